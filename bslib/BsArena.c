@@ -0,0 +1,146 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ region (arena) allocator library.</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdlib.h"
+
+#include "BsError.h"
+#include "BsArena.h"
+
+//alignment of allocated memory:
+#define BSARENA_ALIGN _Alignof(max_align_t)
+
+//aligned block header size:
+#define BSARENA_HDSZ ((sizeof(BsArenaBlk) + BSARENA_ALIGN - 1) & ~(BSARENA_ALIGN - 1))
+
+/**
+ * <p>Allocate new block.</p>
+ * @param pSz - data size
+ * @return block or NULL when OOM
+ * @set errno - ENOMEM
+ **/
+static BsArenaBlk *s_blk_new(size_t pSz) {
+  BsArenaBlk *blk = malloc(BSARENA_HDSZ + pSz);
+  if (blk == NULL) {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+    return NULL;
+  }
+  blk->nxt = NULL;
+  blk->sz = pSz;
+  blk->usd = 0;
+  return blk;
+}
+
+/**
+ * <p>Constructor.</p>
+ * @param pBlkSz block size, if 0 then BSARENA_BLKSZ
+ * @return arena or NULL when OOM
+ * @set errno - ENOMEM
+ **/
+BsArena *bsarena_new(size_t pBlkSz) {
+  BsArena *obj = malloc(sizeof(BsArena));
+  if (obj == NULL) {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+    return NULL;
+  }
+  obj->hd = NULL;
+  obj->blkSz = pBlkSz == 0 ? BSARENA_BLKSZ : pBlkSz;
+  obj->alcd = 0;
+  return obj;
+}
+
+/**
+ * <p>Destructor, it releases all allocated from arena memory.</p>
+ * @param pArena - arena, maybe NULL
+ * @return always NULL
+ **/
+BsArena *bsarena_free(BsArena *pArena) {
+  if (pArena != NULL) {
+    BsArenaBlk *blk = pArena->hd;
+    while (blk != NULL) {
+      BsArenaBlk *nxt = blk->nxt;
+      free(blk);
+      blk = nxt;
+    }
+    free(pArena);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Allocate aligned memory from arena.
+ * Object that is bigger than quarter of block gets its own block.</p>
+ * @param pArena - arena or NULL to use malloc
+ * @param pSz - size in bytes
+ * @return memory or NULL when OOM
+ * @set errno - ENOMEM
+ **/
+void *bsarena_alloc(BsArena *pArena, size_t pSz) {
+  if (pArena == NULL) {
+    void *rz = malloc(pSz);
+    if (rz == NULL) {
+      if ( errno == 0 ) { errno = ENOMEM; }
+      BSLOG_ERR
+    }
+    return rz;
+  }
+  size_t sz = (pSz + BSARENA_ALIGN - 1) & ~(BSARENA_ALIGN - 1);
+  if (sz == 0) { sz = BSARENA_ALIGN; }
+  BsArenaBlk *blk;
+  if (sz > pArena->blkSz / 4) {
+    //own block behind current one, so current's rest is still usable:
+    blk = s_blk_new(sz);
+    if (blk == NULL) { return NULL; }
+    blk->usd = sz;
+    if (pArena->hd == NULL) {
+      pArena->hd = blk;
+    } else {
+      blk->nxt = pArena->hd->nxt;
+      pArena->hd->nxt = blk;
+    }
+  } else {
+    blk = pArena->hd;
+    if (blk == NULL || blk->sz - blk->usd < sz) {
+      blk = s_blk_new(pArena->blkSz);
+      if (blk == NULL) { return NULL; }
+      blk->nxt = pArena->hd;
+      pArena->hd = blk;
+    }
+    blk->usd += sz;
+  }
+  pArena->alcd += pSz;
+  return (char*) blk + BSARENA_HDSZ + blk->usd - sz;
+}
+
+/**
+ * <p>Move all blocks from source arena into destination one,
+ * e.g. to merge per-thread arenas. Source becomes empty.</p>
+ * @param pArena - destination arena
+ * @param pSrc - source arena, maybe NULL
+ **/
+void bsarena_join(BsArena *pArena, BsArena *pSrc) {
+  if (pSrc == NULL || pSrc->hd == NULL) {
+    return;
+  }
+  BsArenaBlk *lst = pSrc->hd;
+  while (lst->nxt != NULL) {
+    lst = lst->nxt;
+  }
+  if (pArena->hd == NULL) {
+    pArena->hd = pSrc->hd;
+  } else { //keep destination's current block:
+    lst->nxt = pArena->hd->nxt;
+    pArena->hd->nxt = pSrc->hd;
+  }
+  pArena->alcd += pSrc->alcd;
+  pSrc->hd = NULL;
+  pSrc->alcd = 0;
+}
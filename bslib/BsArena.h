@@ -0,0 +1,78 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ region (arena) allocator library.
+ * It serves many small objects from few big blocks,
+ * and releases all of them at once.</p>
+ * @author Yury Demidenko
+ **/
+#ifndef BSARENA_H
+#define BSARENA_H 1
+
+#include "stddef.h"
+
+#include "BsLog.h"
+
+//default block size:
+#define BSARENA_BLKSZ 1048576
+
+/**
+ * <p>Arena block, its data follows it.</p>
+ * @member struct BsArenaBlk *nxt - next (older) block or NULL
+ * @member size_t sz - data size
+ * @member size_t usd - used data size
+ **/
+typedef struct BsArenaBlk {
+  struct BsArenaBlk *nxt;
+  size_t sz;
+  size_t usd;
+} BsArenaBlk;
+
+/**
+ * <p>Arena.</p>
+ * @member BsArenaBlk *hd - current block or NULL
+ * @member size_t blkSz - new block size
+ * @member size_t alcd - total allocated (requested) bytes
+ **/
+typedef struct {
+  BsArenaBlk *hd;
+  size_t blkSz;
+  size_t alcd;
+} BsArena;
+
+/**
+ * <p>Constructor.</p>
+ * @param pBlkSz block size, if 0 then BSARENA_BLKSZ
+ * @return arena or NULL when OOM
+ * @set errno - ENOMEM
+ **/
+BsArena *bsarena_new(size_t pBlkSz);
+
+/**
+ * <p>Destructor, it releases all allocated from arena memory.</p>
+ * @param pArena - arena, maybe NULL
+ * @return always NULL
+ **/
+BsArena *bsarena_free(BsArena *pArena);
+
+/**
+ * <p>Allocate aligned memory from arena.
+ * Object that is bigger than quarter of block gets its own block.</p>
+ * @param pArena - arena or NULL to use malloc
+ * @param pSz - size in bytes
+ * @return memory or NULL when OOM
+ * @set errno - ENOMEM
+ **/
+void *bsarena_alloc(BsArena *pArena, size_t pSz);
+
+/**
+ * <p>Move all blocks from source arena into destination one,
+ * e.g. to merge per-thread arenas. Source becomes empty.</p>
+ * @param pArena - destination arena
+ * @param pSrc - source arena, maybe NULL
+ **/
+void bsarena_join(BsArena *pArena, BsArena *pSrc);
+#endif
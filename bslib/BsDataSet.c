@@ -11,6 +11,9 @@ See the LICENSE in the root source folder */
  **/
 
 #include "stdlib.h"
+#include "string.h"
+#include "unistd.h"
+#include "pthread.h"
 
 #include "BsDataSet.h"
 #include "BsError.h"
@@ -427,6 +430,206 @@ oute:
   return BS_IDX_NULL;
 }
 
+//insertion sort is faster on small chunks:
+#define BS_DATASET_SORT_INSSZ 16L
+
+/**
+ * <p>Merge sort job.</p>
+ * @member void **vals - array to sort
+ * @member void **tmp - buffer with same size
+ * @member BS_IDX_T lo - range start
+ * @member BS_IDX_T mid - second sorted range start for merging, otherwise BS_IDX_NULL
+ * @member BS_IDX_T hi - range end (exclusive)
+ * @member Bs_Compare *cmp - comparator
+ **/
+typedef struct {
+  void **vals;
+  void **tmp;
+  BS_IDX_T lo;
+  BS_IDX_T mid;
+  BS_IDX_T hi;
+  Bs_Compare *cmp;
+} BsDataSetSortJob;
+
+/**
+ * <p>Merge two adjacent sorted ranges.</p>
+ * @param pJob - job with both ranges
+ **/
+static void s_merge(BsDataSetSortJob *pJob) {
+  BS_IDX_T i = pJob->lo, j = pJob->mid, k = pJob->lo;
+  if (pJob->cmp(pJob->vals[j - BS_IDX_1], pJob->vals[j]) <= 0) {
+    return; //already ordered
+  }
+  while (i < pJob->mid && j < pJob->hi) {
+    if (pJob->cmp(pJob->vals[j], pJob->vals[i]) < 0) {
+      pJob->tmp[k++] = pJob->vals[j++];
+    } else {
+      pJob->tmp[k++] = pJob->vals[i++];
+    }
+  }
+  while (i < pJob->mid) {
+    pJob->tmp[k++] = pJob->vals[i++];
+  }
+  //the rest of the second range is already in place:
+  memcpy(pJob->vals + pJob->lo, pJob->tmp + pJob->lo, (k - pJob->lo) * sizeof(void*));
+}
+
+/**
+ * <p>Stable merge sort of range.</p>
+ * @param pJob - job with range
+ **/
+static void s_msort(BsDataSetSortJob *pJob) {
+  if (pJob->hi - pJob->lo <= BS_DATASET_SORT_INSSZ) {
+    for (BS_IDX_T l = pJob->lo + BS_IDX_1; l < pJob->hi; l++) {
+      void *obj = pJob->vals[l];
+      BS_IDX_T m = l;
+      while (m > pJob->lo && pJob->cmp(obj, pJob->vals[m - BS_IDX_1]) < 0) {
+        pJob->vals[m] = pJob->vals[m - BS_IDX_1];
+        m--;
+      }
+      pJob->vals[m] = obj;
+    }
+    return;
+  }
+  BsDataSetSortJob job = *pJob;
+  BS_IDX_T mid = pJob->lo + (pJob->hi - pJob->lo) / BS_IDX_2;
+  job.hi = mid;
+  s_msort(&job);
+  job.lo = mid; job.hi = pJob->hi;
+  s_msort(&job);
+  job.lo = pJob->lo; job.mid = mid;
+  s_merge(&job);
+}
+
+/**
+ * <p>Thread's sort or merge job.</p>
+ * @param pJob - job
+ * @return always NULL
+ **/
+static void *s_sort_job(void *pJob) {
+  BsDataSetSortJob *job = (BsDataSetSortJob*) pJob;
+  if (job->mid == BS_IDX_NULL) {
+    s_msort(job);
+  } else {
+    s_merge(job);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Do jobs in threads, the first one in current thread.
+ * If thread can't be created, then job will be done in current thread.</p>
+ * @param pJobs - jobs
+ * @param pCnt - jobs count
+ **/
+static void s_sort_jobs(BsDataSetSortJob *pJobs, int pCnt) {
+  pthread_t thrds[pCnt];
+  bool crtd[pCnt];
+  for (int i = 1; i < pCnt; i++) {
+    crtd[i] = pthread_create(&thrds[i], NULL, s_sort_job, (void*) &pJobs[i]) == 0;
+  }
+  s_sort_job(&pJobs[0]);
+  for (int i = 1; i < pCnt; i++) {
+    if (crtd[i]) {
+      pthread_join(thrds[i], NULL);
+    } else {
+      s_sort_job(&pJobs[i]);
+    }
+  }
+}
+
+/**
+ * <p>Stable merge sort, i.e. equal objects keep their order,
+ * so it's bulk replacement of adding with sorting and duplicates.
+ * Already ordered array is processed in linear time.</p>
+ * @param pSet - data set
+ * @param pCompare comparator NON-NULL
+ * @param pThrdCnt - maximum threads, 0 means online processors count,
+ *   1 means current thread only
+ * @set errno - ENOMEM
+ **/
+void bsdatasettus_sort(BsDataSetTus *pSet, Bs_Compare *pCompare, int pThrdCnt) {
+  if (pSet->size < BS_IDX_2) {
+    return;
+  }
+  long thrds = pThrdCnt;
+  if (thrds < 1) {
+    thrds = sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  if (thrds > pSet->size / BS_DATASET_SORT_THRD_MINSZ) {
+    thrds = pSet->size / BS_DATASET_SORT_THRD_MINSZ;
+  }
+  if (thrds < 1) {
+    thrds = 1;
+  }
+  void **tmp = malloc(pSet->size * sizeof(void*));
+  if (tmp == NULL) {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+    return;
+  }
+  BsDataSetSortJob jobs[thrds];
+  BS_IDX_T bnds[thrds + 1];
+  int cnt = (int) thrds;
+  for (int i = 0; i <= cnt; i++) {
+    bnds[i] = pSet->size * i / cnt;
+  }
+  //1. sort chunks:
+  for (int i = 0; i < cnt; i++) {
+    jobs[i].vals = pSet->vals; jobs[i].tmp = tmp; jobs[i].cmp = pCompare;
+    jobs[i].lo = bnds[i]; jobs[i].mid = BS_IDX_NULL; jobs[i].hi = bnds[i + 1];
+  }
+  s_sort_jobs(jobs, cnt);
+  //2. merge adjacent chunks pairs till the single one:
+  for (int wdth = 1; wdth < cnt; wdth *= 2) {
+    int jcnt = 0;
+    for (int i = 0; i + wdth < cnt; i += 2 * wdth) {
+      int e = i + 2 * wdth;
+      if (e > cnt) {
+        e = cnt;
+      }
+      jobs[jcnt].lo = bnds[i]; jobs[jcnt].mid = bnds[i + wdth]; jobs[jcnt].hi = bnds[e];
+      jcnt++;
+    }
+    s_sort_jobs(jobs, jcnt);
+  }
+  free(tmp);
+  if (bslog_is_debug(BS_DEBUGL_DATASET + 72)) {
+    BSLOG_LOG(BSLDEBUG, "Sorted size="BS_IDX_FMT" by %d threads\n", pSet->size, cnt);
+  }
+}
+
+/**
+ * <p>Remove duplicates from sorted array, the first one of equal objects remains.
+ * So it's bulk replacement of adding with sorting without duplicates.</p>
+ * @param pSet - data set
+ * @param pCompare comparator NON-NULL
+ * @param pObjDestr - record's destructor, maybe NULL
+ * @return removed duplicates count
+ **/
+BS_IDX_T bsdatasettus_uniq(BsDataSetTus *pSet, Bs_Compare *pCompare, Bs_Destruct *pObjDestr) {
+  if (pSet->size < BS_IDX_2) {
+    return BS_IDX_0;
+  }
+  BS_IDX_T sz = BS_IDX_1;
+  for (BS_IDX_T l = BS_IDX_1; l < pSet->size; l++) {
+    if (pCompare(pSet->vals[sz - BS_IDX_1], pSet->vals[l]) == 0) {
+      if (pObjDestr != NULL) {
+        pObjDestr(pSet->vals[l]);
+      }
+    } else {
+      pSet->vals[sz] = pSet->vals[l];
+      sz++;
+    }
+  }
+  BS_IDX_T rmvd = pSet->size - sz;
+  for (BS_IDX_T l = sz; l < pSet->size; l++) {
+    pSet->vals[l] = NULL;
+  }
+  pSet->size = sz;
+  return rmvd;
+}
+
 /**
  * <p>Add index of given objects collection into sorted indexes.</p>
  * @param pIdxset - indexes set to add
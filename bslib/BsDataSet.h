@@ -115,6 +115,31 @@ BS_IDX_T bsdatasettus_add_inc(BsDataSetTus *pSet, void *pObj, BS_IDX_T pInc);
 BS_IDX_T bsdatasettus_add_sort_inc(BsDataSetTus *pSet, void *pObj, BS_IDX_T pInc,
   Bs_Compare *pCompare, bool pYesDup);
 
+//threads sorting minimum size per thread:
+#define BS_DATASET_SORT_THRD_MINSZ 50000L
+
+/**
+ * <p>Stable merge sort, i.e. equal objects keep their order,
+ * so it's bulk replacement of adding with sorting and duplicates.
+ * Already ordered array is processed in linear time.</p>
+ * @param pSet - data set
+ * @param pCompare comparator NON-NULL
+ * @param pThrdCnt - maximum threads, 0 means online processors count,
+ *   1 means current thread only
+ * @set errno - ENOMEM
+ **/
+void bsdatasettus_sort(BsDataSetTus *pSet, Bs_Compare *pCompare, int pThrdCnt);
+
+/**
+ * <p>Remove duplicates from sorted array, the first one of equal objects remains.
+ * So it's bulk replacement of adding with sorting without duplicates.</p>
+ * @param pSet - data set
+ * @param pCompare comparator NON-NULL
+ * @param pObjDestr - record's destructor, maybe NULL
+ * @return removed duplicates count
+ **/
+BS_IDX_T bsdatasettus_uniq(BsDataSetTus *pSet, Bs_Compare *pCompare, Bs_Destruct *pObjDestr);
+
 /**
  * <p>Clear array's cell with given index and shrink array and decrease size.
  * If parameter object's destructor is not NULL, then free object.</p>
@@ -282,6 +282,51 @@ void bsfwrite_long(long *pData, FILE *pFile) {
   }
 }
 
+/**
+ * <p>Read long from given file.</p>
+ * @param pDataRet - pointer to return data
+ * @param pFile - file
+ * @set errno if error.
+ **/
+void bsfread_long(long *pDataRet, FILE *pFile) {
+  int cnt = 1;
+  int rcr = fread(pDataRet, sizeof(long), cnt, pFile);
+  if (rcr != cnt) {
+    if (errno == 0) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+  }
+}
+
+/**
+ * <p>Write unsigned long into given file.</p>
+ * @param pData - pointer to data
+ * @param pFile - file
+ * @set errno if error.
+ **/
+void bsfwrite_ulong(unsigned long *pData, FILE *pFile) {
+  int cnt = 1;
+  int wcr = fwrite(pData, sizeof(unsigned long), cnt, pFile);
+  if (wcr != cnt) {
+    if (errno == 0) { errno = BSE_WRITE_FILE; }
+    BSLOG_ERR
+  }
+}
+
+/**
+ * <p>Read unsigned long from given file.</p>
+ * @param pDataRet - pointer to return data
+ * @param pFile - file
+ * @set errno if error.
+ **/
+void bsfread_ulong(unsigned long *pDataRet, FILE *pFile) {
+  int cnt = 1;
+  int rcr = fread(pDataRet, sizeof(unsigned long), cnt, pFile);
+  if (rcr != cnt) {
+    if (errno == 0) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+  }
+}
+
 /**
  * <p>Write BS_SMALL_T into given file.</p>
  * @param pData - pointer to data
@@ -557,7 +602,7 @@ void
   int wrc, i;
   for ( i = 0; i < pCnt; i++ )
   {
-    wrc = fwrite (&pChrp, BS_CHAR_LEN, 1, pFile);
+    wrc = fwrite (pChrp, BS_CHAR_LEN, 1, pFile);
     if ( wrc != 1 )
     {
       if ( errno == 0 ) { errno = BSE_WRITE_FILE; }
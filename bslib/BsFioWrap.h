@@ -152,6 +152,30 @@ void bsfwrite_enum(int pEnumVl, FILE *pFile);
  **/
 void bsfwrite_long(long *pData, FILE *pFile);
 
+/**
+ * <p>Read long from given file.</p>
+ * @param pDataRet - pointer to return data
+ * @param pFile - file
+ * @set errno if error.
+ **/
+void bsfread_long(long *pDataRet, FILE *pFile);
+
+/**
+ * <p>Write unsigned long into given file.</p>
+ * @param pData - pointer to data
+ * @param pFile - file
+ * @set errno if error.
+ **/
+void bsfwrite_ulong(unsigned long *pData, FILE *pFile);
+
+/**
+ * <p>Read unsigned long from given file.</p>
+ * @param pDataRet - pointer to return data
+ * @param pFile - file
+ * @set errno if error.
+ **/
+void bsfread_ulong(unsigned long *pDataRet, FILE *pFile);
+
 /**
  * <p>Write BS_SMALL_T into given file.</p>
  * @param pData - pointer to data
@@ -0,0 +1,70 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ locale independent Unicode letters simple case folding library.</p>
+ * @author Yury Demidenko
+ **/
+
+#include "BsUcFold.h"
+#include "BsUcFold.inc"
+
+//ASCII wchar's folding, i.e. A...Z plus 32:
+#define BSUCFOLD_ASCII(p_wch) ((p_wch) + ((((unsigned int) (p_wch) - 'A') < 26) << 5))
+
+/**
+ * <p>Char class - 0 not letter, 1 letter without folding,
+ * otherwise folding delta's index.</p>
+ **/
+static int
+  s_cls (BS_WCHAR_T pWch)
+{
+  unsigned long wch = (unsigned long) pWch;
+  if ( wch >= BSUCFOLD_BLKS * BSUCFOLD_BLKSZ )
+    { return 0; }
+  return sBlks[sBlkIxs[wch / BSUCFOLD_BLKSZ]][wch % BSUCFOLD_BLKSZ];
+}
+
+/**
+ * <p>Is it letter, i.e. has Unicode Alphabetic property.</p>
+ * @param pWch - wide char
+ * @return 1 if yes
+ **/
+int
+  bsucfold_isalpha (BS_WCHAR_T pWch)
+{
+  return s_cls (pWch) != 0;
+}
+
+/**
+ * <p>Fold letter by Unicode simple case folding (C and S entries
+ * of CaseFolding.txt), e.g. "Σ" and "ς" into "σ".</p>
+ * @param pWch - wide char
+ * @return folded or the same char
+ **/
+BS_WCHAR_T
+  bsucfold_fold (BS_WCHAR_T pWch)
+{
+  if ( (unsigned long) pWch < 0x80 )
+    { return BSUCFOLD_ASCII (pWch); }
+  return pWch + sDlts[s_cls (pWch)];
+}
+
+/**
+ * <p>Fold all letters of given string, ASCII chars are folded
+ * without table.</p>
+ * @param pWstr - wide string
+ **/
+void
+  bsucfold_wstr (BS_WCHAR_T *pWstr)
+{
+  for ( int i = 0; pWstr[i] != 0; i++ )
+  {
+    if ( (unsigned long) pWstr[i] < 0x80 )
+      { pWstr[i] = BSUCFOLD_ASCII (pWstr[i]); }
+    else
+      { pWstr[i] += sDlts[s_cls (pWstr[i])]; }
+  }
+}
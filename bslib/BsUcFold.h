@@ -0,0 +1,46 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ locale independent Unicode letters simple case folding library.
+ * It replaces iswalpha/towlower calls on normalizing words,
+ * folding is a table load. Table BsUcFold.inc is generated at build time
+ * by BsUcFoldMk from UCD snapshot in ucd/.</p>
+ * @author Yury Demidenko
+ **/
+#ifndef BSUCFOLD_H
+#define BSUCFOLD_H 1
+
+#include "wchar.h"
+
+#include "BsBase.h"
+
+//table's block size:
+#define BSUCFOLD_BLKSZ 256
+//blocks total, i.e. code points 0...0x10FFFF:
+#define BSUCFOLD_BLKS 0x1100
+
+/**
+ * <p>Is it letter, i.e. has Unicode Alphabetic property.</p>
+ * @param pWch - wide char
+ * @return 1 if yes
+ **/
+int bsucfold_isalpha (BS_WCHAR_T pWch);
+
+/**
+ * <p>Fold letter by Unicode simple case folding (C and S entries
+ * of CaseFolding.txt), e.g. "Σ" and "ς" into "σ".</p>
+ * @param pWch - wide char
+ * @return folded or the same char
+ **/
+BS_WCHAR_T bsucfold_fold (BS_WCHAR_T pWch);
+
+/**
+ * <p>Fold all letters of given string, ASCII chars are folded
+ * without table.</p>
+ * @param pWstr - wide string
+ **/
+void bsucfold_wstr (BS_WCHAR_T *pWstr);
+#endif
@@ -0,0 +1,206 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ build-time generator of BsUcFold.inc - Unicode
+ * letters simple case folding table. It's made from UCD snapshot in ucd/,
+ * i.e. from CaseFolding.txt (C and S entries) and Alphabetic.txt
+ * (Alphabetic property), so folding doesn't depend on libc.
+ * Table is:
+ * blocks indexes by code point high part (c / 256),
+ * unique blocks of 256 chars classes:
+ * 0 - not letter, 1 - letter without folding, 2... - folding delta's index,
+ * folding deltas.</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "BsUcFold.h"
+
+//max unique blocks/deltas, they must fit into unsigned char:
+#define MAXSZ 256
+//code points total:
+#define CPSZ (BSUCFOLD_BLKS * BSUCFOLD_BLKSZ)
+
+/**
+ * <p>Read UCD file's data lines, i.e. fields separated by ';',
+ * comments and empty lines are skipped.</p>
+ * @param pFl - UCD file
+ * @param pLn - buffer to return line
+ * @param pLnSz - buffer size
+ * @return 1 if line is read or 0 at the end
+ **/
+static int
+  s_read_ln (FILE *pFl, char *pLn, int pLnSz)
+{
+  while ( fgets (pLn, pLnSz, pFl) != NULL )
+  {
+    if ( pLn[0] != '#' && strchr (pLn, ';') != NULL )
+      { return 1; }
+  }
+  return 0;
+}
+
+/**
+ * <p>Read simple case folding, i.e. C and S entries of CaseFolding.txt.</p>
+ * @param pPth - file path
+ * @param pFlds - folded code point of every one to fill
+ * @return 0 or 1 if error
+ **/
+static int
+  s_read_fold (char *pPth, int *pFlds)
+{
+  char ln[512], st;
+  unsigned int c, m;
+  FILE *fl = fopen (pPth, "r");
+  if ( fl == NULL )
+  {
+    fprintf (stderr, "Can't open %s!\n", pPth);
+    return 1;
+  }
+  while ( s_read_ln (fl, ln, sizeof (ln)) )
+  {
+    if ( sscanf (ln, "%x; %c; %x;", &c, &st, &m) != 3 || c >= CPSZ || m >= CPSZ )
+    {
+      fprintf (stderr, "Wrong line in %s: %s", pPth, ln);
+      fclose (fl);
+      return 1;
+    }
+    if ( st == 'C' || st == 'S' )
+      { pFlds[c] = m; }
+  }
+  fclose (fl);
+  return 0;
+}
+
+/**
+ * <p>Read Alphabetic property ranges from Alphabetic.txt.</p>
+ * @param pPth - file path
+ * @param pAlphs - letter flag of every code point to fill
+ * @return 0 or 1 if error
+ **/
+static int
+  s_read_alpha (char *pPth, unsigned char *pAlphs)
+{
+  char ln[512];
+  unsigned int s, e;
+  FILE *fl = fopen (pPth, "r");
+  if ( fl == NULL )
+  {
+    fprintf (stderr, "Can't open %s!\n", pPth);
+    return 1;
+  }
+  while ( s_read_ln (fl, ln, sizeof (ln)) )
+  {
+    int n = sscanf (ln, "%x..%x", &s, &e);
+    if ( n == 1 )
+      { e = s; }
+    if ( n < 1 || s > e || e >= CPSZ )
+    {
+      fprintf (stderr, "Wrong line in %s: %s", pPth, ln);
+      fclose (fl);
+      return 1;
+    }
+    for ( unsigned int c = s; c <= e; c++ )
+      { pAlphs[c] = 1; }
+  }
+  fclose (fl);
+  return 0;
+}
+
+int
+  main (int argc, char *argv[])
+{
+  static unsigned char blkIxs[BSUCFOLD_BLKS];
+  static unsigned char blks[MAXSZ][BSUCFOLD_BLKSZ];
+  static int flds[CPSZ];
+  static unsigned char alphs[CPSZ];
+  int dlts[MAXSZ];
+  unsigned char blk[BSUCFOLD_BLKSZ];
+  int blksTot = 0, dltsTot = 2;
+  dlts[0] = 0; dlts[1] = 0;
+  if ( argc != 3 )
+  {
+    fprintf (stderr, "Usage: BsUcFoldMk CaseFolding.txt Alphabetic.txt\n");
+    return 1;
+  }
+  for ( int c = 0; c < CPSZ; c++ )
+    { flds[c] = c; }
+  if ( s_read_fold (argv[1], flds) != 0 || s_read_alpha (argv[2], alphs) != 0 )
+    { return 1; }
+  for ( int b = 0; b < BSUCFOLD_BLKS; b++ )
+  {
+    for ( int i = 0; i < BSUCFOLD_BLKSZ; i++ )
+    {
+      int c = b * BSUCFOLD_BLKSZ + i;
+      if ( !alphs[c] && flds[c] != c )
+      {
+        fprintf (stderr, "Folded not letter #%x!\n", c);
+        return 1;
+      }
+      if ( !alphs[c] )
+        { blk[i] = 0; }
+      else if ( flds[c] == c )
+        { blk[i] = 1; }
+      else
+      {
+        int d = flds[c] - c, j;
+        for ( j = 2; j < dltsTot; j++ )
+        {
+          if ( dlts[j] == d )
+            { break; }
+        }
+        if ( j == dltsTot )
+        {
+          if ( dltsTot == MAXSZ )
+          {
+            fprintf (stderr, "Too many deltas!\n");
+            return 1;
+          }
+          dlts[dltsTot++] = d;
+        }
+        blk[i] = j;
+      }
+    }
+    int j;
+    for ( j = 0; j < blksTot; j++ )
+    {
+      if ( memcmp (blks[j], blk, BSUCFOLD_BLKSZ) == 0 )
+        { break; }
+    }
+    if ( j == blksTot )
+    {
+      if ( blksTot == MAXSZ )
+      {
+        fprintf (stderr, "Too many blocks!\n");
+        return 1;
+      }
+      memcpy (blks[blksTot++], blk, BSUCFOLD_BLKSZ);
+    }
+    blkIxs[b] = j;
+  }
+  printf ("//generated by BsUcFoldMk, don't edit!\n");
+  printf ("static const unsigned char sBlkIxs[%d] = {", BSUCFOLD_BLKS);
+  for ( int b = 0; b < BSUCFOLD_BLKS; b++ )
+    { printf ("%s%d", b % 32 == 0 ? "\n  " : "", blkIxs[b]); if ( b < BSUCFOLD_BLKS - 1 ) { printf (","); } }
+  printf ("\n};\n");
+  printf ("static const unsigned char sBlks[%d][%d] = {", blksTot, BSUCFOLD_BLKSZ);
+  for ( int b = 0; b < blksTot; b++ )
+  {
+    printf ("\n {");
+    for ( int i = 0; i < BSUCFOLD_BLKSZ; i++ )
+      { printf ("%s%d", i % 32 == 0 ? "\n  " : "", blks[b][i]); if ( i < BSUCFOLD_BLKSZ - 1 ) { printf (","); } }
+    printf ("\n }%s", b < blksTot - 1 ? "," : "");
+  }
+  printf ("\n};\n");
+  printf ("static const int sDlts[%d] = {", dltsTot);
+  for ( int j = 0; j < dltsTot; j++ )
+    { printf ("%s%d", j % 16 == 0 ? "\n  " : "", dlts[j]); if ( j < dltsTot - 1 ) { printf (","); } }
+  printf ("\n};\n");
+  return 0;
+}
@@ -17,6 +17,7 @@ See the LICENSE in the root source folder */
 #include "BsStrings.h"
 #include "BsError.h"
 #include "BsFatalLog.h"
+#include "BsArena.h"
 
 static void s_test0() {
  //0-"week" 1-"beep" 2-"speak",
@@ -63,6 +64,93 @@ out:
   bsidxset_free(sidxs);
 }
 
+typedef struct {
+  int key;
+  int seq;
+} TstKeySeq;
+
+static int s_cmp_key(TstKeySeq *pObj1, TstKeySeq *pObj2) {
+  if (pObj1->key < pObj2->key) {
+    return -1;
+  } else if (pObj1->key > pObj2->key) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * <p>Test stable (parallel) merge sort and removing duplicates.</p>
+ **/
+static void s_test2() {
+  int sz = 200000, keys = 1000;
+  TstKeySeq *objs = malloc(sz * sizeof(TstKeySeq));
+  BS_IF_EN_RET(objs == NULL, ENOMEM)
+  BsDataSetTus *set = NULL;
+  for (int thrds = 0; thrds < 2; thrds++) {
+    BS_DO_E_OUT(set = bsdatasettus_new(sizeof(BsDataSetTus), 10L))
+    srand(1);
+    for (int i = 0; i < sz; i++) {
+      objs[i].key = rand() % keys;
+      objs[i].seq = i;
+      //double buffer when full-filled:
+      BS_DO_E_OUT(bsdatasettus_add_inc(set, &objs[i], set->bsize))
+    }
+    BS_DO_E_OUT(bsdatasettus_sort(set, (Bs_Compare*) s_cmp_key, thrds))
+    for (BS_IDX_T l = BS_IDX_1; l < set->size; l++) {
+      TstKeySeq *prv = set->vals[l - 1], *cur = set->vals[l];
+      BS_IF_ENM_OUT(prv->key > cur->key || (prv->key == cur->key && prv->seq > cur->seq),
+        BSE_TEST_ERR, "Wrong order or unstable sort\n")
+    }
+    //sorted array again:
+    BS_DO_E_OUT(bsdatasettus_sort(set, (Bs_Compare*) s_cmp_key, thrds))
+    BS_IDX_T rmvd = bsdatasettus_uniq(set, (Bs_Compare*) s_cmp_key, NULL);
+    BS_IF_ENM_OUT(set->size != keys || rmvd != sz - keys, BSE_TEST_ERR, "uniq size wrong\n")
+    for (BS_IDX_T l = BS_IDX_0; l < set->size; l++) {
+      TstKeySeq *cur = set->vals[l];
+      for (int i = 0; i < cur->seq; i++) {
+        BS_IF_ENM_OUT(objs[i].key == cur->key, BSE_TEST_ERR, "uniq left not the first\n")
+      }
+    }
+    set = bsdatasettus_free(set, NULL);
+  }
+out:
+  bsdatasettus_free(set, NULL);
+  free(objs);
+}
+
+/**
+ * <p>Test arena allocator: alignment, own blocks for big objects and joining.</p>
+ **/
+static void s_test3() {
+  BsArena *ar1 = NULL, *ar2 = NULL;
+  BS_DO_E_OUT(ar1 = bsarena_new(256))
+  BS_DO_E_OUT(ar2 = bsarena_new(256))
+  char *mems[300];
+  for (int i = 1; i < 300; i++) {
+    BS_DO_E_OUT(mems[i] = bsarena_alloc(i % 2 == 0 ? ar1 : ar2, i))
+    BS_IF_ENM_OUT(((size_t) mems[i]) % _Alignof(max_align_t) != 0, BSE_TEST_ERR,
+      "Arena memory isn't aligned\n")
+    memset(mems[i], i, i);
+  }
+  for (int i = 1; i < 300; i++) {
+    for (int j = 0; j < i; j++) {
+      BS_IF_ENM_OUT(mems[i][j] != (char) i, BSE_TEST_ERR, "Arena memory overlaps\n")
+    }
+  }
+  size_t alcd = ar1->alcd + ar2->alcd;
+  bsarena_join(ar1, ar2);
+  BS_IF_ENM_OUT(ar2->hd != NULL || ar2->alcd != 0 || ar1->alcd != alcd,
+    BSE_TEST_ERR, "Arena join wrong\n")
+  int blks = 0;
+  for (BsArenaBlk *blk = ar1->hd; blk != NULL; blk = blk->nxt) {
+    blks++;
+  }
+  BS_IF_ENM_OUT(blks < 3, BSE_TEST_ERR, "Arena blocks count wrong\n")
+out:
+  bsarena_free(ar1);
+  bsarena_free(ar2);
+}
+
 static int sCount = 0;
 
 static void
@@ -112,6 +200,8 @@ int
   bsfatallog_set_log_path("bscollfatal.log");
   bsfatallog_init_fatal_signals();
   BS_DO_E_OUT(s_test0())
+  BS_DO_E_OUT(s_test2())
+  BS_DO_E_OUT(s_test3())
   s_test1(); //must be BSE_ARR_OUT_OF_BOUNDS
   if (errno == 0) {
     errno = BSE_ERR;
@@ -0,0 +1,146 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+ 
+/**
+ * <p>Test of BsUcFold.</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdlib.h"
+#include "errno.h"
+#include "locale.h"
+#include "time.h"
+#include "wctype.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsUcFold.h"
+
+#define WSTRSZ 200000
+
+/**
+ * <p>Seconds since given time.</p>
+ **/
+static double s_secs(struct timespec *pStt) {
+  struct timespec en;
+  clock_gettime(CLOCK_MONOTONIC, &en);
+  return (en.tv_sec - pStt->tv_sec) + (en.tv_nsec - pStt->tv_nsec) / 1e9;
+}
+
+/**
+ * <p>Table must be same as UCD snapshot for every code point,
+ * i.e. C and S entries of CaseFolding.txt and Alphabetic ranges.</p>
+ **/
+static void s_test0() {
+  static BS_WCHAR_T flds[BSUCFOLD_BLKS * BSUCFOLD_BLKSZ];
+  static char alphs[BSUCFOLD_BLKS * BSUCFOLD_BLKSZ];
+  char ln[512], st;
+  unsigned int c, m, e;
+  for (c = 0; c < BSUCFOLD_BLKS * BSUCFOLD_BLKSZ; c++) {
+    flds[c] = c;
+  }
+  FILE *fl = fopen("ucd/CaseFolding.txt", "r");
+  BS_IF_ENM_RET(fl == NULL, BSE_OPEN_FILE, "Can't open CaseFolding.txt\n")
+  while (fgets(ln, sizeof(ln), fl) != NULL) {
+    if (ln[0] != '#' && sscanf(ln, "%x; %c; %x;", &c, &st, &m) == 3 && (st == 'C' || st == 'S')) {
+      flds[c] = m;
+    }
+  }
+  fclose(fl);
+  fl = fopen("ucd/Alphabetic.txt", "r");
+  BS_IF_ENM_RET(fl == NULL, BSE_OPEN_FILE, "Can't open Alphabetic.txt\n")
+  while (fgets(ln, sizeof(ln), fl) != NULL) {
+    int n = ln[0] == '#' ? 0 : sscanf(ln, "%x..%x", &c, &e);
+    if (n == 1) {
+      e = c;
+    }
+    for (; n > 0 && c <= e; c++) {
+      alphs[c] = 1;
+    }
+  }
+  fclose(fl);
+  for (c = 1; c < BSUCFOLD_BLKS * BSUCFOLD_BLKSZ; c++) {
+    if (bsucfold_isalpha(c) != alphs[c] || bsucfold_fold(c) != flds[c]) {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG(BSLERROR, "Differs on #%x: isalpha %d/%d, fold #%x/#%x\n", c, bsucfold_isalpha(c), alphs[c], bsucfold_fold(c), flds[c])
+      return;
+    }
+  }
+  if (bsucfold_fold(0x110000) != 0x110000 || bsucfold_isalpha(-5)
+    || bsucfold_fold(0x3C2) != 0x3C3 || bsucfold_fold(0x1E9E) != 0xDF) {
+    errno = BSE_TEST_ERR;
+    BSLOG_LOG(BSLERROR, "Out of Unicode char is not as is or final sigma/capital sharp s are not folded\n")
+  }
+}
+
+/**
+ * <p>Folding whole string must be same as per char one,
+ * also benchmark it against libc's towlower.</p>
+ **/
+static void s_test1() {
+  static BS_WCHAR_T *wrds[6] = { L"Hello World ", L"ВЕЛИКИЙ ", L"ΣΟΦΙΑ ",
+    L"ÜBER Straße ", L"a-Z[@]`{ ", L"\U00010400\U00010401x " };
+  struct timespec stt;
+  BS_WCHAR_T *wstr = malloc((WSTRSZ + 1) * BS_WCHAR_LEN);
+  BS_WCHAR_T *wstrl = malloc((WSTRSZ + 1) * BS_WCHAR_LEN);
+  BS_IF_ENM_OUT(wstr == NULL || wstrl == NULL, ENOMEM, "no memory\n")
+  int len = 0;
+  unsigned int k = 0;
+  while (len < WSTRSZ) {
+    for (int j = 0; wrds[k % 6][j] != 0 && len < WSTRSZ; j++) {
+      wstr[len++] = wrds[k % 6][j];
+    }
+    k = k * 7 + 3;
+  }
+  wstr[len] = 0;
+  for (int i = 0; i <= len; i++) {
+    wstrl[i] = wstr[i];
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; wstrl[i] != 0; i++) {
+    if (iswalpha(wstrl[i])) {
+      wstrl[i] = towlower(wstrl[i]);
+    }
+  }
+  double secsLc = s_secs(&stt);
+  for (int i = 0; i <= len; i++) {
+    wstrl[i] = bsucfold_fold(wstr[i]);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  bsucfold_wstr(wstr);
+  double secsTb = s_secs(&stt);
+  for (int i = 0; i <= len; i++) {
+    if (wstr[i] != wstrl[i]) {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG(BSLERROR, "String folding differs at %d: #%x/#%x\n", i, wstr[i], wstrl[i])
+      goto out;
+    }
+  }
+  bslog_log(BSLTEST, "Folded %d wchars, libc=%.4f sec, table=%.4f sec\n", len, secsLc, secsTb);
+out:
+  free(wstr);
+  free(wstrl);
+}
+
+int
+  main (int argc, char *argv[])
+{
+  if (setlocale(LC_ALL, "C.UTF-8") == NULL) {
+    setlocale(LC_ALL, "");
+  }
+  errno = 0;
+  BS_DO_E_RETE(BsLogFiles *bslf=bslogfiles_new(1))
+  bslog_files_set_path(bslf, 0, "bsucfold.log");
+  if (errno != 0) {
+    bslogfiles_free(bslf);
+    return errno;
+  }
+  BS_DO_E_OUT(bslog_init(bslf))
+  BS_DO_E_OUT(s_test0())
+  s_test1();
+out:
+  bslog_destroy();
+  return errno;
+}
@@ -137,6 +137,7 @@ BsDiIxHeadBs*
     obj->nme = NULL;
     obj->ab = NULL;
     obj->hirt = NULL;
+    obj->hirtLk = NULL;
     obj->irtSz = BS_IDX_NULL;
     obj->isIxRm = false;
     obj->hirtSz = -1;
@@ -168,6 +169,7 @@ BsDiIxHeadBs*
       }
       free(pHead->hirt);
     }
+    bsdiixhirtlk_free (pHead->hirtLk);
     if ( pHead->ab != NULL )
               { bsdicidxab_free (pHead->ab); }
     if ( pHead->nme != NULL )
@@ -572,6 +574,11 @@ BsDiIxOst*
     obj->stt = EBSDS_OPENING;
     obj->prgr = 100;
     obj->stp = false;
+    obj->memBdgt = 0;
+    obj->isBdgtAuto = false;
+    obj->dpVld = false;
+    obj->isFst = false;
+    obj->isSa = false;
   } else {
     if ( errno == 0 ) { errno = ENOMEM; }
     BSLOG_ERR
@@ -596,8 +603,9 @@ BsDiIxOst*
 
 //2. Making IDX utils:
 /**
- * <p>Add HIRT record.
- * It will allocate HIRT if it's NULL!</p>
+ * <p>Add filled HIRT record.
+ * It will allocate HIRT if it's NULL!
+ * HIRTLK is made when the last record has been added.</p>
  * @param pHead - pointer to IFH
  * @param pRcd HIRT record
  * @set errno if error.
@@ -623,6 +631,11 @@ void
     if ( pHead->hirt[i] == NULL )
     {
       pHead->hirt[i] = pRcd;
+      if ( i == pHead->hirtSz - 1 )
+      {
+        pHead->hirtLk = bsdiixhirtlk_free (pHead->hirtLk);
+        pHead->hirtLk = bsdiixhirtlk_new (pHead->hirt, pHead->hirtSz);
+      }
       return;
     }
   }
@@ -738,10 +751,12 @@ void
 }
 
 /**
- * <p>Save (write/overwrite) IDX RAM's head base (in memory) into file.</p>
+ * <p>Save (write/overwrite) IDX RAM's head base (in memory) into file.
+ * It's temporary file that replaces IDX file by bsdiixheadbs_save_end,
+ * so any process that maps old IDX file is not affected.</p>
  * @param pDiIxRm IDX RAM.
  * @param pPth - dictionary path.
- * @return IDX file for further writing
+ * @return IDX file for further writing, it's also readable
  * @set errno if error.
  **/
 FILE*
@@ -750,11 +765,11 @@ FILE*
   //vars:
   int i;
   FILE *idxFl;
-  char idxPth[strlen(pPth) + 10];
+  char idxPth[strlen(pPth) + 14];
   //code:
   strcpy (idxPth, pPth);
-  strcat (idxPth, BDI_IDX_FILE_EXT);
-  idxFl = fopen(idxPth, "wb");
+  strcat (idxPth, BDI_IDX_FILE_EXT BDI_IDX_TMP_EXT);
+  idxFl = fopen(idxPth, "w+b");
   BS_IF_EN_RETN (idxFl == NULL, BSE_OPEN_FILE)
   //HEAD name, format, AB, totals:
   BS_DO_E_OUTE (bsfwrite_bsstr_lenuchar (pHead->nme, idxFl))
@@ -787,9 +802,35 @@ FILE*
 
 oute:
   fclose(idxFl);
+  bsdiixheadbs_save_end (pPth, false);
   return NULL;
 }
 
+/**
+ * <p>End saving IDX file, i.e. replace IDX file by just written temporary
+ * one or remove temporary one after error. errno is kept.</p>
+ * @param pPth - dictionary path.
+ * @param pIsOk - whether temporary file is completely written
+ * @set errno if error.
+ **/
+void
+  bsdiixheadbs_save_end (char *pPth, bool pIsOk)
+{
+  int errnoOld = errno;
+  char idxPth[strlen(pPth) + 10], tmpPth[strlen(pPth) + 14];
+  strcpy (idxPth, pPth);
+  strcat (idxPth, BDI_IDX_FILE_EXT);
+  strcpy (tmpPth, idxPth);
+  strcat (tmpPth, BDI_IDX_TMP_EXT);
+  if ( !pIsOk )
+  {
+    remove (tmpPth);
+    errno = errnoOld;
+    return;
+  }
+  BS_IF_EN_RET (rename (tmpPth, idxPth) != 0, BSE_WRITE_FILE)
+}
+
 /**
  * <p>Load IDX head base from IDX file.</p>
  * @param pPth - dictionary path.
@@ -831,6 +872,7 @@ void
   pHead->ab->chrsTot = chrsTot;
   BS_DO_E_OUTE (bsfread_bswchars (pHead->ab->wchars,
                                   pHead->ab->chrsTot, idxFl))
+  BS_DO_E_OUTE (bsdicidxab_mk_lkp (pHead->ab))
   BS_DO_E_OUTE (bsfread_int (&pHead->ab->ispace, idxFl))
 
   BS_DO_E_OUTE (bsfread_bsindex (&pHead->irtSz, idxFl))
@@ -847,17 +889,18 @@ void
       BS_DO_E_OUTE (bsfread_bsindex (&irtIdx, idxFl))
       BS_DO_E_OUTE (bsfread_bssmall (&schrsSz, idxFl))
       BS_DO_E_OUTE (hirtRd = bsdicidxhirtrd_new (schrsSz))
-      BS_DO_E_OUTE (bsdiixheadbs_add_hirtrd (pHead, hirtRd))
-      hirtRd = NULL;
-      pHead->hirt[i]->fchar = fchar;
-      pHead->hirt[i]->irtIdx = irtIdx;
-      if ( pHead->hirt[i]->schrsSz > 0 )
+      hirtRd->fchar = fchar;
+      hirtRd->irtIdx = irtIdx;
+      if ( hirtRd->schrsSz > 0 )
       {
-        BS_DO_E_OUTE(bsfread_bschars (pHead->hirt[i]->schars,
-                                      pHead->hirt[i]->schrsSz, idxFl))
-        BS_DO_E_OUTE(bsfread_bsindexes (pHead->hirt[i]->irtIdxs,
-                                        pHead->hirt[i]->schrsSz, idxFl))
+        BS_DO_E_OUTE(bsfread_bschars (hirtRd->schars,
+                                      hirtRd->schrsSz, idxFl))
+        BS_DO_E_OUTE(bsfread_bsindexes (hirtRd->irtIdxs,
+                                        hirtRd->schrsSz, idxFl))
       }
+      //HIRTLK is made by adding the last filled record:
+      BS_DO_E_OUTE (bsdiixheadbs_add_hirtrd (pHead, hirtRd))
+      hirtRd = NULL;
     }
   }
   *pDicFlRt = dicFl;
@@ -873,17 +916,177 @@ oute:
 }
 
 /**
- * <p>Reveal initial IRT range to seek for given word(sub) to match in AB coding.</p>
+ * <p>Make HIRTLK from completed HIRT.</p>
  * @param pHirt - HIRT
  * @param pHirtSz - HIRT size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxHirtLk*
+  bsdiixhirtlk_new (BsDiIxHirtRd **pHirt, int pHirtSz)
+{
+  //vars:
+  int i, j, c, chrsSz;
+  BS_CHAR_T mx;
+  BS_SMALL_T *row;
+  BsDiIxHirtRd *rd;
+  BsDiIxHirtLk *obj;
+  //code:
+  obj = NULL;
+  chrsSz = 0;
+  for ( i = 0; i < pHirtSz; i++ )
+  {
+    if ( pHirt[i]->fchar >= chrsSz )
+                    { chrsSz = pHirt[i]->fchar + 1; }
+    for ( j = 0; j < pHirt[i]->schrsSz; j++ )
+    {
+      if ( pHirt[i]->schars[j] >= chrsSz )
+                    { chrsSz = pHirt[i]->schars[j] + 1; }
+    }
+  }
+  obj = malloc (sizeof (BsDiIxHirtLk));
+  BS_IF_EN_OUTE (obj == NULL, ENOMEM)
+  obj->chrsSz = chrsSz;
+  obj->sIdxs = NULL;
+  obj->fIdxs = malloc (chrsSz * sizeof (int));
+  BS_IF_EN_OUTE (obj->fIdxs == NULL, ENOMEM)
+  for ( c = 0; c < chrsSz; c++ )
+                    { obj->fIdxs[c] = -1; }
+  for ( i = pHirtSz - 1; i >= 0; i-- )
+                    { obj->fIdxs[pHirt[i]->fchar] = i; } //the first wins
+  if ( (long) pHirtSz * chrsSz > BDI_HIRTLK_MAXSZ )
+  {
+    BSLOG_LOG (BSLWARN, "HIRTLK second chars rows are too big: %d * %d\n",
+               pHirtSz, chrsSz)
+    return obj;
+  }
+  obj->sIdxs = malloc ((size_t) pHirtSz * chrsSz * sizeof (BS_SMALL_T));
+  BS_IF_EN_OUTE (obj->sIdxs == NULL, ENOMEM)
+  //row[c] = the first second char's index that isn't less than c,
+  //i.e. the first one whose prefix maximum reaches c:
+  for ( i = 0; i < pHirtSz; i++ )
+  {
+    rd = pHirt[i];
+    row = obj->sIdxs + (size_t) i * chrsSz;
+    j = 0;
+    mx = rd->schrsSz > 0 ? rd->schars[0] : 0;
+    for ( c = 0; c < chrsSz; c++ )
+    {
+      while ( j < rd->schrsSz && mx < c )
+      {
+        j++;
+        if ( j < rd->schrsSz && rd->schars[j] > mx )
+                    { mx = rd->schars[j]; }
+      }
+      row[c] = j;
+    }
+  }
+  return obj;
+
+oute:
+  bsdiixhirtlk_free (obj);
+  return NULL;
+}
+
+/**
+ * <p>Destructor.</p>
+ * @param pHirtLk - HIRTLK or NULL
+ * @return always NULL
+ **/
+BsDiIxHirtLk*
+  bsdiixhirtlk_free (BsDiIxHirtLk *pHirtLk)
+{
+  if ( pHirtLk != NULL )
+  {
+    if ( pHirtLk->fIdxs != NULL )
+              { free (pHirtLk->fIdxs); }
+    if ( pHirtLk->sIdxs != NULL )
+              { free (pHirtLk->sIdxs); }
+    free (pHirtLk);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Reveal initial IRT range to seek for given word(sub) to match in AB coding.
+ * It's by HIRTLK if head has it, otherwise by scanning HIRT.</p>
+ * @param pHead - head with HIRT
  * @param pIwrd - word(sub) to match in AB coding
  * @param pIrtStartRt - pointer to return index start
  * @param pIrtEndRt - pointer to return index end
  * @set errno if error.
  **/
 void
-  bsdicidx_find_irtrange (BsDiIxHirtRd **pHirt, int pHirtSz, BS_CHAR_T *pIwrd,
+  bsdicidx_find_irtrange (BsDiIxHeadBs *pHead, BS_CHAR_T *pIwrd,
                           BS_IDX_T *pIrtStartRt, BS_IDX_T *pIrtEndRt)
+{
+  BsDiIxHirtLk *lk = pHead->hirtLk;
+  if ( lk == NULL )
+  {
+    bsdicidx_find_irtrange_scan (pHead->hirt, pHead->hirtSz, pIwrd,
+                                 pIrtStartRt, pIrtEndRt);
+    return;
+  }
+  if ( pIwrd[0] >= lk->chrsSz || lk->fIdxs[pIwrd[0]] < 0 )
+  { //first char never happen in this dictionary
+    return;
+  }
+  int hirtrdIdx = lk->fIdxs[pIwrd[0]];
+  BsDiIxHirtRd *hirtRd = pHead->hirt[hirtrdIdx];
+  BS_IDX_T irtStart;
+  BS_IDX_T irtEnd = BS_IDX_NULL;
+  if ( pIwrd[1] == 0 || hirtRd->schrsSz == 0 )
+  {
+    irtStart = hirtRd->irtIdx;
+  } else {
+    int i;
+    if ( pIwrd[1] >= lk->chrsSz )
+    {
+      i = hirtRd->schrsSz;
+    } else if ( lk->sIdxs != NULL ) {
+      i = lk->sIdxs[(size_t) hirtrdIdx * lk->chrsSz + pIwrd[1]];
+    } else {
+      for ( i = 0; i < hirtRd->schrsSz; i++ )
+      {
+        if ( hirtRd->schars[i] >= pIwrd[1] )
+                    { break; }
+      }
+    }
+    if ( i == hirtRd->schrsSz )
+    {
+      irtStart = hirtRd->irtIdxs[i - 1];
+    } else {
+      irtStart = hirtRd->irtIdxs[i];
+      if ( hirtRd->schars[i] > pIwrd[1] )
+      {
+        irtEnd = irtStart;
+      } else if ( i + 1 < hirtRd->schrsSz ) {
+        irtEnd = hirtRd->irtIdxs[i + 1];
+      }
+    }
+  }
+  if ( irtEnd == BS_IDX_NULL && hirtrdIdx != pHead->hirtSz - 1 )
+  {
+    irtEnd = pHead->hirt[hirtrdIdx + 1]->irtIdx - 1;
+  }
+  *pIrtStartRt = irtStart;
+  if ( irtEnd != BS_IDX_NULL )
+          { *pIrtEndRt = irtEnd; }
+}
+
+/**
+ * <p>Reveal initial IRT range to seek for given word(sub) to match in AB coding
+ * by scanning HIRT.</p>
+ * @param pHirt - HIRT
+ * @param pHirtSz - HIRT size
+ * @param pIwrd - word(sub) to match in AB coding
+ * @param pIrtStartRt - pointer to return index start
+ * @param pIrtEndRt - pointer to return index end
+ * @set errno if error.
+ **/
+void
+  bsdicidx_find_irtrange_scan (BsDiIxHirtRd **pHirt, int pHirtSz, BS_CHAR_T *pIwrd,
+                               BS_IDX_T *pIrtStartRt, BS_IDX_T *pIrtEndRt)
 {
   //1.find irtStRn of first up to two chars and irtEnRn:
   BsDiIxHirtRd *hirtRd = NULL;
@@ -41,6 +41,8 @@ See the LICENSE in the root source folder */
 #include "BsDicDescr.h"
 
 #define BDI_IDX_FILE_EXT ".idx"
+//IDX file is written into temporary one that replaces it:
+#define BDI_IDX_TMP_EXT ".tmp"
 
 //1. Basic dic's format independent models and services:
   //1.1 IDX file structure:
@@ -129,8 +131,46 @@ BsDiIxHirtRd* bsdicidxhirtrd_new_fill(BsDiIxHirtRdMk *pRcdmk);
 #define BSDIIXHIRTRD_NEW_FILL_E_OUTE(p_als,pRcdmk)  BsDiIxHirtRd* p_als=bsdicidxhirtrd_new_fill(pRcdmk);\
   if (errno != 0) { BSLOG_ERR goto oute; }
 
+//HIRTLK second chars rows max total cells, otherwise they are scanned:
+#define BDI_HIRTLK_MAXSZ 4194304L
+
+/**
+ * <p>HIRT direct lookup (HIRTLK) that is made when HIRT has been completed.
+ * First char's AB code is index in fIdxs, i.e. HIRT record's index,
+ * second char's AB code is index in record's row in sIdxs, i.e. index
+ * of the first record's second char that isn't less than it,
+ * so IRT range is narrowed in O(1) instead of scanning HIRT
+ * and its second chars.</p>
+ * @member int chrsSz - row size, i.e. max char's code + 1
+ * @member int *fIdxs - HIRT records indexes by first char or -1
+ * @member BS_SMALL_T *sIdxs - second chars rows hirtSz * chrsSz, or NULL
+ *   if they are too big
+ **/
+typedef struct {
+  int chrsSz;
+  int *fIdxs;
+  BS_SMALL_T *sIdxs;
+} BsDiIxHirtLk;
+
+/**
+ * <p>Make HIRTLK from completed HIRT.</p>
+ * @param pHirt - HIRT
+ * @param pHirtSz - HIRT size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxHirtLk *bsdiixhirtlk_new (BsDiIxHirtRd **pHirt, int pHirtSz);
+
+/**
+ * <p>Destructor.</p>
+ * @param pHirtLk - HIRTLK or NULL
+ * @return always NULL
+ **/
+BsDiIxHirtLk *bsdiixhirtlk_free (BsDiIxHirtLk *pHirtLk);
+
 /**
- * <p>Reveal initial IRT range to seek for given word(sub) to match in AB coding.</p>
+ * <p>Reveal initial IRT range to seek for given word(sub) to match in AB coding
+ * by scanning HIRT.</p>
  * @param pHirt - HIRT
  * @param pHirtSz - HIRT size
  * @param pIwrd - word(sub) to match in AB coding
@@ -139,8 +179,8 @@ BsDiIxHirtRd* bsdicidxhirtrd_new_fill(BsDiIxHirtRdMk *pRcdmk);
  * @set errno if error.
  **/
 void
-  bsdicidx_find_irtrange (BsDiIxHirtRd **pHirt, int pHirtSz, BS_CHAR_T *pIwrd,
-                          BS_IDX_T *pIrtStartRt, BS_IDX_T *pIrtEndRt);
+  bsdicidx_find_irtrange_scan (BsDiIxHirtRd **pHirt, int pHirtSz, BS_CHAR_T *pIwrd,
+                               BS_IDX_T *pIrtStartRt, BS_IDX_T *pIrtEndRt);
 
 /**
  * <p>Dictionary index's head basic IRT with fixed
@@ -155,9 +195,11 @@ void
  * @member bool isIxRm - if IRT in memory (RAM) otherwise in file, this is to satisfy client's prefs 
  * @member int hirtSz - HIRT size, if 0, then it's hieroglyph's dic, and no HIRT
  * @member BsDiIxHirtRd **hirt - head index records table HIRT, NULL for hieroglyph's dic
+ * @member BsDiIxHirtLk *hirtLk - HIRT direct lookup, NULL if HIRT isn't completed
  **/
 #define BSDIIXHEADBS BsString *nme;  EBsDicFrmts frmt; BsDicIdxAb *ab; int mxIrWdSz;\
-                     bool isIxRm; BS_IDX_T irtSz; int hirtSz; BsDiIxHirtRd **hirt;
+                     bool isIxRm; BS_IDX_T irtSz; int hirtSz; BsDiIxHirtRd **hirt;\
+                     BsDiIxHirtLk *hirtLk;
 
 /**
  * <p>Index file's head basic.</p>
@@ -185,14 +227,25 @@ BsDiIxHeadBs *bsdiixheadbs_free (BsDiIxHeadBs *pHead);
 
 
 /**
- * <p>Save (write/overwrite) IDX RAM's head base (in memory) into file.</p>
+ * <p>Save (write/overwrite) IDX RAM's head base (in memory) into file.
+ * It's temporary file that replaces IDX file by bsdiixheadbs_save_end,
+ * so any process that maps old IDX file is not affected.</p>
  * @param pDiIxRm IDX RAM.
  * @param pPth - dictionary path.
- * @return IDX file for further writing
+ * @return IDX file for further writing, it's also readable
  * @set errno if error.
  **/
 FILE* bsdiixheadbs_save (BsDiIxHeadBs *pHead, char *pPth);
 
+/**
+ * <p>End saving IDX file, i.e. replace IDX file by just written temporary
+ * one or remove temporary one after error. errno is kept.</p>
+ * @param pPth - dictionary path.
+ * @param pIsOk - whether temporary file is completely written
+ * @set errno if error.
+ **/
+void bsdiixheadbs_save_end (char *pPth, bool pIsOk);
+
 /**
  * <p>Load IDX head base from IDX file.</p>
  * @param pPth - dictionary path.
@@ -205,14 +258,28 @@ void bsdiixheadbs_load (char *pPth, BsDiIxHeadBs* pHead,
                     FILE ** pDicFlRt, FILE **pIdxFlRt);
 
 /**
- * <p>Add HIRT record.
- * It will allocate HIRT if it's NULL!</p>
+ * <p>Add filled HIRT record.
+ * It will allocate HIRT if it's NULL!
+ * HIRTLK is made when the last record has been added.</p>
  * @param pHead - pointer to IFH
  * @param pRcd HIRT record
  * @set errno if error.
  **/
 void bsdiixheadbs_add_hirtrd (BsDiIxHeadBs *pHead, BsDiIxHirtRd *pRcd);
 
+/**
+ * <p>Reveal initial IRT range to seek for given word(sub) to match in AB coding.
+ * It's by HIRTLK if head has it, otherwise by scanning HIRT.</p>
+ * @param pHead - head with HIRT
+ * @param pIwrd - word(sub) to match in AB coding
+ * @param pIrtStartRt - pointer to return index start
+ * @param pIrtEndRt - pointer to return index end
+ * @set errno if error.
+ **/
+void
+  bsdicidx_find_irtrange (BsDiIxHeadBs *pHead, BS_CHAR_T *pIwrd,
+                          BS_IDX_T *pIrtStartRt, BS_IDX_T *pIrtEndRt);
+
 /**
  * <p>Validate HIRT.</p>
  * @param pHirt HIRT
@@ -508,11 +575,28 @@ typedef enum {
  * @member EBsDicState stt - current state
  * @member int prgr - progress
  * @member stp - if client want to stop
+ * @member size_t memBdgt - memory budget to make IDX with sorted runs spilled
+ *   into temporary files, 0 means making IDX wholly in memory
+ * @member bool isBdgtAuto - pick memBdgt by bsdiixtxex_bdgt only when IDX
+ *   is about to be made or updated, so opening up to date IDX doesn't probe
+ *   available memory, default false
+ * @member bool dpVld - deep validation of saved IDX, i.e. verifying its
+ *   sections checksums and walking it, otherwise IDX with matching
+ *   check-summed head is trusted
+ * @member bool isFst - make and load headwords FST for prefix completion
+ *   and typos finding, default false
+ * @member bool isSa - make and load headwords SA for infix finding,
+ *   default false
  **/
 typedef struct {
   EBsDicState stt;
   int prgr;
   bool stp;
+  size_t memBdgt;
+  bool isBdgtAuto;
+  bool dpVld;
+  bool isFst;
+  bool isSa;
 } BsDiIxOst;
 
 /**
@@ -5,12 +5,13 @@ See the LICENSE in the root source folder */
 
 #include "stdlib.h"
 #include "string.h"
-#include "wctype.h"
 
 #include "BsError.h"
 #include "BsLog.h"
 #include "BsStrings.h"
 #include "BsFioWrap.h"
+#include "BsUcFold.h"
+#include "BsDiIxMm.h"
 #include "BsDiIxFind.h"
 
 /**
@@ -18,12 +19,152 @@ See the LICENSE in the root source folder */
  * @author Yury Demidenko
  **/
 
+//IDX in file tables are read from mapped IDX v2 if it's attached,
+//otherwise from IDX file, IRT by IRTSM's blocks if it's made:
+/**
+ * <p>Get IRT record's word.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIdx - IRT index
+ * @param pBuf - buffer mxIrWdSz to read or decode word into
+ * @return word in buffer or in mapped IDX v2 decoded block, or NULL if error
+ * @set errno if error.
+ **/
+static BS_CHAR_T*
+  s_irt_wrd (BsDiIxTx *pDiIx, BS_IDX_T pIdx, BS_CHAR_T *pBuf)
+{
+  if ( pDiIx->mm != NULL )
+                { return (BS_CHAR_T*) bsdiixmm_irt_wrd (pDiIx->mm, pIdx); }
+  if ( pDiIx->irtSm != NULL )
+  {
+    BS_DO_E_RETN (const char *rd = bsdiixtx_irtsm_rd (pDiIx, pIdx))
+    memcpy (pBuf, rd, pDiIx->head->mxIrWdSz * BS_CHAR_LEN);
+    return pBuf;
+  }
+  BS_FOFST_T ofst = pIdx * (BDI_IRTRD_FIXED_SIZE (pDiIx->head->mxIrWdSz, pDiIx->head->flgs))
+                  + pDiIx->irtOfst;
+  BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, ofst))
+  BS_DO_E_RETN (bsfread_bschars (pBuf, pDiIx->head->mxIrWdSz, pDiIx->idxFl))
+  return pBuf;
+}
+
+/**
+ * <p>Get IRT record's fields except word.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIrtrd - IRT record with index to fill
+ * @set errno if error.
+ **/
+static void
+  s_irt_rest (BsDiIxTx *pDiIx, BsDicFindIrtRd *pIrtrd)
+{
+  if ( pDiIx->mm != NULL )
+  {
+    pIrtrd->dwolt_start = BDI_IDXMM_DWST (pDiIx->mm, pIrtrd->idx);
+    pIrtrd->i2wpt_quantity = BDI_IDXMM_I2QN (pDiIx->mm, pIrtrd->idx);
+    pIrtrd->i2wpt_start = BDI_IDXMM_I2ST (pDiIx->mm, pIrtrd->idx);
+    return;
+  }
+  if ( pDiIx->irtSm != NULL )
+  {
+    BS_DO_E_RET (const char *rd = bsdiixtx_irtsm_rd (pDiIx, pIrtrd->idx))
+    bsdiixtx_dcd_irtrd (pDiIx, rd, &pIrtrd->dwolt_start,
+                        &pIrtrd->i2wpt_quantity, &pIrtrd->i2wpt_start);
+    return;
+  }
+  int flgs = pDiIx->head->flgs;
+  BS_FOFST_T ofst = pIrtrd->idx * (BDI_IRTRD_FIXED_SIZE (pDiIx->head->mxIrWdSz, flgs))
+                  + pDiIx->irtOfst + pDiIx->head->mxIrWdSz * BS_CHAR_LEN;
+  BS_DO_E_RET (bsfseek_goto (pDiIx->idxFl, ofst))
+  BS_DO_E_RET (bsdiixtx_read_idx (&pIrtrd->dwolt_start, flgs, pDiIx->idxFl))
+  BS_DO_E_RET (bsfread_bssmall (&pIrtrd->i2wpt_quantity, pDiIx->idxFl))
+  BS_DO_E_RET (bsdiixtx_read_idx (&pIrtrd->i2wpt_start, flgs, pDiIx->idxFl))
+}
+
+/**
+ * <p>Get whole IRT record.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIrtrd - IRT record with index to fill
+ * @set errno if error.
+ **/
+static void
+  s_irt_rd (BsDiIxTx *pDiIx, BsDicFindIrtRd *pIrtrd)
+{
+  if ( pDiIx->mm != NULL )
+  {
+    memcpy (pIrtrd->idx_subwrd, bsdiixmm_irt_wrd (pDiIx->mm, pIrtrd->idx),
+            pDiIx->head->mxIrWdSz * BS_CHAR_LEN);
+  } else {
+    BS_DO_E_RET (s_irt_wrd (pDiIx, pIrtrd->idx, pIrtrd->idx_subwrd))
+  }
+  s_irt_rest (pDiIx, pIrtrd);
+}
+
+/**
+ * <p>Get I2WPT record.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIdx - I2WPT index
+ * @return DWOLT index or BS_IDX_NULL if error
+ * @set errno if error.
+ **/
+static BS_IDX_T
+  s_i2wpt (BsDiIxTx *pDiIx, BS_IDX_T pIdx)
+{
+  if ( pDiIx->mm != NULL )
+                { return BDI_IDXMM_I2WPT (pDiIx->mm, pIdx); }
+  BS_IDX_T rz = BS_IDX_NULL;
+  BS_FOFST_T ofst = pIdx * (BDI_I2WPTRD_SIZE (pDiIx->head->flgs)) + pDiIx->i2wptOfst;
+  BS_DO_ERR (bsfseek_goto (pDiIx->idxFl, ofst))
+  if ( errno == 0 )
+                { bsdiixtx_read_idx (&rz, pDiIx->head->flgs, pDiIx->idxFl); }
+  return rz;
+}
+
+/**
+ * <p>Get DWOLT record.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIdx - DWOLT index
+ * @param pOfstRt - pointer to return word's offset in dictionary
+ * @param pLenRt - pointer to return word's length
+ * @set errno if error.
+ **/
+static void
+  s_dwolt (BsDiIxTx *pDiIx, BS_IDX_T pIdx, BS_FOFST_T *pOfstRt, BS_SMALL_T *pLenRt)
+{
+  if ( pDiIx->mm != NULL )
+  {
+    *pOfstRt = BDI_IDXMM_DWOFS (pDiIx->mm, pIdx);
+    *pLenRt = pDiIx->mm->dwoltLens[pIdx];
+    return;
+  }
+  int flgs = pDiIx->head->flgs;
+  BS_DO_E_RET (bsfseek_goto (pDiIx->idxFl, pIdx * (BDI_DWOLTRD_SIZE (flgs)) + pDiIx->dwoltOfst))
+  BS_DO_E_RET (bsdiixtx_read_ofst (pOfstRt, flgs, pDiIx->idxFl))
+  BS_DO_E_RET (bsfread_bssmall (pLenRt, pDiIx->idxFl))
+}
+
+/**
+ * <p>Get HWP record of IDX in file.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIdx - DWOLT index
+ * @return record in mapped IDX v2 or NULL if there is no HWP,
+ *   or headword isn't normalized
+ **/
+static const char*
+  s_hwp_rd (BsDiIxTx *pDiIx, BS_IDX_T pIdx)
+{
+  if ( pDiIx->mm == NULL || pDiIx->mm->hwp == NULL )
+                { return NULL; }
+  const char *rd = BDI_HWP_RD (pDiIx->mm->hwp, pIdx);
+  if ( BDI_HWP_MBSLEN (rd) == 0 )
+                { return NULL; }
+  return rd;
+}
+
 /**
  * <p>Read word in given dictionary and IDX in RAM and added into given matched array.
  * IDX DWOLT offset is already pointed.
  * </p>
  * @param pDiIxRm - dictionary and its whole index in memory
- * @param pIwrd - word(sub) to match in AB coding
+ * @param pIwrd - word(sub) to match in AB coding or NULL to add any word
  * @param p_dwoltidx DWOLT idx
  * @param pFdWrds - collection to add found record
  * @set errno if error.
@@ -32,13 +173,23 @@ void
   bsdiixrm_read_wrd (BsDiIxTxRm *pDiIxRm, BS_CHAR_T *pIwrd,
                      BS_IDX_T p_dwoltidx, BsDiFdWds *pFdWrds)
 {
+  if ( pDiIxRm->hwp != NULL )
+  { //normalized headword is in IDX:
+    const char *rd = BDI_HWP_RD (pDiIxRm->hwp, p_dwoltidx);
+    if ( BDI_HWP_MBSLEN (rd) > 0 )
+    {
+      if ( pIwrd == NULL || bsdicidx_istr_cont (BDI_HWP_ISTR (rd), pIwrd) )
+        { bsdifdwds_add_inc1 (pFdWrds, BDI_HWP_MBS (rd), (BsDiIxBs*) pDiIxRm, BDI_RM_DWOFS (pDiIxRm, p_dwoltidx)); }
+      return;
+    }
+  }
   //read word in DIC:
-  BS_DO_E_RET(bsfseek_goto(pDiIxRm->dicFl, pDiIxRm->dwolt[p_dwoltidx]->offset_dword))
-  int wsz = pDiIxRm->dwolt[p_dwoltidx]->length_dword + 1;
+  BS_DO_E_RET(bsfseek_goto(pDiIxRm->dicFl, BDI_RM_DWOFS (pDiIxRm, p_dwoltidx)))
+  int wsz = pDiIxRm->dwoltLens[p_dwoltidx] + 1;
   char wrd[wsz + 7];
   BS_DO_E_RET(bsfread_chars(wrd,
-    pDiIxRm->dwolt[p_dwoltidx]->length_dword, pDiIxRm->dicFl))
-  wrd[pDiIxRm->dwolt[p_dwoltidx]->length_dword] = 0;
+    pDiIxRm->dwoltLens[p_dwoltidx], pDiIxRm->dicFl))
+  wrd[pDiIxRm->dwoltLens[p_dwoltidx]] = 0;
   bsstring_escape_bslash(wrd);
   bsstring_escape_bounds_spaces(wrd);
   BS_WCHAR_T wstr[wsz];
@@ -51,13 +202,7 @@ void
     return;
   }
 //BSLOG_LOG (BSLDEBUG, "wstr %ls\n", wstr)
-  for ( int i = 0; ; i++ )
-  {
-    if ( wstr[i] == 0 )
-                    { break; }
-    if ( iswalpha(wstr[i]) )
-                    { wstr[i] = towlower(wstr[i]); }
-  }
+  bsucfold_wstr (wstr);
   rz =  wcstombs (wrd, wstr, wsz + 7);
   if ( rz <= 0 || errno != 0 )
   {
@@ -66,9 +211,9 @@ void
     return;
   }
   bsdicidxab_wstr_to_istr (wstr, istr, pDiIxRm->head->ab);
-  if ( bsdicidx_istr_cont (istr, pIwrd) )
+  if ( pIwrd == NULL || bsdicidx_istr_cont (istr, pIwrd) )
   { //filter first DWOLT words that belong to the same IRTRD and lower than requested word
-    bsdifdwds_add_inc1 (pFdWrds, wrd, (BsDiIxBs*) pDiIxRm, pDiIxRm->dwolt[p_dwoltidx]->offset_dword);
+    bsdifdwds_add_inc1 (pFdWrds, wrd, (BsDiIxBs*) pDiIxRm, BDI_RM_DWOFS (pDiIxRm, p_dwoltidx));
   }
 }
 
@@ -85,9 +230,10 @@ BsDicString*
   //read word in DIC:
   BS_FOFST_T dwofst;
   BS_SMALL_T dwlen;
-  BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, p_dwoltidx * (BDI_DWOLTRD_SIZE) + pDiIx->dwoltOfst))
-  BS_DO_E_RETN (bsfread_bsfoffset (&dwofst, pDiIx->idxFl))
-  BS_DO_E_RETN (bsfread_bssmall (&dwlen, pDiIx->idxFl))
+  BS_DO_E_RETN (s_dwolt (pDiIx, p_dwoltidx, &dwofst, &dwlen))
+  const char *rd = s_hwp_rd (pDiIx, p_dwoltidx);
+  if ( rd != NULL )
+                { return bsdicstring_new (BDI_HWP_MBS (rd), dwofst); }
   BS_DO_E_RETN (bsfseek_goto (pDiIx->dicFl, dwofst))
   char wrdb[dwlen + 8];
   BS_DO_E_RETN (bsfread_chars (wrdb, dwlen, pDiIx->dicFl))
@@ -102,13 +248,7 @@ BsDicString*
     BSLOG_LOG (BSLERROR, "mbstowcs fail for %s, rz=%d \n", wrdb, rz)
     return NULL;
   }
-  for ( int i = 0; ; i++ )
-  {
-    if ( wstr[i] == 0 )
-                    { break; }
-    if ( iswalpha(wstr[i]) )
-                    { wstr[i] = towlower(wstr[i]); }
-  }
+  bsucfold_wstr (wstr);
   rz =  wcstombs (wrdb, wstr, dwlen + 8);
   if ( rz <= 0 || errno != 0)
   {
@@ -124,7 +264,7 @@ BsDicString*
  * <p>Read word in given dictionary and IDX file and added into given matched array.
  * </p>
  * @param pDiIx - dictionary and its whole index in memory
- * @param pIwrd - word(sub) to match in AB coding
+ * @param pIwrd - word(sub) to match in AB coding or NULL to add any word
  * @param p_dwoltidx DWOLT idx
  * @param pFdWrds - collection to add found record
  * @set errno if error.
@@ -135,9 +275,14 @@ void
 { //read word in DIC:
   BS_FOFST_T dwofst;
   BS_SMALL_T dwlen;
-  BS_DO_E_RET (bsfseek_goto (pDiIx->idxFl, p_dwoltidx * (BDI_DWOLTRD_SIZE) + pDiIx->dwoltOfst))
-  BS_DO_E_RET (bsfread_bsfoffset (&dwofst, pDiIx->idxFl))
-  BS_DO_E_RET (bsfread_bssmall (&dwlen, pDiIx->idxFl))
+  BS_DO_E_RET (s_dwolt (pDiIx, p_dwoltidx, &dwofst, &dwlen))
+  const char *rd = s_hwp_rd (pDiIx, p_dwoltidx);
+  if ( rd != NULL )
+  {
+    if ( pIwrd == NULL || bsdicidx_istr_cont (BDI_HWP_ISTR (rd), pIwrd) )
+                { bsdifdwds_add_inc1 (pFdWrds, BDI_HWP_MBS (rd), (BsDiIxBs*) pDiIx, dwofst); }
+    return;
+  }
   BS_DO_E_RET (bsfseek_goto (pDiIx->dicFl, dwofst))
   char wrdb[dwlen + 8];
   BS_DO_E_RET (bsfread_chars (wrdb, dwlen, pDiIx->dicFl))
@@ -155,13 +300,7 @@ void
     return;
   }
 //BSLOG_LOG (BSLDEBUG, "wstr %ls\n", wstr)
-  for ( int i = 0; ; i++ )
-  {
-    if ( wstr[i] == 0 )
-                    { break; }
-    if ( iswalpha(wstr[i]) )
-                    { wstr[i] = towlower(wstr[i]); }
-  }
+  bsucfold_wstr (wstr);
   rz =  wcstombs (wrdb, wstr, dwlen + 8);
   if ( rz <= 0 || errno != 0)
   {
@@ -170,7 +309,7 @@ void
     return;
   }
   bsdicidxab_wstr_to_istr (wstr, istr, pDiIx->head->ab);
-  if ( bsdicidx_istr_cont (istr, pIwrd) )
+  if ( pIwrd == NULL || bsdicidx_istr_cont (istr, pIwrd) )
   { //filter first DWOLT words that belong to the same IRTRD and lower than requested word
     bsdifdwds_add_inc1 (pFdWrds, wrdb, (BsDiIxBs*) pDiIx, dwofst);
   }
@@ -197,7 +336,6 @@ BsDicString*
   if ( pIrtrd->dwolt_start != BS_IDX_NULL )
   { //where is direct iwords:
     BS_IDX_T dwidx;
-    BS_FOFST_T ofst;
     if ( pIrtrd->idx == pDiIx->head->irtSz - BS_IDX_1 )
     {
       for ( dwidx = pIrtrd->dwolt_start; dwidx < pDiIx->head->dwoltSz; dwidx++ )
@@ -239,12 +377,7 @@ BsDicString*
         pIrtrd->idx++;
         if ( pIrtrd->idx == pDiIx->head->irtSz )
                           { break; }
-        ofst = pIrtrd->idx * (BDI_IRTRD_FIXED_SIZE (pDiIx->head->mxIrWdSz)) + pDiIx->irtOfst;
-        BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, ofst))
-        BS_DO_E_RETN (bsfread_bschars (pIrtrd->idx_subwrd, pDiIx->head->mxIrWdSz, pDiIx->idxFl))
-        BS_DO_E_RETN (bsfread_bsindex (&pIrtrd->dwolt_start, pDiIx->idxFl))
-        BS_DO_E_RETN (bsfread_bssmall (&pIrtrd->i2wpt_quantity, pDiIx->idxFl))
-        BS_DO_E_RETN (bsfread_bsindex (&pIrtrd->i2wpt_start, pDiIx->idxFl))
+        BS_DO_E_RETN (s_irt_rd (pDiIx, pIrtrd))
       }
     }
   }
@@ -263,7 +396,6 @@ void bsdiixfindtst_mtch(BsDiIxTx *pDiIx,
   BS_CHAR_T *pIwrd, BsDicFindIrtRd *pIrtrd, BsDiFdWds *pFdWrds)
 {
   BS_IDX_T dwidx;
-  BS_FOFST_T ofst;
   if (pIrtrd->dwolt_start != BS_IDX_NULL) { //where is direct iwords:
     if (pIrtrd->idx == pDiIx->head->irtSz - BS_IDX_1) {
       for (dwidx = pIrtrd->dwolt_start;
@@ -276,9 +408,7 @@ void bsdiixfindtst_mtch(BsDiIxTx *pDiIx,
       if (pIrtrd->i2wpt_quantity > 0) {
         BS_IDX_T i2wptcl = pIrtrd->i2wpt_quantity;
         for (BS_IDX_T l = BS_IDX_0; l < i2wptcl; l++) {
-          ofst = (pIrtrd->i2wpt_start + l) * (BDI_I2WPTRD_SIZE) + pDiIx->i2wptOfst;
-          BS_DO_E_RET(bsfseek_goto(pDiIx->idxFl, ofst))
-          BS_DO_E_RET(bsfread_bsindex(&dwidx, pDiIx->idxFl))
+          BS_DO_E_RET(dwidx = s_i2wpt (pDiIx, pIrtrd->i2wpt_start + l))
           BS_DO_E_RET(bsdiix_read_wrd (pDiIx, pIwrd, dwidx, pFdWrds))
           if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
             return;
@@ -308,9 +438,7 @@ void bsdiixfindtst_mtch(BsDiIxTx *pDiIx,
         if (pIrtrd->i2wpt_quantity > 0) {
           BS_IDX_T i2wptcl = pIrtrd->i2wpt_quantity;
           for (BS_IDX_T l = BS_IDX_0; l < i2wptcl; l++) {
-            ofst = (pIrtrd->i2wpt_start + l) * (BDI_I2WPTRD_SIZE) + pDiIx->i2wptOfst;
-            BS_DO_E_RET(bsfseek_goto(pDiIx->idxFl, ofst))
-            BS_DO_E_RET(bsfread_bsindex(&dwidx, pDiIx->idxFl))
+            BS_DO_E_RET(dwidx = s_i2wpt (pDiIx, pIrtrd->i2wpt_start + l))
             BS_DO_E_RET(bsdiix_read_wrd (pDiIx, pIwrd, dwidx, pFdWrds))
             if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
               return;
@@ -321,12 +449,7 @@ void bsdiixfindtst_mtch(BsDiIxTx *pDiIx,
         if (pIrtrd->idx == pDiIx->head->irtSz) {
           break;
         }
-        ofst = pIrtrd->idx * (BDI_IRTRD_FIXED_SIZE(pDiIx->head->mxIrWdSz)) + pDiIx->irtOfst;
-        BS_DO_E_RET(bsfseek_goto(pDiIx->idxFl, ofst))
-        BS_DO_E_RET(bsfread_bschars(pIrtrd->idx_subwrd, pDiIx->head->mxIrWdSz, pDiIx->idxFl))
-        BS_DO_E_RET(bsfread_bsindex(&pIrtrd->dwolt_start, pDiIx->idxFl))
-        BS_DO_E_RET(bsfread_bssmall(&pIrtrd->i2wpt_quantity, pDiIx->idxFl))
-        BS_DO_E_RET(bsfread_bsindex(&pIrtrd->i2wpt_start, pDiIx->idxFl))
+        BS_DO_E_RET(s_irt_rd (pDiIx, pIrtrd))
       }
     }
   } else { //only i2words:
@@ -337,9 +460,7 @@ void bsdiixfindtst_mtch(BsDiIxTx *pDiIx,
     }
     BS_IDX_T i2wptcl = pIrtrd->i2wpt_quantity;
     for (BS_IDX_T l = BS_IDX_0; l < i2wptcl; l++) {
-      ofst = (pIrtrd->i2wpt_start + l) * (BDI_I2WPTRD_SIZE) + pDiIx->i2wptOfst;
-      BS_DO_E_RET(bsfseek_goto(pDiIx->idxFl, ofst))
-      BS_DO_E_RET(bsfread_bsindex(&dwidx, pDiIx->idxFl))
+      BS_DO_E_RET(dwidx = s_i2wpt (pDiIx, pIrtrd->i2wpt_start + l))
       BS_DO_E_RET(bsdiix_read_wrd (pDiIx, pIwrd, dwidx, pFdWrds))
       if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
         return;
@@ -360,21 +481,21 @@ void
   bsdiixrmfindtst_mtch (BsDiIxTxRm *pDiIxRm, BS_CHAR_T *pIwrd,
     BS_IDX_T p_irtidx, BsDiFdWds *pFdWrds)
 {
-  if (pDiIxRm->irt[p_irtidx]->dwolt_start != BS_IDX_NULL) { //where is direct iwords:
+  if (BDI_RM_DWST (pDiIxRm, p_irtidx) != BS_IDX_NULL) { //where is direct iwords:
     BS_IDX_T dwidx;
     if (p_irtidx == pDiIxRm->head->irtSz - BS_IDX_1) {
-      for (dwidx = pDiIxRm->irt[p_irtidx]->dwolt_start;
+      for (dwidx = BDI_RM_DWST (pDiIxRm, p_irtidx);
         dwidx < pDiIxRm->head->dwoltSz; dwidx++) {
         BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, pIwrd, dwidx, pFdWrds))
         if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
           return;
         }
       }
-      if (pDiIxRm->irt[p_irtidx]->i2wpt_quantity > 0) {
-        BS_IDX_T i2wptcl = pDiIxRm->irt[p_irtidx]->i2wpt_quantity;
+      if (pDiIxRm->irtI2Qns[p_irtidx] > 0) {
+        BS_IDX_T i2wptcl = pDiIxRm->irtI2Qns[p_irtidx];
         for (BS_IDX_T l = BS_IDX_0; l < i2wptcl; l++) {
           BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, pIwrd,
-            pDiIxRm->i2wpt[pDiIxRm->irt[p_irtidx]->i2wpt_start + l], pFdWrds))
+            BDI_RM_I2WPT (pDiIxRm, BDI_RM_I2ST (pDiIxRm, p_irtidx) + l), pFdWrds))
           if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
             return;
           }
@@ -382,29 +503,29 @@ void
       }
     } else {
       BS_IDX_T irtidxn = p_irtidx;
-      BS_IDX_T dwidxprev = pDiIxRm->irt[p_irtidx]->dwolt_start - BS_IDX_1;
+      BS_IDX_T dwidxprev = BDI_RM_DWST (pDiIxRm, p_irtidx) - BS_IDX_1;
       do {
-        bool isIrtwMtch = bsdicidx_istr_how_match(pIwrd, pDiIxRm->irt[irtidxn]->idx_subwrd) > 0;
-        if (pDiIxRm->irt[irtidxn]->dwolt_start != BS_IDX_NULL) {
-          for (dwidx = dwidxprev + BS_IDX_1; dwidx <= pDiIxRm->irt[irtidxn]->dwolt_start; dwidx++) {
-            if (!isIrtwMtch && dwidx == pDiIxRm->irt[irtidxn]->dwolt_start) {
+        bool isIrtwMtch = bsdicidx_istr_how_match(pIwrd, BDI_RM_IRTWRD(pDiIxRm, irtidxn)) > 0;
+        if (BDI_RM_DWST (pDiIxRm, irtidxn) != BS_IDX_NULL) {
+          for (dwidx = dwidxprev + BS_IDX_1; dwidx <= BDI_RM_DWST (pDiIxRm, irtidxn); dwidx++) {
+            if (!isIrtwMtch && dwidx == BDI_RM_DWST (pDiIxRm, irtidxn)) {
               return;
             }
             BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, pIwrd, dwidx, pFdWrds))
             if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
               return;
             }
-            dwidxprev = pDiIxRm->irt[irtidxn]->dwolt_start;
+            dwidxprev = BDI_RM_DWST (pDiIxRm, irtidxn);
           }
         }
         if (!isIrtwMtch) {
           return;
         }
-        if (pDiIxRm->irt[irtidxn]->i2wpt_quantity > 0) {
-          BS_IDX_T i2wptcl = pDiIxRm->irt[irtidxn]->i2wpt_quantity;
+        if (pDiIxRm->irtI2Qns[irtidxn] > 0) {
+          BS_IDX_T i2wptcl = pDiIxRm->irtI2Qns[irtidxn];
           for (BS_IDX_T l = BS_IDX_0; l < i2wptcl; l++) {
             BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, pIwrd,
-              pDiIxRm->i2wpt[pDiIxRm->irt[irtidxn]->i2wpt_start + l], pFdWrds))
+              BDI_RM_I2WPT (pDiIxRm, BDI_RM_I2ST (pDiIxRm, irtidxn) + l), pFdWrds))
             if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
               return;
             }
@@ -414,15 +535,15 @@ void
       } while (irtidxn < pDiIxRm->head->irtSz);
     }
   } else { //only i2words:
-    if (pDiIxRm->irt[p_irtidx]->i2wpt_quantity <= 0) { //previous validation must fail
+    if (pDiIxRm->irtI2Qns[p_irtidx] <= 0) { //previous validation must fail
       errno = BSE_VALIDATE_ERR;
       BSLOG_ERR
       return;
     }
-    BS_IDX_T i2wptcl = pDiIxRm->irt[p_irtidx]->i2wpt_quantity;
+    BS_IDX_T i2wptcl = pDiIxRm->irtI2Qns[p_irtidx];
     for (BS_IDX_T l = BS_IDX_0; l < i2wptcl; l++) {
       BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, pIwrd,
-        pDiIxRm->i2wpt[pDiIxRm->irt[p_irtidx]->i2wpt_start + l], pFdWrds))
+        BDI_RM_I2WPT (pDiIxRm, BDI_RM_I2ST (pDiIxRm, p_irtidx) + l), pFdWrds))
       if (pFdWrds->size >= BDI_MAX_MATCHED_WORDS) {
         return;
       }
@@ -431,8 +552,10 @@ void
 }
 
 /**
- * <p>Find MAXIMUM matched given word IRT record inside given range in given dictionary.</p>
- * @param pDiIxRm - dictionary and its whole index in memory
+ * <p>Find MAXIMUM matched given word IRT record inside given range in given dictionary.
+ * Binary search's probes are checked by IRTSM if it's made, so IDX file is read
+ * just in blocks where word's first char starts, ends or is found.</p>
+ * @param pDiIx - dictionary and IDX in file
  * @param pIwrd - word(sub) to match in AB coding
  * @param pIrtStart index IRT start
  * @param pIrtEnd index IRT end
@@ -448,8 +571,8 @@ BsDicFindIrtRd*
   bool isDbg = bslog_is_debug (BS_DEBUGL_DICIDXFIND + 80);
   BS_IDX_T irtStart = pIrtStart;
   BS_IDX_T irtEnd = pIrtEnd;
-  BS_CHAR_T irtstr[pDiIx->head->mxIrWdSz];
-  BS_FOFST_T ofst = BS_IDX_NULL;
+  BS_CHAR_T irtbuf[pDiIx->head->mxIrWdSz];
+  BS_CHAR_T *irtstr;
   int irtwlen, iwlen = bsdicidx_istr_len (pIwrd);
   if ( isDbg )
   {
@@ -459,10 +582,15 @@ BsDicFindIrtRd*
   while ( true )
   {
     BS_IDX_T midIdx = irtStart + ( irtEnd - irtStart ) / 2;
-    ofst = midIdx * ( BDI_IRTRD_FIXED_SIZE (pDiIx->head->mxIrWdSz) ) + pDiIx->irtOfst;
-    BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, ofst))
-    BS_DO_E_RETN (bsfread_bschars (irtstr, pDiIx->head->mxIrWdSz, pDiIx->idxFl))
-    int hcmpr = bsdicidx_istr_how_match (pIwrd, irtstr);
+    //IRTSM tells mismatched records without reading them:
+    int hcmpr = 1;
+    if ( pDiIx->mm == NULL && pDiIx->irtSm != NULL )
+          { hcmpr = bsdiixirtsm_cmp (pDiIx->irtSm, midIdx, pIwrd[0]); }
+    if ( hcmpr > 0 )
+    {
+      BS_DO_E_RETN (irtstr = s_irt_wrd (pDiIx, midIdx, irtbuf))
+      hcmpr = bsdicidx_istr_how_match (pIwrd, irtstr);
+    }
     if ( hcmpr > 0 )
     { //found 1st matched
       if ( isDbg )
@@ -471,9 +599,7 @@ BsDicFindIrtRd*
         BSLOG_LOG (BSLDEBUG, " found %ls, cntm=%d\n", wrd, hcmpr)
       }
       BSDICFINDIRTRD_NEW_E_RETN (irtrd, midIdx, irtstr, pDiIx->head->mxIrWdSz)
-      BS_DO_E_RETN (bsfread_bsindex (&irtrd->dwolt_start, pDiIx->idxFl))
-      BS_DO_E_RETN (bsfread_bssmall (&irtrd->i2wpt_quantity, pDiIx->idxFl))
-      BS_DO_E_RETN (bsfread_bsindex (&irtrd->i2wpt_start, pDiIx->idxFl))
+      BS_DO_E_RETN (s_irt_rest (pDiIx, irtrd))
       irtwlen = bsdicidx_istr_len (irtstr);
       if ( hcmpr == iwlen && irtwlen == iwlen )
                     { return irtrd; }
@@ -482,9 +608,7 @@ BsDicFindIrtRd*
         BS_IDX_T irtidxn = midIdx;
         while ( --irtidxn >= BS_IDX_0 )
         {
-          ofst = irtidxn * ( BDI_IRTRD_FIXED_SIZE(pDiIx->head->mxIrWdSz) ) + pDiIx->irtOfst;
-          BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, ofst))
-          BS_DO_E_RETN (bsfread_bschars (irtstr, pDiIx->head->mxIrWdSz, pDiIx->idxFl))
+          BS_DO_E_RETN (irtstr = s_irt_wrd (pDiIx, irtidxn, irtbuf))
           int hcmprn = bsdicidx_istr_how_match (pIwrd, irtstr);
           if ( isDbg )
           {
@@ -497,9 +621,7 @@ BsDicFindIrtRd*
             midIdx = irtidxn;
             irtrd->idx = irtidxn;
             bsdicidx_istr_cpy (irtrd->idx_subwrd, irtstr);
-            BS_DO_E_RETN (bsfread_bsindex (&irtrd->dwolt_start, pDiIx->idxFl))
-            BS_DO_E_RETN (bsfread_bssmall (&irtrd->i2wpt_quantity, pDiIx->idxFl))
-            BS_DO_E_RETN (bsfread_bsindex (&irtrd->i2wpt_start, pDiIx->idxFl))
+            BS_DO_E_RETN (s_irt_rest (pDiIx, irtrd))
             irtwlen = bsdicidx_istr_len (irtstr);
             if ( hcmpr == iwlen && irtwlen == iwlen )
                           { return irtrd; }
@@ -513,9 +635,7 @@ BsDicFindIrtRd*
         BS_IDX_T irtidxn = midIdx;
         while ( ++irtidxn < pDiIx->head->irtSz )
         {
-          ofst = irtidxn * ( BDI_IRTRD_FIXED_SIZE (pDiIx->head->mxIrWdSz) ) + pDiIx->irtOfst;
-          BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, ofst))
-          BS_DO_E_RETN (bsfread_bschars (irtstr, pDiIx->head->mxIrWdSz, pDiIx->idxFl))
+          BS_DO_E_RETN (irtstr = s_irt_wrd (pDiIx, irtidxn, irtbuf))
           int hcmprn = bsdicidx_istr_how_match (pIwrd, irtstr);
           if ( isDbg )
           {
@@ -528,9 +648,7 @@ BsDicFindIrtRd*
             midIdx = irtidxn;
             irtrd->idx = irtidxn;
             bsdicidx_istr_cpy (irtrd->idx_subwrd, irtstr);
-            BS_DO_E_RETN (bsfread_bsindex (&irtrd->dwolt_start, pDiIx->idxFl))
-            BS_DO_E_RETN (bsfread_bssmall (&irtrd->i2wpt_quantity, pDiIx->idxFl))
-            BS_DO_E_RETN (bsfread_bsindex (&irtrd->i2wpt_start, pDiIx->idxFl))
+            BS_DO_E_RETN (s_irt_rest (pDiIx, irtrd))
             irtwlen = bsdicidx_istr_len (irtstr);
             if ( hcmpr == iwlen && irtwlen == iwlen )
                           { return irtrd; }
@@ -559,7 +677,10 @@ BsDicFindIrtRd*
 }
 
 /**
- * <p>Find matched given word IRT record index inside given range in given dictionary.</p>
+ * <p>Find matched given word IRT record index inside given range in given dictionary.
+ * Matched words are ones with the same first char, the result is the first
+ * of them. Binary search never probes range's end unless range is single,
+ * so with IRTEZ it's found if matched records start before range's end.</p>
  * @param pDiIxRm - dictionary and its whole index in memory
  * @param pIwrd - word(sub) to match in AB coding
  * @param pIrtStart index IRT start
@@ -569,16 +690,25 @@ BsDicFindIrtRd*
  **/
 BS_IDX_T bsdiixrmfindtst_irtix(BsDiIxTxRm *pDiIxRm, BS_CHAR_T *pIwrd,
   BS_IDX_T pIrtStart, BS_IDX_T pIrtEnd) {
+  if ( pDiIxRm->irtEz != NULL && pIrtStart <= pIrtEnd )
+  {
+    BS_IDX_T mtchEnd = BS_IDX_NULL;
+    BS_IDX_T mtchStart = bsdiixirtez_find (pDiIxRm->irtEz, pIwrd[0], &mtchEnd);
+    BS_IDX_T prbEnd = pIrtEnd > pIrtStart ? pIrtEnd - BS_IDX_1 : pIrtStart;
+    if ( mtchStart == BS_IDX_NULL || mtchStart > prbEnd || mtchEnd < pIrtStart )
+          { return BS_IDX_NULL; }
+    return mtchStart;
+  }
   BS_IDX_T irtStart = pIrtStart;
   BS_IDX_T irtEnd = pIrtEnd;
   while (TRUE) {
     BS_IDX_T midIdx = irtStart + (irtEnd - irtStart) / 2;
-    int hcmpr = bsdicidx_istr_how_match(pIwrd, pDiIxRm->irt[midIdx]->idx_subwrd);
+    int hcmpr = bsdicidx_istr_how_match(pIwrd, BDI_RM_IRTWRD(pDiIxRm, midIdx));
     if (hcmpr > 0) { //found 1st matched
       BS_IDX_T irtidxn = midIdx;
       if (midIdx > BS_IDX_0) { //check lower words
         while (--irtidxn >= BS_IDX_0) {
-          hcmpr = bsdicidx_istr_how_match(pIwrd, pDiIxRm->irt[irtidxn]->idx_subwrd);
+          hcmpr = bsdicidx_istr_how_match(pIwrd, BDI_RM_IRTWRD(pDiIxRm, irtidxn));
           if (hcmpr > 0) {
             midIdx = irtidxn;
           } else {
@@ -675,7 +805,7 @@ void
   //1.find irtStRn of first up to two chars and irtEnRn:
   BS_IDX_T irtStRn = BS_IDX_0;
   BS_IDX_T irtEnRn = pDiIx->head->irtSz - BS_IDX_1;
-  BS_DO_E_RET (bsdicidx_find_irtrange(pDiIx->head->hirt, pDiIx->head->hirtSz, isubwrd, &irtStRn, &irtEnRn))
+  BS_DO_E_RET (bsdicidx_find_irtrange ((BsDiIxHeadBs*) pDiIx->head, isubwrd, &irtStRn, &irtEnRn))
   //2.find IRT record inside irtStRn-irtEnRn:
   BsDicFindIrtRd *irtrd = bsdiixfindtst_irtrd(pDiIx, isubwrd, irtStRn, irtEnRn);
   if ( irtrd == NULL ) {
@@ -716,7 +846,7 @@ void
   //1.find irtStRn of first up to two chars and irtEnRn:
   BS_IDX_T irtStRn = BS_IDX_0;
   BS_IDX_T irtEnRn = pDiIxRm->head->irtSz - BS_IDX_1;
-  BS_DO_E_RET (bsdicidx_find_irtrange(pDiIxRm->head->hirt, pDiIxRm->head->hirtSz, isubwrd, &irtStRn, &irtEnRn))
+  BS_DO_E_RET (bsdicidx_find_irtrange ((BsDiIxHeadBs*) pDiIxRm->head, isubwrd, &irtStRn, &irtEnRn))
   BS_DO_E_RET (BS_IDX_T irtidx = bsdiixrmfindtst_irtix(pDiIxRm, isubwrd, irtStRn, irtEnRn))
   if (isdbg)
     {  BSLOG_LOG(BSLDEBUG, "irtStRn="BS_IDX_FMT", irtEnRn="BS_IDX_FMT", irtidx="BS_IDX_FMT"\n", irtStRn, irtEnRn, irtidx); }
@@ -726,6 +856,675 @@ void
   bsdiixrmfindtst_mtch (pDiIxRm, isubwrd, irtidx, pFdWrds);
 }
 
+/**
+ * <p>Find all words that start with given prefix in given dictionary and IDX
+ * by FST, i.e. they are DWOLT range that is read in order.
+ * IDX without FST falls back to matching by IRT.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pPrfx - prefix to complete
+ * @set errno if error.
+ **/
+void
+  bsdiixtxfind_prfx (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pPrfx)
+{
+  const char *fst = pDiIx->mm != NULL ? pDiIx->mm->fst : pDiIx->fst;
+  if ( fst == NULL )
+  {
+    bsdiixtxfind_mtch (pDiIx, pFdWrds, pPrfx);
+    return;
+  }
+  int len = strlen (pPrfx);
+  BS_IF_EN_RET (len < 1, BSE_WRONG_PARAMS)
+  BS_CHAR_T iprfx[len + 1];
+  BS_DO_E_RET (bsdicidxab_str_to_istr (pPrfx, iprfx, pDiIx->head->ab))
+  BS_IDX_T dwidx, dwEnd;
+  dwidx = bsdiixfst_prefix (fst, iprfx, &dwEnd);
+  if ( dwidx == BS_IDX_NULL )
+                { return; }
+  for ( ; dwidx < dwEnd && pFdWrds->size < BDI_MAX_MATCHED_WORDS; dwidx++ )
+  {
+    BS_DO_E_RET (bsdiix_read_wrd (pDiIx, iprfx, dwidx, pFdWrds))
+  }
+}
+
+/**
+ * <p>Find all words that start with given prefix in given dictionary and IDX
+ * in RAM by FST. IDX without FST falls back to matching by IRT.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pPrfx - prefix to complete
+ * @set errno if error.
+ **/
+void
+  bsdiixtxrmfind_prfx (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pPrfx)
+{
+  if ( pDiIxRm->fst == NULL )
+  {
+    bsdiixtxrmfind_mtch (pDiIxRm, pFdWrds, pPrfx);
+    return;
+  }
+  int len = strlen (pPrfx);
+  BS_IF_EN_RET (len < 1, BSE_WRONG_PARAMS)
+  BS_CHAR_T iprfx[len + 1];
+  BS_DO_E_RET (bsdicidxab_str_to_istr (pPrfx, iprfx, pDiIxRm->head->ab))
+  BS_IDX_T dwidx, dwEnd;
+  dwidx = bsdiixfst_prefix (pDiIxRm->fst, iprfx, &dwEnd);
+  if ( dwidx == BS_IDX_NULL )
+                { return; }
+  for ( ; dwidx < dwEnd && pFdWrds->size < BDI_MAX_MATCHED_WORDS; dwidx++ )
+  {
+    BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, iprfx, dwidx, pFdWrds))
+  }
+}
+
+/**
+ * <p>Find words that contain given infix in given dictionary and IDX
+ * by SA in DWOLT order. IDX without SA is scanned in DWOLT order, i.e.
+ * every headword (from HWP or dictionary) is checked, so it's slow
+ * but it finds the same words.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pInfx - infix to find
+ * @set errno if error.
+ **/
+void
+  bsdiixtxfind_infx (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pInfx)
+{
+  const char *sa = pDiIx->mm != NULL ? pDiIx->mm->sa : pDiIx->sa;
+  int len = strlen (pInfx);
+  BS_IF_EN_RET (len < 1, BSE_WRONG_PARAMS)
+  int sz, room = BDI_MAX_MATCHED_WORDS - pFdWrds->size;
+  if ( room <= 0 )
+                { return; }
+  BS_CHAR_T iinfx[len + 1];
+  BS_DO_E_RET (bsdicidxab_str_to_istr (pInfx, iinfx, pDiIx->head->ab))
+  if ( iinfx[0] == 0 )
+                { return; } //none of its chars is in AB
+  if ( sa == NULL )
+  {
+    for ( BS_IDX_T l = BS_IDX_0; l < pDiIx->head->dwoltSz
+            && pFdWrds->size < BDI_MAX_MATCHED_WORDS; l++ )
+          { BS_DO_E_RET (bsdiix_read_wrd (pDiIx, iinfx, l, pFdWrds)) }
+    return;
+  }
+  BS_IDX_T idxs[room];
+  BS_DO_E_RET (sz = bsdiixsa_find (sa, iinfx, idxs, room))
+  for ( int i = 0; i < sz; i++ )
+  {
+    BS_DO_E_RET (bsdiix_read_wrd (pDiIx, NULL, idxs[i], pFdWrds))
+  }
+}
+
+/**
+ * <p>Find words that contain given infix in given dictionary and IDX
+ * in RAM by SA in DWOLT order. IDX without SA is scanned in DWOLT order,
+ * i.e. every headword (from HWP or dictionary) is checked.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pInfx - infix to find
+ * @set errno if error.
+ **/
+void
+  bsdiixtxrmfind_infx (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pInfx)
+{
+  int len = strlen (pInfx);
+  BS_IF_EN_RET (len < 1, BSE_WRONG_PARAMS)
+  int sz, room = BDI_MAX_MATCHED_WORDS - pFdWrds->size;
+  if ( room <= 0 )
+                { return; }
+  BS_CHAR_T iinfx[len + 1];
+  BS_DO_E_RET (bsdicidxab_str_to_istr (pInfx, iinfx, pDiIxRm->head->ab))
+  if ( iinfx[0] == 0 )
+                { return; } //none of its chars is in AB
+  if ( pDiIxRm->sa == NULL )
+  {
+    for ( BS_IDX_T l = BS_IDX_0; l < pDiIxRm->head->dwoltSz
+            && pFdWrds->size < BDI_MAX_MATCHED_WORDS; l++ )
+          { BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, iinfx, l, pFdWrds)) }
+    return;
+  }
+  BS_IDX_T idxs[room];
+  BS_DO_E_RET (sz = bsdiixsa_find (pDiIxRm->sa, iinfx, idxs, room))
+  for ( int i = 0; i < sz; i++ )
+  {
+    BS_DO_E_RET (bsdiixrm_read_wrd (pDiIxRm, NULL, idxs[i], pFdWrds))
+  }
+}
+
+/**
+ * <p>Find headwords of articles which content contains all query's terms
+ * (or the phrase) in given dictionary and IDX by its FTI in dictionary order.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFti - its FTI
+ * @param pFdWrds - collection to add found record
+ * @param pQry - query
+ * @param pIsPhr - whether terms must be a phrase
+ * @set errno if error.
+ **/
+void
+  bsdiixtxfind_fti (BsDiIxTx *pDiIx, BsDiIxFti *pFti, BsDiFdWds *pFdWrds,
+                    char *pQry, bool pIsPhr)
+{
+  int sz, room = BDI_MAX_MATCHED_WORDS - pFdWrds->size;
+  if ( room <= 0 )
+                { return; }
+  BS_IDX_T idxs[room];
+  BS_DO_E_RET (sz = bsdiixfti_find (pFti, pDiIx->head->ab, pQry, pIsPhr, idxs, room))
+  for ( int i = 0; i < sz; i++ )
+  {
+    BS_DO_E_RET (bsdiix_read_wrd (pDiIx, NULL, idxs[i], pFdWrds))
+  }
+}
+
+//max distance of typo tolerant finding, 0 - disabled:
+static int sFzDst = BDI_FST_FZ_DSTMX;
+
+/**
+ * <p>Set max distance of typo tolerant finding.</p>
+ * @param pDst - 0 (disabled) .. BDI_FST_FZ_DSTMX
+ * @set errno if error.
+ **/
+void
+  bsdiixfind_set_fzdst (int pDst)
+{
+  BS_IF_EN_RET (pDst < 0 || pDst > BDI_FST_FZ_DSTMX, BSE_WRONG_PARAMS)
+  sFzDst = pDst;
+}
+
+/**
+ * <p>Get max distance of typo tolerant finding.</p>
+ * @return 0 (disabled) .. BDI_FST_FZ_DSTMX
+ **/
+int
+  bsdiixfind_get_fzdst (void)
+{
+  return sFzDst;
+}
+
+/**
+ * <p>Reveal distance for given i.word, i.e. short words allow less typos:
+ * up to 2 chars - 0, up to 5 chars - 1, otherwise 2, but not more than max.</p>
+ * @param pIwrd - i.word
+ * @return distance
+ **/
+static int
+  s_fz_dst (BS_CHAR_T *pIwrd)
+{
+  int dst = bsdicidx_istr_len (pIwrd) / 3;
+  return dst < sFzDst ? dst : sFzDst;
+}
+
+/**
+ * <p>Check if there is found word of given dictionary.</p>
+ * @param pFdWrds - found words
+ * @param pDiIx - dictionary
+ * @return if found
+ **/
+static bool
+  s_is_fd (BsDiFdWds *pFdWrds, BsDiIxBs *pDiIx)
+{
+  for ( BS_IDX_T l = BS_IDX_0; l < pFdWrds->size; l++ )
+  {
+    BsDiSrDt1s *dos = pFdWrds->vals[l]->dicOfsts;
+    for ( BS_IDX_T d = BS_IDX_0; d < dos->size; d++ )
+    {
+      if ( dos->vals[d]->diIx == pDiIx )
+                { return true; }
+    }
+  }
+  return false;
+}
+
+/**
+ * <p>Find words which prefix differs from given word by few typos
+ * in given dictionary and IDX by FST, the closest ones first.
+ * IDX without FST finds nothing.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pWrd - word with typos
+ * @set errno if error.
+ **/
+void
+  bsdiixtxfind_fz (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pWrd)
+{
+  const char *fst = pDiIx->mm != NULL ? pDiIx->mm->fst : pDiIx->fst;
+  int sz, len = strlen (pWrd);
+  BS_IF_EN_RET (len < 1, BSE_WRONG_PARAMS)
+  if ( fst == NULL || pFdWrds->size >= BDI_MAX_MATCHED_WORDS )
+                { return; }
+  BS_CHAR_T iwrd[len + 1];
+  BS_DO_E_RET (bsdicidxab_str_to_istr (pWrd, iwrd, pDiIx->head->ab))
+  int dst = s_fz_dst (iwrd);
+  if ( dst == 0 )
+                { return; }
+  BS_DO_E_RET (BsDiIxFstFz *fzs = bsdiixfst_fuzzy (fst, iwrd, dst,
+          BDI_MAX_MATCHED_WORDS - pFdWrds->size, BDI_FST_FZ_ARCS, &sz))
+  for ( int i = 0; i < sz; i++ )
+  {
+    for ( BS_IDX_T dwidx = fzs[i].stt; dwidx < fzs[i].end
+            && pFdWrds->size < BDI_MAX_MATCHED_WORDS; dwidx++ )
+                { BS_DO_E_OUT (bsdiix_read_wrd (pDiIx, NULL, dwidx, pFdWrds)) }
+  }
+out:
+  free (fzs);
+}
+
+/**
+ * <p>Find words which prefix differs from given word by few typos
+ * in given dictionary and IDX in RAM by FST, the closest ones first.
+ * IDX without FST finds nothing.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pWrd - word with typos
+ * @set errno if error.
+ **/
+void
+  bsdiixtxrmfind_fz (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pWrd)
+{
+  int sz, len = strlen (pWrd);
+  BS_IF_EN_RET (len < 1, BSE_WRONG_PARAMS)
+  if ( pDiIxRm->fst == NULL || pFdWrds->size >= BDI_MAX_MATCHED_WORDS )
+                { return; }
+  BS_CHAR_T iwrd[len + 1];
+  BS_DO_E_RET (bsdicidxab_str_to_istr (pWrd, iwrd, pDiIxRm->head->ab))
+  int dst = s_fz_dst (iwrd);
+  if ( dst == 0 )
+                { return; }
+  BS_DO_E_RET (BsDiIxFstFz *fzs = bsdiixfst_fuzzy (pDiIxRm->fst, iwrd, dst,
+          BDI_MAX_MATCHED_WORDS - pFdWrds->size, BDI_FST_FZ_ARCS, &sz))
+  for ( int i = 0; i < sz; i++ )
+  {
+    for ( BS_IDX_T dwidx = fzs[i].stt; dwidx < fzs[i].end
+            && pFdWrds->size < BDI_MAX_MATCHED_WORDS; dwidx++ )
+                { BS_DO_E_OUT (bsdiixrm_read_wrd (pDiIxRm, NULL, dwidx, pFdWrds)) }
+  }
+out:
+  free (fzs);
+}
+
+/**
+ * <p>Find all matched words in given dictionary and IDX, if there is
+ * no such word, then find words with few typos.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pSbwrd - sub-word to match
+ * @set errno if error.
+ **/
+void
+  bsdiixtxfind_mtfz (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pSbwrd)
+{
+  BS_DO_E_RET (bsdiixtxfind_mtch (pDiIx, pFdWrds, pSbwrd))
+  if ( sFzDst > 0 && !s_is_fd (pFdWrds, (BsDiIxBs*) pDiIx) )
+                { bsdiixtxfind_fz (pDiIx, pFdWrds, pSbwrd); }
+}
+
+/**
+ * <p>Find all matched words in given dictionary and IDX in RAM, if there is
+ * no such word, then find words with few typos.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pSbwrd - sub-word to match
+ * @set errno if error.
+ **/
+void
+  bsdiixtxrmfind_mtfz (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pSbwrd)
+{
+  BS_DO_E_RET (bsdiixtxrmfind_mtch (pDiIxRm, pFdWrds, pSbwrd))
+  if ( sFzDst > 0 && !s_is_fd (pFdWrds, (BsDiIxBs*) pDiIxRm) )
+                { bsdiixtxrmfind_fz (pDiIxRm, pFdWrds, pSbwrd); }
+}
+
+//As-you-type finding session:
+
+/**
+ * <p>Get char of IRT record's word at given position.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIdx - IRT index
+ * @param pPos - position, word must not be shorter
+ * @param pBuf - buffer mxIrWdSz to read word into
+ * @return char or 0 if word ends there
+ * @set errno if error.
+ **/
+static BS_CHAR_T
+  s_irt_chr (BsDiIxTx *pDiIx, BS_IDX_T pIdx, int pPos, BS_CHAR_T *pBuf)
+{
+  if ( pPos >= pDiIx->head->mxIrWdSz )
+                { return 0; }
+  BS_CHAR_T *irtstr = s_irt_wrd (pDiIx, pIdx, pBuf);
+  if ( irtstr == NULL )
+                { return 0; }
+  return irtstr[pPos];
+}
+
+/**
+ * <p>Narrow IRT range of words with the same first pPos chars to ones
+ * which next char is given one. Range's words are ordered, so it's
+ * by two binary searches inside range.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pPos - char's position
+ * @param pChr - char
+ * @param pStRt - pointer to range start to narrow, it's set to BS_IDX_NULL
+ *   if there is no such word, then end is kept
+ * @param pEnRt - pointer to range end to narrow
+ * @set errno if error.
+ **/
+static void
+  s_irt_nrw (BsDiIxTx *pDiIx, int pPos, BS_CHAR_T pChr,
+             BS_IDX_T *pStRt, BS_IDX_T *pEnRt)
+{
+  BS_CHAR_T irtbuf[pDiIx->head->mxIrWdSz];
+  BS_IDX_T lo = *pStRt;
+  BS_IDX_T hi = *pEnRt + BS_IDX_1;
+  while ( lo < hi )
+  { //the first word which char isn't less:
+    BS_IDX_T midIdx = lo + ( hi - lo ) / 2;
+    BS_DO_E_RET (BS_CHAR_T chr = s_irt_chr (pDiIx, midIdx, pPos, irtbuf))
+    if ( chr < pChr )
+    {
+      lo = midIdx + BS_IDX_1;
+    } else {
+      hi = midIdx;
+    }
+  }
+  BS_CHAR_T chrSt = 0;
+  if ( lo <= *pEnRt )
+  {
+    BS_DO_E_RET (chrSt = s_irt_chr (pDiIx, lo, pPos, irtbuf))
+  }
+  if ( lo > *pEnRt || chrSt != pChr )
+  {
+    *pStRt = BS_IDX_NULL;
+    return;
+  }
+  BS_IDX_T st = lo;
+  hi = *pEnRt + BS_IDX_1;
+  while ( lo < hi )
+  { //the first word which char is greater:
+    BS_IDX_T midIdx = lo + ( hi - lo ) / 2;
+    BS_DO_E_RET (BS_CHAR_T chr = s_irt_chr (pDiIx, midIdx, pPos, irtbuf))
+    if ( chr <= pChr )
+    {
+      lo = midIdx + BS_IDX_1;
+    } else {
+      hi = midIdx;
+    }
+  }
+  *pStRt = st;
+  *pEnRt = lo - BS_IDX_1;
+}
+
+/**
+ * <p>Make state of session query's prefix with given length from
+ * the previous one without finding words. IRT record that is found by
+ * bsdiixfindtst_irtrd is the first one of the most matched words if it's
+ * equal to query, otherwise the last one. IDX in RAM matching always starts
+ * from the first word with the same first char (bsdiixrmfindtst_irtix).</p>
+ * @param pSsn - session with query
+ * @param pLen - prefix's length, previous states must be made
+ * @set errno if error.
+ **/
+static void
+  s_ssn_st (BsDiIxSsn *pSsn, int pLen)
+{
+  BsDiIxTx *diIx = (BsDiIxTx*) pSsn->diIx;
+  BsDiIxSsnSt *st = pSsn->sts + pLen - 1;
+  if ( pLen == 1 )
+  {
+    BS_CHAR_T iwrd[2] = { pSsn->iwrd[0], 0 };
+    st->mtch = 0;
+    st->irtSt = BS_IDX_NULL;
+    st->irtEn = pSsn->diIx->head->irtSz - BS_IDX_1;
+    st->irtIdx = BS_IDX_NULL;
+    BS_DO_E_RET (bsdicidx_find_irtrange ((BsDiIxHeadBs*) pSsn->diIx->head, iwrd, &st->irtSt, &st->irtEn))
+    if ( st->irtSt == BS_IDX_NULL )
+                { return; } //first char never happen in this dictionary
+    st->mtch = 1;
+    if ( pSsn->isIxRm )
+    {
+      BS_DO_E_RET (st->irtIdx = bsdiixrmfindtst_irtix ((BsDiIxTxRm*) pSsn->diIx, iwrd, st->irtSt, st->irtEn))
+      return;
+    }
+  } else {
+    *st = st[-1];
+    st->fdWds = NULL;
+    if ( pSsn->isIxRm || st->mtch < pLen - 1 )
+                { return; } //matching starts from the same IRT record
+    BS_DO_E_RET (s_irt_nrw (diIx, pLen - 1, pSsn->iwrd[pLen - 1], &st->irtSt, &st->irtEn))
+    if ( st->irtSt == BS_IDX_NULL )
+    { //no more matched words:
+      st->irtSt = st[-1].irtSt;
+      st->irtIdx = st->irtEn;
+      return;
+    }
+    st->mtch = pLen;
+  }
+  BS_CHAR_T irtbuf[diIx->head->mxIrWdSz];
+  BS_DO_E_RET (BS_CHAR_T chr = s_irt_chr (diIx, st->irtSt, pLen, irtbuf))
+  st->irtIdx = chr == 0 ? st->irtSt : st->irtEn;
+}
+
+/**
+ * <p>Add found word with all its dictionaries and offsets into collection.</p>
+ * @param pFdWrd - found word
+ * @param pFdWrds - collection to add into
+ * @set errno if error.
+ **/
+static void
+  s_fdwd_add (BsDiFdWd *pFdWrd, BsDiFdWds *pFdWrds)
+{
+  for ( BS_IDX_T d = BS_IDX_0; d < pFdWrd->dicOfsts->size; d++ )
+  {
+    BsDiSrDt1 *dos = pFdWrd->dicOfsts->vals[d];
+    BS_DO_E_RET (bsdifdwds_add_inc1 (pFdWrds, pFdWrd->wrd->val, dos->diIx, dos->ofst))
+  }
+}
+
+/**
+ * <p>Find words of session query's prefix with given length,
+ * its state must be made. If matching starts from the same IRT record as
+ * the previous prefix's one, then its words are filtered. Empty previous
+ * result isn't used, because matching in file stops at once when start
+ * IRT record's word isn't the prefix of query, e.g. "rm ü" for "rm ".</p>
+ * @param pSsn - session with query
+ * @param pLen - prefix's length
+ * @param pSbwrd - prefix to find words with typos
+ * @set errno if error.
+ **/
+static void
+  s_ssn_wds (BsDiIxSsn *pSsn, int pLen, char *pSbwrd)
+{
+  BsDiIxSsnSt *st = pSsn->sts + pLen - 1;
+  BS_DO_E_RET (st->fdWds = bsdifdwds_new (BS_IDX_10))
+  st->isFz = false;
+  BS_CHAR_T iwrd[pLen + 1];
+  memcpy (iwrd, pSsn->iwrd, pLen * BS_CHAR_LEN);
+  iwrd[pLen] = 0;
+  BsDiIxSsnSt *prv = pLen > 1 ? st - 1 : NULL;
+  if ( prv != NULL && prv->fdWds != NULL && !prv->isFz
+       && prv->irtIdx == st->irtIdx && st->irtIdx != BS_IDX_NULL
+       && prv->fdWds->size > 0 && prv->fdWds->size < BDI_MAX_MATCHED_WORDS )
+  { //the same candidates, they are all, so just filter them:
+    for ( BS_IDX_T l = BS_IDX_0; l < prv->fdWds->size; l++ )
+    {
+      char *wrd = prv->fdWds->vals[l]->wrd->val;
+      BS_CHAR_T istr[strlen (wrd) + 1];
+      BS_DO_E_RET (bsdicidxab_str_to_istr (wrd, istr, pSsn->diIx->head->ab))
+      if ( bsdicidx_istr_cont (istr, iwrd) )
+                { BS_DO_E_RET (s_fdwd_add (prv->fdWds->vals[l], st->fdWds)) }
+    }
+  } else if ( st->irtIdx != BS_IDX_NULL && pSsn->isIxRm ) {
+    BS_DO_E_RET (bsdiixrmfindtst_mtch ((BsDiIxTxRm*) pSsn->diIx, iwrd, st->irtIdx, st->fdWds))
+  } else if ( st->irtIdx != BS_IDX_NULL ) {
+    BsDiIxTx *diIx = (BsDiIxTx*) pSsn->diIx;
+    BS_CHAR_T irtbuf[diIx->head->mxIrWdSz];
+    BS_DO_E_RET (BS_CHAR_T *irtstr = s_irt_wrd (diIx, st->irtIdx, irtbuf))
+    BS_DO_E_RET (BsDicFindIrtRd *irtrd = bsdicfindirtrd_new (st->irtIdx, irtstr, diIx->head->mxIrWdSz))
+    s_irt_rest (diIx, irtrd);
+    if ( errno == 0 )
+                { bsdiixfindtst_mtch (diIx, iwrd, irtrd, st->fdWds); }
+    bsdicfindirtrd_free (irtrd);
+    if ( errno != 0 )
+    {
+      BSLOG_ERR
+      return;
+    }
+  }
+  if ( st->fdWds->size == 0 && sFzDst > 0 )
+  {
+    if ( pSsn->isIxRm )
+    {
+      BS_DO_E_RET (bsdiixtxrmfind_fz ((BsDiIxTxRm*) pSsn->diIx, st->fdWds, pSbwrd))
+    } else {
+      BS_DO_E_RET (bsdiixtxfind_fz ((BsDiIxTx*) pSsn->diIx, st->fdWds, pSbwrd))
+    }
+    st->isFz = st->fdWds->size > 0;
+  }
+}
+
+/**
+ * <p>Drop session's states of prefixes longer than given length.</p>
+ * @param pSsn - session
+ * @param pLen - length to keep
+ **/
+static void
+  s_ssn_pop (BsDiIxSsn *pSsn, int pLen)
+{
+  for ( int l = pLen; l < pSsn->len; l++ )
+          { pSsn->sts[l].fdWds = bsdifdwds_free (pSsn->sts[l].fdWds); }
+  if ( pSsn->len > pLen )
+          { pSsn->len = pLen; }
+}
+
+/**
+ * <p>Constructor.</p>
+ * @param pDiIx - DIC with IDX in file or in RAM
+ * @param pIsIxRm - whether IDX is in RAM
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxSsn*
+  bsdiixssn_new (BsDiIxBs *pDiIx, bool pIsIxRm)
+{
+  BsDiIxSsn *obj = malloc (sizeof (BsDiIxSsn));
+  if ( obj != NULL )
+  {
+    obj->diIx = pDiIx;
+    obj->isIxRm = pIsIxRm;
+    obj->len = 0;
+    obj->bufSz = BDI_SSN_BUFSZ;
+    obj->iwrd = malloc (obj->bufSz * BS_CHAR_LEN);
+    obj->sts = malloc (obj->bufSz * sizeof (BsDiIxSsnSt));
+    if ( obj->iwrd == NULL || obj->sts == NULL )
+          { obj = bsdiixssn_free (obj); }
+  }
+  if ( obj == NULL )
+  {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+  }
+  return obj;
+}
+
+/**
+ * <p>Destructor.</p>
+ * @param pSsn - session or NULL
+ * @return always NULL
+ **/
+BsDiIxSsn*
+  bsdiixssn_free (BsDiIxSsn *pSsn)
+{
+  if ( pSsn != NULL )
+  {
+    if ( pSsn->sts != NULL )
+    {
+      s_ssn_pop (pSsn, 0);
+      free (pSsn->sts);
+    }
+    if ( pSsn->iwrd != NULL )
+          { free (pSsn->iwrd); }
+    free (pSsn);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Find all matched words in session's dictionary, if there is
+ * no such word, then find words with few typos. Words are added into
+ * collection until it has BDI_MAX_MATCHED_WORDS.</p>
+ * @param pSsn - session
+ * @param pFdWrds - collection to add found record
+ * @param pSbwrd - sub-word to match
+ * @set errno if error.
+ **/
+void
+  bsdiixssn_find (BsDiIxSsn *pSsn, BsDiFdWds *pFdWrds, char *pSbwrd)
+{
+  int len = strlen (pSbwrd);
+  BS_IF_EN_RET (len < 1, BSE_WRONG_PARAMS)
+  BS_CHAR_T iwrd[len + 1];
+  BS_DO_E_RET (bsdicidxab_str_to_istr (pSbwrd, iwrd, pSsn->diIx->head->ab))
+  int ilen = bsdicidx_istr_len (iwrd);
+  if ( ilen == 0 )
+  { //there is no AB's char, so nothing matches:
+    s_ssn_pop (pSsn, 0);
+    if ( sFzDst > 0 )
+    {
+      if ( pSsn->isIxRm )
+      {
+        BS_DO_E_RET (bsdiixtxrmfind_fz ((BsDiIxTxRm*) pSsn->diIx, pFdWrds, pSbwrd))
+      } else {
+        BS_DO_E_RET (bsdiixtxfind_fz ((BsDiIxTx*) pSsn->diIx, pFdWrds, pSbwrd))
+      }
+    }
+    return;
+  }
+  //keep states of the same prefix:
+  int kpt = 0;
+  while ( kpt < pSsn->len && kpt < ilen && pSsn->iwrd[kpt] == iwrd[kpt] )
+          { kpt++; }
+  s_ssn_pop (pSsn, kpt);
+  if ( ilen > pSsn->bufSz )
+  {
+    int bufSz = ilen + BDI_SSN_BUFSZ;
+    BS_CHAR_T *niwrd = realloc (pSsn->iwrd, bufSz * BS_CHAR_LEN);
+    BS_IF_EN_RET (niwrd == NULL, ENOMEM)
+    pSsn->iwrd = niwrd;
+    BsDiIxSsnSt *nsts = realloc (pSsn->sts, bufSz * sizeof (BsDiIxSsnSt));
+    BS_IF_EN_RET (nsts == NULL, ENOMEM)
+    pSsn->sts = nsts;
+    pSsn->bufSz = bufSz;
+  }
+  memcpy (pSsn->iwrd, iwrd, ilen * BS_CHAR_LEN);
+  for ( int l = kpt + 1; l <= ilen; l++ )
+  {
+    pSsn->sts[l - 1].fdWds = NULL;
+    BS_DO_E_RET (s_ssn_st (pSsn, l))
+    pSsn->len = l;
+  }
+  BsDiIxSsnSt *st = pSsn->sts + ilen - 1;
+  if ( st->fdWds != NULL && ( st->isFz || st->fdWds->size == 0 ) )
+  { //words with typos depend on query itself and max distance:
+    st->fdWds = bsdifdwds_free (st->fdWds);
+  }
+  if ( st->fdWds == NULL )
+  {
+    s_ssn_wds (pSsn, ilen, pSbwrd);
+    if ( errno != 0 )
+    {
+      BSLOG_ERR
+      st->fdWds = bsdifdwds_free (st->fdWds);
+      return;
+    }
+  }
+  for ( BS_IDX_T l = BS_IDX_0; l < st->fdWds->size; l++ )
+  {
+    BS_DO_E_RET (s_fdwd_add (st->fdWds->vals[l], pFdWrds))
+    if ( pFdWrds->size >= BDI_MAX_MATCHED_WORDS )
+          { return; }
+  }
+}
+
 /**
  * <p>Find exactly matched word (lower case) in given dictionary and IDX.</p>
  * @param pDiIx IDX with head, opened DIC and IDX
@@ -744,7 +1543,7 @@ BsDicString*
   //1.find idxStartr of first up to two chars and idxEndr:
   BS_IDX_T idxStartr = BS_IDX_0;
   BS_IDX_T idxEndr = pDiIx->head->irtSz - BS_IDX_1;
-  BS_DO_E_RETN (bsdicidx_find_irtrange (pDiIx->head->hirt, pDiIx->head->hirtSz, iwrd, &idxStartr, &idxEndr))
+  BS_DO_E_RETN (bsdicidx_find_irtrange ((BsDiIxHeadBs*) pDiIx->head, iwrd, &idxStartr, &idxEndr))
   //2.find IRT record inside idxStartr-idxEndr:
   BS_DO_E_RETN (BsDicFindIrtRd *irtrd = bsdiixfindtst_irtrd (pDiIx, iwrd, idxStartr, idxEndr))
   if ( irtrd == NULL )
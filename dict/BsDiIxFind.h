@@ -14,6 +14,7 @@ See the LICENSE in the root source folder */
 #include "BsStrings.h"
 #include "BsDiIxTx.h"
 #include "BsDiIxT2.h"
+#include "BsDiIxFti.h"
 
 /**
  * <p>Index file's IRT record model with its index for finding purposes.</p>
@@ -59,6 +60,20 @@ BsDicFindIrtRd *bsdicfindirtrd_free (BsDicFindIrtRd *p_irt_rcd);
 BS_IDX_T bsdiixrmfindtst_irtix (BsDiIxTxRm *pDiIxRm, BS_CHAR_T *pIwrd,
   BS_IDX_T pIrtStart, BS_IDX_T pIrtEnd);
 
+/**
+ * <p>Find MAXIMUM matched given word IRT record inside given range in given dictionary.
+ * Binary search's probes are checked by IRTSM if it's made, so IDX file is read
+ * just in blocks where word's first char starts, ends or is found.</p>
+ * @param pDiIx - dictionary and IDX in file
+ * @param pIwrd - word(sub) to match in AB coding
+ * @param pIrtStart index IRT start
+ * @param pIrtEnd index IRT end
+ * @return IRT record matched to word or NULL if not found.
+ * @set errno if error.
+ **/
+BsDicFindIrtRd *bsdiixfindtst_irtrd (BsDiIxTx *pDiIx, BS_CHAR_T *pIwrd,
+                                     BS_IDX_T pIrtStart, BS_IDX_T pIrtEnd);
+
 /**
  * <p>Find all matched words in given dictionary and IDX file.</p>
  * @param pDiIx - dictionary and its whole index in memory
@@ -100,6 +115,195 @@ void bsdiixtxrmfind_mtch (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pSbwrd)
  **/
 void bsdiixtxfind_mtch (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pSbwrd);
 
+/**
+ * <p>Find all words that start with given prefix in given dictionary and IDX
+ * by FST in sorted order. IDX without FST falls back to matching by IRT.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pPrfx - prefix to complete
+ * @set errno if error.
+ **/
+void bsdiixtxfind_prfx (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pPrfx);
+
+/**
+ * <p>Find all words that start with given prefix in given dictionary and IDX
+ * in RAM by FST in sorted order. IDX without FST falls back to matching by IRT.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pPrfx - prefix to complete
+ * @set errno if error.
+ **/
+void bsdiixtxrmfind_prfx (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pPrfx);
+
+/**
+ * <p>Find words that contain given infix in given dictionary and IDX
+ * by SA in DWOLT order, e.g. "ens" finds "sense" and "common sense".
+ * IDX without SA is scanned in DWOLT order, i.e. every headword
+ * (from HWP or dictionary) is checked, so it's slow but it finds
+ * the same words.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pInfx - infix to find
+ * @set errno if error.
+ **/
+void bsdiixtxfind_infx (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pInfx);
+
+/**
+ * <p>Find words that contain given infix in given dictionary and IDX
+ * in RAM by SA in DWOLT order. IDX without SA is scanned in DWOLT order,
+ * i.e. every headword (from HWP or dictionary) is checked.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pInfx - infix to find
+ * @set errno if error.
+ **/
+void bsdiixtxrmfind_infx (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pInfx);
+
+/**
+ * <p>Find headwords of articles which content contains all query's terms
+ * (or the phrase) in given dictionary and IDX by its FTI in dictionary order,
+ * e.g. "mouth disease" finds "send" which article has "foot-and-mouth disease".</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFti - its FTI
+ * @param pFdWrds - collection to add found record
+ * @param pQry - query
+ * @param pIsPhr - whether terms must be a phrase
+ * @set errno if error.
+ **/
+void bsdiixtxfind_fti (BsDiIxTx *pDiIx, BsDiIxFti *pFti, BsDiFdWds *pFdWrds,
+                       char *pQry, bool pIsPhr);
+
+/**
+ * <p>Set max distance of typo tolerant finding.</p>
+ * @param pDst - 0 (disabled) .. BDI_FST_FZ_DSTMX, default is the max
+ * @set errno if error.
+ **/
+void bsdiixfind_set_fzdst (int pDst);
+
+/**
+ * <p>Get max distance of typo tolerant finding.</p>
+ * @return 0 (disabled) .. BDI_FST_FZ_DSTMX
+ **/
+int bsdiixfind_get_fzdst (void);
+
+/**
+ * <p>Find words which prefix differs from given word by few typos
+ * in given dictionary and IDX by FST, the closest ones first.
+ * Distance is up to 1 for 3..5 chars word, up to 2 for longer one,
+ * but not more than max one. IDX without FST finds nothing.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pWrd - word with typos
+ * @set errno if error.
+ **/
+void bsdiixtxfind_fz (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pWrd);
+
+/**
+ * <p>Find words which prefix differs from given word by few typos
+ * in given dictionary and IDX in RAM by FST, the closest ones first.
+ * Distance is up to 1 for 3..5 chars word, up to 2 for longer one,
+ * but not more than max one. IDX without FST finds nothing.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pWrd - word with typos
+ * @set errno if error.
+ **/
+void bsdiixtxrmfind_fz (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pWrd);
+
+/**
+ * <p>Find all matched words in given dictionary and IDX, if there is
+ * no such word, then find words with few typos.</p>
+ * @param pDiIx - DIC with IDX
+ * @param pFdWrds - collection to add found record
+ * @param pSbwrd - sub-word to match
+ * @set errno if error.
+ **/
+void bsdiixtxfind_mtfz (BsDiIxTx *pDiIx, BsDiFdWds *pFdWrds, char *pSbwrd);
+
+/**
+ * <p>Find all matched words in given dictionary and IDX in RAM, if there is
+ * no such word, then find words with few typos.</p>
+ * @param pDiIxRm - DIC with IDX in RAM
+ * @param pFdWrds - collection to add found record
+ * @param pSbwrd - sub-word to match
+ * @set errno if error.
+ **/
+void bsdiixtxrmfind_mtfz (BsDiIxTxRm *pDiIxRm, BsDiFdWds *pFdWrds, char *pSbwrd);
+
+//initial size of as-you-type finding session's buffers:
+#define BDI_SSN_BUFSZ 32
+
+/**
+ * <p>As-you-type finding session's state of query's prefix.</p>
+ * @member int mtch - how many prefix's first chars IRT words match, 0 if none
+ * @member BS_IDX_T irtSt - the first IRT record which word matches mtch chars
+ *   or BS_IDX_NULL if none
+ * @member BS_IDX_T irtEn - the last one
+ * @member BS_IDX_T irtIdx - IRT record which matching starts from or BS_IDX_NULL
+ * @member bool isFz - whether words were found with typos
+ * @member BsDiFdWds *fdWds - prefix's words or NULL if they weren't found yet
+ **/
+typedef struct {
+  int mtch;
+  BS_IDX_T irtSt;
+  BS_IDX_T irtEn;
+  BS_IDX_T irtIdx;
+  bool isFz;
+  BsDiFdWds *fdWds;
+} BsDiIxSsnSt;
+
+/**
+ * <p>As-you-type finding session of dictionary with IDX in file or in RAM.
+ * It keeps states of every prefix of the last query, so typed char narrows
+ * the previous IRT range (the first char's one is HIRT's one) instead of
+ * finding it from scratch, and matched words of extended query are filtered
+ * from the previous ones if they are started from the same IRT record
+ * and weren't cut by BDI_MAX_MATCHED_WORDS. Deleted char pops cached state.
+ * Found words are the same as bsdiixtxfind_mtfz/bsdiixtxrmfind_mtfz ones.
+ * It isn't thread-safe as well as reading IDX file.</p>
+ * @member BsDiIxBs *diIx - DIC with IDX
+ * @member bool isIxRm - whether IDX is in RAM
+ * @member int len - states total, i.e. the last query's length
+ * @member int bufSz - buffers size
+ * @member BS_CHAR_T *iwrd - the last query in AB coding
+ * @member BsDiIxSsnSt *sts - states, the K-th one is of K+1 chars prefix
+ **/
+typedef struct {
+  BsDiIxBs *diIx;
+  bool isIxRm;
+  int len;
+  int bufSz;
+  BS_CHAR_T *iwrd;
+  BsDiIxSsnSt *sts;
+} BsDiIxSsn;
+
+/**
+ * <p>Constructor.</p>
+ * @param pDiIx - DIC with IDX in file or in RAM
+ * @param pIsIxRm - whether IDX is in RAM
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxSsn *bsdiixssn_new (BsDiIxBs *pDiIx, bool pIsIxRm);
+
+/**
+ * <p>Destructor.</p>
+ * @param pSsn - session or NULL
+ * @return always NULL
+ **/
+BsDiIxSsn *bsdiixssn_free (BsDiIxSsn *pSsn);
+
+/**
+ * <p>Find all matched words in session's dictionary, if there is
+ * no such word, then find words with few typos. Words are added into
+ * collection until it has BDI_MAX_MATCHED_WORDS.</p>
+ * @param pSsn - session
+ * @param pFdWrds - collection to add found record
+ * @param pSbwrd - sub-word to match
+ * @set errno if error.
+ **/
+void bsdiixssn_find (BsDiIxSsn *pSsn, BsDiFdWds *pFdWrds, char *pSbwrd);
+
 //This useful only for tests purposes, because finding word's definition by clicking it in the text is also done by find matches,
 //although, text words marked with <<any word>> can by seek with methods below:
 /**
@@ -0,0 +1,363 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+#include "stdlib.h"
+#include "string.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsFioWrap.h"
+#include "BsDicWordDsl.h"
+#include "BsDiIxFpt.h"
+
+/**
+ * <p>Beigesoft™ IDX fingerprints table (FPT).</p>
+ * @author Yury Demidenko
+ **/
+
+//FNV-1a 64 bit:
+#define S_FNV_BASIS 14695981039346656037UL
+#define S_FNV_PRIME 1099511628211UL
+
+//initial chunks buffer size:
+#define S_FPT_INITSIZE 64L
+
+/**
+ * <p>Continue FNV-1a hash with given bytes.</p>
+ * @param pHash - hash so far
+ * @param pDt - bytes
+ * @param pSz - bytes total
+ * @return hash
+ **/
+static unsigned long
+  s_fnv (unsigned long pHash, char *pDt, BS_FOFST_T pSz)
+{
+  for ( BS_FOFST_T i = BS_FOFST_0; i < pSz; i++ )
+  {
+    pHash ^= (unsigned char) pDt[i];
+    pHash *= S_FNV_PRIME;
+  }
+  return pHash;
+}
+
+/**
+ * <p>Add new chunk.</p>
+ * @param pFpt - FPT
+ * @param pBsz - pointer to buffer size
+ * @param pOfst - chunk's start
+ * @param pHash - chunk's hash
+ * @set errno if error.
+ **/
+static void
+  s_add (BsDiIxFpt *pFpt, BS_IDX_T *pBsz, BS_FOFST_T pOfst, unsigned long pHash)
+{
+  if ( pFpt->size == *pBsz )
+  {
+    BsDiIxFptRd *vals = realloc (pFpt->vals, *pBsz * 2 * sizeof (BsDiIxFptRd));
+    if ( vals == NULL )
+    {
+      if ( errno == 0 ) { errno = ENOMEM; }
+      BSLOG_ERR
+      return;
+    }
+    pFpt->vals = vals;
+    *pBsz = *pBsz * 2;
+  }
+  pFpt->vals[pFpt->size].ofst = pOfst;
+  pFpt->vals[pFpt->size].hash = pHash;
+  pFpt->vals[pFpt->size].dupSz = BS_IDX_0;
+  pFpt->size++;
+}
+
+/**
+ * <p>Constructor of empty FPT.</p>
+ * @param pBsz - buffer size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+static BsDiIxFpt*
+  s_new (BS_IDX_T pBsz)
+{
+  BsDiIxFpt *obj = malloc (sizeof (BsDiIxFpt));
+  if ( obj != NULL )
+  {
+    obj->dicSz = BS_FOFST_0; obj->mtime = 0L; obj->fptOfst = BS_FOFST_NULL;
+    obj->size = BS_IDX_0;
+    obj->vals = malloc (( pBsz < BS_IDX_1 ? BS_IDX_1 : pBsz ) * sizeof (BsDiIxFptRd));
+    if ( obj->vals == NULL )
+                { obj = bsdiixfpt_free (obj); }
+  }
+  if ( obj == NULL )
+  {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+  }
+  return obj;
+}
+
+/**
+ * <p>Destructor.</p>
+ * @param pFpt - FPT or NULL
+ * @return always NULL
+ **/
+BsDiIxFpt*
+  bsdiixfpt_free (BsDiIxFpt *pFpt)
+{
+  if ( pFpt != NULL )
+  {
+    if ( pFpt->vals != NULL )
+                { free (pFpt->vals); }
+    free (pFpt);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Read dictionary size and modification time.</p>
+ * @param pPth - dictionary path
+ * @param pDicSzRt - pointer to return size
+ * @param pMtimeRt - pointer to return modification time in nanoseconds
+ * @set errno if error.
+ **/
+void
+  bsdiixfpt_stat (char *pPth, BS_FOFST_T *pDicSzRt, long *pMtimeRt)
+{
+  struct stat st;
+  BS_IF_EN_RET (stat (pPth, &st) != 0, BSE_OPEN_FILE)
+  *pDicSzRt = st.st_size;
+  *pMtimeRt = st.st_mtim.tv_sec * 1000000000L + st.st_mtim.tv_nsec;
+}
+
+/**
+ * <p>Make FPT by splitting mapped dictionary into chunks.
+ * Chunk ends before article (headword line after content or empty line)
+ * whose headword line's hash matches mask, but chunk is never less than
+ * BDI_FPT_CHUNK_MINSZ and more than BDI_FPT_CHUNK_MAXSZ.
+ * Duplicates totals are zero.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pPth - dictionary path
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFpt*
+  bsdiixfpt_new_make (BsDicDslMm *pDslMm, int pDeBufSz, char *pPth)
+{
+  BS_FOFST_T pos, stt, lnEnd;
+  BS_IDX_T bsz = S_FPT_INITSIZE;
+  unsigned long hash, lnHash;
+  bool isHw, isArt;
+  char *en, c;
+  BS_DO_E_RETN (BsDiIxFpt *fpt = s_new (bsz))
+  BS_DO_E_OUTE (bsdiixfpt_stat (pPth, &fpt->dicSz, &fpt->mtime))
+  if ( fpt->dicSz != pDslMm->sz )
+  {
+    errno = BSE_ALG_ERR;
+    BSLOG_LOG (BSLERROR, "Dictionary %s has been changed while mapping\n", pPth)
+    goto oute;
+  }
+  stt = BS_FOFST_0;
+  hash = S_FNV_BASIS;
+  if ( pDslMm->sz > BS_FOFST_0 )
+  {
+    //head is in the first chunk:
+    BS_DO_E_OUTE (pos = bsdicdslmm_find_art (pDslMm, pDeBufSz, BS_FOFST_0))
+    hash = s_fnv (hash, pDslMm->dt, pos);
+    isArt = true;
+    while ( pos < pDslMm->sz )
+    {
+      en = memchr (pDslMm->dt + pos, '\n', pDslMm->sz - pos);
+      lnEnd = en == NULL ? pDslMm->sz : en - pDslMm->dt + 1;
+      c = pDslMm->dt[pos];
+      isHw = c != '\t' && c != ' ' && c != '\n' && c != '\r';
+      if ( isHw && isArt && pos - stt >= BDI_FPT_CHUNK_MINSZ )
+      {
+        lnHash = s_fnv (S_FNV_BASIS, pDslMm->dt + pos, lnEnd - pos);
+        if ( ( ( lnHash ^ ( lnHash >> 29 ) ) & BDI_FPT_CHUNK_MASK ) == 0
+              || pos - stt >= BDI_FPT_CHUNK_MAXSZ )
+        {
+          BS_DO_E_OUTE (s_add (fpt, &bsz, stt, hash))
+          stt = pos;
+          hash = S_FNV_BASIS;
+        }
+      }
+      hash = s_fnv (hash, pDslMm->dt + pos, lnEnd - pos);
+      isArt = !isHw;
+      pos = lnEnd;
+    }
+  }
+  BS_DO_E_OUTE (s_add (fpt, &bsz, stt, hash))
+  BSLOG_LOG (BSLINFO, "Made FPT for %s, size="BS_FOFST_FMT", chunks="BS_IDX_FMT"\n", pPth, fpt->dicSz, fpt->size)
+  return fpt;
+
+oute:
+  bsdiixfpt_free (fpt);
+  return NULL;
+}
+
+/**
+ * <p>Find chunk that contains given offset.</p>
+ * @param pFpt - FPT
+ * @param pOfst - offset in dictionary
+ * @return chunk's index
+ **/
+BS_IDX_T
+  bsdiixfpt_find (BsDiIxFpt *pFpt, BS_FOFST_T pOfst)
+{
+  BS_IDX_T lo = BS_IDX_0, hi = pFpt->size - 1, md;
+  while ( lo < hi )
+  {
+    md = lo + ( hi - lo + 1 ) / 2;
+    if ( pFpt->vals[md].ofst <= pOfst )
+    {
+      lo = md;
+    } else {
+      hi = md - 1;
+    }
+  }
+  return lo;
+}
+
+/**
+ * <p>Get chunk's size.</p>
+ * @param pFpt - FPT
+ * @param pIdx - chunk's index
+ * @return chunk's size
+ **/
+BS_FOFST_T
+  bsdiixfpt_chunk_sz (BsDiIxFpt *pFpt, BS_IDX_T pIdx)
+{
+  if ( pIdx + 1 < pFpt->size )
+                { return pFpt->vals[pIdx + 1].ofst - pFpt->vals[pIdx].ofst; }
+  return pFpt->dicSz - pFpt->vals[pIdx].ofst;
+}
+
+/**
+ * <p>Add headwords into chunks duplicates totals.</p>
+ * @param pFpt - FPT
+ * @param pOfsts - headwords offsets
+ * @param pCnt - headwords total
+ **/
+void
+  bsdiixfpt_add_hws (BsDiIxFpt *pFpt, BS_FOFST_T *pOfsts, BS_IDX_T pCnt)
+{
+  for ( BS_IDX_T l = BS_IDX_0; l < pCnt; l++ )
+              { pFpt->vals[bsdiixfpt_find (pFpt, pOfsts[l])].dupSz++; }
+}
+
+/**
+ * <p>Subtract DWOLT records, i.e. i.words with headwords,
+ * from chunks duplicates totals.</p>
+ * @param pFpt - FPT
+ * @param pIwrds - sorted i.words without duplicates
+ * @set errno if error.
+ **/
+void
+  bsdiixfpt_sub_dwolt (BsDiIxFpt *pFpt, BsDicIwrds *pIwrds)
+{
+  BS_IDX_T l;
+  for ( l = BS_IDX_0; l < pIwrds->size; l++ )
+  {
+    if ( pIwrds->vals[l]->length_dword != 0 )
+      { pFpt->vals[bsdiixfpt_find (pFpt, pIwrds->vals[l]->offset_dword)].dupSz--; }
+  }
+  for ( l = BS_IDX_0; l < pFpt->size; l++ )
+  {
+    if ( pFpt->vals[l].dupSz < BS_IDX_0 )
+    {
+      errno = BSE_ALG_ERR;
+      BSLOG_LOG (BSLERROR, "FPT chunk#"BS_IDX_FMT" has more DWOLT records than headwords\n", l)
+      return;
+    }
+  }
+}
+
+/**
+ * <p>Write FPT at the current IDX file's position (its end).</p>
+ * @param pFpt - FPT
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixfpt_save (BsDiIxFpt *pFpt, FILE *pIdxFl)
+{
+  int mgc = BDI_FPT_MAGIC;
+  pFpt->fptOfst = ftell (pIdxFl);
+  BS_DO_E_RET (bsfwrite_bsfoffset (&pFpt->dicSz, pIdxFl))
+  BS_DO_E_RET (bsfwrite_long (&pFpt->mtime, pIdxFl))
+  BS_DO_E_RET (bsfwrite_bsindex (&pFpt->size, pIdxFl))
+  for ( BS_IDX_T l = BS_IDX_0; l < pFpt->size; l++ )
+  {
+    BS_DO_E_RET (bsfwrite_bsfoffset (&pFpt->vals[l].ofst, pIdxFl))
+    BS_DO_E_RET (bsfwrite_ulong (&pFpt->vals[l].hash, pIdxFl))
+    BS_DO_E_RET (bsfwrite_bsindex (&pFpt->vals[l].dupSz, pIdxFl))
+  }
+  BS_DO_E_RET (bsfwrite_bsfoffset (&pFpt->fptOfst, pIdxFl))
+  BS_DO_E_RET (bsfwrite_int (&mgc, pIdxFl))
+}
+
+/**
+ * <p>Load FPT from the end of IDX file. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @return object or NULL if error or IDX file without FPT
+ * @set errno if error. "FPT not found" is not error!
+ **/
+BsDiIxFpt*
+  bsdiixfpt_load (FILE *pIdxFl)
+{
+  BsDiIxFpt *fpt = NULL;
+  BS_FOFST_T fptOfst;
+  BS_IDX_T size;
+  int mgc = 0;
+  long pos = ftell (pIdxFl);
+  if ( fseek (pIdxFl, - (long) ( BS_FOFST_LEN + sizeof (int) ), SEEK_END) != 0
+        || fread (&fptOfst, BS_FOFST_LEN, 1, pIdxFl) != 1
+          || fread (&mgc, sizeof (int), 1, pIdxFl) != 1 || mgc != BDI_FPT_MAGIC )
+  {
+    if ( errno != 0 ) { errno = 0; }
+    BSLOG_LOG (BSLWARN, "IDX file without FPT\n")
+    goto out;
+  }
+  BS_DO_E_OUTE (bsfseek_goto (pIdxFl, fptOfst + BS_FOFST_LEN + sizeof (long)))
+  BS_DO_E_OUTE (bsfread_bsindex (&size, pIdxFl))
+  BS_DO_E_OUTE (fpt = s_new (size))
+  fpt->fptOfst = fptOfst;
+  BS_DO_E_OUTE (bsfseek_goto (pIdxFl, fptOfst))
+  BS_DO_E_OUTE (bsfread_bsfoffset (&fpt->dicSz, pIdxFl))
+  BS_DO_E_OUTE (bsfread_long (&fpt->mtime, pIdxFl))
+  BS_DO_E_OUTE (bsfread_bsindex (&fpt->size, pIdxFl))
+  for ( BS_IDX_T l = BS_IDX_0; l < fpt->size; l++ )
+  {
+    BS_DO_E_OUTE (bsfread_bsfoffset (&fpt->vals[l].ofst, pIdxFl))
+    BS_DO_E_OUTE (bsfread_ulong (&fpt->vals[l].hash, pIdxFl))
+    BS_DO_E_OUTE (bsfread_bsindex (&fpt->vals[l].dupSz, pIdxFl))
+  }
+  goto out;
+
+oute:
+  fpt = bsdiixfpt_free (fpt);
+out:
+  fseek (pIdxFl, pos, SEEK_SET);
+  return fpt;
+}
+
+/**
+ * <p>Overwrite saved FPT's modification time, e.g. when dictionary
+ * has been touched without changing.</p>
+ * @param pFpt - loaded FPT with new modification time
+ * @param pIdxPth - IDX path
+ * @set errno if error.
+ **/
+void
+  bsdiixfpt_save_mtime (BsDiIxFpt *pFpt, char *pIdxPth)
+{
+  FILE *idxFl = fopen (pIdxPth, "r+b");
+  BS_IF_EN_RET (idxFl == NULL, BSE_OPEN_FILE)
+  BS_DO_E_OUT (bsfseek_goto (idxFl, pFpt->fptOfst + BS_FOFST_LEN))
+  BS_DO_E_OUT (bsfwrite_long (&pFpt->mtime, idxFl))
+out:
+  fclose (idxFl);
+}
@@ -0,0 +1,143 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ IDX fingerprints table (FPT) of DSL dictionary's regions.
+ * Dictionary is split into chunks by articles boundaries,
+ * chunk's end depends on its content only (content defined chunking),
+ * so insertion or deletion changes only few chunks around it.
+ * FPT is stored at the end of IDX file, so IDX can be updated by re-parsing
+ * only changed chunks.</p>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXFPT
+#define BS_DEBUGL_DIIXFPT 30550
+
+#include "BsDicIwrds.h"
+
+//chunk is never less than (except the last one), it's much less than
+//average chunk, otherwise chunks after change don't get back in step:
+#define BDI_FPT_CHUNK_MINSZ 2048L
+//chunk is never more than (except huge article):
+#define BDI_FPT_CHUNK_MAXSZ 262144L
+//article's headword line hash mask that ends chunk, i.e. 1 of 64 articles:
+#define BDI_FPT_CHUNK_MASK 0x3FUL
+//IDX file's last int that marks FPT presence:
+#define BDI_FPT_MAGIC 0x46505431
+
+/**
+ * <p>Chunk's fingerprint record.</p>
+ * @member BS_FOFST_T ofst - chunk's start in dictionary
+ * @member unsigned long hash - FNV-1a hash of chunk's content
+ * @member BS_IDX_T dupSz - chunk's headwords total minus its DWOLT records,
+ *   i.e. duplicates that are hidden by the same i.words
+ **/
+typedef struct {
+  BS_FOFST_T ofst;
+  unsigned long hash;
+  BS_IDX_T dupSz;
+} BsDiIxFptRd;
+
+/**
+ * <p>Fingerprints table.</p>
+ * @member BS_FOFST_T dicSz - dictionary size
+ * @member long mtime - dictionary modification time in nanoseconds
+ * @member BS_FOFST_T fptOfst - FPT offset in IDX file, or BS_FOFST_NULL
+ * @member BS_IDX_T size - chunks total
+ * @member BsDiIxFptRd *vals - chunks ordered by offset
+ **/
+typedef struct {
+  BS_FOFST_T dicSz;
+  long mtime;
+  BS_FOFST_T fptOfst;
+  BS_IDX_T size;
+  BsDiIxFptRd *vals;
+} BsDiIxFpt;
+
+/**
+ * <p>Destructor.</p>
+ * @param pFpt - FPT or NULL
+ * @return always NULL
+ **/
+BsDiIxFpt *bsdiixfpt_free (BsDiIxFpt *pFpt);
+
+/**
+ * <p>Read dictionary size and modification time.</p>
+ * @param pPth - dictionary path
+ * @param pDicSzRt - pointer to return size
+ * @param pMtimeRt - pointer to return modification time in nanoseconds
+ * @set errno if error.
+ **/
+void bsdiixfpt_stat (char *pPth, BS_FOFST_T *pDicSzRt, long *pMtimeRt);
+
+/**
+ * <p>Make FPT by splitting mapped dictionary into chunks.
+ * Duplicates totals are zero.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pPth - dictionary path
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFpt *bsdiixfpt_new_make (BsDicDslMm *pDslMm, int pDeBufSz, char *pPth);
+
+/**
+ * <p>Find chunk that contains given offset.</p>
+ * @param pFpt - FPT
+ * @param pOfst - offset in dictionary
+ * @return chunk's index
+ **/
+BS_IDX_T bsdiixfpt_find (BsDiIxFpt *pFpt, BS_FOFST_T pOfst);
+
+/**
+ * <p>Get chunk's size.</p>
+ * @param pFpt - FPT
+ * @param pIdx - chunk's index
+ * @return chunk's size
+ **/
+BS_FOFST_T bsdiixfpt_chunk_sz (BsDiIxFpt *pFpt, BS_IDX_T pIdx);
+
+/**
+ * <p>Add headwords into chunks duplicates totals.</p>
+ * @param pFpt - FPT
+ * @param pOfsts - headwords offsets
+ * @param pCnt - headwords total
+ **/
+void bsdiixfpt_add_hws (BsDiIxFpt *pFpt, BS_FOFST_T *pOfsts, BS_IDX_T pCnt);
+
+/**
+ * <p>Subtract DWOLT records, i.e. i.words with headwords,
+ * from chunks duplicates totals.</p>
+ * @param pFpt - FPT
+ * @param pIwrds - sorted i.words without duplicates
+ * @set errno if error.
+ **/
+void bsdiixfpt_sub_dwolt (BsDiIxFpt *pFpt, BsDicIwrds *pIwrds);
+
+/**
+ * <p>Write FPT at the current IDX file's position (its end).</p>
+ * @param pFpt - FPT
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixfpt_save (BsDiIxFpt *pFpt, FILE *pIdxFl);
+
+/**
+ * <p>Load FPT from the end of IDX file.</p>
+ * @param pIdxFl - IDX file
+ * @return object or NULL if error or IDX file without FPT
+ * @set errno if error. "FPT not found" is not error!
+ **/
+BsDiIxFpt *bsdiixfpt_load (FILE *pIdxFl);
+
+/**
+ * <p>Overwrite saved FPT's modification time, e.g. when dictionary
+ * has been touched without changing.</p>
+ * @param pFpt - loaded FPT with new modification time
+ * @param pIdxPth - IDX path
+ * @set errno if error.
+ **/
+void bsdiixfpt_save_mtime (BsDiIxFpt *pFpt, char *pIdxPth);
+#endif
@@ -0,0 +1,1006 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ IDX headwords finite-state transducer (FST).</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdlib.h"
+#include "string.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsFioWrap.h"
+#include "BsDiIxFst.h"
+
+//max arc's size, i.e. flags, label and two 64-bit varints:
+#define S_ARC_MXSZ 24
+
+//local lib:
+/**
+ * <p>Put varint into buffer.</p>
+ * @param pBuf - buffer
+ * @param pVal - number
+ * @return bytes put
+ **/
+static inline int
+  s_put_vint (unsigned char *pBuf, unsigned long pVal)
+{
+  int i = 0;
+  while ( pVal >= 0x80 )
+  {
+    pBuf[i++] = (unsigned char) ( pVal | 0x80 );
+    pVal >>= 7;
+  }
+  pBuf[i++] = (unsigned char) pVal;
+  return i;
+}
+
+/**
+ * <p>Get varint from FST.</p>
+ * @param pFst - FST
+ * @param pPos - varint's offset
+ * @param pValRt - pointer to return number
+ * @return next offset
+ **/
+static inline BS_FOFST_T
+  s_get_vint (const unsigned char *pFst, BS_FOFST_T pPos, unsigned long *pValRt)
+{
+  unsigned long val = 0;
+  int sft = 0;
+  while ( pFst[pPos] & 0x80 )
+  {
+    val |= (unsigned long) ( pFst[pPos++] & 0x7F ) << sft;
+    sft += 7;
+  }
+  *pValRt = val | (unsigned long) pFst[pPos++] << sft;
+  return pPos;
+}
+
+/**
+ * <p>Decode arc.</p>
+ * @param pFst - FST
+ * @param pPos - arc's offset
+ * @param pArc - arc to fill
+ * @return next arc's offset
+ **/
+static inline BS_FOFST_T
+  s_arc (const unsigned char *pFst, BS_FOFST_T pPos, BsDiIxFstArc *pArc)
+{
+  unsigned long val;
+  BS_FOFST_T pos = pPos;
+  int dlt = pFst[pos] >> BDI_FST_DLT_SFT;
+  pArc->flgs = pFst[pos++] & BDI_FST_FLGS;
+  pos = s_get_vint (pFst, pos, &val);
+  pArc->lbl = (BS_CHAR_T) val;
+  pArc->out = BS_IDX_0;
+  if ( pArc->flgs & BDI_FST_OUT )
+  {
+    pos = s_get_vint (pFst, pos, &val);
+    pArc->out = (BS_IDX_T) val;
+  }
+  pArc->trg = BS_FOFST_0;
+  if ( dlt != 0 )
+  {
+    pArc->trg = pPos - dlt;
+  } else if ( !( pArc->flgs & BDI_FST_STOP ) )
+  {
+    pos = s_get_vint (pFst, pos, &val);
+    pArc->trg = pPos - (BS_FOFST_T) val;
+  }
+  return pos;
+}
+
+/**
+ * <p>Find state's arc with given label. Arcs are in labels order,
+ * so it stops on the first greater one.</p>
+ * @param pFst - FST
+ * @param pSt - state's offset
+ * @param pLbl - label
+ * @param pArc - arc to fill
+ * @return offset after found arc, i.e. its next sibling's one
+ *   if it isn't the last, or 0 if not found
+ **/
+static BS_FOFST_T
+  s_find_arc (const unsigned char *pFst, BS_FOFST_T pSt, BS_CHAR_T pLbl,
+              BsDiIxFstArc *pArc)
+{
+  BS_FOFST_T pos = pSt;
+  while ( true )
+  {
+    pos = s_arc (pFst, pos, pArc);
+    if ( pArc->lbl == pLbl )
+                { return pos; }
+    if ( pArc->lbl > pLbl || pArc->flgs & BDI_FST_LAST )
+                { return BS_FOFST_0; }
+  }
+}
+
+/**
+ * <p>Make state's hash.</p>
+ * @param pSt - state
+ * @return hash
+ **/
+static unsigned long
+  s_st_hash (BsDiIxFstMkSt *pSt)
+{
+  unsigned long hsh = 14695981039346656037UL;
+  for ( int i = 0; i < pSt->arcsSz; i++ )
+  {
+    BsDiIxFstArc *arc = pSt->arcs + i;
+    hsh = ( hsh ^ arc->lbl ) * 1099511628211UL;
+    hsh = ( hsh ^ (unsigned long) arc->flgs ) * 1099511628211UL;
+    hsh = ( hsh ^ (unsigned long) arc->out ) * 1099511628211UL;
+    hsh = ( hsh ^ (unsigned long) arc->trg ) * 1099511628211UL;
+  }
+  return hsh;
+}
+
+/**
+ * <p>Check if written state is equal to not yet written one.</p>
+ * @param pFstMk - FST maker
+ * @param pOfst - written state's offset
+ * @param pSt - state
+ * @return if they are equal
+ **/
+static bool
+  s_st_eq (BsDiIxFstMk *pFstMk, BS_FOFST_T pOfst, BsDiIxFstMkSt *pSt)
+{
+  BsDiIxFstArc arc;
+  BS_FOFST_T pos = pOfst;
+  for ( int i = 0; i < pSt->arcsSz; i++ )
+  {
+    BsDiIxFstArc *sarc = pSt->arcs + i;
+    pos = s_arc (pFstMk->dt, pos, &arc);
+    if ( arc.lbl != sarc->lbl || arc.out != sarc->out
+          || ( arc.flgs & ( BDI_FST_FINAL | BDI_FST_STOP ) ) != sarc->flgs
+            || ( !( sarc->flgs & BDI_FST_STOP ) && arc.trg != sarc->trg )
+              || ( ( arc.flgs & BDI_FST_LAST ) != 0 ) != ( i == pSt->arcsSz - 1 ) )
+                { return false; }
+  }
+  return true;
+}
+
+/**
+ * <p>Put state's offset into register.</p>
+ * @param pFstMk - FST maker
+ * @param pOfst - state's offset
+ * @param pHsh - state's hash
+ **/
+static void
+  s_rgst_put (BsDiIxFstMk *pFstMk, BS_FOFST_T pOfst, unsigned long pHsh)
+{
+  BS_FOFST_T i = pHsh & ( pFstMk->rgstCap - 1 );
+  while ( pFstMk->rgst[i] != BS_FOFST_0 )
+        { i = ( i + 1 ) & ( pFstMk->rgstCap - 1 ); }
+  pFstMk->rgst[i] = pOfst;
+  pFstMk->rgstHshs[i] = pHsh;
+}
+
+/**
+ * <p>Double register.</p>
+ * @param pFstMk - FST maker
+ * @set errno if error.
+ **/
+static void
+  s_rgst_grow (BsDiIxFstMk *pFstMk)
+{
+  BS_FOFST_T l, cap = pFstMk->rgstCap;
+  BS_FOFST_T *rgst = pFstMk->rgst;
+  unsigned long *hshs = pFstMk->rgstHshs;
+  BS_FOFST_T *nrgst = calloc (cap * 2, sizeof (BS_FOFST_T));
+  unsigned long *nhshs = malloc (cap * 2 * sizeof (unsigned long));
+  if ( nrgst == NULL || nhshs == NULL )
+  {
+    free (nrgst); free (nhshs);
+    errno = ENOMEM;
+    BSLOG_ERR
+    return;
+  }
+  pFstMk->rgst = nrgst;
+  pFstMk->rgstHshs = nhshs;
+  pFstMk->rgstCap = cap * 2;
+  for ( l = BS_FOFST_0; l < cap; l++ )
+  {
+    if ( rgst[l] != BS_FOFST_0 )
+          { s_rgst_put (pFstMk, rgst[l], hshs[l]); }
+  }
+  free (rgst); free (hshs);
+}
+
+/**
+ * <p>Write state if there is no equal written one.</p>
+ * @param pFstMk - FST maker
+ * @param pSt - state
+ * @return state's offset or 0 if state has no arcs
+ * @set errno if error.
+ **/
+static BS_FOFST_T
+  s_st_write (BsDiIxFstMk *pFstMk, BsDiIxFstMkSt *pSt)
+{
+  if ( pSt->arcsSz == 0 )
+                { return BS_FOFST_0; }
+  unsigned long hsh = s_st_hash (pSt);
+  BS_FOFST_T i = hsh & ( pFstMk->rgstCap - 1 );
+  while ( pFstMk->rgst[i] != BS_FOFST_0 )
+  {
+    if ( pFstMk->rgstHshs[i] == hsh && s_st_eq (pFstMk, pFstMk->rgst[i], pSt) )
+                { return pFstMk->rgst[i]; }
+    i = ( i + 1 ) & ( pFstMk->rgstCap - 1 );
+  }
+  BS_FOFST_T ofst = pFstMk->sz;
+  BS_FOFST_T need = ofst + pSt->arcsSz * S_ARC_MXSZ;
+  if ( need > pFstMk->cap )
+  {
+    BS_FOFST_T cap = pFstMk->cap * 2 > need ? pFstMk->cap * 2 : need;
+    unsigned char *dt = realloc (pFstMk->dt, cap);
+    if ( dt == NULL )
+    {
+      errno = ENOMEM;
+      BSLOG_ERR
+      return BS_FOFST_0;
+    }
+    pFstMk->dt = dt;
+    pFstMk->cap = cap;
+  }
+  for ( int j = 0; j < pSt->arcsSz; j++ )
+  {
+    BsDiIxFstArc *arc = pSt->arcs + j;
+    BS_FOFST_T pos = pFstMk->sz;
+    unsigned char *buf = pFstMk->dt + pos;
+    int flgs = arc->flgs, k = 1;
+    if ( j == pSt->arcsSz - 1 )
+          { flgs |= BDI_FST_LAST; }
+    if ( arc->out != BS_IDX_0 )
+          { flgs |= BDI_FST_OUT; }
+    //target is usually just written before, so near one is in flags:
+    if ( !( flgs & BDI_FST_STOP ) && pos - arc->trg <= BDI_FST_DLT_MAX )
+          { flgs |= ( pos - arc->trg ) << BDI_FST_DLT_SFT; }
+    buf[0] = (unsigned char) flgs;
+    k += s_put_vint (buf + k, arc->lbl);
+    if ( flgs & BDI_FST_OUT )
+          { k += s_put_vint (buf + k, arc->out); }
+    if ( !( flgs & BDI_FST_STOP ) && ( flgs >> BDI_FST_DLT_SFT ) == 0 )
+          { k += s_put_vint (buf + k, pos - arc->trg); }
+    pFstMk->sz += k;
+  }
+  s_rgst_put (pFstMk, ofst, hsh);
+  pFstMk->rgstSz++;
+  if ( pFstMk->rgstSz * 2 > pFstMk->rgstCap )
+        { s_rgst_grow (pFstMk); }
+  return ofst;
+}
+
+/**
+ * <p>Write (or find equal written) path's state and point its parent's
+ * last arc to it.</p>
+ * @param pFstMk - FST maker
+ * @param pDpth - state's depth, i.e. index in path, > 0
+ * @set errno if error.
+ **/
+static void
+  s_freeze (BsDiIxFstMk *pFstMk, int pDpth)
+{
+  BsDiIxFstMkSt *st = pFstMk->sts + pDpth;
+  BsDiIxFstMkSt *prnt = pFstMk->sts + pDpth - 1;
+  BS_DO_E_RET (BS_FOFST_T ofst = s_st_write (pFstMk, st))
+  BsDiIxFstArc *arc = prnt->arcs + prnt->arcsSz - 1;
+  arc->trg = ofst;
+  arc->flgs = ( st->isFnl ? BDI_FST_FINAL : 0 ) | ( st->arcsSz == 0 ? BDI_FST_STOP : 0 );
+}
+
+/**
+ * <p>Ensure that path fits word.</p>
+ * @param pFstMk - FST maker
+ * @param pLen - word's length
+ * @set errno if error.
+ **/
+static void
+  s_path_fit (BsDiIxFstMk *pFstMk, int pLen)
+{
+  if ( pLen < pFstMk->stsCap )
+                { return; }
+  int cap = pFstMk->stsCap * 2 > pLen ? pFstMk->stsCap * 2 : pLen + 1;
+  BsDiIxFstMkSt *sts = realloc (pFstMk->sts, cap * sizeof (BsDiIxFstMkSt));
+  BS_IF_EN_RET (sts == NULL, ENOMEM)
+  pFstMk->sts = sts;
+  memset (sts + pFstMk->stsCap, 0, ( cap - pFstMk->stsCap ) * sizeof (BsDiIxFstMkSt));
+  pFstMk->stsCap = cap;
+  BS_CHAR_T *prv = realloc (pFstMk->prv, cap * BS_CHAR_LEN);
+  BS_IF_EN_RET (prv == NULL, ENOMEM)
+  pFstMk->prv = prv;
+}
+
+/**
+ * <p>Add arc to path's state.</p>
+ * @param pSt - state
+ * @param pLbl - label
+ * @param pOut - output
+ * @set errno if error.
+ **/
+static void
+  s_st_add_arc (BsDiIxFstMkSt *pSt, BS_CHAR_T pLbl, BS_IDX_T pOut)
+{
+  if ( pSt->arcsSz == pSt->arcsCap )
+  {
+    int cap = pSt->arcsCap > 0 ? pSt->arcsCap * 2 : 4;
+    BsDiIxFstArc *arcs = realloc (pSt->arcs, cap * sizeof (BsDiIxFstArc));
+    BS_IF_EN_RET (arcs == NULL, ENOMEM)
+    pSt->arcs = arcs;
+    pSt->arcsCap = cap;
+  }
+  BsDiIxFstArc *arc = pSt->arcs + pSt->arcsSz++;
+  arc->lbl = pLbl;
+  arc->out = pOut;
+  arc->flgs = 0;
+  arc->trg = BS_FOFST_0;
+}
+
+/**
+ * <p>Read and check FST head.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - FST offset
+ * @param pCnt - DWOLT size
+ * @param pSzRt - pointer to return FST size
+ * @return if FST is found
+ * @set errno if error.
+ **/
+static bool
+  s_head (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt, BS_FOFST_T *pSzRt)
+{
+  struct stat st;
+  int mgc, mxLen;
+  BS_IDX_T cnt;
+  BS_FOFST_T root;
+  int fd = fileno (pIdxFl);
+  if ( fd == -1 || fstat (fd, &st) != 0 )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return false;
+  }
+  if ( pOfst + BDI_FST_HEADSZ > st.st_size )
+                { return false; }
+  BS_DO_E_RETF (bsfseek_goto (pIdxFl, pOfst))
+  if ( fread (&mgc, sizeof (int), 1, pIdxFl) != 1
+        || fread (&mxLen, sizeof (int), 1, pIdxFl) != 1
+          || fread (&cnt, BS_IDX_LEN, 1, pIdxFl) != 1
+            || fread (pSzRt, BS_FOFST_LEN, 1, pIdxFl) != 1
+              || fread (&root, BS_FOFST_LEN, 1, pIdxFl) != 1 )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return false;
+  }
+  return mgc == BDI_FST_MAGIC && cnt == pCnt && mxLen >= 0
+    && *pSzRt >= BDI_FST_HEADSZ && pOfst + *pSzRt <= st.st_size
+      && root >= BS_FOFST_0 && root < *pSzRt
+        && ( root == BS_FOFST_0 ) == ( cnt == BS_IDX_0 );
+}
+
+//public lib:
+/**
+ * <p>Constructor.</p>
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFstMk*
+  bsdiixfstmk_new (void)
+{
+  BsDiIxFstMk *obj = calloc (1, sizeof (BsDiIxFstMk));
+  BS_IF_EN_RETN (obj == NULL, ENOMEM)
+  obj->cap = 4096;
+  obj->sz = BDI_FST_HEADSZ;
+  obj->dt = malloc (obj->cap);
+  obj->rgstCap = 1024;
+  obj->rgst = calloc (obj->rgstCap, sizeof (BS_FOFST_T));
+  obj->rgstHshs = malloc (obj->rgstCap * sizeof (unsigned long));
+  obj->stsCap = 32;
+  obj->sts = calloc (obj->stsCap, sizeof (BsDiIxFstMkSt));
+  obj->prv = malloc (obj->stsCap * BS_CHAR_LEN);
+  if ( obj->dt == NULL || obj->rgst == NULL || obj->rgstHshs == NULL
+        || obj->sts == NULL || obj->prv == NULL )
+  {
+    bsdiixfstmk_free (obj);
+    errno = ENOMEM;
+    BSLOG_ERR
+    return NULL;
+  }
+  return obj;
+}
+
+/**
+ * <p>Add next word, words must be added in ascending order
+ * without duplicates.</p>
+ * @param pFstMk - FST maker
+ * @param pIwrd - not empty i.word
+ * @set errno if error, BSE_WRONG_PARAMS if word isn't greater than previous.
+ **/
+void
+  bsdiixfstmk_add (BsDiIxFstMk *pFstMk, const BS_CHAR_T *pIwrd)
+{
+  int d, cp, len;
+  for ( len = 0; pIwrd[len] != 0; len++ ) ;
+  for ( cp = 0; cp < len && cp < pFstMk->prvLen && pIwrd[cp] == pFstMk->prv[cp]; cp++ ) ;
+  if ( len == 0 || ( pFstMk->cnt > BS_IDX_0 && ( cp == len
+        || ( cp < pFstMk->prvLen && pIwrd[cp] < pFstMk->prv[cp] ) ) ) )
+  {
+    errno = BSE_WRONG_PARAMS;
+    BSLOG_LOG (BSLERROR, "Word isn't greater than previous, len=%d, cnt="BS_IDX_FMT"\n", len, pFstMk->cnt)
+    return;
+  }
+  BS_DO_E_RET (s_path_fit (pFstMk, len))
+  //the previous word's states after common prefix will never change:
+  for ( d = pFstMk->prvLen; d > cp; d-- )
+        { BS_DO_E_RET (s_freeze (pFstMk, d)) }
+  for ( d = 0; d < cp; d++ )
+        { pFstMk->sts[d].cnt++; }
+  for ( d = cp; d < len; d++ )
+  {
+    BS_DO_E_RET (s_st_add_arc (pFstMk->sts + d, pIwrd[d], pFstMk->sts[d].cnt))
+    pFstMk->sts[d].cnt++;
+    pFstMk->sts[d + 1].cnt = BS_IDX_0;
+    pFstMk->sts[d + 1].isFnl = false;
+    pFstMk->sts[d + 1].arcsSz = 0;
+  }
+  pFstMk->sts[len].isFnl = true;
+  pFstMk->sts[len].cnt++;
+  memcpy (pFstMk->prv, pIwrd, len * BS_CHAR_LEN);
+  pFstMk->prvLen = len;
+  if ( len > pFstMk->mxLen )
+        { pFstMk->mxLen = len; }
+  pFstMk->cnt++;
+}
+
+/**
+ * <p>Finish FST and hand over it to client.</p>
+ * @param pFstMk - FST maker with all words
+ * @return FST section (to free by client) or NULL when error
+ * @set errno if error.
+ **/
+char*
+  bsdiixfstmk_end (BsDiIxFstMk *pFstMk)
+{
+  int mgc = BDI_FST_MAGIC;
+  BS_FOFST_T root = BS_FOFST_0;
+  for ( int d = pFstMk->prvLen; d > 0; d-- )
+        { BS_DO_E_RETN (s_freeze (pFstMk, d)) }
+  if ( pFstMk->cnt > BS_IDX_0 )
+        { BS_DO_E_RETN (root = s_st_write (pFstMk, pFstMk->sts)) }
+  memcpy (pFstMk->dt, &mgc, sizeof (int));
+  memcpy (pFstMk->dt + BDI_FST_MXLEN_OFST, &pFstMk->mxLen, sizeof (int));
+  memcpy (pFstMk->dt + BDI_FST_CNT_OFST, &pFstMk->cnt, BS_IDX_LEN);
+  memcpy (pFstMk->dt + BDI_FST_SZ_OFST, &pFstMk->sz, BS_FOFST_LEN);
+  memcpy (pFstMk->dt + BDI_FST_ROOT_OFST, &root, BS_FOFST_LEN);
+  char *fst = realloc (pFstMk->dt, pFstMk->sz);
+  if ( fst == NULL ) //it's still the bigger one
+        { fst = (char*) pFstMk->dt; }
+  pFstMk->dt = NULL;
+  BSLOG_LOG (BSLINFO, "FST has been made, words="BS_IDX_FMT", states="BS_FOFST_FMT", size="BS_FOFST_FMT"\n", pFstMk->cnt, pFstMk->rgstSz, pFstMk->sz)
+  return fst;
+}
+
+/**
+ * <p>Destructor.</p>
+ * @param pFstMk - FST maker or NULL
+ * @return always NULL
+ **/
+BsDiIxFstMk*
+  bsdiixfstmk_free (BsDiIxFstMk *pFstMk)
+{
+  if ( pFstMk != NULL )
+  {
+    free (pFstMk->dt);
+    free (pFstMk->rgst);
+    free (pFstMk->rgstHshs);
+    if ( pFstMk->sts != NULL )
+    {
+      for ( int i = 0; i < pFstMk->stsCap; i++ )
+            { free (pFstMk->sts[i].arcs); }
+      free (pFstMk->sts);
+    }
+    free (pFstMk->prv);
+    free (pFstMk);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Make FST from ordered i.words of DWOLT, i.e. with not zero
+ * length_dword.</p>
+ * @param pIwrds - ordered i.words
+ * @return FST section or NULL when error
+ * @set errno if error.
+ **/
+char*
+  bsdiixfst_new (BsDicIwrds *pIwrds)
+{
+  char *fst = NULL;
+  BS_DO_E_RETN (BsDiIxFstMk *fstMk = bsdiixfstmk_new ())
+  for ( BS_IDX_T l = BS_IDX_0; l < pIwrds->size; l++ )
+  {
+    if ( pIwrds->vals[l]->length_dword != 0 )
+          { BS_DO_E_OUT (bsdiixfstmk_add (fstMk, pIwrds->vals[l]->iword)) }
+  }
+  fst = bsdiixfstmk_end (fstMk);
+out:
+  bsdiixfstmk_free (fstMk);
+  return fst;
+}
+
+/**
+ * <p>Find word's DWOLT index.</p>
+ * @param pFst - FST
+ * @param pIwrd - i.word
+ * @return DWOLT index or BS_IDX_NULL if there is no such word
+ **/
+BS_IDX_T
+  bsdiixfst_find (const char *pFst, const BS_CHAR_T *pIwrd)
+{
+  const unsigned char *fst = (const unsigned char*) pFst;
+  BsDiIxFstArc arc;
+  BS_FOFST_T st = BDI_FST_ROOT (pFst);
+  BS_IDX_T idx = BS_IDX_0;
+  if ( st == BS_FOFST_0 || pIwrd[0] == 0 )
+                { return BS_IDX_NULL; }
+  for ( int i = 0; ; i++ )
+  {
+    if ( s_find_arc (fst, st, pIwrd[i], &arc) == BS_FOFST_0 )
+                { return BS_IDX_NULL; }
+    idx += arc.out;
+    if ( pIwrd[i + 1] == 0 )
+                { return arc.flgs & BDI_FST_FINAL ? idx : BS_IDX_NULL; }
+    if ( arc.flgs & BDI_FST_STOP )
+                { return BS_IDX_NULL; }
+    st = arc.trg;
+  }
+}
+
+/**
+ * <p>Find DWOLT range of words that start with given prefix.</p>
+ * @param pFst - FST
+ * @param pPrfx - i.word's prefix, empty one means all words
+ * @param pEndRt - pointer to return range's end (exclusive)
+ * @return range's start or BS_IDX_NULL if there is no such word
+ **/
+BS_IDX_T
+  bsdiixfst_prefix (const char *pFst, const BS_CHAR_T *pPrfx,
+                    BS_IDX_T *pEndRt)
+{
+  const unsigned char *fst = (const unsigned char*) pFst;
+  BsDiIxFstArc arc, sbl;
+  BS_FOFST_T nxt, st = BDI_FST_ROOT (pFst);
+  BS_IDX_T stt = BS_IDX_0, end = BDI_FST_CNT (pFst);
+  for ( int i = 0; pPrfx[i] != 0; i++ )
+  {
+    if ( st == BS_FOFST_0 )
+                { return BS_IDX_NULL; }
+    nxt = s_find_arc (fst, st, pPrfx[i], &arc);
+    if ( nxt == BS_FOFST_0 )
+                { return BS_IDX_NULL; }
+    //the next sibling's words are the first ones after prefix's words:
+    if ( !( arc.flgs & BDI_FST_LAST ) )
+    {
+      s_arc (fst, nxt, &sbl);
+      end = stt + sbl.out;
+    }
+    stt += arc.out;
+    st = arc.flgs & BDI_FST_STOP ? BS_FOFST_0 : arc.trg;
+  }
+  if ( stt >= end )
+                { return BS_IDX_NULL; }
+  *pEndRt = end;
+  return stt;
+}
+
+/**
+ * <p>Constructor.</p>
+ * @param pFst - FST
+ * @param pPrfx - i.word's prefix, empty one means all words
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFstIt*
+  bsdiixfstit_new (const char *pFst, const BS_CHAR_T *pPrfx)
+{
+  BsDiIxFstArc arc;
+  BS_FOFST_T st;
+  BS_IDX_T out;
+  int len, mx = BDI_FST_MXLEN (pFst);
+  for ( len = 0; pPrfx[len] != 0; len++ ) ;
+  BsDiIxFstIt *obj = calloc (1, sizeof (BsDiIxFstIt));
+  BS_IF_EN_RETN (obj == NULL, ENOMEM)
+  obj->fst = (const unsigned char*) pFst;
+  obj->prfxLen = len;
+  obj->lvl = -1;
+  obj->prfxIdx = BS_IDX_NULL;
+  if ( len > mx )
+                { return obj; }
+  obj->wrd = malloc ((mx + 1) * BS_CHAR_LEN);
+  obj->poss = malloc ((mx - len + 1) * sizeof (BS_FOFST_T));
+  obj->outs = malloc ((mx - len + 1) * sizeof (BS_IDX_T));
+  if ( obj->wrd == NULL || obj->poss == NULL || obj->outs == NULL )
+  {
+    bsdiixfstit_free (obj);
+    errno = ENOMEM;
+    BSLOG_ERR
+    return NULL;
+  }
+  st = BDI_FST_ROOT (pFst);
+  out = BS_IDX_0;
+  arc.flgs = 0;
+  for ( int i = 0; i < len; i++ )
+  {
+    if ( st == BS_FOFST_0 || s_find_arc (obj->fst, st, pPrfx[i], &arc) == BS_FOFST_0 )
+                { return obj; }
+    obj->wrd[i] = pPrfx[i];
+    out += arc.out;
+    st = arc.flgs & BDI_FST_STOP ? BS_FOFST_0 : arc.trg;
+  }
+  if ( arc.flgs & BDI_FST_FINAL )
+        { obj->prfxIdx = out; }
+  if ( st != BS_FOFST_0 )
+  {
+    obj->lvl = 0;
+    obj->poss[0] = st;
+    obj->outs[0] = out;
+  }
+  return obj;
+}
+
+/**
+ * <p>Get next word.</p>
+ * @param pFstIt - iterator
+ * @param pIdxRt - pointer to return word's DWOLT index
+ * @return word that is valid until next call or NULL if there is no more
+ **/
+const BS_CHAR_T*
+  bsdiixfstit_next (BsDiIxFstIt *pFstIt, BS_IDX_T *pIdxRt)
+{
+  BsDiIxFstArc arc;
+  BS_FOFST_T nxt;
+  int len, mxLvl;
+  if ( pFstIt->prfxIdx != BS_IDX_NULL )
+  {
+    *pIdxRt = pFstIt->prfxIdx;
+    pFstIt->prfxIdx = BS_IDX_NULL;
+    pFstIt->wrd[pFstIt->prfxLen] = 0;
+    return pFstIt->wrd;
+  }
+  mxLvl = BDI_FST_MXLEN (pFstIt->fst) - pFstIt->prfxLen;
+  //depth-first walk, word is returned before its continuations:
+  while ( pFstIt->lvl >= 0 )
+  {
+    if ( pFstIt->poss[pFstIt->lvl] == BS_FOFST_0 )
+    {
+      pFstIt->lvl--;
+      continue;
+    }
+    nxt = s_arc (pFstIt->fst, pFstIt->poss[pFstIt->lvl], &arc);
+    pFstIt->poss[pFstIt->lvl] = arc.flgs & BDI_FST_LAST ? BS_FOFST_0 : nxt;
+    len = pFstIt->prfxLen + pFstIt->lvl;
+    pFstIt->wrd[len] = arc.lbl;
+    *pIdxRt = pFstIt->outs[pFstIt->lvl] + arc.out;
+    if ( !( arc.flgs & BDI_FST_STOP ) && pFstIt->lvl < mxLvl )
+    {
+      pFstIt->lvl++;
+      pFstIt->poss[pFstIt->lvl] = arc.trg;
+      pFstIt->outs[pFstIt->lvl] = *pIdxRt;
+    }
+    if ( arc.flgs & BDI_FST_FINAL )
+    {
+      pFstIt->wrd[len + 1] = 0;
+      return pFstIt->wrd;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * <p>Destructor.</p>
+ * @param pFstIt - iterator or NULL
+ * @return always NULL
+ **/
+BsDiIxFstIt*
+  bsdiixfstit_free (BsDiIxFstIt *pFstIt)
+{
+  if ( pFstIt != NULL )
+  {
+    free (pFstIt->wrd);
+    free (pFstIt->poss);
+    free (pFstIt->outs);
+    free (pFstIt);
+  }
+  return NULL;
+}
+
+//fuzzy finding:
+/**
+ * <p>Fuzzy finding's context.</p>
+ * @member const unsigned char *fst - FST
+ * @member const BS_CHAR_T *wrd - i.word
+ * @member int len - its length
+ * @member int dst - current max distance, -1 means finding is over
+ * @member int *rows - distances rows per level, row is len + 1
+ * @member BS_CHAR_T *lbls - path's labels
+ * @member BS_IDX_T wrdsMx - max words
+ * @member BS_IDX_T cnts - words found per distance
+ * @member long arcs - arcs budget left
+ * @member BsDiIxFstFz *fzs - found ranges
+ * @member int fzsSz - their total
+ * @member int fzsCap - their capacity
+ **/
+typedef struct {
+  const unsigned char *fst;
+  const BS_CHAR_T *wrd;
+  int len;
+  int dst;
+  int *rows;
+  BS_CHAR_T *lbls;
+  BS_IDX_T wrdsMx;
+  BS_IDX_T cnts[BDI_FST_FZ_DSTMX + 1];
+  long arcs;
+  BsDiIxFstFz *fzs;
+  int fzsSz;
+  int fzsCap;
+} BsDiIxFstFzCx;
+
+/**
+ * <p>Add found range. Ranges of each distance are added in DWOLT order,
+ * so max distance is lowered when words within it are enough.</p>
+ * @param pCx - context
+ * @param pStt - range's start
+ * @param pEnd - range's end
+ * @param pDst - distance
+ * @set errno if error.
+ **/
+static void
+  s_fz_add (BsDiIxFstFzCx *pCx, BS_IDX_T pStt, BS_IDX_T pEnd, int pDst)
+{
+  if ( pCx->fzsSz == pCx->fzsCap )
+  {
+    int cap = pCx->fzsCap * 2;
+    BsDiIxFstFz *fzs = realloc (pCx->fzs, cap * sizeof (BsDiIxFstFz));
+    BS_IF_EN_RET (fzs == NULL, ENOMEM)
+    pCx->fzs = fzs;
+    pCx->fzsCap = cap;
+  }
+  pCx->fzs[pCx->fzsSz].stt = pStt;
+  pCx->fzs[pCx->fzsSz].end = pEnd;
+  pCx->fzs[pCx->fzsSz++].dst = pDst;
+  pCx->cnts[pDst] += pEnd - pStt;
+  while ( pCx->dst >= 0 )
+  {
+    BS_IDX_T cnt = BS_IDX_0;
+    for ( int d = 0; d <= pCx->dst; d++ )
+                { cnt += pCx->cnts[d]; }
+    if ( cnt < pCx->wrdsMx )
+                { break; }
+    pCx->dst--;
+  }
+}
+
+/**
+ * <p>Visit state's arcs, i.e. next level.</p>
+ * @param pCx - context
+ * @param pSt - state's offset
+ * @param pStt - state's words start, i.e. outputs sum
+ * @param pEnd - state's words end
+ * @param pLvl - state's level, its distances row is filled
+ * @param pBst - the least distance of word's prefix on state's path
+ * @set errno if error.
+ **/
+static void
+  s_fz (BsDiIxFstFzCx *pCx, BS_FOFST_T pSt, BS_IDX_T pStt, BS_IDX_T pEnd,
+        int pLvl, int pBst)
+{
+  BsDiIxFstArc arc, sbl;
+  BS_IDX_T stt, end;
+  BS_FOFST_T nxt, pos = pSt;
+  int mn, bst, j, ln = pCx->len + 1;
+  int *row = pCx->rows + pLvl * ln, *nrow = row + ln;
+  while ( pCx->dst >= 0 && pCx->arcs-- > 0 )
+  {
+    nxt = s_arc (pCx->fst, pos, &arc);
+    stt = pStt + arc.out;
+    end = pEnd;
+    if ( !( arc.flgs & BDI_FST_LAST ) )
+    {
+      s_arc (pCx->fst, nxt, &sbl);
+      end = pStt + sbl.out;
+    }
+    pCx->lbls[pLvl] = arc.lbl;
+    nrow[0] = mn = pLvl + 1;
+    for ( j = 1; j < ln; j++ )
+    {
+      nrow[j] = row[j - 1] + ( pCx->wrd[j - 1] == arc.lbl ? 0 : 1 );
+      if ( nrow[j] > row[j] + 1 )
+                { nrow[j] = row[j] + 1; }
+      if ( nrow[j] > nrow[j - 1] + 1 )
+                { nrow[j] = nrow[j - 1] + 1; }
+      if ( j > 1 && pLvl > 0 && pCx->wrd[j - 1] == pCx->lbls[pLvl - 1]
+            && pCx->wrd[j - 2] == arc.lbl && nrow[j] > row[j - 2 - ln] + 1 )
+                { nrow[j] = row[j - 2 - ln] + 1; }
+      if ( nrow[j] < mn )
+                { mn = nrow[j]; }
+    }
+    bst = nrow[ln - 1] < pBst ? nrow[ln - 1] : pBst;
+    //distances never decrease deeper than row's minimum:
+    if ( bst <= mn || mn > pCx->dst || arc.flgs & BDI_FST_STOP )
+    {
+      if ( bst <= pCx->dst )
+                { BS_DO_E_RET (s_fz_add (pCx, stt, end, bst)) }
+    } else {
+      if ( arc.flgs & BDI_FST_FINAL && bst <= pCx->dst )
+                { BS_DO_E_RET (s_fz_add (pCx, stt, stt + BS_IDX_1, bst)) }
+      BS_DO_E_RET (s_fz (pCx, arc.trg, stt, end, pLvl + 1, bst))
+    }
+    if ( arc.flgs & BDI_FST_LAST )
+                { break; }
+    pos = nxt;
+  }
+}
+
+/**
+ * <p>Compare ranges by distance then by start.</p>
+ * @param pFz1 - range 1
+ * @param pFz2 - range 2
+ * @return -1, 0 or 1
+ **/
+static int
+  s_fz_cmp (const void *pFz1, const void *pFz2)
+{
+  const BsDiIxFstFz *fz1 = pFz1, *fz2 = pFz2;
+  if ( fz1->dst != fz2->dst )
+                { return fz1->dst < fz2->dst ? -1 : 1; }
+  if ( fz1->stt != fz2->stt )
+                { return fz1->stt < fz2->stt ? -1 : 1; }
+  return 0;
+}
+
+/**
+ * <p>Find words that start with prefix that differs from given word by up to
+ * given edits (insertion, deletion, substitution or adjacent chars
+ * transposition), i.e. typo tolerant completion. It's Levenshtein automaton
+ * simulated by distances row per FST level, so subtree is skipped as soon
+ * as any its word is too far and it's taken whole as DWOLT range as soon as
+ * its words can't be closer. Max distance is lowered while finding as soon as
+ * closer words are enough. Ranges are ordered by distance then by DWOLT
+ * index and they're cut to given words total.</p>
+ * @param pFst - FST
+ * @param pIwrd - not empty i.word
+ * @param pDst - max distance 0..BDI_FST_FZ_DSTMX
+ * @param pWrdsMx - max words to find
+ * @param pArcsMx - visited arcs budget, when it's run out the rest FST
+ *   isn't visited
+ * @param pSzRt - pointer to return ranges total
+ * @return ranges to free by client or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFstFz*
+  bsdiixfst_fuzzy (const char *pFst, const BS_CHAR_T *pIwrd,
+    int pDst, BS_IDX_T pWrdsMx, long pArcsMx, int *pSzRt)
+{
+  BsDiIxFstFzCx cx;
+  int i, mx = BDI_FST_MXLEN (pFst);
+  memset (&cx, 0, sizeof (BsDiIxFstFzCx));
+  for ( cx.len = 0; pIwrd[cx.len] != 0; cx.len++ ) ;
+  BS_IF_EN_RETN (cx.len == 0 || pDst < 0 || pDst > BDI_FST_FZ_DSTMX
+                  || pWrdsMx < BS_IDX_1, BSE_WRONG_PARAMS)
+  cx.fst = (const unsigned char*) pFst;
+  cx.wrd = pIwrd;
+  cx.dst = pDst;
+  cx.wrdsMx = pWrdsMx;
+  cx.arcs = pArcsMx;
+  cx.fzsCap = 16;
+  cx.fzs = malloc (cx.fzsCap * sizeof (BsDiIxFstFz));
+  cx.rows = malloc ((mx + 1) * ( cx.len + 1 ) * sizeof (int));
+  cx.lbls = malloc ((mx + 1) * BS_CHAR_LEN);
+  if ( cx.fzs == NULL || cx.rows == NULL || cx.lbls == NULL )
+  {
+    errno = ENOMEM;
+    BSLOG_ERR
+    goto out;
+  }
+  for ( i = 0; i <= cx.len; i++ )
+                { cx.rows[i] = i; }
+  if ( BDI_FST_ROOT (pFst) != BS_FOFST_0 )
+  {
+    s_fz (&cx, BDI_FST_ROOT (pFst), BS_IDX_0, BDI_FST_CNT (pFst), 0, cx.len);
+    if ( errno != 0 )
+    {
+      BSLOG_ERR
+      goto out;
+    }
+  }
+  qsort (cx.fzs, cx.fzsSz, sizeof (BsDiIxFstFz), s_fz_cmp);
+  //cut to words total, the last range may be partially used:
+  BS_IDX_T cnt = BS_IDX_0;
+  for ( i = 0; i < cx.fzsSz && cnt < pWrdsMx; i++ )
+                { cnt += cx.fzs[i].end - cx.fzs[i].stt; }
+  *pSzRt = i;
+out:
+  free (cx.rows);
+  free (cx.lbls);
+  if ( errno != 0 )
+  {
+    free (cx.fzs);
+    return NULL;
+  }
+  return cx.fzs;
+}
+
+/**
+ * <p>Write FST at IDX file current position.</p>
+ * @param pFst - FST
+ * @param pIdxFl - IDX file positioned at HWP end
+ * @set errno if error.
+ **/
+void
+  bsdiixfst_write (const char *pFst, FILE *pIdxFl)
+{
+  size_t sz = BDI_FST_SZ (pFst);
+  BS_IF_EN_RET (fwrite (pFst, 1, sz, pIdxFl) != sz, BSE_WRITE_FILE)
+}
+
+/**
+ * <p>Reveal FST size in IDX file. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - FST offset, i.e. HWP end
+ * @param pCnt - DWOLT size
+ * @return FST size or 0 if IDX file without FST
+ * @set errno if error. "FST not found" is not error!
+ **/
+BS_FOFST_T
+  bsdiixfst_size (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt)
+{
+  BS_FOFST_T sz, rz = BS_FOFST_0;
+  long pos = ftell (pIdxFl);
+  BS_DO_E_OUT (bool isFst = s_head (pIdxFl, pOfst, pCnt, &sz))
+  if ( isFst )
+        { rz = sz; }
+out:
+  fseek (pIdxFl, pos, SEEK_SET);
+  return rz;
+}
+
+/**
+ * <p>Load FST from IDX file into memory. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - FST offset, i.e. HWP end
+ * @param pCnt - DWOLT size
+ * @return FST or NULL if error or IDX file without FST
+ * @set errno if error. "FST not found" is not error!
+ **/
+char*
+  bsdiixfst_load (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt)
+{
+  char *fst = NULL;
+  long pos = ftell (pIdxFl);
+  BS_DO_E_RETN (BS_FOFST_T sz = bsdiixfst_size (pIdxFl, pOfst, pCnt))
+  if ( sz == BS_FOFST_0 )
+  {
+    BSLOG_LOG (BSLINFO, "IDX file without FST\n")
+    return NULL;
+  }
+  fst = malloc (sz);
+  BS_IF_EN_OUT (fst == NULL, ENOMEM)
+  BS_DO_E_OUT (bsfseek_goto (pIdxFl, pOfst))
+  if ( fread (fst, 1, sz, pIdxFl) != (size_t) sz )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+  }
+out:
+  if ( errno != 0 && fst != NULL )
+  {
+    free (fst);
+    fst = NULL;
+  }
+  fseek (pIdxFl, pos, SEEK_SET);
+  return fst;
+}
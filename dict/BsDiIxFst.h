@@ -0,0 +1,305 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ IDX headwords finite-state transducer (FST) - optional IDX
+ * section just after HWP (or DWOLT if IDX is without HWP). It's minimal
+ * acyclic automaton over DWOLT i.words that maps each one to its DWOLT index,
+ * i.e. to its ordinal, because DWOLT is ordered by i.words without duplicates.
+ * Arc's output is the number of words that are less than any word through it
+ * in its state, so word's DWOLT index is the sum of outputs along its path.
+ * It's made from ordered i.words (Daciuk's incremental minimization), so
+ * equal suffixes share states. It's byte coded and position independent,
+ * so it's used as is in memory or in mapped IDX v2. Prefix's words are
+ * a range of DWOLT, so they are streamed in order without any IDX reading.
+ * IDX without FST (e.g. old one) is still valid.</p>
+ * <pre>
+ * section (native byte order, offsets are relative to section start):
+ *   int magic, int max word length, BS_IDX_T cnt (=DWOLT size),
+ *   BS_FOFST_T sz - section size, BS_FOFST_T root - root state offset
+ *     or 0 if FST is empty,
+ *   states, a state is its arcs in chars order, an arc is:
+ *     byte flags BDI_FST_* (low 4 bits) and arc's offset minus target
+ *     state's one if it's 1..15 (high 4 bits, otherwise 0), varint label,
+ *     varint output if BDI_FST_OUT, varint arc's offset minus target
+ *     state's one if it isn't in flags and not BDI_FST_STOP
+ * </pre>
+ * varint is unsigned LEB128, i.e. 7 bits per byte, the high bit means
+ * that the next byte follows.
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXFST
+#define BS_DEBUGL_DIIXFST 30670
+
+#include "stdio.h"
+#include "stdbool.h"
+
+#include "BsDicIwrds.h"
+
+//FST section's first int:
+#define BDI_FST_MAGIC 0x31545346
+#define BDI_FST_HEADSZ 32
+#define BDI_FST_MXLEN_OFST 4
+#define BDI_FST_CNT_OFST 8
+#define BDI_FST_SZ_OFST 16
+#define BDI_FST_ROOT_OFST 24
+
+//arc's flags:
+//the last arc of state:
+#define BDI_FST_LAST 1
+//word ends at arc's target:
+#define BDI_FST_FINAL 2
+//target is state without arcs:
+#define BDI_FST_STOP 4
+//arc has not zero output:
+#define BDI_FST_OUT 8
+//flags mask, the rest high bits are near target's delta:
+#define BDI_FST_FLGS 15
+#define BDI_FST_DLT_SFT 4
+#define BDI_FST_DLT_MAX 15
+
+/**
+ * <p>FST's arc, i.e. not yet written one of maker or decoded one.</p>
+ * @member BS_CHAR_T lbl - label
+ * @member int flgs - flags BDI_FST_*, maker's arc has only
+ *   BDI_FST_FINAL and BDI_FST_STOP
+ * @member BS_IDX_T out - output
+ * @member BS_FOFST_T trg - target state's offset, maker's arc has it
+ *   when target is written
+ **/
+typedef struct {
+  BS_CHAR_T lbl;
+  int flgs;
+  BS_IDX_T out;
+  BS_FOFST_T trg;
+} BsDiIxFstArc;
+
+/**
+ * <p>Not yet written state of FST maker, i.e. state on path
+ * of the last added word.</p>
+ * @member BS_IDX_T cnt - words through state added so far
+ * @member bool isFnl - if it's end of word
+ * @member int arcsSz - arcs total
+ * @member int arcsCap - arcs capacity
+ * @member BsDiIxFstArc *arcs - arcs
+ **/
+typedef struct {
+  BS_IDX_T cnt;
+  bool isFnl;
+  int arcsSz;
+  int arcsCap;
+  BsDiIxFstArc *arcs;
+} BsDiIxFstMkSt;
+
+/**
+ * <p>FST maker from ordered words.</p>
+ * @member unsigned char *dt - section being made
+ * @member BS_FOFST_T sz - section size so far
+ * @member BS_FOFST_T cap - section capacity
+ * @member BS_FOFST_T *rgst - written states offsets hash table, 0 means empty
+ * @member unsigned long *rgstHshs - their hashes
+ * @member BS_FOFST_T rgstCap - hash table capacity, power of 2
+ * @member BS_FOFST_T rgstSz - written states total
+ * @member BsDiIxFstMkSt *sts - path of the last added word, root is the first
+ * @member int stsCap - path capacity
+ * @member BS_CHAR_T *prv - the last added word
+ * @member int prvLen - its length
+ * @member BS_IDX_T cnt - words added
+ * @member int mxLen - the longest word's length
+ **/
+typedef struct {
+  unsigned char *dt;
+  BS_FOFST_T sz;
+  BS_FOFST_T cap;
+  BS_FOFST_T *rgst;
+  unsigned long *rgstHshs;
+  BS_FOFST_T rgstCap;
+  BS_FOFST_T rgstSz;
+  BsDiIxFstMkSt *sts;
+  int stsCap;
+  BS_CHAR_T *prv;
+  int prvLen;
+  BS_IDX_T cnt;
+  int mxLen;
+} BsDiIxFstMk;
+
+/**
+ * <p>Constructor.</p>
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFstMk *bsdiixfstmk_new (void);
+
+/**
+ * <p>Add next word, words must be added in ascending order
+ * without duplicates.</p>
+ * @param pFstMk - FST maker
+ * @param pIwrd - not empty i.word
+ * @set errno if error, BSE_WRONG_PARAMS if word isn't greater than previous.
+ **/
+void bsdiixfstmk_add (BsDiIxFstMk *pFstMk, const BS_CHAR_T *pIwrd);
+
+/**
+ * <p>Finish FST and hand over it to client.</p>
+ * @param pFstMk - FST maker with all words
+ * @return FST section (to free by client) or NULL when error
+ * @set errno if error.
+ **/
+char *bsdiixfstmk_end (BsDiIxFstMk *pFstMk);
+
+/**
+ * <p>Destructor.</p>
+ * @param pFstMk - FST maker or NULL
+ * @return always NULL
+ **/
+BsDiIxFstMk *bsdiixfstmk_free (BsDiIxFstMk *pFstMk);
+
+/**
+ * <p>Make FST from ordered i.words of DWOLT, i.e. with not zero
+ * length_dword.</p>
+ * @param pIwrds - ordered i.words
+ * @return FST section or NULL when error
+ * @set errno if error.
+ **/
+char *bsdiixfst_new (BsDicIwrds *pIwrds);
+
+//FST section's head fields:
+#define BDI_FST_MXLEN(pFst) (*(const int*) ((const char*) (pFst) + BDI_FST_MXLEN_OFST))
+#define BDI_FST_CNT(pFst) (*(const BS_IDX_T*) ((const char*) (pFst) + BDI_FST_CNT_OFST))
+#define BDI_FST_SZ(pFst) (*(const BS_FOFST_T*) ((const char*) (pFst) + BDI_FST_SZ_OFST))
+#define BDI_FST_ROOT(pFst) (*(const BS_FOFST_T*) ((const char*) (pFst) + BDI_FST_ROOT_OFST))
+
+/**
+ * <p>Find word's DWOLT index.</p>
+ * @param pFst - FST
+ * @param pIwrd - i.word
+ * @return DWOLT index or BS_IDX_NULL if there is no such word
+ **/
+BS_IDX_T bsdiixfst_find (const char *pFst, const BS_CHAR_T *pIwrd);
+
+/**
+ * <p>Find DWOLT range of words that start with given prefix.</p>
+ * @param pFst - FST
+ * @param pPrfx - i.word's prefix, empty one means all words
+ * @param pEndRt - pointer to return range's end (exclusive)
+ * @return range's start or BS_IDX_NULL if there is no such word
+ **/
+BS_IDX_T bsdiixfst_prefix (const char *pFst, const BS_CHAR_T *pPrfx,
+                           BS_IDX_T *pEndRt);
+
+/**
+ * <p>Iterator over words that start with given prefix in ascending order.</p>
+ * @member const unsigned char *fst - FST
+ * @member BS_CHAR_T *wrd - current word, max word length + 1
+ * @member int prfxLen - prefix length
+ * @member int lvl - current level, i.e. word's length minus prefix's one,
+ *   -1 means that there is no more words
+ * @member BS_FOFST_T *poss - next arcs offsets of levels states,
+ *   0 means that state has no more arcs
+ * @member BS_IDX_T *outs - outputs sums at levels states
+ * @member BS_IDX_T prfxIdx - prefix's DWOLT index if prefix is word
+ *   that isn't yet returned, otherwise BS_IDX_NULL
+ **/
+typedef struct {
+  const unsigned char *fst;
+  BS_CHAR_T *wrd;
+  int prfxLen;
+  int lvl;
+  BS_FOFST_T *poss;
+  BS_IDX_T *outs;
+  BS_IDX_T prfxIdx;
+} BsDiIxFstIt;
+
+/**
+ * <p>Constructor.</p>
+ * @param pFst - FST
+ * @param pPrfx - i.word's prefix, empty one means all words
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFstIt *bsdiixfstit_new (const char *pFst, const BS_CHAR_T *pPrfx);
+
+/**
+ * <p>Get next word.</p>
+ * @param pFstIt - iterator
+ * @param pIdxRt - pointer to return word's DWOLT index
+ * @return word that is valid until next call or NULL if there is no more
+ **/
+const BS_CHAR_T *bsdiixfstit_next (BsDiIxFstIt *pFstIt, BS_IDX_T *pIdxRt);
+
+/**
+ * <p>Destructor.</p>
+ * @param pFstIt - iterator or NULL
+ * @return always NULL
+ **/
+BsDiIxFstIt *bsdiixfstit_free (BsDiIxFstIt *pFstIt);
+
+//the max fuzzy finding distance:
+#define BDI_FST_FZ_DSTMX 2
+//default visited arcs budget of fuzzy finding, i.e. its latency bound:
+#define BDI_FST_FZ_ARCS 200000L
+
+/**
+ * <p>DWOLT range of words found by fuzzy finding.</p>
+ * @member BS_IDX_T stt - range's start
+ * @member BS_IDX_T end - range's end (exclusive)
+ * @member int dst - edit distance between given word and these words' prefix
+ **/
+typedef struct {
+  BS_IDX_T stt;
+  BS_IDX_T end;
+  int dst;
+} BsDiIxFstFz;
+
+/**
+ * <p>Find words that start with prefix that differs from given word by up to
+ * given edits (insertion, deletion, substitution or adjacent chars
+ * transposition), i.e. typo tolerant completion. It's Levenshtein automaton
+ * simulated by distances row per FST level, so subtree is skipped as soon
+ * as any its word is too far and it's taken whole as DWOLT range as soon as
+ * its words can't be closer. Max distance is lowered while finding as soon as
+ * closer words are enough. Ranges are ordered by distance then by DWOLT
+ * index and they're cut to given words total.</p>
+ * @param pFst - FST
+ * @param pIwrd - not empty i.word
+ * @param pDst - max distance 0..BDI_FST_FZ_DSTMX
+ * @param pWrdsMx - max words to find
+ * @param pArcsMx - visited arcs budget, when it's run out the rest FST
+ *   isn't visited
+ * @param pSzRt - pointer to return ranges total
+ * @return ranges to free by client or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxFstFz *bsdiixfst_fuzzy (const char *pFst, const BS_CHAR_T *pIwrd,
+  int pDst, BS_IDX_T pWrdsMx, long pArcsMx, int *pSzRt);
+
+/**
+ * <p>Write FST at IDX file current position.</p>
+ * @param pFst - FST
+ * @param pIdxFl - IDX file positioned at HWP end
+ * @set errno if error.
+ **/
+void bsdiixfst_write (const char *pFst, FILE *pIdxFl);
+
+/**
+ * <p>Reveal FST size in IDX file. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - FST offset, i.e. HWP end
+ * @param pCnt - DWOLT size
+ * @return FST size or 0 if IDX file without FST
+ * @set errno if error. "FST not found" is not error!
+ **/
+BS_FOFST_T bsdiixfst_size (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt);
+
+/**
+ * <p>Load FST from IDX file into memory. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - FST offset, i.e. HWP end
+ * @param pCnt - DWOLT size
+ * @return FST or NULL if error or IDX file without FST
+ * @set errno if error. "FST not found" is not error!
+ **/
+char *bsdiixfst_load (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt);
+#endif
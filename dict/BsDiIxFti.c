@@ -0,0 +1,1481 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ full-text index (FTI) of DSL articles' content.</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "unistd.h"
+#include "fcntl.h"
+#include "pthread.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsFioWrap.h"
+#include "BsArena.h"
+#include "BsUcFold.h"
+#include "BsDicWordDsl.h"
+#include "BsDicIwrdsMt.h"
+#include "BsDiIxMm.h"
+#include "BsDiIxFti.h"
+
+//head fields offsets:
+#define S_HD_MAGIC 0
+#define S_HD_VER 4
+#define S_HD_IDXSZ 8
+#define S_HD_IDXMTIME 16
+#define S_HD_DOCSSZ 24
+#define S_HD_DWOLTSZ 32
+#define S_HD_TRMSSZ 40
+#define S_HD_DOCSOFST 48
+#define S_HD_DOCDWSOFST 56
+#define S_HD_TRMSOFST 64
+#define S_HD_TXTOFST 72
+#define S_HD_PSTSOFST 80
+#define S_HD_FLSZ 88
+
+//term record fields offsets:
+#define S_TR_PST 0
+#define S_TR_TXT 8
+#define S_TR_DF 16
+#define S_TR_SKP 20
+
+//varint max bytes of uint32:
+#define S_VINT_MX 5
+//arena block size for shard's terms:
+#define S_ARENA_BLKSZ 1048576
+//initial sizes:
+#define S_HSH_INITSZ 4096
+#define S_TKNS_INITSZ 256
+#define S_DOCS_INITSZ 1024
+#define S_PST_INITSZ 16
+//end of postings mark:
+#define S_DOC_END UINT32_MAX
+
+//term record #pIdx fields:
+#define S_TR(pFti, pIdx) ((pFti)->trms + (pIdx) * BDI_FTI_TRMRD_SZ)
+#define S_TR_PSTOF(pFti, pIdx) (*(const int64_t*) (S_TR (pFti, pIdx) + S_TR_PST))
+#define S_TR_TXTOF(pFti, pIdx) (*(const int64_t*) (S_TR (pFti, pIdx) + S_TR_TXT))
+#define S_TR_DFS(pFti, pIdx) (*(const uint32_t*) (S_TR (pFti, pIdx) + S_TR_DF))
+#define S_TR_SKPS(pFti, pIdx) (*(const uint32_t*) (S_TR (pFti, pIdx) + S_TR_SKP))
+
+/**
+ * <p>Term consumer.</p>
+ * @param pTrm - folded UTF-8 term, not 0 terminated
+ * @param pLen - its length in bytes
+ * @param pInst - consumer's data
+ **/
+typedef void BsDiIxFti_Trm_Csm (const char *pTrm, int pLen, void *pInst);
+
+/**
+ * <p>Shard's term.</p>
+ * @member char *trm - 0 terminated text
+ * @member unsigned char *pst - postings buffer
+ * @member uint32_t sz - postings size
+ * @member uint32_t bsz - postings buffer size
+ * @member uint32_t df - documents total
+ * @member uint32_t lstDoc - the last shard's document
+ **/
+typedef struct {
+  char *trm;
+  unsigned char *pst;
+  uint32_t sz;
+  uint32_t bsz;
+  uint32_t df;
+  uint32_t lstDoc;
+} BsDiIxFtiTrm;
+
+/**
+ * <p>Current document's token.</p>
+ * @member BsDiIxFtiTrm *trm - term
+ * @member uint32_t pos - position in document
+ **/
+typedef struct {
+  BsDiIxFtiTrm *trm;
+  uint32_t pos;
+} BsDiIxFtiTkn;
+
+/**
+ * <p>Shard's worker data.</p>
+ * @member char *dt - mapped dictionary
+ * @member BS_FOFST_T stt - shard's start, article start
+ * @member BS_FOFST_T end - shard's end, article start or content size
+ * @member bool hasApo - whether AB has apostrophe
+ * @member bool hasHyp - whether AB has hyphen
+ * @member BsArena *arena - terms arena
+ * @member BsDiIxFtiTrm **trms - terms hash (open addressing),
+ *   then terms sorted by text
+ * @member uint32_t trmsBsz - hash size, power of 2
+ * @member uint32_t trmsSz - terms total
+ * @member BsDiIxFtiTkn *tkns - current document's tokens
+ * @member uint32_t tknsSz - tokens total
+ * @member uint32_t tknsBsz - tokens buffer size
+ * @member BS_FOFST_T *docs - documents starts
+ * @member uint32_t docsSz - documents total
+ * @member uint32_t docsBsz - documents buffer size
+ * @member int err - worker's errno
+ **/
+typedef struct {
+  char *dt;
+  BS_FOFST_T stt;
+  BS_FOFST_T end;
+  bool hasApo;
+  bool hasHyp;
+  BsArena *arena;
+  BsDiIxFtiTrm **trms;
+  uint32_t trmsBsz;
+  uint32_t trmsSz;
+  BsDiIxFtiTkn *tkns;
+  uint32_t tknsSz;
+  uint32_t tknsBsz;
+  BS_FOFST_T *docs;
+  uint32_t docsSz;
+  uint32_t docsBsz;
+  int err;
+} BsDiIxFtiShrd;
+
+/**
+ * <p>Query's terms.</p>
+ * @member int sz - terms total
+ * @member char trms - 0 terminated terms
+ **/
+typedef struct {
+  int sz;
+  char trms[BDI_FTI_QRYMX][BDI_FTI_TRMMX + 1];
+} BsDiIxFtiQry;
+
+/**
+ * <p>Term's postings cursor.</p>
+ * @member const unsigned char *bgn - documents start
+ * @member const unsigned char *cur - next document
+ * @member const uint32_t *skps - skips
+ * @member uint32_t skpsSz - skips total
+ * @member uint32_t skpIdx - the next skip to try
+ * @member uint32_t df - documents total
+ * @member uint32_t n - read documents
+ * @member uint32_t doc - current document or S_DOC_END
+ * @member uint32_t tf - current document's term frequency
+ * @member const unsigned char *poss - current document's positions
+ * @member bool isCur - whether doc is read current one
+ * @member int qPos - term's position in query
+ **/
+typedef struct {
+  const unsigned char *bgn;
+  const unsigned char *cur;
+  const uint32_t *skps;
+  uint32_t skpsSz;
+  uint32_t skpIdx;
+  uint32_t df;
+  uint32_t n;
+  uint32_t doc;
+  uint32_t tf;
+  const unsigned char *poss;
+  bool isCur;
+  int qPos;
+} BsDiIxFtiCur;
+
+//local lib:
+/**
+ * <p>Put little-endian number into buffer.</p>
+ * @param pBuf - buffer
+ * @param pVal - number
+ * @param pLen - number's size in bytes
+ **/
+static void
+  s_put (unsigned char *pBuf, uint64_t pVal, int pLen)
+{
+  for ( int i = 0; i < pLen; i++ )
+  {
+    pBuf[i] = (unsigned char) (pVal & 0xFF);
+    pVal >>= 8;
+  }
+}
+
+/**
+ * <p>Get little-endian number from buffer.</p>
+ * @param pBuf - buffer
+ * @param pLen - number's size in bytes
+ * @return number
+ **/
+static uint64_t
+  s_get (const unsigned char *pBuf, int pLen)
+{
+  uint64_t rz = 0;
+  for ( int i = pLen - 1; i >= 0; i-- )
+        { rz = ( rz << 8 ) | pBuf[i]; }
+  return rz;
+}
+
+/**
+ * <p>Write zero padding up to given alignment.</p>
+ * @param pFl - file
+ * @param pAlgn - alignment, up to 8
+ * @set errno if error.
+ **/
+static void
+  s_pad (FILE *pFl, int pAlgn)
+{
+  char zrs[8] = { 0 };
+  int cnt = ( pAlgn - ftell (pFl) % pAlgn ) % pAlgn;
+  if ( cnt > 0 )
+        { BS_IF_EN_RET (fwrite (zrs, 1, cnt, pFl) != (size_t) cnt, BSE_WRITE_FILE) }
+}
+
+/**
+ * <p>Check if host is little-endian, i.e. mapped numbers are usable as is.</p>
+ * @return if little-endian
+ **/
+static bool
+  s_is_le (void)
+{
+  uint16_t one = 1;
+  return *((unsigned char*) &one) == 1;
+}
+
+/**
+ * <p>Read IDX v1 file size and modification time.</p>
+ * @param pDiIx - IDX in file
+ * @param pSzRt - pointer to return size
+ * @param pMtimeRt - pointer to return modification time in nanoseconds
+ * @set errno if error.
+ **/
+static void
+  s_idx_stat (BsDiIxTx *pDiIx, int64_t *pSzRt, int64_t *pMtimeRt)
+{
+  struct stat st;
+  int fd = fileno (pDiIx->idxFl);
+  BS_IF_EN_RET (fd == -1 || fstat (fd, &st) != 0, BSE_READ_FILE)
+  *pSzRt = st.st_size;
+  *pMtimeRt = st.st_mtim.tv_sec * 1000000000L + st.st_mtim.tv_nsec;
+}
+
+/**
+ * <p>Put varint.</p>
+ * @param pBuf - buffer with S_VINT_MX bytes at least
+ * @param pVal - number
+ * @return written bytes
+ **/
+static int
+  s_vput (unsigned char *pBuf, uint32_t pVal)
+{
+  int i = 0;
+  while ( pVal >= 0x80 )
+  {
+    pBuf[i++] = (unsigned char) ( pVal | 0x80 );
+    pVal >>= 7;
+  }
+  pBuf[i++] = (unsigned char) pVal;
+  return i;
+}
+
+/**
+ * <p>Get varint.</p>
+ * @param pCur - pointer to varint, it's moved after it
+ * @return number
+ **/
+static uint32_t
+  s_vget (const unsigned char **pCur)
+{
+  const unsigned char *c = *pCur;
+  uint32_t rz = *c & 0x7F;
+  int sh = 7;
+  while ( *c & 0x80 )
+  {
+    c++;
+    rz |= (uint32_t) ( *c & 0x7F ) << sh;
+    sh += 7;
+  }
+  *pCur = c + 1;
+  return rz;
+}
+
+/**
+ * <p>Encode char into UTF-8.</p>
+ * @param pWch - char
+ * @param pBuf - buffer with 4 bytes at least
+ * @return bytes count
+ **/
+static int
+  s_utf8_enc (BS_WCHAR_T pWch, char *pBuf)
+{
+  uint32_t c = (uint32_t) pWch;
+  if ( c < 0x80 )
+  {
+    pBuf[0] = (char) c;
+    return 1;
+  }
+  if ( c < 0x800 )
+  {
+    pBuf[0] = (char) ( 0xC0 | ( c >> 6 ) );
+    pBuf[1] = (char) ( 0x80 | ( c & 0x3F ) );
+    return 2;
+  }
+  if ( c < 0x10000 )
+  {
+    pBuf[0] = (char) ( 0xE0 | ( c >> 12 ) );
+    pBuf[1] = (char) ( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+    pBuf[2] = (char) ( 0x80 | ( c & 0x3F ) );
+    return 3;
+  }
+  pBuf[0] = (char) ( 0xF0 | ( c >> 18 ) );
+  pBuf[1] = (char) ( 0x80 | ( ( c >> 12 ) & 0x3F ) );
+  pBuf[2] = (char) ( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+  pBuf[3] = (char) ( 0x80 | ( c & 0x3F ) );
+  return 4;
+}
+
+/**
+ * <p>Tokenize DSL content line or query. Tags are skipped as invisible,
+ * e.g. stress "[']" inside word, media [s]..[/s] is skipped whole,
+ * comments {{..}} and wrong UTF-8 separate words, escaped char is usual one.
+ * Term is folded letters and digits, apostrophe or hyphen is its part
+ * if it's inside word and AB has it. Term longer than BDI_FTI_TRMMX
+ * bytes is cut.</p>
+ * @param pSt - start
+ * @param pEn - end
+ * @param pHasApo - whether AB has apostrophe
+ * @param pHasHyp - whether AB has hyphen
+ * @param pCsm - terms consumer
+ * @param pInst - consumer's data
+ **/
+static void
+  s_tknz (unsigned char *pSt, unsigned char *pEn, bool pHasApo, bool pHasHyp,
+          BsDiIxFti_Trm_Csm *pCsm, void *pInst)
+{
+  //vars:
+  char trm[BDI_FTI_TRMMX + 4];
+  int ln = 0, jn = 0, n;
+  bool isMda = false;
+  unsigned char *c = pSt, *e;
+  BS_WCHAR_T wch;
+  //code:
+  while ( c < pEn )
+  {
+    if ( *c == '[' )
+    { //tag:
+      e = memchr (c, ']', pEn - c);
+      if ( e == NULL )
+                { e = pEn - 1; }
+      if ( e - c == 2 && c[1] == 's' )
+      {
+        isMda = true;
+      } else if ( e - c == 3 && c[1] == '/' && c[2] == 's' ) {
+        isMda = false;
+      }
+      c = e + 1;
+      continue;
+    }
+    if ( c[0] == '{' && c + 1 < pEn && c[1] == '{' )
+    { //comment:
+      for ( e = c + 2; e + 1 < pEn && !( e[0] == '}' && e[1] == '}' ); e++ ) ;
+      c = e + 2;
+      wch = ' ';
+    } else {
+      if ( *c == '\\' && c + 1 < pEn )
+                { c++; }
+      n = bsdicdslmm_utf8_dec (c, pEn, &wch);
+      if ( n == -1 )
+      {
+        n = 1;
+        wch = ' ';
+      }
+      c += n;
+      if ( isMda )
+                { continue; }
+    }
+    if ( bsucfold_isalpha (wch) || ( wch >= '0' && wch <= '9' ) )
+    {
+      char bts[4];
+      n = s_utf8_enc (bsucfold_fold (wch), bts);
+      if ( ln + n <= BDI_FTI_TRMMX )
+      { //the rest of long term is cut:
+        memcpy (trm + ln, bts, n);
+        ln += n;
+        jn = 0;
+      }
+    } else if ( ln > 0 && jn == 0 && ln < BDI_FTI_TRMMX
+            && ( ( wch == '\'' && pHasApo ) || ( wch == '-' && pHasHyp ) ) ) {
+      trm[ln++] = (char) wch;
+      jn = 1;
+    } else if ( ln > 0 ) { //trailing joiner is dropped:
+      if ( ln - jn > 0 )
+                { pCsm (trm, ln - jn, pInst); }
+      ln = jn = 0;
+    }
+  }
+  if ( ln - jn > 0 )
+                { pCsm (trm, ln - jn, pInst); }
+}
+
+/**
+ * <p>Query's terms consumer, the rest ones over BDI_FTI_QRYMX are ignored.</p>
+ * @param pTrm - term
+ * @param pLen - its length
+ * @param pQry - query
+ **/
+static void
+  s_qry_csm (const char *pTrm, int pLen, void *pQry)
+{
+  BsDiIxFtiQry *qry = (BsDiIxFtiQry*) pQry;
+  if ( qry->sz < BDI_FTI_QRYMX )
+  {
+    memcpy (qry->trms[qry->sz], pTrm, pLen);
+    qry->trms[qry->sz][pLen] = 0;
+    qry->sz++;
+  }
+}
+
+/**
+ * <p>FNV-1a hash.</p>
+ * @param pTrm - term
+ * @param pLen - its length
+ * @return hash
+ **/
+static uint32_t
+  s_hash (const char *pTrm, int pLen)
+{
+  uint32_t h = 2166136261U;
+  for ( int i = 0; i < pLen; i++ )
+  {
+    h ^= (unsigned char) pTrm[i];
+    h *= 16777619U;
+  }
+  return h;
+}
+
+/**
+ * <p>Double shard's terms hash.</p>
+ * @param pShrd - shard
+ * @set errno if error.
+ **/
+static void
+  s_hsh_grow (BsDiIxFtiShrd *pShrd)
+{
+  uint32_t bsz = pShrd->trmsBsz * 2, i, h;
+  BsDiIxFtiTrm **trms = calloc (bsz, sizeof (BsDiIxFtiTrm*));
+  BS_IF_EN_RET (trms == NULL, ENOMEM)
+  for ( i = 0; i < pShrd->trmsBsz; i++ )
+  {
+    if ( pShrd->trms[i] != NULL )
+    {
+      h = s_hash (pShrd->trms[i]->trm, strlen (pShrd->trms[i]->trm)) & ( bsz - 1 );
+      while ( trms[h] != NULL )
+                { h = ( h + 1 ) & ( bsz - 1 ); }
+      trms[h] = pShrd->trms[i];
+    }
+  }
+  free (pShrd->trms);
+  pShrd->trms = trms;
+  pShrd->trmsBsz = bsz;
+}
+
+/**
+ * <p>Shard's terms consumer, it adds term's token into current document.</p>
+ * @param pTrm - term
+ * @param pLen - its length
+ * @param pShrd - shard
+ * @set errno if error.
+ **/
+static void
+  s_shrd_csm (const char *pTrm, int pLen, void *pShrd)
+{
+  BsDiIxFtiShrd *shrd = (BsDiIxFtiShrd*) pShrd;
+  BsDiIxFtiTrm *trm;
+  uint32_t h;
+  if ( errno != 0 )
+                { return; }
+  h = s_hash (pTrm, pLen) & ( shrd->trmsBsz - 1 );
+  while ( ( trm = shrd->trms[h] ) != NULL
+    && ( strncmp (trm->trm, pTrm, pLen) != 0 || trm->trm[pLen] != 0 ) )
+                { h = ( h + 1 ) & ( shrd->trmsBsz - 1 ); }
+  if ( trm == NULL )
+  {
+    trm = bsarena_alloc (shrd->arena, sizeof (BsDiIxFtiTrm) + pLen + 1);
+    BS_IF_EN_RET (trm == NULL, ENOMEM)
+    trm->trm = (char*) ( trm + 1 );
+    memcpy (trm->trm, pTrm, pLen);
+    trm->trm[pLen] = 0;
+    trm->pst = NULL;
+    trm->sz = trm->bsz = trm->df = trm->lstDoc = 0;
+    shrd->trms[h] = trm;
+    shrd->trmsSz++;
+    if ( shrd->trmsSz * 2 > shrd->trmsBsz )
+                { BS_DO_E_RET (s_hsh_grow (shrd)) }
+  }
+  if ( shrd->tknsSz == shrd->tknsBsz )
+  {
+    BsDiIxFtiTkn *tkns = realloc (shrd->tkns, shrd->tknsBsz * 2 * sizeof (BsDiIxFtiTkn));
+    BS_IF_EN_RET (tkns == NULL, ENOMEM)
+    shrd->tkns = tkns;
+    shrd->tknsBsz *= 2;
+  }
+  shrd->tkns[shrd->tknsSz].trm = trm;
+  shrd->tkns[shrd->tknsSz].pos = shrd->tknsSz;
+  shrd->tknsSz++;
+}
+
+/**
+ * <p>Compare tokens by term, then by position.</p>
+ * @param pTkn1 - token1
+ * @param pTkn2 - token2
+ * @return pTkn1 -1 less 0 equal 1 greater than pTkn2
+ **/
+static int
+  s_cmp_tkn (const void *pTkn1, const void *pTkn2)
+{
+  const BsDiIxFtiTkn *tk1 = (const BsDiIxFtiTkn*) pTkn1;
+  const BsDiIxFtiTkn *tk2 = (const BsDiIxFtiTkn*) pTkn2;
+  if ( tk1->trm != tk2->trm )
+                { return tk1->trm < tk2->trm ? -1 : 1; }
+  if ( tk1->pos != tk2->pos )
+                { return tk1->pos < tk2->pos ? -1 : 1; }
+  return 0;
+}
+
+/**
+ * <p>Compare terms by text.</p>
+ * @param pTrm1 - pointer to term1
+ * @param pTrm2 - pointer to term2
+ * @return pTrm1 -1 less 0 equal 1 greater than pTrm2
+ **/
+static int
+  s_cmp_trm (const void *pTrm1, const void *pTrm2)
+{
+  return strcmp ((*(BsDiIxFtiTrm**) pTrm1)->trm, (*(BsDiIxFtiTrm**) pTrm2)->trm);
+}
+
+/**
+ * <p>Append current document's tokens into its terms postings.
+ * Term's first document is shard's one, next ones are deltas.</p>
+ * @param pShrd - shard
+ * @set errno if error.
+ **/
+static void
+  s_doc_end (BsDiIxFtiShrd *pShrd)
+{
+  uint32_t i, j, k, doc = pShrd->docsSz - 1, prv;
+  BsDiIxFtiTrm *trm;
+  qsort (pShrd->tkns, pShrd->tknsSz, sizeof (BsDiIxFtiTkn), s_cmp_tkn);
+  for ( i = 0; i < pShrd->tknsSz; i = j )
+  {
+    trm = pShrd->tkns[i].trm;
+    for ( j = i + 1; j < pShrd->tknsSz && pShrd->tkns[j].trm == trm; j++ ) ;
+    if ( trm->sz + ( j - i + 2 ) * S_VINT_MX > trm->bsz )
+    {
+      uint32_t bsz = trm->bsz == 0 ? S_PST_INITSZ : trm->bsz * 2;
+      if ( bsz < trm->sz + ( j - i + 2 ) * S_VINT_MX )
+                { bsz = trm->sz + ( j - i + 2 ) * S_VINT_MX; }
+      unsigned char *pst = realloc (trm->pst, bsz);
+      BS_IF_EN_RET (pst == NULL, ENOMEM)
+      trm->pst = pst;
+      trm->bsz = bsz;
+    }
+    trm->sz += s_vput (trm->pst + trm->sz, trm->df == 0 ? doc : doc - trm->lstDoc);
+    trm->sz += s_vput (trm->pst + trm->sz, j - i);
+    prv = 0;
+    for ( k = i; k < j; k++ )
+    {
+      trm->sz += s_vput (trm->pst + trm->sz, pShrd->tkns[k].pos - prv);
+      prv = pShrd->tkns[k].pos;
+    }
+    trm->lstDoc = doc;
+    trm->df++;
+  }
+  pShrd->tknsSz = 0;
+}
+
+/**
+ * <p>Worker that tokenizes shard's articles into terms postings,
+ * then it sorts terms by text. Article's headwords lines aren't tokenized,
+ * article that has no content is empty document.</p>
+ * @param pShrd - shard
+ * @return always NULL
+ **/
+static void*
+  s_wrk_tknz (void *pShrd)
+{
+  BsDiIxFtiShrd *shrd = (BsDiIxFtiShrd*) pShrd;
+  unsigned char *c, *en, *le;
+  bool isCnt = true;
+  uint32_t i, j;
+  errno = 0;
+  c = (unsigned char*) shrd->dt + shrd->stt;
+  en = (unsigned char*) shrd->dt + shrd->end;
+  while ( c < en )
+  {
+    le = memchr (c, '\n', en - c);
+    if ( le == NULL )
+                { le = en; }
+    if ( *c == '\t' || *c == ' ' )
+    {
+      if ( shrd->docsSz > 0 )
+      {
+        BS_DO_E_OUT (s_tknz (c, le, shrd->hasApo, shrd->hasHyp, s_shrd_csm, shrd))
+        isCnt = true;
+      }
+    } else if ( *c != '\n' && *c != '\r' && isCnt ) { //new article:
+      if ( shrd->docsSz > 0 )
+                { BS_DO_E_OUT (s_doc_end (shrd)) }
+      BS_IF_EN_OUT (shrd->docsSz == S_DOC_END - 1, BSE_WRONG_PARAMS)
+      if ( shrd->docsSz == shrd->docsBsz )
+      {
+        BS_FOFST_T *docs = realloc (shrd->docs, shrd->docsBsz * 2 * BS_FOFST_LEN);
+        BS_IF_EN_OUT (docs == NULL, ENOMEM)
+        shrd->docs = docs;
+        shrd->docsBsz *= 2;
+      }
+      shrd->docs[shrd->docsSz++] = (char*) c - shrd->dt;
+      isCnt = false;
+    }
+    c = le + 1;
+  }
+  if ( shrd->docsSz > 0 )
+                { BS_DO_E_OUT (s_doc_end (shrd)) }
+  //terms hash into sorted terms:
+  for ( i = 0, j = 0; i < shrd->trmsBsz; i++ )
+  {
+    if ( shrd->trms[i] != NULL )
+                { shrd->trms[j++] = shrd->trms[i]; }
+  }
+  qsort (shrd->trms, shrd->trmsSz, sizeof (BsDiIxFtiTrm*), s_cmp_trm);
+out:
+  shrd->err = errno;
+  return NULL;
+}
+
+/**
+ * <p>Run given worker for every shard in its own thread and wait for all.</p>
+ * @param pShrds - shards
+ * @param pCnt - shards count
+ * @param pWrk - worker
+ * @set errno if error.
+ **/
+static void
+  s_run_wrks (BsDiIxFtiShrd *pShrds, int pCnt, void *(*pWrk) (void*))
+{
+  pthread_t thrds[pCnt];
+  int i, crtd = 0, err = 0;
+  for ( i = 0; i < pCnt; i++ )
+  {
+    pShrds[i].err = 0;
+    if ( pthread_create (&thrds[i], NULL, pWrk, (void*) &pShrds[i]) != 0 )
+    {
+      err = BSE_ERR;
+      BSLOG_LOG (BSLERROR, "Can't create thread#%d\n", i)
+      break;
+    }
+    crtd++;
+  }
+  for ( i = 0; i < crtd; i++ )
+  {
+    pthread_join (thrds[i], NULL);
+    if ( err == 0 && pShrds[i].err != 0 )
+                { err = pShrds[i].err; }
+  }
+  errno = err;
+}
+
+/**
+ * <p>Make documents DWOLT indexes by DWOLT offsets, i.e. document of
+ * headword is the last one that starts at or before it.</p>
+ * @param pDiIx - IDX in file
+ * @param pStts - documents starts
+ * @param pDocsSz - documents total
+ * @param pDocs - documents starts in DWOLT indexes to fill [pDocsSz + 1]
+ * @return DWOLT indexes in documents order or NULL if error
+ * @set errno if error.
+ **/
+static uint32_t*
+  s_docs_dws (BsDiIxTx *pDiIx, BS_FOFST_T *pStts, uint32_t pDocsSz,
+              uint32_t *pDocs)
+{
+  BS_IDX_T dwoltSz = pDiIx->head->dwoltSz, i;
+  BS_FOFST_T ofst;
+  BS_SMALL_T len;
+  uint32_t *docOf = NULL, *dws = NULL, *curs = NULL, l, r, m;
+  BS_IF_EN_RETN (dwoltSz >= (BS_IDX_T) S_DOC_END, BSE_WRONG_PARAMS)
+  docOf = malloc ((dwoltSz + 1) * sizeof (uint32_t));
+  dws = malloc ((dwoltSz + 1) * sizeof (uint32_t));
+  curs = malloc ((pDocsSz + 1) * sizeof (uint32_t));
+  BS_IF_EN_OUTE (docOf == NULL || dws == NULL || curs == NULL, ENOMEM)
+  memset (pDocs, 0, ( pDocsSz + 1 ) * sizeof (uint32_t));
+  if ( pDiIx->mm == NULL )
+                { BS_DO_E_OUTE (bsfseek_goto (pDiIx->idxFl, pDiIx->dwoltOfst)) }
+  for ( i = BS_IDX_0; i < dwoltSz; i++ )
+  {
+    if ( pDiIx->mm != NULL )
+    {
+      ofst = BDI_IDXMM_DWOFS (pDiIx->mm, i);
+    } else {
+      BS_DO_E_OUTE (bsdiixtx_read_ofst (&ofst, pDiIx->head->flgs, pDiIx->idxFl))
+      BS_DO_E_OUTE (bsfread_bssmall (&len, pDiIx->idxFl))
+    }
+    docOf[i] = S_DOC_END;
+    if ( pDocsSz > 0 && ofst >= pStts[0] )
+    {
+      for ( l = 0, r = pDocsSz; r - l > 1; )
+      {
+        m = l + ( r - l ) / 2;
+        if ( pStts[m] <= ofst )
+        {
+          l = m;
+        } else {
+          r = m;
+        }
+      }
+      docOf[i] = l;
+      pDocs[l + 1]++;
+    }
+  }
+  for ( l = 0; l < pDocsSz; l++ )
+  {
+    pDocs[l + 1] += pDocs[l];
+    curs[l] = pDocs[l];
+  }
+  for ( i = BS_IDX_0; i < dwoltSz; i++ )
+  {
+    if ( docOf[i] != S_DOC_END )
+                { dws[curs[docOf[i]]++] = (uint32_t) i; }
+  }
+  free (docOf);
+  free (curs);
+  return dws;
+
+oute:
+  free (docOf);
+  free (dws);
+  free (curs);
+  return NULL;
+}
+
+/**
+ * <p>Merge term's shards postings into buffer, every shard's first document
+ * becomes delta from the previous shard's last one. Shards postings are freed.</p>
+ * @param pShrds - shards
+ * @param pIdxs - shards current terms indexes, NULL means absent
+ * @param pBases - shards first documents
+ * @param pCnt - shards count
+ * @param pBuf - pointer to buffer to (re)allocate
+ * @param pBsz - pointer to buffer size
+ * @param pDfRt - pointer to return documents total
+ * @return postings size
+ * @set errno if error.
+ **/
+static uint32_t
+  s_merge_trm (BsDiIxFtiShrd *pShrds, BsDiIxFtiTrm **pTrms, uint32_t *pBases,
+    int pCnt, unsigned char **pBuf, size_t *pBsz, uint32_t *pDfRt)
+{
+  size_t sz = 0;
+  uint32_t prv = 0, doc, df = 0;
+  const unsigned char *c;
+  BsDiIxFtiTrm *trm;
+  for ( int i = 0; i < pCnt; i++ )
+  {
+    trm = pTrms[i];
+    if ( trm == NULL )
+                { continue; }
+    if ( sz + trm->sz + S_VINT_MX > *pBsz )
+    {
+      size_t bsz = ( sz + trm->sz + S_VINT_MX ) * 2;
+      unsigned char *buf = realloc (*pBuf, bsz);
+      BS_IF_EN_RETE (buf == NULL, ENOMEM)
+      *pBuf = buf;
+      *pBsz = bsz;
+    }
+    c = trm->pst;
+    doc = pBases[i] + s_vget (&c);
+    sz += s_vput (*pBuf + sz, df == 0 ? doc : doc - prv);
+    memcpy (*pBuf + sz, c, trm->sz - ( c - trm->pst ));
+    sz += trm->sz - ( c - trm->pst );
+    prv = pBases[i] + trm->lstDoc;
+    df += trm->df;
+    free (trm->pst);
+    trm->pst = NULL;
+  }
+  BS_IF_EN_RETE (sz >= S_DOC_END, BSE_WRONG_PARAMS)
+  *pDfRt = df;
+  return (uint32_t) sz;
+}
+
+/**
+ * <p>Write term's postings with skips.</p>
+ * @param pFl - file
+ * @param pPst - postings
+ * @param pSz - postings size
+ * @param pDf - documents total
+ * @return skips total
+ * @set errno if error.
+ **/
+static uint32_t
+  s_write_pst (FILE *pFl, const unsigned char *pPst, uint32_t pSz, uint32_t pDf)
+{
+  uint32_t skpsSz = ( pDf - 1 ) / BDI_FTI_SKIP, n, doc = 0, tf;
+  uint32_t skps[2 * skpsSz + 1];
+  const unsigned char *c = pPst;
+  for ( n = 0; n < pDf; n++ )
+  {
+    if ( n > 0 && n % BDI_FTI_SKIP == 0 )
+    {
+      skps[2 * ( n / BDI_FTI_SKIP - 1 )] = doc;
+      skps[2 * ( n / BDI_FTI_SKIP - 1 ) + 1] = c - pPst;
+    }
+    doc += s_vget (&c);
+    tf = s_vget (&c);
+    while ( tf-- > 0 )
+                { s_vget (&c); }
+  }
+  if ( skpsSz > 0 )
+  {
+    BS_IF_EN_RETE (fwrite (skps, sizeof (uint32_t), 2 * skpsSz, pFl)
+                     != 2 * skpsSz, BSE_WRITE_FILE)
+  }
+  BS_IF_EN_RETE (fwrite (pPst, 1, pSz, pFl) != pSz, BSE_WRITE_FILE)
+  BS_DO_E_RETE (s_pad (pFl, 4))
+  return skpsSz;
+}
+
+/**
+ * <p>Write FTI without head from tokenized shards.</p>
+ * @param pDiIx - IDX in file
+ * @param pShrds - shards
+ * @param pCnt - shards count
+ * @param pFl - file
+ * @param pHd - head to fill
+ * @set errno if error.
+ **/
+static void
+  s_write (BsDiIxTx *pDiIx, BsDiIxFtiShrd *pShrds, int pCnt, FILE *pFl,
+           unsigned char *pHd)
+{
+  //vars:
+  uint32_t docsSz = 0, bases[pCnt], idxs[pCnt], *docs = NULL, *dws = NULL;
+  uint32_t psz, df, skpsSz;
+  BsDiIxFtiTrm *trms[pCnt];
+  BS_FOFST_T *stts = NULL;
+  unsigned char *buf = NULL, *rds = NULL, rd[BDI_FTI_TRMRD_SZ];
+  char *txt = NULL;
+  size_t bsz = 0, rdsSz = 0, rdsBsz = 0, txtSz = 0, txtBsz = 0, ln;
+  int64_t pstsOfst, ofst;
+  int mn, j;
+  //code:
+  for ( j = 0; j < pCnt; j++ )
+  {
+    bases[j] = docsSz;
+    idxs[j] = 0;
+    docsSz += pShrds[j].docsSz;
+  }
+  //documents:
+  stts = malloc (( docsSz + 1 ) * BS_FOFST_LEN);
+  docs = malloc (( docsSz + 1 ) * sizeof (uint32_t));
+  BS_IF_EN_OUTE (stts == NULL || docs == NULL, ENOMEM)
+  for ( j = 0; j < pCnt; j++ )
+  {
+    if ( pShrds[j].docsSz > 0 )
+                { memcpy (stts + bases[j], pShrds[j].docs, pShrds[j].docsSz * BS_FOFST_LEN); }
+  }
+  BS_DO_E_OUTE (dws = s_docs_dws (pDiIx, stts, docsSz, docs))
+  s_put (pHd + S_HD_DOCSSZ, docsSz, 8);
+  s_put (pHd + S_HD_DWOLTSZ, docs[docsSz], 8);
+  s_put (pHd + S_HD_DOCSOFST, ftell (pFl), 8);
+  BS_IF_EN_OUTE (fwrite (docs, sizeof (uint32_t), docsSz + 1, pFl)
+                   != docsSz + 1, BSE_WRITE_FILE)
+  s_put (pHd + S_HD_DOCDWSOFST, ftell (pFl), 8);
+  if ( docs[docsSz] > 0 )
+  {
+    BS_IF_EN_OUTE (fwrite (dws, sizeof (uint32_t), docs[docsSz], pFl)
+                     != docs[docsSz], BSE_WRITE_FILE)
+  }
+  BS_DO_E_OUTE (s_pad (pFl, 8))
+  //postings in terms order:
+  pstsOfst = ftell (pFl);
+  s_put (pHd + S_HD_PSTSOFST, pstsOfst, 8);
+  while ( true )
+  {
+    mn = -1;
+    for ( j = 0; j < pCnt; j++ )
+    {
+      trms[j] = NULL;
+      if ( idxs[j] < pShrds[j].trmsSz && ( mn == -1
+        || strcmp (pShrds[j].trms[idxs[j]]->trm, pShrds[mn].trms[idxs[mn]]->trm) < 0 ) )
+                { mn = j; }
+    }
+    if ( mn == -1 )
+                { break; }
+    for ( j = 0; j < pCnt; j++ )
+    {
+      if ( idxs[j] < pShrds[j].trmsSz
+        && strcmp (pShrds[j].trms[idxs[j]]->trm, pShrds[mn].trms[idxs[mn]]->trm) == 0 )
+                { trms[j] = pShrds[j].trms[idxs[j]]; }
+    }
+    ofst = ftell (pFl) - pstsOfst;
+    BS_DO_E_OUTE (psz = s_merge_trm (pShrds, trms, bases, pCnt, &buf, &bsz, &df))
+    BS_DO_E_OUTE (skpsSz = s_write_pst (pFl, buf, psz, df))
+    ln = strlen (trms[mn]->trm) + 1;
+    if ( rdsSz + BDI_FTI_TRMRD_SZ * 2 > rdsBsz || txtSz + ln > txtBsz )
+    {
+      rdsBsz = ( rdsSz + BDI_FTI_TRMRD_SZ * 2 ) * 2;
+      txtBsz = ( txtSz + ln ) * 2;
+      unsigned char *nrds = realloc (rds, rdsBsz);
+      if ( nrds != NULL )
+                { rds = nrds; }
+      char *ntxt = realloc (txt, txtBsz);
+      if ( ntxt != NULL )
+                { txt = ntxt; }
+      BS_IF_EN_OUTE (nrds == NULL || ntxt == NULL, ENOMEM)
+    }
+    s_put (rds + rdsSz + S_TR_PST, ofst, 8);
+    s_put (rds + rdsSz + S_TR_TXT, txtSz, 8);
+    s_put (rds + rdsSz + S_TR_DF, df, 4);
+    s_put (rds + rdsSz + S_TR_SKP, skpsSz, 4);
+    rdsSz += BDI_FTI_TRMRD_SZ;
+    memcpy (txt + txtSz, trms[mn]->trm, ln);
+    txtSz += ln;
+    for ( j = 0; j < pCnt; j++ )
+    {
+      if ( trms[j] != NULL )
+                { idxs[j]++; }
+    }
+  }
+  BS_DO_E_OUTE (s_pad (pFl, 8))
+  //terms with the last one that holds sections ends:
+  s_put (pHd + S_HD_TRMSSZ, rdsSz / BDI_FTI_TRMRD_SZ, 8);
+  s_put (rd + S_TR_PST, ftell (pFl) - pstsOfst, 8);
+  s_put (rd + S_TR_TXT, txtSz, 8);
+  s_put (rd + S_TR_DF, 0, 4);
+  s_put (rd + S_TR_SKP, 0, 4);
+  s_put (pHd + S_HD_TRMSOFST, ftell (pFl), 8);
+  if ( rdsSz > 0 )
+        { BS_IF_EN_OUTE (fwrite (rds, 1, rdsSz, pFl) != rdsSz, BSE_WRITE_FILE) }
+  BS_IF_EN_OUTE (fwrite (rd, BDI_FTI_TRMRD_SZ, 1, pFl) != 1, BSE_WRITE_FILE)
+  s_put (pHd + S_HD_TXTOFST, ftell (pFl), 8);
+  if ( txtSz > 0 )
+        { BS_IF_EN_OUTE (fwrite (txt, 1, txtSz, pFl) != txtSz, BSE_WRITE_FILE) }
+  BS_DO_E_OUTE (s_pad (pFl, 8))
+  s_put (pHd + S_HD_FLSZ, ftell (pFl), 8);
+  BSLOG_LOG (BSLINFO, "FTI documents=%u, headwords=%u, terms=%zu, postings=%ld, file size=%ld\n", docsSz, docs[docsSz], rdsSz / BDI_FTI_TRMRD_SZ, (long) s_get (rd + S_TR_PST, 8), ftell (pFl))
+
+oute:
+  free (stts);
+  free (docs);
+  free (dws);
+  free (buf);
+  free (rds);
+  free (txt);
+}
+
+/**
+ * <p>Make FTI head without sections.</p>
+ * @param pDiIx - IDX in file
+ * @param pHd - buffer BDI_FTI_HEADSZ to fill
+ * @set errno if error.
+ **/
+static void
+  s_mk_head (BsDiIxTx *pDiIx, unsigned char *pHd)
+{
+  int64_t idxSz, idxMtime;
+  BS_DO_E_RET (s_idx_stat (pDiIx, &idxSz, &idxMtime))
+  memset (pHd, 0, BDI_FTI_HEADSZ);
+  s_put (pHd + S_HD_MAGIC, BDI_FTI_MAGIC, 4);
+  s_put (pHd + S_HD_VER, BDI_FTI_VER, 4);
+  s_put (pHd + S_HD_IDXSZ, idxSz, 8);
+  s_put (pHd + S_HD_IDXMTIME, idxMtime, 8);
+}
+
+/**
+ * <p>Validate FTI head against IDX v1 and mapped size.</p>
+ * @param pDiIx - IDX in file
+ * @param pHd - FTI head
+ * @param pFlSz - FTI file size
+ * @return if FTI matches
+ * @set errno if error.
+ **/
+static bool
+  s_is_valid (BsDiIxTx *pDiIx, const unsigned char *pHd, int64_t pFlSz)
+{
+  unsigned char hd[BDI_FTI_HEADSZ];
+  BS_DO_E_RETF (s_mk_head (pDiIx, hd))
+  if ( memcmp (hd, pHd, S_HD_DOCSSZ) != 0
+    || (int64_t) s_get (pHd + S_HD_FLSZ, 8) != pFlSz )
+                { return false; }
+  for ( int i = S_HD_DOCSOFST; i < S_HD_FLSZ; i += 8 )
+  {
+    if ( (int64_t) s_get (pHd + i, 8) > pFlSz )
+                { return false; }
+  }
+  return true;
+}
+
+/**
+ * <p>Find term's record.</p>
+ * @param pFti - FTI
+ * @param pTrm - term
+ * @return index or -1 if absent
+ **/
+static BS_IDX_T
+  s_trm_find (BsDiIxFti *pFti, const char *pTrm)
+{
+  BS_IDX_T l = BS_IDX_0, r = pFti->trmsSz - 1, m;
+  int cmp;
+  while ( l <= r )
+  {
+    m = l + ( r - l ) / 2;
+    cmp = strcmp (pFti->trmsTxt + S_TR_TXTOF (pFti, m), pTrm);
+    if ( cmp == 0 )
+                { return m; }
+    if ( cmp < 0 )
+    {
+      l = m + 1;
+    } else {
+      r = m - 1;
+    }
+  }
+  return -1;
+}
+
+/**
+ * <p>Read cursor's next document.</p>
+ * @param pCur - cursor
+ **/
+static void
+  s_cur_next (BsDiIxFtiCur *pCur)
+{
+  uint32_t tf;
+  pCur->isCur = true;
+  if ( pCur->n == pCur->df )
+  {
+    pCur->doc = S_DOC_END;
+    return;
+  }
+  pCur->doc += s_vget (&pCur->cur);
+  pCur->tf = tf = s_vget (&pCur->cur);
+  pCur->poss = pCur->cur;
+  while ( tf-- > 0 )
+  {
+    while ( *pCur->cur & 0x80 )
+                { pCur->cur++; }
+    pCur->cur++;
+  }
+  pCur->n++;
+}
+
+/**
+ * <p>Move cursor to the first document that is greater or equal
+ * to given one, skips are used to pass blocks of documents.</p>
+ * @param pCur - cursor
+ * @param pTgt - target document
+ **/
+static void
+  s_cur_adv (BsDiIxFtiCur *pCur, uint32_t pTgt)
+{
+  if ( pCur->isCur && pCur->doc >= pTgt )
+                { return; }
+  while ( pCur->skpIdx < pCur->skpsSz && pCur->skps[2 * pCur->skpIdx] < pTgt )
+  {
+    uint32_t n = ( pCur->skpIdx + 1 ) * BDI_FTI_SKIP;
+    if ( n >= pCur->n )
+    { //the skip's previous document is less than target:
+      pCur->n = n;
+      pCur->doc = pCur->skps[2 * pCur->skpIdx];
+      pCur->cur = pCur->bgn + pCur->skps[2 * pCur->skpIdx + 1];
+      pCur->isCur = false;
+    }
+    pCur->skpIdx++;
+  }
+  while ( !pCur->isCur || pCur->doc < pTgt )
+                { s_cur_next (pCur); }
+}
+
+/**
+ * <p>Check if current documents positions have query's terms in a row.</p>
+ * @param pCurs - cursors on the same document
+ * @param pCnt - cursors count
+ * @return if it's phrase
+ * @set errno if error.
+ **/
+static bool
+  s_is_phr (BsDiIxFtiCur *pCurs, int pCnt)
+{
+  size_t tot = 0;
+  int i, a = 0;
+  uint32_t k, p, l, r, m, st, *poss, *ps[pCnt];
+  const unsigned char *c;
+  bool rz = false;
+  for ( i = 0; i < pCnt; i++ )
+  {
+    tot += pCurs[i].tf;
+    if ( pCurs[i].tf < pCurs[a].tf )
+                { a = i; }
+  }
+  poss = malloc (tot * sizeof (uint32_t));
+  if ( poss == NULL )
+  {
+    errno = ENOMEM;
+    BSLOG_ERR
+    return false;
+  }
+  for ( i = 0, tot = 0; i < pCnt; i++ )
+  {
+    ps[i] = poss + tot;
+    tot += pCurs[i].tf;
+    c = pCurs[i].poss;
+    for ( k = 0, p = 0; k < pCurs[i].tf; k++ )
+    {
+      p += s_vget (&c);
+      ps[i][k] = p;
+    }
+  }
+  for ( k = 0; k < pCurs[a].tf && !rz; k++ )
+  {
+    if ( ps[a][k] < (uint32_t) pCurs[a].qPos )
+                { continue; }
+    st = ps[a][k] - pCurs[a].qPos;
+    rz = true;
+    for ( i = 0; i < pCnt && rz; i++ )
+    {
+      if ( i == a )
+                { continue; }
+      p = st + pCurs[i].qPos;
+      for ( l = 0, r = pCurs[i].tf; l < r; )
+      {
+        m = l + ( r - l ) / 2;
+        if ( ps[i][m] < p )
+        {
+          l = m + 1;
+        } else {
+          r = m;
+        }
+      }
+      rz = l < pCurs[i].tf && ps[i][l] == p;
+    }
+  }
+  free (poss);
+  return rz;
+}
+
+//public lib:
+/**
+ * <p>Save (write/overwrite) FTI of given dictionary and its IDX v1 in file.
+ * It's written into temporary file that replaces old one.</p>
+ * @param pDiIx - IDX in file with opened dictionary
+ * @param pPth - dictionary path
+ * @param pThrdCnt - worker threads count, 1 or less means in current thread
+ * @set errno if error.
+ **/
+void
+  bsdiixfti_save (BsDiIxTx *pDiIx, char *pPth, int pThrdCnt)
+{
+  //vars:
+  FILE *fl = NULL;
+  BsDicDslMm *dslMm = NULL;
+  unsigned char hd[BDI_FTI_HEADSZ];
+  int ln = strlen (pPth), i, cnt;
+  char pth[ln + 10], tmpPth[ln + 14];
+  BS_FOFST_T stt, end;
+  //code:
+  if ( pThrdCnt < 1 )
+                { pThrdCnt = 1; }
+  if ( pThrdCnt > BSDICIWRDSMT_MAX_THRDS )
+                { pThrdCnt = BSDICIWRDSMT_MAX_THRDS; }
+  BsDiIxFtiShrd shrds[pThrdCnt];
+  for ( i = 0; i < pThrdCnt; i++ )
+  {
+    shrds[i].arena = NULL; shrds[i].trms = NULL; shrds[i].tkns = NULL;
+    shrds[i].docs = NULL; shrds[i].trmsSz = 0;
+  }
+  cnt = 0;
+  strcpy (pth, pPth);
+  strcat (pth, BDI_FTI_FILE_EXT);
+  strcpy (tmpPth, pth);
+  strcat (tmpPth, ".tmp");
+  BS_DO_E_OUTE (s_mk_head (pDiIx, hd))
+  BS_DO_E_OUTE (dslMm = bsdicdslmm_new (pDiIx->dicFl))
+  //1. split by articles:
+  BS_DO_E_OUTE (stt = bsdicdslmm_find_art (dslMm, BS_DIC_ENTRY_BUFFER_SIZE, BS_FOFST_0))
+  for ( cnt = 0; cnt < pThrdCnt; cnt++ )
+  {
+    if ( cnt == pThrdCnt - 1 )
+    {
+      end = dslMm->sz;
+    } else {
+      BS_DO_E_OUTE (end = bsdicdslmm_find_art (dslMm, BS_DIC_ENTRY_BUFFER_SIZE,
+                  stt + ( dslMm->sz - stt ) / ( pThrdCnt - cnt )))
+    }
+    shrds[cnt].dt = dslMm->dt; shrds[cnt].stt = stt; shrds[cnt].end = end;
+    shrds[cnt].hasApo = bsdicidxab_wchar_to_ichar (pDiIx->head->ab, L'\'') != 0;
+    shrds[cnt].hasHyp = bsdicidxab_wchar_to_ichar (pDiIx->head->ab, L'-') != 0;
+    shrds[cnt].trmsBsz = S_HSH_INITSZ; shrds[cnt].trmsSz = 0;
+    shrds[cnt].tknsBsz = S_TKNS_INITSZ; shrds[cnt].tknsSz = 0;
+    shrds[cnt].docsBsz = S_DOCS_INITSZ; shrds[cnt].docsSz = 0;
+    shrds[cnt].arena = bsarena_new (S_ARENA_BLKSZ);
+    shrds[cnt].trms = calloc (S_HSH_INITSZ, sizeof (BsDiIxFtiTrm*));
+    shrds[cnt].tkns = malloc (S_TKNS_INITSZ * sizeof (BsDiIxFtiTkn));
+    shrds[cnt].docs = malloc (S_DOCS_INITSZ * BS_FOFST_LEN);
+    if ( shrds[cnt].arena == NULL || shrds[cnt].trms == NULL
+      || shrds[cnt].tkns == NULL || shrds[cnt].docs == NULL )
+    {
+      cnt++;
+      errno = ENOMEM;
+      goto oute;
+    }
+    stt = end;
+  }
+  //2. tokenizing:
+  if ( cnt == 1 )
+  {
+    s_wrk_tknz (&shrds[0]);
+    errno = shrds[0].err;
+  } else {
+    s_run_wrks (shrds, cnt, s_wrk_tknz);
+  }
+  if ( errno != 0 )
+                { goto oute; }
+  //3. merging into file:
+  fl = fopen (tmpPth, "wb");
+  BS_IF_EN_OUTE (fl == NULL, BSE_OPEN_FILE)
+  BS_IF_EN_OUTE (fwrite (hd, BDI_FTI_HEADSZ, 1, fl) != 1, BSE_WRITE_FILE)
+  BS_DO_E_OUTE (s_write (pDiIx, shrds, cnt, fl, hd))
+  BS_DO_E_OUTE (bsfseek_goto (fl, 0L))
+  BS_IF_EN_OUTE (fwrite (hd, BDI_FTI_HEADSZ, 1, fl) != 1, BSE_WRITE_FILE)
+  BS_IF_EN_OUTE (fclose (fl) != 0, BSE_WRITE_FILE)
+  fl = NULL;
+  BS_IF_EN_OUTE (rename (tmpPth, pth) != 0, BSE_WRITE_FILE)
+  BSLOG_LOG (BSLINFO, "FTI has been saved %s by %d threads\n", pth, cnt)
+
+oute:
+  for ( i = 0; i < cnt; i++ )
+  {
+    if ( shrds[i].trms != NULL )
+    {
+      for ( uint32_t j = 0; j < shrds[i].trmsBsz; j++ )
+      {
+        if ( shrds[i].trms[j] != NULL && shrds[i].trms[j]->pst != NULL )
+                { free (shrds[i].trms[j]->pst); }
+      }
+      free (shrds[i].trms);
+    }
+    free (shrds[i].tkns);
+    free (shrds[i].docs);
+    bsarena_free (shrds[i].arena);
+  }
+  bsdicdslmm_free (dslMm);
+  if ( fl != NULL )
+  {
+    fclose (fl);
+    remove (tmpPth);
+  }
+}
+
+/**
+ * <p>Map FTI that matches given IDX v1 in file.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @return object or NULL if error or FTI is absent or stale
+ * @set errno if error. Absent or stale FTI is not error!
+ **/
+BsDiIxFti*
+  bsdiixfti_load (BsDiIxTx *pDiIx, char *pPth)
+{
+  //vars:
+  BsDiIxFti *obj;
+  struct stat st;
+  bool isVld;
+  int fd;
+  const unsigned char *hd;
+  char pth[strlen (pPth) + 10];
+  //code:
+  if ( !s_is_le () )
+                { return NULL; }
+  strcpy (pth, pPth);
+  strcat (pth, BDI_FTI_FILE_EXT);
+  fd = open (pth, O_RDONLY);
+  if ( fd == -1 )
+  {
+    errno = 0;
+    return NULL;
+  }
+  obj = NULL;
+  BS_IF_EN_OUTE (fstat (fd, &st) != 0, BSE_READ_FILE)
+  if ( st.st_size < BDI_FTI_HEADSZ )
+                { goto out; }
+  obj = malloc (sizeof (BsDiIxFti));
+  BS_IF_EN_OUTE (obj == NULL, ENOMEM)
+  obj->sz = st.st_size;
+  obj->dt = mmap (NULL, obj->sz, PROT_READ, MAP_SHARED, fd, 0);
+  if ( obj->dt == MAP_FAILED )
+  {
+    obj->dt = NULL;
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_LOG (BSLERROR, "Can't map file %s size=%zu\n", pth, obj->sz)
+    goto oute;
+  }
+  hd = obj->dt;
+  BS_DO_E_OUTE (isVld = s_is_valid (pDiIx, hd, obj->sz))
+  if ( !isVld )
+  {
+    BSLOG_LOG (BSLINFO, "FTI is stale %s\n", pth)
+    goto out;
+  }
+  obj->docsSz = s_get (hd + S_HD_DOCSSZ, 8);
+  obj->trmsSz = s_get (hd + S_HD_TRMSSZ, 8);
+  obj->docs = (const uint32_t*) ((const char*) obj->dt + s_get (hd + S_HD_DOCSOFST, 8));
+  obj->docDws = (const uint32_t*) ((const char*) obj->dt + s_get (hd + S_HD_DOCDWSOFST, 8));
+  obj->trms = (const char*) obj->dt + s_get (hd + S_HD_TRMSOFST, 8);
+  obj->trmsTxt = (const char*) obj->dt + s_get (hd + S_HD_TXTOFST, 8);
+  obj->psts = (const char*) obj->dt + s_get (hd + S_HD_PSTSOFST, 8);
+  madvise (obj->dt, obj->sz, MADV_RANDOM);
+  close (fd);
+  return obj;
+
+out: //absent or stale
+  bsdiixfti_free (obj);
+  close (fd);
+  return NULL;
+
+oute:
+  bsdiixfti_free (obj);
+  close (fd);
+  return NULL;
+}
+
+/**
+ * <p>Map FTI, (re)make it first if it's absent or stale.</p>
+ * @param pDiIx - IDX in file with opened dictionary
+ * @param pPth - dictionary path
+ * @param pThrdCnt - worker threads count, 1 or less means in current thread
+ * @return object or NULL if error
+ * @set errno if error.
+ **/
+BsDiIxFti*
+  bsdiixfti_open (BsDiIxTx *pDiIx, char *pPth, int pThrdCnt)
+{
+  BsDiIxFti *obj;
+  BS_IF_EN_RETN (!s_is_le (), BSE_WRONG_PARAMS)
+  BS_DO_E_RETN (obj = bsdiixfti_load (pDiIx, pPth))
+  if ( obj != NULL )
+                { return obj; }
+  BS_DO_E_RETN (bsdiixfti_save (pDiIx, pPth, pThrdCnt))
+  BS_DO_E_RETN (obj = bsdiixfti_load (pDiIx, pPth))
+  return obj;
+}
+
+/**
+ * <p>Destructor, it unmaps file.</p>
+ * @param pFti - FTI or NULL
+ * @return always NULL
+ **/
+BsDiIxFti*
+  bsdiixfti_free (BsDiIxFti *pFti)
+{
+  if ( pFti != NULL )
+  {
+    if ( pFti->dt != NULL )
+          { munmap (pFti->dt, pFti->sz); }
+    free (pFti);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Find headwords of articles that contain all query's terms.
+ * Rarest term's postings lead, the rest ones are advanced by skips.
+ * Thread-safe.</p>
+ * @param pFti - FTI
+ * @param pAb - dictionary AB
+ * @param pQry - query, e.g. "mouth disease"
+ * @param pIsPhr - whether terms must be a phrase, i.e. in a row
+ * @param pIdxs - array to return DWOLT indexes of the first found articles
+ *   in dictionary order
+ * @param pIdxsMx - its size
+ * @return found DWOLT indexes total or -1 if error
+ * @set errno if error.
+ **/
+int
+  bsdiixfti_find (BsDiIxFti *pFti, BsDicIdxAb *pAb, char *pQry,
+                  bool pIsPhr, BS_IDX_T *pIdxs, int pIdxsMx)
+{
+  //vars:
+  BsDiIxFtiQry qry;
+  BS_IDX_T idx;
+  uint32_t tgt = 0, j;
+  int i, cnt = 0;
+  bool isPhr;
+  //code:
+  if ( pFti == NULL || pQry == NULL || pQry[0] == 0 || pIdxsMx <= 0 )
+  {
+    errno = BSE_WRONG_PARAMS;
+    BSLOG_ERR
+    return -1;
+  }
+  qry.sz = 0;
+  s_tknz ((unsigned char*) pQry, (unsigned char*) pQry + strlen (pQry),
+          bsdicidxab_wchar_to_ichar (pAb, L'\'') != 0,
+          bsdicidxab_wchar_to_ichar (pAb, L'-') != 0, s_qry_csm, &qry);
+  if ( qry.sz == 0 )
+                { return 0; }
+  BsDiIxFtiCur curs[qry.sz], cur;
+  for ( i = 0; i < qry.sz; i++ )
+  {
+    idx = s_trm_find (pFti, qry.trms[i]);
+    if ( idx == -1 )
+                { return 0; }
+    curs[i].skpsSz = S_TR_SKPS (pFti, idx);
+    curs[i].skps = (const uint32_t*) (pFti->psts + S_TR_PSTOF (pFti, idx));
+    curs[i].bgn = (const unsigned char*) (curs[i].skps + 2 * curs[i].skpsSz);
+    curs[i].cur = curs[i].bgn;
+    curs[i].df = S_TR_DFS (pFti, idx);
+    curs[i].skpIdx = curs[i].n = curs[i].doc = curs[i].tf = 0;
+    curs[i].isCur = false;
+    curs[i].qPos = i;
+  }
+  //the rarest term leads:
+  for ( i = 1; i < qry.sz; i++ )
+  {
+    cur = curs[i];
+    for ( j = i; j > 0 && curs[j - 1].df > cur.df; j-- )
+                { curs[j] = curs[j - 1]; }
+    curs[j] = cur;
+  }
+  while ( cnt < pIdxsMx )
+  {
+    s_cur_adv (&curs[0], tgt);
+    if ( curs[0].doc == S_DOC_END )
+                { break; }
+    tgt = curs[0].doc;
+    for ( i = 1; i < qry.sz; i++ )
+    {
+      s_cur_adv (&curs[i], tgt);
+      if ( curs[i].doc != tgt )
+                { break; }
+    }
+    if ( i < qry.sz )
+    {
+      if ( curs[i].doc == S_DOC_END )
+                { break; }
+      tgt = curs[i].doc;
+      continue;
+    }
+    if ( pIsPhr && qry.sz > 1 )
+    {
+      isPhr = s_is_phr (curs, qry.sz);
+      if ( errno != 0 )
+                { return -1; }
+      if ( !isPhr )
+      {
+        tgt++;
+        continue;
+      }
+    }
+    for ( j = pFti->docs[tgt]; j < pFti->docs[tgt + 1] && cnt < pIdxsMx; j++ )
+                { pIdxs[cnt++] = pFti->docDws[j]; }
+    tgt++;
+  }
+  return cnt;
+}
@@ -0,0 +1,138 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ full-text index (FTI) of DSL articles' content. It's
+ * optional mappable file beside IDX (dictionary path plus BDI_FTI_FILE_EXT),
+ * that is made from IDX v1 in file and mapped dictionary, and it's stale when
+ * IDX v1 is changed. Document is article, i.e. its headwords lines and content
+ * lines (started with TAB or space). Content is tokenized without DSL tags
+ * ([..]), comments ({{..}}) and media ([s]..[/s]), escaped chars are
+ * usual ones. Term is folded letters and digits, apostrophe or hyphen inside
+ * word is its part only if dictionary AB has it (as IDX does), so query
+ * is tokenized in the same way by the same AB. Term's postings are documents
+ * in dictionary order, each one with term's positions in it, they are delta
+ * and varint (7 bits per byte, the highest one means "more") coded, and
+ * every BDI_FTI_SKIP-th document is in term's skip table.
+ * Dictionary is split by articles into shards that are tokenized
+ * simultaneously, shard's postings are coded while streaming articles,
+ * then they are merged term by term into file.</p>
+ * <pre>
+ * head (BDI_FTI_HEADSZ bytes, all numbers are little-endian):
+ *   uint32 magic, uint32 version, int64 IDX v1 size, int64 IDX v1 mtime,
+ *   int64 docs total, int64 DWOLT size, int64 terms total,
+ *   int64 docs offset, int64 docs DWOLT offset, int64 terms offset,
+ *   int64 terms text offset, int64 postings offset, int64 file size
+ * docs: uint32 starts[docs total + 1] - in docs DWOLT
+ * docs DWOLT: uint32 DWOLT indexes of documents headwords
+ *   in documents order, then ascending, padding up to 8 bytes
+ * terms: {int64 postings offset, int64 text offset, uint32 docs total,
+ *   uint32 skips total}[terms total + 1] - ordered by text, the last
+ *   one holds sections ends
+ * terms text: UTF-8 terms each followed by 0, padding up to 8 bytes
+ * term's postings: {uint32 previous doc, uint32 offset}[skips total] -
+ *   the K-th skip is before document K * BDI_FTI_SKIP,
+ *   documents {varint doc delta, varint frequency,
+ *   varint position delta[frequency]}, padding up to 4 bytes
+ * </pre>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXFTI
+#define BS_DEBUGL_DIIXFTI 30690
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#include "BsDiIxTx.h"
+
+#define BDI_FTI_FILE_EXT ".fti"
+#define BDI_FTI_MAGIC 0x49544642U
+//2 - terms are folded by UCD simple case folding:
+#define BDI_FTI_VER 2
+#define BDI_FTI_HEADSZ 96
+#define BDI_FTI_TRMRD_SZ 24
+//documents per skip:
+#define BDI_FTI_SKIP 128
+//max term's bytes, longer one is cut:
+#define BDI_FTI_TRMMX 64
+//max query's terms, the rest ones are ignored:
+#define BDI_FTI_QRYMX 16
+
+/**
+ * <p>Mapped FTI.</p>
+ * @member void *dt - mapped file
+ * @member size_t sz - file size
+ * @member BS_IDX_T docsSz - documents total
+ * @member BS_IDX_T trmsSz - terms total
+ * @member const uint32_t *docs - documents starts in docs DWOLT
+ * @member const uint32_t *docDws - documents DWOLT indexes
+ * @member const char *trms - terms records
+ * @member const char *trmsTxt - terms text
+ * @member const char *psts - postings
+ **/
+typedef struct {
+  void *dt;
+  size_t sz;
+  BS_IDX_T docsSz;
+  BS_IDX_T trmsSz;
+  const uint32_t *docs;
+  const uint32_t *docDws;
+  const char *trms;
+  const char *trmsTxt;
+  const char *psts;
+} BsDiIxFti;
+
+/**
+ * <p>Save (write/overwrite) FTI of given dictionary and its IDX v1 in file.
+ * It's written into temporary file that replaces old one.</p>
+ * @param pDiIx - IDX in file with opened dictionary
+ * @param pPth - dictionary path
+ * @param pThrdCnt - worker threads count, 1 or less means in current thread
+ * @set errno if error.
+ **/
+void bsdiixfti_save (BsDiIxTx *pDiIx, char *pPth, int pThrdCnt);
+
+/**
+ * <p>Map FTI that matches given IDX v1 in file.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @return object or NULL if error or FTI is absent or stale
+ * @set errno if error. Absent or stale FTI is not error!
+ **/
+BsDiIxFti *bsdiixfti_load (BsDiIxTx *pDiIx, char *pPth);
+
+/**
+ * <p>Map FTI, (re)make it first if it's absent or stale.</p>
+ * @param pDiIx - IDX in file with opened dictionary
+ * @param pPth - dictionary path
+ * @param pThrdCnt - worker threads count, 1 or less means in current thread
+ * @return object or NULL if error
+ * @set errno if error.
+ **/
+BsDiIxFti *bsdiixfti_open (BsDiIxTx *pDiIx, char *pPth, int pThrdCnt);
+
+/**
+ * <p>Destructor, it unmaps file.</p>
+ * @param pFti - FTI or NULL
+ * @return always NULL
+ **/
+BsDiIxFti *bsdiixfti_free (BsDiIxFti *pFti);
+
+/**
+ * <p>Find headwords of articles that contain all query's terms.
+ * Thread-safe.</p>
+ * @param pFti - FTI
+ * @param pAb - dictionary AB
+ * @param pQry - query, e.g. "mouth disease"
+ * @param pIsPhr - whether terms must be a phrase, i.e. in a row
+ * @param pIdxs - array to return DWOLT indexes of the first found articles
+ *   in dictionary order
+ * @param pIdxsMx - its size
+ * @return found DWOLT indexes total or -1 if error
+ * @set errno if error.
+ **/
+int bsdiixfti_find (BsDiIxFti *pFti, BsDicIdxAb *pAb, char *pQry,
+                    bool pIsPhr, BS_IDX_T *pIdxs, int pIdxsMx);
+#endif
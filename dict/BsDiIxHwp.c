@@ -0,0 +1,405 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ IDX headwords pool (HWP).</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdlib.h"
+#include "string.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsStrings.h"
+#include "BsFioWrap.h"
+#include "BsUcFold.h"
+#include "BsDicWordDsl.h"
+#include "BsDiIxHwp.h"
+
+//local lib:
+/**
+ * <p>Write bytes into IDX file or HWP in memory.</p>
+ * @param pHwpMk - HWP maker
+ * @param pDt - bytes
+ * @param pSz - bytes count
+ * @set errno if error.
+ **/
+static void
+  s_put (BsDiIxHwpMk *pHwpMk, const void *pDt, size_t pSz)
+{
+  if ( pSz == 0 )
+                { return; }
+  if ( pHwpMk->idxFl != NULL )
+  {
+    BS_IF_EN_RET (fwrite (pDt, 1, pSz, pHwpMk->idxFl) != pSz, BSE_WRITE_FILE)
+    return;
+  }
+  size_t pos = pHwpMk->memSz;
+  if ( pos + pSz > pHwpMk->memBsz )
+  {
+    size_t bsz = pHwpMk->memBsz * 2;
+    if ( bsz < pos + pSz )
+                { bsz = pos + pSz; }
+    char *mem = realloc (pHwpMk->mem, bsz);
+    BS_IF_EN_RET (mem == NULL, ENOMEM)
+    pHwpMk->mem = mem;
+    pHwpMk->memBsz = bsz;
+  }
+  memcpy (pHwpMk->mem + pos, pDt, pSz);
+  pHwpMk->memSz = pos + pSz;
+}
+
+/**
+ * <p>Write zero padding.</p>
+ * @param pHwpMk - HWP maker
+ * @param pCnt - bytes count
+ * @set errno if error.
+ **/
+static void
+  s_pad (BsDiIxHwpMk *pHwpMk, int pCnt)
+{
+  char zrs[8] = { 0 };
+  if ( pCnt > 0 )
+        { s_put (pHwpMk, zrs, pCnt); }
+}
+
+/**
+ * <p>Read and check HWP head.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - HWP offset
+ * @param pCnt - DWOLT size
+ * @param pTblOfstRt - pointer to return records table offset
+ * @return if HWP is found
+ * @set errno if error.
+ **/
+static bool
+  s_head (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt, BS_FOFST_T *pTblOfstRt)
+{
+  struct stat st;
+  int mgc, zr;
+  BS_IDX_T cnt;
+  int fd = fileno (pIdxFl);
+  if ( fd == -1 || fstat (fd, &st) != 0 )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return false;
+  }
+  if ( pOfst + BDI_HWP_HEADSZ > st.st_size )
+                { return false; }
+  BS_DO_E_RETF (bsfseek_goto (pIdxFl, pOfst))
+  if ( fread (&mgc, sizeof (int), 1, pIdxFl) != 1
+        || fread (&zr, sizeof (int), 1, pIdxFl) != 1
+          || fread (&cnt, BS_IDX_LEN, 1, pIdxFl) != 1
+            || fread (pTblOfstRt, BS_FOFST_LEN, 1, pIdxFl) != 1 )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return false;
+  }
+  return ( mgc == BDI_HWP_MAGIC || mgc == BDI_HWP_MAGIC1 ) && cnt == pCnt
+    && *pTblOfstRt >= BDI_HWP_HEADSZ
+      && pOfst + *pTblOfstRt + pCnt * BS_FOFST_LEN <= st.st_size;
+}
+
+/**
+ * <p>Constructor that writes HWP head.</p>
+ * @param pIdxFl - IDX file positioned just after DWOLT or NULL
+ * @param pDicFl - dictionary or NULL
+ * @param pAb - alphabet
+ * @param pCnt - DWOLT size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+static BsDiIxHwpMk*
+  s_new (FILE *pIdxFl, FILE *pDicFl, BsDicIdxAb *pAb, BS_IDX_T pCnt)
+{
+  int mgc = BDI_HWP_MAGIC, zr = 0;
+  BS_FOFST_T tblOfst = BS_FOFST_NULL;
+  BsDiIxHwpMk *obj = calloc (1, sizeof (BsDiIxHwpMk));
+  BS_IF_EN_RETN (obj == NULL, ENOMEM)
+  obj->ofsts = malloc ((pCnt > BS_IDX_0 ? pCnt : BS_IDX_1) * BS_FOFST_LEN);
+  if ( obj->ofsts == NULL )
+  {
+    free (obj);
+    errno = ENOMEM;
+    BSLOG_ERR
+    return NULL;
+  }
+  obj->idxFl = pIdxFl; obj->dicFl = pDicFl; obj->ab = pAb;
+  obj->cnt = pCnt; obj->sz = BS_IDX_0;
+  obj->stt = pIdxFl == NULL ? BS_FOFST_0 : ftell (pIdxFl);
+  obj->pos = BDI_HWP_HEADSZ;
+  BS_DO_E_OUTE (s_put (obj, &mgc, sizeof (int)))
+  BS_DO_E_OUTE (s_put (obj, &zr, sizeof (int)))
+  BS_DO_E_OUTE (s_put (obj, &pCnt, BS_IDX_LEN))
+  BS_DO_E_OUTE (s_put (obj, &tblOfst, BS_FOFST_LEN))
+  return obj;
+
+oute:
+  return bsdiixhwpmk_free (obj);
+}
+
+//public lib:
+/**
+ * <p>Constructor that writes HWP head at IDX file current position.</p>
+ * @param pIdxFl - IDX file positioned just after DWOLT
+ * @param pDicFl - dictionary
+ * @param pAb - alphabet
+ * @param pCnt - DWOLT size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxHwpMk*
+  bsdiixhwpmk_new (FILE *pIdxFl, FILE *pDicFl, BsDicIdxAb *pAb, BS_IDX_T pCnt)
+{
+  return s_new (pIdxFl, pDicFl, pAb, pCnt);
+}
+
+/**
+ * <p>Constructor of maker in memory, e.g. to update IDX.</p>
+ * @param pAb - alphabet
+ * @param pCnt - DWOLT size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxHwpMk*
+  bsdiixhwpmk_new_mem (BsDicIdxAb *pAb, BS_IDX_T pCnt)
+{
+  return s_new (NULL, NULL, pAb, pCnt);
+}
+
+/**
+ * <p>Read, normalize and write next (in DWOLT order) headword.</p>
+ * @param pHwpMk - HWP maker with dictionary
+ * @param pOfst - headword offset in dictionary
+ * @param pLen - headword length in dictionary
+ * @set errno if error.
+ **/
+void
+  bsdiixhwpmk_add (BsDiIxHwpMk *pHwpMk, BS_FOFST_T pOfst, BS_SMALL_T pLen)
+{
+  char bts[pLen + 1];
+  BS_DO_E_RET (bsfseek_goto (pHwpMk->dicFl, pOfst))
+  BS_DO_E_RET (bsfread_chars (bts, pLen, pHwpMk->dicFl))
+  bsdiixhwpmk_add_bts (pHwpMk, bts, pLen, pOfst);
+}
+
+/**
+ * <p>Normalize and write next (in DWOLT order) headword from its bytes,
+ * e.g. from mapped dictionary.</p>
+ * @param pHwpMk - HWP maker
+ * @param pBts - headword's bytes
+ * @param pLen - headword length in dictionary
+ * @param pOfst - headword offset in dictionary to log
+ * @set errno if error.
+ **/
+void
+  bsdiixhwpmk_add_bts (BsDiIxHwpMk *pHwpMk, const char *pBts,
+                       BS_SMALL_T pLen, BS_FOFST_T pOfst)
+{
+  BS_IF_EN_RET (pHwpMk->sz >= pHwpMk->cnt, BSE_ARR_OUT_MAX_SIZE)
+  int wsz = pLen + 1;
+  char wrd[wsz + 7];
+  BS_WCHAR_T wstr[wsz];
+  BS_CHAR_T istr[wsz];
+  BS_SMALL_T mbsLen, istrLen;
+  //i.string is made as i.word is:
+  BS_DO_E_RET (bsdicdslmm_dec_hw (pBts, pLen, wstr))
+  bsdicidxab_wstr_to_istr (wstr, istr, pHwpMk->ab);
+  istrLen = bsdicidx_istr_len (istr);
+  //multibyte one to show:
+  memcpy (wrd, pBts, pLen);
+  wrd[pLen] = 0;
+  bsstring_escape_bslash (wrd);
+  bsstring_escape_bounds_spaces (wrd);
+  mbsLen = 0;
+  int rz = mbstowcs (wstr, wrd, wsz);
+  if ( rz > 0 && errno == 0 )
+  {
+    bsucfold_wstr (wstr);
+    rz = wcstombs (wrd, wstr, wsz + 7);
+    if ( rz > 0 && errno == 0 )
+                { mbsLen = rz; }
+  }
+  if ( mbsLen == 0 )
+  { //it's left for reading from dictionary:
+    BSLOG_LOG (BSLWARN, "Can't normalize headword at "BS_FOFST_FMT"\n", pOfst)
+    errno = 0;
+    wrd[0] = 0;
+  }
+  int mbsSz = ( mbsLen + 2 ) & ~1;
+  pHwpMk->ofsts[pHwpMk->sz++] = pHwpMk->pos;
+  BS_DO_E_RET (s_put (pHwpMk, &mbsLen, BS_SMALL_LEN))
+  BS_DO_E_RET (s_put (pHwpMk, &istrLen, BS_SMALL_LEN))
+  BS_DO_E_RET (s_put (pHwpMk, wrd, mbsLen + 1))
+  BS_DO_E_RET (s_pad (pHwpMk, mbsSz - mbsLen - 1))
+  BS_DO_E_RET (s_put (pHwpMk, istr, ( istrLen + 1 ) * BS_CHAR_LEN))
+  pHwpMk->pos += 2 * BS_SMALL_LEN + mbsSz + ( istrLen + 1 ) * BS_CHAR_LEN;
+}
+
+/**
+ * <p>Write next (in DWOLT order) record as is, e.g. kept one of
+ * updated IDX.</p>
+ * @param pHwpMk - HWP maker
+ * @param pRd - record of current HWP
+ * @set errno if error.
+ **/
+void
+  bsdiixhwpmk_add_rd (BsDiIxHwpMk *pHwpMk, const char *pRd)
+{
+  BS_IF_EN_RET (pHwpMk->sz >= pHwpMk->cnt, BSE_ARR_OUT_MAX_SIZE)
+  BS_SMALL_T istrLen = ((const BS_SMALL_T*) pRd)[1];
+  size_t sz = (const char*) BDI_HWP_ISTR (pRd) - pRd + ( istrLen + 1 ) * BS_CHAR_LEN;
+  pHwpMk->ofsts[pHwpMk->sz++] = pHwpMk->pos;
+  BS_DO_E_RET (s_put (pHwpMk, pRd, sz))
+  pHwpMk->pos += sz;
+}
+
+/**
+ * <p>Write records table and finish HWP.
+ * IDX file is positioned at HWP end.</p>
+ * @param pHwpMk - HWP maker with all DWOLT headwords
+ * @set errno if error.
+ **/
+void
+  bsdiixhwpmk_end (BsDiIxHwpMk *pHwpMk)
+{
+  if ( pHwpMk->sz != pHwpMk->cnt )
+  {
+    errno = BSE_ALG_ERR;
+    BSLOG_LOG (BSLERROR, "HWP size="BS_IDX_FMT", must be "BS_IDX_FMT"\n", pHwpMk->sz, pHwpMk->cnt)
+    return;
+  }
+  BS_FOFST_T tblOfst = ( pHwpMk->pos + 7 ) & ~7L;
+  BS_DO_E_RET (s_pad (pHwpMk, tblOfst - pHwpMk->pos))
+  BS_DO_E_RET (s_put (pHwpMk, pHwpMk->ofsts, pHwpMk->cnt * BS_FOFST_LEN))
+  if ( pHwpMk->idxFl == NULL )
+  {
+    memcpy (pHwpMk->mem + BDI_HWP_TBL_OFST, &tblOfst, BS_FOFST_LEN);
+    return;
+  }
+  BS_FOFST_T end = ftell (pHwpMk->idxFl);
+  BS_DO_E_RET (bsfseek_goto (pHwpMk->idxFl, pHwpMk->stt + BDI_HWP_TBL_OFST))
+  BS_DO_E_RET (bsfwrite_bsfoffset (&tblOfst, pHwpMk->idxFl))
+  BS_DO_E_RET (bsfseek_goto (pHwpMk->idxFl, end))
+}
+
+/**
+ * <p>Finish HWP in memory and hand it over to client.</p>
+ * @param pHwpMk - HWP maker in memory with all DWOLT headwords
+ * @return HWP or NULL when error
+ * @set errno if error.
+ **/
+char*
+  bsdiixhwpmk_end_mem (BsDiIxHwpMk *pHwpMk)
+{
+  BS_DO_E_RETN (bsdiixhwpmk_end (pHwpMk))
+  char *hwp = pHwpMk->mem;
+  pHwpMk->mem = NULL;
+  return hwp;
+}
+
+/**
+ * <p>Destructor.</p>
+ * @param pHwpMk - HWP maker or NULL
+ * @return always NULL
+ **/
+BsDiIxHwpMk*
+  bsdiixhwpmk_free (BsDiIxHwpMk *pHwpMk)
+{
+  if ( pHwpMk != NULL )
+  {
+    if ( pHwpMk->ofsts != NULL )
+          { free (pHwpMk->ofsts); }
+    if ( pHwpMk->mem != NULL )
+          { free (pHwpMk->mem); }
+    free (pHwpMk);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Reveal size of HWP in memory.</p>
+ * @param pHwp - HWP
+ * @param pCnt - DWOLT size
+ * @return HWP size
+ **/
+BS_FOFST_T
+  bsdiixhwp_mem_size (const char *pHwp, BS_IDX_T pCnt)
+{
+  return *(const BS_FOFST_T*) (pHwp + BDI_HWP_TBL_OFST) + pCnt * BS_FOFST_LEN;
+}
+
+/**
+ * <p>Check if HWP's i.strings are DWOLT's i.words, i.e. it isn't HWP1.</p>
+ * @param pHwp - HWP
+ * @return if it's current HWP
+ **/
+bool
+  bsdiixhwp_is_exact (const char *pHwp)
+{
+  return *(const int*) pHwp == BDI_HWP_MAGIC;
+}
+
+/**
+ * <p>Reveal HWP size in IDX file. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - HWP offset, i.e. DWOLT end
+ * @param pCnt - DWOLT size
+ * @return HWP size or 0 if IDX file without HWP
+ * @set errno if error. "HWP not found" is not error!
+ **/
+BS_FOFST_T
+  bsdiixhwp_size (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt)
+{
+  BS_FOFST_T tblOfst, rz = BS_FOFST_0;
+  long pos = ftell (pIdxFl);
+  BS_DO_E_OUT (bool isHwp = s_head (pIdxFl, pOfst, pCnt, &tblOfst))
+  if ( isHwp )
+        { rz = tblOfst + pCnt * BS_FOFST_LEN; }
+out:
+  fseek (pIdxFl, pos, SEEK_SET);
+  return rz;
+}
+
+/**
+ * <p>Load HWP from IDX file into memory. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - HWP offset, i.e. DWOLT end
+ * @param pCnt - DWOLT size
+ * @return HWP or NULL if error or IDX file without HWP
+ * @set errno if error. "HWP not found" is not error!
+ **/
+char*
+  bsdiixhwp_load (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt)
+{
+  char *hwp = NULL;
+  long pos = ftell (pIdxFl);
+  BS_DO_E_RETN (BS_FOFST_T sz = bsdiixhwp_size (pIdxFl, pOfst, pCnt))
+  if ( sz == BS_FOFST_0 )
+  {
+    BSLOG_LOG (BSLINFO, "IDX file without HWP\n")
+    return NULL;
+  }
+  hwp = malloc (sz);
+  BS_IF_EN_OUT (hwp == NULL, ENOMEM)
+  BS_DO_E_OUT (bsfseek_goto (pIdxFl, pOfst))
+  if ( fread (hwp, 1, sz, pIdxFl) != (size_t) sz )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+  }
+out:
+  if ( errno != 0 && hwp != NULL )
+  {
+    free (hwp);
+    hwp = NULL;
+  }
+  fseek (pIdxFl, pos, SEEK_SET);
+  return hwp;
+}
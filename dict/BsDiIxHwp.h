@@ -0,0 +1,191 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ IDX headwords pool (HWP) - optional IDX section just after
+ * DWOLT with normalized (unescaped and folded) headwords and their i.strings
+ * in DWOLT order. It's made once at index time, so matching candidates
+ * doesn't read and normalize headwords from dictionary.
+ * IDX without HWP (e.g. old one) is still valid, then headwords are read
+ * from dictionary.</p>
+ * <pre>
+ * section (native byte order, offsets are relative to section start):
+ *   int magic, int 0, BS_IDX_T cnt (=DWOLT size), BS_FOFST_T tblOfst,
+ *   records, each starts at even offset:
+ *     BS_SMALL_T mbsLen, BS_SMALL_T istrLen,
+ *     char mbs[mbsLen + 1] padded up to even size,
+ *     BS_CHAR_T istr[istrLen + 1]
+ *   padding up to 8 bytes, BS_FOFST_T tbl[cnt] - records offsets
+ * </pre>
+ * Record with mbsLen=0 means headword that can't be converted into locale's
+ * multibyte string, so it's still read from dictionary (and fails there
+ * as before). I.string is made from UTF-8 headword the same way as
+ * i.word is, so HWP also gives DWOLT's i.words to update IDX without
+ * reading kept headwords. HWP1 (with i.string of multibyte one) is still
+ * used for finding, but not for updating.
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXHWP
+#define BS_DEBUGL_DIIXHWP 30660
+
+#include "stdio.h"
+#include "stdbool.h"
+
+#include "BsDicIdxAb.h"
+
+//HWP section's first int, current and old one:
+#define BDI_HWP_MAGIC 0x32505748
+#define BDI_HWP_MAGIC1 0x31505748
+#define BDI_HWP_HEADSZ 24
+#define BDI_HWP_CNT_OFST 8
+#define BDI_HWP_TBL_OFST 16
+
+//record #pIdx of HWP pHwp (section start) and its fields:
+#define BDI_HWP_RD(pHwp, pIdx) ((const char*) (pHwp)\
+  + ((const BS_FOFST_T*) ((const char*) (pHwp)\
+    + *(const BS_FOFST_T*) ((const char*) (pHwp) + BDI_HWP_TBL_OFST)))[pIdx])
+#define BDI_HWP_MBSLEN(pRd) (((const BS_SMALL_T*) (pRd))[0])
+#define BDI_HWP_MBS(pRd) ((char*) (pRd) + 2 * BS_SMALL_LEN)
+#define BDI_HWP_ISTR(pRd) ((BS_CHAR_T*) (BDI_HWP_MBS (pRd)\
+  + ((BDI_HWP_MBSLEN (pRd) + 2) & ~1)))
+
+/**
+ * <p>HWP maker that streams records into IDX file or into memory.</p>
+ * @member FILE *idxFl - IDX file positioned at HWP start (DWOLT end)
+ *   or NULL to make HWP in memory
+ * @member FILE *dicFl - dictionary or NULL
+ * @member BsDicIdxAb *ab - alphabet
+ * @member BS_FOFST_T stt - HWP offset in IDX
+ * @member BS_FOFST_T pos - next record's offset in HWP
+ * @member BS_IDX_T cnt - records total (DWOLT size)
+ * @member BS_IDX_T sz - records added
+ * @member BS_FOFST_T *ofsts - records offsets
+ * @member char *mem - HWP in memory or NULL
+ * @member size_t memSz - its filled size
+ * @member size_t memBsz - its buffer size
+ **/
+typedef struct {
+  FILE *idxFl;
+  FILE *dicFl;
+  BsDicIdxAb *ab;
+  BS_FOFST_T stt;
+  BS_FOFST_T pos;
+  BS_IDX_T cnt;
+  BS_IDX_T sz;
+  BS_FOFST_T *ofsts;
+  char *mem;
+  size_t memSz;
+  size_t memBsz;
+} BsDiIxHwpMk;
+
+/**
+ * <p>Constructor that writes HWP head at IDX file current position.</p>
+ * @param pIdxFl - IDX file positioned just after DWOLT
+ * @param pDicFl - dictionary
+ * @param pAb - alphabet
+ * @param pCnt - DWOLT size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxHwpMk *bsdiixhwpmk_new (FILE *pIdxFl, FILE *pDicFl, BsDicIdxAb *pAb,
+                              BS_IDX_T pCnt);
+
+/**
+ * <p>Constructor of maker in memory, e.g. to update IDX.</p>
+ * @param pAb - alphabet
+ * @param pCnt - DWOLT size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxHwpMk *bsdiixhwpmk_new_mem (BsDicIdxAb *pAb, BS_IDX_T pCnt);
+
+/**
+ * <p>Read, normalize and write next (in DWOLT order) headword.</p>
+ * @param pHwpMk - HWP maker with dictionary
+ * @param pOfst - headword offset in dictionary
+ * @param pLen - headword length in dictionary
+ * @set errno if error.
+ **/
+void bsdiixhwpmk_add (BsDiIxHwpMk *pHwpMk, BS_FOFST_T pOfst, BS_SMALL_T pLen);
+
+/**
+ * <p>Normalize and write next (in DWOLT order) headword from its bytes,
+ * e.g. from mapped dictionary.</p>
+ * @param pHwpMk - HWP maker
+ * @param pBts - headword's bytes
+ * @param pLen - headword length in dictionary
+ * @param pOfst - headword offset in dictionary to log
+ * @set errno if error.
+ **/
+void bsdiixhwpmk_add_bts (BsDiIxHwpMk *pHwpMk, const char *pBts,
+                          BS_SMALL_T pLen, BS_FOFST_T pOfst);
+
+/**
+ * <p>Write next (in DWOLT order) record as is, e.g. kept one of
+ * updated IDX.</p>
+ * @param pHwpMk - HWP maker
+ * @param pRd - record of current HWP
+ * @set errno if error.
+ **/
+void bsdiixhwpmk_add_rd (BsDiIxHwpMk *pHwpMk, const char *pRd);
+
+/**
+ * <p>Write records table and finish HWP.
+ * IDX file is positioned at HWP end.</p>
+ * @param pHwpMk - HWP maker with all DWOLT headwords
+ * @set errno if error.
+ **/
+void bsdiixhwpmk_end (BsDiIxHwpMk *pHwpMk);
+
+/**
+ * <p>Finish HWP in memory and hand it over to client.</p>
+ * @param pHwpMk - HWP maker in memory with all DWOLT headwords
+ * @return HWP or NULL when error
+ * @set errno if error.
+ **/
+char *bsdiixhwpmk_end_mem (BsDiIxHwpMk *pHwpMk);
+
+/**
+ * <p>Destructor.</p>
+ * @param pHwpMk - HWP maker or NULL
+ * @return always NULL
+ **/
+BsDiIxHwpMk *bsdiixhwpmk_free (BsDiIxHwpMk *pHwpMk);
+
+/**
+ * <p>Reveal HWP size in IDX file. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - HWP offset, i.e. DWOLT end
+ * @param pCnt - DWOLT size
+ * @return HWP size or 0 if IDX file without HWP
+ * @set errno if error. "HWP not found" is not error!
+ **/
+BS_FOFST_T bsdiixhwp_size (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt);
+
+/**
+ * <p>Reveal size of HWP in memory.</p>
+ * @param pHwp - HWP
+ * @param pCnt - DWOLT size
+ * @return HWP size
+ **/
+BS_FOFST_T bsdiixhwp_mem_size (const char *pHwp, BS_IDX_T pCnt);
+
+/**
+ * <p>Check if HWP's i.strings are DWOLT's i.words, i.e. it isn't HWP1.</p>
+ * @param pHwp - HWP
+ * @return if it's current HWP
+ **/
+bool bsdiixhwp_is_exact (const char *pHwp);
+
+/**
+ * <p>Load HWP from IDX file into memory. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - HWP offset, i.e. DWOLT end
+ * @param pCnt - DWOLT size
+ * @return HWP or NULL if error or IDX file without HWP
+ * @set errno if error. "HWP not found" is not error!
+ **/
+char *bsdiixhwp_load (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt);
+#endif
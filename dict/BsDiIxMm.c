@@ -0,0 +1,523 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ IDX v2 - mappable image of IDX in file tables.</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "unistd.h"
+#include "fcntl.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsFioWrap.h"
+#include "BsDiIxMm.h"
+
+//head fields offsets:
+#define S_HD_MAGIC 0
+#define S_HD_VER 4
+#define S_HD_IDXSZ 8
+#define S_HD_IDXMTIME 16
+#define S_HD_IRTSZ 24
+#define S_HD_I2WPTSZ 32
+#define S_HD_DWOLTSZ 40
+#define S_HD_MXIRWDSZ 48
+#define S_HD_FLGS 52
+#define S_HD_IRTOFST 56
+#define S_HD_DWOFSOFST 64
+#define S_HD_DWLNSOFST 72
+#define S_HD_IDXIRTOFST 80
+//the last fields, they are known only when sections have been written:
+#define S_HD_SUMS 88
+#define S_HD_FLSZ 112
+
+#define S_ALIGN(pSz) (((pSz) + BDI_IDXMM_ALIGN - 1) / BDI_IDXMM_ALIGN * BDI_IDXMM_ALIGN)
+
+//local lib:
+/**
+ * <p>Put little-endian number into buffer.</p>
+ * @param pBuf - buffer
+ * @param pVal - number
+ * @param pLen - number's size in bytes
+ **/
+static void
+  s_put (unsigned char *pBuf, uint64_t pVal, int pLen)
+{
+  for ( int i = 0; i < pLen; i++ )
+  {
+    pBuf[i] = (unsigned char) (pVal & 0xFF);
+    pVal >>= 8;
+  }
+}
+
+/**
+ * <p>Get little-endian number from buffer.</p>
+ * @param pBuf - buffer
+ * @param pLen - number's size in bytes
+ * @return number
+ **/
+static uint64_t
+  s_get (const unsigned char *pBuf, int pLen)
+{
+  uint64_t rz = 0;
+  for ( int i = pLen - 1; i >= 0; i-- )
+        { rz = ( rz << 8 ) | pBuf[i]; }
+  return rz;
+}
+
+/**
+ * <p>Check if host is little-endian, i.e. mapped numbers are usable as is.</p>
+ * @return if little-endian
+ **/
+static bool
+  s_is_le (void)
+{
+  uint16_t one = 1;
+  return *((unsigned char*) &one) == 1;
+}
+
+/**
+ * <p>Check if IDX v2 is usable on this host with given IDX v1.</p>
+ * @param pDiIx - IDX in file
+ * @return if usable
+ **/
+static bool
+  s_is_usable (BsDiIxTx *pDiIx)
+{
+  return s_is_le () && BS_CHAR_LEN == 2
+    && ( pDiIx->head->flgs & BDI_TXFLG_ALGN );
+}
+
+/**
+ * <p>Read IDX v1 file size and modification time.</p>
+ * @param pDiIx - IDX in file
+ * @param pSzRt - pointer to return size
+ * @param pMtimeRt - pointer to return modification time in nanoseconds
+ * @set errno if error.
+ **/
+static void
+  s_idx_stat (BsDiIxTx *pDiIx, int64_t *pSzRt, int64_t *pMtimeRt)
+{
+  struct stat st;
+  int fd = fileno (pDiIx->idxFl);
+  BS_IF_EN_RET (fd == -1 || fstat (fd, &st) != 0, BSE_READ_FILE)
+  *pSzRt = st.st_size;
+  *pMtimeRt = st.st_mtim.tv_sec * 1000000000L + st.st_mtim.tv_nsec;
+}
+
+/**
+ * <p>Make IDX v2 head without sections checksums and file size.</p>
+ * @param pDiIx - IDX in file
+ * @param pHd - buffer BDI_IDXMM_HEADSZ to fill
+ * @set errno if error.
+ **/
+static void
+  s_mk_head (BsDiIxTx *pDiIx, unsigned char *pHd)
+{
+  int64_t idxSz, idxMtime;
+  BS_DO_E_RET (s_idx_stat (pDiIx, &idxSz, &idxMtime))
+  int flgs = pDiIx->head->flgs;
+  int64_t irtSz = pDiIx->head->irtSz;
+  int64_t irtOfst = BDI_IDXMM_HEADSZ;
+  int64_t dwOfsOfst = irtOfst + BDI_IDXMM_IRTRD_SZ * irtSz;
+  int64_t dwLnsOfst = dwOfsOfst + S_ALIGN (BDI_TX_OFSLEN (flgs) * (int64_t) pDiIx->head->dwoltSz);
+  memset (pHd, 0, BDI_IDXMM_HEADSZ);
+  s_put (pHd + S_HD_MAGIC, BDI_IDXMM_MAGIC, 4);
+  s_put (pHd + S_HD_VER, BDI_IDXMM_VER, 4);
+  s_put (pHd + S_HD_IDXSZ, idxSz, 8);
+  s_put (pHd + S_HD_IDXMTIME, idxMtime, 8);
+  s_put (pHd + S_HD_IRTSZ, irtSz, 8);
+  s_put (pHd + S_HD_I2WPTSZ, pDiIx->head->i2wptSz, 8);
+  s_put (pHd + S_HD_DWOLTSZ, pDiIx->head->dwoltSz, 8);
+  s_put (pHd + S_HD_MXIRWDSZ, pDiIx->head->mxIrWdSz, 4);
+  s_put (pHd + S_HD_FLGS, flgs, 4);
+  s_put (pHd + S_HD_IRTOFST, irtOfst, 8);
+  s_put (pHd + S_HD_DWOFSOFST, dwOfsOfst, 8);
+  s_put (pHd + S_HD_DWLNSOFST, dwLnsOfst, 8);
+  s_put (pHd + S_HD_IDXIRTOFST, pDiIx->irtOfst, 8);
+}
+
+/**
+ * <p>Write section padded up to alignment, and put its checksum
+ * into head.</p>
+ * @param pFl - IDX v2 file
+ * @param pSct - section with zeroed room for padding
+ * @param pSz - section's size without padding
+ * @param pHd - IDX v2 head
+ * @param pIdx - section's index
+ * @set errno if error.
+ **/
+static void
+  s_write_sct (FILE *pFl, const unsigned char *pSct, int64_t pSz,
+               unsigned char *pHd, int pIdx)
+{
+  int64_t sz = S_ALIGN (pSz);
+  s_put (pHd + S_HD_SUMS + 8 * pIdx,
+         bsdiixsum_hash (BDI_SUM_HASH0, (const char*) pSct, sz), 8);
+  if ( sz > 0 )
+        { BS_IF_EN_RET (fwrite (pSct, sz, 1, pFl) != 1, BSE_WRITE_FILE) }
+}
+
+/**
+ * <p>Write IDX v1 IRT numbers and DWOLT into IDX v2 file just after head.</p>
+ * @param pDiIx - IDX in file
+ * @param pFl - IDX v2 file
+ * @param pHd - IDX v2 head to put sections checksums and file size
+ * @set errno if error.
+ **/
+static void
+  s_write_tbls (BsDiIxTx *pDiIx, FILE *pFl, unsigned char *pHd)
+{
+  //vars:
+  int flgs, wdt;
+  BS_IDX_T l, idx, irtSz, dwoltSz;
+  BS_SMALL_T sml;
+  BS_FOFST_T ofst;
+  unsigned char *rds, *rd, *ofs, *lns;
+  BS_CHAR_T wrd[pDiIx->head->mxIrWdSz];
+  //init:
+  flgs = pDiIx->head->flgs;
+  irtSz = pDiIx->head->irtSz;
+  dwoltSz = pDiIx->head->dwoltSz;
+  wdt = BDI_TX_OFSLEN (flgs);
+  ofs = NULL; lns = NULL;
+  //sections are zeroed with room for padding:
+  rds = calloc (irtSz + 1, BDI_IDXMM_IRTRD_SZ);
+  BS_IF_EN_RET (rds == NULL, ENOMEM)
+  ofs = calloc (wdt * dwoltSz + BDI_IDXMM_ALIGN, 1);
+  BS_IF_EN_OUT (ofs == NULL, ENOMEM)
+  lns = calloc (2 * dwoltSz + BDI_IDXMM_ALIGN, 1);
+  BS_IF_EN_OUT (lns == NULL, ENOMEM)
+  //code:
+  BS_DO_E_OUT (bsfseek_goto (pDiIx->idxFl, pDiIx->irtOfst))
+  for ( l = BS_IDX_0; l < irtSz; l++ )
+  {
+    //words are read from mapped IDX v1:
+    BS_DO_E_OUT (bsfread_bschars (wrd, pDiIx->head->mxIrWdSz, pDiIx->idxFl))
+    rd = rds + l * BDI_IDXMM_IRTRD_SZ;
+    BS_DO_E_OUT (bsdiixtx_read_idx (&idx, flgs, pDiIx->idxFl))
+    s_put (rd + BDI_IDXMM_IRT_DWST, idx, 8);
+    BS_DO_E_OUT (bsfread_bssmall (&sml, pDiIx->idxFl))
+    s_put (rd + BDI_IDXMM_IRT_I2QN, sml, 2);
+    BS_DO_E_OUT (bsdiixtx_read_idx (&idx, flgs, pDiIx->idxFl))
+    s_put (rd + BDI_IDXMM_IRT_I2ST, idx, 8);
+  }
+  //DWOLT is split into offsets and lengths arrays:
+  BS_DO_E_OUT (bsfseek_goto (pDiIx->idxFl, pDiIx->dwoltOfst))
+  for ( l = BS_IDX_0; l < dwoltSz; l++ )
+  {
+    BS_DO_E_OUT (bsdiixtx_read_ofst (&ofst, flgs, pDiIx->idxFl))
+    BS_DO_E_OUT (bsfread_bssmall (&sml, pDiIx->idxFl))
+    s_put (ofs + wdt * l, ofst, wdt);
+    s_put (lns + 2 * l, sml, 2);
+  }
+  BS_DO_E_OUT (s_write_sct (pFl, rds, BDI_IDXMM_IRTRD_SZ * irtSz, pHd, 0))
+  BS_DO_E_OUT (s_write_sct (pFl, ofs, wdt * dwoltSz, pHd, 1))
+  BS_DO_E_OUT (s_write_sct (pFl, lns, 2 * dwoltSz, pHd, 2))
+  s_put (pHd + S_HD_FLSZ, s_get (pHd + S_HD_DWLNSOFST, 8) + S_ALIGN (2 * dwoltSz), 8);
+
+out:
+  free (rds);
+  if ( ofs != NULL )
+        { free (ofs); }
+  if ( lns != NULL )
+        { free (lns); }
+}
+
+/**
+ * <p>Validate IDX v2 head against IDX v1 and mapped size.</p>
+ * @param pDiIx - IDX in file
+ * @param pHd - IDX v2 head
+ * @param pFlSz - IDX v2 file size
+ * @return if IDX v2 matches
+ * @set errno if error.
+ **/
+static bool
+  s_is_valid (BsDiIxTx *pDiIx, const unsigned char *pHd, int64_t pFlSz)
+{
+  unsigned char hd[BDI_IDXMM_HEADSZ];
+  BS_DO_E_RETF (s_mk_head (pDiIx, hd))
+  //the same IDX v1 gives the same head without checksums:
+  return memcmp (hd, pHd, S_HD_SUMS) == 0
+    && (int64_t) s_get (pHd + S_HD_FLSZ, 8) == pFlSz;
+}
+
+/**
+ * <p>Validate IRT records, i.e. their DWOLT start and I2WPT range
+ * are within DWOLT and I2WPT, so lookup never goes out of mapped tables.</p>
+ * @param pMm - mapped IDX v2 with IRT
+ * @param pDiIx - IDX in file
+ * @return if IRT records are valid
+ **/
+static bool
+  s_is_irt_valid (BsDiIxMm *pMm, BsDiIxTx *pDiIx)
+{
+  BS_IDX_T dwSt, i2St, i2Qn;
+  for ( BS_IDX_T l = BS_IDX_0; l < pMm->irtSz; l++ )
+  {
+    dwSt = BDI_IDXMM_DWST (pMm, l);
+    i2St = BDI_IDXMM_I2ST (pMm, l);
+    i2Qn = BDI_IDXMM_I2QN (pMm, l);
+    if ( dwSt < BS_IDX_NULL || dwSt >= pDiIx->head->dwoltSz
+          || ( i2Qn > 0 && ( i2St < BS_IDX_0
+                             || i2St + i2Qn > pDiIx->head->i2wptSz ) ) )
+          { return false; }
+  }
+  return true;
+}
+
+/**
+ * <p>Deep validation, i.e. verify IDX v2 sections checksums.</p>
+ * @param pMm - mapped IDX v2
+ * @return if all sections are intact
+ **/
+static bool
+  s_is_scts_valid (BsDiIxMm *pMm)
+{
+  const unsigned char *hd = pMm->dt;
+  int64_t scts[BDI_IDXMM_SCTS + 1] = {
+    s_get (hd + S_HD_IRTOFST, 8), s_get (hd + S_HD_DWOFSOFST, 8),
+    s_get (hd + S_HD_DWLNSOFST, 8), s_get (hd + S_HD_FLSZ, 8) };
+  bool rz = true;
+  for ( int i = 0; i < BDI_IDXMM_SCTS; i++ )
+  {
+    if ( bsdiixsum_hash (BDI_SUM_HASH0, (const char*) pMm->dt + scts[i],
+                         scts[i + 1] - scts[i])
+           != s_get (hd + S_HD_SUMS + 8 * i, 8) )
+    {
+      BSLOG_LOG (BSLWARN, "IDX v2 section #%d has wrong checksum\n", i)
+      rz = false;
+    }
+  }
+  return rz;
+}
+
+/**
+ * <p>Map IDX v1 file and point its IRT, I2WPT, HWP, FST and SA.
+ * Their offsets are aligned (BDI_TXFLG_ALGN).</p>
+ * @param pMm - mapped IDX v2
+ * @param pDiIx - IDX in file
+ * @set errno if error.
+ **/
+static void
+  s_map_idx (BsDiIxMm *pMm, BsDiIxTx *pDiIx)
+{
+  pMm->ixSz = s_get ((const unsigned char*) pMm->dt + S_HD_IDXSZ, 8);
+  pMm->irtRdSz = BDI_IRTRD_FIXED_SIZE (pMm->mxIrWdSz, pMm->flgs);
+  BS_IF_EN_RET (pDiIx->irtOfst + pMm->irtSz * (BS_FOFST_T) pMm->irtRdSz
+                  > (BS_FOFST_T) pMm->ixSz
+    || pDiIx->i2wptOfst + pDiIx->head->i2wptSz
+      * (BS_FOFST_T) BDI_TX_IDXLEN (pDiIx->head->flgs) > (BS_FOFST_T) pMm->ixSz,
+                BSE_VALIDATE_ERR)
+  pMm->ixDt = mmap (NULL, pMm->ixSz, PROT_READ, MAP_SHARED, fileno (pDiIx->idxFl), 0);
+  if ( pMm->ixDt == MAP_FAILED )
+  {
+    pMm->ixDt = NULL;
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_LOG (BSLERROR, "Can't map IDX file size=%zu\n", pMm->ixSz)
+    return;
+  }
+  madvise (pMm->ixDt, pMm->ixSz, MADV_RANDOM);
+  pMm->irtWrds = (const char*) pMm->ixDt + pDiIx->irtOfst;
+  pMm->i2wpt = (const char*) pMm->ixDt + pDiIx->i2wptOfst;
+  pMm->hwp = NULL;
+  if ( pDiIx->hwpOfst != BS_FOFST_NULL )
+        { pMm->hwp = (const char*) pMm->ixDt + pDiIx->hwpOfst; }
+  pMm->fst = NULL;
+  if ( pDiIx->fstOfst != BS_FOFST_NULL )
+        { pMm->fst = (const char*) pMm->ixDt + pDiIx->fstOfst; }
+  pMm->sa = NULL;
+  if ( pDiIx->saOfst != BS_FOFST_NULL )
+        { pMm->sa = (const char*) pMm->ixDt + pDiIx->saOfst; }
+}
+
+//public lib:
+/**
+ * <p>Destructor, it unmaps files.</p>
+ * @param pMm - mapped IDX v2 or NULL
+ * @return always NULL
+ **/
+BsDiIxMm*
+  bsdiixmm_free (BsDiIxMm *pMm)
+{
+  if ( pMm != NULL )
+  {
+    if ( pMm->dt != NULL )
+          { munmap (pMm->dt, pMm->sz); }
+    if ( pMm->ixDt != NULL )
+          { munmap (pMm->ixDt, pMm->ixSz); }
+    free (pMm);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Get IRT record's word from mapped IDX v1.</p>
+ * @param pMm - mapped IDX v2
+ * @param pIdx - IRT index
+ * @return word mxIrWdSz, it's 0 terminated if shorter
+ **/
+const BS_CHAR_T*
+  bsdiixmm_irt_wrd (BsDiIxMm *pMm, BS_IDX_T pIdx)
+{
+  //word is at IDX v1 fixed size record's start:
+  return (const BS_CHAR_T*) (pMm->irtWrds + pIdx * pMm->irtRdSz);
+}
+
+/**
+ * <p>Save (write/overwrite) IDX v2 from IDX v1 in file.
+ * It's written into temporary file that replaces old one,
+ * so any process that maps old one is not affected.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void
+  bsdiixmm_save (BsDiIxTx *pDiIx, char *pPth)
+{
+  //vars:
+  FILE *fl;
+  unsigned char hd[BDI_IDXMM_HEADSZ];
+  int ln = strlen (pPth);
+  char pth[ln + 10], tmpPth[ln + 14];
+  //code:
+  strcpy (pth, pPth);
+  strcat (pth, BDI_IDXMM_FILE_EXT);
+  strcpy (tmpPth, pth);
+  strcat (tmpPth, ".tmp");
+  BS_DO_E_RET (s_mk_head (pDiIx, hd))
+  fl = fopen (tmpPth, "wb");
+  BS_IF_EN_RET (fl == NULL, BSE_OPEN_FILE)
+  //head's placeholder:
+  BS_IF_EN_OUTE (fwrite (hd, BDI_IDXMM_HEADSZ, 1, fl) != 1, BSE_WRITE_FILE)
+  BS_DO_E_OUTE (s_write_tbls (pDiIx, fl, hd))
+  BS_IF_EN_OUTE ((int64_t) s_get (hd + S_HD_FLSZ, 8) != ftell (fl), BSE_ALG_ERR)
+  BS_DO_E_OUTE (bsfseek_goto (fl, 0L))
+  BS_IF_EN_OUTE (fwrite (hd, BDI_IDXMM_HEADSZ, 1, fl) != 1, BSE_WRITE_FILE)
+  BS_IF_EN_OUTE (fclose (fl) != 0, BSE_WRITE_FILE)
+  fl = NULL;
+  BS_IF_EN_OUTE (rename (tmpPth, pth) != 0, BSE_WRITE_FILE)
+  BSLOG_LOG (BSLINFO, "IDX v2 has been saved %s\n", pth)
+  return;
+
+oute:
+  if ( fl != NULL )
+        { fclose (fl); }
+  remove (tmpPth);
+}
+
+/**
+ * <p>Map IDX v2 that matches given IDX v1 in file, and IDX v1 file.
+ * IDX v2 with invalid IRT records or with wrong sections checksums
+ * (deep validation) is treated as stale.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @param pDpVld - deep validation, i.e. verifying sections checksums
+ * @return object or NULL if error or IDX v2 is absent, stale
+ *   or unusable on this host (big-endian) or with IDX v1 (unaligned)
+ * @set errno if error. Absent or stale IDX v2 is not error!
+ **/
+BsDiIxMm*
+  bsdiixmm_load (BsDiIxTx *pDiIx, char *pPth, bool pDpVld)
+{
+  //vars:
+  BsDiIxMm *obj;
+  struct stat st;
+  bool isVld;
+  int fd;
+  const unsigned char *hd;
+  char pth[strlen (pPth) + 10];
+  //code:
+  if ( !s_is_usable (pDiIx) )
+                { return NULL; }
+  strcpy (pth, pPth);
+  strcat (pth, BDI_IDXMM_FILE_EXT);
+  fd = open (pth, O_RDONLY);
+  if ( fd == -1 )
+  {
+    errno = 0;
+    return NULL;
+  }
+  obj = NULL;
+  BS_IF_EN_OUTE (fstat (fd, &st) != 0, BSE_READ_FILE)
+  if ( st.st_size < BDI_IDXMM_HEADSZ )
+                { goto out; }
+  obj = malloc (sizeof (BsDiIxMm));
+  BS_IF_EN_OUTE (obj == NULL, ENOMEM)
+  obj->ixDt = NULL;
+  obj->sz = st.st_size;
+  obj->dt = mmap (NULL, obj->sz, PROT_READ, MAP_SHARED, fd, 0);
+  if ( obj->dt == MAP_FAILED )
+  {
+    obj->dt = NULL;
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_LOG (BSLERROR, "Can't map file %s size=%zu\n", pth, obj->sz)
+    goto oute;
+  }
+  hd = obj->dt;
+  BS_DO_E_OUTE (isVld = s_is_valid (pDiIx, hd, obj->sz))
+  if ( !isVld )
+  {
+    BSLOG_LOG (BSLINFO, "IDX v2 is stale %s\n", pth)
+    goto out;
+  }
+  obj->mxIrWdSz = s_get (hd + S_HD_MXIRWDSZ, 4);
+  obj->irtSz = s_get (hd + S_HD_IRTSZ, 8);
+  obj->flgs = s_get (hd + S_HD_FLGS, 4);
+  obj->irt = (const char*) obj->dt + s_get (hd + S_HD_IRTOFST, 8);
+  obj->dwoltOfsts = (const char*) obj->dt + s_get (hd + S_HD_DWOFSOFST, 8);
+  obj->dwoltLens = (const uint16_t*) ((const char*) obj->dt + s_get (hd + S_HD_DWLNSOFST, 8));
+  if ( !s_is_irt_valid (obj, pDiIx)
+        || ( pDpVld && !s_is_scts_valid (obj) ) )
+  {
+    BSLOG_LOG (BSLWARN, "IDX v2 is corrupted %s\n", pth)
+    goto out;
+  }
+  BS_DO_E_OUTE (s_map_idx (obj, pDiIx))
+  madvise (obj->dt, obj->sz, MADV_RANDOM);
+  close (fd);
+  return obj;
+
+out: //absent or stale
+  bsdiixmm_free (obj);
+  close (fd);
+  return NULL;
+
+oute:
+  bsdiixmm_free (obj);
+  close (fd);
+  return NULL;
+}
+
+/**
+ * <p>Map IDX v2, (re)make it first if it's absent or stale.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @param pDpVld - deep validation, i.e. verifying sections checksums
+ * @return object or NULL if error or host or IDX v1 is unusable
+ * @set errno if error.
+ **/
+BsDiIxMm*
+  bsdiixmm_open (BsDiIxTx *pDiIx, char *pPth, bool pDpVld)
+{
+  BsDiIxMm *obj;
+  if ( !s_is_usable (pDiIx) )
+  {
+    BSLOG_LOG (BSLINFO, "IDX v2 isn't used on big-endian host or with unaligned IDX\n")
+    return NULL;
+  }
+  BS_DO_E_RETN (obj = bsdiixmm_load (pDiIx, pPth, pDpVld))
+  if ( obj != NULL )
+                { return obj; }
+  BS_DO_E_RETN (bsdiixmm_save (pDiIx, pPth))
+  BS_DO_E_RETN (obj = bsdiixmm_load (pDiIx, pPth, false))
+  return obj;
+}
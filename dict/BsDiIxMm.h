@@ -0,0 +1,159 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ IDX v2 - mappable image of IDX in file tables.
+ * It's sidecar file (dictionary path + ".idx2") that is made from IDX v1
+ * with aligned sections (BDI_TXFLG_ALGN). IDX v1 file is mapped too,
+ * so its I2WPT, HWP, FST and SA are used as they are, i.e. IDX v2 holds
+ * only IRT and DWOLT, which records are packed in IDX v1, so their numbers
+ * aren't aligned there. All IDX v2 numbers are fixed size little-endian,
+ * sections and IRT records are aligned by 8 bytes, so they are accessed
+ * by pointer arithmetic instead of seek and field-by-field reading.
+ * It's remade whenever IDX v1 file is changed. Sections checksums
+ * (see BsDiIxSum.h) are verified only by deep validation.
+ * IRT words aren't copied, they are read from mapped IDX v1 fixed size
+ * IRT records, which words are aligned by BS_CHAR_LEN, so IDX v2 doesn't
+ * duplicate the biggest part of IRT. IRT records numbers are validated
+ * on loading, so they never point out of I2WPT or DWOLT.
+ * DWOLT offsets are of the same width as IDX v1 ones, i.e. 32-bit
+ * if IDX v1 has BDI_TXFLG_OFS32.</p>
+ * <pre>
+ * head (BDI_IDXMM_HEADSZ bytes):
+ *   uint32 magic, uint32 version, int64 IDX v1 size, int64 IDX v1 mtime,
+ *   int64 irtSz, int64 i2wptSz, int64 dwoltSz, uint32 mxIrWdSz,
+ *   uint32 IDX v1 flags, int64 IRT offset, int64 DWOLT offsets offset,
+ *   int64 DWOLT lengths offset, int64 IDX v1 IRT offset,
+ *   uint64 sections checksums[BDI_IDXMM_SCTS], int64 file size
+ * IRT record: int64 dwolt_start, int64 i2wpt_start, uint16 i2wpt_quantity,
+ *   padding up to 8 bytes
+ * DWOLT: int64 or uint32 offsets[dwoltSz], padding up to 8 bytes,
+ *   uint16 lengths[dwoltSz], padding up to 8 bytes
+ * </pre>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXMM
+#define BS_DEBUGL_DIIXMM 30650
+
+#include "stdint.h"
+
+#include "BsDiIxTx.h"
+
+#define BDI_IDXMM_FILE_EXT ".idx2"
+#define BDI_IDXMM_MAGIC 0x32584442U
+#define BDI_IDXMM_VER 8
+#define BDI_IDXMM_HEADSZ 120
+//check-summed sections: IRT, DWOLT offsets and DWOLT lengths:
+#define BDI_IDXMM_SCTS 3
+#define BDI_IDXMM_ALIGN 8
+#define BDI_IDXMM_IRTRD_SZ 24
+
+//IRT record fields offsets:
+#define BDI_IDXMM_IRT_DWST 0
+#define BDI_IDXMM_IRT_I2ST 8
+#define BDI_IDXMM_IRT_I2QN 16
+
+/**
+ * <p>Mapped IDX v2.</p>
+ * @member void *dt - mapped file
+ * @member size_t sz - file size
+ * @member void *ixDt - mapped IDX v1 file
+ * @member size_t ixSz - IDX v1 file size
+ * @member int mxIrWdSz - max IRT word size
+ * @member int flgs - IDX v1 encoding flags BDI_TXFLG_*
+ * @member const char *irt - IRT
+ * @member const char *irtWrds - IDX v1 IRT, i.e. its records words
+ * @member size_t irtRdSz - IDX v1 IRT record size
+ * @member const void *i2wpt - IDX v1 I2WPT, int64 or int32
+ * @member const void *dwoltOfsts - DWOLT words offsets in dictionary,
+ *   int64 or uint32
+ * @member const uint16_t *dwoltLens - DWOLT words lengths
+ * @member const char *hwp - IDX v1 HWP or NULL
+ * @member const char *fst - IDX v1 FST or NULL
+ * @member const char *sa - IDX v1 SA or NULL
+ * @member BS_IDX_T irtSz - IRT size
+ **/
+typedef struct BsDiIxMm {
+  void *dt;
+  size_t sz;
+  void *ixDt;
+  size_t ixSz;
+  int mxIrWdSz;
+  int flgs;
+  const char *irt;
+  const char *irtWrds;
+  size_t irtRdSz;
+  const void *i2wpt;
+  const void *dwoltOfsts;
+  const uint16_t *dwoltLens;
+  const char *hwp;
+  const char *fst;
+  const char *sa;
+  BS_IDX_T irtSz;
+} BsDiIxMm;
+
+//IRT record #pIdx fields:
+#define BDI_IDXMM_IRT(pMm, pIdx) ((pMm)->irt + (pIdx) * BDI_IDXMM_IRTRD_SZ)
+#define BDI_IDXMM_DWST(pMm, pIdx) (*(const int64_t*) (BDI_IDXMM_IRT (pMm, pIdx) + BDI_IDXMM_IRT_DWST))
+#define BDI_IDXMM_I2ST(pMm, pIdx) (*(const int64_t*) (BDI_IDXMM_IRT (pMm, pIdx) + BDI_IDXMM_IRT_I2ST))
+#define BDI_IDXMM_I2QN(pMm, pIdx) (*(const uint16_t*) (BDI_IDXMM_IRT (pMm, pIdx) + BDI_IDXMM_IRT_I2QN))
+
+//I2WPT record #pIdx (DWOLT index):
+#define BDI_IDXMM_I2WPT(pMm, pIdx) (((pMm)->flgs & BDI_TXFLG_IDX32)\
+  ? (BS_IDX_T) ((const int32_t*) (pMm)->i2wpt)[pIdx]\
+  : (BS_IDX_T) ((const int64_t*) (pMm)->i2wpt)[pIdx])
+//DWOLT record #pIdx word's offset:
+#define BDI_IDXMM_DWOFS(pMm, pIdx) (((pMm)->flgs & BDI_TXFLG_OFS32)\
+  ? (BS_FOFST_T) ((const uint32_t*) (pMm)->dwoltOfsts)[pIdx]\
+  : (BS_FOFST_T) ((const int64_t*) (pMm)->dwoltOfsts)[pIdx])
+
+/**
+ * <p>Destructor, it unmaps files.</p>
+ * @param pMm - mapped IDX v2 or NULL
+ * @return always NULL
+ **/
+BsDiIxMm *bsdiixmm_free (BsDiIxMm *pMm);
+
+/**
+ * <p>Get IRT record's word from mapped IDX v1.</p>
+ * @param pMm - mapped IDX v2
+ * @param pIdx - IRT index
+ * @return word mxIrWdSz, it's 0 terminated if shorter
+ **/
+const BS_CHAR_T *bsdiixmm_irt_wrd (BsDiIxMm *pMm, BS_IDX_T pIdx);
+
+/**
+ * <p>Save (write/overwrite) IDX v2 from IDX v1 in file.
+ * It's written into temporary file that replaces old one,
+ * so any process that maps old one is not affected.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void bsdiixmm_save (BsDiIxTx *pDiIx, char *pPth);
+
+/**
+ * <p>Map IDX v2 that matches given IDX v1 in file, and IDX v1 file.
+ * IDX v2 with invalid IRT records or with wrong sections checksums
+ * (deep validation) is treated as stale.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @param pDpVld - deep validation, i.e. verifying sections checksums
+ * @return object or NULL if error or IDX v2 is absent, stale
+ *   or unusable on this host (big-endian) or with IDX v1 (unaligned)
+ * @set errno if error. Absent or stale IDX v2 is not error!
+ **/
+BsDiIxMm *bsdiixmm_load (BsDiIxTx *pDiIx, char *pPth, bool pDpVld);
+
+/**
+ * <p>Map IDX v2, (re)make it first if it's absent or stale.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path
+ * @param pDpVld - deep validation, i.e. verifying sections checksums
+ * @return object or NULL if error or host or IDX v1 is unusable
+ * @set errno if error.
+ **/
+BsDiIxMm *bsdiixmm_open (BsDiIxTx *pDiIx, char *pPth, bool pDpVld);
+#endif
@@ -0,0 +1,439 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+/**
+ * <p>Beigesoft™ IDX headwords suffix array (SA).</p>
+ * @author Yury Demidenko
+ **/
+
+#include "stdlib.h"
+#include "string.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsFioWrap.h"
+#include "BsDiIxSa.h"
+
+//suffixes group size that is sorted by insertion:
+#define S_INS_SZ 16
+
+//local lib:
+/**
+ * <p>Compare two suffixes from given depth up to separator,
+ * equal ones by their positions.</p>
+ * @param pTxt - text
+ * @param pSfx1 - suffix 1 start
+ * @param pSfx2 - suffix 2 start
+ * @param pDpth - depth, i.e. chars before are equal
+ * @return -1, 0 or 1
+ **/
+static inline int
+  s_sfx_cmp (const BS_CHAR_T *pTxt, uint32_t pSfx1, uint32_t pSfx2, int pDpth)
+{
+  const BS_CHAR_T *s1 = pTxt + pSfx1 + pDpth, *s2 = pTxt + pSfx2 + pDpth;
+  for ( ; *s1 == *s2; s1++, s2++ )
+  {
+    if ( *s1 == 0 )
+                { return pSfx1 < pSfx2 ? -1 : pSfx1 > pSfx2 ? 1 : 0; }
+  }
+  return *s1 < *s2 ? -1 : 1;
+}
+
+/**
+ * <p>Compare two positions.</p>
+ * @param pPos1 - position 1
+ * @param pPos2 - position 2
+ * @return -1, 0 or 1
+ **/
+static int
+  s_pos_cmp (const void *pPos1, const void *pPos2)
+{
+  uint32_t p1 = *(const uint32_t*) pPos1, p2 = *(const uint32_t*) pPos2;
+  return p1 < p2 ? -1 : p1 > p2 ? 1 : 0;
+}
+
+/**
+ * <p>Sort suffixes by multikey quicksort, i.e. ternary partition by char
+ * at depth, then equal ones by next char. Words are short, so it's
+ * fast without any LCP.</p>
+ * @param pTxt - text
+ * @param pSfxs - suffixes starts
+ * @param pSz - their total
+ * @param pDpth - depth, i.e. chars before are equal
+ **/
+static void
+  s_sort (const BS_CHAR_T *pTxt, uint32_t *pSfxs, BS_FOFST_T pSz, int pDpth)
+{
+  BS_FOFST_T lt, i, gt, j;
+  uint32_t sw;
+  BS_CHAR_T pvt, c, c1, c2, c3;
+  while ( pSz > 1 )
+  {
+    if ( pSz < S_INS_SZ )
+    {
+      for ( i = 1; i < pSz; i++ )
+      {
+        sw = pSfxs[i];
+        for ( j = i; j > 0 && s_sfx_cmp (pTxt, pSfxs[j - 1], sw, pDpth) > 0; j-- )
+                { pSfxs[j] = pSfxs[j - 1]; }
+        pSfxs[j] = sw;
+      }
+      return;
+    }
+    //median of three:
+    c1 = pTxt[pSfxs[0] + pDpth];
+    c2 = pTxt[pSfxs[pSz / 2] + pDpth];
+    c3 = pTxt[pSfxs[pSz - 1] + pDpth];
+    pvt = c1 < c2 ? ( c2 < c3 ? c2 : c1 < c3 ? c3 : c1 )
+                  : ( c1 < c3 ? c1 : c2 < c3 ? c3 : c2 );
+    lt = 0; i = 0; gt = pSz;
+    while ( i < gt )
+    {
+      c = pTxt[pSfxs[i] + pDpth];
+      if ( c < pvt )
+      {
+        sw = pSfxs[lt]; pSfxs[lt++] = pSfxs[i]; pSfxs[i++] = sw;
+      } else if ( c > pvt )
+      {
+        sw = pSfxs[--gt]; pSfxs[gt] = pSfxs[i]; pSfxs[i] = sw;
+      } else {
+        i++;
+      }
+    }
+    s_sort (pTxt, pSfxs, lt, pDpth);
+    s_sort (pTxt, pSfxs + gt, pSz - gt, pDpth);
+    if ( pvt == 0 )
+    { //the same suffixes of different words:
+      qsort (pSfxs + lt, gt - lt, sizeof (uint32_t), s_pos_cmp);
+      return;
+    }
+    pSfxs += lt;
+    pSz = gt - lt;
+    pDpth++;
+  }
+}
+
+/**
+ * <p>Compare suffix with infix up to infix's length.</p>
+ * @param pTxt - text
+ * @param pSfx - suffix start
+ * @param pInfx - infix
+ * @return -1 if suffix is less, 0 if it starts with infix, otherwise 1
+ **/
+static inline int
+  s_infx_cmp (const BS_CHAR_T *pTxt, uint32_t pSfx, const BS_CHAR_T *pInfx)
+{
+  const BS_CHAR_T *s = pTxt + pSfx;
+  for ( ; *pInfx != 0; s++, pInfx++ )
+  {
+    if ( *s != *pInfx )
+                { return *s < *pInfx ? -1 : 1; }
+  }
+  return 0;
+}
+
+/**
+ * <p>Read and check SA head in IDX file.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - SA offset
+ * @param pCnt - DWOLT size
+ * @param pSzRt - pointer to return SA size
+ * @return true if there is valid SA head
+ * @set errno if error.
+ **/
+static bool
+  s_head (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt, BS_FOFST_T *pSzRt)
+{
+  struct stat st;
+  int mgc, rsv;
+  BS_IDX_T cnt;
+  BS_FOFST_T txtLen, sfxSz;
+  int fd = fileno (pIdxFl);
+  if ( fd == -1 || fstat (fd, &st) != 0 )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return false;
+  }
+  if ( pOfst + BDI_SA_HEADSZ > st.st_size )
+                { return false; }
+  BS_DO_E_RETF (bsfseek_goto (pIdxFl, pOfst))
+  if ( fread (&mgc, sizeof (int), 1, pIdxFl) != 1
+        || fread (&rsv, sizeof (int), 1, pIdxFl) != 1
+          || fread (&cnt, BS_IDX_LEN, 1, pIdxFl) != 1
+            || fread (pSzRt, BS_FOFST_LEN, 1, pIdxFl) != 1
+              || fread (&txtLen, BS_FOFST_LEN, 1, pIdxFl) != 1
+                || fread (&sfxSz, BS_FOFST_LEN, 1, pIdxFl) != 1 )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return false;
+  }
+  return mgc == BDI_SA_MAGIC && cnt == pCnt && txtLen >= BS_FOFST_0
+    && sfxSz >= BS_FOFST_0 && sfxSz + cnt == txtLen
+      && *pSzRt == (BS_FOFST_T) ( BDI_SA_HEADSZ + ( txtLen * BS_CHAR_LEN + 3 ) / 4 * 4
+                     + ( cnt + sfxSz ) * sizeof (uint32_t) )
+        && pOfst + *pSzRt <= st.st_size;
+}
+
+//public lib:
+/**
+ * <p>Make SA from ordered i.words of DWOLT, i.e. with not zero
+ * length_dword.</p>
+ * @param pIwrds - ordered i.words
+ * @return SA section or NULL when error
+ * @set errno if error, BSE_ARR_OUT_MAX_SIZE if text is too long.
+ **/
+char*
+  bsdiixsa_new (BsDicIwrds *pIwrds)
+{
+  BS_IDX_T l, cnt = BS_IDX_0;
+  BS_FOFST_T txtLen = BS_FOFST_0, sz, pos, k;
+  int len, mgc = BDI_SA_MAGIC;
+  for ( l = BS_IDX_0; l < pIwrds->size; l++ )
+  {
+    if ( pIwrds->vals[l]->length_dword != 0 )
+    {
+      cnt++;
+      txtLen += bsdicidx_istr_len (pIwrds->vals[l]->iword) + 1;
+    }
+  }
+  BS_IF_EN_RETN (txtLen > (BS_FOFST_T) UINT32_MAX, BSE_ARR_OUT_MAX_SIZE)
+  BS_FOFST_T sfxSz = txtLen - cnt;
+  sz = BDI_SA_HEADSZ + ( txtLen * BS_CHAR_LEN + 3 ) / 4 * 4
+         + ( cnt + sfxSz ) * (BS_FOFST_T) sizeof (uint32_t);
+  char *sa = calloc (1, sz);
+  BS_IF_EN_RETN (sa == NULL, ENOMEM)
+  memcpy (sa, &mgc, sizeof (int));
+  memcpy (sa + BDI_SA_CNT_OFST, &cnt, BS_IDX_LEN);
+  memcpy (sa + BDI_SA_SZ_OFST, &sz, BS_FOFST_LEN);
+  memcpy (sa + BDI_SA_TXTLEN_OFST, &txtLen, BS_FOFST_LEN);
+  memcpy (sa + BDI_SA_SFXSZ_OFST, &sfxSz, BS_FOFST_LEN);
+  BS_CHAR_T *txt = (BS_CHAR_T*) BDI_SA_TXT (sa);
+  uint32_t *stts = (uint32_t*) BDI_SA_STTS (sa);
+  uint32_t *sfxs = (uint32_t*) BDI_SA_SFXS (sa);
+  pos = BS_FOFST_0; k = BS_FOFST_0; cnt = BS_IDX_0;
+  for ( l = BS_IDX_0; l < pIwrds->size; l++ )
+  {
+    if ( pIwrds->vals[l]->length_dword == 0 )
+                { continue; }
+    len = bsdicidx_istr_len (pIwrds->vals[l]->iword);
+    stts[cnt++] = (uint32_t) pos;
+    memcpy (txt + pos, pIwrds->vals[l]->iword, len * BS_CHAR_LEN);
+    for ( int i = 0; i < len; i++ )
+                { sfxs[k++] = (uint32_t) ( pos + i ); }
+    pos += len;
+    txt[pos++] = 0;
+  }
+  s_sort (txt, sfxs, sfxSz, 0);
+  BSLOG_LOG (BSLINFO, "SA has been made, words="BS_IDX_FMT", suffixes="BS_FOFST_FMT", size="BS_FOFST_FMT"\n", cnt, sfxSz, sz)
+  return sa;
+}
+
+/**
+ * <p>Find range of suffixes that start with given infix.</p>
+ * @param pSa - SA
+ * @param pInfx - not empty i.word's infix
+ * @param pEndRt - pointer to return range's end (exclusive)
+ * @return range's start or BS_IDX_NULL if there is no such suffix
+ **/
+BS_IDX_T
+  bsdiixsa_range (const char *pSa, const BS_CHAR_T *pInfx,
+                  BS_IDX_T *pEndRt)
+{
+  const BS_CHAR_T *txt = BDI_SA_TXT (pSa);
+  const uint32_t *sfxs = BDI_SA_SFXS (pSa);
+  BS_IDX_T lo = BS_IDX_0, hi = BDI_SA_SFXSZ (pSa), md, stt;
+  //the first not less:
+  while ( lo < hi )
+  {
+    md = lo + ( hi - lo ) / 2;
+    if ( s_infx_cmp (txt, sfxs[md], pInfx) < 0 )
+          { lo = md + 1; }
+    else
+          { hi = md; }
+  }
+  stt = lo;
+  //the first greater:
+  hi = BDI_SA_SFXSZ (pSa);
+  while ( lo < hi )
+  {
+    md = lo + ( hi - lo ) / 2;
+    if ( s_infx_cmp (txt, sfxs[md], pInfx) <= 0 )
+          { lo = md + 1; }
+    else
+          { hi = md; }
+  }
+  if ( stt == lo )
+                { return BS_IDX_NULL; }
+  *pEndRt = lo;
+  return stt;
+}
+
+/**
+ * <p>Reveal suffix's word.</p>
+ * @param pSa - SA
+ * @param pSfx - suffix's index
+ * @return word's DWOLT index
+ **/
+BS_IDX_T
+  bsdiixsa_wrd (const char *pSa, BS_IDX_T pSfx)
+{
+  const uint32_t *stts = BDI_SA_STTS (pSa);
+  uint32_t pos = BDI_SA_SFXS (pSa)[pSfx];
+  BS_IDX_T lo = BS_IDX_0, hi = BDI_SA_CNT (pSa), md;
+  //the last word that starts not after suffix:
+  while ( hi - lo > 1 )
+  {
+    md = lo + ( hi - lo ) / 2;
+    if ( stts[md] <= pos )
+          { lo = md; }
+    else
+          { hi = md; }
+  }
+  return lo;
+}
+
+/**
+ * <p>Compare DWOLT indexes.</p>
+ * @param pIdx1 - index 1
+ * @param pIdx2 - index 2
+ * @return -1, 0 or 1
+ **/
+static int
+  s_idx_cmp (const void *pIdx1, const void *pIdx2)
+{
+  BS_IDX_T i1 = *(const BS_IDX_T*) pIdx1, i2 = *(const BS_IDX_T*) pIdx2;
+  return i1 < i2 ? -1 : i1 > i2 ? 1 : 0;
+}
+
+/**
+ * <p>Find words that contain given infix. If there are up to
+ * BDI_SA_SCANMX such suffixes, then they're the first words in DWOLT order,
+ * otherwise they're the first words of the first BDI_SA_SCANMX suffixes.</p>
+ * @param pSa - SA
+ * @param pInfx - not empty i.word's infix
+ * @param pIdxs - array to return DWOLT indexes ordered ascending
+ * @param pIdxsMx - its size
+ * @return found words total or -1 if error
+ * @set errno if error.
+ **/
+int
+  bsdiixsa_find (const char *pSa, const BS_CHAR_T *pInfx,
+                 BS_IDX_T *pIdxs, int pIdxsMx)
+{
+  BS_IDX_T stt, end, l, *idxs;
+  int i, j, cnt = 0;
+  if ( pInfx[0] == 0 || pIdxsMx < 1 )
+  {
+    errno = BSE_WRONG_PARAMS;
+    BSLOG_ERR
+    return -1;
+  }
+  stt = bsdiixsa_range (pSa, pInfx, &end);
+  if ( stt == BS_IDX_NULL )
+                { return 0; }
+  if ( end - stt > BDI_SA_SCANMX )
+  { //in suffixes order:
+    for ( l = stt; l < end && cnt < pIdxsMx; l++ )
+    {
+      BS_IDX_T idx = bsdiixsa_wrd (pSa, l);
+      for ( i = 0; i < cnt && pIdxs[i] != idx; i++ ) ;
+      if ( i == cnt )
+                { pIdxs[cnt++] = idx; }
+    }
+    qsort (pIdxs, cnt, sizeof (BS_IDX_T), s_idx_cmp);
+    return cnt;
+  }
+  idxs = malloc ((end - stt) * sizeof (BS_IDX_T));
+  if ( idxs == NULL )
+  {
+    errno = ENOMEM;
+    BSLOG_ERR
+    return -1;
+  }
+  for ( l = stt; l < end; l++ )
+                { idxs[l - stt] = bsdiixsa_wrd (pSa, l); }
+  qsort (idxs, end - stt, sizeof (BS_IDX_T), s_idx_cmp);
+  for ( j = 0; j < end - stt && cnt < pIdxsMx; j++ )
+  {
+    if ( j == 0 || idxs[j] != idxs[j - 1] )
+                { pIdxs[cnt++] = idxs[j]; }
+  }
+  free (idxs);
+  return cnt;
+}
+
+/**
+ * <p>Write SA at IDX file current position.</p>
+ * @param pSa - SA
+ * @param pIdxFl - IDX file positioned at FST end
+ * @set errno if error.
+ **/
+void
+  bsdiixsa_write (const char *pSa, FILE *pIdxFl)
+{
+  size_t sz = BDI_SA_SZ (pSa);
+  BS_IF_EN_RET (fwrite (pSa, 1, sz, pIdxFl) != sz, BSE_WRITE_FILE)
+}
+
+/**
+ * <p>Reveal SA size in IDX file. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - SA offset, i.e. FST end
+ * @param pCnt - DWOLT size
+ * @return SA size or 0 if IDX file without SA
+ * @set errno if error. "SA not found" is not error!
+ **/
+BS_FOFST_T
+  bsdiixsa_size (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt)
+{
+  BS_FOFST_T sz, rz = BS_FOFST_0;
+  long pos = ftell (pIdxFl);
+  BS_DO_E_OUT (bool isSa = s_head (pIdxFl, pOfst, pCnt, &sz))
+  if ( isSa )
+        { rz = sz; }
+out:
+  fseek (pIdxFl, pos, SEEK_SET);
+  return rz;
+}
+
+/**
+ * <p>Load SA from IDX file into memory. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - SA offset, i.e. FST end
+ * @param pCnt - DWOLT size
+ * @return SA or NULL if error or IDX file without SA
+ * @set errno if error. "SA not found" is not error!
+ **/
+char*
+  bsdiixsa_load (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt)
+{
+  char *sa = NULL;
+  long pos = ftell (pIdxFl);
+  BS_DO_E_RETN (BS_FOFST_T sz = bsdiixsa_size (pIdxFl, pOfst, pCnt))
+  if ( sz == BS_FOFST_0 )
+  {
+    BSLOG_LOG (BSLINFO, "IDX file without SA\n")
+    return NULL;
+  }
+  sa = malloc (sz);
+  BS_IF_EN_OUT (sa == NULL, ENOMEM)
+  BS_DO_E_OUT (bsfseek_goto (pIdxFl, pOfst))
+  if ( fread (sa, 1, sz, pIdxFl) != (size_t) sz )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+  }
+out:
+  if ( errno != 0 && sa != NULL )
+  {
+    free (sa);
+    sa = NULL;
+  }
+  fseek (pIdxFl, pos, SEEK_SET);
+  return sa;
+}
@@ -0,0 +1,125 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ IDX headwords suffix array (SA) - optional IDX section just
+ * after FST (or HWP/DWOLT if IDX is without it). It's made of DWOLT i.words
+ * that are concatenated with 0 separator, and of all their suffixes
+ * (except separators) ordered by i.word's chars up to separator, equal ones
+ * by their positions. So words that contain any infix are a SA range that is
+ * found by binary search in O(m log n). Suffix's word (its DWOLT index) is
+ * revealed by binary search in words starts. It's position independent,
+ * so it's used as is in memory or in mapped IDX v2.
+ * IDX without SA (e.g. old one) is still valid.</p>
+ * <pre>
+ * section (native byte order, offsets are relative to section start):
+ *   int magic, int reserved 0, BS_IDX_T cnt (=DWOLT size),
+ *   BS_FOFST_T sz - section size, BS_FOFST_T txtLen - text's chars total,
+ *   BS_FOFST_T sfxSz - suffixes total,
+ *   BS_CHAR_T text[txtLen] - i.words each followed by 0,
+ *     padding up to 4 bytes,
+ *   uint32 starts[cnt] - words starts in text,
+ *   uint32 suffixes[sfxSz] - ordered suffixes starts in text
+ * </pre>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXSA
+#define BS_DEBUGL_DIIXSA 30680
+
+#include "stdio.h"
+#include "stdint.h"
+
+#include "BsDicIwrds.h"
+
+//SA section's first int:
+#define BDI_SA_MAGIC 0x31584153
+#define BDI_SA_HEADSZ 40
+#define BDI_SA_CNT_OFST 8
+#define BDI_SA_SZ_OFST 16
+#define BDI_SA_TXTLEN_OFST 24
+#define BDI_SA_SFXSZ_OFST 32
+
+//max suffixes that are scanned to reveal the first words in DWOLT order:
+#define BDI_SA_SCANMX 10000
+
+//SA section's head fields and tables:
+#define BDI_SA_CNT(pSa) (*(const BS_IDX_T*) ((const char*) (pSa) + BDI_SA_CNT_OFST))
+#define BDI_SA_SZ(pSa) (*(const BS_FOFST_T*) ((const char*) (pSa) + BDI_SA_SZ_OFST))
+#define BDI_SA_TXTLEN(pSa) (*(const BS_FOFST_T*) ((const char*) (pSa) + BDI_SA_TXTLEN_OFST))
+#define BDI_SA_SFXSZ(pSa) (*(const BS_FOFST_T*) ((const char*) (pSa) + BDI_SA_SFXSZ_OFST))
+#define BDI_SA_TXT(pSa) ((const BS_CHAR_T*) ((const char*) (pSa) + BDI_SA_HEADSZ))
+#define BDI_SA_STTS(pSa) ((const uint32_t*) ((const char*) (pSa) + BDI_SA_HEADSZ \
+  + ( BDI_SA_TXTLEN (pSa) * BS_CHAR_LEN + 3 ) / 4 * 4))
+#define BDI_SA_SFXS(pSa) (BDI_SA_STTS (pSa) + BDI_SA_CNT (pSa))
+
+/**
+ * <p>Make SA from ordered i.words of DWOLT, i.e. with not zero
+ * length_dword.</p>
+ * @param pIwrds - ordered i.words
+ * @return SA section or NULL when error
+ * @set errno if error, BSE_ARR_OUT_MAX_SIZE if text is too long.
+ **/
+char *bsdiixsa_new (BsDicIwrds *pIwrds);
+
+/**
+ * <p>Find range of suffixes that start with given infix.</p>
+ * @param pSa - SA
+ * @param pInfx - not empty i.word's infix
+ * @param pEndRt - pointer to return range's end (exclusive)
+ * @return range's start or BS_IDX_NULL if there is no such suffix
+ **/
+BS_IDX_T bsdiixsa_range (const char *pSa, const BS_CHAR_T *pInfx,
+                         BS_IDX_T *pEndRt);
+
+/**
+ * <p>Reveal suffix's word.</p>
+ * @param pSa - SA
+ * @param pSfx - suffix's index
+ * @return word's DWOLT index
+ **/
+BS_IDX_T bsdiixsa_wrd (const char *pSa, BS_IDX_T pSfx);
+
+/**
+ * <p>Find words that contain given infix. If there are up to
+ * BDI_SA_SCANMX such suffixes, then they're the first words in DWOLT order,
+ * otherwise they're the first words of the first BDI_SA_SCANMX suffixes.</p>
+ * @param pSa - SA
+ * @param pInfx - not empty i.word's infix
+ * @param pIdxs - array to return DWOLT indexes ordered ascending
+ * @param pIdxsMx - its size
+ * @return found words total or -1 if error
+ * @set errno if error.
+ **/
+int bsdiixsa_find (const char *pSa, const BS_CHAR_T *pInfx,
+                   BS_IDX_T *pIdxs, int pIdxsMx);
+
+/**
+ * <p>Write SA at IDX file current position.</p>
+ * @param pSa - SA
+ * @param pIdxFl - IDX file positioned at FST end
+ * @set errno if error.
+ **/
+void bsdiixsa_write (const char *pSa, FILE *pIdxFl);
+
+/**
+ * <p>Reveal SA size in IDX file. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - SA offset, i.e. FST end
+ * @param pCnt - DWOLT size
+ * @return SA size or 0 if IDX file without SA
+ * @set errno if error. "SA not found" is not error!
+ **/
+BS_FOFST_T bsdiixsa_size (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt);
+
+/**
+ * <p>Load SA from IDX file into memory. File position is restored.</p>
+ * @param pIdxFl - IDX file
+ * @param pOfst - SA offset, i.e. FST end
+ * @param pCnt - DWOLT size
+ * @return SA or NULL if error or IDX file without SA
+ * @set errno if error. "SA not found" is not error!
+ **/
+char *bsdiixsa_load (FILE *pIdxFl, BS_FOFST_T pOfst, BS_IDX_T pCnt);
+#endif
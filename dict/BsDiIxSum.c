@@ -0,0 +1,358 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+#include "stdlib.h"
+#include "string.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsFioWrap.h"
+#include "BsDiIxSum.h"
+
+/**
+ * <p>Beigesoft™ IDX check-summed head's block (SUM).</p>
+ * @author Yury Demidenko
+ **/
+
+//hash multiplier:
+#define S_HASH_MUL 0x9E3779B97F4A7C15UL
+
+//sections reading buffer size:
+#define S_BUFSZ 65536L
+
+//head's checksum offset in SUM:
+#define S_HEADSUM_OFST (BDI_SUM_SZ - sizeof (unsigned long))
+
+/**
+ * <p>Continue fast hash with given bytes.</p>
+ * @param pHash - hash so far
+ * @param pDt - bytes
+ * @param pSz - bytes total
+ * @return hash
+ **/
+unsigned long
+  bsdiixsum_hash (unsigned long pHash, const char *pDt, size_t pSz)
+{
+  unsigned long w;
+  size_t i = 0;
+  //by words, it's much faster than FNV-1a by bytes:
+  for ( ; i + sizeof (unsigned long) <= pSz; i += sizeof (unsigned long) )
+  {
+    memcpy (&w, pDt + i, sizeof (unsigned long));
+    pHash = (pHash ^ w) * S_HASH_MUL;
+    pHash ^= pHash >> 29;
+  }
+  for ( ; i < pSz; i++ )
+  {
+    pHash = (pHash ^ (unsigned char) pDt[i]) * S_HASH_MUL;
+    pHash ^= pHash >> 29;
+  }
+  return pHash;
+}
+
+/**
+ * <p>Hash file's region.</p>
+ * @param pFl - file
+ * @param pStt - region's start
+ * @param pEnd - region's end
+ * @param pBuf - buffer S_BUFSZ
+ * @return hash
+ * @set errno if error.
+ **/
+static unsigned long
+  s_hash_rgn (FILE *pFl, BS_FOFST_T pStt, BS_FOFST_T pEnd, char *pBuf)
+{
+  unsigned long hash = BDI_SUM_HASH0;
+  size_t sz;
+  BS_DO_E_OUT (bsfseek_goto (pFl, pStt))
+  while ( pStt < pEnd )
+  {
+    sz = pEnd - pStt < S_BUFSZ ? pEnd - pStt : S_BUFSZ;
+    BS_IF_EN_OUT (fread (pBuf, 1, sz, pFl) != sz, BSE_READ_FILE)
+    hash = bsdiixsum_hash (hash, pBuf, sz);
+    pStt += sz;
+  }
+out:
+  return hash;
+}
+
+/**
+ * <p>Hash IDX head, i.e. bytes before IRT, with zeroed head's checksum.</p>
+ * @param pSum - SUM with offset and sections bounds
+ * @param pIdxFl - IDX file
+ * @return hash
+ * @set errno if error.
+ **/
+static unsigned long
+  s_head_hash (BsDiIxSum *pSum, FILE *pIdxFl)
+{
+  unsigned long hash = BDI_SUM_HASH0;
+  BS_FOFST_T hsOfst = pSum->ofst + S_HEADSUM_OFST;
+  char *buf = NULL;
+  BS_IF_EN_OUT (pSum->ofst < BS_FOFST_0
+    || hsOfst + (BS_FOFST_T) sizeof (unsigned long) > pSum->scts[0], BSE_VALIDATE_ERR)
+  buf = malloc (pSum->scts[0]);
+  BS_IF_EN_OUT (buf == NULL, ENOMEM)
+  BS_DO_E_OUT (bsfseek_goto (pIdxFl, BS_FOFST_0))
+  BS_IF_EN_OUT (fread (buf, 1, pSum->scts[0], pIdxFl) != (size_t) pSum->scts[0],
+                BSE_READ_FILE)
+  memset (buf + hsOfst, 0, sizeof (unsigned long));
+  hash = bsdiixsum_hash (hash, buf, pSum->scts[0]);
+out:
+  if ( buf != NULL )
+        { free (buf); }
+  return hash;
+}
+
+/**
+ * <p>Make sections checksums.</p>
+ * @param pSum - SUM with sections bounds
+ * @param pIdxFl - IDX file
+ * @param pSumsRt - sums to return
+ * @set errno if error.
+ **/
+static void
+  s_scts_sums (BsDiIxSum *pSum, FILE *pIdxFl, unsigned long *pSumsRt)
+{
+  char *buf = malloc (S_BUFSZ);
+  BS_IF_EN_RET (buf == NULL, ENOMEM)
+  for ( int i = 0; i < BDI_SUM_SCTS; i++ )
+  {
+    BS_DO_E_OUT (pSumsRt[i] = s_hash_rgn (pIdxFl, pSum->scts[i], pSum->scts[i + 1], buf))
+  }
+out:
+  free (buf);
+}
+
+/**
+ * <p>Make dictionary's fingerprint, i.e. size, modification time
+ * and hash of BDI_SUM_SMPLS blocks spread over it.</p>
+ * @param pSum - SUM to fill
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void
+  bsdiixsum_dic_fpt (BsDiIxSum *pSum, char *pPth)
+{
+  struct stat st;
+  BS_FOFST_T stp, ofst;
+  size_t sz;
+  FILE *dicFl;
+  char *buf;
+  BS_IF_EN_RET (stat (pPth, &st) != 0, BSE_OPEN_FILE)
+  pSum->dicSz = st.st_size;
+  pSum->mtime = st.st_mtim.tv_sec * 1000000000L + st.st_mtim.tv_nsec;
+  pSum->dicHash = bsdiixsum_hash (BDI_SUM_HASH0, (char*) &pSum->dicSz, BS_FOFST_LEN);
+  dicFl = fopen (pPth, "rb");
+  BS_IF_EN_RET (dicFl == NULL, BSE_OPEN_FILE)
+  buf = malloc (BDI_SUM_SMPLSZ);
+  BS_IF_EN_OUT (buf == NULL, ENOMEM)
+  //the first and the last blocks and evenly spread between them:
+  stp = ( pSum->dicSz - BDI_SUM_SMPLSZ ) / ( BDI_SUM_SMPLS - 1 );
+  if ( stp < BDI_SUM_SMPLSZ )
+        { stp = BDI_SUM_SMPLSZ; }
+  for ( ofst = BS_FOFST_0; ofst < pSum->dicSz; ofst += stp )
+  {
+    BS_DO_E_OUT (bsfseek_goto (dicFl, ofst))
+    sz = fread (buf, 1, BDI_SUM_SMPLSZ, dicFl);
+    BS_IF_EN_OUT (sz == 0 && ferror (dicFl), BSE_READ_FILE)
+    pSum->dicHash = bsdiixsum_hash (pSum->dicHash, buf, sz);
+  }
+out:
+  if ( buf != NULL )
+        { free (buf); }
+  fclose (dicFl);
+}
+
+/**
+ * <p>Write SUM at the current IDX file's position, it's placeholder
+ * that will be overwritten by bsdiixsum_save.</p>
+ * @param pSum - SUM
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixsum_write (BsDiIxSum *pSum, FILE *pIdxFl)
+{
+  pSum->ofst = ftell (pIdxFl);
+  BS_DO_E_RET (bsfwrite_int (&pSum->ver, pIdxFl))
+  BS_DO_E_RET (bsfwrite_bsfoffset (&pSum->dicSz, pIdxFl))
+  BS_DO_E_RET (bsfwrite_long (&pSum->mtime, pIdxFl))
+  BS_DO_E_RET (bsfwrite_ulong (&pSum->dicHash, pIdxFl))
+  for ( int i = 0; i <= BDI_SUM_SCTS; i++ )
+        { BS_DO_E_RET (bsfwrite_bsfoffset (&pSum->scts[i], pIdxFl)) }
+  for ( int i = 0; i < BDI_SUM_SCTS; i++ )
+        { BS_DO_E_RET (bsfwrite_ulong (&pSum->sums[i], pIdxFl)) }
+  BS_DO_E_RET (bsfwrite_ulong (&pSum->headSum, pIdxFl))
+}
+
+/**
+ * <p>Overwrite SUM, then its head's checksum.</p>
+ * @param pSum - SUM
+ * @param pIdxFl - IDX file opened for update
+ * @set errno if error.
+ **/
+static void
+  s_overwrite (BsDiIxSum *pSum, FILE *pIdxFl)
+{
+  BS_FOFST_T ofst = pSum->ofst;
+  pSum->headSum = 0UL;
+  BS_DO_E_RET (bsfseek_goto (pIdxFl, ofst))
+  BS_DO_E_RET (bsdiixsum_write (pSum, pIdxFl))
+  BS_IF_EN_RET (fflush (pIdxFl) != 0, BSE_WRITE_FILE)
+  BS_DO_E_RET (pSum->headSum = s_head_hash (pSum, pIdxFl))
+  BS_DO_E_RET (bsfseek_goto (pIdxFl, ofst + S_HEADSUM_OFST))
+  BS_DO_E_RET (bsfwrite_ulong (&pSum->headSum, pIdxFl))
+  BS_IF_EN_RET (fflush (pIdxFl) != 0, BSE_WRITE_FILE)
+}
+
+/**
+ * <p>Make SUM of written IDX and overwrite its placeholder.
+ * File position is restored.</p>
+ * @param pSum - SUM with offset and sections bounds
+ * @param pIdxFl - IDX file
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void
+  bsdiixsum_save (BsDiIxSum *pSum, FILE *pIdxFl, char *pPth)
+{
+  long pos = ftell (pIdxFl);
+  BS_IF_EN_RET (fflush (pIdxFl) != 0, BSE_WRITE_FILE)
+  pSum->ver = BDI_SUM_VER;
+  BS_DO_E_RET (bsdiixsum_dic_fpt (pSum, pPth))
+  BS_DO_E_RET (s_scts_sums (pSum, pIdxFl, pSum->sums))
+  BS_DO_E_RET (s_overwrite (pSum, pIdxFl))
+  BS_DO_E_RET (bsfseek_goto (pIdxFl, pos))
+}
+
+/**
+ * <p>Read SUM from the current IDX file's position.</p>
+ * @param pSum - SUM to fill
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixsum_load (BsDiIxSum *pSum, FILE *pIdxFl)
+{
+  pSum->ofst = ftell (pIdxFl);
+  BS_DO_E_RET (bsfread_int (&pSum->ver, pIdxFl))
+  BS_DO_E_RET (bsfread_bsfoffset (&pSum->dicSz, pIdxFl))
+  BS_DO_E_RET (bsfread_long (&pSum->mtime, pIdxFl))
+  BS_DO_E_RET (bsfread_ulong (&pSum->dicHash, pIdxFl))
+  for ( int i = 0; i <= BDI_SUM_SCTS; i++ )
+        { BS_DO_E_RET (bsfread_bsfoffset (&pSum->scts[i], pIdxFl)) }
+  for ( int i = 0; i < BDI_SUM_SCTS; i++ )
+        { BS_DO_E_RET (bsfread_ulong (&pSum->sums[i], pIdxFl)) }
+  BS_DO_E_RET (bsfread_ulong (&pSum->headSum, pIdxFl))
+}
+
+/**
+ * <p>Check IDX head's checksum and dictionary's fingerprint.
+ * Corrupted SUM is EBDI_SUM_BAD with warning, but reading error
+ * is reported by errno. File position is restored.</p>
+ * @param pSum - loaded SUM
+ * @param pIdxFl - IDX file
+ * @param pPth - dictionary path
+ * @return check result
+ * @set errno if error.
+ **/
+EBsDiIxSumStt
+  bsdiixsum_check (BsDiIxSum *pSum, FILE *pIdxFl, char *pPth)
+{
+  EBsDiIxSumStt rz = EBDI_SUM_BAD;
+  unsigned long headSum;
+  BsDiIxSum dic;
+  struct stat st;
+  long pos = ftell (pIdxFl);
+  if ( fstat (fileno (pIdxFl), &st) != 0 )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return rz;
+  }
+  for ( int i = 0; i < BDI_SUM_SCTS; i++ )
+  {
+    if ( pSum->scts[0] <= BS_FOFST_0 || pSum->scts[i] > pSum->scts[i + 1]
+           || pSum->scts[i + 1] > st.st_size )
+    {
+      BSLOG_LOG (BSLWARN, "IDX of %s has wrong sections bounds\n", pPth)
+      return rz;
+    }
+  }
+  if ( pSum->ver != BDI_SUM_VER || pSum->ofst < BS_FOFST_0
+         || pSum->ofst + (BS_FOFST_T) BDI_SUM_SZ > pSum->scts[0] )
+  {
+    BSLOG_LOG (BSLWARN, "IDX of %s has wrong SUM's version or offset\n", pPth)
+    return rz;
+  }
+  //reading error isn't wrong checksum:
+  BS_DO_E_OUT (headSum = s_head_hash (pSum, pIdxFl))
+  if ( headSum != pSum->headSum )
+  {
+    BSLOG_LOG (BSLWARN, "IDX of %s has wrong head's checksum\n", pPth)
+    goto out;
+  }
+  BS_DO_E_OUT (bsdiixsum_dic_fpt (&dic, pPth))
+  if ( dic.dicSz == pSum->dicSz && dic.mtime == pSum->mtime
+         && dic.dicHash == pSum->dicHash )
+  {
+    rz = EBDI_SUM_OK;
+  } else {
+    rz = EBDI_SUM_STALE;
+  }
+out:
+  fseek (pIdxFl, pos, SEEK_SET);
+  return rz;
+}
+
+/**
+ * <p>Deep check, i.e. verify IDX sections checksums.
+ * File position is restored.</p>
+ * @param pSum - loaded SUM
+ * @param pIdxFl - IDX file
+ * @return if all sections are intact
+ * @set errno if error.
+ **/
+bool
+  bsdiixsum_check_scts (BsDiIxSum *pSum, FILE *pIdxFl)
+{
+  unsigned long sums[BDI_SUM_SCTS];
+  long pos = ftell (pIdxFl);
+  bool rz = false;
+  BS_DO_E_OUT (s_scts_sums (pSum, pIdxFl, sums))
+  rz = true;
+  for ( int i = 0; i < BDI_SUM_SCTS; i++ )
+  {
+    if ( sums[i] != pSum->sums[i] )
+    {
+      BSLOG_LOG (BSLWARN, "IDX section #%d has wrong checksum\n", i)
+      rz = false;
+    }
+  }
+out:
+  fseek (pIdxFl, pos, SEEK_SET);
+  return rz;
+}
+
+/**
+ * <p>Overwrite saved SUM's dictionary fingerprint and head's checksum,
+ * e.g. when dictionary has been touched without changing.</p>
+ * @param pSum - loaded SUM
+ * @param pIdxPth - IDX path
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void
+  bsdiixsum_save_fpt (BsDiIxSum *pSum, char *pIdxPth, char *pPth)
+{
+  BS_DO_E_RET (bsdiixsum_dic_fpt (pSum, pPth))
+  FILE *idxFl = fopen (pIdxPth, "r+b");
+  BS_IF_EN_RET (idxFl == NULL, BSE_OPEN_FILE)
+  BS_DO_E_OUT (s_overwrite (pSum, idxFl))
+out:
+  fclose (idxFl);
+}
@@ -0,0 +1,152 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ IDX check-summed head's block (SUM).
+ * It's written into IDX head, so opening can trust IDX by reading
+ * just the head instead of validating whole IDX. It holds format version,
+ * dictionary's fingerprint, i.e. its size, modification time and fast hash
+ * of its sampled blocks, sections bounds with their checksums, and the head's
+ * checksum. Sections checksums are verified only by deep validation.</p>
+ * <pre>
+ * int version, int64 DIC size, int64 DIC mtime, uint64 DIC hash,
+ * int64 sections bounds[BDI_SUM_SCTS + 1], uint64 sections sums[BDI_SUM_SCTS],
+ * uint64 head sum - of IDX bytes before IRT with this field zeroed
+ * </pre>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXSUM
+#define BS_DEBUGL_DIIXSUM 30560
+
+#include "stdio.h"
+#include "stdbool.h"
+
+#include "BsBase.h"
+
+//SUM format version:
+#define BDI_SUM_VER 1
+//sections IRT, I2WPT, DWOLT, HWP:
+#define BDI_SUM_SCTS 4
+//hash basis, i.e. hash of nothing:
+#define BDI_SUM_HASH0 14695981039346656037UL
+//DIC hash samples total and size:
+#define BDI_SUM_SMPLS 16
+#define BDI_SUM_SMPLSZ 4096L
+
+//SUM size in IDX file:
+#define BDI_SUM_SZ (sizeof (int) + BS_FOFST_LEN + sizeof (long)\
+  + sizeof (unsigned long) + BS_FOFST_LEN * (BDI_SUM_SCTS + 1)\
+  + sizeof (unsigned long) * (BDI_SUM_SCTS + 1))
+
+/**
+ * <p>SUM.</p>
+ * @member int ver - format version
+ * @member BS_FOFST_T dicSz - dictionary size
+ * @member long mtime - dictionary modification time in nanoseconds
+ * @member unsigned long dicHash - hash of dictionary's sampled blocks
+ * @member BS_FOFST_T scts - sections bounds in IDX file, the first one
+ *   is IRT offset, i.e. head's size, the last one is HWP (with FST and SA)
+ *   end
+ * @member unsigned long sums - sections checksums
+ * @member unsigned long headSum - head's checksum
+ * @member BS_FOFST_T ofst - SUM offset in IDX file or BS_FOFST_NULL
+ **/
+typedef struct {
+  int ver;
+  BS_FOFST_T dicSz;
+  long mtime;
+  unsigned long dicHash;
+  BS_FOFST_T scts[BDI_SUM_SCTS + 1];
+  unsigned long sums[BDI_SUM_SCTS];
+  unsigned long headSum;
+  BS_FOFST_T ofst;
+} BsDiIxSum;
+
+/**
+ * <p>SUM's check result.</p>
+ **/
+typedef enum {
+  EBDI_SUM_OK, //IDX matches dictionary
+  EBDI_SUM_STALE, //dictionary's fingerprint differs
+  EBDI_SUM_BAD //IDX is corrupted
+} EBsDiIxSumStt;
+
+/**
+ * <p>Continue fast hash with given bytes.</p>
+ * @param pHash - hash so far
+ * @param pDt - bytes
+ * @param pSz - bytes total
+ * @return hash
+ **/
+unsigned long bsdiixsum_hash (unsigned long pHash, const char *pDt, size_t pSz);
+
+/**
+ * <p>Make dictionary's fingerprint, i.e. size, modification time
+ * and hash of BDI_SUM_SMPLS blocks spread over it.</p>
+ * @param pSum - SUM to fill
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void bsdiixsum_dic_fpt (BsDiIxSum *pSum, char *pPth);
+
+/**
+ * <p>Write SUM at the current IDX file's position, it's placeholder
+ * that will be overwritten by bsdiixsum_save.</p>
+ * @param pSum - SUM
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixsum_write (BsDiIxSum *pSum, FILE *pIdxFl);
+
+/**
+ * <p>Make SUM of written IDX and overwrite its placeholder.
+ * File position is restored.</p>
+ * @param pSum - SUM with offset and sections bounds
+ * @param pIdxFl - IDX file
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void bsdiixsum_save (BsDiIxSum *pSum, FILE *pIdxFl, char *pPth);
+
+/**
+ * <p>Read SUM from the current IDX file's position.</p>
+ * @param pSum - SUM to fill
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixsum_load (BsDiIxSum *pSum, FILE *pIdxFl);
+
+/**
+ * <p>Check IDX head's checksum and dictionary's fingerprint.
+ * Corrupted SUM is EBDI_SUM_BAD with warning, but reading error
+ * is reported by errno. File position is restored.</p>
+ * @param pSum - loaded SUM
+ * @param pIdxFl - IDX file
+ * @param pPth - dictionary path
+ * @return check result
+ * @set errno if error.
+ **/
+EBsDiIxSumStt bsdiixsum_check (BsDiIxSum *pSum, FILE *pIdxFl, char *pPth);
+
+/**
+ * <p>Deep check, i.e. verify IDX sections checksums.
+ * File position is restored.</p>
+ * @param pSum - loaded SUM
+ * @param pIdxFl - IDX file
+ * @return if all sections are intact
+ * @set errno if error.
+ **/
+bool bsdiixsum_check_scts (BsDiIxSum *pSum, FILE *pIdxFl);
+
+/**
+ * <p>Overwrite saved SUM's dictionary fingerprint and head's checksum,
+ * e.g. when dictionary has been touched without changing.</p>
+ * @param pSum - loaded SUM
+ * @param pIdxPth - IDX path
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void bsdiixsum_save_fpt (BsDiIxSum *pSum, char *pIdxPth, char *pPth);
+#endif
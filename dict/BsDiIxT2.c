@@ -570,6 +570,7 @@ void
   int wsz, lenr;
   //vars init0:
   bschr0 = 0;
+  idxFl = NULL;
   //Head base:
   BS_DO_E_OUT (idxFl = bsdiixheadbs_save ((BsDiIxHeadBs*) pDiIxRm->head, pPth))
   //Audio offset:
@@ -587,7 +588,12 @@ void
   }
   BSLOG_LOG(BSLINFO, "%s with IDXRAM#%p has been successfully saved!\n", pPth, pDiIxRm);
 out:
-  fclose(idxFl);
+  if ( idxFl != NULL )
+  {
+    if ( fclose (idxFl) != 0 && errno == 0 )
+          { errno = BSE_WRITE_FILE; }
+    bsdiixheadbs_save_end (pPth, errno == 0);
+  }
 }
 
 /**
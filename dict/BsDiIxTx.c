@@ -6,17 +6,29 @@ See the LICENSE in the root source folder */
 #include "stdlib.h"
 #include "wctype.h"
 #include "string.h"
+#include "limits.h"
+#include "sys/stat.h"
 
 #include "BsError.h"
 #include "BsFioWrap.h"
 #include "BsDicWordDsl.h"
-#include "BsDiIxTx.h"
+#include "BsDicIwrdsMt.h"
+#include "BsDiIxTxEx.h"
+#include "BsDiIxTxUp.h"
+#include "BsDiIxMm.h"
 
 /**
  * <p>Beigesoft™ text dictionary with index final library.</p>
  * @author Yury Demidenko
  **/
 
+//IDX RAM's IRT words pool capacity for head pHead:
+#define BDI_RM_IRTWRDS_CAP(pHead) ((pHead)->irtSz * ( (pHead)->mxIrWdSz > 0\
+  ? (pHead)->mxIrWdSz : UCHAR_MAX ) + 1)
+
+//IDX RAM's loading buffer size:
+#define BDI_RM_LDBUFSZ 65536
+
 //1. Counsructors/destructors/collection utils:
 /**
  * <p>Dynamic constructor for further loading from IDX.
@@ -34,6 +46,10 @@ BsDiIxHeadTx*
   {
     obj->i2wptSz = BS_IDX_NULL;
     obj->dwoltSz = BS_IDX_NULL;
+    obj->fpt = NULL;
+    obj->flgs = 0;
+    memset (&obj->sum, 0, sizeof (BsDiIxSum));
+    obj->sum.ofst = BS_FOFST_NULL;
     obj->frmt = DFRM_UNKNOWN;
   } else {
     if ( errno == 0 ) { errno = ENOMEM; }
@@ -56,6 +72,10 @@ BsDiIxHeadTx*
 {
   BsDiIxHeadTx *obj = (BsDiIxHeadTx*) bsdiixheadbs_new (sizeof (BsDiIxHeadTx));
   if (obj != NULL) {
+    obj->fpt = NULL;
+    obj->flgs = 0;
+    memset (&obj->sum, 0, sizeof (BsDiIxSum));
+    obj->sum.ofst = BS_FOFST_NULL;
     obj->hirt = malloc (pIrtTots->hirtSz * sizeof(BsDiIxHirtRd*));
     if (obj->hirt == NULL)
     {
@@ -90,7 +110,10 @@ BsDiIxHeadTx*
   bsdiixheadtx_free (BsDiIxHeadTx *pHead)
 {
   if ( pHead != NULL )
-          { bsdiixheadbs_free ((BsDiIxHeadBs*) pHead); }
+  {
+    bsdiixfpt_free (pHead->fpt);
+    bsdiixheadbs_free ((BsDiIxHeadBs*) pHead);
+  }
   return NULL;
 }
 
@@ -107,6 +130,195 @@ void
   bsdiixheadbs_add_hirtrd ((BsDiIxHeadBs*) pHead, pRcd);
 }
 
+/**
+ * <p>Choose the most compact IDX file's encoding for head's totals
+ * and dictionary's size.</p>
+ * @param pHead - head with totals
+ * @param pDicFl - dictionary
+ * @set errno if error.
+ **/
+void
+  bsdiixheadtx_mk_flgs (BsDiIxHeadTx *pHead, FILE *pDicFl)
+{
+  struct stat st;
+  pHead->flgs = BDI_TXFLG_SUM | BDI_TXFLG_UCF | BDI_TXFLG_ALGN;
+  if ( pHead->dwoltSz <= INT_MAX && pHead->i2wptSz <= INT_MAX )
+        { pHead->flgs |= BDI_TXFLG_IDX32; }
+  if ( pDicFl != NULL )
+  {
+    int fd = fileno (pDicFl);
+    if ( fd == -1 || fstat (fd, &st) != 0 )
+    {
+      if ( errno == 0 ) { errno = BSE_READ_FILE; }
+      BSLOG_ERR
+      return;
+    }
+    if ( st.st_size <= UINT_MAX )
+          { pHead->flgs |= BDI_TXFLG_OFS32; }
+  }
+}
+
+/**
+ * <p>Write head's rest totals (after head base) with encoding flags.</p>
+ * @param pHead - head
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixheadtx_write_tots (BsDiIxHeadTx *pHead, FILE *pIdxFl)
+{
+  if ( pHead->flgs != 0 )
+  {
+    BS_IDX_T mrk = BDI_TXFLGS_MARK;
+    BS_DO_E_RET (bsfwrite_bsindex (&mrk, pIdxFl))
+    BS_DO_E_RET (bsfwrite_int (&pHead->flgs, pIdxFl))
+  }
+  if ( pHead->flgs & BDI_TXFLG_SUM )
+  { //placeholder:
+    memset (&pHead->sum, 0, sizeof (BsDiIxSum));
+    BS_DO_E_RET (bsdiixsum_write (&pHead->sum, pIdxFl))
+  }
+  BS_DO_E_RET (bsfwrite_bsindex (&pHead->dwoltSz, pIdxFl))
+  BS_DO_E_RET (bsfwrite_bsindex (&pHead->i2wptSz, pIdxFl))
+}
+
+/**
+ * <p>Make check-summed head's block of written IDX sections (HWP with FST and SA is
+ * the last one and it ends at the current file's position), and overwrite
+ * its placeholder. File position is restored.</p>
+ * @param pHead - head with SUM flag
+ * @param pIdxFl - IDX file
+ * @param pIrtOfst - IRT offset
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void
+  bsdiixheadtx_save_sum (BsDiIxHeadTx *pHead, FILE *pIdxFl,
+                         BS_FOFST_T pIrtOfst, char *pPth)
+{
+  BsDiIxSum *sum = &pHead->sum;
+  if ( !( pHead->flgs & BDI_TXFLG_SUM ) )
+        { return; }
+  sum->scts[0] = pIrtOfst;
+  sum->scts[1] = BDI_TX_SCTOFST (pHead->flgs, sum->scts[0] + pHead->irtSz
+    * ( pHead->mxIrWdSz > 0 ? BDI_IRTRD_FIXED_SIZE (pHead->mxIrWdSz, pHead->flgs) : 0 ));
+  sum->scts[2] = BDI_TX_SCTOFST (pHead->flgs, sum->scts[1]
+                                 + pHead->i2wptSz * BDI_I2WPTRD_SIZE (pHead->flgs));
+  sum->scts[3] = BDI_TX_SCTOFST (pHead->flgs, sum->scts[2]
+                                 + pHead->dwoltSz * BDI_DWOLTRD_SIZE (pHead->flgs));
+  sum->scts[4] = ftell (pIdxFl);
+  BS_IF_EN_RET (sum->scts[3] > sum->scts[4], BSE_ALG_ERR)
+  BS_DO_E_RET (bsdiixsum_save (sum, pIdxFl, pPth))
+}
+
+/**
+ * <p>Write DWOLT or I2WPT index into IDX file.</p>
+ * @param pIdx - index
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixtx_write_idx (BS_IDX_T *pIdx, int pFlgs, FILE *pIdxFl)
+{
+  if ( pFlgs & BDI_TXFLG_IDX32 )
+  {
+    int idx = (int) *pIdx;
+    bsfwrite_int (&idx, pIdxFl);
+  } else {
+    bsfwrite_bsindex (pIdx, pIdxFl);
+  }
+}
+
+/**
+ * <p>Read DWOLT or I2WPT index from IDX file.</p>
+ * @param pIdxRt - pointer to return index
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixtx_read_idx (BS_IDX_T *pIdxRt, int pFlgs, FILE *pIdxFl)
+{
+  if ( pFlgs & BDI_TXFLG_IDX32 )
+  {
+    int idx;
+    BS_DO_E_RET (bsfread_int (&idx, pIdxFl))
+    *pIdxRt = idx;
+  } else {
+    bsfread_bsindex (pIdxRt, pIdxFl);
+  }
+}
+
+/**
+ * <p>Write DWOLT word's offset into IDX file.</p>
+ * @param pOfst - offset in dictionary
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixtx_write_ofst (BS_FOFST_T *pOfst, int pFlgs, FILE *pIdxFl)
+{
+  if ( pFlgs & BDI_TXFLG_OFS32 )
+  {
+    unsigned int ofst = (unsigned int) *pOfst;
+    bsfwrite_uint (&ofst, pIdxFl);
+  } else {
+    bsfwrite_bsfoffset (pOfst, pIdxFl);
+  }
+}
+
+/**
+ * <p>Read DWOLT word's offset from IDX file.</p>
+ * @param pOfstRt - pointer to return offset in dictionary
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixtx_read_ofst (BS_FOFST_T *pOfstRt, int pFlgs, FILE *pIdxFl)
+{
+  if ( pFlgs & BDI_TXFLG_OFS32 )
+  {
+    unsigned int ofst;
+    BS_DO_E_RET (bsfread_uint (&ofst, pIdxFl))
+    *pOfstRt = ofst;
+  } else {
+    bsfread_bsfoffset (pOfstRt, pIdxFl);
+  }
+}
+
+/**
+ * <p>Write zero padding up to the next section's offset into IDX file.</p>
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixtx_write_pad (int pFlgs, FILE *pIdxFl)
+{
+  char zrs[BDI_TX_ALIGN] = { 0 };
+  long pos = ftell (pIdxFl);
+  size_t cnt = BDI_TX_SCTOFST (pFlgs, pos) - pos;
+  if ( cnt > 0 )
+        { BS_IF_EN_RET (fwrite (zrs, 1, cnt, pIdxFl) != cnt, BSE_WRITE_FILE) }
+}
+
+/**
+ * <p>Skip padding up to the next section's offset in IDX file.</p>
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void
+  bsdiixtx_skip_pad (int pFlgs, FILE *pIdxFl)
+{
+  long pos = ftell (pIdxFl);
+  if ( BDI_TX_SCTOFST (pFlgs, pos) != pos )
+        { bsfseek_goto (pIdxFl, BDI_TX_SCTOFST (pFlgs, pos)); }
+}
+
 /**
  * <p>Constructor.</p>
  * @return object or NULL when error
@@ -184,10 +396,37 @@ BsDiIxTx *bsdiixtx_new(FILE *pDicFl, FILE *pIdx_file, BsDiIxHeadTx *pHead) {
     obj->head = pHead;
     obj->dicFl = pDicFl;
     obj->idxFl = pIdx_file;
-    obj->irtOfst = ftell(pIdx_file);
-    BS_IDX_T irtsz = pHead->irtSz * (BDI_IRTRD_FIXED_SIZE(pHead->mxIrWdSz));
-    obj->i2wptOfst = obj->irtOfst + irtsz;
-    obj->dwoltOfst = obj->i2wptOfst + (pHead->i2wptSz * BS_IDX_LEN);
+    obj->mm = NULL;
+    obj->irtSm = NULL;
+    obj->fst = NULL;
+    obj->sa = NULL;
+    int flgs = pHead->flgs;
+    obj->irtOfst = BDI_TX_SCTOFST (flgs, ftell(pIdx_file));
+    BS_IDX_T irtsz = pHead->irtSz * (BDI_IRTRD_FIXED_SIZE(pHead->mxIrWdSz, flgs));
+    obj->i2wptOfst = BDI_TX_SCTOFST (flgs, obj->irtOfst + irtsz);
+    obj->dwoltOfst = BDI_TX_SCTOFST (flgs, obj->i2wptOfst
+                                     + pHead->i2wptSz * (BDI_I2WPTRD_SIZE (flgs)));
+    obj->hwpOfst = BDI_TX_SCTOFST (flgs, obj->dwoltOfst
+                                   + pHead->dwoltSz * (BDI_DWOLTRD_SIZE (flgs)));
+    BS_FOFST_T hwpSz = bsdiixhwp_size (pIdx_file, obj->hwpOfst, pHead->dwoltSz);
+    obj->fstOfst = BDI_TX_SCTOFST (flgs, obj->hwpOfst + hwpSz);
+    if ( errno != 0 || hwpSz == BS_FOFST_0 )
+    {
+      errno = 0;
+      obj->hwpOfst = BS_FOFST_NULL;
+    }
+    BS_FOFST_T fstSz = bsdiixfst_size (pIdx_file, obj->fstOfst, pHead->dwoltSz);
+    obj->saOfst = BDI_TX_SCTOFST (flgs, obj->fstOfst + fstSz);
+    if ( errno != 0 || fstSz == BS_FOFST_0 )
+    {
+      errno = 0;
+      obj->fstOfst = BS_FOFST_NULL;
+    }
+    if ( bsdiixsa_size (pIdx_file, obj->saOfst, pHead->dwoltSz) == BS_FOFST_0 )
+    {
+      errno = 0;
+      obj->saOfst = BS_FOFST_NULL;
+    }
     BSLOG_LOG(BSLINFO, "Created IDXBASE dicFl#%p idxf#%p irtofst=%ld i2wptofst=%ld dwoltofst=%ld\n", obj->dicFl, obj->idxFl, obj->irtOfst, obj->i2wptOfst, obj->dwoltOfst)
   } else {
     if ( errno == 0 ) { errno = ENOMEM; }
@@ -214,6 +453,10 @@ BsDiIxTx*
     if (pDiIx->idxFl != NULL) {
       fclose(pDiIx->idxFl);
     }
+    bsdiixmm_free (pDiIx->mm);
+    bsdiixirtsm_free (pDiIx->irtSm);
+    free (pDiIx->fst);
+    free (pDiIx->sa);
     if (pDiIx->head != NULL) {
       bsdiixheadtx_free(pDiIx->head);
     }
@@ -223,49 +466,249 @@ BsDiIxTx*
 }
 
 /**
- * <p>Constructor of IDX RAM (in memory) to fill from IDX file or IRTRAW and IWORDSSORT.</p>
+ * <p>Allocate IDX RAM's table.</p>
+ * @param pCnt - records count
+ * @param pSz - record size
+ * @return table or NULL when error
+ * @set errno if error.
+ **/
+static void*
+  s_rm_tbl (BS_IDX_T pCnt, size_t pSz)
+{
+  void *tbl = malloc ((pCnt > BS_IDX_0 ? pCnt : BS_IDX_1) * pSz);
+  BS_IF_EN_RETN (tbl == NULL, ENOMEM)
+  return tbl;
+}
+
+/**
+ * <p>Constructor of IDX RAM (in memory) to fill from IDX file or IRTRAW and IWORDSSORT.
+ * IRT words pool is allocated for fixed size records (irtSz * mxIrWdSz
+ * plus terminator of the last word that fills whole record) or for
+ * the longest float ones, it's shrunk when it's filled.
+ * Indexes and DWOLT offsets tables are 32 bit wide if head's flags
+ * has BDI_TXFLG_IDX32 and BDI_TXFLG_OFS32, IRT words offsets ones
+ * if words pool capacity fits uint32.</p>
  * @param pDicFl - dictionary
  * @param pHead - idx-head with totals and not-yet filled HIRT
  * @return object or NULL when error
  * @set errno if error.
  **/
-BsDiIxTxRm *bsdiixtxrm_new(FILE *pDicFl, BsDiIxHeadTx *pHead) {
-  BsDiIxTxRm *obj = malloc(sizeof(BsDiIxTxRm));
-  if (obj != NULL) {
-    obj->irt = malloc(pHead->irtSz * sizeof(BsDicIdxIrtRd*));
-    if (obj->irt == NULL) {
-      obj = bsdiixtxrm_destroy(obj);
-      goto out;
-    }
-    obj->i2wpt = malloc(pHead->i2wptSz * sizeof(BS_IDX_T));
-    if (obj->i2wpt == NULL) {
-      obj = bsdiixtxrm_destroy(obj);
-      goto out;
-    }
-    obj->dwolt = malloc(pHead->dwoltSz * sizeof(BsDcIxDwoltRd*));
-    if (obj->dwolt == NULL) {
-      obj = bsdiixtxrm_destroy(obj);
-      goto out;
-    }
-    BS_IDX_T l;
-    for (l = BS_IDX_0; l < pHead->irtSz; l++) {
-      obj->irt[l] = NULL;
-    }
-    for (l = BS_IDX_0; l < pHead->i2wptSz; l++) {
-      obj->i2wpt[l] = BS_IDX_NULL;
-    }
-    for (l = BS_IDX_0; l < pHead->dwoltSz; l++) {
-      obj->dwolt[l] = NULL;
+BsDiIxTxRm*
+  bsdiixtxrm_new (FILE *pDicFl, BsDiIxHeadTx *pHead)
+{
+  BsDiIxTxRm *obj = calloc (1, sizeof (BsDiIxTxRm));
+  BS_IF_EN_RETN (obj == NULL, ENOMEM)
+  obj->flgs = pHead->flgs & (BDI_TXFLG_IDX32 | BDI_TXFLG_OFS32);
+  if ( BDI_RM_IRTWRDS_CAP (pHead) <= UINT32_MAX )
+        { obj->flgs |= BDI_RMFLG_WOFS32; }
+  size_t idxLen = BDI_RM_IDXLEN (obj->flgs);
+  BS_DO_E_OUTE (obj->irtWrds = s_rm_tbl (BDI_RM_IRTWRDS_CAP (pHead), BS_CHAR_LEN))
+  BS_DO_E_OUTE (obj->irtWrdOfsts = s_rm_tbl (pHead->irtSz,
+                                             BDI_RM_WOFSLEN (obj->flgs)))
+  BS_DO_E_OUTE (obj->irtDwSts = s_rm_tbl (pHead->irtSz, idxLen))
+  BS_DO_E_OUTE (obj->irtI2Qns = s_rm_tbl (pHead->irtSz, BS_SMALL_LEN))
+  BS_DO_E_OUTE (obj->irtI2Sts = s_rm_tbl (pHead->irtSz, idxLen))
+  BS_DO_E_OUTE (obj->i2wpt = s_rm_tbl (pHead->i2wptSz, idxLen))
+  BS_DO_E_OUTE (obj->dwoltOfsts = s_rm_tbl (pHead->dwoltSz,
+                                            BDI_RM_OFSLEN (obj->flgs)))
+  BS_DO_E_OUTE (obj->dwoltLens = s_rm_tbl (pHead->dwoltSz, BS_SMALL_LEN))
+  BS_IDX_T l;
+  for ( l = BS_IDX_0; l < pHead->i2wptSz; l++ )
+        { BDI_RM_SET_IDX (obj, obj->i2wpt, l, BS_IDX_NULL); }
+  for ( l = BS_IDX_0; l < pHead->dwoltSz; l++ )
+  {
+    BDI_RM_SET_DWOFS (obj, l, BS_FOFST_NULL);
+    obj->dwoltLens[l] = BS_SMALL_NULL;
+  }
+  obj->head = pHead;
+  obj->dicFl = pDicFl;
+  return obj;
+
+oute:
+  return bsdiixtxrm_destroy (obj);
+}
+
+/**
+ * <p>Shrink IRT words pool to its filled size.</p>
+ * @param pDiIxRm IDX RAM
+ * @param pSz - filled size
+ **/
+static void
+  s_rm_shrink_wrds (BsDiIxTxRm *pDiIxRm, BS_IDX_T pSz)
+{
+  BS_CHAR_T *wrds = realloc (pDiIxRm->irtWrds, (pSz > BS_IDX_0 ? pSz : BS_IDX_1) * BS_CHAR_LEN);
+  if ( wrds != NULL ) //otherwise it's still the bigger one
+        { pDiIxRm->irtWrds = wrds; }
+}
+
+/**
+ * <p>Fill Eytzinger ordered IRTEZ from sorted keys by in-order walking.</p>
+ * @param pIrtEz - IRTEZ to fill
+ * @param pKeys - sorted keys
+ * @param pSts - sorted keys IRT starts
+ * @param pEns - sorted keys IRT ends
+ * @param pI - next sorted key
+ * @param pK - node, 1-based
+ * @return next sorted key
+ **/
+static int
+  s_irtez_fill (BsDiIxIrtEz *pIrtEz, BS_CHAR_T *pKeys, BS_IDX_T *pSts,
+                BS_IDX_T *pEns, int pI, int pK)
+{
+  if ( pK <= pIrtEz->sz )
+  {
+    pI = s_irtez_fill (pIrtEz, pKeys, pSts, pEns, pI, 2 * pK);
+    pIrtEz->keys[pK] = pKeys[pI];
+    pIrtEz->irtSts[pK] = pSts[pI];
+    pIrtEz->irtEns[pK] = pEns[pI];
+    pI = s_irtez_fill (pIrtEz, pKeys, pSts, pEns, pI + 1, 2 * pK + 1);
+  }
+  return pI;
+}
+
+/**
+ * <p>Make IRTEZ from filled IRT of IDX RAM.</p>
+ * @param pDiIxRm - IDX RAM with filled IRT
+ * @param pIrtSz - IRT size
+ * @return object or NULL when error or if IRT isn't ordered by first chars
+ * @set errno if error.
+ **/
+BsDiIxIrtEz*
+  bsdiixirtez_new (BsDiIxTxRm *pDiIxRm, BS_IDX_T pIrtSz)
+{
+  //vars:
+  BsDiIxIrtEz *obj;
+  BS_CHAR_T *keys, fchar;
+  BS_IDX_T *sts, *ens, l;
+  int sz;
+  //code:
+  obj = NULL; keys = NULL; sts = NULL; ens = NULL;
+  //distinct first chars total:
+  for ( l = BS_IDX_0, sz = 0; l < pIrtSz; l++ )
+  {
+    fchar = *BDI_RM_IRTWRD (pDiIxRm, l);
+    if ( fchar == 0 || ( l > BS_IDX_0
+                         && fchar < *BDI_RM_IRTWRD (pDiIxRm, l - 1) ) )
+    {
+      BSLOG_LOG (BSLWARN, "IRT isn't ordered by first chars, IRT#"BS_IDX_FMT"\n", l)
+      return NULL;
     }
-    obj->head = pHead;
-    obj->dicFl = pDicFl;
+    if ( l == BS_IDX_0 || fchar != *BDI_RM_IRTWRD (pDiIxRm, l - 1) )
+          { sz++; }
   }
-out:
-  if (obj == NULL) {
-    if ( errno == 0 ) { errno = ENOMEM; }
-    BSLOG_ERR
+  if ( sz == 0 )
+          { return NULL; }
+  keys = malloc (sz * BS_CHAR_LEN);
+  BS_IF_EN_OUTE (keys == NULL, ENOMEM)
+  sts = malloc (sz * BS_IDX_LEN);
+  BS_IF_EN_OUTE (sts == NULL, ENOMEM)
+  ens = malloc (sz * BS_IDX_LEN);
+  BS_IF_EN_OUTE (ens == NULL, ENOMEM)
+  for ( l = BS_IDX_0, sz = 0; l < pIrtSz; l++ )
+  {
+    fchar = *BDI_RM_IRTWRD (pDiIxRm, l);
+    if ( l == BS_IDX_0 || fchar != keys[sz - 1] )
+    {
+      keys[sz] = fchar;
+      sts[sz++] = l;
+    }
+    ens[sz - 1] = l;
   }
+  obj = calloc (1, sizeof (BsDiIxIrtEz));
+  BS_IF_EN_OUTE (obj == NULL, ENOMEM)
+  obj->sz = sz;
+  obj->keys = malloc ((sz + 1) * BS_CHAR_LEN);
+  BS_IF_EN_OUTE (obj->keys == NULL, ENOMEM)
+  obj->irtSts = malloc ((sz + 1) * BS_IDX_LEN);
+  BS_IF_EN_OUTE (obj->irtSts == NULL, ENOMEM)
+  obj->irtEns = malloc ((sz + 1) * BS_IDX_LEN);
+  BS_IF_EN_OUTE (obj->irtEns == NULL, ENOMEM)
+  obj->keys[0] = 0; obj->irtSts[0] = BS_IDX_NULL; obj->irtEns[0] = BS_IDX_NULL;
+  s_irtez_fill (obj, keys, sts, ens, 0, 1);
+  free (keys); free (sts); free (ens);
   return obj;
+
+oute:
+  free (keys); free (sts); free (ens);
+  return bsdiixirtez_free (obj);
+}
+
+/**
+ * <p>Destructor.</p>
+ * @param pIrtEz - IRTEZ or NULL
+ * @return always NULL
+ **/
+BsDiIxIrtEz*
+  bsdiixirtez_free (BsDiIxIrtEz *pIrtEz)
+{
+  if ( pIrtEz != NULL )
+  {
+    free (pIrtEz->keys);
+    free (pIrtEz->irtSts);
+    free (pIrtEz->irtEns);
+    free (pIrtEz);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Find IRT records range with given first char.</p>
+ * @param pIrtEz - IRTEZ
+ * @param pFchar - first char
+ * @param pIrtEndRt - pointer to return the last IRT record with it
+ * @return the first IRT record with it or BS_IDX_NULL if there is no one
+ **/
+BS_IDX_T
+  bsdiixirtez_find (BsDiIxIrtEz *pIrtEz, BS_CHAR_T pFchar,
+                    BS_IDX_T *pIrtEndRt)
+{
+  int k = 1;
+  //descend to leaf, right if key is less:
+  while ( k <= pIrtEz->sz )
+        { k = 2 * k + ( pIrtEz->keys[k] < pFchar ); }
+  //the last left turn's node is the first not less key:
+  while ( k & 1 )
+        { k >>= 1; }
+  k >>= 1;
+  if ( k == 0 || pIrtEz->keys[k] != pFchar )
+        { return BS_IDX_NULL; }
+  *pIrtEndRt = pIrtEz->irtEns[k];
+  return pIrtEz->irtSts[k];
+}
+
+/**
+ * <p>Finish filled IRT of IDX RAM, i.e. shrink words pool and make IRTEZ.</p>
+ * @param pDiIxRm IDX RAM with head
+ * @param pSz - filled words pool size
+ * @set errno if error.
+ **/
+static void
+  s_rm_irt_done (BsDiIxTxRm *pDiIxRm, BS_IDX_T pSz)
+{
+  s_rm_shrink_wrds (pDiIxRm, pSz);
+  pDiIxRm->irtEz = bsdiixirtez_free (pDiIxRm->irtEz);
+  pDiIxRm->irtEz = bsdiixirtez_new (pDiIxRm, pDiIxRm->head->irtSz);
+}
+
+/**
+ * <p>Free IDX RAM's tables IRT, I2WPT, DWOLT, HWP, FST and SA.</p>
+ * @param pDiIxRm IDX RAM with head
+ **/
+static void
+  s_rm_free_tbls (BsDiIxTxRm *pDiIxRm)
+{
+  free (pDiIxRm->irtWrds); pDiIxRm->irtWrds = NULL;
+  free (pDiIxRm->irtWrdOfsts); pDiIxRm->irtWrdOfsts = NULL;
+  free (pDiIxRm->irtDwSts); pDiIxRm->irtDwSts = NULL;
+  free (pDiIxRm->irtI2Qns); pDiIxRm->irtI2Qns = NULL;
+  free (pDiIxRm->irtI2Sts); pDiIxRm->irtI2Sts = NULL;
+  free (pDiIxRm->i2wpt); pDiIxRm->i2wpt = NULL;
+  free (pDiIxRm->dwoltOfsts); pDiIxRm->dwoltOfsts = NULL;
+  free (pDiIxRm->dwoltLens); pDiIxRm->dwoltLens = NULL;
+  free (pDiIxRm->hwp); pDiIxRm->hwp = NULL;
+  pDiIxRm->irtEz = bsdiixirtez_free (pDiIxRm->irtEz);
+  free (pDiIxRm->fst); pDiIxRm->fst = NULL;
+  free (pDiIxRm->sa); pDiIxRm->sa = NULL;
 }
 
 /**
@@ -284,26 +727,7 @@ BsDiIxTxRm*
     if (pDiIxRm->dicFl != NULL) {
       fclose(pDiIxRm->dicFl);
     }
-    BS_IDX_T l;
-    if (pDiIxRm->irt != NULL) {
-      for (l = 0; l < pDiIxRm->head->irtSz; l++) {
-        if (pDiIxRm->irt[l] != NULL) {
-          bsdicidxirtrd_free(pDiIxRm->irt[l]);
-        }
-      }
-      free(pDiIxRm->irt);
-    }
-    if (pDiIxRm->dwolt != NULL) {
-      for (l = 0; l < pDiIxRm->head->dwoltSz; l++) {
-        if (pDiIxRm->dwolt[l] != NULL) {
-          bsdiixdwoltrd_free(pDiIxRm->dwolt[l]);
-        }
-      }
-      free(pDiIxRm->dwolt);
-    }
-    if (pDiIxRm->i2wpt != NULL) {
-      free(pDiIxRm->i2wpt);
-    }
+    s_rm_free_tbls (pDiIxRm);
     if (pDiIxRm->head != NULL) {
       bsdiixheadtx_free(pDiIxRm->head);
     }
@@ -315,7 +739,7 @@ BsDiIxTxRm*
 //2. Making IDX services:
 
 /**
- * <p>Fills IDX RAM (in memory) HIRT, IRT, I2WPT and DWOLT with data
+ * <p>Fills IDX RAM (in memory) HIRT, IRT, I2WPT, DWOLT with data
  * from IRTRAW and DIWORDSSORTED.</p>
  * @param pDiIxRm IDX RAM.
  * @param p_iwrds - ordered d.i.words array
@@ -325,7 +749,7 @@ BsDiIxTxRm*
 void bsdiixtxrm_fill(BsDiIxTxRm *pDiIxRm, BsDicIwrds *p_iwrds,
   BsDicIdxIrtRaw *p_irtraw) {
   BSDIIXHIRTRDMK_CREATE(hirtrdmk, pDiIxRm->head->ab->chrsTot)
-  BS_IDX_T tcidx = BS_IDX_0, l;
+  BS_IDX_T tcidx = BS_IDX_0, l, wrdsSz = BS_IDX_0;
   for (l = BS_IDX_0; l < pDiIxRm->head->irtSz; l++) {
     if (hirtrdmk.fchar != p_irtraw->vals[l]->idx_subwrd[0]) {
       if (hirtrdmk.fchar != 0) { //next first char
@@ -341,15 +765,15 @@ void bsdiixtxrm_fill(BsDiIxTxRm *pDiIxRm, BsDicIwrds *p_iwrds,
       BS_DO_E_RET(bsdiixhirtrdmk_make(&hirtrdmk, p_irtraw->vals[l]->idx_subwrd[1], l))
     }
     //IRT:
-    BSDICIDXIRTRD_NEW_E_RET(irtrd)
-    irtrd->idx_subwrd = p_irtraw->vals[l]->idx_subwrd;
-    irtrd->idx_subwrd_size = p_irtraw->vals[l]->idx_subwrd_size;
-    p_irtraw->vals[l]->idx_subwrd = NULL;
-    irtrd->dwolt_start = p_irtraw->vals[l]->dwolt_start;
-    irtrd->i2wpt_quantity = p_irtraw->vals[l]->i2wpt_quantity;
-    pDiIxRm->irt[l] = irtrd;
-    if (irtrd->i2wpt_quantity > 0) {
-      irtrd->i2wpt_start = tcidx;
+    BDI_RM_SET_IRTWOFS (pDiIxRm, l, wrdsSz);
+    for (int i = 0; i < p_irtraw->vals[l]->idx_subwrd_size; i++) {
+      pDiIxRm->irtWrds[wrdsSz++] = p_irtraw->vals[l]->idx_subwrd[i];
+    }
+    BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->irtDwSts, l, p_irtraw->vals[l]->dwolt_start);
+    pDiIxRm->irtI2Qns[l] = p_irtraw->vals[l]->i2wpt_quantity;
+    BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->irtI2Sts, l, BS_IDX_NULL);
+    if (pDiIxRm->irtI2Qns[l] > 0) {
+      BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->irtI2Sts, l, tcidx);
       //I2WPT:
       int i2wptquani = p_irtraw->vals[l]->i2wpt_quantity;
       for (int i = 0; i < i2wptquani; i++) {
@@ -358,11 +782,12 @@ void bsdiixtxrm_fill(BsDiIxTxRm *pDiIxRm, BsDicIwrds *p_iwrds,
           BSLOG_LOG(BSLERROR, "I2WPT full on l="BS_IDX_FMT", idx="BS_IDX_FMT"\n", l, tcidx);
           return;
         }
-        pDiIxRm->i2wpt[tcidx] = p_irtraw->vals[l]->i2wpt_dwolt_idx[i];
+        BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->i2wpt, tcidx, p_irtraw->vals[l]->i2wpt_dwolt_idx[i]);
         tcidx++;
       }
     }
   }
+  BS_DO_E_RET (s_rm_irt_done (pDiIxRm, wrdsSz))
   //last accumulated HIRT data:
   BSDIIXHIRTRD_NEW_FILL_E_RET(hirtRd, &hirtrdmk)
   BS_DO_E_RET(bsdiixheadtx_add_hirtrd(pDiIxRm->head, hirtRd))
@@ -375,10 +800,8 @@ void bsdiixtxrm_fill(BsDiIxTxRm *pDiIxRm, BsDicIwrds *p_iwrds,
         BSLOG_LOG(BSLERROR, "DWOLT full on l="BS_IDX_FMT", idx="BS_IDX_FMT"\n", l, tcidx);
         return;
       }
-      BSDICIDXDWOLTRD_E_RET(dwoltrd)
-      dwoltrd->offset_dword = p_iwrds->vals[l]->offset_dword;
-      dwoltrd->length_dword = p_iwrds->vals[l]->length_dword;
-      pDiIxRm->dwolt[tcidx] = dwoltrd;
+      BDI_RM_SET_DWOFS (pDiIxRm, tcidx, p_iwrds->vals[l]->offset_dword);
+      pDiIxRm->dwoltLens[tcidx] = p_iwrds->vals[l]->length_dword;
       tcidx++;
     }
   }
@@ -411,7 +834,8 @@ void bsdiixtxrm_validate(BsDiIxTxRm *pDiIxRm) {
     BSLOG_LOG(BSLERROR, "IRTRAM-head-AB == NULL\n")
     return;
   }
-  if (pDiIxRm->irt == NULL) {
+  if (pDiIxRm->irtWrds == NULL || pDiIxRm->irtWrdOfsts == NULL || pDiIxRm->irtDwSts == NULL
+        || pDiIxRm->irtI2Qns == NULL || pDiIxRm->irtI2Sts == NULL) {
     errno = BSE_VALIDATE_ERR;
     BSLOG_LOG(BSLERROR, "IDXRAM-irt == NULL\n")
     return;
@@ -421,7 +845,7 @@ void bsdiixtxrm_validate(BsDiIxTxRm *pDiIxRm) {
     BSLOG_LOG(BSLERROR, "IRTRAM-i2wpt == NULL\n")
     return;
   }
-  if (pDiIxRm->dwolt == NULL) {
+  if (pDiIxRm->dwoltOfsts == NULL || pDiIxRm->dwoltLens == NULL) {
     errno = BSE_VALIDATE_ERR;
     BSLOG_LOG(BSLERROR, "IRTRAM-dwolt == NULL\n")
     return;
@@ -429,54 +853,44 @@ void bsdiixtxrm_validate(BsDiIxTxRm *pDiIxRm) {
   BS_DO_E_RET (bsdicidxhirt_validate ( pDiIxRm->head->hirt, pDiIxRm->head->hirtSz, pDiIxRm->head->ab))
   BS_IDX_T l, i2wpt_idx_curr = BS_IDX_0;
   for (l = BS_IDX_0; l < pDiIxRm->head->irtSz; l++) {
-    if (pDiIxRm->irt[l] == NULL) {
-      errno = BSE_VALIDATE_ERR;
-      BSLOG_LOG(BSLERROR, "IDXRAM-irt["BS_IDX_FMT"] == NULL\n", l)
-      return;
-    }
-    if (pDiIxRm->irt[l]->idx_subwrd == NULL) {
+    if (BDI_RM_IRTWRD(pDiIxRm, l)[0] == 0) {
       errno = BSE_VALIDATE_ERR;
-      BSLOG_LOG(BSLERROR, "IDXRAM-irt["BS_IDX_FMT"]-idx_subwrd == NULL\n", l)
+      BSLOG_LOG(BSLERROR, "IDXRAM-irt["BS_IDX_FMT"]-idx_subwrd is empty\n", l)
       return;
     }
-    if (pDiIxRm->irt[l]->dwolt_start == BS_IDX_NULL && pDiIxRm->irt[l]->i2wpt_quantity <= 0) {
+    if (BDI_RM_DWST (pDiIxRm, l) == BS_IDX_NULL && pDiIxRm->irtI2Qns[l] <= 0) {
       errno = BSE_VALIDATE_ERR;
       BSLOG_LOG(BSLERROR, "IDXRAM-irt["BS_IDX_FMT"]-dwolt_start == NULL && i2wpt_quantity <= 0\n", l)
       return;
     }
-    if (pDiIxRm->irt[l]->i2wpt_start == BS_IDX_NULL && pDiIxRm->irt[l]->i2wpt_quantity > 0) {
+    if (BDI_RM_I2ST (pDiIxRm, l) == BS_IDX_NULL && pDiIxRm->irtI2Qns[l] > 0) {
       errno = BSE_VALIDATE_ERR;
       BSLOG_LOG(BSLERROR, "IDXRAM-irt["BS_IDX_FMT"]-i2wpt_start == NULL && i2wpt_quantity > 0\n", l)
       return;
     }
-    if (pDiIxRm->irt[l]->i2wpt_quantity > 0) {
-      if (pDiIxRm->irt[l]->i2wpt_start != i2wpt_idx_curr) {
+    if (pDiIxRm->irtI2Qns[l] > 0) {
+      if (BDI_RM_I2ST (pDiIxRm, l) != i2wpt_idx_curr) {
         errno = BSE_VALIDATE_ERR;
-        BSLOG_LOG(BSLERROR, "IDXRAM-irt["BS_IDX_FMT"]-i2wpt_start is "BS_IDX_FMT", must be "BS_IDX_FMT"\n", l, pDiIxRm->irt[l]->i2wpt_start, i2wpt_idx_curr)
+        BSLOG_LOG(BSLERROR, "IDXRAM-irt["BS_IDX_FMT"]-i2wpt_start is "BS_IDX_FMT", must be "BS_IDX_FMT"\n", l, BDI_RM_I2ST (pDiIxRm, l), i2wpt_idx_curr)
         return;
       }
-      i2wpt_idx_curr += pDiIxRm->irt[l]->i2wpt_quantity;
+      i2wpt_idx_curr += pDiIxRm->irtI2Qns[l];
     }
   }
   for (l = BS_IDX_0; l < pDiIxRm->head->i2wptSz; l++) {
-    if (pDiIxRm->i2wpt[l] == BS_IDX_NULL) {
+    if (BDI_RM_I2WPT (pDiIxRm, l) == BS_IDX_NULL) {
       errno = BSE_VALIDATE_ERR;
       BSLOG_LOG(BSLERROR, "IRTRAM-i2wpt["BS_IDX_FMT"] == NULL\n", l)
       return;
     }
   }
   for (l = BS_IDX_0; l < pDiIxRm->head->dwoltSz; l++) {
-    if (pDiIxRm->dwolt[l] == NULL) {
-      errno = BSE_VALIDATE_ERR;
-      BSLOG_LOG(BSLERROR, "IRTRAM-dwolt["BS_IDX_FMT"] == NULL\n", l)
-      return;
-    }
-    if (pDiIxRm->dwolt[l]->offset_dword == BS_IDX_NULL) {
+    if (BDI_RM_DWOFS (pDiIxRm, l) == BS_FOFST_NULL) {
       errno = BSE_VALIDATE_ERR;
       BSLOG_LOG(BSLERROR, "IRTRAM-dwolt["BS_IDX_FMT"]-offset_dword == NULL\n", l)
       return;
     }
-    if (pDiIxRm->dwolt[l]->length_dword == BS_SMALL_NULL) {
+    if (pDiIxRm->dwoltLens[l] == BS_SMALL_NULL) {
       errno = BSE_VALIDATE_ERR;
       BSLOG_LOG(BSLERROR, "IRTRAM-dwolt["BS_IDX_FMT"]-length_dword == NULL\n", l)
       return;
@@ -486,71 +900,259 @@ void bsdiixtxrm_validate(BsDiIxTxRm *pDiIxRm) {
 }
 
 /**
- * <p>Save (write/overwrite) IDX RAM (in memory) into file.</p>
+ * <p>Write IDX RAM (in memory) into new IDX file.</p>
  * @param pDiIxRm IDX RAM.
  * @param pPth - dictionary path.
+ * @param pIrtOfstRt - pointer to return IRT offset
+ * @return opened IDX file or NULL when error
  * @set errno if error.
  **/
-void
-  bsdiixtxrm_save (BsDiIxTxRm *pDiIxRm, char *pPth)
+static FILE*
+  s_rm_write (BsDiIxTxRm *pDiIxRm, char *pPth, BS_FOFST_T *pIrtOfstRt)
 {
   //vars:
   FILE *idxFl;
-  BS_CHAR_T bschr0;
-  BS_IDX_T l;
-  int lenr;
+  BS_CHAR_T bschr0, *wrd;
+  BS_IDX_T l, idx;
+  int lenr, flgs, wsz;
+  unsigned char iwsz;
+  BS_FOFST_T hwpOfst, ofst;
+  BsDiIxHwpMk *hwpMk;
   //vars init0:
   bschr0 = 0;
+  hwpMk = NULL;
+  BS_DO_E_RETN (bsdiixheadtx_mk_flgs (pDiIxRm->head, pDiIxRm->dicFl))
+  flgs = pDiIxRm->head->flgs;
   //Head base:
-  BS_DO_E_OUT (idxFl = bsdiixheadbs_save ((BsDiIxHeadBs*) pDiIxRm->head, pPth))
+  BS_DO_E_RETN (idxFl = bsdiixheadbs_save ((BsDiIxHeadBs*) pDiIxRm->head, pPth))
   //rest of totals:
-  BS_DO_E_OUT (bsfwrite_bsindex (&pDiIxRm->head->dwoltSz, idxFl))
-  BS_DO_E_OUT (bsfwrite_bsindex (&pDiIxRm->head->i2wptSz, idxFl))
+  BS_DO_E_OUTE (bsdiixheadtx_write_tots (pDiIxRm->head, idxFl))
+  BS_DO_E_OUTE (bsdiixtx_write_pad (flgs, idxFl))
+  *pIrtOfstRt = ftell (idxFl);
   //IRT:
   for ( l = BS_IDX_0; l < pDiIxRm->head->irtSz; l++ )
   {
+    wrd = BDI_RM_IRTWRD (pDiIxRm, l);
+    wsz = bsdicidx_istr_len (wrd) + 1;
     if ( pDiIxRm->head->mxIrWdSz == 0 )
     {
-      BS_DO_E_OUT (bsfwrite_uchar (&pDiIxRm->irt[l]->idx_subwrd_size, idxFl))
+      BS_IF_EN_OUTE (wsz > UCHAR_MAX, BSE_INTEGER_OVERFLOW)
+      iwsz = wsz;
+      BS_DO_E_OUTE (bsfwrite_uchar (&iwsz, idxFl))
     }
-    BS_DO_E_OUT (bsfwrite_bschars (pDiIxRm->irt[l]->idx_subwrd, pDiIxRm->irt[l]->idx_subwrd_size, idxFl))
+    BS_DO_E_OUTE (bsfwrite_bschars (wrd, wsz, idxFl))
     if ( pDiIxRm->head->mxIrWdSz > 0 )
     {
-      lenr = pDiIxRm->head->mxIrWdSz - pDiIxRm->irt[l]->idx_subwrd_size;
+      lenr = pDiIxRm->head->mxIrWdSz - wsz;
       if ( lenr > 0 )
-            { BS_DO_E_OUT (bsfwrite_bscharn(&bschr0, lenr, idxFl)) }
+            { BS_DO_E_OUTE (bsfwrite_bscharn(&bschr0, lenr, idxFl)) }
     }
-    BS_DO_E_OUT (bsfwrite_bsindex (&pDiIxRm->irt[l]->dwolt_start, idxFl))
-    BS_DO_E_OUT (bsfwrite_bssmall (&pDiIxRm->irt[l]->i2wpt_quantity, idxFl))
-    BS_DO_E_OUT (bsfwrite_bsindex (&pDiIxRm->irt[l]->i2wpt_start, idxFl))
+    idx = BDI_RM_DWST (pDiIxRm, l);
+    BS_DO_E_OUTE (bsdiixtx_write_idx (&idx, flgs, idxFl))
+    BS_DO_E_OUTE (bsfwrite_bssmall (&pDiIxRm->irtI2Qns[l], idxFl))
+    idx = BDI_RM_I2ST (pDiIxRm, l);
+    BS_DO_E_OUTE (bsdiixtx_write_idx (&idx, flgs, idxFl))
   }
   //I2WPT:
+  BS_DO_E_OUTE (bsdiixtx_write_pad (flgs, idxFl))
   for ( l = BS_IDX_0; l < pDiIxRm->head->i2wptSz; l++ )
   {
-    BS_DO_E_OUT (bsfwrite_bsindex (&pDiIxRm->i2wpt[l], idxFl))
+    idx = BDI_RM_I2WPT (pDiIxRm, l);
+    BS_DO_E_OUTE (bsdiixtx_write_idx (&idx, flgs, idxFl))
   }
   //DWOLT:
+  BS_DO_E_OUTE (bsdiixtx_write_pad (flgs, idxFl))
   for ( l = BS_IDX_0; l < pDiIxRm->head->dwoltSz; l++ )
   {
-    BS_DO_E_OUT (bsfwrite_bsfoffset (&pDiIxRm->dwolt[l]->offset_dword, idxFl))
-    BS_DO_E_OUT (bsfwrite_bssmall (&pDiIxRm->dwolt[l]->length_dword, idxFl))
+    ofst = BDI_RM_DWOFS (pDiIxRm, l);
+    BS_DO_E_OUTE (bsdiixtx_write_ofst (&ofst, flgs, idxFl))
+    BS_DO_E_OUTE (bsfwrite_bssmall (&pDiIxRm->dwoltLens[l], idxFl))
+  }
+  //HWP, the current one in memory is already made by DWOLT:
+  BS_DO_E_OUTE (bsdiixtx_write_pad (flgs, idxFl))
+  hwpOfst = ftell (idxFl);
+  if ( pDiIxRm->hwp != NULL && bsdiixhwp_is_exact (pDiIxRm->hwp) )
+  {
+    BS_FOFST_T hwpSz = bsdiixhwp_mem_size (pDiIxRm->hwp, pDiIxRm->head->dwoltSz);
+    BS_IF_EN_OUTE (fwrite (pDiIxRm->hwp, 1, hwpSz, idxFl) != (size_t) hwpSz, BSE_WRITE_FILE)
+  } else if ( pDiIxRm->dicFl != NULL ) {
+    BS_DO_E_OUTE (hwpMk = bsdiixhwpmk_new (idxFl, pDiIxRm->dicFl, pDiIxRm->head->ab, pDiIxRm->head->dwoltSz))
+    for ( l = BS_IDX_0; l < pDiIxRm->head->dwoltSz; l++ )
+    {
+      BS_DO_E_OUTE (bsdiixhwpmk_add (hwpMk, BDI_RM_DWOFS (pDiIxRm, l), pDiIxRm->dwoltLens[l]))
+    }
+    BS_DO_E_OUTE (bsdiixhwpmk_end (hwpMk))
+    hwpMk = bsdiixhwpmk_free (hwpMk);
+  }
+  //FST:
+  if ( pDiIxRm->fst != NULL )
+  {
+    BS_DO_E_OUTE (bsdiixtx_write_pad (flgs, idxFl))
+    BS_DO_E_OUTE (bsdiixfst_write (pDiIxRm->fst, idxFl))
+  }
+  //SA:
+  if ( pDiIxRm->sa != NULL )
+  {
+    BS_DO_E_OUTE (bsdiixtx_write_pad (flgs, idxFl))
+    BS_DO_E_OUTE (bsdiixsa_write (pDiIxRm->sa, idxFl))
+  }
+  BS_DO_E_OUTE (bsdiixheadtx_save_sum (pDiIxRm->head, idxFl, *pIrtOfstRt, pPth))
+  //FPT:
+  if ( pDiIxRm->head->fpt != NULL )
+        { BS_DO_E_OUTE (bsdiixfpt_save (pDiIxRm->head->fpt, idxFl)) }
+  BS_IF_EN_OUTE (fflush (idxFl) != 0, BSE_WRITE_FILE)
+  BS_DO_E_OUTE (bsdiixheadbs_save_end (pPth, true))
+  if ( pDiIxRm->hwp == NULL || !bsdiixhwp_is_exact (pDiIxRm->hwp) )
+  {
+    free (pDiIxRm->hwp);
+    BS_DO_E_OUTE (pDiIxRm->hwp = bsdiixhwp_load (idxFl, hwpOfst, pDiIxRm->head->dwoltSz))
   }
   BSLOG_LOG(BSLINFO, "%s with IDXRAM#%p has been successfully saved!\n", pPth, pDiIxRm);
-out:
-  fclose(idxFl);
+  return idxFl;
+
+oute:
+  bsdiixhwpmk_free (hwpMk);
+  fclose (idxFl);
+  bsdiixheadbs_save_end (pPth, false);
+  return NULL;
 }
 
 /**
- * <p>Create IDX RAM (in memory).</p>
+ * <p>Save (write/overwrite) IDX RAM (in memory) into file.</p>
+ * @param pDiIxRm IDX RAM.
+ * @param pPth - dictionary path.
+ * @set errno if error.
+ **/
+void
+  bsdiixtxrm_save (BsDiIxTxRm *pDiIxRm, char *pPth)
+{
+  BS_FOFST_T irtOfst;
+  BS_DO_E_RET (FILE *idxFl = s_rm_write (pDiIxRm, pPth, &irtOfst))
+  fclose (idxFl);
+}
+
+/**
+ * <p>Save (write/overwrite) IDX RAM (in memory) into file, then hand over
+ * its head and dictionary to IDX in file object without reloading saved file.
+ * IDX RAM is destroyed when success, otherwise it's still client's one.</p>
+ * @param pDiIxRm IDX RAM.
+ * @param pPth - dictionary path.
+ * @return IDX in file or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxTx*
+  bsdiixtxrm_save_tx (BsDiIxTxRm *pDiIxRm, char *pPth)
+{
+  //vars:
+  BsDiIxTx *diIx;
+  FILE *idxFl;
+  BS_FOFST_T irtOfst;
+  //code:
+  BS_DO_E_RETN (idxFl = s_rm_write (pDiIxRm, pPth, &irtOfst))
+  BS_DO_E_OUTE (bsfseek_goto (idxFl, irtOfst))
+  BS_DO_E_OUTE (diIx = bsdiixtx_new (pDiIxRm->dicFl, idxFl, pDiIxRm->head))
+  //the rest of IDX RAM without handed over ones:
+  s_rm_free_tbls (pDiIxRm);
+  free (pDiIxRm);
+  BSLOG_LOG(BSLINFO, "IDXRAM has been handed over to IDX#%p\n", diIx);
+  return diIx;
+
+oute:
+  fclose (idxFl);
+  return NULL;
+}
+
+/**
+ * <p>Read dictionary name from its head, otherwise it's file name.</p>
+ * @param pDicFl - opened dictionary
+ * @param pFrmt - dictionary format
+ * @param pPth - dictionary path
+ * @return name or NULL when error
+ * @set errno if error.
+ **/
+BsString*
+  bsdiixtx_dic_nme (FILE *pDicFl, EBsDicFrmts pFrmt, char *pPth)
+{
+  char buf[300];
+  if ( pFrmt == DFRM_DSL )
+  {
+    rewind (pDicFl);
+    int rz = fscanf (pDicFl, "%*299[^#]");
+    rz = fscanf (pDicFl, "#NAME \"%299[^\"\n]", buf);
+    if ( rz == 1 )
+            { return bsstring_new (buf); }
+  }
+  //file name:
+  char *nm = strrchr (pPth, '/');
+  if ( nm != NULL )
+  {
+    nm = nm + 1;
+  } else {
+    nm = pPth;
+  }
+  return bsstring_new (nm);
+}
+
+/**
+ * <p>Make headwords FST of ordered i.words if client wants it.
+ * It isn't fatal, IDX is made without FST if it fails.</p>
+ * @param pIwrds - ordered i.words
+ * @param pOpSt - opening state data shared with client
+ * @return FST or NULL if it isn't wanted or failed
+ **/
+char*
+  bsdiixtx_mk_fst (BsDicIwrds *pIwrds, BsDiIxOst* pOpSt)
+{
+  if ( !pOpSt->isFst )
+                { return NULL; }
+  char *fst = bsdiixfst_new (pIwrds);
+  if ( errno != 0 )
+  {
+    BSLOG_LOG (BSLWARN, "FST isn't made, errno=%d\n", errno)
+    errno = 0;
+    free (fst);
+    fst = NULL;
+  }
+  return fst;
+}
+
+/**
+ * <p>Make headwords SA of ordered i.words if client wants it.
+ * It isn't fatal, IDX is made without SA if it fails,
+ * e.g. if headwords text is too big.</p>
+ * @param pIwrds - ordered i.words
+ * @param pOpSt - opening state data shared with client
+ * @return SA or NULL if it isn't wanted or failed
+ **/
+char*
+  bsdiixtx_mk_sa (BsDicIwrds *pIwrds, BsDiIxOst* pOpSt)
+{
+  if ( !pOpSt->isSa )
+                { return NULL; }
+  char *sa = bsdiixsa_new (pIwrds);
+  if ( errno != 0 )
+  {
+    BSLOG_LOG (BSLWARN, "SA isn't made, errno=%d\n", errno)
+    errno = 0;
+    free (sa);
+    sa = NULL;
+  }
+  return sa;
+}
+
+/**
+ * <p>Make IDX RAM (in memory) from whole dictionary or from
+ * given remembered headwords positions.</p>
  * @param pPth - dictionary path.
+ * @param pHwDslMm - mapped dictionary with all headwords positions,
+ *   or NULL to scan whole dictionary
  * @param pOpSt - opening state data shared with client
  * @return object or NULL if stopped or error
  * @set errno if error.
  **/
-BsDiIxTxRm*
-  bsdiixtxrm_create (char *pPth, BsDiIxOst* pOpSt)
+static BsDiIxTxRm*
+  s_make (char *pPth, BsDicDslMm *pHwDslMm, BsDiIxOst* pOpSt)
 {
-  char buf[300];
   BsString *nme = NULL;
   BsDicIwrds *iwrds = NULL;
   BsDicI2wrds *i2wrds = NULL;
@@ -559,15 +1161,19 @@ BsDiIxTxRm*
   BsDicIdxIrtTots *irt_tots = NULL;
   BsDiIxHeadTx *head = NULL;
   BsDiIxTxRm *idx_ram = NULL;
+  BsDicDslMm *dslMm = NULL;
+  BsDiIxFpt *fpt = NULL;
   FILE *dicFl = fopen(pPth, "r");
   BS_IF_EN_RETN (dicFl == NULL, BSE_OPEN_FILE)
   //making IDX:
   //0. Check DIC format
-  //1. making AB - reading all d.words(by iterator) from dicFl, adding them into AB, converting them into idx-string
-  //   to find max_idxword_length, no need to store them
-  //2. making all di.words (in AB coding plus offset original) sorted:
+  //1. making AB - reading all d.words(by iterator) from mapped dicFl, adding them into AB, converting them into idx-string
+  //   to find max_idxword_length, only headwords positions are stored
+  //2. making all di.words (in AB coding plus offset original) sorted from stored headwords,
+  //   big dictionary is split by articles into shards that are processed by several threads
   //3. making IRTRAW with all index words from ordered i/2words
   //4. making IDX-RAM - AB, HIRT, IRT, I2WPT, DWOLT from data in memory IRTRAW and IWRDSSORTEDALL
+  //   plus FPT with chunks duplicates totals
   //0. Check DIC format:
   BS_DO_E_OUTE(EBsDicFrmts dfmt = bsdicfrmt_get_format(dicFl))
   if ( dfmt != DFRM_DSL )
@@ -576,15 +1182,7 @@ BsDiIxTxRm*
     BSLOG_LOG(BSLERROR, "Dic formar#%d unimplemented!\n", dfmt);
     goto oute;
   }  
-  BsDicIdxAb_Iter_Dwrd_Fill *iter_ab_fill = NULL;
-
-  BsDicWord_Iter_Tus *bsdicword_iter_tus = NULL;
-
-  iter_ab_fill = bsdicidxab_iter_dsl_fill;
-
-  bsdicword_iter_tus = bsdicworddsl_iter_tus;
-
-  //1. making AB:
+  //1. making AB and 2. making IWRDSSORTALL by single pass over mapped DIC:
   BS_DO_E_OUTE(idx_ab = bsdicidxab_new(BDI_AB_BUF_INITSIZE))
 
   BSDICIDXABTOTALS_CREATE(ab_tots)
@@ -592,15 +1190,31 @@ BsDiIxTxRm*
   if ( pOpSt->stp )
                 { goto oute; }
 
-  BS_DO_E_OUTE(iter_ab_fill(dicFl, BS_DIC_ENTRY_BUFFER_SIZE, idx_ab, &ab_tots))
+  if ( pHwDslMm == NULL )
+  {
+    BS_DO_E_OUTE(dslMm = bsdicdslmm_new(dicFl))
+    BS_DO_E_OUTE (bsdiciwrdsmt_make (dslMm, BS_DIC_ENTRY_BUFFER_SIZE,
+            bsdiciwrdsmt_thrds_cnt (dslMm), idx_ab, &ab_tots, &iwrds))
+  } else { //only headwords lines are read:
+    BS_CHAR_T istr[BS_DIC_ENTRY_BUFFER_SIZE];
+    BsDicIdxAbFill abFill = { .idx_ab=idx_ab, .totals=&ab_tots, .idxstr=istr };
+    BS_DO_E_OUTE (bsdicdslmm_iter_hw (pHwDslMm, BS_DIC_ENTRY_BUFFER_SIZE,
+        (BsDicWord_Consume_Tus*) bsdicidxab_dwrd_consume_fill, (void*) &abFill))
+    BS_DO_E_OUTE (bsdiciwrds_iter_dslmm (pHwDslMm, BS_DIC_ENTRY_BUFFER_SIZE,
+            &ab_tots, idx_ab, bsdiciwrds_dwrd_csm_apnd, &iwrds))
+  }
 
-  if ( pOpSt->stp )
-                { goto oute; }
+  BS_DO_E_OUTE (fpt = bsdiixfpt_new_make (pHwDslMm == NULL ? dslMm : pHwDslMm,
+                                           BS_DIC_ENTRY_BUFFER_SIZE, pPth))
+  if ( pHwDslMm == NULL )
+  {
+    bsdiixfpt_add_hws (fpt, dslMm->hwOfsts, dslMm->hwSz);
+  } else {
+    bsdiixfpt_add_hws (fpt, pHwDslMm->hwOfsts, pHwDslMm->hwSz);
+  }
+  BS_DO_E_OUTE (bsdiixfpt_sub_dwolt (fpt, iwrds))
 
-  rewind(dicFl);
-  //2. making IWRDSSORTALL
-  BS_DO_E_OUTE (bsdiciwrds_iter(dicFl, BS_DIC_ENTRY_BUFFER_SIZE,
-          &ab_tots, idx_ab, bsdicword_iter_tus, bsdiciwrds_dwrd_csm, &iwrds))
+  dslMm = bsdicdslmm_free (dslMm);
 
   pOpSt->prgr = 60;
 
@@ -628,41 +1242,32 @@ BsDiIxTxRm*
 
   //4. making IDXRAM
   BS_DO_E_OUTE(head = bsdiixheadtx_new_tf(dfmt, iwrds, irt_tots))
+  head->fpt = fpt;
+  fpt = NULL;
   fclose (dicFl); //reopen for further char reading
   dicFl = fopen(pPth, "r");
-  if ( dfmt == DFRM_DSL )
-  {
-    rewind (dicFl);
-    int rz = fscanf (dicFl, "%*299[^#]");
-    rz = fscanf (dicFl, "#NAME \"%299[^\"\n]", buf);
-    if ( rz == 1 )
-            { BS_DO_E_OUTE (nme = bsstring_new (buf)) }
-  }
-  if ( nme == NULL )
-  { //file name:
-    char *nm = strrchr (pPth, '/');
-    if ( nm != NULL )
-    {
-      nm = nm + 1;
-    } else {
-      nm = pPth;
-    }
-    BS_DO_E_OUTE (nme = bsstring_new (nm))
-  }
+  BS_DO_E_OUTE (nme = bsdiixtx_dic_nme (dicFl, dfmt, pPth))
   head->nme = nme;
   nme = NULL;
 
   if ( pOpSt->stp )
                 { goto oute; }
 
+  //RAM tables widths are chosen by flags:
+  BS_DO_E_OUTE(bsdiixheadtx_mk_flgs(head, dicFl))
   BS_DO_E_OUTE(idx_ram = bsdiixtxrm_new(dicFl, head))
 
   BS_DO_E_OUTE(bsdiixtxrm_fill(idx_ram, iwrds, irt))
+  //FST and SA of the same i.words:
+  idx_ram->fst = bsdiixtx_mk_fst (iwrds, pOpSt);
+  idx_ram->sa = bsdiixtx_mk_sa (iwrds, pOpSt);
 
   BSLOG_LOG (BSLINFO, "Created DIC IDX RAM #%p, name=%s\n", idx_ram, idx_ram->head->nme->val)
   return idx_ram;
 
 oute: //or canceled
+  bsdicdslmm_free (dslMm);
+  bsdiixfpt_free (fpt);
   bsstring_free (nme);
   bsdiciwrds_free (iwrds);
   bsdici2wrds_free (i2wrds);
@@ -684,13 +1289,238 @@ oute: //or canceled
   return NULL;
 }
 
+/**
+ * <p>Create IDX RAM (in memory).</p>
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ * @return object or NULL if stopped or error
+ * @set errno if error.
+ **/
+BsDiIxTxRm*
+  bsdiixtxrm_create (char *pPth, BsDiIxOst* pOpSt)
+{
+  return s_make (pPth, NULL, pOpSt);
+}
+
+/**
+ * <p>Make IDX RAM (in memory) from mapped dictionary whose all headwords
+ * positions are already remembered, e.g. kept and re-parsed ones by update.
+ * It reads only headwords lines.</p>
+ * @param pPth - dictionary path.
+ * @param pDslMm - mapped dictionary with headwords positions in offset order
+ * @param pOpSt - opening state data shared with client
+ * @return object or NULL if stopped or error
+ * @set errno if error.
+ **/
+BsDiIxTxRm*
+  bsdiixtxrm_make (char *pPth, BsDicDslMm *pDslMm, BsDiIxOst* pOpSt)
+{
+  return s_make (pPth, pDslMm, pOpSt);
+}
+
+/**
+ * <p>Read IDX RAM's tables with float size IRT records from IDX file
+ * field by field.</p>
+ * @param pDiIxRm IDX RAM with head
+ * @param pIdxFl - IDX file positioned at IRT
+ * @set errno if error.
+ **/
+static void
+  s_rm_read_flds (BsDiIxTxRm *pDiIxRm, FILE *pIdxFl)
+{
+  BsDiIxHeadTx *head = pDiIxRm->head;
+  BS_IDX_T l, idx, wrdsSz = BS_IDX_0;
+  BS_FOFST_T ofst;
+  BS_IDX_T wrdsCap = BDI_RM_IRTWRDS_CAP (head);
+  unsigned char iwsz;
+  int i;
+  //IRT:
+  BS_DO_E_RET (bsdiixtx_skip_pad (head->flgs, pIdxFl))
+  for ( l = BS_IDX_0; l < head->irtSz; l++ )
+  {
+    BS_DO_E_RET (bsfread_uchar (&iwsz, pIdxFl))
+    //word and its terminator must fit into pool:
+    BS_IF_EN_RET (wrdsSz + iwsz >= wrdsCap, BSE_ARR_OUT_MAX_SIZE)
+    BDI_RM_SET_IRTWOFS (pDiIxRm, l, wrdsSz);
+    BS_DO_E_RET (bsfread_bschars (pDiIxRm->irtWrds + wrdsSz, iwsz, pIdxFl))
+    for ( i = 0; i < iwsz && pDiIxRm->irtWrds[wrdsSz + i] != 0; i++ ) ;
+    pDiIxRm->irtWrds[wrdsSz + i] = 0;
+    wrdsSz += i + 1;
+    BS_DO_E_RET (bsdiixtx_read_idx (&idx, head->flgs, pIdxFl))
+    BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->irtDwSts, l, idx);
+    BS_DO_E_RET (bsfread_bssmall (&pDiIxRm->irtI2Qns[l], pIdxFl))
+    BS_DO_E_RET (bsdiixtx_read_idx (&idx, head->flgs, pIdxFl))
+    BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->irtI2Sts, l, idx);
+  }
+  BS_DO_E_RET (s_rm_irt_done (pDiIxRm, wrdsSz))
+  //I2WPT:
+  BS_DO_E_RET (bsdiixtx_skip_pad (head->flgs, pIdxFl))
+  for ( l = BS_IDX_0; l < head->i2wptSz; l++ )
+  {
+    BS_DO_E_RET (bsdiixtx_read_idx (&idx, head->flgs, pIdxFl))
+    BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->i2wpt, l, idx);
+  }
+  //DWOLT:
+  BS_DO_E_RET (bsdiixtx_skip_pad (head->flgs, pIdxFl))
+  for ( l = BS_IDX_0; l < head->dwoltSz; l++ )
+  {
+    BS_DO_E_RET (bsdiixtx_read_ofst (&ofst, head->flgs, pIdxFl))
+    BDI_RM_SET_DWOFS (pDiIxRm, l, ofst);
+    BS_DO_E_RET (bsfread_bssmall (&pDiIxRm->dwoltLens[l], pIdxFl))
+  }
+}
+
+/**
+ * <p>Decode DWOLT or I2WPT index from IDX file's image.</p>
+ * @param pBuf - index in image
+ * @param pFlgs - encoding flags
+ * @return index
+ **/
+static inline BS_IDX_T
+  s_dcd_idx (const char *pBuf, int pFlgs)
+{
+  if ( pFlgs & BDI_TXFLG_IDX32 )
+  {
+    int idx;
+    memcpy (&idx, pBuf, sizeof (int));
+    return idx;
+  }
+  BS_IDX_T idx;
+  memcpy (&idx, pBuf, BS_IDX_LEN);
+  return idx;
+}
+
+/**
+ * <p>Decode DWOLT word's offset from IDX file's image.</p>
+ * @param pBuf - offset in image
+ * @param pFlgs - encoding flags
+ * @return offset
+ **/
+static inline BS_FOFST_T
+  s_dcd_ofst (const char *pBuf, int pFlgs)
+{
+  if ( pFlgs & BDI_TXFLG_OFS32 )
+  {
+    unsigned int ofst;
+    memcpy (&ofst, pBuf, sizeof (unsigned int));
+    return ofst;
+  }
+  BS_FOFST_T ofst;
+  memcpy (&ofst, pBuf, BS_FOFST_LEN);
+  return ofst;
+}
+
+/**
+ * <p>Read next chunk of fixed size records.</p>
+ * @param pBuf - buffer
+ * @param pBufSz - buffer size, not less than record size
+ * @param pRdSz - record size
+ * @param pRest - records left in section
+ * @param pIdxFl - IDX file
+ * @return records read into buffer
+ * @set errno if error.
+ **/
+static BS_IDX_T
+  s_rm_read_chunk (char *pBuf, size_t pBufSz, size_t pRdSz, BS_IDX_T pRest,
+                   FILE *pIdxFl)
+{
+  BS_IDX_T cnt = pBufSz / pRdSz;
+  if ( cnt > pRest )
+        { cnt = pRest; }
+  if ( fread (pBuf, pRdSz, cnt, pIdxFl) != (size_t) cnt )
+  {
+    if ( errno == 0 ) { errno = BSE_READ_FILE; }
+    BSLOG_ERR
+    return BS_IDX_0;
+  }
+  return cnt;
+}
+
+/**
+ * <p>Read IDX RAM's tables with fixed size IRT records from IDX file.
+ * Each section is read by big chunks that are decoded in place,
+ * so loading isn't bound by calls per field.</p>
+ * @param pDiIxRm IDX RAM with head
+ * @param pIdxFl - IDX file positioned at IRT
+ * @set errno if error.
+ **/
+static void
+  s_rm_read_tbls (BsDiIxTxRm *pDiIxRm, FILE *pIdxFl)
+{
+  //vars:
+  BsDiIxHeadTx *head = pDiIxRm->head;
+  int mx = head->mxIrWdSz, flgs = head->flgs, i;
+  size_t idxLen = BDI_TX_IDXLEN (flgs), ofsLen = BDI_TX_OFSLEN (flgs);
+  size_t irtRdSz = BDI_IRTRD_FIXED_SIZE (mx, flgs);
+  size_t dwRdSz = BDI_DWOLTRD_SIZE (flgs);
+  BS_IDX_T l, j, cnt, wrdsSz = BS_IDX_0;
+  BS_CHAR_T *wrd;
+  const char *rd;
+  //the longest IRT record must fit into buffer:
+  size_t bufSz = irtRdSz > BDI_RM_LDBUFSZ ? irtRdSz : BDI_RM_LDBUFSZ;
+  char *buf = malloc (bufSz);
+  BS_IF_EN_RET (buf == NULL, ENOMEM)
+  //IRT:
+  BS_DO_E_OUT (bsdiixtx_skip_pad (flgs, pIdxFl))
+  for ( l = BS_IDX_0; l < head->irtSz; l += cnt )
+  {
+    BS_DO_E_OUT (cnt = s_rm_read_chunk (buf, bufSz, irtRdSz, head->irtSz - l,
+                                        pIdxFl))
+    for ( j = BS_IDX_0, rd = buf; j < cnt; j++, rd += irtRdSz )
+    {
+      BDI_RM_SET_IRTWOFS (pDiIxRm, l + j, wrdsSz);
+      wrd = pDiIxRm->irtWrds + wrdsSz;
+      memcpy (wrd, rd, mx * BS_CHAR_LEN);
+      //word is 0 terminated and padded with 0 or it fills whole record:
+      for ( i = 0; i < mx && wrd[i] != 0; i++ ) ;
+      wrd[i] = 0;
+      wrdsSz += i + 1;
+      BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->irtDwSts, l + j,
+                      s_dcd_idx (rd + mx * BS_CHAR_LEN, flgs));
+      memcpy (&pDiIxRm->irtI2Qns[l + j], rd + mx * BS_CHAR_LEN + idxLen,
+              BS_SMALL_LEN);
+      BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->irtI2Sts, l + j,
+                      s_dcd_idx (rd + mx * BS_CHAR_LEN + idxLen
+                                 + BS_SMALL_LEN, flgs));
+    }
+  }
+  BS_DO_E_OUT (s_rm_irt_done (pDiIxRm, wrdsSz))
+  //I2WPT:
+  BS_DO_E_OUT (bsdiixtx_skip_pad (flgs, pIdxFl))
+  for ( l = BS_IDX_0; l < head->i2wptSz; l += cnt )
+  {
+    BS_DO_E_OUT (cnt = s_rm_read_chunk (buf, bufSz, idxLen, head->i2wptSz - l,
+                                        pIdxFl))
+    for ( j = BS_IDX_0, rd = buf; j < cnt; j++, rd += idxLen )
+          { BDI_RM_SET_IDX (pDiIxRm, pDiIxRm->i2wpt, l + j, s_dcd_idx (rd, flgs)); }
+  }
+  //DWOLT:
+  BS_DO_E_OUT (bsdiixtx_skip_pad (flgs, pIdxFl))
+  for ( l = BS_IDX_0; l < head->dwoltSz; l += cnt )
+  {
+    BS_DO_E_OUT (cnt = s_rm_read_chunk (buf, bufSz, dwRdSz, head->dwoltSz - l,
+                                        pIdxFl))
+    for ( j = BS_IDX_0, rd = buf; j < cnt; j++, rd += dwRdSz )
+    {
+      BDI_RM_SET_DWOFS (pDiIxRm, l + j, s_dcd_ofst (rd, flgs));
+      memcpy (&pDiIxRm->dwoltLens[l + j], rd + ofsLen, BS_SMALL_LEN);
+    }
+  }
+out:
+  free (buf);
+}
+
 /**
  * <p>Load IDX RAM (in memory) from IDX file.</p>
  * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client to load only
+ *   wanted FST and SA, or NULL to load all IDX has
  * @return object or NULL if error or if IDX file not found
  * @set errno if error. "IDX file not found" is not error!
  **/
-BsDiIxTxRm* bsdiixtxrm_load(char *pPth) {
+static BsDiIxTxRm*
+  s_rm_load (char *pPth, BsDiIxOst* pOpSt)
+{
   FILE *dicFl = NULL;
   FILE *idxFl = NULL;
   BsDiIxHeadTx *head = NULL;
@@ -699,40 +1529,29 @@ BsDiIxTxRm* bsdiixtxrm_load(char *pPth) {
     return NULL;
   }
   BS_DO_E_OUTE(BsDiIxTxRm *idx_ram = bsdiixtxrm_new(dicFl, head))
-  BS_IDX_T l;
-  //IRT:
-  for (l = BS_IDX_0; l < idx_ram->head->irtSz; l++) {
-    BS_DO_E_OUTE(idx_ram->irt[l] = bsdicidxirtrd_new())
-    if ( head->mxIrWdSz > 0 )
-    {
-      idx_ram->irt[l]->idx_subwrd_size = head->mxIrWdSz;
-    } else {
-      BS_DO_E_OUTE (bsfread_uchar(&idx_ram->irt[l]->idx_subwrd_size, idxFl))
-    }
-    idx_ram->irt[l]->idx_subwrd = malloc(idx_ram->irt[l]->idx_subwrd_size * BS_WCHAR_LEN);
-    if (idx_ram->irt[l]->idx_subwrd == NULL) {
-      if ( errno == 0 ) { errno = ENOMEM; }
-      BSLOG_ERR
-      goto oute;
-    }
-    BS_DO_E_OUTE(bsfread_bschars(idx_ram->irt[l]->idx_subwrd, idx_ram->irt[l]->idx_subwrd_size, idxFl))
-    if ( head->mxIrWdSz > 0 )
-    {
-      idx_ram->irt[l]->idx_subwrd_size = bsdicidx_istr_len(idx_ram->irt[l]->idx_subwrd + 1);
-    }
-    BS_DO_E_OUTE(bsfread_bsindex(&idx_ram->irt[l]->dwolt_start, idxFl))
-    BS_DO_E_OUTE(bsfread_bssmall(&idx_ram->irt[l]->i2wpt_quantity, idxFl))
-    BS_DO_E_OUTE(bsfread_bsindex(&idx_ram->irt[l]->i2wpt_start, idxFl))
+  if ( head->mxIrWdSz > 0 )
+  {
+    BS_DO_E_OUTE (s_rm_read_tbls (idx_ram, idxFl))
+  } else {
+    BS_DO_E_OUTE (s_rm_read_flds (idx_ram, idxFl))
   }
-  //I2WPT:
-  for (l = BS_IDX_0; l < idx_ram->head->i2wptSz; l++) {
-    BS_DO_E_OUTE(bsfread_bsindex(&idx_ram->i2wpt[l], idxFl))
+  //HWP:
+  int flgs = head->flgs;
+  BS_FOFST_T hwpOfst = BDI_TX_SCTOFST (flgs, ftell (idxFl));
+  BS_DO_E_OUTE(idx_ram->hwp = bsdiixhwp_load(idxFl, hwpOfst, idx_ram->head->dwoltSz))
+  //FST:
+  BS_DO_E_OUTE (BS_FOFST_T hwpSz = bsdiixhwp_size (idxFl, hwpOfst, idx_ram->head->dwoltSz))
+  BS_FOFST_T fstOfst = BDI_TX_SCTOFST (flgs, hwpOfst + hwpSz);
+  BS_DO_E_OUTE (BS_FOFST_T fstSz = bsdiixfst_size (idxFl, fstOfst, idx_ram->head->dwoltSz))
+  if ( fstSz > BS_FOFST_0 && ( pOpSt == NULL || pOpSt->isFst ) )
+  {
+    BS_DO_E_OUTE (idx_ram->fst = bsdiixfst_load (idxFl, fstOfst, idx_ram->head->dwoltSz))
   }
-  //DWOLT:
-  for (l = BS_IDX_0; l < idx_ram->head->dwoltSz; l++) {
-    BS_DO_E_OUTE(idx_ram->dwolt[l] = bsdiixdwoltrd_new())
-    BS_DO_E_OUTE(bsfread_bsfoffset(&idx_ram->dwolt[l]->offset_dword, idxFl))
-    BS_DO_E_OUTE(bsfread_bssmall(&idx_ram->dwolt[l]->length_dword, idxFl))
+  //SA:
+  if ( pOpSt == NULL || pOpSt->isSa )
+  {
+    BS_FOFST_T saOfst = BDI_TX_SCTOFST (flgs, fstOfst + fstSz);
+    BS_DO_E_OUTE (idx_ram->sa = bsdiixsa_load (idxFl, saOfst, idx_ram->head->dwoltSz))
   }
   fclose(idxFl);
   return idx_ram;
@@ -753,6 +1572,63 @@ oute:
   return NULL;
 }
 
+/**
+ * <p>Load IDX RAM (in memory) from IDX file with all it has.</p>
+ * @param pPth - dictionary path.
+ * @return object or NULL if error or if IDX file not found
+ * @set errno if error. "IDX file not found" is not error!
+ **/
+BsDiIxTxRm*
+  bsdiixtxrm_load (char *pPth)
+{
+  return s_rm_load (pPth, NULL);
+}
+
+/**
+ * <p>Hand over head and dictionary of just made IDX in file to IDX RAM
+ * object, its tables are read from still opened IDX file.
+ * IDX in file is destroyed when success, otherwise it's still client's one.</p>
+ * @param pDiIx IDX in file without mapped IDX v2.
+ * @return IDX RAM or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxTxRm*
+  bsdiixtx_to_rm (BsDiIxTx *pDiIx)
+{
+  BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, pDiIx->irtOfst))
+  BS_DO_E_RETN (BsDiIxTxRm *diIxRm = bsdiixtxrm_new (pDiIx->dicFl, pDiIx->head))
+  if ( pDiIx->head->mxIrWdSz > 0 )
+  {
+    BS_DO_E_OUTE (s_rm_read_tbls (diIxRm, pDiIx->idxFl))
+  } else {
+    BS_DO_E_OUTE (s_rm_read_flds (diIxRm, pDiIx->idxFl))
+  }
+  if ( pDiIx->hwpOfst != BS_FOFST_NULL )
+  {
+    BS_DO_E_OUTE (diIxRm->hwp = bsdiixhwp_load (pDiIx->idxFl, pDiIx->hwpOfst, pDiIx->head->dwoltSz))
+  }
+  if ( pDiIx->fstOfst != BS_FOFST_NULL )
+  {
+    BS_DO_E_OUTE (diIxRm->fst = bsdiixfst_load (pDiIx->idxFl, pDiIx->fstOfst, pDiIx->head->dwoltSz))
+  }
+  if ( pDiIx->saOfst != BS_FOFST_NULL )
+  {
+    BS_DO_E_OUTE (diIxRm->sa = bsdiixsa_load (pDiIx->idxFl, pDiIx->saOfst, pDiIx->head->dwoltSz))
+  }
+  //the rest of IDX in file without handed over ones:
+  pDiIx->dicFl = NULL;
+  pDiIx->head = NULL;
+  bsdiixtx_destroy (pDiIx);
+  BSLOG_LOG(BSLINFO, "IDX has been handed over to IDXRAM#%p\n", diIxRm);
+  return diIxRm;
+
+oute: //head and dictionary are still IDX in file's ones:
+  diIxRm->dicFl = NULL;
+  diIxRm->head = NULL;
+  bsdiixtxrm_destroy (diIxRm);
+  return NULL;
+}
+
 /**
  * <p>Load IDX Base (head) from IDX file.</p>
  * @param pPth - dictionary path.
@@ -778,8 +1654,15 @@ void
     bsdiixheadtx_free (head);
     return;
   }
-  //rest totals:
+  //rest totals, IDX without encoding flags is all 64-bit:
   BS_DO_E_OUTE (bsfread_bsindex (&head->dwoltSz, idxFl))
+  if ( head->dwoltSz == BDI_TXFLGS_MARK )
+  {
+    BS_DO_E_OUTE (bsfread_int (&head->flgs, idxFl))
+    if ( head->flgs & BDI_TXFLG_SUM )
+          { BS_DO_E_OUTE (bsdiixsum_load (&head->sum, idxFl)) }
+    BS_DO_E_OUTE (bsfread_bsindex (&head->dwoltSz, idxFl))
+  }
   BS_DO_E_OUTE (bsfread_bsindex (&head->i2wptSz, idxFl))
 
   *pHeadRt = head;
@@ -826,7 +1709,191 @@ oute:
 }
 
 /**
- * <p>Open DIC IDX, i.e. load or create then load.</p>
+ * <p>Destructor.</p>
+ * @param pIrtSm - IRTSM or NULL
+ * @return always NULL
+ **/
+BsDiIxIrtSm*
+  bsdiixirtsm_free (BsDiIxIrtSm *pIrtSm)
+{
+  if ( pIrtSm != NULL )
+  {
+    free (pIrtSm->fchars);
+    free (pIrtSm->blk);
+    free (pIrtSm);
+  }
+  return NULL;
+}
+
+/**
+ * <p>Compare word's first char with IRT record's one by IRTSM.</p>
+ * @param pIrtSm - IRTSM
+ * @param pIdx - IRT index
+ * @param pFchar - word's first char
+ * @return 0 if word's char is greater, -1 if it's less,
+ *   1 if record must be read to know it
+ **/
+int
+  bsdiixirtsm_cmp (BsDiIxIrtSm *pIrtSm, BS_IDX_T pIdx, BS_CHAR_T pFchar)
+{
+  BS_IDX_T b = pIdx / pIrtSm->k;
+  //block's chars are between its first one and the next block's first one:
+  if ( pFchar == 0 )
+        { return 1; }
+  if ( pIrtSm->fchars[b] > pFchar )
+        { return -1; }
+  if ( pIrtSm->fchars[b + 1] < pFchar )
+        { return 0; }
+  return 1;
+}
+
+/**
+ * <p>Make IRTSM of IDX in file by reading every k-th IRT record's first char.
+ * It isn't made if IRT isn't ordered by first chars.</p>
+ * @param pDiIx - IDX in file
+ * @param pBkSz - block's size in bytes, e.g. BDI_IRTSM_BKSZ
+ * @set errno if error.
+ **/
+void
+  bsdiixtx_mk_irtsm (BsDiIxTx *pDiIx, size_t pBkSz)
+{
+  //vars:
+  BsDiIxIrtSm *obj;
+  BS_IDX_T b, irtSz;
+  size_t rdSz;
+  //code:
+  pDiIx->irtSm = bsdiixirtsm_free (pDiIx->irtSm);
+  irtSz = pDiIx->head->irtSz;
+  if ( irtSz <= BS_IDX_0 )
+        { return; }
+  rdSz = BDI_IRTRD_FIXED_SIZE (pDiIx->head->mxIrWdSz, pDiIx->head->flgs);
+  obj = calloc (1, sizeof (BsDiIxIrtSm));
+  BS_IF_EN_RET (obj == NULL, ENOMEM)
+  obj->k = pBkSz / rdSz > 0 ? pBkSz / rdSz : 1;
+  obj->sz = ( irtSz + obj->k - 1 ) / obj->k;
+  obj->blkIdx = BS_IDX_NULL;
+  obj->fchars = malloc ((obj->sz + 1) * BS_CHAR_LEN);
+  BS_IF_EN_OUTE (obj->fchars == NULL, ENOMEM)
+  obj->blk = malloc (obj->k * rdSz);
+  BS_IF_EN_OUTE (obj->blk == NULL, ENOMEM)
+  for ( b = BS_IDX_0; b <= obj->sz; b++ )
+  {
+    BS_IDX_T l = b < obj->sz ? b * obj->k : irtSz - BS_IDX_1;
+    BS_DO_E_OUTE (bsfseek_goto (pDiIx->idxFl, pDiIx->irtOfst + l * rdSz))
+    BS_DO_E_OUTE (bsfread_bschars (&obj->fchars[b], 1, pDiIx->idxFl))
+    if ( obj->fchars[b] == 0 || ( b > BS_IDX_0
+                                  && obj->fchars[b] < obj->fchars[b - 1] ) )
+    {
+      BSLOG_LOG (BSLWARN, "IRT isn't ordered by first chars, IRT#"BS_IDX_FMT"\n", l)
+      bsdiixirtsm_free (obj);
+      return;
+    }
+  }
+  pDiIx->irtSm = obj;
+  return;
+
+oute:
+  bsdiixirtsm_free (obj);
+}
+
+/**
+ * <p>Get IRT record as it's in IDX file from IRTSM's block,
+ * the block is read if it isn't the last read one.</p>
+ * @param pDiIx - IDX in file with IRTSM
+ * @param pIdx - IRT index
+ * @return record or NULL if error
+ * @set errno if error.
+ **/
+const char*
+  bsdiixtx_irtsm_rd (BsDiIxTx *pDiIx, BS_IDX_T pIdx)
+{
+  BsDiIxIrtSm *sm = pDiIx->irtSm;
+  size_t rdSz = BDI_IRTRD_FIXED_SIZE (pDiIx->head->mxIrWdSz, pDiIx->head->flgs);
+  BS_IDX_T b = pIdx / sm->k;
+  if ( b != sm->blkIdx )
+  {
+    BS_IDX_T l = b * sm->k;
+    sm->blkIdx = BS_IDX_NULL;
+    BS_DO_E_RETN (bsfseek_goto (pDiIx->idxFl, pDiIx->irtOfst + l * rdSz))
+    BS_DO_E_RETN (s_rm_read_chunk (sm->blk, sm->k * rdSz, rdSz,
+                                   pDiIx->head->irtSz - l, pDiIx->idxFl))
+    sm->blkIdx = b;
+  }
+  return sm->blk + ( pIdx - b * sm->k ) * rdSz;
+}
+
+/**
+ * <p>Decode IRT record's fields except word.</p>
+ * @param pDiIx - IDX in file
+ * @param pRd - record as it's in IDX file
+ * @param pDwStRt - pointer to return dwolt_start
+ * @param pI2QnRt - pointer to return i2wpt_quantity
+ * @param pI2StRt - pointer to return i2wpt_start
+ **/
+void
+  bsdiixtx_dcd_irtrd (BsDiIxTx *pDiIx, const char *pRd, BS_IDX_T *pDwStRt,
+                      BS_SMALL_T *pI2QnRt, BS_IDX_T *pI2StRt)
+{
+  int flgs = pDiIx->head->flgs;
+  const char *rd = pRd + pDiIx->head->mxIrWdSz * BS_CHAR_LEN;
+  *pDwStRt = s_dcd_idx (rd, flgs);
+  memcpy (pI2QnRt, rd + BDI_TX_IDXLEN (flgs), BS_SMALL_LEN);
+  *pI2StRt = s_dcd_idx (rd + BDI_TX_IDXLEN (flgs) + BS_SMALL_LEN, flgs);
+}
+
+/**
+ * <p>Attach mapped IDX v2 tables to IDX in file, (re)make them if need.
+ * It isn't fatal, IDX tables are read from file if it fails,
+ * then IRTSM is made and FST and SA are loaded.
+ * FST and SA that client doesn't want are neither mapped nor loaded.</p>
+ * @param pDiIx - IDX in file
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ **/
+static void
+  s_mm_attach (BsDiIxTx *pDiIx, char *pPth, BsDiIxOst* pOpSt)
+{
+  if ( !pOpSt->isFst )
+        { pDiIx->fstOfst = BS_FOFST_NULL; }
+  if ( !pOpSt->isSa )
+        { pDiIx->saOfst = BS_FOFST_NULL; }
+  pDiIx->mm = bsdiixmm_open (pDiIx, pPth, pOpSt->dpVld);
+  if ( errno != 0 )
+  {
+    BSLOG_LOG (BSLWARN, "IDX v2 isn't used, errno=%d, dic=%s\n", errno, pPth)
+    errno = 0;
+  }
+  if ( pDiIx->mm == NULL )
+  {
+    bsdiixtx_mk_irtsm (pDiIx, BDI_IRTSM_BKSZ);
+    if ( errno != 0 )
+    {
+      BSLOG_LOG (BSLWARN, "IRTSM isn't used, errno=%d, dic=%s\n", errno, pPth)
+      errno = 0;
+    }
+    if ( pDiIx->fstOfst != BS_FOFST_NULL )
+    {
+      pDiIx->fst = bsdiixfst_load (pDiIx->idxFl, pDiIx->fstOfst, pDiIx->head->dwoltSz);
+      if ( errno != 0 )
+      {
+        BSLOG_LOG (BSLWARN, "FST isn't used, errno=%d, dic=%s\n", errno, pPth)
+        errno = 0;
+      }
+    }
+    if ( pDiIx->saOfst != BS_FOFST_NULL )
+    {
+      pDiIx->sa = bsdiixsa_load (pDiIx->idxFl, pDiIx->saOfst, pDiIx->head->dwoltSz);
+      if ( errno != 0 )
+      {
+        BSLOG_LOG (BSLWARN, "SA isn't used, errno=%d, dic=%s\n", errno, pPth)
+        errno = 0;
+      }
+    }
+  }
+}
+
+/**
+ * <p>Open DIC IDX, i.e. load or create, save and hand over made one.</p>
  * @param pPth - dictionary path.
  * @param pOpSt - opening state data shared with client
  * @param pIsIxRm - client prefers IRT (index records table) in memory (RAM) than in file
@@ -840,19 +1907,42 @@ BsDiIxTxBs*
   BsDiIxTxRm *diIxRm;
   diIx = NULL;
   diIxRm = NULL;
-  if ( !pIsIxRm )
+  //IDX of changed dictionary is updated by re-parsing only changed chunks:
+  BS_DO_E_OUTE (diIxRm = bsdiixtxup_update (pPth, pOpSt))
+  if ( pOpSt->stp )
+                { goto oute; }
+  if ( diIxRm != NULL )
   {
+    BS_DO_E_OUTE (bsdiixtxrm_validate (diIxRm))
+    pOpSt->prgr = 100;
+    pOpSt->stt = EBSDS_OPENED;
+    if ( pIsIxRm )
+    {
+      BS_DO_E_OUTE (bsdiixtxrm_save (diIxRm, pPth))
+      return (BsDiIxTxBs *) diIxRm;
+    }
+    BS_DO_E_OUTE (diIx = bsdiixtxrm_save_tx (diIxRm, pPth))
+    s_mm_attach (diIx, pPth, pOpSt);
+    return (BsDiIxTxBs *) diIx;
+  } else if ( !pIsIxRm ) {
     BS_DO_E_OUTE (diIx = bsdiixtx_load (pPth))
     if ( diIx != NULL )
     {
+      if ( pOpSt->dpVld )
+      {
+        BS_DO_E_OUTE (bsdicidxhirt_validate (diIx->head->hirt, diIx->head->hirtSz, diIx->head->ab))
+      }
+      s_mm_attach (diIx, pPth, pOpSt);
       pOpSt->prgr = 100;
       pOpSt->stt = EBSDS_OPENED;
       return (BsDiIxTxBs *) diIx;
     }
   } else {
-    BS_DO_E_OUTE (diIxRm = bsdiixtxrm_load (pPth))
+    BS_DO_E_OUTE (diIxRm = s_rm_load (pPth, pOpSt))
     if ( diIxRm != NULL )
     {
+      if ( pOpSt->dpVld )
+            { BS_DO_E_OUTE (bsdiixtxrm_validate (diIxRm)) }
       pOpSt->prgr = 100;
       pOpSt->stt = EBSDS_OPENED;
       return (BsDiIxTxBs *) diIxRm;
@@ -861,34 +1951,50 @@ BsDiIxTxBs*
 
   pOpSt->stt = EBSDS_INDEXING;
 
-  BS_DO_E_OUTE (diIxRm = bsdiixtxrm_create (pPth, pOpSt))
-
-  BS_DO_E_OUTE (bsdiixtxrm_validate (diIxRm))
-
-  BS_DO_E_OUTE (bsdiixtxrm_save (diIxRm, pPth))
-
-  diIxRm = bsdiixtxrm_destroy (diIxRm);
-
-  
-  if ( !pIsIxRm )
-  {
-    BS_DO_E_OUTE (diIx = bsdiixtx_load (pPth))
-    if ( diIx != NULL )
-    {
-      pOpSt->prgr = 100;
-      pOpSt->stt = EBSDS_OPENED;
-      return (BsDiIxTxBs *) diIx;
+  if ( pOpSt->isBdgtAuto )
+                { pOpSt->memBdgt = bsdiixtxex_bdgt (pPth); }
+  if ( pOpSt->memBdgt > 0 )
+  { //IDX is streamed into file:
+    BS_DO_E_OUTE (diIx = bsdiixtxex_create (pPth, pOpSt))
+    if ( diIx == NULL ) //canceled
+                { goto oute; }
+    if ( pIsIxRm )
+    { //merged tables are streamed into file without keeping them in memory,
+      //so IDX RAM reads them back from just written (i.e. cached) IDX file,
+      //head and dictionary are handed over:
+      BS_DO_E_OUTE (diIxRm = bsdiixtx_to_rm (diIx))
+      diIx = NULL;
     }
   } else {
-    BS_DO_E_OUTE (diIxRm = bsdiixtxrm_load (pPth))
-    if ( diIx != NULL )
+    BS_DO_E_OUTE (diIxRm = bsdiixtxrm_create (pPth, pOpSt))
+    if ( diIxRm == NULL ) //canceled
+                { goto oute; }
+
+    BS_DO_E_OUTE (bsdiixtxrm_validate (diIxRm))
+
+    if ( pIsIxRm )
     {
-      pOpSt->prgr = 100;
-      pOpSt->stt = EBSDS_OPENED;
-      return (BsDiIxTxBs *) diIxRm;
+      BS_DO_E_OUTE (bsdiixtxrm_save (diIxRm, pPth))
+    } else {
+      BS_DO_E_OUTE (diIx = bsdiixtxrm_save_tx (diIxRm, pPth))
+      diIxRm = NULL;
     }
   }
 
+  if ( diIx != NULL )
+  {
+    s_mm_attach (diIx, pPth, pOpSt);
+    pOpSt->prgr = 100;
+    pOpSt->stt = EBSDS_OPENED;
+    return (BsDiIxTxBs *) diIx;
+  }
+  if ( diIxRm != NULL )
+  {
+    pOpSt->prgr = 100;
+    pOpSt->stt = EBSDS_OPENED;
+    return (BsDiIxTxBs *) diIxRm;
+  }
+
 oute:
   bsdiixtxrm_destroy (diIxRm);
   bsdiixtx_destroy (diIx);
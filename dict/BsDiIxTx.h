@@ -13,22 +13,61 @@ See the LICENSE in the root source folder */
 
 #include "stdio.h"
 #include "wchar.h"
+#include "stdint.h"
 
 #include "BsStrings.h"
 #include "BsDicFrmt.h"
 #include "BsDicIdxIrtRaw.h"
 #include "BsDiIx.h"
+#include "BsDiIxFpt.h"
+#include "BsDiIxHwp.h"
+#include "BsDiIxFst.h"
+#include "BsDiIxSa.h"
+#include "BsDiIxSum.h"
+
+//IDX file's encoding flags, they follow this mark written instead of
+//dwoltSz, then dwoltSz and i2wptSz follow, IDX without them (old one)
+//is all 64-bit, i.e. flags=0:
+#define BDI_TXFLGS_MARK -2L
+//IRT dwolt_start/i2wpt_start and I2WPT indexes are int:
+#define BDI_TXFLG_IDX32 1
+//DWOLT offsets are unsigned int:
+#define BDI_TXFLG_OFS32 2
+//check-summed head's block (SUM) follows flags:
+#define BDI_TXFLG_SUM 4
+//i.words are folded by UCD simple case folding (BsUcFold),
+//IDX without it (folded by libc) is remade:
+#define BDI_TXFLG_UCF 8
+//sections IRT, I2WPT, DWOLT, HWP, FST and SA start at offsets aligned
+//by BDI_TX_ALIGN, so HWP, FST, SA and I2WPT are usable in mapped file,
+//IDX without it is remade:
+#define BDI_TXFLG_ALGN 16
+#define BDI_TX_ALIGN 8
+
+//section's offset in IDX file with flags just after previous section's end:
+#define BDI_TX_SCTOFST(pFlgs, pOfst) (((pFlgs) & BDI_TXFLG_ALGN)\
+  ? ((pOfst) + BDI_TX_ALIGN - 1) / BDI_TX_ALIGN * BDI_TX_ALIGN : (pOfst))
+
+//index and offset sizes in IDX file with flags:
+#define BDI_TX_IDXLEN(pFlgs) (((pFlgs) & BDI_TXFLG_IDX32) ? sizeof (int) : BS_IDX_LEN)
+#define BDI_TX_OFSLEN(pFlgs) (((pFlgs) & BDI_TXFLG_OFS32) ? sizeof (unsigned int) : BS_FOFST_LEN)
 
 /**
  * <p>Index file's head of a text dictionary.</p>
  * @extends BSDIIXHEADBS
  * @member BS_IDX_T dwoltSz - total records in DWOLT (words in dictionary)
  * @member BS_IDX_T i2wptSz - total records in I2WPT
+ * @member BsDiIxFpt *fpt - dictionary's fingerprints to save, or NULL
+ * @member int flgs - IDX file's encoding flags BDI_TXFLG_*
+ * @member BsDiIxSum sum - check-summed block if flags has BDI_TXFLG_SUM
  **/
 typedef struct {
   BSDIIXHEADBS
   BS_IDX_T dwoltSz;
   BS_IDX_T i2wptSz;
+  BsDiIxFpt *fpt;
+  int flgs;
+  BsDiIxSum sum;
 } BsDiIxHeadTx;
 
 /**
@@ -68,6 +107,88 @@ BsDiIxHeadTx *bsdiixheadtx_free (BsDiIxHeadTx *pHead);
  **/
 void bsdiixheadtx_add_hirtrd (BsDiIxHeadTx *pHead, BsDiIxHirtRd *pRcd);
 
+/**
+ * <p>Choose the most compact IDX file's encoding for head's totals
+ * and dictionary's size.</p>
+ * @param pHead - head with totals
+ * @param pDicFl - dictionary
+ * @set errno if error.
+ **/
+void bsdiixheadtx_mk_flgs (BsDiIxHeadTx *pHead, FILE *pDicFl);
+
+/**
+ * <p>Write head's rest totals (after head base) with encoding flags.</p>
+ * @param pHead - head
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixheadtx_write_tots (BsDiIxHeadTx *pHead, FILE *pIdxFl);
+
+/**
+ * <p>Make check-summed head's block of written IDX sections (HWP with FST and SA is
+ * the last one and it ends at the current file's position), and overwrite
+ * its placeholder. File position is restored.</p>
+ * @param pHead - head with SUM flag
+ * @param pIdxFl - IDX file
+ * @param pIrtOfst - IRT offset
+ * @param pPth - dictionary path
+ * @set errno if error.
+ **/
+void bsdiixheadtx_save_sum (BsDiIxHeadTx *pHead, FILE *pIdxFl,
+                            BS_FOFST_T pIrtOfst, char *pPth);
+
+/**
+ * <p>Write DWOLT or I2WPT index into IDX file.</p>
+ * @param pIdx - index
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixtx_write_idx (BS_IDX_T *pIdx, int pFlgs, FILE *pIdxFl);
+
+/**
+ * <p>Read DWOLT or I2WPT index from IDX file.</p>
+ * @param pIdxRt - pointer to return index
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixtx_read_idx (BS_IDX_T *pIdxRt, int pFlgs, FILE *pIdxFl);
+
+/**
+ * <p>Write DWOLT word's offset into IDX file.</p>
+ * @param pOfst - offset in dictionary
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixtx_write_ofst (BS_FOFST_T *pOfst, int pFlgs, FILE *pIdxFl);
+
+/**
+ * <p>Read DWOLT word's offset from IDX file.</p>
+ * @param pOfstRt - pointer to return offset in dictionary
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixtx_read_ofst (BS_FOFST_T *pOfstRt, int pFlgs, FILE *pIdxFl);
+
+/**
+ * <p>Write zero padding up to the next section's offset into IDX file.</p>
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixtx_write_pad (int pFlgs, FILE *pIdxFl);
+
+/**
+ * <p>Skip padding up to the next section's offset in IDX file.</p>
+ * @param pFlgs - encoding flags
+ * @param pIdxFl - IDX file
+ * @set errno if error.
+ **/
+void bsdiixtx_skip_pad (int pFlgs, FILE *pIdxFl);
+
 /**
  * <p>Index file's IRT float (idx_subwrd_size is persistent)
  * or fixed (idx_subwrd_size isn't persistent) size record.</p>
@@ -79,7 +200,7 @@ typedef struct {
   BS_IDX_T i2wpt_start;
 } BsDicIdxIrtRd;
 
-#define BDI_IRTRD_FIXED_SIZE(p_max_irtwrd_size) BS_SMALL_LEN + BS_IDX_LEN*2 + BS_CHAR_LEN*p_max_irtwrd_size
+#define BDI_IRTRD_FIXED_SIZE(p_max_irtwrd_size, pFlgs) (BS_SMALL_LEN + BDI_TX_IDXLEN (pFlgs) * 2 + BS_CHAR_LEN * (p_max_irtwrd_size))
 
 /**
  * <p>Constructor.</p>
@@ -102,7 +223,7 @@ typedef struct {
   BSDICDWOLTRCDBASE
 } BsDcIxDwoltRd;
 
-#define BDI_DWOLTRD_SIZE BS_FOFST_LEN + BS_SMALL_LEN
+#define BDI_DWOLTRD_SIZE(pFlgs) (BDI_TX_OFSLEN (pFlgs) + BS_SMALL_LEN)
 
 /**
  * <p>Constructor.</p>
@@ -129,6 +250,47 @@ typedef struct {
   BSDIIXBST(BsDiIxHeadTx)
 } BsDiIxTxBs;
 
+//IRTSM block's size in bytes, i.e. IRT records read by single read:
+#define BDI_IRTSM_BKSZ 4096
+
+/**
+ * <p>IRT sparse sample (IRTSM) of IDX in file, that is made when mapped
+ * IDX v2 isn't used. It holds the first char of every k-th IRT record,
+ * so finding's binary search probes it in RAM and reads from file
+ * just blocks of k records where word's first char starts, ends or is found.
+ * The last read block is kept in RAM.</p>
+ * @member int k - IRT records in block
+ * @member BS_IDX_T sz - blocks total
+ * @member BS_CHAR_T *fchars - blocks first records first chars and
+ *   the last record's one, i.e. sz + 1
+ * @member char *blk - the last read block as it's in IDX file
+ * @member BS_IDX_T blkIdx - the last read block's index or BS_IDX_NULL
+ **/
+typedef struct {
+  int k;
+  BS_IDX_T sz;
+  BS_CHAR_T *fchars;
+  char *blk;
+  BS_IDX_T blkIdx;
+} BsDiIxIrtSm;
+
+/**
+ * <p>Destructor.</p>
+ * @param pIrtSm - IRTSM or NULL
+ * @return always NULL
+ **/
+BsDiIxIrtSm *bsdiixirtsm_free (BsDiIxIrtSm *pIrtSm);
+
+/**
+ * <p>Compare word's first char with IRT record's one by IRTSM.</p>
+ * @param pIrtSm - IRTSM
+ * @param pIdx - IRT index
+ * @param pFchar - word's first char
+ * @return 0 if word's char is greater, -1 if it's less,
+ *   1 if record must be read to know it
+ **/
+int bsdiixirtsm_cmp (BsDiIxIrtSm *pIrtSm, BS_IDX_T pIdx, BS_CHAR_T pFchar);
+
 /**
  * <p>Text dictionary with cached IDX head and IDX file.</p>
  * @extends BSDIIXBST(BsDiIxHeadTx)
@@ -137,6 +299,14 @@ typedef struct {
  * @member BS_FOFST_T irtOfst - offset IRT
  * @member BS_FOFST_T i2wptOfst - offset I2WPT
  * @member BS_FOFST_T dwoltOfst - offset DWOLT
+ * @member BS_FOFST_T hwpOfst - offset HWP or BS_FOFST_NULL if IDX without it
+ * @member BS_FOFST_T fstOfst - offset FST or BS_FOFST_NULL if IDX without it
+ * @member BS_FOFST_T saOfst - offset SA or BS_FOFST_NULL if IDX without it
+ * @member struct BsDiIxMm *mm - mapped IDX v2 tables or NULL,
+ *   then they are read from IDX file
+ * @member BsDiIxIrtSm *irtSm - IRT sample for reading IRT from IDX file or NULL
+ * @member char *fst - FST loaded from IDX file or NULL, IDX v2 has own one
+ * @member char *sa - SA loaded from IDX file or NULL, IDX v2 has own one
  **/
 typedef struct {
   BSDIIXBST(BsDiIxHeadTx)
@@ -144,8 +314,45 @@ typedef struct {
   BS_FOFST_T irtOfst;
   BS_FOFST_T i2wptOfst;
   BS_FOFST_T dwoltOfst;
+  BS_FOFST_T hwpOfst;
+  BS_FOFST_T fstOfst;
+  BS_FOFST_T saOfst;
+  struct BsDiIxMm *mm;
+  BsDiIxIrtSm *irtSm;
+  char *fst;
+  char *sa;
 } BsDiIxTx;
 
+/**
+ * <p>Make IRTSM of IDX in file by reading every k-th IRT record's first char.
+ * It isn't made if IRT isn't ordered by first chars.</p>
+ * @param pDiIx - IDX in file
+ * @param pBkSz - block's size in bytes, e.g. BDI_IRTSM_BKSZ
+ * @set errno if error.
+ **/
+void bsdiixtx_mk_irtsm (BsDiIxTx *pDiIx, size_t pBkSz);
+
+/**
+ * <p>Get IRT record as it's in IDX file from IRTSM's block,
+ * the block is read if it isn't the last read one.</p>
+ * @param pDiIx - IDX in file with IRTSM
+ * @param pIdx - IRT index
+ * @return record or NULL if error
+ * @set errno if error.
+ **/
+const char *bsdiixtx_irtsm_rd (BsDiIxTx *pDiIx, BS_IDX_T pIdx);
+
+/**
+ * <p>Decode IRT record's fields except word.</p>
+ * @param pDiIx - IDX in file
+ * @param pRd - record as it's in IDX file
+ * @param pDwStRt - pointer to return dwolt_start
+ * @param pI2QnRt - pointer to return i2wpt_quantity
+ * @param pI2StRt - pointer to return i2wpt_start
+ **/
+void bsdiixtx_dcd_irtrd (BsDiIxTx *pDiIx, const char *pRd, BS_IDX_T *pDwStRt,
+                         BS_SMALL_T *pI2QnRt, BS_IDX_T *pI2StRt);
+
 /**
  * <p>Constructor of IDX BASE fillits head from IDX file.</p>
  * @param pDicFl - dictionary
@@ -164,21 +371,140 @@ BsDiIxTx *bsdiixtx_new (FILE *pDicFl, FILE *pIdx_file, BsDiIxHeadTx *pHead);
 BsDiIxTx *bsdiixtx_destroy (BsDiIxTx *pDiIx);
 
 /**
- * <p>Full dictionary with full index in memory data.</p>
+ * <p>IDX RAM's IRT search keys (IRTEZ) that are made when IRT has been filled.
+ * Finding compares IRT words by their first chars (see bsdicidx_istr_how_match),
+ * so keys are IRT's distinct first chars with theirs IRT records ranges.
+ * They are laid out in Eytzinger (BFS) order, so the first probes
+ * of every search hit the same few cache lines.</p>
+ * @member int sz - keys total
+ * @member BS_CHAR_T *keys - first chars in Eytzinger order, 1-based
+ * @member BS_IDX_T *irtSts - first IRT record with key, the same order
+ * @member BS_IDX_T *irtEns - last IRT record with key, the same order
+ **/
+typedef struct {
+  int sz;
+  BS_CHAR_T *keys;
+  BS_IDX_T *irtSts;
+  BS_IDX_T *irtEns;
+} BsDiIxIrtEz;
+
+/**
+ * <p>Destructor.</p>
+ * @param pIrtEz - IRTEZ or NULL
+ * @return always NULL
+ **/
+BsDiIxIrtEz *bsdiixirtez_free (BsDiIxIrtEz *pIrtEz);
+
+/**
+ * <p>Find IRT records range with given first char.</p>
+ * @param pIrtEz - IRTEZ
+ * @param pFchar - first char
+ * @param pIrtEndRt - pointer to return the last IRT record with it
+ * @return the first IRT record with it or BS_IDX_NULL if there is no one
+ **/
+BS_IDX_T bsdiixirtez_find (BsDiIxIrtEz *pIrtEz, BS_CHAR_T pFchar,
+                           BS_IDX_T *pIrtEndRt);
+
+/**
+ * <p>Full dictionary with full index in memory data.
+ * Tables are flat arrays (structure of arrays) indexed by record's index,
+ * IRT words are in single pool, so searching doesn't chase pointers.
+ * Indexes and offsets tables are 32 bit wide if totals allow it,
+ * so they are accessed by BDI_RM_* macros.</p>
  * @extends BSDIIXBST(BsDiIxHeadTx)
  * data evaluated during opening/creating IDX:
- * @member BsDicIdxIrtRd **irt
- * @member BS_IDX_T *i2wpt
- * @member BsDcIxDwoltRd **dwolt
+ * @member int flgs - tables widths: BDI_TXFLG_IDX32 - int32 indexes,
+ *   BDI_TXFLG_OFS32 - uint32 DWOLT offsets (UINT32_MAX is NULL),
+ *   BDI_RMFLG_WOFS32 - uint32 IRT words offsets,
+ *   otherwise they are BS_IDX_T and BS_FOFST_T
+ * @member BS_CHAR_T *irtWrds - IRT words pool, each word is 0 terminated
+ * @member void *irtWrdOfsts - IRT words offsets in pool
+ * @member void *irtDwSts - IRT dwolt_start
+ * @member BS_SMALL_T *irtI2Qns - IRT i2wpt_quantity
+ * @member void *irtI2Sts - IRT i2wpt_start
+ * @member void *i2wpt - I2WPT
+ * @member void *dwoltOfsts - DWOLT words offsets in dictionary
+ * @member BS_SMALL_T *dwoltLens - DWOLT words lengths
+ * @member char *hwp - HWP loaded from IDX file (or made by update) or NULL,
+ *   then headwords are read from dictionary, the current one is saved as is
+ * @member BsDiIxIrtEz *irtEz - IRT search keys or NULL
+ * @member char *fst - headwords FST or NULL
+ * @member char *sa - headwords SA or NULL
  **/
 typedef struct {
   BSDIIXBST(BsDiIxHeadTx)
-  BsDicIdxIrtRd **irt;
-  BS_IDX_T *i2wpt;
-  BsDcIxDwoltRd **dwolt;
+  int flgs;
+  BS_CHAR_T *irtWrds;
+  void *irtWrdOfsts;
+  void *irtDwSts;
+  BS_SMALL_T *irtI2Qns;
+  void *irtI2Sts;
+  void *i2wpt;
+  void *dwoltOfsts;
+  BS_SMALL_T *dwoltLens;
+  char *hwp;
+  BsDiIxIrtEz *irtEz;
+  char *fst;
+  char *sa;
 } BsDiIxTxRm;
 
-#define BDI_I2WPTRD_SIZE BS_IDX_LEN
+//IDX RAM's IRT words offsets are uint32 flag:
+#define BDI_RMFLG_WOFS32 8
+
+//IDX RAM's indexes table record size:
+#define BDI_RM_IDXLEN(pFlgs) BDI_TX_IDXLEN (pFlgs)
+//IDX RAM's DWOLT offsets table record size:
+#define BDI_RM_OFSLEN(pFlgs) BDI_TX_OFSLEN (pFlgs)
+//IDX RAM's IRT words offsets table record size:
+#define BDI_RM_WOFSLEN(pFlgs) (((pFlgs) & BDI_RMFLG_WOFS32) ? sizeof (uint32_t) : BS_IDX_LEN)
+
+//IDX RAM's indexes table pTbl record #pIdx:
+#define BDI_RM_IDX(pDiIxRm, pTbl, pIdx) (((pDiIxRm)->flgs & BDI_TXFLG_IDX32)\
+  ? (BS_IDX_T) ((int32_t*) (pTbl))[pIdx]\
+  : ((BS_IDX_T*) (pTbl))[pIdx])
+//set IDX RAM's indexes table pTbl record #pIdx:
+#define BDI_RM_SET_IDX(pDiIxRm, pTbl, pIdx, pVal) (((pDiIxRm)->flgs & BDI_TXFLG_IDX32)\
+  ? (void) (((int32_t*) (pTbl))[pIdx] = (int32_t) (pVal))\
+  : (void) (((BS_IDX_T*) (pTbl))[pIdx] = (pVal)))
+//IRT record #pIdx dwolt_start:
+#define BDI_RM_DWST(pDiIxRm, pIdx) BDI_RM_IDX (pDiIxRm, (pDiIxRm)->irtDwSts, pIdx)
+//IRT record #pIdx i2wpt_start:
+#define BDI_RM_I2ST(pDiIxRm, pIdx) BDI_RM_IDX (pDiIxRm, (pDiIxRm)->irtI2Sts, pIdx)
+//I2WPT record #pIdx:
+#define BDI_RM_I2WPT(pDiIxRm, pIdx) BDI_RM_IDX (pDiIxRm, (pDiIxRm)->i2wpt, pIdx)
+//DWOLT record #pIdx word's offset:
+#define BDI_RM_DWOFS(pDiIxRm, pIdx) (((pDiIxRm)->flgs & BDI_TXFLG_OFS32)\
+  ? (((uint32_t*) (pDiIxRm)->dwoltOfsts)[pIdx] == UINT32_MAX ? BS_FOFST_NULL\
+    : (BS_FOFST_T) ((uint32_t*) (pDiIxRm)->dwoltOfsts)[pIdx])\
+  : ((BS_FOFST_T*) (pDiIxRm)->dwoltOfsts)[pIdx])
+//set DWOLT record #pIdx word's offset:
+#define BDI_RM_SET_DWOFS(pDiIxRm, pIdx, pVal) (((pDiIxRm)->flgs & BDI_TXFLG_OFS32)\
+  ? (void) (((uint32_t*) (pDiIxRm)->dwoltOfsts)[pIdx] = (pVal) == BS_FOFST_NULL\
+    ? UINT32_MAX : (uint32_t) (pVal))\
+  : (void) (((BS_FOFST_T*) (pDiIxRm)->dwoltOfsts)[pIdx] = (pVal)))
+//IRT record #pIdx word's offset in pool:
+#define BDI_RM_IRTWOFS(pDiIxRm, pIdx) (((pDiIxRm)->flgs & BDI_RMFLG_WOFS32)\
+  ? (BS_IDX_T) ((uint32_t*) (pDiIxRm)->irtWrdOfsts)[pIdx]\
+  : ((BS_IDX_T*) (pDiIxRm)->irtWrdOfsts)[pIdx])
+//set IRT record #pIdx word's offset in pool:
+#define BDI_RM_SET_IRTWOFS(pDiIxRm, pIdx, pVal) (((pDiIxRm)->flgs & BDI_RMFLG_WOFS32)\
+  ? (void) (((uint32_t*) (pDiIxRm)->irtWrdOfsts)[pIdx] = (uint32_t) (pVal))\
+  : (void) (((BS_IDX_T*) (pDiIxRm)->irtWrdOfsts)[pIdx] = (pVal)))
+
+//IRT record #pIdx word of IDX RAM:
+#define BDI_RM_IRTWRD(pDiIxRm, pIdx) ((pDiIxRm)->irtWrds + BDI_RM_IRTWOFS (pDiIxRm, pIdx))
+
+/**
+ * <p>Make IRTEZ from filled IRT of IDX RAM.</p>
+ * @param pDiIxRm - IDX RAM with filled IRT
+ * @param pIrtSz - IRT size
+ * @return object or NULL when error or if IRT isn't ordered by first chars
+ * @set errno if error.
+ **/
+BsDiIxIrtEz *bsdiixirtez_new (BsDiIxTxRm *pDiIxRm, BS_IDX_T pIrtSz);
+
+
+#define BDI_I2WPTRD_SIZE(pFlgs) BDI_TX_IDXLEN (pFlgs)
 
 /**
  * <p>Constructor of IDX RAM (in memory) to fill from IDX file or IRTRAW and IWORDSSORT.</p>
@@ -223,13 +549,34 @@ void bsdiixtxrm_validate(BsDiIxTxRm *pDiIxRm);
 void bsdiixtxrm_save(BsDiIxTxRm *pDiIxRm, char *pPth);
 
 /**
- * <p>Load IDX RAM (in memory) from IDX file.</p>
+ * <p>Save (write/overwrite) IDX RAM (in memory) into file, then hand over
+ * its head and dictionary to IDX in file object without reloading saved file.
+ * IDX RAM is destroyed when success, otherwise it's still client's one.</p>
+ * @param pDiIxRm IDX RAM.
+ * @param pPth - dictionary path.
+ * @return IDX in file or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxTx *bsdiixtxrm_save_tx (BsDiIxTxRm *pDiIxRm, char *pPth);
+
+/**
+ * <p>Load IDX RAM (in memory) from IDX file with all it has.</p>
  * @param pPth - dictionary path.
  * @return object or NULL if error or if IDX file not found
  * @set errno if error. "IDX file not found" is not error!
  **/
 BsDiIxTxRm* bsdiixtxrm_load (char *pPth);
 
+/**
+ * <p>Hand over head and dictionary of just made IDX in file to IDX RAM
+ * object, its tables are read from still opened IDX file.
+ * IDX in file is destroyed when success, otherwise it's still client's one.</p>
+ * @param pDiIx IDX in file without mapped IDX v2.
+ * @return IDX RAM or NULL when error
+ * @set errno if error.
+ **/
+BsDiIxTxRm *bsdiixtx_to_rm (BsDiIxTx *pDiIx);
+
 #define BSDICIDXRAM_OPEN_E_RET(p_als, p_dicpth) BsDiIxTxRm* p_als=bsdiixtxrm_load(p_dicpth);\
   if (errno != 0) { BSLOG_ERR return; }
 
@@ -255,6 +602,35 @@ BsDiIxTx* bsdiixtx_load (char *pPth);
 void bsdiixheadtx_load(char *pPth, BsDiIxHeadTx** pHeadRt,
   FILE ** pDicFlRt, FILE **pIdx_file_ret);
 
+/**
+ * <p>Read dictionary name from its head, otherwise it's file name.</p>
+ * @param pDicFl - opened dictionary
+ * @param pFrmt - dictionary format
+ * @param pPth - dictionary path
+ * @return name or NULL when error
+ * @set errno if error.
+ **/
+BsString *bsdiixtx_dic_nme (FILE *pDicFl, EBsDicFrmts pFrmt, char *pPth);
+
+/**
+ * <p>Make headwords FST of ordered i.words if client wants it.
+ * It isn't fatal, IDX is made without FST if it fails.</p>
+ * @param pIwrds - ordered i.words
+ * @param pOpSt - opening state data shared with client
+ * @return FST or NULL if it isn't wanted or failed
+ **/
+char *bsdiixtx_mk_fst (BsDicIwrds *pIwrds, BsDiIxOst* pOpSt);
+
+/**
+ * <p>Make headwords SA of ordered i.words if client wants it.
+ * It isn't fatal, IDX is made without SA if it fails,
+ * e.g. if headwords text is too big.</p>
+ * @param pIwrds - ordered i.words
+ * @param pOpSt - opening state data shared with client
+ * @return SA or NULL if it isn't wanted or failed
+ **/
+char *bsdiixtx_mk_sa (BsDicIwrds *pIwrds, BsDiIxOst* pOpSt);
+
 /**
  * <p>Create IDX RAM (in memory).</p>
  * @param pPth - dictionary path.
@@ -265,7 +641,19 @@ void bsdiixheadtx_load(char *pPth, BsDiIxHeadTx** pHeadRt,
 BsDiIxTxRm* bsdiixtxrm_create (char *pPth, BsDiIxOst* pOpSt);
 
 /**
- * <p>Open DIC IDX, i.e. load or create then load.</p>
+ * <p>Make IDX RAM (in memory) from mapped dictionary whose all headwords
+ * positions are already remembered, e.g. kept and re-parsed ones by update.
+ * It reads only headwords lines.</p>
+ * @param pPth - dictionary path.
+ * @param pDslMm - mapped dictionary with headwords positions in offset order
+ * @param pOpSt - opening state data shared with client
+ * @return object or NULL if stopped or error
+ * @set errno if error.
+ **/
+BsDiIxTxRm* bsdiixtxrm_make (char *pPth, BsDicDslMm *pDslMm, BsDiIxOst* pOpSt);
+
+/**
+ * <p>Open DIC IDX, i.e. load or create, save and hand over made one.</p>
  * @param pPth - dictionary path.
  * @param pOpSt - opening state data shared with client
  * @param pIsIxRm - client prefers IRT (index records table) in memory (RAM) than in file
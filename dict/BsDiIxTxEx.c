@@ -0,0 +1,916 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+#include "stdlib.h"
+#include "string.h"
+#include "limits.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+
+#include "BsLog.h"
+#include "BsError.h"
+#include "BsFioWrap.h"
+#include "BsDicWordDsl.h"
+#include "BsDiIxTxEx.h"
+
+/**
+ * <p>Beigesoft™ maker of text dictionary IDX file within memory budget.</p>
+ * @author Yury Demidenko
+ **/
+
+//mapped record size aligned to pointer:
+#define S_ALIGN(pSz) (((pSz) + sizeof (void*) - 1) & ~(sizeof (void*) - 1))
+
+/**
+ * <p>Sorted run spilled into temporary file.
+ * Record is i.word size, i.word with terminator, offset and length.</p>
+ * @member FILE *fl - temporary file
+ * @member BS_IDX_T cnt - records count
+ * @member BS_IDX_T rdd - read records count
+ * @member BS_SMALL_T iwsz - current i.word size with terminator, 0 means end
+ * @member BS_CHAR_T *iwrd - current i.word buffer
+ * @member BS_FOFST_T ofst - current d.word offset or phrase index
+ * @member BS_SMALL_T len - current d.word length or 0
+ **/
+typedef struct {
+  FILE *fl;
+  BS_IDX_T cnt;
+  BS_IDX_T rdd;
+  BS_SMALL_T iwsz;
+  BS_CHAR_T *iwrd;
+  BS_FOFST_T ofst;
+  BS_SMALL_T len;
+} BsDiIxExRun;
+
+/**
+ * <p>Runs maker data.</p>
+ * @member char *pth - dictionary path, temporary files are made next to it
+ * @member size_t memBdgt - memory budget
+ * @member BS_IDX_T bsz - run's initial buffer size
+ * @member BsDicIwrds *iwrds - current i.words run in RAM or NULL
+ * @member BsDicI2wrds *i2wrds - current i2words run in RAM or NULL
+ * @member BsDiIxExRun **runs - spilled runs
+ * @member int runsSz - spilled runs count
+ * @member int mxIwSz - maximum i.word size of all runs
+ * @member unsigned long alIwSz - all i.words size of all runs
+ **/
+typedef struct {
+  char *pth;
+  size_t memBdgt;
+  BS_IDX_T bsz;
+  BsDicIwrds *iwrds;
+  BsDicI2wrds *i2wrds;
+  BsDiIxExRun **runs;
+  int runsSz;
+  int mxIwSz;
+  unsigned long alIwSz;
+} BsDiIxExRuns;
+
+/**
+ * <p>Merged records in memory mapped temporary file.</p>
+ * @member FILE *fl - temporary file
+ * @member void *map - mapped records then their pointers or NULL
+ * @member size_t mapSz - mapped size
+ **/
+typedef struct {
+  FILE *fl;
+  void *map;
+  size_t mapSz;
+} BsDiIxExMap;
+
+/**
+ * <p>IRT streaming data.</p>
+ * @member FILE *irtFl - temporary IRT with float size records
+ * @member FILE *i2wptFl - temporary I2WPT
+ * @member BsDiIxHirtRdMk *hirtrdmk - HIRT record maker
+ * @member BsDiIxHirtRd **hirt - made HIRT records
+ * @member int hirtSz - made HIRT records count
+ * @member int hirtBsz - HIRT buffer size
+ * @member BS_IDX_T irtSz - made IRT records count
+ * @member BS_IDX_T i2wptSz - made I2WPT records count
+ **/
+typedef struct {
+  FILE *irtFl;
+  FILE *i2wptFl;
+  BsDiIxHirtRdMk *hirtrdmk;
+  BsDiIxHirtRd **hirt;
+  int hirtSz;
+  int hirtBsz;
+  BS_IDX_T irtSz;
+  BS_IDX_T i2wptSz;
+} BsDiIxExIrt;
+
+/**
+ * <p>Open new temporary file next to dictionary.
+ * It's unlinked at once, so it'll be removed on closing.</p>
+ * @param pPth - dictionary path
+ * @return file or NULL when error
+ * @set errno if error.
+ **/
+static FILE*
+  s_tmp_open (char *pPth)
+{
+  char pth[strlen (pPth) + 8];
+  strcpy (pth, pPth);
+  strcat (pth, ".XXXXXX");
+  int fd = mkstemp (pth);
+  BS_IF_EN_RETN (fd == -1, BSE_OPEN_FILE)
+  unlink (pth);
+  FILE *rz = fdopen (fd, "w+b");
+  if ( rz == NULL )
+  {
+    close (fd);
+    if ( errno == 0 ) { errno = BSE_OPEN_FILE; }
+    BSLOG_ERR
+  }
+  return rz;
+}
+
+/**
+ * <p>Release all spilled runs.</p>
+ * @param pRuns - runs data
+ **/
+static void
+  s_runs_clear (BsDiIxExRuns *pRuns)
+{
+  for ( int i = 0; i < pRuns->runsSz; i++ )
+  {
+    if ( pRuns->runs[i]->fl != NULL )
+                { fclose (pRuns->runs[i]->fl); }
+    if ( pRuns->runs[i]->iwrd != NULL )
+                { free (pRuns->runs[i]->iwrd); }
+    free (pRuns->runs[i]);
+  }
+  if ( pRuns->runs != NULL )
+              { free (pRuns->runs); }
+  pRuns->runs = NULL;
+  pRuns->runsSz = 0;
+}
+
+/**
+ * <p>Write sorted set into new run's temporary file.</p>
+ * @param pRuns - runs data
+ * @param pSet - sorted i.words or i2words
+ * @param pIsI2w - if i2words
+ * @set errno if error.
+ **/
+static void
+  s_spill (BsDiIxExRuns *pRuns, BsDicIwrdsBs *pSet, bool pIsI2w)
+{
+  BS_SMALL_T iwsz, len;
+  BS_FOFST_T ofst;
+  BsDiIxExRun **runs = realloc (pRuns->runs, (pRuns->runsSz + 1) * sizeof (BsDiIxExRun*));
+  BS_IF_EN_RET (runs == NULL, ENOMEM)
+  pRuns->runs = runs;
+  BsDiIxExRun *run = malloc (sizeof (BsDiIxExRun));
+  BS_IF_EN_RET (run == NULL, ENOMEM)
+  run->fl = NULL;
+  run->iwrd = NULL;
+  run->cnt = pSet->size;
+  run->rdd = BS_IDX_0;
+  pRuns->runs[pRuns->runsSz++] = run;
+  BS_DO_E_RET (run->fl = s_tmp_open (pRuns->pth))
+  for ( BS_IDX_T l = BS_IDX_0; l < pSet->size; l++ )
+  {
+    iwsz = bsdicidx_istr_len (pSet->vals[l]->iword) + 1;
+    if ( pIsI2w )
+    {
+      ofst = ((BsDicI2wrdRd*) pSet->vals[l])->iphrase_idx;
+      len = 0;
+    } else {
+      ofst = ((BsDicIwrdRd*) pSet->vals[l])->offset_dword;
+      len = ((BsDicIwrdRd*) pSet->vals[l])->length_dword;
+    }
+    BS_DO_E_RET (bsfwrite_bssmall (&iwsz, run->fl))
+    BS_DO_E_RET (bsfwrite_bschars (pSet->vals[l]->iword, iwsz, run->fl))
+    BS_DO_E_RET (bsfwrite_bsfoffset (&ofst, run->fl))
+    BS_DO_E_RET (bsfwrite_bssmall (&len, run->fl))
+  }
+  BSLOG_LOG (BSLINFO, "Spilled run#%d, records="BS_IDX_FMT"\n", pRuns->runsSz, pSet->size)
+}
+
+/**
+ * <p>Sort current i.words run without duplicates, spill it
+ * and start new one.</p>
+ * @param pRuns - runs data
+ * @param pIsLst - if the last run, so new one isn't needed
+ * @set errno if error.
+ **/
+static void
+  s_spill_iwrds (BsDiIxExRuns *pRuns, bool pIsLst)
+{
+  BsDicIdxAb *ab = pRuns->iwrds->idx_ab;
+  if ( pRuns->mxIwSz < pRuns->iwrds->max_iword_size )
+              { pRuns->mxIwSz = pRuns->iwrds->max_iword_size; }
+  pRuns->alIwSz += pRuns->iwrds->all_iwords_size;
+  if ( pRuns->iwrds->size > BS_IDX_0 )
+  {
+    BS_DO_E_RET (bsdiciwrds_sort (pRuns->iwrds, 0))
+    BS_DO_E_RET (s_spill (pRuns, (BsDicIwrdsBs*) pRuns->iwrds, false))
+  }
+  pRuns->iwrds = bsdiciwrds_free (pRuns->iwrds);
+  if ( !pIsLst )
+  {
+    BS_DO_E_RET (pRuns->iwrds = bsdiciwrds_new_ar (pRuns->bsz, ab))
+  }
+}
+
+/**
+ * <p>Stable sort current i2words run, spill it and start new one.</p>
+ * @param pRuns - runs data
+ * @param pIsLst - if the last run, so new one isn't needed
+ * @set errno if error.
+ **/
+static void
+  s_spill_i2wrds (BsDiIxExRuns *pRuns, bool pIsLst)
+{
+  BsDicIdxAb *ab = pRuns->i2wrds->idx_ab;
+  if ( pRuns->i2wrds->size > BS_IDX_0 )
+  {
+    BS_DO_E_RET (bsdatasettus_sort ((BsDataSetTus*) pRuns->i2wrds,
+                   (Bs_Compare*) &bsdici2wrdrd_compare, 0))
+    BS_DO_E_RET (s_spill (pRuns, (BsDicIwrdsBs*) pRuns->i2wrds, true))
+  }
+  pRuns->i2wrds = bsdici2wrds_free (pRuns->i2wrds);
+  if ( !pIsLst )
+  {
+    BS_DO_E_RET (pRuns->i2wrds = bsdici2wrds_new_ar (pRuns->bsz, ab))
+  }
+}
+
+/**
+ * <p>Type-unsafe consumer of just read dic.word. It appends i.word into
+ * current run, and spills it when memory budget is exceeded.</p>
+ * @param pDwrd - just read d.word
+ * @param pRuns - runs data
+ * @return 0 to continue iteration, otherwise stop iteration
+ * @set errno if error.
+ **/
+static int
+  s_dwrd_csm (BsDicWord *pDwrd, BsDiIxExRuns *pRuns)
+{
+  int rz = bsdiciwrds_dwrd_csm_apnd (pDwrd, pRuns->iwrds);
+  if ( rz != 0 )
+                { return rz; }
+  if ( pRuns->iwrds->arena->alcd + pRuns->iwrds->bsize * sizeof (void*)
+         >= pRuns->memBdgt )
+  {
+    BS_DO_E_RETE (s_spill_iwrds (pRuns, false))
+  }
+  return 0;
+}
+
+/**
+ * <p>Read next record of run.</p>
+ * @param pRun - run
+ * @set errno if error.
+ **/
+static void
+  s_run_next (BsDiIxExRun *pRun)
+{
+  if ( pRun->rdd == pRun->cnt )
+  {
+    pRun->iwsz = 0;
+    return;
+  }
+  BS_DO_E_RET (bsfread_bssmall (&pRun->iwsz, pRun->fl))
+  BS_DO_E_RET (bsfread_bschars (pRun->iwrd, pRun->iwsz, pRun->fl))
+  BS_DO_E_RET (bsfread_bsfoffset (&pRun->ofst, pRun->fl))
+  BS_DO_E_RET (bsfread_bssmall (&pRun->len, pRun->fl))
+  pRun->rdd++;
+}
+
+/**
+ * <p>Merge spilled runs into temporary file with records
+ * BsDicIwrdRd or BsDicI2wrdRd followed by i.word.
+ * Equal i.words are taken from runs in their order,
+ * so the first d.word wins.</p>
+ * @param pRuns - runs data
+ * @param pMap - map with temporary file to write into
+ * @param pIsI2w - if i2words, otherwise i.words without duplicates
+ * @return merged records count
+ * @set errno if error.
+ **/
+static BS_IDX_T
+  s_merge (BsDiIxExRuns *pRuns, BsDiIxExMap *pMap, bool pIsI2w)
+{
+  int i, mn;
+  BS_IDX_T cnt = BS_IDX_0;
+  size_t hdSz = pIsI2w ? sizeof (BsDicI2wrdRd) : sizeof (BsDicIwrdRd);
+  char zrs[sizeof (void*)];
+  BS_CHAR_T *lst = malloc (pRuns->mxIwSz * BS_CHAR_LEN + BS_CHAR_LEN);
+  if ( lst == NULL )
+  {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+    return BS_IDX_0;
+  }
+  lst[0] = 0;
+  memset (zrs, 0, sizeof (zrs));
+  for ( i = 0; i < pRuns->runsSz; i++ )
+  {
+    pRuns->runs[i]->iwrd = malloc (pRuns->mxIwSz * BS_CHAR_LEN);
+    BS_IF_EN_OUTE (pRuns->runs[i]->iwrd == NULL, ENOMEM)
+    rewind (pRuns->runs[i]->fl);
+    BS_DO_E_OUTE (s_run_next (pRuns->runs[i]))
+  }
+  while ( true )
+  {
+    mn = -1;
+    for ( i = 0; i < pRuns->runsSz; i++ )
+    {
+      if ( pRuns->runs[i]->iwsz > 0 && ( mn == -1
+        || bsdicidx_istr_cmp (pRuns->runs[i]->iwrd, pRuns->runs[mn]->iwrd) < 0 ) )
+                  { mn = i; }
+    }
+    if ( mn == -1 )
+                { break; }
+    BsDiIxExRun *run = pRuns->runs[mn];
+    if ( pIsI2w || cnt == BS_IDX_0 || bsdicidx_istr_cmp (lst, run->iwrd) != 0 )
+    {
+      if ( pIsI2w )
+      {
+        BsDicI2wrdRd rd;
+        memset (&rd, 0, hdSz);
+        rd.iphrase_idx = run->ofst;
+        BS_IF_EN_OUTE (fwrite (&rd, hdSz, 1, pMap->fl) != 1, BSE_WRITE_FILE)
+      } else {
+        BsDicIwrdRd rd;
+        memset (&rd, 0, hdSz);
+        rd.offset_dword = run->ofst;
+        rd.length_dword = run->len;
+        BS_IF_EN_OUTE (fwrite (&rd, hdSz, 1, pMap->fl) != 1, BSE_WRITE_FILE)
+        bsdicidx_istr_cpy (lst, run->iwrd);
+      }
+      BS_DO_E_OUTE (bsfwrite_bschars (run->iwrd, run->iwsz, pMap->fl))
+      size_t pdSz = S_ALIGN (hdSz + run->iwsz * BS_CHAR_LEN) - hdSz - run->iwsz * BS_CHAR_LEN;
+      BS_IF_EN_OUTE (pdSz > 0 && fwrite (zrs, pdSz, 1, pMap->fl) != 1, BSE_WRITE_FILE)
+      cnt++;
+    }
+    BS_DO_E_OUTE (s_run_next (run))
+  }
+  free (lst);
+  return cnt;
+oute:
+  free (lst);
+  return BS_IDX_0;
+}
+
+/**
+ * <p>Map merged records and make their pointers array after them.</p>
+ * @param pMap - map with just written temporary file
+ * @param pCnt - records count
+ * @param pIsI2w - if i2words
+ * @return pointers array or NULL if empty or error
+ * @set errno if error.
+ **/
+static void**
+  s_map (BsDiIxExMap *pMap, BS_IDX_T pCnt, bool pIsI2w)
+{
+  if ( pCnt == BS_IDX_0 )
+                { return NULL; }
+  size_t hdSz = pIsI2w ? sizeof (BsDicI2wrdRd) : sizeof (BsDicIwrdRd);
+  BS_IF_EN_RETN (fflush (pMap->fl) != 0, BSE_WRITE_FILE)
+  long rdsSz = ftell (pMap->fl);
+  BS_IF_EN_RETN (rdsSz < 0, BSE_SEEK_FILE)
+  pMap->mapSz = rdsSz + pCnt * sizeof (void*);
+  BS_IF_EN_RETN (ftruncate (fileno (pMap->fl), pMap->mapSz) != 0, BSE_WRITE_FILE)
+  void *map = mmap (NULL, pMap->mapSz, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fileno (pMap->fl), 0);
+  BS_IF_EN_RETN (map == MAP_FAILED, BSE_OPEN_FILE)
+  pMap->map = map;
+  void **vals = (void**) ((char*) map + rdsSz);
+  char *rd = (char*) map;
+  for ( BS_IDX_T l = BS_IDX_0; l < pCnt; l++ )
+  {
+    BsDicIwrdRdBs *rdb = (BsDicIwrdRdBs*) rd;
+    rdb->iword = (BS_CHAR_T*) (rd + hdSz);
+    vals[l] = rd;
+    rd += S_ALIGN (hdSz + (bsdicidx_istr_len (rdb->iword) + 1) * BS_CHAR_LEN);
+  }
+  return vals;
+}
+
+/**
+ * <p>Release map.</p>
+ * @param pMap - map
+ **/
+static void
+  s_map_clear (BsDiIxExMap *pMap)
+{
+  if ( pMap->map != NULL )
+              { munmap (pMap->map, pMap->mapSz); }
+  if ( pMap->fl != NULL )
+              { fclose (pMap->fl); }
+  pMap->map = NULL;
+  pMap->fl = NULL;
+}
+
+/**
+ * <p>Add just made HIRT record.</p>
+ * @param pIrt - IRT streaming data
+ * @set errno if error.
+ **/
+static void
+  s_hirt_add (BsDiIxExIrt *pIrt)
+{
+  BS_IF_ENM_RET (pIrt->hirtSz == pIrt->hirtBsz, BSE_OUT_BUFFER_SIZE, "HIRT full!\n")
+  BS_DO_E_RET (pIrt->hirt[pIrt->hirtSz] = bsdicidxhirtrd_new_fill (pIrt->hirtrdmk))
+  pIrt->hirtSz++;
+}
+
+/**
+ * <p>Consumer of just made IRT record data that writes float size record
+ * into temporary IRT and its indexes into temporary I2WPT.
+ * It also makes HIRT.</p>
+ * @param pMchd - record data
+ * @param pIrt - IRT streaming data
+ * @return 0 to continue iteration or errno
+ * @set errno if error.
+ **/
+static int
+  s_irt_csm (BsDicIdxIrtMchd *pMchd, BsDiIxExIrt *pIrt)
+{
+  BS_IDX_T i2wptStt = BS_IDX_NULL;
+  unsigned char iwsz;
+  BS_IF_EN_RETE (pMchd->idx_subwrd_size > UCHAR_MAX, BSE_INTEGER_OVERFLOW)
+  if ( pMchd->dwolt_start == BS_IDX_NULL && pMchd->i2wpt_quantity <= 0 )
+  {
+    errno = BSE_VALIDATE_ERR;
+    BSLOG_LOG (BSLERROR, "irt["BS_IDX_FMT"]-dwolt_start == NULL && i2wpt_quantity <= 0\n", pIrt->irtSz)
+    return errno;
+  }
+  //HIRT:
+  if ( pIrt->hirtrdmk->fchar != pMchd->idx_subwrd[0] )
+  {
+    if ( pIrt->hirtrdmk->fchar != 0 ) //next first char
+                { BS_DO_E_RETE (s_hirt_add (pIrt)) }
+    bsdiixhirtrdmk_init (pIrt->hirtrdmk);
+    pIrt->hirtrdmk->fchar = pMchd->idx_subwrd[0];
+    pIrt->hirtrdmk->irtIdx = pIrt->irtSz;
+  }
+  if ( pMchd->idx_subwrd[1] != 0 )
+  {
+    BS_DO_E_RETE (bsdiixhirtrdmk_make (pIrt->hirtrdmk, pMchd->idx_subwrd[1], pIrt->irtSz))
+  }
+  //I2WPT:
+  if ( pMchd->i2wpt_quantity > 0 )
+  {
+    for ( int i = 0; i < pMchd->i2wpt_quantity; i++ )
+    {
+      if ( pMchd->i2wpt_dwolt_idx[i] == BS_IDX_NULL )
+      {
+        errno = BSE_VALIDATE_ERR;
+        BSLOG_LOG (BSLERROR, "irt["BS_IDX_FMT"]-i2wpt_dwolt_idx[%d] == NULL\n", pIrt->irtSz, i)
+        return errno;
+      }
+    }
+    i2wptStt = pIrt->i2wptSz;
+    BS_DO_E_RETE (bsfwrite_bsindexs (pMchd->i2wpt_dwolt_idx, pMchd->i2wpt_quantity, pIrt->i2wptFl))
+    pIrt->i2wptSz += pMchd->i2wpt_quantity;
+  }
+  //IRT:
+  iwsz = pMchd->idx_subwrd_size;
+  BS_DO_E_RETE (bsfwrite_uchar (&iwsz, pIrt->irtFl))
+  BS_DO_E_RETE (bsfwrite_bschars (pMchd->idx_subwrd, iwsz, pIrt->irtFl))
+  BS_DO_E_RETE (bsfwrite_bsindex (&pMchd->dwolt_start, pIrt->irtFl))
+  BS_DO_E_RETE (bsfwrite_bssmall (&pMchd->i2wpt_quantity, pIrt->irtFl))
+  BS_DO_E_RETE (bsfwrite_bsindex (&i2wptStt, pIrt->irtFl))
+  pIrt->irtSz++;
+  return 0;
+}
+
+/**
+ * <p>Stream IRT, I2WPT into temporary files and make HIRT.</p>
+ * @param pIwrds - ordered iwords array
+ * @param pI2wrds - ordered i2words array or NULL
+ * @param pIrtTots IRT totals to make
+ * @param pIrt - IRT streaming data
+ * @set errno if error.
+ **/
+static void
+  s_irt_make (BsDicIwrds *pIwrds, BsDicI2wrds *pI2wrds,
+              BsDicIdxIrtTots *pIrtTots, BsDiIxExIrt *pIrt)
+{
+  BSDIIXHIRTRDMK_CREATE(hirtrdmk, pIwrds->idx_ab->chrsTot)
+  pIrt->hirtrdmk = &hirtrdmk;
+  bsdicidxirtraw_iter (pIwrds, pI2wrds, pIrtTots,
+    (BsDicIdxIrtMchd_Csm*) s_irt_csm, (void*) pIrt);
+  if ( errno == 0 && pIrt->irtSz > BS_IDX_0 )
+  { //last accumulated HIRT data:
+    s_hirt_add (pIrt);
+  }
+  pIrt->hirtrdmk = NULL;
+}
+
+/**
+ * <p>Write IDX file from head, streamed IRT, I2WPT and mapped i.words,
+ * that are also source of FST and SA.</p>
+ * @param pHead - head with HIRT
+ * @param pIrt - IRT streaming data
+ * @param pIwrds - mapped ordered i.words
+ * @param pDicFl - dictionary to read headwords into HWP
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ * @return IDX file positioned at IRT or NULL when error
+ * @set errno if error.
+ **/
+static FILE*
+  s_save (BsDiIxHeadTx *pHead, BsDiIxExIrt *pIrt, BsDicIwrds *pIwrds,
+          FILE *pDicFl, char *pPth, BsDiIxOst* pOpSt)
+{
+  //vars:
+  FILE *idxFl;
+  BsDiIxHwpMk *hwpMk = NULL;
+  char *fst = NULL;
+  char *sa = NULL;
+  BS_CHAR_T bschr0, chrs[UCHAR_MAX + 1];
+  BS_IDX_T l, dwoltStt, i2wptStt, dwoltSz;
+  BS_SMALL_T i2wptQt;
+  unsigned char iwsz;
+  BS_FOFST_T irtOfst;
+  int lenr, flgs;
+  //vars init0:
+  bschr0 = 0;
+  dwoltSz = BS_IDX_0;
+  BS_DO_E_RETN (bsdiixheadtx_mk_flgs (pHead, pDicFl))
+  flgs = pHead->flgs;
+  //Head base:
+  BS_DO_E_RETN (idxFl = bsdiixheadbs_save ((BsDiIxHeadBs*) pHead, pPth))
+  //rest of totals:
+  BS_DO_E_OUT (bsdiixheadtx_write_tots (pHead, idxFl))
+  BS_DO_E_OUT (bsdiixtx_write_pad (flgs, idxFl))
+  irtOfst = ftell (idxFl);
+  //IRT:
+  rewind (pIrt->irtFl);
+  for ( l = BS_IDX_0; l < pHead->irtSz; l++ )
+  {
+    BS_DO_E_OUT (bsfread_uchar (&iwsz, pIrt->irtFl))
+    BS_DO_E_OUT (bsfread_bschars (chrs, iwsz, pIrt->irtFl))
+    BS_DO_E_OUT (bsfread_bsindex (&dwoltStt, pIrt->irtFl))
+    BS_DO_E_OUT (bsfread_bssmall (&i2wptQt, pIrt->irtFl))
+    BS_DO_E_OUT (bsfread_bsindex (&i2wptStt, pIrt->irtFl))
+    if ( pHead->mxIrWdSz == 0 )
+    {
+      BS_DO_E_OUT (bsfwrite_uchar (&iwsz, idxFl))
+    }
+    BS_DO_E_OUT (bsfwrite_bschars (chrs, iwsz, idxFl))
+    if ( pHead->mxIrWdSz > 0 )
+    {
+      lenr = pHead->mxIrWdSz - iwsz;
+      if ( lenr > 0 )
+            { BS_DO_E_OUT (bsfwrite_bscharn(&bschr0, lenr, idxFl)) }
+    }
+    BS_DO_E_OUT (bsdiixtx_write_idx (&dwoltStt, flgs, idxFl))
+    BS_DO_E_OUT (bsfwrite_bssmall (&i2wptQt, idxFl))
+    BS_DO_E_OUT (bsdiixtx_write_idx (&i2wptStt, flgs, idxFl))
+  }
+  //I2WPT:
+  BS_DO_E_OUT (bsdiixtx_write_pad (flgs, idxFl))
+  rewind (pIrt->i2wptFl);
+  for ( l = BS_IDX_0; l < pHead->i2wptSz; l++ )
+  {
+    BS_DO_E_OUT (bsfread_bsindex (&i2wptStt, pIrt->i2wptFl))
+    BS_DO_E_OUT (bsdiixtx_write_idx (&i2wptStt, flgs, idxFl))
+  }
+  //DWOLT:
+  BS_DO_E_OUT (bsdiixtx_write_pad (flgs, idxFl))
+  for ( l = BS_IDX_0; l < pIwrds->size; l++ )
+  {
+    if ( pIwrds->vals[l]->length_dword != 0 )
+    {
+      BS_DO_E_OUT (bsdiixtx_write_ofst (&pIwrds->vals[l]->offset_dword, flgs, idxFl))
+      BS_DO_E_OUT (bsfwrite_bssmall (&pIwrds->vals[l]->length_dword, idxFl))
+      dwoltSz++;
+    }
+  }
+  if ( dwoltSz != pHead->dwoltSz )
+  {
+    errno = BSE_ALG_ERR;
+    BSLOG_LOG (BSLERROR, "DWOLT size="BS_IDX_FMT", must be "BS_IDX_FMT"\n", dwoltSz, pHead->dwoltSz)
+    goto out;
+  }
+  //HWP:
+  BS_DO_E_OUT (bsdiixtx_write_pad (flgs, idxFl))
+  BS_DO_E_OUT (hwpMk = bsdiixhwpmk_new (idxFl, pDicFl, pHead->ab, dwoltSz))
+  for ( l = BS_IDX_0; l < pIwrds->size; l++ )
+  {
+    if ( pIwrds->vals[l]->length_dword != 0 )
+    {
+      BS_DO_E_OUT (bsdiixhwpmk_add (hwpMk, pIwrds->vals[l]->offset_dword, pIwrds->vals[l]->length_dword))
+    }
+  }
+  BS_DO_E_OUT (bsdiixhwpmk_end (hwpMk))
+  hwpMk = bsdiixhwpmk_free (hwpMk);
+  //FST:
+  fst = bsdiixtx_mk_fst (pIwrds, pOpSt);
+  if ( fst != NULL )
+  {
+    BS_DO_E_OUT (bsdiixtx_write_pad (flgs, idxFl))
+    BS_DO_E_OUT (bsdiixfst_write (fst, idxFl))
+    free (fst); fst = NULL;
+  }
+  //SA:
+  sa = bsdiixtx_mk_sa (pIwrds, pOpSt);
+  if ( sa != NULL )
+  {
+    BS_DO_E_OUT (bsdiixtx_write_pad (flgs, idxFl))
+    BS_DO_E_OUT (bsdiixsa_write (sa, idxFl))
+    free (sa); sa = NULL;
+  }
+  BS_DO_E_OUT (bsdiixheadtx_save_sum (pHead, idxFl, irtOfst, pPth))
+  //FPT:
+  if ( pHead->fpt != NULL )
+        { BS_DO_E_OUT (bsdiixfpt_save (pHead->fpt, idxFl)) }
+  BS_IF_EN_OUT (fflush (idxFl) != 0, BSE_WRITE_FILE)
+  BS_DO_E_OUT (bsdiixheadbs_save_end (pPth, true))
+  BS_DO_E_OUT (bsfseek_goto (idxFl, irtOfst))
+  BSLOG_LOG (BSLINFO, "%s IDX has been successfully saved!\n", pPth);
+  return idxFl;
+out:
+  bsdiixhwpmk_free (hwpMk);
+  free (fst);
+  free (sa);
+  fclose (idxFl);
+  bsdiixheadbs_save_end (pPth, false);
+  return NULL;
+}
+
+/**
+ * <p>Make in memory IDX, then save it and hand it over,
+ * as it's too small dictionary for spilling.</p>
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ * @return IDX in file or NULL if stopped or error
+ * @set errno if error.
+ **/
+static BsDiIxTx*
+  s_create_rm (char *pPth, BsDiIxOst* pOpSt)
+{
+  BsDiIxTx *diIx = NULL;
+  BS_DO_E_RETN (BsDiIxTxRm *diIxRm = bsdiixtxrm_create (pPth, pOpSt))
+  if ( diIxRm != NULL )
+  {
+    BS_DO_E_OUT (bsdiixtxrm_validate (diIxRm))
+    BS_DO_E_OUT (diIx = bsdiixtxrm_save_tx (diIxRm, pPth))
+    return diIx;
+  }
+out:
+  bsdiixtxrm_destroy (diIxRm);
+  return NULL;
+}
+
+/**
+ * <p>Make IDX file within memory budget pOpSt->memBdgt.
+ * Headwords positions, alphabet and HIRT are still in memory,
+ * merged i.words and i2words are in memory mapped temporary files.
+ * Saved IDX file is handed over without reloading.</p>
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ * @return IDX in file or NULL if stopped or error
+ * @set errno if error.
+ **/
+BsDiIxTx*
+  bsdiixtxex_create (char *pPth, BsDiIxOst* pOpSt)
+{
+  //vars:
+  BsDiIxTx *diIx = NULL;
+  FILE *idxFl = NULL;
+  BS_IDX_T l, cnt;
+  BsDicIdxAb *idx_ab = NULL;
+  BsDicDslMm *dslMm = NULL;
+  BsDicIdxIrtTots *irt_tots = NULL;
+  BsDiIxHeadTx *head = NULL;
+  BsDicIwrds *iwrds = NULL;
+  BsDicI2wrds *i2wrds = NULL;
+  BsDiIxFpt *fpt = NULL;
+  BsDiIxExRuns runs = { .pth=pPth, .memBdgt=pOpSt->memBdgt, .bsz=BS_IDX_1,
+    .iwrds=NULL, .i2wrds=NULL, .runs=NULL, .runsSz=0, .mxIwSz=0, .alIwSz=0L };
+  BsDiIxExMap iwMap = { .fl=NULL, .map=NULL, .mapSz=0 };
+  BsDiIxExMap i2wMap = { .fl=NULL, .map=NULL, .mapSz=0 };
+  BsDiIxExIrt irt = { .irtFl=NULL, .i2wptFl=NULL, .hirtrdmk=NULL, .hirt=NULL,
+    .hirtSz=0, .hirtBsz=0, .irtSz=BS_IDX_0, .i2wptSz=BS_IDX_0 };
+  bool isSvd = false;
+  //code:
+  FILE *dicFl = fopen(pPth, "r");
+  BS_IF_EN_RETN (dicFl == NULL, BSE_OPEN_FILE)
+  //0. Check DIC format:
+  BS_DO_E_OUTE(EBsDicFrmts dfmt = bsdicfrmt_get_format(dicFl))
+  if ( dfmt != DFRM_DSL )
+  {
+    errno = BSE_UNIMPLEMENTED;
+    BSLOG_LOG(BSLERROR, "Dic formar#%d unimplemented!\n", dfmt);
+    goto oute;
+  }
+  //1. making AB and remembering headwords positions:
+  BS_DO_E_OUTE (dslMm = bsdicdslmm_new (dicFl))
+  BS_DO_E_OUTE (idx_ab = bsdicidxab_new (BDI_AB_BUF_INITSIZE))
+  BSDICIDXABTOTALS_CREATE(ab_tots)
+  BS_DO_E_OUTE (bsdicidxab_iter_dslmm_fill (dslMm, BS_DIC_ENTRY_BUFFER_SIZE, idx_ab, &ab_tots))
+  BS_DO_E_OUTE (fpt = bsdiixfpt_new_make (dslMm, BS_DIC_ENTRY_BUFFER_SIZE, pPth))
+  bsdiixfpt_add_hws (fpt, dslMm->hwOfsts, dslMm->hwSz);
+  pOpSt->prgr = 20;
+  if ( pOpSt->stp )
+                { goto oute; }
+  //2. making i.words sorted runs within budget:
+  runs.bsz = runs.memBdgt / (sizeof (void*) * 16);
+  if ( runs.bsz > ab_tots.dwoltSz )
+                { runs.bsz = ab_tots.dwoltSz; }
+  if ( runs.bsz < BS_IDX_1 )
+                { runs.bsz = BS_IDX_1; }
+  BS_DO_E_OUTE (runs.iwrds = bsdiciwrds_new_ar (runs.bsz, idx_ab))
+  BS_DO_E_OUTE (bsdicdslmm_iter_hw (dslMm, BS_DIC_ENTRY_BUFFER_SIZE,
+                  (BsDicWord_Consume_Tus*) s_dwrd_csm, (void*) &runs))
+  BS_DO_E_OUTE (s_spill_iwrds (&runs, true))
+  dslMm = bsdicdslmm_free (dslMm);
+  pOpSt->prgr = 40;
+  if ( pOpSt->stp )
+                { goto oute; }
+  //3. merging runs into mapped i.words:
+  BS_DO_E_OUTE (iwMap.fl = s_tmp_open (pPth))
+  BS_DO_E_OUTE (cnt = s_merge (&runs, &iwMap, false))
+  s_runs_clear (&runs);
+  if ( cnt < BDI_MAX_IWORDS_TO_AVOIDI2W )
+  { //i2words will be added into i.words:
+    s_map_clear (&iwMap);
+    fclose (dicFl);
+    bsdicidxab_free (idx_ab);
+    bsdiixfpt_free (fpt);
+    BSLOG_LOG (BSLINFO, "Small dictionary %s with i.words="BS_IDX_FMT" is made in memory\n", pPth, cnt)
+    return s_create_rm (pPth, pOpSt);
+  }
+  iwrds = malloc (sizeof (BsDicIwrds));
+  BS_IF_EN_OUTE (iwrds == NULL, ENOMEM)
+  iwrds->bsize = cnt;
+  iwrds->size = cnt;
+  iwrds->dwoltSz = cnt;
+  iwrds->idx_ab = idx_ab;
+  iwrds->arena = NULL;
+  iwrds->max_iword_size = runs.mxIwSz;
+  iwrds->all_iwords_size = runs.alIwSz;
+  BS_DO_E_OUTE (iwrds->vals = (BsDicIwrdRd**) s_map (&iwMap, cnt, false))
+  BSLOG_LOG (BSLINFO, "Merged i.words: size="BS_IDX_FMT", max i.word size=%d, all_iwords_size="BS_IDX_FMT", chars=%d\n", iwrds->size, iwrds->max_iword_size, iwrds->all_iwords_size, idx_ab->chrsTot);
+  BS_DO_E_OUTE (bsdiixfpt_sub_dwolt (fpt, iwrds))
+  if ( pOpSt->stp )
+                { goto oute; }
+  //4. making i2words sorted runs then merging them:
+  if ( ab_tots.i2wptSz > BS_IDX_0 )
+  {
+    BS_DO_E_OUTE (runs.i2wrds = bsdici2wrds_new_ar (runs.bsz, idx_ab))
+    for ( l = BS_IDX_0; l < iwrds->size; l++ )
+    {
+      BS_DO_E_OUTE (bsdici2wrds_add_phrase (runs.i2wrds, iwrds, l))
+      if ( runs.i2wrds->arena->alcd + runs.i2wrds->bsize * sizeof (void*)
+             >= runs.memBdgt )
+      {
+        BS_DO_E_OUTE (s_spill_i2wrds (&runs, false))
+      }
+    }
+    BS_DO_E_OUTE (s_spill_i2wrds (&runs, true))
+    BS_DO_E_OUTE (i2wMap.fl = s_tmp_open (pPth))
+    BS_DO_E_OUTE (cnt = s_merge (&runs, &i2wMap, true))
+    s_runs_clear (&runs);
+    i2wrds = malloc (sizeof (BsDicI2wrds));
+    BS_IF_EN_OUTE (i2wrds == NULL, ENOMEM)
+    i2wrds->bsize = cnt;
+    i2wrds->size = cnt;
+    i2wrds->idx_ab = idx_ab;
+    i2wrds->arena = NULL;
+    BS_DO_E_OUTE (i2wrds->vals = (BsDicI2wrdRd**) s_map (&i2wMap, cnt, true))
+    BSLOG_LOG (BSLINFO, "Merged i2words: size="BS_IDX_FMT"\n", i2wrds->size);
+  }
+  pOpSt->prgr = 60;
+  if ( pOpSt->stp )
+                { goto oute; }
+  //5. streaming IRT and I2WPT:
+  BS_DO_E_OUTE (irt_tots = bsdicidxirttotals_new ())
+  irt_tots->ab_chars_total = idx_ab->chrsTot;
+  irt.hirtBsz = idx_ab->chrsTot;
+  irt.hirt = malloc (irt.hirtBsz * sizeof (BsDiIxHirtRd*));
+  BS_IF_EN_OUTE (irt.hirt == NULL, ENOMEM)
+  BS_DO_E_OUTE (irt.irtFl = s_tmp_open (pPth))
+  BS_DO_E_OUTE (irt.i2wptFl = s_tmp_open (pPth))
+  BS_DO_E_OUTE (s_irt_make (iwrds, i2wrds, irt_tots, &irt))
+  if ( irt.irtSz != irt_tots->irtSz || irt.i2wptSz != irt_tots->i2wptSz
+        || irt.hirtSz != irt_tots->hirtSz )
+  {
+    errno = BSE_ALG_ERR;
+    BSLOG_LOG (BSLERROR, "Streamed IRT doesn't match to totals!\n")
+    goto oute;
+  }
+  pOpSt->prgr = 80;
+  if ( pOpSt->stp )
+                { goto oute; }
+  //6. making head and saving IDX:
+  BS_DO_E_OUTE (head = bsdiixheadtx_new_tf (dfmt, iwrds, irt_tots))
+  head->fpt = fpt;
+  fpt = NULL;
+  for ( int i = 0; i < irt.hirtSz; i++ )
+  {
+    BS_DO_E_OUTE (bsdiixheadtx_add_hirtrd (head, irt.hirt[i]))
+    irt.hirt[i] = NULL;
+  }
+  irt.hirtSz = 0;
+  BS_DO_E_OUTE (bsdicidxhirt_validate (head->hirt, head->hirtSz, head->ab))
+  fclose (dicFl); //reopen for further char reading
+  dicFl = fopen (pPth, "r");
+  BS_IF_EN_OUTE (dicFl == NULL, BSE_OPEN_FILE)
+  BS_DO_E_OUTE (head->nme = bsdiixtx_dic_nme (dicFl, dfmt, pPth))
+  isSvd = true;
+  BS_DO_E_OUTE (idxFl = s_save (head, &irt, iwrds, dicFl, pPth, pOpSt))
+  BS_DO_E_OUTE (diIx = bsdiixtx_new (dicFl, idxFl, head))
+  BSLOG_LOG (BSLINFO, "Created DIC IDX within memory budget=%lu, name=%s\n", (unsigned long) runs.memBdgt, head->nme->val)
+  //handed over:
+  dicFl = NULL;
+  idxFl = NULL;
+  head = NULL;
+  idx_ab = NULL;
+
+oute: //or canceled
+  if ( errno != 0 && isSvd )
+  {
+    char idxPth[strlen(pPth) + 10];
+    strcpy (idxPth, pPth);
+    strcat (idxPth, BDI_IDX_FILE_EXT);
+    remove (idxPth);
+  }
+  if ( dicFl != NULL )
+              { fclose (dicFl); }
+  if ( idxFl != NULL )
+              { fclose (idxFl); }
+  bsdicdslmm_free (dslMm);
+  bsdiciwrds_free (runs.iwrds);
+  bsdici2wrds_free (runs.i2wrds);
+  s_runs_clear (&runs);
+  if ( irt.hirt != NULL )
+  {
+    for ( int i = 0; i < irt.hirtSz; i++ )
+                { bsdicidxhirtrd_free (irt.hirt[i]); }
+    free (irt.hirt);
+  }
+  if ( irt.irtFl != NULL )
+              { fclose (irt.irtFl); }
+  if ( irt.i2wptFl != NULL )
+              { fclose (irt.i2wptFl); }
+  s_map_clear (&iwMap);
+  s_map_clear (&i2wMap);
+  if ( iwrds != NULL )
+              { free (iwrds); }
+  if ( i2wrds != NULL )
+              { free (i2wrds); }
+  bsdicidxirttotals_free (irt_tots);
+  bsdiixfpt_free (fpt);
+  if ( head != NULL )
+  {
+    bsdiixheadtx_free (head);
+  } else {
+    bsdicidxab_free (idx_ab);
+  }
+  return diIx;
+}
+
+/**
+ * <p>Pick memory budget to make IDX of given dictionary. Making IDX wholly
+ * in memory takes about BDI_MEMBDGT_FCTR times of dictionary size, if it's
+ * more than half of available memory, then the budget is its quarter.</p>
+ * @param pPth - dictionary path.
+ * @return budget or 0 if IDX can be made wholly in memory
+ *   or available memory is unknown
+ **/
+size_t
+  bsdiixtxex_bdgt (char *pPth)
+{
+  struct stat st;
+  if ( stat (pPth, &st) != 0 )
+                { return 0; } //opening reports it
+  unsigned long long avl = 0;
+  FILE *fl = fopen ("/proc/meminfo", "r");
+  if ( fl != NULL )
+  { //it counts reclaimable cache unlike free pages:
+    char ln[128];
+    while ( fgets (ln, sizeof (ln), fl) != NULL )
+    {
+      if ( sscanf (ln, "MemAvailable: %llu", &avl) == 1 )
+      {
+        avl *= 1024ULL;
+        break;
+      }
+    }
+    fclose (fl);
+  }
+  if ( avl == 0 )
+  {
+    long pgs = sysconf (_SC_AVPHYS_PAGES);
+    long pgSz = sysconf (_SC_PAGESIZE);
+    if ( pgs > 0 && pgSz > 0 )
+                { avl = (unsigned long long) pgs * pgSz; }
+  }
+  if ( avl == 0
+       || (unsigned long long) st.st_size * BDI_MEMBDGT_FCTR <= avl / 2 )
+                { return 0; }
+  BSLOG_LOG (BSLINFO, "Dictionary size=%lld, available memory=%llu, IDX will be made within quarter of it\n", (long long) st.st_size, avl)
+  return (size_t) ( avl / 4 );
+}
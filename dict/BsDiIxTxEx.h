@@ -0,0 +1,42 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ maker of text dictionary IDX file within memory budget.
+ * Sorted runs of i.words and i2words are spilled into temporary files,
+ * then they are merged, and IRT, I2WPT and DWOLT are streamed into IDX file,
+ * so it's same as made by bsdiixtxrm_create and bsdiixtxrm_save.</p>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXTXEX
+#define BS_DEBUGL_DIIXTXEX 30800
+
+#include "BsDiIxTx.h"
+
+//memory to make IDX wholly in memory per dictionary byte:
+#define BDI_MEMBDGT_FCTR 4
+
+/**
+ * <p>Make IDX file within memory budget pOpSt->memBdgt.
+ * Headwords positions, alphabet and HIRT are still in memory,
+ * merged i.words and i2words are in memory mapped temporary files.
+ * Saved IDX file is handed over without reloading.</p>
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ * @return IDX in file or NULL if stopped or error
+ * @set errno if error.
+ **/
+BsDiIxTx *bsdiixtxex_create (char *pPth, BsDiIxOst* pOpSt);
+
+/**
+ * <p>Pick memory budget to make IDX of given dictionary. Making IDX wholly
+ * in memory takes about BDI_MEMBDGT_FCTR times of dictionary size, if it's
+ * more than half of available memory, then the budget is its quarter.</p>
+ * @param pPth - dictionary path.
+ * @return budget or 0 if IDX can be made wholly in memory
+ *   or available memory is unknown
+ **/
+size_t bsdiixtxex_bdgt (char *pPth);
+#endif
@@ -0,0 +1,893 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+#include "stdlib.h"
+#include "string.h"
+#include "sys/stat.h"
+
+#include "BsError.h"
+#include "BsLog.h"
+#include "BsFioWrap.h"
+#include "BsUcFold.h"
+#include "BsDicWordDsl.h"
+#include "BsDiIxHwp.h"
+#include "BsDiIxTxEx.h"
+#include "BsDiIxTxUp.h"
+
+/**
+ * <p>Beigesoft™ updater of text dictionary IDX file.</p>
+ * @author Yury Demidenko
+ **/
+
+/**
+ * <p>Kept headword of saved DWOLT.</p>
+ * @member BS_FOFST_T ofst - offset in changed dictionary
+ * @member BS_SMALL_T len - length
+ * @member BS_IDX_T idx - index in saved DWOLT
+ **/
+typedef struct {
+  BS_FOFST_T ofst;
+  BS_SMALL_T len;
+  BS_IDX_T idx;
+} BsDiIxUpHw;
+
+/**
+ * <p>Saved chunk's hash with its index.</p>
+ * @member unsigned long hash - chunk's hash
+ * @member BS_IDX_T idx - chunk's index in saved FPT
+ **/
+typedef struct {
+  unsigned long hash;
+  BS_IDX_T idx;
+} BsDiIxUpCk;
+
+/**
+ * <p>Headwords of re-parsed chunks.</p>
+ * @member BsDicIwrds *iwrds - their i.words in saved AB
+ * @member bool isNewCh - if some of them has char out of saved AB
+ **/
+typedef struct {
+  BsDicIwrds *iwrds;
+  bool isNewCh;
+} BsDiIxUpPrs;
+
+/**
+ * <p>Merged DWOLT of updated IDX.</p>
+ * @member BsDicIwrds *iwrds - i.words of kept and re-parsed headwords
+ * @member BS_IDX_T *srcs - saved DWOLT index of every i.word
+ *   or BS_IDX_NULL if it's re-parsed one
+ * @member BS_IDX_T *map - index in merged DWOLT of every saved one
+ *   or BS_IDX_NULL if it's gone
+ * @member bool *afct - affected first chars by AB-code, i.e. ones of
+ *   gone or new i.words and of their sub-words
+ **/
+typedef struct {
+  BsDicIwrds *iwrds;
+  BS_IDX_T *srcs;
+  BS_IDX_T *map;
+  bool *afct;
+} BsDiIxUpMrg;
+
+/**
+ * <p>Comparator of kept headwords by offset.</p>
+ * @param pHw1 pointer to headword1
+ * @param pHw2 pointer to headword2
+ * @return pHw1 -1 less 0 equal 1 greater than pHw2
+ **/
+static int
+  s_cmp_hw (const void *pHw1, const void *pHw2)
+{
+  BS_FOFST_T o1 = ((BsDiIxUpHw*) pHw1)->ofst;
+  BS_FOFST_T o2 = ((BsDiIxUpHw*) pHw2)->ofst;
+  return o1 < o2 ? -1 : ( o1 > o2 ? 1 : 0 );
+}
+
+/**
+ * <p>Comparator of saved chunks by hash, then by index.</p>
+ * @param pCk1 pointer to chunk1
+ * @param pCk2 pointer to chunk2
+ * @return pCk1 -1 less 0 equal 1 greater than pCk2
+ **/
+static int
+  s_cmp_ck (const void *pCk1, const void *pCk2)
+{
+  BsDiIxUpCk *ck1 = (BsDiIxUpCk*) pCk1;
+  BsDiIxUpCk *ck2 = (BsDiIxUpCk*) pCk2;
+  if ( ck1->hash != ck2->hash )
+                { return ck1->hash < ck2->hash ? -1 : 1; }
+  return ck1->idx < ck2->idx ? -1 : ( ck1->idx > ck2->idx ? 1 : 0 );
+}
+
+/**
+ * <p>Consumer of re-parsed headword that adds its i.word in saved AB,
+ * headwords positions are remembered by iterator.</p>
+ * @param pDwrd - just read d.word
+ * @param pPrs - re-parsed headwords
+ * @return 0 to continue iteration, otherwise stop iteration
+ * @set errno if error.
+ **/
+static int
+  s_csm_prs (BsDicWord *pDwrd, BsDiIxUpPrs *pPrs)
+{
+  if ( pPrs->isNewCh ) //IDX will be remade
+                { return 0; }
+  for ( int i = 0; pDwrd->word[i] != 0; i++ )
+  {
+    if ( bsdicidxab_wchar_to_ichar (pPrs->iwrds->idx_ab,
+                                    bsucfold_fold (pDwrd->word[i])) == 0 )
+    {
+      pPrs->isNewCh = true;
+      return 0;
+    }
+  }
+  return bsdiciwrds_dwrd_csm_apnd (pDwrd, pPrs->iwrds);
+}
+
+/**
+ * <p>Check if dictionary has been only touched.</p>
+ * @param pOld - saved FPT
+ * @param pNew - FPT of current dictionary
+ * @return if chunks are same
+ **/
+static bool
+  s_is_same (BsDiIxFpt *pOld, BsDiIxFpt *pNew)
+{
+  if ( pOld->dicSz != pNew->dicSz || pOld->size != pNew->size )
+                { return false; }
+  for ( BS_IDX_T l = BS_IDX_0; l < pNew->size; l++ )
+  {
+    if ( pOld->vals[l].ofst != pNew->vals[l].ofst
+          || pOld->vals[l].hash != pNew->vals[l].hash )
+                { return false; }
+  }
+  return true;
+}
+
+/**
+ * <p>Match current chunks with saved ones by hash and size,
+ * the first unused saved chunk without hidden duplicates is taken.</p>
+ * @param pOld - saved FPT
+ * @param pNew - FPT of current dictionary
+ * @param pMtchs - array to return matched saved chunk for every current one
+ *   or BS_IDX_NULL
+ * @return matched chunks total
+ * @set errno if error.
+ **/
+static BS_IDX_T
+  s_match (BsDiIxFpt *pOld, BsDiIxFpt *pNew, BS_IDX_T *pMtchs)
+{
+  BS_IDX_T l, lo, hi, md, cnt = BS_IDX_0;
+  BsDiIxUpCk *cks = malloc (pOld->size * sizeof (BsDiIxUpCk));
+  BS_IF_EN_RETE (cks == NULL, ENOMEM)
+  for ( l = BS_IDX_0; l < pOld->size; l++ )
+  {
+    cks[l].hash = pOld->vals[l].hash;
+    cks[l].idx = pOld->vals[l].dupSz == BS_IDX_0 ? l : BS_IDX_NULL;
+  }
+  qsort (cks, pOld->size, sizeof (BsDiIxUpCk), s_cmp_ck);
+  for ( l = BS_IDX_0; l < pNew->size; l++ )
+  {
+    pMtchs[l] = BS_IDX_NULL;
+    //the first chunk with the same hash:
+    lo = BS_IDX_0; hi = pOld->size;
+    while ( lo < hi )
+    {
+      md = lo + ( hi - lo ) / 2;
+      if ( cks[md].hash < pNew->vals[l].hash )
+      {
+        lo = md + 1;
+      } else {
+        hi = md;
+      }
+    }
+    for ( ; lo < pOld->size && cks[lo].hash == pNew->vals[l].hash; lo++ )
+    {
+      if ( cks[lo].idx != BS_IDX_NULL && bsdiixfpt_chunk_sz (pOld, cks[lo].idx)
+                                  == bsdiixfpt_chunk_sz (pNew, l) )
+      {
+        pMtchs[l] = cks[lo].idx;
+        cks[lo].idx = BS_IDX_NULL; //used
+        cnt++;
+        break;
+      }
+    }
+  }
+  free (cks);
+  return cnt;
+}
+
+/**
+ * <p>Take headwords of matched chunks from saved DWOLT
+ * and shift them into current chunks.</p>
+ * @param pOld - saved IDX RAM
+ * @param pOldFpt - saved FPT
+ * @param pFpt - FPT of current dictionary
+ * @param pMtchs - matched saved chunk for every current one
+ * @param pCntRt - pointer to return kept headwords total
+ * @return kept headwords in DWOLT order or NULL when error
+ * @set errno if error.
+ **/
+static BsDiIxUpHw*
+  s_read_kept (BsDiIxTxRm *pOld, BsDiIxFpt *pOldFpt, BsDiIxFpt *pFpt,
+               BS_IDX_T *pMtchs, BS_IDX_T *pCntRt)
+{
+  BS_IDX_T l, ck;
+  BS_FOFST_T ofst;
+  BsDiIxUpHw *hws = NULL;
+  //current chunk for every saved one or BS_IDX_NULL:
+  BS_IDX_T *nws = malloc (pOldFpt->size * sizeof (BS_IDX_T));
+  BS_IF_EN_RETN (nws == NULL, ENOMEM)
+  for ( l = BS_IDX_0; l < pOldFpt->size; l++ )
+                { nws[l] = BS_IDX_NULL; }
+  for ( l = BS_IDX_0; l < pFpt->size; l++ )
+  {
+    if ( pMtchs[l] != BS_IDX_NULL )
+                { nws[pMtchs[l]] = l; }
+  }
+  hws = malloc (( pOld->head->dwoltSz + 1 ) * sizeof (BsDiIxUpHw));
+  BS_IF_EN_OUTE (hws == NULL, ENOMEM)
+  *pCntRt = BS_IDX_0;
+  for ( l = BS_IDX_0; l < pOld->head->dwoltSz; l++ )
+  {
+    ofst = BDI_RM_DWOFS (pOld, l);
+    ck = bsdiixfpt_find (pOldFpt, ofst);
+    if ( nws[ck] != BS_IDX_NULL )
+    {
+      hws[*pCntRt].ofst = ofst + pFpt->vals[nws[ck]].ofst - pOldFpt->vals[ck].ofst;
+      hws[*pCntRt].len = pOld->dwoltLens[l];
+      hws[*pCntRt].idx = l;
+      *pCntRt = *pCntRt + 1;
+    }
+  }
+  free (nws);
+  return hws;
+
+oute:
+  free (nws);
+  return NULL;
+}
+
+/**
+ * <p>Remember all headwords positions in offset order,
+ * i.e. kept ones and just parsed from every run of unmatched chunks.</p>
+ * @param pDslMm - mapped current dictionary
+ * @param pFpt - FPT of current dictionary
+ * @param pMtchs - matched saved chunk for every current one
+ * @param pKpts - kept headwords in offset order
+ * @param pKpCnt - kept headwords total
+ * @param pPrs - re-parsed headwords to fill
+ * @param pOpSt - opening state data shared with client
+ * @return re-parsed chunks total
+ * @set errno if error.
+ **/
+static BS_IDX_T
+  s_collect (BsDicDslMm *pDslMm, BsDiIxFpt *pFpt, BS_IDX_T *pMtchs,
+             BsDiIxUpHw *pKpts, BS_IDX_T pKpCnt, BsDiIxUpPrs *pPrs,
+             BsDiIxOst* pOpSt)
+{
+  BsDicDslMm *shrd;
+  BS_FOFST_T end;
+  BS_IDX_T l, j, k = BS_IDX_0, cnt = BS_IDX_0;
+  pDslMm->hwSz = BS_IDX_0;
+  for ( l = BS_IDX_0; l < pFpt->size; l = j )
+  {
+    if ( pMtchs[l] != BS_IDX_NULL )
+    {
+      j = l + 1;
+      end = pFpt->vals[l].ofst + bsdiixfpt_chunk_sz (pFpt, l);
+      for ( ; k < pKpCnt && pKpts[k].ofst < end; k++ )
+      {
+        bsdicdslmm_add_hws (pDslMm, &pKpts[k].ofst, &pKpts[k].len, BS_IDX_1);
+        if ( errno != 0 )
+        {
+          BSLOG_ERR
+          return BS_IDX_NULL;
+        }
+      }
+    } else {
+      for ( j = l + 1; j < pFpt->size && pMtchs[j] == BS_IDX_NULL; j++ ) ;
+      end = pFpt->vals[j - 1].ofst + bsdiixfpt_chunk_sz (pFpt, j - 1);
+      shrd = bsdicdslmm_new_shrd (pDslMm, pFpt->vals[l].ofst, end);
+      if ( shrd == NULL )
+      {
+        BSLOG_ERR
+        return BS_IDX_NULL;
+      }
+      bsdicdslmm_iter (shrd, BS_DIC_ENTRY_BUFFER_SIZE,
+                       (BsDicWord_Consume_Tus*) s_csm_prs, (void*) pPrs);
+      if ( errno == 0 )
+      {
+        bsdicdslmm_add_hws (pDslMm, shrd->hwOfsts, shrd->hwLens, shrd->hwSz);
+      }
+      bsdicdslmm_free (shrd);
+      if ( errno != 0 )
+      {
+        BSLOG_ERR
+        return BS_IDX_NULL;
+      }
+      cnt += j - l;
+      if ( pOpSt->stp )
+                { return cnt; }
+    }
+  }
+  if ( k != pKpCnt )
+  {
+    errno = BSE_ALG_ERR;
+    BSLOG_LOG (BSLERROR, "Kept headwords collected="BS_IDX_FMT", must be "BS_IDX_FMT"\n", k, pKpCnt)
+    return BS_IDX_NULL;
+  }
+  return cnt;
+}
+
+/**
+ * <p>Get saved i.word from saved HWP.</p>
+ * @param pOld - saved IDX RAM with current HWP
+ * @param pIdx - index in saved DWOLT
+ * @return i.word
+ **/
+static BS_CHAR_T*
+  s_old_iwrd (BsDiIxTxRm *pOld, BS_IDX_T pIdx)
+{
+  return BDI_HWP_ISTR (BDI_HWP_RD (pOld->hwp, pIdx));
+}
+
+/**
+ * <p>Mark first chars of gone or new i.word and of its sub-words
+ * as affected.</p>
+ * @param pAfct - affected first chars by AB-code
+ * @param pIwrd - i.word
+ * @param pIsp - space AB-code
+ **/
+static void
+  s_mark (bool *pAfct, BS_CHAR_T *pIwrd, int pIsp)
+{
+  pAfct[pIwrd[0]] = true;
+  for ( int i = 1; pIwrd[i] != 0; i++ )
+  {
+    if ( pIwrd[i - 1] == pIsp && pIwrd[i] != pIsp )
+                { pAfct[pIwrd[i]] = true; }
+  }
+}
+
+/**
+ * <p>Destructor of merged DWOLT's data.</p>
+ * @param pMrg - merged DWOLT
+ **/
+static void
+  s_mrg_free (BsDiIxUpMrg *pMrg)
+{
+  pMrg->iwrds = bsdiciwrds_free (pMrg->iwrds);
+  free (pMrg->srcs); pMrg->srcs = NULL;
+  free (pMrg->map); pMrg->map = NULL;
+  free (pMrg->afct); pMrg->afct = NULL;
+}
+
+/**
+ * <p>Merge kept headwords (their i.words are saved HWP's ones) with
+ * re-parsed ones into ordered i.words, the first (by offset) headword of
+ * duplicated i.word is taken as bsdiciwrds_sort does. Then saved DWOLT
+ * is walked together with merged one to map its indexes and to find
+ * affected first chars.</p>
+ * @param pMrg - merged DWOLT to make
+ * @param pOld - saved IDX RAM with current HWP
+ * @param pKpts - kept headwords in DWOLT order
+ * @param pKpCnt - kept headwords total
+ * @param pPrsd - ordered i.words of re-parsed headwords
+ * @return if AB is the same, i.e. all its chars are still used
+ * @set errno if error.
+ **/
+static bool
+  s_merge (BsDiIxUpMrg *pMrg, BsDiIxTxRm *pOld, BsDiIxUpHw *pKpts,
+           BS_IDX_T pKpCnt, BsDicIwrds *pPrsd)
+{
+  //vars:
+  BsDicIdxAb *ab = pOld->head->ab;
+  BsDicIwrds *iwrds;
+  BsDicIwrdRd *rd;
+  BS_IDX_T k, j, l, n, oldSz = pOld->head->dwoltSz;
+  int cmp, i, iwsz;
+  bool used[ab->chrsTot + 1];
+  //code:
+  for ( i = 0; i <= ab->chrsTot; i++ )
+                { used[i] = false; }
+  BS_DO_E_RETF (pMrg->iwrds = bsdiciwrds_new_ar (pKpCnt + pPrsd->size + BS_IDX_1, ab))
+  iwrds = pMrg->iwrds;
+  pMrg->srcs = malloc (( pKpCnt + pPrsd->size + BS_IDX_1 ) * BS_IDX_LEN);
+  pMrg->map = malloc (( oldSz + BS_IDX_1 ) * BS_IDX_LEN);
+  pMrg->afct = calloc (ab->chrsTot + 1, sizeof (bool));
+  if ( pMrg->srcs == NULL || pMrg->map == NULL || pMrg->afct == NULL )
+  {
+    errno = ENOMEM;
+    BSLOG_ERR
+    return false;
+  }
+  for ( k = BS_IDX_0, j = BS_IDX_0; k < pKpCnt || j < pPrsd->size; )
+  {
+    BS_DO_E_RETF (rd = bsarena_alloc (iwrds->arena, sizeof (BsDicIwrdRd)))
+    if ( k == pKpCnt )
+    {
+      cmp = 1;
+    } else if ( j == pPrsd->size ) {
+      cmp = -1;
+    } else {
+      cmp = bsdicidx_istr_cmp (s_old_iwrd (pOld, pKpts[k].idx), pPrsd->vals[j]->iword);
+    }
+    if ( cmp < 0 || ( cmp == 0 && pKpts[k].ofst < pPrsd->vals[j]->offset_dword ) )
+    {
+      rd->iword = s_old_iwrd (pOld, pKpts[k].idx);
+      rd->offset_dword = pKpts[k].ofst;
+      rd->length_dword = pKpts[k].len;
+      pMrg->srcs[iwrds->size] = pKpts[k].idx;
+    } else {
+      rd->iword = pPrsd->vals[j]->iword;
+      rd->offset_dword = pPrsd->vals[j]->offset_dword;
+      rd->length_dword = pPrsd->vals[j]->length_dword;
+      pMrg->srcs[iwrds->size] = BS_IDX_NULL;
+    }
+    if ( cmp <= 0 )
+                { k++; }
+    if ( cmp >= 0 )
+                { j++; }
+    BS_DO_E_RETF (bsdiciwrds_add_inc (iwrds, rd))
+    iwsz = bsdicidx_istr_len (rd->iword) + 1;
+    if ( iwrds->max_iword_size < iwsz )
+                { iwrds->max_iword_size = iwsz; }
+    iwrds->all_iwords_size += iwsz;
+    for ( i = 0; rd->iword[i] != 0; i++ )
+                { used[rd->iword[i]] = true; }
+  }
+  iwrds->dwoltSz = iwrds->size;
+  //saved DWOLT against merged one:
+  for ( l = BS_IDX_0, n = BS_IDX_0; l < oldSz || n < iwrds->size; )
+  {
+    if ( l == oldSz )
+    {
+      cmp = 1;
+    } else if ( n == iwrds->size ) {
+      cmp = -1;
+    } else {
+      cmp = bsdicidx_istr_cmp (s_old_iwrd (pOld, l), iwrds->vals[n]->iword);
+    }
+    if ( cmp == 0 )
+    {
+      pMrg->map[l++] = n++;
+    } else if ( cmp < 0 ) {
+      s_mark (pMrg->afct, s_old_iwrd (pOld, l), ab->ispace);
+      pMrg->map[l++] = BS_IDX_NULL;
+    } else {
+      s_mark (pMrg->afct, iwrds->vals[n++]->iword, ab->ispace);
+    }
+  }
+  for ( i = 1; i <= ab->chrsTot; i++ )
+  {
+    if ( !used[i] && i != ab->ispace )
+                { return false; }
+  }
+  return true;
+}
+
+/**
+ * <p>Check if all DWOLT indexes of saved IRT records range are mapped.</p>
+ * @param pOld - saved IDX RAM
+ * @param pStt - range start
+ * @param pEnd - range end
+ * @param pMap - index in merged DWOLT of every saved one
+ * @return if they are mapped
+ **/
+static bool
+  s_is_mapped (BsDiIxTxRm *pOld, BS_IDX_T pStt, BS_IDX_T pEnd, BS_IDX_T *pMap)
+{
+  BS_IDX_T l, dwst, i2st;
+  for ( l = pStt; l < pEnd; l++ )
+  {
+    dwst = BDI_RM_DWST (pOld, l);
+    if ( dwst != BS_IDX_NULL && pMap[dwst] == BS_IDX_NULL )
+                { return false; }
+    i2st = BDI_RM_I2ST (pOld, l);
+    for ( int i = 0; i < pOld->irtI2Qns[l]; i++ )
+    {
+      if ( pMap[BDI_RM_I2WPT (pOld, i2st + i)] == BS_IDX_NULL )
+                { return false; }
+    }
+  }
+  return true;
+}
+
+/**
+ * <p>Copy saved IRT records range with mapped DWOLT indexes.</p>
+ * @param pIrt - IRT in memory with arena
+ * @param pOld - saved IDX RAM
+ * @param pStt - range start
+ * @param pEnd - range end
+ * @param pMap - index in merged DWOLT of every saved one
+ * @set errno if error.
+ **/
+static void
+  s_copy_irt (BsDicIdxIrtRaw *pIrt, BsDiIxTxRm *pOld, BS_IDX_T pStt,
+              BS_IDX_T pEnd, BS_IDX_T *pMap)
+{
+  BS_IDX_T l, dwst, i2st;
+  BS_CHAR_T *wrd;
+  BsDicIdxIrtRawRd *rd;
+  for ( l = pStt; l < pEnd; l++ )
+  {
+    BS_DO_E_RET (rd = bsdicidxirtrawrd_new_ar (pIrt->arena))
+    BS_DO_E_RET (bsdicidxirtraw_add_inc (pIrt, rd, pIrt->bsize / BS_IDX_10 + BS_IDX_1))
+    wrd = BDI_RM_IRTWRD (pOld, l);
+    rd->idx_subwrd_size = bsdicidx_istr_len (wrd) + 1;
+    rd->idx_subwrd = malloc (rd->idx_subwrd_size * BS_CHAR_LEN);
+    BS_IF_EN_RET (rd->idx_subwrd == NULL, ENOMEM)
+    bsdicidx_istr_cpy (rd->idx_subwrd, wrd);
+    dwst = BDI_RM_DWST (pOld, l);
+    rd->dwolt_start = dwst == BS_IDX_NULL ? BS_IDX_NULL : pMap[dwst];
+    rd->i2wpt_quantity = pOld->irtI2Qns[l];
+    if ( rd->i2wpt_quantity > 0 )
+    {
+      rd->i2wpt_dwolt_idx = bsarena_alloc (pIrt->arena, rd->i2wpt_quantity * BS_IDX_LEN);
+      BS_IF_EN_RET (rd->i2wpt_dwolt_idx == NULL, ENOMEM)
+      i2st = BDI_RM_I2ST (pOld, l);
+      for ( int i = 0; i < rd->i2wpt_quantity; i++ )
+                { rd->i2wpt_dwolt_idx[i] = pMap[BDI_RM_I2WPT (pOld, i2st + i)]; }
+    }
+  }
+}
+
+/**
+ * <p>Make IRT of merged DWOLT by first chars. Records of not affected
+ * first char are copied from saved IRT, the rest ones are made again
+ * from merged i.words and i2words.</p>
+ * @param pMrg - merged DWOLT
+ * @param pOld - saved IDX RAM
+ * @param pIrtTots - IRT totals to make
+ * @return IRT in memory or NULL when error
+ * @set errno if error.
+ **/
+static BsDicIdxIrtRaw*
+  s_mk_irt (BsDiIxUpMrg *pMrg, BsDiIxTxRm *pOld, BsDicIdxIrtTots *pIrtTots)
+{
+  //vars:
+  BsDicIwrds *iwrds = pMrg->iwrds;
+  BsDicI2wrds *i2wrds = NULL;
+  BsDicIdxIrtRaw *irt;
+  BS_IDX_T l, le, n, ne, oldSz = pOld->head->irtSz;
+  BS_CHAR_T fch;
+  int mkCnt = 0, cpCnt = 0;
+  //code:
+  BS_DO_E_RETN (irt = bsdicidxirtraw_new_ar (oldSz + BS_IDX_1))
+  for ( l = BS_IDX_0, n = BS_IDX_0; l < oldSz || n < iwrds->size; l = le, n = ne )
+  {
+    if ( n == iwrds->size || ( l < oldSz
+          && BDI_RM_IRTWRD (pOld, l)[0] < iwrds->vals[n]->iword[0] ) )
+    {
+      fch = BDI_RM_IRTWRD (pOld, l)[0];
+    } else {
+      fch = iwrds->vals[n]->iword[0];
+    }
+    for ( le = l; le < oldSz && BDI_RM_IRTWRD (pOld, le)[0] == fch; le++ ) ;
+    for ( ne = n; ne < iwrds->size && iwrds->vals[ne]->iword[0] == fch; ne++ ) ;
+    if ( !pMrg->afct[fch] && le > l && s_is_mapped (pOld, l, le, pMrg->map) )
+    {
+      BS_DO_E_OUTE (s_copy_irt (irt, pOld, l, le, pMrg->map))
+      cpCnt++;
+    } else if ( ne > n ) {
+      if ( i2wrds == NULL )
+      {
+        BS_DO_E_OUTE (i2wrds = bsdici2wrds_new_fill (iwrds->size / BS_IDX_2 + BS_IDX_1, iwrds))
+      }
+      BS_DO_E_OUTE (bsdicidxirtraw_add_rng (irt, iwrds, i2wrds, n, ne, pIrtTots))
+      mkCnt++;
+    }
+  }
+  bsdici2wrds_free (i2wrds);
+  //totals of whole IRT:
+  pIrtTots->irtSz = irt->size;
+  pIrtTots->hirtSz = 0;
+  pIrtTots->mxIrWdSz = 0;
+  pIrtTots->alIrWdsSz = 0L;
+  pIrtTots->i2wptSz = BS_IDX_0;
+  for ( l = BS_IDX_0; l < irt->size; l++ )
+  {
+    if ( l == BS_IDX_0 || irt->vals[l]->idx_subwrd[0] != irt->vals[l - 1]->idx_subwrd[0] )
+                { pIrtTots->hirtSz++; }
+    if ( irt->vals[l]->idx_subwrd_size > pIrtTots->mxIrWdSz )
+                { pIrtTots->mxIrWdSz = irt->vals[l]->idx_subwrd_size; }
+    pIrtTots->alIrWdsSz += irt->vals[l]->idx_subwrd_size;
+    pIrtTots->i2wptSz += irt->vals[l]->i2wpt_quantity;
+  }
+  BSLOG_LOG (BSLINFO, "Updated IRTRAW: first chars re-made=%d, copied=%d, hirtSz=%d, mxIrWdSz=%d, irtSz="BS_IDX_FMT", i2wptSz="BS_IDX_FMT"\n", mkCnt, cpCnt, pIrtTots->hirtSz, pIrtTots->mxIrWdSz, pIrtTots->irtSz, pIrtTots->i2wptSz)
+  return irt;
+
+oute:
+  bsdici2wrds_free (i2wrds);
+  bsdicidxirtraw_free (irt);
+  return NULL;
+}
+
+/**
+ * <p>Make HWP of merged DWOLT, kept records are copied from saved HWP.</p>
+ * @param pMrg - merged DWOLT
+ * @param pOld - saved IDX RAM with current HWP
+ * @param pDslMm - mapped current dictionary
+ * @return HWP or NULL when error
+ * @set errno if error.
+ **/
+static char*
+  s_mk_hwp (BsDiIxUpMrg *pMrg, BsDiIxTxRm *pOld, BsDicDslMm *pDslMm)
+{
+  char *hwp = NULL;
+  BsDicIwrdRd *rd;
+  BS_DO_E_RETN (BsDiIxHwpMk *hwpMk = bsdiixhwpmk_new_mem (pOld->head->ab, pMrg->iwrds->size))
+  for ( BS_IDX_T l = BS_IDX_0; l < pMrg->iwrds->size; l++ )
+  {
+    if ( pMrg->srcs[l] != BS_IDX_NULL )
+    {
+      BS_DO_E_OUT (bsdiixhwpmk_add_rd (hwpMk, BDI_HWP_RD (pOld->hwp, pMrg->srcs[l])))
+    } else {
+      rd = pMrg->iwrds->vals[l];
+      BS_DO_E_OUT (bsdiixhwpmk_add_bts (hwpMk, pDslMm->dt + rd->offset_dword,
+                                        rd->length_dword, rd->offset_dword))
+    }
+  }
+  hwp = bsdiixhwpmk_end_mem (hwpMk);
+out:
+  bsdiixhwpmk_free (hwpMk);
+  return hwp;
+}
+
+/**
+ * <p>Make IDX RAM of changed dictionary from saved one and merged DWOLT,
+ * so result is same as made by bsdiixtxrm_create.</p>
+ * @param pPth - dictionary path.
+ * @param pMrg - merged DWOLT
+ * @param pOld - saved IDX RAM with current HWP, its AB is handed over
+ * @param pDslMm - mapped current dictionary with all headwords positions
+ * @param pFptRt - pointer to FPT of current dictionary, it's handed over
+ * @param pOpSt - opening state data shared with client
+ * @return object or NULL if stopped or error
+ * @set errno if error.
+ **/
+static BsDiIxTxRm*
+  s_make (char *pPth, BsDiIxUpMrg *pMrg, BsDiIxTxRm *pOld,
+          BsDicDslMm *pDslMm, BsDiIxFpt **pFptRt, BsDiIxOst* pOpSt)
+{
+  //vars:
+  BsDicIwrds *iwrds = pMrg->iwrds;
+  BsDicIdxIrtRaw *irt = NULL;
+  BsDiIxHeadTx *head = NULL;
+  BsDiIxTxRm *diIxRm = NULL;
+  FILE *dicFl = NULL;
+  char *hwp = NULL;
+  BsDicIdxIrtTots irtTots;
+  //code:
+  memset (&irtTots, 0, sizeof (BsDicIdxIrtTots));
+  irtTots.ab_chars_total = iwrds->idx_ab->chrsTot;
+  BS_DO_E_OUTE (irt = s_mk_irt (pMrg, pOld, &irtTots))
+  pOpSt->prgr = 60;
+  if ( pOpSt->stp )
+                { goto oute; }
+  BS_DO_E_OUTE (hwp = s_mk_hwp (pMrg, pOld, pDslMm))
+  //the same i.words, but in the new HWP:
+  for ( BS_IDX_T l = BS_IDX_0; l < iwrds->size; l++ )
+                { iwrds->vals[l]->iword = BDI_HWP_ISTR (BDI_HWP_RD (hwp, l)); }
+  BS_DO_E_OUTE (bsdiixfpt_add_hws (*pFptRt, pDslMm->hwOfsts, pDslMm->hwSz))
+  BS_DO_E_OUTE (bsdiixfpt_sub_dwolt (*pFptRt, iwrds))
+  dicFl = fopen (pPth, "r");
+  BS_IF_EN_OUTE (dicFl == NULL, BSE_OPEN_FILE)
+  BS_DO_E_OUTE (head = bsdiixheadtx_new_tf (pOld->head->frmt, iwrds, &irtTots))
+  pOld->head->ab = NULL;
+  head->fpt = *pFptRt;
+  *pFptRt = NULL;
+  BS_DO_E_OUTE (head->nme = bsdiixtx_dic_nme (dicFl, head->frmt, pPth))
+  BS_DO_E_OUTE (bsdiixheadtx_mk_flgs (head, dicFl))
+  BS_DO_E_OUTE (diIxRm = bsdiixtxrm_new (dicFl, head))
+  dicFl = NULL; head = NULL;
+  BS_DO_E_OUTE (bsdiixtxrm_fill (diIxRm, iwrds, irt))
+  diIxRm->hwp = hwp;
+  hwp = NULL;
+  //FST and SA of the same i.words:
+  diIxRm->fst = bsdiixtx_mk_fst (iwrds, pOpSt);
+  diIxRm->sa = bsdiixtx_mk_sa (iwrds, pOpSt);
+  bsdicidxirtraw_free (irt);
+  BSLOG_LOG (BSLINFO, "Updated DIC IDX RAM #%p, name=%s\n", diIxRm, diIxRm->head->nme->val)
+  return diIxRm;
+
+oute: //or canceled
+  bsdicidxirtraw_free (irt);
+  free (hwp);
+  bsdiixheadtx_free (head);
+  bsdiixtxrm_destroy (diIxRm);
+  if ( dicFl != NULL )
+                { fclose (dicFl); }
+  return NULL;
+}
+
+/**
+ * <p>Update IDX of changed dictionary.
+ * IDX folded by libc (without BDI_TXFLG_UCF) or with unaligned sections
+ * (without BDI_TXFLG_ALGN) is removed for further remaking.
+ * IDX with check-summed head is trusted if its head is intact and
+ * dictionary's fingerprint matches, IDX with corrupted head (or sections
+ * when deep validation) is removed for further remaking.
+ * If dictionary has been only touched, then saved modification time
+ * is just overwritten. Otherwise headwords of unchanged chunks are taken
+ * from saved DWOLT and HWP, and only changed chunks are parsed.
+ * They are merged into saved DWOLT, and IRT records are made again only
+ * for first chars of gone and new i.words (and of their sub-words),
+ * the rest ones are taken from saved IRT. If AB is changed or saved IDX
+ * is without current HWP, then IDX is made from all headwords.
+ * IDX of changed dictionary (or without FPT) that can't be updated
+ * within memory budget is removed for further remaking.</p>
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ * @return updated IDX RAM to save or NULL if IDX is up to date,
+ *   not found, without FPT, removed, stopped or error
+ * @set errno if error.
+ **/
+BsDiIxTxRm*
+  bsdiixtxup_update (char *pPth, BsDiIxOst* pOpSt)
+{
+  //vars:
+  BsDiIxTx *diIx;
+  BsDiIxTxRm *diIxRm, *oldRm;
+  BsDiIxFpt *oldFpt, *fpt;
+  BsDicDslMm *dslMm;
+  FILE *dicFl;
+  BS_IDX_T *mtchs;
+  BsDiIxUpHw *kpts, *kptsOf;
+  BS_IDX_T kpCnt, cnt;
+  BS_FOFST_T dicSz;
+  long mtime;
+  BsDiIxSum sum;
+  EBsDiIxSumStt sumStt;
+  BsDiIxUpPrs prs;
+  BsDiIxUpMrg mrg;
+  struct stat st;
+  bool isSum, isIncr;
+  char idxPth[strlen (pPth) + 10];
+  //init0 vars:
+  diIxRm = NULL; oldRm = NULL; oldFpt = NULL; fpt = NULL; dslMm = NULL;
+  dicFl = NULL; mtchs = NULL; kpts = NULL; kptsOf = NULL; prs.iwrds = NULL;
+  memset (&mrg, 0, sizeof (BsDiIxUpMrg));
+  strcpy (idxPth, pPth);
+  strcat (idxPth, BDI_IDX_FILE_EXT);
+  //code:
+  BS_DO_E_RETN (diIx = bsdiixtx_load (pPth))
+  if ( diIx == NULL ) //no IDX
+                { return NULL; }
+  if ( !( diIx->head->flgs & BDI_TXFLG_UCF )
+        || !( diIx->head->flgs & BDI_TXFLG_ALGN ) )
+  { //i.words folded by libc don't match searched ones,
+    //unaligned HWP, FST and SA can't be mapped:
+    diIx = bsdiixtx_destroy (diIx);
+    remove (idxPth);
+    BSLOG_LOG (BSLINFO, "IDX of %s in old format has been removed\n", pPth)
+    goto oute;
+  }
+  isSum = diIx->head->flgs & BDI_TXFLG_SUM;
+  if ( isSum )
+  {
+    sum = diIx->head->sum;
+    BS_DO_E_OUTE (sumStt = bsdiixsum_check (&sum, diIx->idxFl, pPth))
+    if ( sumStt == EBDI_SUM_OK && pOpSt->dpVld )
+    {
+      BS_DO_E_OUTE (bool isOk = bsdiixsum_check_scts (&sum, diIx->idxFl))
+      if ( !isOk )
+                { sumStt = EBDI_SUM_BAD; }
+    }
+    if ( sumStt == EBDI_SUM_OK ) //up to date, it's trusted without walking
+                { goto oute; }
+    if ( sumStt == EBDI_SUM_BAD )
+    {
+      diIx = bsdiixtx_destroy (diIx);
+      remove (idxPth);
+      BSLOG_LOG (BSLWARN, "Corrupted IDX of %s has been removed\n", pPth)
+      goto oute;
+    }
+  }
+  BS_DO_E_OUTE (oldFpt = bsdiixfpt_load (diIx->idxFl))
+  if ( oldFpt == NULL )
+  {
+    if ( isSum )
+    { //stale IDX without FPT is remade:
+      diIx = bsdiixtx_destroy (diIx);
+      remove (idxPth);
+      BSLOG_LOG (BSLINFO, "IDX without FPT of changed dictionary %s has been removed\n", pPth)
+    } //otherwise old IDX without FPT is used as is
+    goto oute;
+  }
+  BS_DO_E_OUTE (bsdiixfpt_stat (pPth, &dicSz, &mtime))
+  //stale SUM means changed content even with the same size and time:
+  if ( !isSum && dicSz == oldFpt->dicSz && mtime == oldFpt->mtime ) //up to date
+                { goto oute; }
+  pOpSt->stt = EBSDS_INDEXING;
+  //1. splitting changed dictionary into chunks:
+  dicFl = fopen (pPth, "r");
+  BS_IF_EN_OUTE (dicFl == NULL, BSE_OPEN_FILE)
+  BS_DO_E_OUTE (dslMm = bsdicdslmm_new (dicFl))
+  BS_DO_E_OUTE (fpt = bsdiixfpt_new_make (dslMm, BS_DIC_ENTRY_BUFFER_SIZE, pPth))
+  if ( s_is_same (oldFpt, fpt) )
+  {
+    diIx = bsdiixtx_destroy (diIx);
+    oldFpt->mtime = fpt->mtime;
+    BS_DO_E_OUTE (bsdiixfpt_save_mtime (oldFpt, idxPth))
+    if ( isSum )
+          { BS_DO_E_OUTE (bsdiixsum_save_fpt (&sum, idxPth, pPth)) }
+    BSLOG_LOG (BSLINFO, "Dictionary %s has been touched without changing\n", pPth)
+    goto oute;
+  }
+  if ( pOpSt->isBdgtAuto )
+                { pOpSt->memBdgt = bsdiixtxex_bdgt (pPth); }
+  if ( pOpSt->memBdgt > 0 && ( stat (idxPth, &st) != 0
+        || (unsigned long long) st.st_size * BDI_UP_MEM_FCTR > pOpSt->memBdgt ) )
+  { //IDX will be remade within memory budget:
+    errno = 0;
+    diIx = bsdiixtx_destroy (diIx);
+    remove (idxPth);
+    BSLOG_LOG (BSLINFO, "IDX of changed dictionary %s has been removed\n", pPth)
+    goto oute;
+  }
+  pOpSt->prgr = 10;
+  //2. matching unchanged chunks and taking their headwords from saved DWOLT:
+  mtchs = malloc (fpt->size * sizeof (BS_IDX_T));
+  BS_IF_EN_OUTE (mtchs == NULL, ENOMEM)
+  BS_DO_E_OUTE (s_match (oldFpt, fpt, mtchs))
+  BS_DO_E_OUTE (oldRm = bsdiixtx_to_rm (diIx))
+  diIx = NULL;
+  BS_DO_E_OUTE (kpts = s_read_kept (oldRm, oldFpt, fpt, mtchs, &kpCnt))
+  kptsOf = malloc (( kpCnt + 1 ) * sizeof (BsDiIxUpHw));
+  BS_IF_EN_OUTE (kptsOf == NULL, ENOMEM)
+  memcpy (kptsOf, kpts, kpCnt * sizeof (BsDiIxUpHw));
+  qsort (kptsOf, kpCnt, sizeof (BsDiIxUpHw), s_cmp_hw);
+  //3. parsing changed chunks:
+  BS_DO_E_OUTE (prs.iwrds = bsdiciwrds_new_ar (kpCnt / BS_IDX_10 + BS_IDX_1, oldRm->head->ab))
+  prs.isNewCh = false;
+  BS_DO_E_OUTE (cnt = s_collect (dslMm, fpt, mtchs, kptsOf, kpCnt, &prs, pOpSt))
+  pOpSt->prgr = 20;
+  if ( pOpSt->stp )
+                { goto oute; }
+  BSLOG_LOG (BSLINFO, "Updating IDX of %s, re-parsed chunks="BS_IDX_FMT" of "BS_IDX_FMT", kept headwords="BS_IDX_FMT" of "BS_IDX_FMT"\n", pPth, cnt, fpt->size, kpCnt, dslMm->hwSz)
+  //4. merging re-parsed headwords into saved DWOLT:
+  isIncr = !prs.isNewCh && oldRm->hwp != NULL && bsdiixhwp_is_exact (oldRm->hwp)
+    && oldRm->head->dwoltSz >= BDI_MAX_IWORDS_TO_AVOIDI2W;
+  if ( isIncr )
+  {
+    BS_DO_E_OUTE (bsdiciwrds_sort (prs.iwrds, 0))
+    BS_DO_E_OUTE (isIncr = s_merge (&mrg, oldRm, kpts, kpCnt, prs.iwrds))
+    isIncr = isIncr && mrg.iwrds->size >= BDI_MAX_IWORDS_TO_AVOIDI2W;
+  }
+  pOpSt->prgr = 40;
+  if ( pOpSt->stp )
+                { goto oute; }
+  if ( isIncr )
+  {
+    BS_DO_E_OUTE (diIxRm = s_make (pPth, &mrg, oldRm, dslMm, &fpt, pOpSt))
+  } else if ( pOpSt->memBdgt > 0 ) {
+    remove (idxPth);
+    BSLOG_LOG (BSLINFO, "IDX of changed dictionary %s has been removed\n", pPth)
+  } else { //5. making IDX from all headwords:
+    BSLOG_LOG (BSLINFO, "IDX of %s is made from all headwords, AB has been changed or there is no current HWP\n", pPth)
+    s_mrg_free (&mrg);
+    oldRm = bsdiixtxrm_destroy (oldRm);
+    BS_DO_E_OUTE (diIxRm = bsdiixtxrm_make (pPth, dslMm, pOpSt))
+  }
+
+oute: //or up to date, or canceled
+  bsdiixtx_destroy (diIx);
+  bsdiixtxrm_destroy (oldRm);
+  bsdiixfpt_free (oldFpt);
+  bsdiixfpt_free (fpt);
+  bsdicdslmm_free (dslMm);
+  if ( dicFl != NULL )
+                { fclose (dicFl); }
+  if ( mtchs != NULL )
+                { free (mtchs); }
+  if ( kpts != NULL )
+                { free (kpts); }
+  if ( kptsOf != NULL )
+                { free (kptsOf); }
+  bsdiciwrds_free (prs.iwrds);
+  s_mrg_free (&mrg);
+  return diIxRm;
+}
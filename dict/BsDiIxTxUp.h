@@ -0,0 +1,50 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ updater of text dictionary IDX file after dictionary
+ * has been changed. Dictionary's chunks are matched with ones from saved FPT,
+ * headwords of unchanged chunks are taken from saved DWOLT and HWP, only
+ * changed chunks (or ones with hidden duplicates) are re-parsed and merged
+ * into saved DWOLT, IRT records of affected first chars are made again,
+ * the rest ones are shifted, so result is same as made by
+ * bsdiixtxrm_create.</p>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DIIXTXUP
+#define BS_DEBUGL_DIIXTXUP 30850
+
+#include "BsDiIxTx.h"
+
+/**
+ * <p>Memory used by update in IDX file sizes, i.e. saved IDX in RAM,
+ * merged DWOLT, IRT and HWP.</p>
+ **/
+#define BDI_UP_MEM_FCTR 3
+
+/**
+ * <p>Update IDX of changed dictionary.
+ * IDX folded by libc (without BDI_TXFLG_UCF) or with unaligned sections
+ * (without BDI_TXFLG_ALGN) is removed for further remaking.
+ * IDX with check-summed head is trusted if its head is intact and
+ * dictionary's fingerprint matches, IDX with corrupted head (or sections
+ * when deep validation) is removed for further remaking.
+ * If dictionary has been only touched, then saved modification time
+ * is just overwritten. Otherwise headwords of unchanged chunks are taken
+ * from saved DWOLT and HWP, and only changed chunks are parsed.
+ * They are merged into saved DWOLT, and IRT records are made again only
+ * for first chars of gone and new i.words (and of their sub-words),
+ * the rest ones are taken from saved IRT. If AB is changed or saved IDX
+ * is without current HWP, then IDX is made from all headwords.
+ * IDX of changed dictionary (or without FPT) that can't be updated
+ * within memory budget is removed for further remaking.</p>
+ * @param pPth - dictionary path.
+ * @param pOpSt - opening state data shared with client
+ * @return updated IDX RAM to save or NULL if IDX is up to date,
+ *   not found, without FPT, removed, stopped or error
+ * @set errno if error.
+ **/
+BsDiIxTxRm *bsdiixtxup_update (char *pPth, BsDiIxOst* pOpSt);
+#endif
@@ -166,22 +166,18 @@ int bsdicidx_istr_cmp_match(BS_CHAR_T *p_irtwrd, BS_CHAR_T *p_iwrd) {
 bool
   bsdicidx_istr_cont (BS_CHAR_T *pIwrd1, BS_CHAR_T *pIwrd2)
 {
-  int mchd = 0, len = bsdicidx_istr_len (pIwrd2);
-  for ( int i = 0; ; i++ )
+  if ( pIwrd2[0] == 0 )
+                { return false; }
+  //partial match is retried from the next char, e.g. "aaab" contains "aab":
+  for ( int i = 0; pIwrd1[i] != 0; i++ )
   {
-    if ( pIwrd1[i] == 0 )
-    {
-      return false;
-    }
-    if ( pIwrd2[mchd] == pIwrd1[i] )
-    {
-      mchd++;
-      if ( mchd == len )
+    int j = 0;
+    while ( pIwrd2[j] != 0 && pIwrd1[i + j] == pIwrd2[j] )
+          { j++; }
+    if ( pIwrd2[j] == 0 )
                 { return true; }
-    } else {
-      mchd = 0;
-    }
   }
+  return false;
 }
 
 /**
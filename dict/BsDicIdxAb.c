@@ -4,10 +4,10 @@ All rights reserved.
 See the LICENSE in the root source folder */
 
 #include "stdlib.h"
-#include "wctype.h"
 
 #include "BsError.h"
 #include "BsLog.h"
+#include "BsUcFold.h"
 #include "BsDicIdxAb.h"
 #include "BsDicWordDsl.h"
 
@@ -34,10 +34,14 @@ BsDicIdxAb *bsdicidxab_new(int p_buffer_sz) {
   BsDicIdxAb *obj = malloc(sizeof(BsDicIdxAb));
   if (obj != NULL) {
     obj->transient_buffer_len = p_buffer_sz;
+    obj->lkpHwchs = NULL;
+    obj->lkpHcds = NULL;
+    obj->lkpHsz = 0;
+    obj->lkpHcnt = 0;
+    obj->lkpPgs = calloc(BDI_AB_LKP_PGSZ, sizeof(BS_CHAR_T*));
     obj->wchars = malloc(obj->transient_buffer_len * BS_WCHAR_LEN);
-    if (obj->wchars == NULL) {
-      free(obj);
-      obj = NULL;
+    if (obj->wchars == NULL || obj->lkpPgs == NULL) {
+      obj = bsdicidxab_free(obj);
     } else {
       for (int i = 0; i < obj->transient_buffer_len; i++) {
         obj->wchars[i] = 0;
@@ -45,6 +49,10 @@ BsDicIdxAb *bsdicidxab_new(int p_buffer_sz) {
       obj->wchars[0] = L' ';
       obj->chrsTot = 1;
       obj->ispace = 1;
+      bsdicidxab_mk_lkp(obj);
+      if (errno != 0) {
+        obj = bsdicidxab_free(obj);
+      }
     }
   }
   if (obj == NULL) {
@@ -66,11 +74,138 @@ BsDicIdxAb *bsdicidxab_free(BsDicIdxAb *pIdx_ab) {
     if (pIdx_ab->wchars != NULL)  {
       free(pIdx_ab->wchars);
     }
+    if (pIdx_ab->lkpPgs != NULL)  {
+      for (int i = 0; i < BDI_AB_LKP_PGSZ; i++) {
+        if (pIdx_ab->lkpPgs[i] != NULL)  {
+          free(pIdx_ab->lkpPgs[i]);
+        }
+      }
+      free(pIdx_ab->lkpPgs);
+    }
+    if (pIdx_ab->lkpHwchs != NULL)  {
+      free(pIdx_ab->lkpHwchs);
+      free(pIdx_ab->lkpHcds);
+    }
     free(pIdx_ab);
   }
   return NULL;
 }
 
+/**
+ * <p>Non-BMP wchar's hash slot, i.e. its own or empty one.</p>
+ **/
+static int
+  s_lkp_hslot (BS_WCHAR_T *pHwchs, int pHsz, BS_WCHAR_T pWch)
+{
+  int i = (int) (((unsigned long) pWch * 2654435761UL) & (pHsz - 1));
+  while ( pHwchs[i] != 0 && pHwchs[i] != pWch )
+    { i = (i + 1) & (pHsz - 1); }
+  return i;
+}
+
+/**
+ * <p>Put wchar's AB-code into lookup table.</p>
+ * @set errno if error.
+ **/
+static void
+  s_lkp_put (BsDicIdxAb *pAb, BS_WCHAR_T pWch, BS_CHAR_T pIch)
+{
+  unsigned long wch = (unsigned long) pWch;
+  if ( wch < BDI_AB_LKP_PGSZ * BDI_AB_LKP_PGSZ )
+  {
+    int pg = wch / BDI_AB_LKP_PGSZ;
+    if ( pAb->lkpPgs[pg] == NULL )
+    {
+      pAb->lkpPgs[pg] = calloc (BDI_AB_LKP_PGSZ, sizeof (BS_CHAR_T));
+      if ( pAb->lkpPgs[pg] == NULL )
+      {
+        if ( errno == 0 ) { errno = ENOMEM; }
+        BSLOG_ERR
+        return;
+      }
+    }
+    pAb->lkpPgs[pg][wch % BDI_AB_LKP_PGSZ] = pIch;
+    return;
+  }
+  if ( (pAb->lkpHcnt + 1) * 2 > pAb->lkpHsz )
+  { //grow and rehash:
+    int hsz = pAb->lkpHsz == 0 ? BDI_AB_LKP_HINITSIZE : pAb->lkpHsz * 2;
+    BS_WCHAR_T *hwchs = calloc (hsz, BS_WCHAR_LEN);
+    BS_CHAR_T *hcds = calloc (hsz, sizeof (BS_CHAR_T));
+    if ( hwchs == NULL || hcds == NULL )
+    {
+      free (hwchs); free (hcds);
+      if ( errno == 0 ) { errno = ENOMEM; }
+      BSLOG_ERR
+      return;
+    }
+    for ( int i = 0; i < pAb->lkpHsz; i++ )
+    {
+      if ( pAb->lkpHwchs[i] != 0 )
+      {
+        int j = s_lkp_hslot (hwchs, hsz, pAb->lkpHwchs[i]);
+        hwchs[j] = pAb->lkpHwchs[i];
+        hcds[j] = pAb->lkpHcds[i];
+      }
+    }
+    free (pAb->lkpHwchs); free (pAb->lkpHcds);
+    pAb->lkpHwchs = hwchs; pAb->lkpHcds = hcds;
+    pAb->lkpHsz = hsz;
+  }
+  int i = s_lkp_hslot (pAb->lkpHwchs, pAb->lkpHsz, pWch);
+  if ( pAb->lkpHwchs[i] == 0 )
+  {
+    pAb->lkpHwchs[i] = pWch;
+    pAb->lkpHcnt++;
+  }
+  pAb->lkpHcds[i] = pIch;
+}
+
+/**
+ * <p>Make wchar to AB-code lookup table by AB's wchars,
+ * e.g. after AB has been loaded.</p>
+ * @param pAb - index alphabet
+ * @set errno if error.
+ **/
+void
+  bsdicidxab_mk_lkp (BsDicIdxAb *pAb)
+{
+  for ( int i = 0; i < BDI_AB_LKP_PGSZ; i++ )
+  {
+    if ( pAb->lkpPgs[i] != NULL )
+      { memset (pAb->lkpPgs[i], 0, BDI_AB_LKP_PGSZ * sizeof (BS_CHAR_T)); }
+  }
+  for ( int i = 0; i < pAb->lkpHsz; i++ )
+    { pAb->lkpHwchs[i] = 0; }
+  pAb->lkpHcnt = 0;
+  for ( int i = 0; i < pAb->chrsTot; i++ )
+  {
+    if ( bsdicidxab_wchar_to_ichar (pAb, pAb->wchars[i]) == 0 )
+      { BS_DO_E_RET (s_lkp_put (pAb, pAb->wchars[i], i + 1)) }
+  }
+}
+
+/**
+ * <p>Find wchar's AB-code.</p>
+ * @param pAb - index alphabet
+ * @param pWch - wchar, it must be already lower-cased
+ * @return AB-code, i.e. wchar's index plus 1, or 0 if not found
+ **/
+BS_CHAR_T
+  bsdicidxab_wchar_to_ichar (BsDicIdxAb *pAb, BS_WCHAR_T pWch)
+{
+  unsigned long wch = (unsigned long) pWch;
+  if ( wch < BDI_AB_LKP_PGSZ * BDI_AB_LKP_PGSZ )
+  {
+    BS_CHAR_T *pg = pAb->lkpPgs[wch / BDI_AB_LKP_PGSZ];
+    return pg == NULL ? 0 : pg[wch % BDI_AB_LKP_PGSZ];
+  }
+  if ( pAb->lkpHsz == 0 )
+    { return 0; }
+  int i = s_lkp_hslot (pAb->lkpHwchs, pAb->lkpHsz, pWch);
+  return pAb->lkpHwchs[i] == 0 ? 0 : pAb->lkpHcds[i];
+}
+
 /**
  * <p>Type-safe consumer. Fill AB by all words from dictionary.
  * @param p_dword just read d.word
@@ -138,6 +273,31 @@ int bsdicidxab_iter_dsl_fill(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicIdx
   return rez;
 }
 
+/**
+ * <p>
+ * Type-safe single pass iterator trough whole memory mapped DSL dictionary,
+ * just read dic.word will be consumed by AB filler, if consumer returns an error,
+ * then iteration will stop. Headwords positions will be remembered
+ * for further iterating by bsdicdslmm_iter_hw.
+ * </p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pIdxAb pointer to index alphabet
+ * @param pTotals pointer to return totals
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error.
+ **/
+int
+  bsdicidxab_iter_dslmm_fill (BsDicDslMm *pDslMm, int pDeBufSz,
+                              BsDicIdxAb *pIdxAb, BsDicIdxAbTotals *pTotals)
+{
+  BS_CHAR_T istr[pDeBufSz];
+  BsDicIdxAbFill instr = { .idx_ab=pIdxAb, .totals=pTotals, .idxstr=istr };
+  int rez = bsdicdslmm_iter (pDslMm, pDeBufSz, (BsDicWord_Consume_Tus*) bsdicidxab_dwrd_consume_fill, (void*) &instr);
+  BSLOG_LOG (BSLINFO, "Created AB chars total=%d, ispace=%d, max_iword_len=%d, dwoltSz=%lu, i2wptSz=%lu, headwords="BS_IDX_FMT"\n", pIdxAb->chrsTot, pIdxAb->ispace, pTotals->max_iword_len, pTotals->dwoltSz, pTotals->i2wptSz, pDslMm->hwSz);
+  return rez;
+}
+
 /**
  * <p>
  * Fills alphabet with wide char string.
@@ -154,25 +314,17 @@ int bsdicidxab_iter_dsl_fill(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicIdx
  **/
 void bsdicidxab_add_wstr(BS_WCHAR_T *p_wstr, BsDicIdxAb *pIdx_ab) {
   for (int i = 0; ; i++) {
-    BS_WCHAR_T nwch;
     if (p_wstr[i] == 0) {
       break;
-    } else if (iswalpha(p_wstr[i])) {
-      nwch = towlower(p_wstr[i]);
-    } else { // any char:
-      nwch = p_wstr[i];
     }
-    int is_fnd = FALSE;
-    int lt_idx = 0; //last less idx
-    for (int i = 0; i < pIdx_ab->chrsTot; i++) {
-      if (nwch == pIdx_ab->wchars[i]) {
-        is_fnd = TRUE;
-        break;
-      } else if (pIdx_ab->wchars[i] < nwch) {
-        lt_idx = i;
+    BS_WCHAR_T nwch = bsucfold_fold(p_wstr[i]);
+    if (bsdicidxab_wchar_to_ichar(pIdx_ab, nwch) == 0) {
+      int lt_idx = 0; //last less idx
+      for (int i = 0; i < pIdx_ab->chrsTot; i++) {
+        if (pIdx_ab->wchars[i] < nwch) {
+          lt_idx = i;
+        }
       }
-    }
-    if (!is_fnd) {
       if (pIdx_ab->chrsTot >= pIdx_ab->transient_buffer_len) {
         pIdx_ab->transient_buffer_len += BDI_AB_BUF_INCREASE;
         pIdx_ab->wchars = realloc(pIdx_ab->wchars, pIdx_ab->transient_buffer_len * BS_WCHAR_LEN);
@@ -196,12 +348,15 @@ void bsdicidxab_add_wstr(BS_WCHAR_T *p_wstr, BsDicIdxAb *pIdx_ab) {
       }
       pIdx_ab->wchars[nwch_idx] = nwch;
       pIdx_ab->chrsTot++;
+      //codes of inserted and shifted wchars:
+      for (int i = nwch_idx; i < pIdx_ab->chrsTot; i++) {
+        BS_DO_E_RET(s_lkp_put(pIdx_ab, pIdx_ab->wchars[i], i + 1))
+      }
     }
   }
-  for (int i = 0; i < pIdx_ab->chrsTot; i++) {
-    if (pIdx_ab->wchars[i] == L' ') {
-      pIdx_ab->ispace = i + 1;
-    }
+  BS_CHAR_T isp = bsdicidxab_wchar_to_ichar(pIdx_ab, L' ');
+  if (isp != 0) {
+    pIdx_ab->ispace = isp;
   }
 }
 
@@ -218,28 +373,22 @@ void bsdicidxab_wstr_to_istr(BS_WCHAR_T *p_wstr, BS_CHAR_T *p_istr, BsDicIdxAb *
   int idx_str_len = 0;
   int was_space = FALSE;
   for (int i = 0; ; i++) {
-    BS_WCHAR_T nwch;
     if (p_wstr[i] == 0) {
       break;
-    } else if (iswalpha(p_wstr[i])) {
-      nwch = towlower(p_wstr[i]);
-    } else {
-      nwch = p_wstr[i];
     }
-    for (int j = 0; j < pIdx_ab->chrsTot; j++) {
-      if (nwch == pIdx_ab->wchars[j]) {
-        if (nwch == pIdx_ab->ispace) { //TODO hyphen between words (iswalpha), e.g. word (---) is actually a sign
-          if (was_space) {
-            break;
-          }
-          was_space = TRUE;
-        } else {
-          was_space = FALSE;
+    BS_WCHAR_T nwch = bsucfold_fold(p_wstr[i]);
+    BS_CHAR_T ich = bsdicidxab_wchar_to_ichar(pIdx_ab, nwch);
+    if (ich != 0) {
+      if (nwch == pIdx_ab->ispace) { //TODO hyphen between words (iswalpha), e.g. word (---) is actually a sign
+        if (was_space) {
+          continue;
         }
-        p_istr[idx_str_len] = j + 1;
-        idx_str_len++;
-        break;
+        was_space = TRUE;
+      } else {
+        was_space = FALSE;
       }
+      p_istr[idx_str_len] = ich;
+      idx_str_len++;
     }
   }
   p_istr[idx_str_len] = 0;
@@ -15,10 +15,12 @@ See the LICENSE in the root source folder */
 #include "string.h"
 
 #include "BsDicIdx.h"
-#include "BsDicWord.h"
+#include "BsDicWordDsl.h"
 
 #define BDI_AB_BUF_INITSIZE 60 //40 low letters + BDI_AB_FIRST_CHARS_COUNT is enough for standard dictionary
 #define BDI_AB_BUF_INCREASE 300 //it's usually a multi-lang dic
+#define BDI_AB_LKP_PGSZ 256 //BMP lookup table's page size, i.e. pages total too
+#define BDI_AB_LKP_HINITSIZE 16 //non-BMP wchars hash initial size, power of 2
 
 #define BDI_AB_SIZE(p_pidx_ab) sizeof(int) + BS_WCHAR_LEN*p_pidx_ab->chrsTot
 
@@ -35,6 +37,12 @@ typedef struct {
   //corresponding to wchar char will be its index plus 1:
   BS_WCHAR_T *wchars;
   int ispace; //space in AB-coding, initial 0
+  //non-persistent wchar to AB-code lookup, 0 means "not in AB":
+  BS_CHAR_T **lkpPgs; //direct table for BMP by 256 wchars pages, NULL is empty page
+  BS_WCHAR_T *lkpHwchs; //open address hash of other wchars, 0 is empty slot
+  BS_CHAR_T *lkpHcds; //their AB-codes
+  int lkpHsz; //hash size, power of 2
+  int lkpHcnt; //hash used slots
 } BsDicIdxAb;
 
 //Public methods:
@@ -56,6 +64,22 @@ BsDicIdxAb *bsdicidxab_new(int p_buffer_sz);
  **/
 BsDicIdxAb *bsdicidxab_free(BsDicIdxAb *pIdx_ab);
 
+/**
+ * <p>Make wchar to AB-code lookup table by AB's wchars,
+ * e.g. after AB has been loaded.</p>
+ * @param pAb - index alphabet
+ * @set errno if error.
+ **/
+void bsdicidxab_mk_lkp (BsDicIdxAb *pAb);
+
+/**
+ * <p>Find wchar's AB-code.</p>
+ * @param pAb - index alphabet
+ * @param pWch - wchar, it must be already lower-cased
+ * @return AB-code, i.e. wchar's index plus 1, or 0 if not found
+ **/
+BS_CHAR_T bsdicidxab_wchar_to_ichar (BsDicIdxAb *pAb, BS_WCHAR_T pWch);
+
 /* Temporary result holder, no need to dynamic allocate */
 typedef struct {
   int max_iword_len; //pointer to return max i.word (in idx.AB) length
@@ -111,6 +135,23 @@ typedef int BsDicIdxAb_Iter_Dwrd_Fill(FILE*, int, BsDicIdxAb*, BsDicIdxAbTotals*
 int bsdicidxab_iter_dsl_fill(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicIdxAb *pIdx_ab,
   BsDicIdxAbTotals *p_totals); //TODO 1 extract into AB-DSL lib
 
+/**
+ * <p>
+ * Type-safe single pass iterator trough whole memory mapped DSL dictionary,
+ * just read dic.word will be consumed by AB filler, if consumer returns an error,
+ * then iteration will stop. Headwords positions will be remembered
+ * for further iterating by bsdicdslmm_iter_hw.
+ * </p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pIdxAb pointer to index alphabet
+ * @param pTotals pointer to return totals
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error.
+ **/
+int bsdicidxab_iter_dslmm_fill (BsDicDslMm *pDslMm, int pDeBufSz,
+                                BsDicIdxAb *pIdxAb, BsDicIdxAbTotals *pTotals);
+
 /**
  * <p>
  * Fills alphabet with wide char string.
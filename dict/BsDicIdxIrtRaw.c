@@ -129,7 +129,23 @@ int bsdicidxirttst_i2wrds_match(BsDicI2wrds *p_i2wrds, BsDicIdxIrtMchd *p_matche
  * @set errno if error.
  **/
 BsDicIdxIrtRaw *bsdicidxirtraw_new(BS_IDX_T pBufSz) {
-  return (BsDicIdxIrtRaw*) bsdatasettus_new(sizeof(BsDicIdxIrtRaw), pBufSz);
+  BsDicIdxIrtRaw *obj = (BsDicIdxIrtRaw*) bsdatasettus_new(sizeof(BsDicIdxIrtRaw), pBufSz);
+  if (obj != NULL) {
+    obj->arena = NULL;
+  }
+  return obj;
+}
+
+/**
+ * <p>Destructor of arena's record, it frees only not transferred idx_subwrd.</p>
+ * @param p_irtrcd IRT record
+ * @return always NULL
+ **/
+static BsDicIdxIrtRawRd *s_irtrawrd_free_ar(BsDicIdxIrtRawRd *p_irtrcd) {
+  if (p_irtrcd->idx_subwrd != NULL) {
+    free(p_irtrcd->idx_subwrd);
+  }
+  return NULL;
 }
 
 /**
@@ -139,7 +155,10 @@ BsDicIdxIrtRaw *bsdicidxirtraw_new(BS_IDX_T pBufSz) {
  **/
 BsDicIdxIrtRaw *bsdicidxirtraw_free(BsDicIdxIrtRaw *pSet) {
   if (pSet != NULL) {
-    bsdatasettus_free((BsDataSetTus*) pSet, (Bs_Destruct*) &bsdicidxirtrawrd_free);
+    BsArena *arena = pSet->arena;
+    bsdatasettus_free((BsDataSetTus*) pSet, arena == NULL ?
+      (Bs_Destruct*) &bsdicidxirtrawrd_free : (Bs_Destruct*) &s_irtrawrd_free_ar);
+    bsarena_free(arena);
   }
   return NULL;
 }
@@ -164,7 +183,17 @@ BS_IDX_T bsdicidxirtraw_add_inc(BsDicIdxIrtRaw *pSet, BsDicIdxIrtRawRd *pObj, BS
  * @set errno if error.
  **/
 BsDicIdxIrtRawRd *bsdicidxirtrawrd_new() {
-  BsDicIdxIrtRawRd *obj = malloc(sizeof(BsDicIdxIrtRawRd));
+  return bsdicidxirtrawrd_new_ar(NULL);
+}
+
+/**
+ * <p>Constructor in arena. Such record must not be freed by bsdicidxirtrawrd_free.</p>
+ * @param pArena arena or NULL to use malloc
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIdxIrtRawRd *bsdicidxirtrawrd_new_ar(BsArena *pArena) {
+  BsDicIdxIrtRawRd *obj = bsarena_alloc(pArena, sizeof(BsDicIdxIrtRawRd));
   if (obj != NULL) {
     obj->idx_subwrd = NULL;
     obj->idx_subwrd_size = 0;
@@ -205,6 +234,18 @@ BsDicIdxIrtRawRd *bsdicidxirtrawrd_free(BsDicIdxIrtRawRd *p_irtrcd) {
  * @set errno if error.
  **/
 void bsdicidxirtrcd_set_bulk(BsDicIdxIrtRawRd *p_irtrcd, BsDicIdxIrtMchd *p_matched_data) {
+  bsdicidxirtrcd_set_bulk_ar(p_irtrcd, p_matched_data, NULL);
+}
+
+/**
+ * <p>Bulk setter with I2WPT indexes in arena.</p>
+ * @param p_irtrcd IRT record
+ * @param p_matched_data data
+ * @param pArena arena or NULL to use malloc
+ * @set errno if error.
+ **/
+void bsdicidxirtrcd_set_bulk_ar(BsDicIdxIrtRawRd *p_irtrcd, BsDicIdxIrtMchd *p_matched_data,
+  BsArena *pArena) {
   if (p_matched_data->idx_subwrd_size > UCHAR_MAX) {
     errno = BSE_INTEGER_OVERFLOW;
     BSLOG_ERR
@@ -219,9 +260,10 @@ void bsdicidxirtrcd_set_bulk(BsDicIdxIrtRawRd *p_irtrcd, BsDicIdxIrtMchd *p_matc
   }
   bsdicidx_istr_cpy(p_irtrcd->idx_subwrd, p_matched_data->idx_subwrd);
   if (p_matched_data->i2wpt_quantity > 0) {
-    p_irtrcd->i2wpt_dwolt_idx = malloc(p_matched_data->i2wpt_quantity * BS_IDX_LEN);
+    p_irtrcd->i2wpt_dwolt_idx = bsarena_alloc(pArena, p_matched_data->i2wpt_quantity * BS_IDX_LEN);
     if (p_irtrcd->i2wpt_dwolt_idx == NULL) {
       free(p_irtrcd->idx_subwrd);
+      p_irtrcd->idx_subwrd = NULL;
       if ( errno == 0 ) { errno = ENOMEM; }
       BSLOG_ERR
       return;
@@ -235,20 +277,20 @@ void bsdicidxirtrcd_set_bulk(BsDicIdxIrtRawRd *p_irtrcd, BsDicIdxIrtMchd *p_matc
 }
 
 /**
- * <p>Create IRT in memory from array of sorted i.words in memory.</p>
+ * <p>Iterate trough IRT records made from range of sorted i.words,
+ * just made record's data will be consumed by given consumer.</p>
  * @param p_iwrds - ordered iwords array
- * @param p_i2wrds - ordered i2words array
+ * @param p_i2wrds - ordered i2words array or NULL
+ * @param pStt - range start
+ * @param pEnd - range end
  * @param pIrtTots IRT totals to make
- * @return object or NULL when error
+ * @param pCsm - IRT record data consumer
+ * @param pInst - instrument to consume data
+ * @return BSR_OK_END or consumer's last return value or errno
  * @set errno if error.
  **/
-BsDicIdxIrtRaw *bsdicidxirtraw_create(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds,
-  BsDicIdxIrtTots *pIrtTots) {
-  BS_IDX_T irtsz0 = p_iwrds->size / BS_IDX_10; //usually less than 10%
-  if (irtsz0 == BS_IDX_0) { irtsz0 = BS_IDX_1; }
-  BS_IDX_T irtinc = p_iwrds->size / BS_IDX_100;
-  if (irtinc == BS_IDX_0) { irtinc = BS_IDX_1; }
-  BSDICIDXIRT_NEW_E_RETN(irt, irtsz0)
+static int s_iter(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds, BS_IDX_T pStt,
+  BS_IDX_T pEnd, BsDicIdxIrtTots *pIrtTots, BsDicIdxIrtMchd_Csm *pCsm, void *pInst) {
   int rez = 0;
   BS_CHAR_T first_chars[p_iwrds->idx_ab->chrsTot];
   int i;
@@ -264,8 +306,8 @@ BsDicIdxIrtRaw *bsdicidxirtraw_create(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds
   int idx_wrd_size = p_iwrds->max_iword_size + 1;
   BS_SMALL_T i2wpt_dwolt_idx_sz = BDI_MAX_MATCHED_WORDS; //this temporary data isn't too big
   BSDICIDXIRTMCHD_CREATE(matched_data, idx_wrd_size, i2wpt_dwolt_idx_sz, p_iwrds->idx_ab->ispace)
-  BS_IDX_T l, irtIdx, prev_i2wrds_count = BS_IDX_0;
-  for (l = BS_IDX_0; l < p_iwrds->size; l++) { //without duplicates
+  BS_IDX_T l, prev_i2wrds_count = BS_IDX_0;
+  for (l = pStt; l < pEnd; l++) { //without duplicates
     //1.1 process word's all or up to triggered rule letters:
     int idxw_lenm1 = bsdicidx_istr_len(p_iwrds->vals[l]->iword) - 1;
     for (int j = 0; j <= idxw_lenm1; j++) {
@@ -313,17 +355,21 @@ BsDicIdxIrtRaw *bsdicidxirtraw_create(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds
           //previous word with same start index already done 
           break;
         }
-        BSDICIDXIRTRAWRCD_NEW_ERR_OUTE(irtrcd)
         if (p_iwrds->vals[l]->length_dword == 0) {
           prev_i2wrds_count++;
         } else {
           matched_data.dwolt_start = l - prev_i2wrds_count;
         }
-        BS_DO_E_OUTE(irtIdx = bsdicidxirtraw_add_inc(irt, irtrcd, irtinc))
-        BS_DO_E_OUTE(bsdicidxirtrcd_set_bulk(irtrcd, &matched_data))
+        rez = pCsm(&matched_data, pInst);
+        if (rez != 0) {
+          if (errno != 0) {
+            BSLOG_ERR
+          }
+          return rez;
+        }
 #ifdef BS_USE_LOG_DETAIL1
         if (chrdbgl >=dbgFlr && chrdbgl<= dbgClg) {
-          bslog_log(BSLONLYMSG, "    created IRT IDX="BS_IDX_FMT" dwolt_start="BS_IDX_FMT" i2wpt_quantity=%d\n", irtIdx, matched_data.dwolt_start, matched_data.i2wpt_quantity);
+          bslog_log(BSLONLYMSG, "    created IRT IDX="BS_IDX_FMT" dwolt_start="BS_IDX_FMT" i2wpt_quantity=%d\n", pIrtTots->irtSz, matched_data.dwolt_start, matched_data.i2wpt_quantity);
         }
 #endif
         //save last index data:
@@ -354,7 +400,97 @@ BsDicIdxIrtRaw *bsdicidxirtraw_create(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds
       }
     }
   }
-  BSLOG_LOG(BSLINFO, "Created IRTRAW: hirtSz=%d, mxIrWdSz=%d, alIrWdsSz="BS_IDX_FMT", irtSz="BS_IDX_FMT", i2wptSz="BS_IDX_FMT"\n", pIrtTots->hirtSz, pIrtTots->mxIrWdSz, pIrtTots->alIrWdsSz, pIrtTots->irtSz, pIrtTots->i2wptSz);
+  return BSR_OK_END;
+oute:
+  return errno;
+}
+
+/**
+ * <p>Iterate trough all IRT records made from arrays of sorted i.words,
+ * just made record's data will be consumed by given consumer.</p>
+ * @param p_iwrds - ordered iwords array
+ * @param p_i2wrds - ordered i2words array or NULL
+ * @param pIrtTots IRT totals to make
+ * @param pCsm - IRT record data consumer
+ * @param pInst - instrument to consume data
+ * @return BSR_OK_END or consumer's last return value or errno
+ * @set errno if error.
+ **/
+int bsdicidxirtraw_iter(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds,
+  BsDicIdxIrtTots *pIrtTots, BsDicIdxIrtMchd_Csm *pCsm, void *pInst) {
+  int rez = s_iter(p_iwrds, p_i2wrds, BS_IDX_0, p_iwrds->size, pIrtTots, pCsm, pInst);
+  if (rez == BSR_OK_END) {
+    BSLOG_LOG(BSLINFO, "Created IRTRAW: hirtSz=%d, mxIrWdSz=%d, alIrWdsSz="BS_IDX_FMT", irtSz="BS_IDX_FMT", i2wptSz="BS_IDX_FMT"\n", pIrtTots->hirtSz, pIrtTots->mxIrWdSz, pIrtTots->alIrWdsSz, pIrtTots->irtSz, pIrtTots->i2wptSz);
+  }
+  return rez;
+}
+
+/**
+ * <p>Consumer of just made IRT record data that adds record into IRT in memory.</p>
+ * @param p_matched_data - record data
+ * @param p_irt - IRT in memory
+ * @return 0 to continue iteration or errno
+ * @set errno if error.
+ **/
+static int s_irtraw_csm(BsDicIdxIrtMchd *p_matched_data, BsDicIdxIrtRaw *p_irt) {
+  BS_DO_E_RETE(BsDicIdxIrtRawRd *irtrcd = bsdicidxirtrawrd_new_ar(p_irt->arena))
+  BS_DO_E_RETE(bsdicidxirtraw_add_inc(p_irt, irtrcd, p_irt->bsize / BS_IDX_10 + BS_IDX_1))
+  BS_DO_E_RETE(bsdicidxirtrcd_set_bulk_ar(irtrcd, p_matched_data, p_irt->arena))
+  return 0;
+}
+
+/**
+ * <p>Constructor with own arena, so records must be made by
+ * bsdicidxirtrawrd_new_ar with its arena.</p>
+ * @param pBufSz buffer size, must be more than 0
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIdxIrtRaw *bsdicidxirtraw_new_ar(BS_IDX_T pBufSz) {
+  BS_DO_E_RETN(BsDicIdxIrtRaw *obj = bsdicidxirtraw_new(pBufSz))
+  obj->arena = bsarena_new(BSARENA_BLKSZ);
+  if (obj->arena == NULL) {
+    obj = bsdicidxirtraw_free(obj);
+  }
+  return obj;
+}
+
+/**
+ * <p>Add IRT records made from range of sorted i.words into IRT in memory.
+ * Records of i.words with the same first char depend only on them and
+ * on i2words with that char, so range of whole first char groups gives
+ * the same records as all i.words do, e.g. to update IDX.
+ * I.words must be without i2words, i.e. not less than
+ * BDI_MAX_IWORDS_TO_AVOIDI2W.</p>
+ * @param pIrt - IRT in memory with arena
+ * @param p_iwrds - ordered iwords array
+ * @param p_i2wrds - ordered i2words array or NULL
+ * @param pStt - range start, i.e. the first i.word with its first char
+ * @param pEnd - range end, i.e. the first i.word with other first char or size
+ * @param pIrtTots IRT totals to make
+ * @set errno if error.
+ **/
+void bsdicidxirtraw_add_rng(BsDicIdxIrtRaw *pIrt, BsDicIwrds *p_iwrds,
+  BsDicI2wrds *p_i2wrds, BS_IDX_T pStt, BS_IDX_T pEnd, BsDicIdxIrtTots *pIrtTots) {
+  BS_DO_E_RET(s_iter(p_iwrds, p_i2wrds, pStt, pEnd, pIrtTots,
+    (BsDicIdxIrtMchd_Csm*) s_irtraw_csm, (void*) pIrt))
+}
+
+/**
+ * <p>Create IRT in memory from array of sorted i.words in memory.</p>
+ * @param p_iwrds - ordered iwords array
+ * @param p_i2wrds - ordered i2words array
+ * @param pIrtTots IRT totals to make
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIdxIrtRaw *bsdicidxirtraw_create(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds,
+  BsDicIdxIrtTots *pIrtTots) {
+  BS_IDX_T irtsz0 = p_iwrds->size / BS_IDX_10; //usually less than 10%
+  if (irtsz0 == BS_IDX_0) { irtsz0 = BS_IDX_1; }
+  BS_DO_E_RETN(BsDicIdxIrtRaw *irt = bsdicidxirtraw_new_ar(irtsz0))
+  BS_DO_E_OUTE(bsdicidxirtraw_iter(p_iwrds, p_i2wrds, pIrtTots,
+    (BsDicIdxIrtMchd_Csm*) s_irtraw_csm, (void*) irt))
   return irt;
 oute:
   bsdicidxirtraw_free(irt);
@@ -54,6 +54,14 @@ typedef struct {
  **/
 BsDicIdxIrtRawRd *bsdicidxirtrawrd_new();
 
+/**
+ * <p>Constructor in arena. Such record must not be freed by bsdicidxirtrawrd_free.</p>
+ * @param pArena arena or NULL to use malloc
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIdxIrtRawRd *bsdicidxirtrawrd_new_ar (BsArena *pArena);
+
 /**
  * <p>Destructor.</p>
  * @param p_irtrcd IRT record
@@ -67,9 +75,12 @@ BsDicIdxIrtRawRd *bsdicidxirtrawrd_free(BsDicIdxIrtRawRd *p_irtrcd);
 /**
  * <p>IRT in memory.</p>
  * @extends BSDATASET(BsDicIdxIrtRawRd)
+ * @member BsArena *arena - records and their I2WPT indexes memory or NULL if they are malloc'ed,
+ *   idx_subwrd is always malloc'ed cause it's transferred into final IRT record
  **/
 typedef struct { 
   BSDATASET(BsDicIdxIrtRawRd)
+  BsArena *arena;
 } BsDicIdxIrtRaw;
 
 /**
@@ -133,6 +144,16 @@ typedef struct {
  **/
 void bsdicidxirtrcd_set_bulk(BsDicIdxIrtRawRd *p_irtrcd, BsDicIdxIrtMchd *p_matched_data);
 
+/**
+ * <p>Bulk setter with I2WPT indexes in arena.</p>
+ * @param p_irtrcd IRT record
+ * @param p_matched_data data
+ * @param pArena arena or NULL to use malloc
+ * @set errno if error.
+ **/
+void bsdicidxirtrcd_set_bulk_ar (BsDicIdxIrtRawRd *p_irtrcd, BsDicIdxIrtMchd *p_matched_data,
+  BsArena *pArena);
+
 /**
  * <p>Totals calculated during filling temporary IRT file.
  * Part of it is saved into IDX file, so it's a dynamic thing.
@@ -167,6 +188,57 @@ BsDicIdxIrtTots *bsdicidxirttotals_new();
  **/
 BsDicIdxIrtTots *bsdicidxirttotals_free(BsDicIdxIrtTots *pIrtTots);
 
+/**
+ * <p>Type-unsafe consumer of just made IRT record data.</p>
+ * @param p_matched_data - record data with index sub-word and matched phrases,
+ *   it's valid only during consuming
+ * @param pInst - instrument to consume data
+ * @return 0 to continue iteration, otherwise stop iteration
+ * @set errno if error.
+ **/
+typedef int BsDicIdxIrtMchd_Csm(BsDicIdxIrtMchd*, void*);
+
+/**
+ * <p>Iterate trough all IRT records made from arrays of sorted i.words,
+ * just made record's data will be consumed by given consumer.</p>
+ * @param p_iwrds - ordered iwords array
+ * @param p_i2wrds - ordered i2words array or NULL
+ * @param pIrtTots IRT totals to make
+ * @param pCsm - IRT record data consumer
+ * @param pInst - instrument to consume data
+ * @return BSR_OK_END or consumer's last return value or errno
+ * @set errno if error.
+ **/
+int bsdicidxirtraw_iter(BsDicIwrds *p_iwrds, BsDicI2wrds *p_i2wrds,
+  BsDicIdxIrtTots *pIrtTots, BsDicIdxIrtMchd_Csm *pCsm, void *pInst);
+
+/**
+ * <p>Constructor with own arena, so records must be made by
+ * bsdicidxirtrawrd_new_ar with its arena.</p>
+ * @param pBufSz buffer size, must be more than 0
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIdxIrtRaw *bsdicidxirtraw_new_ar(BS_IDX_T pBufSz);
+
+/**
+ * <p>Add IRT records made from range of sorted i.words into IRT in memory.
+ * Records of i.words with the same first char depend only on them and
+ * on i2words with that char, so range of whole first char groups gives
+ * the same records as all i.words do, e.g. to update IDX.
+ * I.words must be without i2words, i.e. not less than
+ * BDI_MAX_IWORDS_TO_AVOIDI2W.</p>
+ * @param pIrt - IRT in memory with arena
+ * @param p_iwrds - ordered iwords array
+ * @param p_i2wrds - ordered i2words array or NULL
+ * @param pStt - range start, i.e. the first i.word with its first char
+ * @param pEnd - range end, i.e. the first i.word with other first char or size
+ * @param pIrtTots IRT totals to make
+ * @set errno if error.
+ **/
+void bsdicidxirtraw_add_rng(BsDicIdxIrtRaw *pIrt, BsDicIwrds *p_iwrds,
+  BsDicI2wrds *p_i2wrds, BS_IDX_T pStt, BS_IDX_T pEnd, BsDicIdxIrtTots *pIrtTots);
+
 /**
  * <p>Create IRT in memory from array of sorted i.words in memory.</p>
  * @param p_iwrds - ordered iwords array
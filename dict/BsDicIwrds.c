@@ -24,20 +24,43 @@ See the LICENSE in the root source folder */
  **/
 BsDicI2wrdRd *bsdici2wrdrd_new(BS_CHAR_T *p_iphrase, int p_i2wstart, int p_i2wsize,
   BS_IDX_T p_iphrase_idx) {
-  BsDicI2wrdRd *obj = malloc(sizeof(BsDicI2wrdRd));
-  if (obj != NULL) {
-    obj->iword = malloc(p_i2wsize * sizeof(BS_CHAR_T));
-    if (obj->iword == NULL) {
-      obj = bsdici2wrdrd_free(obj);
-    } else {
-      int i;
-      for (i = 0; i < p_i2wsize - 1; i++) {
-        obj->iword[i] = p_iphrase[p_i2wstart + i];
+  return bsdici2wrdrd_new_ar(NULL, p_iphrase, p_i2wstart, p_i2wsize, p_iphrase_idx);
+}
+
+/**
+ * <p>Constructor in arena. Such record must not be freed by bsdici2wrdrd_free.</p>
+ * @param pArena arena or NULL to use malloc
+ * @param p_phrase phrase to copy from
+ * @param p_i2wstart I2WORD index start in p_phrase
+ * @param p_i2wsize I2WORD size
+ * @param p_iphrase_idx index of parent phrase in IWORDS
+ * @set errno if error.
+ **/
+BsDicI2wrdRd *bsdici2wrdrd_new_ar(BsArena *pArena, BS_CHAR_T *p_iphrase,
+  int p_i2wstart, int p_i2wsize, BS_IDX_T p_iphrase_idx) {
+  BsDicI2wrdRd *obj;
+  if (pArena != NULL) { //record and its i.word in one chunk:
+    obj = bsarena_alloc(pArena, sizeof(BsDicI2wrdRd) + p_i2wsize * sizeof(BS_CHAR_T));
+    if (obj != NULL) {
+      obj->iword = (BS_CHAR_T*) (obj + 1);
+    }
+  } else {
+    obj = malloc(sizeof(BsDicI2wrdRd));
+    if (obj != NULL) {
+      obj->iword = malloc(p_i2wsize * sizeof(BS_CHAR_T));
+      if (obj->iword == NULL) {
+        obj = bsdici2wrdrd_free(obj);
       }
-      obj->iword[i] = 0;
-      obj->iphrase_idx = p_iphrase_idx;
     }
   }
+  if (obj != NULL) {
+    int i;
+    for (i = 0; i < p_i2wsize - 1; i++) {
+      obj->iword[i] = p_iphrase[p_i2wstart + i];
+    }
+    obj->iword[i] = 0;
+    obj->iphrase_idx = p_iphrase_idx;
+  }
   if (obj == NULL) {
     if ( errno == 0 ) { errno = ENOMEM; }
     BSLOG_ERR
@@ -72,83 +95,115 @@ int bsdici2wrdrd_compare(BsDicI2wrdRd *p_rcd1, BsDicI2wrdRd *p_rcd2) {
 
 
 /**
- * <p>Constructor and filler.</p>
+ * <p>Constructor of empty array with own arena.</p>
  * @param pBufSz total records
- * @param p_iwrds - whole phrases
+ * @param pIdx_ab alphabet
  * @return object or NULL when error
  * @set errno if error.
  **/
-BsDicI2wrds *bsdici2wrds_new_fill(BS_IDX_T pBufSz, BsDicIwrds *p_iwrds) {
+BsDicI2wrds *bsdici2wrds_new_ar(BS_IDX_T pBufSz, BsDicIdxAb *pIdx_ab) {
   BS_DO_E_RETN(BsDicI2wrds *obj = (BsDicI2wrds *)
     bsdatasettus_new(sizeof(BsDicI2wrds), pBufSz))
-  obj->idx_ab = p_iwrds->idx_ab;
-  // 1. make 2nd, 3d sub-words:
+  obj->idx_ab = pIdx_ab;
+  obj->arena = bsarena_new(BSARENA_BLKSZ);
+  if (obj->arena == NULL) {
+    obj = bsdici2wrds_free(obj);
+  }
+  return obj;
+}
+
+/**
+ * <p>Append 2nd, 3d... sub-words of given phrase into array
+ * for further bulk sorting.</p>
+ * @param pSet - i2words array with arena
+ * @param p_iwrds - whole phrases
+ * @param pIdx - phrase index
+ * @set errno if error.
+ **/
+void bsdici2wrds_add_phrase(BsDicI2wrds *pSet, BsDicIwrds *p_iwrds, BS_IDX_T pIdx) {
   BS_CHAR_T *iwords_done[10]; //10 pointers for done i2words from phrase
-  BS_IDX_T l;
-  for (l = BS_IDX_0; l < p_iwrds->size; l++) {
-    for (int iw = 0; iw < 10; iw++) {
-      iwords_done[iw] = NULL;
+  for (int iw = 0; iw < 10; iw++) {
+    iwords_done[iw] = NULL;
+  }
+  int sw_start = -1;
+  for (int i = 1; ; i++) {
+    int is_end_swrd = FALSE;
+    if (p_iwrds->vals[pIdx]->iword[i] == 0) {
+      if (sw_start > 0) {
+        is_end_swrd = TRUE;
+      } else {
+        break;
+      }
+    } else if (p_iwrds->vals[pIdx]->iword[i] == p_iwrds->idx_ab->ispace) {
+      if (sw_start > 0) {
+        is_end_swrd = TRUE;
+      } else {
+        sw_start = i + 1;
+      }
     }
-    int sw_start = -1;
-    for (int i = 1; ; i++) {
-      int is_end_swrd = FALSE;
-      if (p_iwrds->vals[l]->iword[i] == 0) {
-        if (sw_start > 0) {
-          is_end_swrd = TRUE;
-        } else {
+    if (is_end_swrd) {
+      //make i2word decord:
+      int i2wsz = i - sw_start + 1;
+      if (i2wsz - 1 < BSDICI2WORDMINLEN) { //TODO hieroglyphs
+        goto out;
+      }
+      BS_DO_E_RET(BsDicI2wrdRd *i2wrdrd = bsdici2wrdrd_new_ar(pSet->arena,
+        p_iwrds->vals[pIdx]->iword, sw_start, i2wsz, pIdx))
+      //rejecting due to duplicating IN CURRENT PHRASE:
+      for (int iw = 0; iw < 10; iw++) {
+        if (iwords_done[iw] == NULL) {
           break;
         }
-      } else if (p_iwrds->vals[l]->iword[i] == p_iwrds->idx_ab->ispace) {
-        if (sw_start > 0) {
-          is_end_swrd = TRUE;
-        } else {
-          sw_start = i + 1;
+        if (bsdicidx_istr_cmp(iwords_done[iw], i2wrdrd->iword) == 0) {
+          goto out; //reject duplicate, it's in arena
         }
       }
-      if (is_end_swrd) {
-        //make i2word decord:
-        int i2wsz = i - sw_start + 1;
-        if (i2wsz - 1 < BSDICI2WORDMINLEN) { //TODO hieroglyphs
-          goto out;
-        }
-        BS_DO_E_OUTE(BsDicI2wrdRd *i2wrdrd = bsdici2wrdrd_new(p_iwrds->vals[l]->iword,
-          sw_start, i2wsz, l))
-        //rejecting due to duplicating IN CURRENT PHRASE:
-        for (int iw = 0; iw < 10; iw++) {
-          if (iwords_done[iw] == NULL) {
-            break;
-          }
-          if (bsdicidx_istr_cmp(iwords_done[iw], i2wrdrd->iword) == 0) {
-            bsdici2wrdrd_free(i2wrdrd); //reject duplicate
-            goto out;
-          }
-        }
-        for (int iw = 1; iw < 10; iw++) {
-          if (iwords_done[iw] == NULL) {
-            iwords_done[iw] = i2wrdrd->iword;
-            break;
-          }
-        }
-        BS_DO_E_OUTE(bsdici2wrds_add_sort_inc(obj, i2wrdrd, BS_IDX_100))
-        //reset:
-        if (p_iwrds->vals[l]->iword[i] == 0) {
+      for (int iw = 1; iw < 10; iw++) {
+        if (iwords_done[iw] == NULL) {
+          iwords_done[iw] = i2wrdrd->iword;
           break;
         }
-      out:
-        sw_start = i + 1;
       }
+      BS_DO_E_RET(bsdatasettus_add_inc((BsDataSetTus*) pSet, (void*) i2wrdrd, pSet->bsize))
+    out: //reset, a short last sub-word also ends phrase:
+      if (p_iwrds->vals[pIdx]->iword[i] == 0) {
+        break;
+      }
+      sw_start = i + 1;
     }
   }
+}
+
+/**
+ * <p>Constructor and filler.</p>
+ * @param pBufSz total records
+ * @param p_iwrds - whole phrases
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicI2wrds *bsdici2wrds_new_fill(BS_IDX_T pBufSz, BsDicIwrds *p_iwrds) {
+  BS_DO_E_RETN(BsDicI2wrds *obj = bsdici2wrds_new_ar(pBufSz, p_iwrds->idx_ab))
+  // 1. make 2nd, 3d sub-words:
+  BS_IDX_T l;
+  for (l = BS_IDX_0; l < p_iwrds->size; l++) {
+    BS_DO_E_OUTE(bsdici2wrds_add_phrase(obj, p_iwrds, l))
+  }
+  BS_DO_E_OUTE(bsdatasettus_sort((BsDataSetTus*) obj, (Bs_Compare*) &bsdici2wrdrd_compare, 0))
   BSLOG_LOG(BSLINFO, "Created i2words: buf.size="BS_IDX_FMT", size="BS_IDX_FMT"\n", obj->bsize, obj->size);
   if (p_iwrds->size < BDI_MAX_IWORDS_TO_AVOIDI2W) {
     for (l = BS_IDX_0; l < obj->size; l++) {
-      BS_DO_E_OUTE(BsDicIwrdRd *iwrdrd = bsdiciwrdrd_new(obj->vals[l]->iword, l, 0))
+      BS_DO_E_OUTE(BsDicIwrdRd *iwrdrd = bsdiciwrdrd_new_ar(p_iwrds->arena,
+        obj->vals[l]->iword, l, 0))
       int iwsz = bsdicidx_istr_len(obj->vals[l]->iword) + 1;
       if (p_iwrds->max_iword_size < iwsz) {
         p_iwrds->max_iword_size = iwsz;
       }
       p_iwrds->all_iwords_size += iwsz;
+      BS_IDX_T sz = p_iwrds->size;
       BS_DO_E_OUTE(bsdiciwrds_addi2w_sortm_inc(p_iwrds, iwrdrd, BS_IDX_100))
+      if (sz == p_iwrds->size && p_iwrds->arena == NULL) { //rejected duplicate
+        bsdiciwrdrd_free(iwrdrd);
+      }
     }
     BSLOG_LOG(BSLINFO, "Added i2words into i.words sorted: bsize="BS_IDX_FMT", size="BS_IDX_FMT", max i.word size=%d, all_iwords_size="BS_IDX_FMT"\n", p_iwrds->bsize, p_iwrds->size, p_iwrds->max_iword_size, p_iwrds->all_iwords_size);
   }
@@ -165,7 +220,10 @@ oute:
  **/
 BsDicI2wrds *bsdici2wrds_free(BsDicI2wrds *pSet) {
   if (pSet != NULL) {
-    bsdatasettus_free((BsDataSetTus*) pSet, (Bs_Destruct*) &bsdici2wrdrd_free);
+    BsArena *arena = pSet->arena;
+    bsdatasettus_free((BsDataSetTus*) pSet,
+      arena == NULL ? (Bs_Destruct*) &bsdici2wrdrd_free : NULL);
+    bsarena_free(arena);
   }
   return NULL;
 }
@@ -197,22 +255,45 @@ BsDicIwrdRd*
   bsdiciwrdrd_new (BS_CHAR_T *pIwrdc, BS_FOFST_T p_dwofst,
                 BS_SMALL_T p_dwlen)
 {
-  BsDicIwrdRd *obj = malloc (sizeof (BsDicIwrdRd));
+  return bsdiciwrdrd_new_ar (NULL, pIwrdc, p_dwofst, p_dwlen);
+}
 
-  if ( obj != NULL )
-  {
-    int iwsz = bsdicidx_istr_len (pIwrdc) + 1;
-    obj->iword = malloc (iwsz * sizeof (BS_CHAR_T));
+/**
+ * <p>Constructor in arena. Such record must not be freed by bsdiciwrdrd_free.</p>
+ * @param pArena arena or NULL to use malloc
+ * @param pIwrdc i.word to  copy
+ * @param p_dwofst d.word offset
+ * @param p_dwlen d.word length
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIwrdRd*
+  bsdiciwrdrd_new_ar (BsArena *pArena, BS_CHAR_T *pIwrdc,
+                BS_FOFST_T p_dwofst, BS_SMALL_T p_dwlen)
+{
+  BsDicIwrdRd *obj;
+  int iwsz = bsdicidx_istr_len (pIwrdc) + 1;
 
-    if ( obj->iword == NULL )
+  if ( pArena != NULL )
+  { //record and its i.word in one chunk:
+    obj = bsarena_alloc (pArena, sizeof (BsDicIwrdRd) + iwsz * sizeof (BS_CHAR_T));
+    if ( obj != NULL )
+                { obj->iword = (BS_CHAR_T*) (obj + 1); }
+  } else {
+    obj = malloc (sizeof (BsDicIwrdRd));
+    if ( obj != NULL )
     {
-      obj = bsdiciwrdrd_free (obj);
-    } else {
-      bsdicidx_istr_cpy (obj->iword, pIwrdc);
-      obj->offset_dword = p_dwofst;
-      obj->length_dword = p_dwlen;
+      obj->iword = malloc (iwsz * sizeof (BS_CHAR_T));
+      if ( obj->iword == NULL )
+                { obj = bsdiciwrdrd_free (obj); }
     }
   }
+  if ( obj != NULL )
+  {
+    bsdicidx_istr_cpy (obj->iword, pIwrdc);
+    obj->offset_dword = p_dwofst;
+    obj->length_dword = p_dwlen;
+  }
   if ( obj == NULL )
   {
     if ( errno == 0 ) { errno = ENOMEM; }
@@ -281,6 +362,26 @@ BsDicIwrds*
   obj->max_iword_size = 0;
   obj->all_iwords_size = BS_IDX_0;
   obj->dwoltSz = BS_IDX_0;
+  obj->arena = NULL;
+  return obj;
+}
+
+/**
+ * <p>Constructor with own arena, so records must be made by
+ * bsdiciwrdrd_new_ar with its arena, and they are released at once
+ * by destructor.</p>
+ * @param pBufSz total records
+ * @param pIdx_ab alphabet
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIwrds*
+  bsdiciwrds_new_ar (BS_IDX_T pBufSz, BsDicIdxAb *pIdx_ab)
+{
+  BS_DO_E_RETN (BsDicIwrds *obj = bsdiciwrds_new (pBufSz, pIdx_ab))
+  obj->arena = bsarena_new (BSARENA_BLKSZ);
+  if ( obj->arena == NULL )
+                { obj = bsdiciwrds_free (obj); }
   return obj;
 }
 
@@ -294,7 +395,10 @@ BsDicIwrds*
 {
   if ( pSet != NULL )
   {
-    bsdatasettus_free ((BsDataSetTus*) pSet, (Bs_Destruct*) &bsdiciwrdrd_free);
+    BsArena *arena = pSet->arena;
+    bsdatasettus_free ((BsDataSetTus*) pSet,
+      arena == NULL ? (Bs_Destruct*) &bsdiciwrdrd_free : NULL);
+    bsarena_free (arena);
   }
   return NULL;
 }
@@ -316,6 +420,36 @@ BS_IDX_T
                           pInc, (Bs_Compare*) &bsdiciwrdrd_compare, false);
 }
 
+/**
+ * <p>Add i.word to the end of array for further bulk sorting by bsdiciwrds_sort.
+ * It doubles array if it's full-filled.</p>
+ * @param pSet - data set
+ * @param pObj - object NON-NULL
+ * @return index of added object when OK
+ * @set errno - BSE_ARR_SET_NULL, BSE_ARR_OUT_MAX_SIZE or ENOMEM
+ **/
+BS_IDX_T
+  bsdiciwrds_add_inc (BsDicIwrds *pSet, BsDicIwrdRd *pObj)
+{
+  return bsdatasettus_add_inc ((BsDataSetTus*) pSet, (void*) pObj, pSet->bsize);
+}
+
+/**
+ * <p>Sort i.words added by bsdiciwrds_add_inc and remove duplicates,
+ * so result is same as made by bsdiciwrds_add_sort_inc.</p>
+ * @param pSet - data set
+ * @param pThrdCnt - maximum threads, 0 means online processors count
+ * @set errno - ENOMEM
+ **/
+void
+  bsdiciwrds_sort (BsDicIwrds *pSet, int pThrdCnt)
+{
+  BS_DO_E_RET (bsdatasettus_sort ((BsDataSetTus*) pSet,
+                 (Bs_Compare*) &bsdiciwrdrd_compare, pThrdCnt))
+  bsdatasettus_uniq ((BsDataSetTus*) pSet, (Bs_Compare*) &bsdiciwrdrd_compare,
+    pSet->arena == NULL ? (Bs_Destruct*) &bsdiciwrdrd_free : NULL);
+}
+
 /**
  * <p>Add i2word record into array with sorting without matched duplicates, e.g.
  * "sense" is duplicate for "sense of humor".
@@ -352,21 +486,56 @@ int bsdiciwrds_dwrd_csm(BsDicWord *p_dword, BsDicIwrds *p_iwrds) {
   if (is_debug) {
     bslog_log(BSLONLYMSG, "Consuming d.word=%ls, dwofst=%ld, dwlen=%d, dwsz=%d, iwsz=%d", p_dword->word, p_dword->offset, p_dword->lenChrs, dwsz, iwsz);
   }
-  BS_DO_E_RETE(BsDicIwrdRd *iwrdrd = bsdiciwrdrd_new(iwrd, p_dword->offset, p_dword->lenChrs))
+  BS_DO_E_RETE(BsDicIwrdRd *iwrdrd = bsdiciwrdrd_new_ar(p_iwrds->arena, iwrd,
+    p_dword->offset, p_dword->lenChrs))
   if (is_debug) {
     bslog_log(BSLONLYMSG, ", ... created iwrdrd#%p, .iword#%p\n", iwrdrd, iwrdrd->iword);
   }
+  BS_IDX_T sz = p_iwrds->size;
   BS_DO_E_OUTE(bsdiciwrds_add_sort_inc(p_iwrds, iwrdrd, BS_IDX_100))
+  if (sz == p_iwrds->size && p_iwrds->arena == NULL) { //rejected duplicate
+    bsdiciwrdrd_free(iwrdrd);
+  }
   return 0;
 oute:
   BSLOG_LOG(BSLERROR, "Error on d.word=%ls\n", p_dword->word)
-  bsdiciwrdrd_free(iwrdrd);
+  if (p_iwrds->arena == NULL) {
+    bsdiciwrdrd_free(iwrdrd);
+  }
+  return errno;
+}
+
+/**
+ * <p>Type-safe consumer of just read dic.word. It appends i.word into array,
+ * so iterator will sort it in bulk at the end.</p>
+ * @param p_dword - pointer to return next word
+ * @param p_iwrds - pointer to make i.words array
+ * @return 0 to continue iteration, otherwise stop iteration
+ * @set errno if error.
+ **/
+int
+  bsdiciwrds_dwrd_csm_apnd (BsDicWord *p_dword, BsDicIwrds *p_iwrds)
+{
+  BS_CHAR_T iwrd[wcslen (p_dword->word) + 1];
+  bsdicidxab_wstr_to_istr (p_dword->word, iwrd, p_iwrds->idx_ab);
+  int iwsz = bsdicidx_istr_len (iwrd) + 1;
+  if ( p_iwrds->max_iword_size < iwsz )
+                { p_iwrds->max_iword_size = iwsz; }
+  p_iwrds->all_iwords_size += iwsz;
+  BS_DO_E_RETE (BsDicIwrdRd *iwrdrd = bsdiciwrdrd_new_ar (p_iwrds->arena, iwrd,
+                                        p_dword->offset, p_dword->lenChrs))
+  BS_DO_E_OUTE (bsdiciwrds_add_inc (p_iwrds, iwrdrd))
+  return 0;
+oute:
+  BSLOG_LOG (BSLERROR, "Error on d.word=%ls\n", p_dword->word)
+  if ( p_iwrds->arena == NULL )
+                { bsdiciwrdrd_free (iwrdrd); }
   return errno;
 }
 
 /**
  * <p>Iterates trough whole dictionary, just read d.word will be consumed
- * by bsdiciwrds_dwrd_csm.</p>
+ * by bsdiciwrds_dwrd_csm or bsdiciwrds_dwrd_csm_apnd, then i.words are sorted.</p>
  * @param pDicFl - opened unwound dictionary file
  * @param p_dic_entry_buffer_size - client expected/predicted this max entry size in dictionary
  * @param p_abtots AB totals
@@ -383,11 +552,39 @@ int bsdiciwrds_iter(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicIdxAbTotals
   *p_iwrds_ret = iwrds;
   BS_DO_E_RETE(int ret = p_dw_iter_all(pDicFl, p_dic_entry_buffer_size,
     (BsDicWord_Consume_Tus*) p_consumer, (void*) iwrds))
+  BS_DO_E_RETE(bsdiciwrds_sort(iwrds, 0))
   BSLOG_LOG(BSLINFO, "Created i.words: buf.size="BS_IDX_FMT", size="BS_IDX_FMT", max i.word size=%d, all_iwords_size="BS_IDX_FMT", chars=%d\n", iwrds->bsize, iwrds->size, iwrds->max_iword_size, iwrds->all_iwords_size, iwrds->idx_ab->chrsTot);
   iwrds->dwoltSz = iwrds->size;
   return ret;
 }
 
+/**
+ * <p>Iterates trough headwords of memory mapped DSL dictionary
+ * remembered by bsdicidxab_iter_dslmm_fill, just read d.word will be consumed
+ * by given consumer, then i.words are sorted.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pAbTots AB totals
+ * @param pIdxAb alphabet
+ * @param pConsumer - pointer to type-safe consumer BsDicIwrds_Dwrd_Csm
+ * @param pIwrdsRt - pointer to return sorted i.words array
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error.
+ **/
+int
+  bsdiciwrds_iter_dslmm (BsDicDslMm *pDslMm, int pDeBufSz, BsDicIdxAbTotals *pAbTots,
+    BsDicIdxAb *pIdxAb, BsDicIwrds_Dwrd_Csm pConsumer, BsDicIwrds **pIwrdsRt)
+{
+  BS_DO_E_RETE (BsDicIwrds *iwrds = bsdiciwrds_new_ar (pAbTots->dwoltSz, pIdxAb))
+  *pIwrdsRt = iwrds;
+  BS_DO_E_RETE (int ret = bsdicdslmm_iter_hw (pDslMm, pDeBufSz,
+    (BsDicWord_Consume_Tus*) pConsumer, (void*) iwrds))
+  BS_DO_E_RETE (bsdiciwrds_sort (iwrds, 0))
+  BSLOG_LOG (BSLINFO, "Created i.words: buf.size="BS_IDX_FMT", size="BS_IDX_FMT", max i.word size=%d, all_iwords_size="BS_IDX_FMT", chars=%d\n", iwrds->bsize, iwrds->size, iwrds->max_iword_size, iwrds->all_iwords_size, iwrds->idx_ab->chrsTot);
+  iwrds->dwoltSz = iwrds->size;
+  return ret;
+}
+
 /**
  * <p>Basic method. Find index of the first sorted i.word matched to given one.</p>
  * @param p_iword_- i.word to match
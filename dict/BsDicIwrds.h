@@ -12,6 +12,7 @@ See the LICENSE in the root source folder */
 #define BS_DEBUGL_DICIWORDS 30100
 
 #include "BsDataSet.h"
+#include "BsArena.h"
 #include "BsDicIdxAb.h"
 
 //max iwords to avoid adding i2words into iwords, small means switch off adding i2wordssorted into iwordssorted
@@ -89,6 +90,18 @@ typedef struct {
  **/
 BsDicIwrdRd *bsdiciwrdrd_new(BS_CHAR_T *pIwrdc, BS_FOFST_T p_dwofst, BS_SMALL_T p_dwlen);
 
+/**
+ * <p>Constructor in arena. Such record must not be freed by bsdiciwrdrd_free.</p>
+ * @param pArena arena or NULL to use malloc
+ * @param pIwrdc i.word to  copy
+ * @param p_dwofst d.word offset
+ * @param p_dwlen d.word length
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIwrdRd *bsdiciwrdrd_new_ar (BsArena *pArena, BS_CHAR_T *pIwrdc,
+  BS_FOFST_T p_dwofst, BS_SMALL_T p_dwlen);
+
 /**
  * <p>Destructor.</p>
  * @param pRcd IWORD record
@@ -120,6 +133,7 @@ int bsdiciwrdrd_comparem(BsDicIwrdRd *p_rcd1, BsDicIwrdRd *p_rcd2);
  * This is actually DWOLT plus i2words marked with length_dword=0.</p>
  * @extends BSDICIWORDSBASE(BsDicIwrdRd)
  * @member BS_IDX_T dwoltSz = size - i2words
+ * @member BsArena *arena - records memory or NULL if records are malloc'ed
  * //transient statistics:
  * @member int max_iword_size - maximum i-word size
  * @member unsigned long all_iwords_size - all i-words size
@@ -127,6 +141,7 @@ int bsdiciwrdrd_comparem(BsDicIwrdRd *p_rcd1, BsDicIwrdRd *p_rcd2);
 typedef struct {
   BSDICIWORDSBASE(BsDicIwrdRd)
   BS_IDX_T dwoltSz;
+  BsArena *arena;
   int max_iword_size;
   unsigned long all_iwords_size;
 } BsDicIwrds;
@@ -140,6 +155,17 @@ typedef struct {
  **/
 BsDicIwrds *bsdiciwrds_new(BS_IDX_T pBufSz, BsDicIdxAb *pIdx_ab);
 
+/**
+ * <p>Constructor with own arena, so records must be made by
+ * bsdiciwrdrd_new_ar with its arena, and they are released at once
+ * by destructor.</p>
+ * @param pBufSz total records
+ * @param pIdx_ab alphabet
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicIwrds *bsdiciwrds_new_ar (BS_IDX_T pBufSz, BsDicIdxAb *pIdx_ab);
+
 /**
  * <p>Destructor.</p>
  * @param p_iwrd_sort allocated array of records i-words to sort or NULL
@@ -172,6 +198,25 @@ BS_IDX_T bsdiciwrds_add_sort_inc(BsDicIwrds *pSet, BsDicIwrdRd *pObj, BS_IDX_T p
  **/
 BS_IDX_T bsdiciwrds_addi2w_sortm_inc(BsDicIwrds *pSet, BsDicIwrdRd *pObj, BS_IDX_T pInc);
 
+/**
+ * <p>Add i.word to the end of array for further bulk sorting by bsdiciwrds_sort.
+ * It doubles array if it's full-filled.</p>
+ * @param pSet - data set
+ * @param pObj - object NON-NULL
+ * @return index of added object when OK
+ * @set errno - BSE_ARR_SET_NULL, BSE_ARR_OUT_MAX_SIZE or ENOMEM
+ **/
+BS_IDX_T bsdiciwrds_add_inc (BsDicIwrds *pSet, BsDicIwrdRd *pObj);
+
+/**
+ * <p>Sort i.words added by bsdiciwrds_add_inc and remove duplicates,
+ * so result is same as made by bsdiciwrds_add_sort_inc.</p>
+ * @param pSet - data set
+ * @param pThrdCnt - maximum threads, 0 means online processors count
+ * @set errno - ENOMEM
+ **/
+void bsdiciwrds_sort (BsDicIwrds *pSet, int pThrdCnt);
+
 /**
  * <p>Type-safe wrapper. Find index of the first sorted i.word matched to given one.</p>
  * @param p_iword_- i.word to match
@@ -199,9 +244,19 @@ typedef int BsDicIwrds_Dwrd_Csm(BsDicWord*, BsDicIwrds*);
  **/
 int bsdiciwrds_dwrd_csm(BsDicWord *p_dword, BsDicIwrds *p_iwrds);
 
+/**
+ * <p>Type-safe consumer of just read dic.word. It appends i.word into array,
+ * so iterator will sort it in bulk at the end.</p>
+ * @param p_dword - pointer to return next word
+ * @param p_iwrds - pointer to make i.words array
+ * @return 0 to continue iteration, otherwise stop iteration
+ * @set errno if error.
+ **/
+int bsdiciwrds_dwrd_csm_apnd (BsDicWord *p_dword, BsDicIwrds *p_iwrds);
+
 /**
  * <p>Iterates trough whole dictionary, just read d.word will be consumed
- * by bsdiciwrdsort_dwrd_csm.</p>
+ * by bsdiciwrdsort_dwrd_csm or bsdiciwrds_dwrd_csm_apnd, then i.words are sorted.</p>
  * @param pDicFl - opened unwound dictionary file
  * @param p_dic_entry_buffer_size - client expected/predicted this max entry size in dictionary
  * @param p_abtots AB totals
@@ -215,6 +270,23 @@ int bsdiciwrds_dwrd_csm(BsDicWord *p_dword, BsDicIwrds *p_iwrds);
 int bsdiciwrds_iter(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicIdxAbTotals *p_abtots, BsDicIdxAb *pIdx_ab,
   BsDicWord_Iter_Tus *p_dw_iter_all, BsDicIwrds_Dwrd_Csm p_consumer, BsDicIwrds **p_iwrds_ret);
 
+/**
+ * <p>Iterates trough headwords of memory mapped DSL dictionary
+ * remembered by bsdicidxab_iter_dslmm_fill, just read d.word will be consumed
+ * by given consumer, then i.words are sorted.
+ * I.words array has arena, so consumer must make records in it.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pAbTots AB totals
+ * @param pIdxAb alphabet
+ * @param pConsumer - pointer to type-safe consumer BsDicIwrds_Dwrd_Csm
+ * @param pIwrdsRt - pointer to return sorted i.words array
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error.
+ **/
+int bsdiciwrds_iter_dslmm (BsDicDslMm *pDslMm, int pDeBufSz, BsDicIdxAbTotals *pAbTots,
+  BsDicIdxAb *pIdxAb, BsDicIwrds_Dwrd_Csm pConsumer, BsDicIwrds **pIwrdsRt);
+
 //derived from IWORDS I2WORDS:
 
 #define BSDICI2WORDMINLEN 3
@@ -240,6 +312,18 @@ typedef struct {
 BsDicI2wrdRd *bsdici2wrdrd_new(BS_CHAR_T *p_iphrase, int p_i2wstart, int p_i2wsize,
   BS_IDX_T p_iphrase_idx);
 
+/**
+ * <p>Constructor in arena. Such record must not be freed by bsdici2wrdrd_free.</p>
+ * @param pArena arena or NULL to use malloc
+ * @param p_phrase phrase to copy from
+ * @param p_i2wstart I2WORD index start in p_phrase
+ * @param p_i2wsize I2WORD size
+ * @param p_iphrase_idx index of parent phrase in IWORDS
+ * @set errno if error.
+ **/
+BsDicI2wrdRd *bsdici2wrdrd_new_ar (BsArena *pArena, BS_CHAR_T *p_iphrase,
+  int p_i2wstart, int p_i2wsize, BS_IDX_T p_iphrase_idx);
+
 /**
  * <p>Destructor.</p>
  * @param pRcd I2WORD record
@@ -258,11 +342,32 @@ int bsdici2wrdrd_compare(BsDicI2wrdRd *p_rcd1, BsDicI2wrdRd *p_rcd2);
 /**
  * <p>Second sorted dic.i-2/3/4..words table I2WPT. It's made of main IWORDS table.</p>
  * @extends BSDICIWORDSBASE(BsDicI2wrdRd)
+ * @member BsArena *arena - records memory
  **/
 typedef struct {
   BSDICIWORDSBASE(BsDicI2wrdRd)
+  BsArena *arena;
 } BsDicI2wrds;
 
+/**
+ * <p>Constructor of empty array with own arena.</p>
+ * @param pBufSz total records
+ * @param pIdx_ab alphabet
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicI2wrds *bsdici2wrds_new_ar(BS_IDX_T pBufSz, BsDicIdxAb *pIdx_ab);
+
+/**
+ * <p>Append 2nd, 3d... sub-words of given phrase into array
+ * for further bulk sorting.</p>
+ * @param pSet - i2words array with arena
+ * @param p_iwrds - whole phrases
+ * @param pIdx - phrase index
+ * @set errno if error.
+ **/
+void bsdici2wrds_add_phrase(BsDicI2wrds *pSet, BsDicIwrds *p_iwrds, BS_IDX_T pIdx);
+
 /**
  * <p>Constructor and filler.</p>
  * @param pBufSz total records
@@ -0,0 +1,312 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+
+#include "stdlib.h"
+#include "unistd.h"
+#include "pthread.h"
+
+#include "BsLog.h"
+#include "BsError.h"
+#include "BsDicIwrdsMt.h"
+
+/**
+ * <p>Beigesoft™ multi-threaded (sharded) maker of AB and sorted I-Words.</p>
+ * @author Yury Demidenko
+ **/
+
+/**
+ * <p>Shard's worker data.</p>
+ * @member BsDicDslMm *shrd - shard of mapped dictionary
+ * @member int deBufSz - client expected/predicted this max entry size in dictionary
+ * @member BsDicIdxAb *idxAb - AB fragment, then shared merged AB
+ * @member BsDicIdxAbTotals tots - shard's AB totals
+ * @member BsDicIwrds *run - shard's sorted i.words with duplicates in its own arena
+ * @member int err - worker's errno
+ **/
+typedef struct {
+  BsDicDslMm *shrd;
+  int deBufSz;
+  BsDicIdxAb *idxAb;
+  BsDicIdxAbTotals tots;
+  BsDicIwrds *run;
+  int err;
+} BsDicIwrdsShrd;
+
+/**
+ * <p>Comparator for runs merging,
+ * equal i.words are ordered by offset, so the first d.word wins.</p>
+ * @param pRcd1 pointer to IWORD record1
+ * @param pRcd2 pointer to IWORD record2
+ * @return pRcd1 -1 less 0 equal 1 greater than pRcd2
+ **/
+static int
+  s_cmp_ofst (const void *pRcd1, const void *pRcd2)
+{
+  BsDicIwrdRd *rd1 = *(BsDicIwrdRd**) pRcd1;
+  BsDicIwrdRd *rd2 = *(BsDicIwrdRd**) pRcd2;
+  int rz = bsdiciwrdrd_compare (rd1, rd2);
+  if ( rz == 0 )
+  {
+    if ( rd1->offset_dword < rd2->offset_dword )
+    {
+      rz = -1;
+    } else if ( rd1->offset_dword > rd2->offset_dword ) {
+      rz = 1;
+    }
+  }
+  return rz;
+}
+
+/**
+ * <p>Worker that makes shard's AB fragment and totals.</p>
+ * @param pShrd - shard
+ * @return always NULL
+ **/
+static void*
+  s_wrk_fill_ab (void *pShrd)
+{
+  BsDicIwrdsShrd *shrd = (BsDicIwrdsShrd*) pShrd;
+  errno = 0;
+  bsdicidxab_iter_dslmm_fill (shrd->shrd, shrd->deBufSz, shrd->idxAb, &shrd->tots);
+  shrd->err = errno;
+  return NULL;
+}
+
+/**
+ * <p>Worker that makes shard's sorted i.words run by shared merged AB.</p>
+ * @param pShrd - shard
+ * @return always NULL
+ **/
+static void*
+  s_wrk_make_run (void *pShrd)
+{
+  BsDicIwrdsShrd *shrd = (BsDicIwrdsShrd*) pShrd;
+  errno = 0;
+  BS_IDX_T bsz = shrd->shrd->hwSz;
+  if ( bsz == BS_IDX_0 )
+                { bsz = BS_IDX_1; }
+  BS_DO_E_OUT (shrd->run = bsdiciwrds_new_ar (bsz, shrd->idxAb))
+  BS_DO_E_OUT (bsdicdslmm_iter_hw (shrd->shrd, shrd->deBufSz,
+                 (BsDicWord_Consume_Tus*) bsdiciwrds_dwrd_csm_apnd, (void*) shrd->run))
+  //stable sorting keeps equal i.words in offset order:
+  BS_DO_E_OUT (bsdatasettus_sort ((BsDataSetTus*) shrd->run,
+                 (Bs_Compare*) &bsdiciwrdrd_compare, 1))
+out:
+  shrd->err = errno;
+  return NULL;
+}
+
+/**
+ * <p>Run given worker for every shard in its own thread and wait for all.</p>
+ * @param pShrds - shards
+ * @param pCnt - shards count
+ * @param pWrk - worker
+ * @set errno if error.
+ **/
+static void
+  s_run_wrks (BsDicIwrdsShrd *pShrds, int pCnt, void *(*pWrk) (void*))
+{
+  pthread_t thrds[pCnt];
+  int i, crtd = 0, err = 0;
+  for ( i = 0; i < pCnt; i++ )
+  {
+    pShrds[i].err = 0;
+    if ( pthread_create (&thrds[i], NULL, pWrk, (void*) &pShrds[i]) != 0 )
+    {
+      err = BSE_ERR;
+      BSLOG_LOG (BSLERROR, "Can't create thread#%d\n", i)
+      break;
+    }
+    crtd++;
+  }
+  for ( i = 0; i < crtd; i++ )
+  {
+    pthread_join (thrds[i], NULL);
+    if ( err == 0 && pShrds[i].err != 0 )
+                { err = pShrds[i].err; }
+  }
+  errno = err;
+}
+
+/**
+ * <p>Merge shards sorted runs into result without duplicates,
+ * records are moved from runs.</p>
+ * @param pShrds - shards
+ * @param pCnt - shards count
+ * @param pIwrds - result with enough buffer
+ **/
+static void
+  s_merge_runs (BsDicIwrdsShrd *pShrds, int pCnt, BsDicIwrds *pIwrds)
+{
+  BS_IDX_T idxs[pCnt];
+  BsDicIwrdRd *lst = NULL;
+  int i, mn;
+  for ( i = 0; i < pCnt; i++ )
+  {
+    idxs[i] = BS_IDX_0;
+    pIwrds->all_iwords_size += pShrds[i].run->all_iwords_size;
+    if ( pIwrds->max_iword_size < pShrds[i].run->max_iword_size )
+                { pIwrds->max_iword_size = pShrds[i].run->max_iword_size; }
+  }
+  while ( true )
+  {
+    mn = -1;
+    for ( i = 0; i < pCnt; i++ )
+    {
+      if ( idxs[i] < pShrds[i].run->size && ( mn == -1
+        || s_cmp_ofst (&pShrds[i].run->vals[idxs[i]], &pShrds[mn].run->vals[idxs[mn]]) < 0 ) )
+                { mn = i; }
+    }
+    if ( mn == -1 )
+                { break; }
+    BsDicIwrdRd *rd = pShrds[mn].run->vals[idxs[mn]];
+    pShrds[mn].run->vals[idxs[mn]] = NULL;
+    idxs[mn]++;
+    if ( lst != NULL && bsdiciwrdrd_compare (lst, rd) == 0 )
+    { //reject duplicate with greater offset:
+      if ( pShrds[mn].run->arena == NULL )
+                { bsdiciwrdrd_free (rd); }
+    } else {
+      pIwrds->vals[pIwrds->size] = rd;
+      pIwrds->size++;
+      lst = rd;
+    }
+  }
+  for ( i = 0; i < pCnt; i++ )
+  { //result owns runs records:
+    pShrds[i].run->size = BS_IDX_0;
+    bsarena_join (pIwrds->arena, pShrds[i].run->arena);
+  }
+}
+
+/**
+ * <p>Evaluate worker threads count for given dictionary
+ * according online processors and shard minimum size.</p>
+ * @param pDslMm - mapped dictionary
+ * @return threads count from 1
+ **/
+int
+  bsdiciwrdsmt_thrds_cnt (BsDicDslMm *pDslMm)
+{
+  long cnt = sysconf (_SC_NPROCESSORS_ONLN);
+  long szCnt = pDslMm->sz / BSDICIWRDSMT_SHRD_MINSZ;
+  if ( cnt > szCnt )
+                { cnt = szCnt; }
+  if ( cnt > BSDICIWRDSMT_MAX_THRDS )
+                { cnt = BSDICIWRDSMT_MAX_THRDS; }
+  if ( cnt < 1 )
+                { cnt = 1; }
+  return (int) cnt;
+}
+
+/**
+ * <p>Make AB and sorted i.words without duplicates from mapped DSL dictionary.
+ * Dictionary is split by articles boundaries into shards,
+ * every worker thread makes AB fragment and totals from its shard,
+ * then fragments are merged into given AB, then every worker makes
+ * sorted i.words run from its shard by merged AB, then runs are merged
+ * into result, so it's same as made by bsdicidxab_iter_dslmm_fill
+ * and bsdiciwrds_iter_dslmm.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pThrdCnt - worker threads count, 1 or less means in current thread
+ * @param pIdxAb - just created alphabet to fill
+ * @param pAbTots - AB totals to fill
+ * @param pIwrdsRt - pointer to return sorted i.words array
+ * @return BSR_OK_END or errno
+ * @set errno if error.
+ **/
+int
+  bsdiciwrdsmt_make (BsDicDslMm *pDslMm, int pDeBufSz, int pThrdCnt,
+    BsDicIdxAb *pIdxAb, BsDicIdxAbTotals *pAbTots, BsDicIwrds **pIwrdsRt)
+{
+  if ( pThrdCnt <= 1 )
+  {
+    BS_DO_E_RETE (bsdicidxab_iter_dslmm_fill (pDslMm, pDeBufSz, pIdxAb, pAbTots))
+    return bsdiciwrds_iter_dslmm (pDslMm, pDeBufSz, pAbTots, pIdxAb,
+                                  bsdiciwrds_dwrd_csm_apnd, pIwrdsRt);
+  }
+  if ( pThrdCnt > BSDICIWRDSMT_MAX_THRDS )
+                { pThrdCnt = BSDICIWRDSMT_MAX_THRDS; }
+  BsDicIwrdsShrd shrds[pThrdCnt];
+  BsDicIwrds *iwrds = NULL;
+  BS_FOFST_T stt, end, hdEnd;
+  BS_IDX_T hwSz;
+  int i;
+  for ( i = 0; i < pThrdCnt; i++ )
+  {
+    shrds[i].shrd = NULL; shrds[i].idxAb = NULL; shrds[i].run = NULL;
+    shrds[i].deBufSz = pDeBufSz; shrds[i].err = 0;
+    shrds[i].tots.max_iword_len = 0; shrds[i].tots.dwoltSz = BS_IDX_0;
+    shrds[i].tots.i2wptSz = BS_IDX_0;
+  }
+  //1. split by articles:
+  BS_DO_E_OUTE (hdEnd = bsdicdslmm_find_art (pDslMm, pDeBufSz, BS_FOFST_0))
+  stt = BS_FOFST_0;
+  for ( i = 0; i < pThrdCnt; i++ )
+  {
+    if ( i == pThrdCnt - 1 )
+    {
+      end = pDslMm->sz;
+    } else {
+      BS_DO_E_OUTE (end = bsdicdslmm_find_art (pDslMm, pDeBufSz,
+                  hdEnd + ( pDslMm->sz - hdEnd ) * ( i + 1 ) / pThrdCnt))
+      if ( end < stt )
+                { end = stt; }
+    }
+    BS_DO_E_OUTE (shrds[i].shrd = bsdicdslmm_new_shrd (pDslMm, stt, end))
+    BS_DO_E_OUTE (shrds[i].idxAb = bsdicidxab_new (BDI_AB_BUF_INITSIZE))
+    stt = end;
+  }
+  //2. making AB fragments:
+  BS_DO_E_OUTE (s_run_wrks (shrds, pThrdCnt, s_wrk_fill_ab))
+  //3. merging AB fragments in dictionary order:
+  hwSz = BS_IDX_0;
+  for ( i = 0; i < pThrdCnt; i++ )
+  {
+    BS_WCHAR_T wchrs[shrds[i].idxAb->chrsTot + 1];
+    for ( int j = 0; j < shrds[i].idxAb->chrsTot; j++ )
+                { wchrs[j] = shrds[i].idxAb->wchars[j]; }
+    wchrs[shrds[i].idxAb->chrsTot] = 0;
+    BS_DO_E_OUTE (bsdicidxab_add_wstr (wchrs, pIdxAb))
+    shrds[i].idxAb = bsdicidxab_free (shrds[i].idxAb);
+    pAbTots->dwoltSz += shrds[i].tots.dwoltSz;
+    pAbTots->i2wptSz += shrds[i].tots.i2wptSz;
+    if ( pAbTots->max_iword_len < shrds[i].tots.max_iword_len )
+                { pAbTots->max_iword_len = shrds[i].tots.max_iword_len; }
+    hwSz += shrds[i].shrd->hwSz;
+  }
+  //headwords positions are remembered as if it was scanned in one thread:
+  pDslMm->hwSz = BS_IDX_0;
+  for ( i = 0; i < pThrdCnt; i++ )
+  {
+    BS_DO_E_OUTE (bsdicdslmm_add_hws (pDslMm, shrds[i].shrd->hwOfsts,
+                      shrds[i].shrd->hwLens, shrds[i].shrd->hwSz))
+  }
+  BSLOG_LOG (BSLINFO, "Merged AB from %d shards, chars total=%d, ispace=%d, max_iword_len=%d, dwoltSz=%lu, i2wptSz=%lu, headwords="BS_IDX_FMT"\n", pThrdCnt, pIdxAb->chrsTot, pIdxAb->ispace, pAbTots->max_iword_len, pAbTots->dwoltSz, pAbTots->i2wptSz, hwSz);
+  //4. making sorted runs by shared AB:
+  for ( i = 0; i < pThrdCnt; i++ )
+                { shrds[i].idxAb = pIdxAb; }
+  BS_DO_E_OUTE (s_run_wrks (shrds, pThrdCnt, s_wrk_make_run))
+  //5. merging runs:
+  BS_DO_E_OUTE (iwrds = bsdiciwrds_new_ar (pAbTots->dwoltSz, pIdxAb))
+  s_merge_runs (shrds, pThrdCnt, iwrds);
+  iwrds->dwoltSz = iwrds->size;
+  BSLOG_LOG (BSLINFO, "Created i.words: buf.size="BS_IDX_FMT", size="BS_IDX_FMT", max i.word size=%d, all_iwords_size="BS_IDX_FMT", chars=%d\n", iwrds->bsize, iwrds->size, iwrds->max_iword_size, iwrds->all_iwords_size, iwrds->idx_ab->chrsTot);
+  *pIwrdsRt = iwrds;
+  iwrds = NULL;
+oute:
+  for ( i = 0; i < pThrdCnt; i++ )
+  {
+    bsdicdslmm_free (shrds[i].shrd);
+    if ( shrds[i].idxAb != pIdxAb )
+                { bsdicidxab_free (shrds[i].idxAb); }
+    bsdiciwrds_free (shrds[i].run);
+  }
+  bsdiciwrds_free (iwrds);
+  if ( errno != 0 )
+                { return errno; }
+  return BSR_OK_END;
+}
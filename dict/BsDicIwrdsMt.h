@@ -0,0 +1,49 @@
+/* BSD 2-Clause License
+Copyright (c) 2020, Beigesoft™
+All rights reserved.
+See the LICENSE in the root source folder */
+/**
+ * <p>Beigesoft™ multi-threaded (sharded) maker of AB and sorted I-Words
+ * from memory mapped DSL dictionary.</p>
+ * @author Yury Demidenko
+ **/
+
+#ifndef BS_DEBUGL_DICIWORDSMT
+#define BS_DEBUGL_DICIWORDSMT 30200
+
+#include "BsDicIwrds.h"
+
+//max worker threads:
+#define BSDICIWRDSMT_MAX_THRDS 64
+//min shard size to avoid threads overhead on small dictionaries:
+#define BSDICIWRDSMT_SHRD_MINSZ 1048576L
+
+/**
+ * <p>Evaluate worker threads count for given dictionary
+ * according online processors and shard minimum size.</p>
+ * @param pDslMm - mapped dictionary
+ * @return threads count from 1
+ **/
+int bsdiciwrdsmt_thrds_cnt (BsDicDslMm *pDslMm);
+
+/**
+ * <p>Make AB and sorted i.words without duplicates from mapped DSL dictionary.
+ * Dictionary is split by articles boundaries into shards,
+ * every worker thread makes AB fragment and totals from its shard,
+ * then fragments are merged into given AB, then every worker makes
+ * sorted i.words run from its shard by merged AB, then runs are merged
+ * into result, so it's same as made by bsdicidxab_iter_dslmm_fill
+ * and bsdiciwrds_iter_dslmm, including headwords positions remembered
+ * in given mapped dictionary.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pThrdCnt - worker threads count, 1 or less means in current thread
+ * @param pIdxAb - just created alphabet to fill
+ * @param pAbTots - AB totals to fill
+ * @param pIwrdsRt - pointer to return sorted i.words array
+ * @return BSR_OK_END or errno
+ * @set errno if error.
+ **/
+int bsdiciwrdsmt_make (BsDicDslMm *pDslMm, int pDeBufSz, int pThrdCnt,
+  BsDicIdxAb *pIdxAb, BsDicIdxAbTotals *pAbTots, BsDicIwrds **pIwrdsRt);
+#endif
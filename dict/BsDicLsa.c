@@ -24,7 +24,6 @@ See the LICENSE in the root source folder */
  **/
 
 #include "wchar.h"
-#include "wctype.h"
 #include "stdlib.h"
 #include "string.h"
 #include "time.h"
@@ -34,6 +33,7 @@ See the LICENSE in the root source folder */
 #include "BsError.h"
 #include "BsDicLsa.h"
 #include "BsFioWrap.h"
+#include "BsUcFold.h"
 
 /**
  * <p>Vorbis file read delegator.</p>
@@ -493,13 +493,7 @@ int
     ext = wcsstr (wbuf, L".wav");
     if ( ext != NULL )
                     { ext[0] = 0; }
-    for ( j = 0; ; j++ )
-    {
-      if ( wbuf[j] == 0 )
-                      { break; }
-      if ( iswalpha (wbuf[j]) )
-                      { wbuf[j] = towlower (wbuf[j]); }
-    }
+    bsucfold_wstr (wbuf);
     BS_DO_E_OUTE (bsfread_chars (buf, 4, pDiIxRm->dicFl))
     if ( buf[0] != 0x0 || buf[1] != 0xA || buf[2] != 0x0 || buf[3] != (char) 0xFF )
     {
@@ -772,7 +766,7 @@ void
   BS_IDX_T irtEnd = pDiIx->head->irtSz - BS_IDX_1;
   if ( pDiIx->head->hirt != NULL )
   {
-    BS_DO_E_RET (bsdicidx_find_irtrange (pDiIx->head->hirt, pDiIx->head->hirtSz, iwrd, &irtStart, &irtEnd))
+    BS_DO_E_RET (bsdicidx_find_irtrange ((BsDiIxHeadBs*) pDiIx->head, iwrd, &irtStart, &irtEnd))
   }
   BS_DO_E_RET (BsDiIxT2IdxIrd *warec = bsdiixt2tst_find_irtrd (pDiIx, iwrd, irtStart, irtEnd))
   if ( warec != NULL )
@@ -799,7 +793,7 @@ BsDSoundRd*
   BS_IDX_T irtEnd = pDiIx->head->irtSz - BS_IDX_1;
   if ( pDiIx->head->hirt != NULL )
   {
-    BS_DO_E_RETN (bsdicidx_find_irtrange (pDiIx->head->hirt, pDiIx->head->hirtSz, iwrd, &irtStart, &irtEnd))
+    BS_DO_E_RETN (bsdicidx_find_irtrange ((BsDiIxHeadBs*) pDiIx->head, iwrd, &irtStart, &irtEnd))
   }
   BS_DO_E_RETN (BsDiIxT2IdxIrd *warec = bsdiixt2tst_find_irtrd (pDiIx, iwrd, irtStart, irtEnd))
   BsDSoundRd *obj = NULL;
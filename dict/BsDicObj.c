@@ -34,6 +34,8 @@ BsDiPref*
   BsDiPref *obj = malloc (sizeof (BsDiPref));
   if ( obj != NULL ) {
     obj->isIxRm = pIsIxRm;
+    obj->memBdgtMb = BSDI_MEMBDGT_AUTO;
+    obj->dpVld = false;
   }
   if (obj == NULL) {
     if ( errno == 0 ) { errno = ENOMEM; }
@@ -93,7 +95,7 @@ BsDicObj*
   BsDicObj *obj = malloc (sizeof (BsDicObj));
   if ( obj != NULL )
   {
-    obj->diIx = NULL; obj->pth = NULL; obj->nme = NULL; obj->opSt = NULL; obj->pref = NULL;
+    obj->diIx = NULL; obj->ssn = NULL; obj->pth = NULL; obj->nme = NULL; obj->opSt = NULL; obj->pref = NULL;
     obj->diix_destroy = NULL; obj->diixfind_mtch = NULL; obj->diix_read = NULL;
     obj->pth = bsstring_new (pPth);
     if ( obj->pth == NULL )
@@ -148,6 +150,12 @@ void
   {
     pDiObj->diIx = (BsDiIxBs*) bsdiixlsa_open (pDiObj->pth->val, pDiObj->opSt);
   } else {
+    pDiObj->opSt->isBdgtAuto = pDiObj->pref->memBdgtMb == BSDI_MEMBDGT_AUTO;
+    if ( !pDiObj->opSt->isBdgtAuto )
+          { pDiObj->opSt->memBdgt = (size_t) pDiObj->pref->memBdgtMb * 1048576; }
+    pDiObj->opSt->dpVld = pDiObj->pref->dpVld;
+    //headwords FST is used only by typos finding:
+    pDiObj->opSt->isFst = bsdiixfind_get_fzdst () > 0;
     pDiObj->diIx = (BsDiIxBs*) bsdiixtx_open (pDiObj->pth->val, pDiObj->opSt, pDiObj->pref->isIxRm);
   }
   if ( pDiObj->diIx != NULL )
@@ -164,16 +172,19 @@ void
       }
       pDiObj->diix_read = (BsDiIx_Read*) &bsdiclsa_read;
     } else {
-      pDiObj->diix_destroy = (BsDiIx_Destroy*) &bsdiixtx_destroy;
       if ( pDiObj->pref->isIxRm )
       {
-        pDiObj->diixfind_mtch = (BsDiIxFind_Mtch*) &bsdiixtxrmfind_mtch;
+        pDiObj->diix_destroy = (BsDiIx_Destroy*) &bsdiixtxrm_destroy;
+        pDiObj->diixfind_mtch = (BsDiIxFind_Mtch*) &bsdiixtxrmfind_mtfz;
       } else {
-        pDiObj->diixfind_mtch = (BsDiIxFind_Mtch*) &bsdiixtxfind_mtch;
+        pDiObj->diix_destroy = (BsDiIx_Destroy*) &bsdiixtx_destroy;
+        pDiObj->diixfind_mtch = (BsDiIxFind_Mtch*) &bsdiixtxfind_mtfz;
       }
       if ( pDiObj->diIx->head->frmt == DFRM_DSL )
       {
         pDiObj->diix_read = (BsDiIx_Read*) &s_bsdicdsl_read;
+        //if OOM, then it's NULL and finding is from scratch:
+        pDiObj->ssn = bsdiixssn_new (pDiObj->diIx, pDiObj->pref->isIxRm);
       }
       else {
         BSLOG_LOG (BSLERROR, "Read word's content not yet implemented for format=%d\n",  pDiObj->diIx->head->frmt)
@@ -212,6 +223,7 @@ BsDicObj *bsdicobj_free(BsDicObj *pDiObj) {
     bsstring_free (pDiObj->pth);
     bsdiixost_free (pDiObj->opSt);
     bsdipref_free (pDiObj->pref);
+    bsdiixssn_free (pDiObj->ssn);
     if ( pDiObj->diIx != NULL )
           { pDiObj->diix_destroy (pDiObj->diIx); }
     free (pDiObj);
@@ -13,13 +13,22 @@ See the LICENSE in the root source folder */
 #define BS_DEBUGL_DICOBJ 33000
 
 #include "BsDiIx.h"
+#include "BsDiIxFind.h"
+
+//memory budget is picked by available memory and dictionary size:
+#define BSDI_MEMBDGT_AUTO -1
 
 /**
  * <p>Client's preferences.</p>
  * @member bool isIxRm - client prefers IRT (index records table) in memory (RAM) than in file
+ * @member int memBdgtMb - memory budget in MB to make IDX, 0 means wholly
+ *   in memory, BSDI_MEMBDGT_AUTO (default) - by bsdiixtxex_bdgt
+ * @member bool dpVld - deep validation of saved IDX on opening, default false
  **/
 typedef struct {
   bool isIxRm;
+  int memBdgtMb;
+  bool dpVld;
 } BsDiPref;
 
 /**
@@ -75,6 +84,7 @@ typedef BsHypStrs *BsDiIx_Read (BsDiIxBs *pDiIx, BsDiFdWd *pFdWrd);
  * @member opSt - opening shared data
  * @member pref - user preferences
  * @member diIx - text/audio/both/... dictionary with cached IDX head
+ * @member ssn - as-you-type finding session of text dictionary or NULL
  * @method diix_destroy - destroyer
  * @method diixfind_mtch - finder of matched words
  * @method diix_read - reader of content of found word
@@ -85,6 +95,7 @@ typedef struct {
   BsDiIxOst *opSt;
   BsDiPref *pref;
   BsDiIxBs *diIx;
+  BsDiIxSsn *ssn;
   BsDiIx_Destroy *diix_destroy;
   BsDiIxFind_Mtch *diixfind_mtch;
   BsDiIx_Read *diix_read;
@@ -11,10 +11,13 @@ See the LICENSE in the root source folder */
 #include "stdio.h"
 #include "stdlib.h"
 #include "wchar.h"
-#include "wctype.h"
 #include "string.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
 
+#include "BsError.h"
 #include "BsLog.h"
+#include "BsUcFold.h"
 #include "BsDicWordDsl.h"
 
 /**
@@ -168,7 +171,7 @@ int bsdicworddsl_iter_tus(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicWord_C
         if (wordb[0] != 0) {
           strwchl = wcslen(wordb);
           for (int i = 0; i < strwchl; i++) {
-            if (iswalpha(wordb[i])) {
+            if (bsucfold_isalpha(wordb[i])) {
               bsdword.word = wordb;
               bsdword.offset = poz;
               int csmret = 0;
@@ -193,3 +196,494 @@ int bsdicworddsl_iter_tus(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicWord_C
   }
   return BSR_OK_END;
 }
+
+//Memory mapped byte-level DSL scanner:
+
+#define BSDSLMM_HW_INITSIZE 1000L
+
+/**
+ * <p>Decode UTF-8 char.</p>
+ * @param pSt - start of char
+ * @param pEn - end of content
+ * @param pWch - pointer to return decoded char
+ * @return bytes count or -1 if wrong UTF-8
+ **/
+int
+  bsdicdslmm_utf8_dec (unsigned char *pSt, unsigned char *pEn, BS_WCHAR_T *pWch)
+{
+  int cnt;
+  BS_WCHAR_T wch;
+  if ( pSt[0] < 0x80 )
+  {
+    *pWch = pSt[0];
+    return 1;
+  } else if ( ( pSt[0] & 0xE0 ) == 0xC0 ) {
+    cnt = 2; wch = pSt[0] & 0x1F;
+  } else if ( ( pSt[0] & 0xF0 ) == 0xE0 ) {
+    cnt = 3; wch = pSt[0] & 0x0F;
+  } else if ( ( pSt[0] & 0xF8 ) == 0xF0 ) {
+    cnt = 4; wch = pSt[0] & 0x07;
+  } else {
+    return -1;
+  }
+  if ( pEn - pSt < cnt )
+                { return -1; }
+  for ( int i = 1; i < cnt; i++ )
+  {
+    if ( ( pSt[i] & 0xC0 ) != 0x80 )
+                { return -1; }
+    wch = ( wch << 6 ) | ( pSt[i] & 0x3F );
+  }
+  *pWch = wch;
+  return cnt;
+}
+
+/**
+ * <p>Normalize just read headword, i.e. unescape back-slashes, trim and
+ * replace tabs.</p>
+ * @param pWrd - headword to normalize
+ **/
+static void
+  s_norm_hw (BS_WCHAR_T *pWrd)
+{
+  bsdicword_escape_bslash (pWrd);
+  bsdicword_escape_bounds_spaces (pWrd);
+  bsdicword_replace_tabs (pWrd);
+}
+
+/**
+ * <p>Decode headword's UTF-8 bytes, e.g. DWOLT's ones, and normalize it
+ * as iterator does, so its i.string is the same as iterator's one.</p>
+ * @param pBts - headword's bytes
+ * @param pLen - bytes count
+ * @param pWrd - buffer to return headword, at least pLen + 1 chars
+ * @set errno - EILSEQ
+ **/
+void
+  bsdicdslmm_dec_hw (const char *pBts, BS_SMALL_T pLen, BS_WCHAR_T *pWrd)
+{
+  unsigned char *cur = (unsigned char*) pBts;
+  unsigned char *en = cur + pLen;
+  int cnt = 0;
+  while ( cur < en )
+  {
+    int bts = bsdicdslmm_utf8_dec (cur, en, &pWrd[cnt]);
+    if ( bts < 0 )
+    {
+      pWrd[cnt] = 0;
+      errno = EILSEQ;
+      BSLOG_ERR
+      return;
+    }
+    cur += bts;
+    cnt++;
+  }
+  pWrd[cnt] = 0;
+  s_norm_hw (pWrd);
+}
+
+/**
+ * <p>Read up to given chars count till new line like fwscanf "%999l[^\n]".</p>
+ * @param pDslMm - mapped dictionary
+ * @param pPos - current position to read from and to return the next one
+ * @param pMax - maximum chars to read
+ * @param pWrd - buffer to return decoded chars with terminator or NULL to skip
+ * @param pLen - pointer to return bytes count of chars before the first 0 or NULL
+ * @return read chars count
+ * @set errno - EILSEQ
+ **/
+static int
+  s_read_chrs (BsDicDslMm *pDslMm, BS_FOFST_T *pPos, int pMax,
+               BS_WCHAR_T *pWrd, BS_SMALL_T *pLen)
+{
+  unsigned char *st = (unsigned char*) pDslMm->dt + *pPos;
+  unsigned char *en = (unsigned char*) pDslMm->dt + pDslMm->sz;
+  unsigned char *cur = st;
+  BS_WCHAR_T wch;
+  bool isZr = false;
+  int cnt = 0;
+  if ( pLen != NULL )
+                { *pLen = 0; }
+  while ( cnt < pMax && cur < en && *cur != '\n' )
+  {
+    int bts = bsdicdslmm_utf8_dec (cur, en, &wch);
+    if ( bts < 0 )
+    {
+      errno = EILSEQ;
+      BSLOG_LOG (BSLERROR, "Wrong UTF-8 at offset="BS_FOFST_FMT"\n", (BS_FOFST_T) ( (char*) cur - pDslMm->dt ))
+      return cnt;
+    }
+    if ( wch == 0 )
+                { isZr = true; }
+    if ( pWrd != NULL )
+                { pWrd[cnt] = wch; }
+    cur += bts;
+    if ( pLen != NULL && !isZr )
+                { *pLen = cur - st; }
+    cnt++;
+  }
+  if ( pWrd != NULL )
+                { pWrd[cnt] = 0; }
+  *pPos += cur - st;
+  return cnt;
+}
+
+/**
+ * <p>Skip chars from given set.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pPos - current position
+ * @param pChrs - chars to skip
+ **/
+static void
+  s_skip_chrs (BsDicDslMm *pDslMm, BS_FOFST_T *pPos, char *pChrs)
+{
+  while ( *pPos < pDslMm->sz && pDslMm->dt[*pPos] != 0
+          && strchr (pChrs, pDslMm->dt[*pPos]) != NULL )
+                { (*pPos)++; }
+}
+
+/**
+ * <p>Skip head, i.e. lines started with [BOM]#.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pPos - current position and to return the next one
+ * @return 0 or errno
+ * @set errno if error.
+ **/
+static int
+  s_skip_head (BsDicDslMm *pDslMm, int pDeBufSz, BS_FOFST_T *pPos)
+{
+  while ( *pPos < pDslMm->sz )
+  {
+    BS_FOFST_T cst = *pPos;
+    while ( *pPos < pDslMm->sz )
+    {
+      if ( pDslMm->dt[*pPos] == '#' )
+      {
+        (*pPos)++;
+      } else if ( *pPos + 2 < pDslMm->sz && (unsigned char) pDslMm->dt[*pPos] == 0xEF
+          && (unsigned char) pDslMm->dt[*pPos + 1] == 0xBB
+            && (unsigned char) pDslMm->dt[*pPos + 2] == 0xBF ) {
+        *pPos += 3;
+      } else {
+        break;
+      }
+    }
+    if ( *pPos == cst || *pPos == pDslMm->sz || pDslMm->dt[*pPos] == '\n' )
+                { break; }
+    BS_DO_E_RETE (s_read_chrs (pDslMm, pPos, pDeBufSz - 1, NULL, NULL))
+    s_skip_chrs (pDslMm, pPos, "\n");
+  }
+  return 0;
+}
+
+/**
+ * <p>Read headword from given position, fix it and consume if it's a word.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pPos - headword position and to return the next one
+ * @param pWrd - buffer with pDeBufSz size
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pWd_Csm - dic.word consumer
+ * @param pInst - instrument to consume d.word
+ * @param pIsRmb - whether to remember consumed headword
+ * @return 0 to continue iteration, otherwise consumer's return value
+ * @set errno if error.
+ **/
+static int
+  s_consume_hw (BsDicDslMm *pDslMm, BS_FOFST_T *pPos, BS_WCHAR_T *pWrd,
+                int pDeBufSz, BsDicWord_Consume_Tus *pWd_Csm, void *pInst, bool pIsRmb)
+{
+  BsDicWord dwrd;
+  dwrd.offset = *pPos;
+  BS_DO_E_RETE (s_read_chrs (pDslMm, pPos, pDeBufSz - 1, pWrd, &dwrd.lenChrs))
+  s_norm_hw (pWrd);
+  for ( int i = 0; pWrd[i] != 0; i++ )
+  {
+    if ( bsucfold_isalpha (pWrd[i]) )
+    {
+      if ( pIsRmb )
+      {
+        if ( pDslMm->hwSz == pDslMm->hwBsz )
+        {
+          BS_IDX_T nbsz = pDslMm->hwBsz * BS_IDX_2;
+          BS_FOFST_T *ofsts = realloc (pDslMm->hwOfsts, nbsz * BS_FOFST_LEN);
+          if ( ofsts == NULL )
+          {
+            if ( errno == 0 ) { errno = ENOMEM; }
+            BSLOG_ERR
+            return errno;
+          }
+          pDslMm->hwOfsts = ofsts;
+          BS_SMALL_T *lens = realloc (pDslMm->hwLens, nbsz * sizeof (BS_SMALL_T));
+          if ( lens == NULL )
+          {
+            if ( errno == 0 ) { errno = ENOMEM; }
+            BSLOG_ERR
+            return errno;
+          }
+          pDslMm->hwLens = lens;
+          pDslMm->hwBsz = nbsz;
+        }
+        pDslMm->hwOfsts[pDslMm->hwSz] = dwrd.offset;
+        pDslMm->hwLens[pDslMm->hwSz] = dwrd.lenChrs;
+        pDslMm->hwSz++;
+      }
+      dwrd.word = pWrd;
+      BS_DO_E_RETE (int csmret = pWd_Csm (&dwrd, pInst))
+      return csmret;
+    }
+  }
+  return 0;
+}
+
+/**
+ * <p>Constructor. It maps whole opened dictionary into memory read-only.</p>
+ * @param pDicFl - opened dictionary file
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicDslMm*
+  bsdicdslmm_new (FILE *pDicFl)
+{
+  struct stat st;
+  int fd = fileno (pDicFl);
+  BS_IF_EN_RETN (fd == -1 || fstat (fd, &st) != 0, BSE_READ_FILE)
+  BsDicDslMm *obj = malloc (sizeof (BsDicDslMm));
+  if ( obj != NULL )
+  {
+    obj->dt = NULL; obj->sz = st.st_size; obj->hwSz = BS_IDX_0;
+    obj->stt = BS_FOFST_0; obj->end = obj->sz; obj->isShrd = false;
+    obj->hwBsz = BSDSLMM_HW_INITSIZE;
+    obj->hwOfsts = malloc (obj->hwBsz * BS_FOFST_LEN);
+    obj->hwLens = malloc (obj->hwBsz * sizeof (BS_SMALL_T));
+    if ( obj->hwOfsts == NULL || obj->hwLens == NULL )
+    {
+      obj = bsdicdslmm_free (obj);
+    } else if ( obj->sz > BS_FOFST_0 ) {
+      void *dt = mmap (NULL, obj->sz, PROT_READ, MAP_PRIVATE, fd, 0);
+      if ( dt == MAP_FAILED )
+      {
+        if ( errno == 0 ) { errno = BSE_READ_FILE; }
+        BSLOG_LOG (BSLERROR, "Can't map file size="BS_FOFST_FMT"\n", obj->sz)
+        bsdicdslmm_free (obj);
+        return NULL;
+      }
+      obj->dt = dt;
+      madvise (obj->dt, obj->sz, MADV_SEQUENTIAL);
+    }
+  }
+  if ( obj == NULL )
+  {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+  }
+  return obj;
+}
+
+/**
+ * <p>Shard constructor. It makes view over given articles range
+ * of mapped dictionary without copying content.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pStt - range start, it must be 0 or article start
+ * @param pEnd - range end, it must be article start or content size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicDslMm*
+  bsdicdslmm_new_shrd (BsDicDslMm *pDslMm, BS_FOFST_T pStt, BS_FOFST_T pEnd)
+{
+  BS_IF_EN_RETN (pStt < BS_FOFST_0 || pStt > pEnd || pEnd > pDslMm->sz, BSE_WRONG_PARAMS)
+  BsDicDslMm *obj = malloc (sizeof (BsDicDslMm));
+  if ( obj != NULL )
+  {
+    obj->dt = pDslMm->dt; obj->sz = pDslMm->sz; obj->hwSz = BS_IDX_0;
+    obj->stt = pStt; obj->end = pEnd; obj->isShrd = true;
+    obj->hwBsz = BSDSLMM_HW_INITSIZE;
+    obj->hwOfsts = malloc (obj->hwBsz * BS_FOFST_LEN);
+    obj->hwLens = malloc (obj->hwBsz * sizeof (BS_SMALL_T));
+    if ( obj->hwOfsts == NULL || obj->hwLens == NULL )
+                { obj = bsdicdslmm_free (obj); }
+  }
+  if ( obj == NULL )
+  {
+    if ( errno == 0 ) { errno = ENOMEM; }
+    BSLOG_ERR
+  }
+  return obj;
+}
+
+/**
+ * <p>Find article (headword line) start at or after given position.
+ * Head (comments) is never split.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pPos - position to start search from
+ * @return article start or content size if there is no more articles
+ * @set errno if error.
+ **/
+BS_FOFST_T
+  bsdicdslmm_find_art (BsDicDslMm *pDslMm, int pDeBufSz, BS_FOFST_T pPos)
+{
+  BS_FOFST_T pos = BS_FOFST_0;
+  char *en;
+  errno = 0;
+  if ( s_skip_head (pDslMm, pDeBufSz, &pos) != 0 )
+  {
+    BSLOG_ERR
+    return pDslMm->sz;
+  }
+  if ( pPos <= pos )
+                { return pos; }
+  pos = pPos;
+  if ( pos < pDslMm->sz && pDslMm->dt[pos - 1] != '\n' )
+  { //inside line:
+    en = memchr (pDslMm->dt + pos, '\n', pDslMm->sz - pos);
+    if ( en == NULL )
+                { return pDslMm->sz; }
+    pos = en - pDslMm->dt + 1;
+  }
+  while ( pos < pDslMm->sz && ( pDslMm->dt[pos] == '\t'
+          || pDslMm->dt[pos] == ' ' || pDslMm->dt[pos] == '\n' ) )
+  { //word's content or empty line:
+    en = memchr (pDslMm->dt + pos, '\n', pDslMm->sz - pos);
+    if ( en == NULL )
+                { return pDslMm->sz; }
+    pos = en - pDslMm->dt + 1;
+  }
+  return pos;
+}
+
+/**
+ * <p>Append headwords positions, e.g. remembered by shard,
+ * so they can be iterated by bsdicdslmm_iter_hw.</p>
+ * @param pDslMm - mapped dictionary or shard
+ * @param pOfsts - headwords offsets
+ * @param pLens - headwords lengths
+ * @param pCnt - headwords total
+ * @set errno ENOMEM if buffers can't be grown, remembered headwords stay intact.
+ **/
+void
+  bsdicdslmm_add_hws (BsDicDslMm *pDslMm, BS_FOFST_T *pOfsts,
+                      BS_SMALL_T *pLens, BS_IDX_T pCnt)
+{
+  BS_IDX_T nsz = pDslMm->hwSz + pCnt;
+  if ( nsz > pDslMm->hwBsz )
+  {
+    BS_IDX_T nbsz = pDslMm->hwBsz * 2;
+    if ( nbsz < nsz )
+                { nbsz = nsz; }
+    BS_FOFST_T *ofsts = realloc (pDslMm->hwOfsts, nbsz * BS_FOFST_LEN);
+    if ( ofsts == NULL )
+    {
+      errno = ENOMEM;
+      BSLOG_ERR
+      return;
+    }
+    pDslMm->hwOfsts = ofsts;
+    BS_SMALL_T *lens = realloc (pDslMm->hwLens, nbsz * sizeof (BS_SMALL_T));
+    if ( lens == NULL )
+    {
+      errno = ENOMEM;
+      BSLOG_ERR
+      return;
+    }
+    pDslMm->hwLens = lens;
+    pDslMm->hwBsz = nbsz;
+  }
+  memcpy (pDslMm->hwOfsts + pDslMm->hwSz, pOfsts, pCnt * BS_FOFST_LEN);
+  memcpy (pDslMm->hwLens + pDslMm->hwSz, pLens, pCnt * sizeof (BS_SMALL_T));
+  pDslMm->hwSz = nsz;
+}
+
+/**
+ * <p>Destructor. It unmaps content if it's not shard, file stays opened.</p>
+ * @param pDslMm - mapped dictionary or NULL
+ * @return always NULL
+ **/
+BsDicDslMm*
+  bsdicdslmm_free (BsDicDslMm *pDslMm)
+{
+  if ( pDslMm != NULL )
+  {
+    if ( pDslMm->dt != NULL && !pDslMm->isShrd )
+                { munmap (pDslMm->dt, pDslMm->sz); }
+    if ( pDslMm->hwOfsts != NULL )
+                { free (pDslMm->hwOfsts); }
+    if ( pDslMm->hwLens != NULL )
+                { free (pDslMm->hwLens); }
+    free (pDslMm);
+  }
+  return NULL;
+}
+
+/**
+ * <p>
+ * Single pass byte-level iterator trough whole mapped dictionary, just read dic.word
+ * will be consumed by given consumer, if consumer returned non-zero, then iteration will stop.
+ * It yields same words, offsets and lengths as bsdicworddsl_iter_tus,
+ * and it remembers consumed headwords positions for bsdicdslmm_iter_hw.
+ * </p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pWd_Csm - dic.word consumer
+ * @param pInst - instrument to consume d.word
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error, e.g. EILSEQ on wrong UTF-8 headword.
+ **/
+int
+  bsdicdslmm_iter (BsDicDslMm *pDslMm, int pDeBufSz,
+                   BsDicWord_Consume_Tus *pWd_Csm, void *pInst)
+{
+  BS_WCHAR_T wordb[pDeBufSz];
+  BS_FOFST_T pos = pDslMm->stt;
+  char *en;
+  pDslMm->hwSz = BS_IDX_0;
+  if ( pos == BS_FOFST_0 )
+                { BS_DO_E_RETE (s_skip_head (pDslMm, pDeBufSz, &pos)) }
+  while ( pos < pDslMm->end )
+  {
+    if ( pDslMm->dt[pos] == '\t' || pDslMm->dt[pos] == ' ' )
+    { //word's content:
+      en = memchr (pDslMm->dt + pos, '\n', pDslMm->sz - pos);
+      if ( en == NULL )
+                { break; }
+      pos = en - pDslMm->dt;
+    } else if ( pDslMm->dt[pos] != '\n' ) {
+      BS_DO_E_RETE (int csmret = s_consume_hw (pDslMm, &pos, wordb, pDeBufSz, pWd_Csm, pInst, true))
+      if ( csmret != 0 )
+                { return csmret; }
+    }
+    s_skip_chrs (pDslMm, &pos, "\n");
+  }
+  if ( bslog_is_debug (BS_DEBUGL_DICWORDDSL) )
+    { BSLOG_LOG (BSLDEBUG, "Scanned range="BS_FOFST_FMT"-"BS_FOFST_FMT", headwords="BS_IDX_FMT"\n", pDslMm->stt, pDslMm->end, pDslMm->hwSz) }
+  return BSR_OK_END;
+}
+
+/**
+ * <p>
+ * Iterator trough headwords remembered by bsdicdslmm_iter,
+ * it reads only headwords lines without rescanning articles.
+ * </p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pWd_Csm - dic.word consumer
+ * @param pInst - instrument to consume d.word
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error.
+ **/
+int
+  bsdicdslmm_iter_hw (BsDicDslMm *pDslMm, int pDeBufSz,
+                      BsDicWord_Consume_Tus *pWd_Csm, void *pInst)
+{
+  BS_WCHAR_T wordb[pDeBufSz];
+  BS_FOFST_T pos;
+  for ( BS_IDX_T l = BS_IDX_0; l < pDslMm->hwSz; l++ )
+  {
+    pos = pDslMm->hwOfsts[l];
+    BS_DO_E_RETE (int csmret = s_consume_hw (pDslMm, &pos, wordb, pDeBufSz, pWd_Csm, pInst, false))
+    if ( csmret != 0 )
+                { return csmret; }
+  }
+  return BSR_OK_END;
+}
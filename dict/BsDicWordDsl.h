@@ -11,6 +11,8 @@ See the LICENSE in the root source folder */
 #ifndef BS_DEBUGL_DICWORDDSL
 #define BS_DEBUGL_DICWORDDSL 20100
 
+#include "stdbool.h"
+
 #include "BsDicWord.h"
 
 /**
@@ -32,4 +34,135 @@ void bsdicword_escape_bslash(BS_WCHAR_T *pWrd);
   * @set errno if error.
  **/
 int bsdicworddsl_iter_tus(FILE *pDicFl, int p_dic_entry_buffer_size, BsDicWord_Consume_Tus *p_consume, void *p_consinst);
+
+/**
+ * <p>Memory mapped DSL dictionary. It's scanned once byte by byte (UTF-8)
+ * with remembering headwords positions, so the next consumers
+ * can iterate over headwords without rescanning whole content.
+ * Shard is a view over articles range of parent's mapped content,
+ * so several shards can be scanned simultaneously in different threads.</p>
+ * @member char *dt - mapped content or NULL for empty file
+ * @member BS_FOFST_T sz - content size
+ * @member BS_FOFST_T stt - scan start, 0 means from head (comments)
+ * @member BS_FOFST_T end - scan end, i.e. the next article start or sz
+ * @member bool isShrd - whether it's shard that doesn't own content
+ * @member BS_IDX_T hwSz - remembered headwords total
+ * @member BS_IDX_T hwBsz - headwords buffers size
+ * @member BS_FOFST_T *hwOfsts - headwords offsets
+ * @member BS_SMALL_T *hwLens - headwords lengths in bytes (chars) without terminator
+ **/
+typedef struct {
+  char *dt;
+  BS_FOFST_T sz;
+  BS_FOFST_T stt;
+  BS_FOFST_T end;
+  bool isShrd;
+  BS_IDX_T hwSz;
+  BS_IDX_T hwBsz;
+  BS_FOFST_T *hwOfsts;
+  BS_SMALL_T *hwLens;
+} BsDicDslMm;
+
+/**
+ * <p>Decode UTF-8 char.</p>
+ * @param pSt - start of char
+ * @param pEn - end of content
+ * @param pWch - pointer to return decoded char
+ * @return bytes count or -1 if wrong UTF-8
+ **/
+int bsdicdslmm_utf8_dec (unsigned char *pSt, unsigned char *pEn,
+                         BS_WCHAR_T *pWch);
+
+/**
+ * <p>Decode headword's UTF-8 bytes, e.g. DWOLT's ones, and normalize it
+ * as iterator does, so its i.string is the same as iterator's one.</p>
+ * @param pBts - headword's bytes
+ * @param pLen - bytes count
+ * @param pWrd - buffer to return headword, at least pLen + 1 chars
+ * @set errno - EILSEQ
+ **/
+void bsdicdslmm_dec_hw (const char *pBts, BS_SMALL_T pLen, BS_WCHAR_T *pWrd);
+
+/**
+ * <p>Constructor. It maps whole opened dictionary into memory read-only.</p>
+ * @param pDicFl - opened dictionary file
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicDslMm *bsdicdslmm_new (FILE *pDicFl);
+
+/**
+ * <p>Shard constructor. It makes view over given articles range
+ * of mapped dictionary without copying content.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pStt - range start, it must be 0 or article start
+ * @param pEnd - range end, it must be article start or content size
+ * @return object or NULL when error
+ * @set errno if error.
+ **/
+BsDicDslMm *bsdicdslmm_new_shrd (BsDicDslMm *pDslMm, BS_FOFST_T pStt,
+                                 BS_FOFST_T pEnd);
+
+/**
+ * <p>Find article (headword line) start at or after given position.
+ * Head (comments) is never split.</p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pPos - position to start search from
+ * @return article start or content size if there is no more articles
+ * @set errno if error.
+ **/
+BS_FOFST_T bsdicdslmm_find_art (BsDicDslMm *pDslMm, int pDeBufSz,
+                                BS_FOFST_T pPos);
+
+/**
+ * <p>Append headwords positions, e.g. remembered by shard,
+ * so they can be iterated by bsdicdslmm_iter_hw.</p>
+ * @param pDslMm - mapped dictionary or shard
+ * @param pOfsts - headwords offsets
+ * @param pLens - headwords lengths
+ * @param pCnt - headwords total
+ * @set errno ENOMEM if buffers can't be grown, remembered headwords stay intact.
+ **/
+void bsdicdslmm_add_hws (BsDicDslMm *pDslMm, BS_FOFST_T *pOfsts,
+                         BS_SMALL_T *pLens, BS_IDX_T pCnt);
+
+/**
+ * <p>Destructor. It unmaps content if it's not shard, file stays opened.</p>
+ * @param pDslMm - mapped dictionary or NULL
+ * @return always NULL
+ **/
+BsDicDslMm *bsdicdslmm_free (BsDicDslMm *pDslMm);
+
+/**
+ * <p>
+ * Single pass byte-level iterator trough whole mapped dictionary or shard, just read dic.word
+ * will be consumed by given consumer, if consumer returned non-zero, then iteration will stop.
+ * It yields same words, offsets and lengths as bsdicworddsl_iter_tus,
+ * and it remembers consumed headwords positions for bsdicdslmm_iter_hw.
+ * </p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pWd_Csm - dic.word consumer
+ * @param pInst - instrument to consume d.word
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error, e.g. EILSEQ on wrong UTF-8 headword.
+ **/
+int bsdicdslmm_iter (BsDicDslMm *pDslMm, int pDeBufSz,
+                     BsDicWord_Consume_Tus *pWd_Csm, void *pInst);
+
+/**
+ * <p>
+ * Iterator trough headwords remembered by bsdicdslmm_iter,
+ * it reads only headwords lines without rescanning articles.
+ * </p>
+ * @param pDslMm - mapped dictionary
+ * @param pDeBufSz - client expected/predicted this max entry size in dictionary
+ * @param pWd_Csm - dic.word consumer
+ * @param pInst - instrument to consume d.word
+ * @return BSR_OK_END or consumer's last return value, e.g. BSR_OK_ENOUGH or errno
+ * @set errno if error.
+ **/
+int bsdicdslmm_iter_hw (BsDicDslMm *pDslMm, int pDeBufSz,
+                        BsDicWord_Consume_Tus *pWd_Csm, void *pInst);
 #endif
@@ -10,7 +10,6 @@ See the LICENSE in the root source folder */
 #include "time.h"
 #include "locale.h"
 #include "string.h"
-#include "wctype.h"
 #include "stdlib.h"
 
 #include "gtk/gtk.h"
@@ -18,6 +17,7 @@ See the LICENSE in the root source folder */
 #include "BsI18N.h"
 #include "BsFatalLog.h"
 #include "BsError.h"
+#include "BsUcFold.h"
 #include "BsDict.h"
 #include "BsDictSettings.h"
 #include "BsDicHist.h"
@@ -320,7 +320,12 @@ static gboolean
     errno = 0;
     if ( wdics->vals[i]->opSt->stt == EBSDS_OPENED )
     {
-      BS_DO_E_CONT (wdics->vals[i]->diixfind_mtch (wdics->vals[i]->diIx, sDicsWrds, sLastCstr))
+      if ( wdics->vals[i]->ssn != NULL )
+      { //reuse the previous keystroke's finding:
+        BS_DO_E_CONT (bsdiixssn_find (wdics->vals[i]->ssn, sDicsWrds, sLastCstr))
+      } else {
+        BS_DO_E_CONT (wdics->vals[i]->diixfind_mtch (wdics->vals[i]->diIx, sDicsWrds, sLastCstr))
+      }
     }
   }
   for ( int i = 0; i < sDicsWrds->size; i++ )
@@ -406,13 +411,7 @@ static gboolean
     BSLOG_LOG (BSLWARN, "mbstowcs fail on %s, rz=%d\n", cstr, i)
     strcpy (cstrl, cstr);
   } else {
-    for ( i = 0; ; i++ )
-    {
-      if ( wstr[i] == 0 )
-                      { break; }
-      if ( iswalpha (wstr[i]) )
-                      { wstr[i] = towlower (wstr[i]); }
-    }
+    bsucfold_wstr (wstr);
     i = wcstombs (cstrl, wstr, len + 2);
     if ( i <= 0 || errno != 0 )
     {
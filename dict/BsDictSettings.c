@@ -35,6 +35,10 @@ static int sMenuVals[] = { EADD, ESAVE, EDELETE, EONOFF };
 
 static bool sIsIxRm = false;
 
+static int sMemBdgtMb = BSDI_MEMBDGT_AUTO;
+
+static bool sDpVld = false;
+
   //ID for progress thread:
 static int sTimer = -1;
 
@@ -54,7 +58,8 @@ static GMutex sMutex;
 
 #define BS_THREAD_UNLOCK g_mutex_unlock (&sMutex);
 
-//Dic opener args:
+//Dic opener args, pending dics range is opener's own tasks queue,
+//opener takes its tasks from range start, idle one steals from range end:
 typedef struct {
   BS_IDX_T ixSt;
   BS_IDX_T ixEn;
@@ -63,8 +68,10 @@ typedef struct {
 
 OpenArg sOargAdd = { .ixSt = BS_IDX_NULL, .ixEn = BS_IDX_NULL, .thrd = NULL };
 
-OpenArg sOargs[2] = { { .ixSt = BS_IDX_NULL, .ixEn = BS_IDX_NULL, .thrd = NULL },
-                      { .ixSt = BS_IDX_NULL, .ixEn = BS_IDX_NULL, .thrd = NULL } };
+  //openers pool:
+OpenArg sOargs[BSDICSET_MAX_OPNRS];
+
+static int sOargsCnt = 0;
 
 /* Generic info dialog */ //TODO 1 into lib
 static void
@@ -95,8 +102,37 @@ static gboolean
 }
 
 /**
- * <p>Open dic in dics.</p>
- * @param pArg index start-end
+ * <p>Take next dic to open, i.e. own pending one, otherwise
+ * steal the last pending one from the most loaded opener.
+ * It's invoked under lock.</p>
+ * @param pArg opener
+ * @return dic index or BS_IDX_NULL if there is no pending dics
+ **/
+static BS_IDX_T
+  s_take_dic (OpenArg *pArg)
+{
+  if ( pArg->ixSt != BS_IDX_NULL && pArg->ixSt <= pArg->ixEn )
+  {
+    pArg->ixSt++;
+    return pArg->ixSt - BS_IDX_1;
+  }
+  OpenArg *vctm = NULL;
+  for ( int i = 0; i < sOargsCnt; i++ )
+  {
+    if ( sOargs[i].ixSt != BS_IDX_NULL && sOargs[i].ixSt <= sOargs[i].ixEn
+          && ( vctm == NULL
+            || sOargs[i].ixEn - sOargs[i].ixSt > vctm->ixEn - vctm->ixSt ) )
+                { vctm = &sOargs[i]; }
+  }
+  if ( vctm == NULL )
+                { return BS_IDX_NULL; }
+  vctm->ixEn--;
+  return vctm->ixEn + BS_IDX_1;
+}
+
+/**
+ * <p>Open dics from opener's range, then steal pending ones.</p>
+ * @param pArg opener
  * @set errno if error.
  **/
 static void
@@ -105,18 +141,26 @@ static void
 
   BsDicObj *wdici; //cached dic for unlocked opening
 
+  BS_IDX_T l;
+
   bool isDbg = bslog_is_debug (BS_DEBUGL_DICTSETTINGS + 70);
   
   if ( isDbg )
       { BSLOG_LOG (BSLDEBUG, "Try to open dics OARG#%p from "BS_IDX_FMT" to "BS_IDX_FMT"\n", pArg, pArg->ixSt, pArg->ixEn) }
 
-  for ( BS_IDX_T l = pArg->ixSt; l <= pArg->ixEn; l++ )
+  while ( true )
   {
     wdici = NULL;
     BS_THREAD_LOCK
-                // return if no dic:
-      if ( sDics == NULL || !( l >= BS_IDX_0 && l < sDics->size ) )
-                              { return; }
+                // return if no more dics:
+      l = BS_IDX_NULL;
+      if ( sDics != NULL )
+                { l = s_take_dic (pArg); }
+      if ( l == BS_IDX_NULL || l >= sDics->size )
+      {
+        BS_THREAD_UNLOCK
+        return;
+      }
 
       if ( isDbg )
           { BSLOG_LOG (BSLDEBUG, "Dic %s, state init =%d\n", sDics->vals[l]->nme->val, sDics->vals[l]->opSt->stt) }
@@ -137,6 +181,7 @@ static void
 
           if ( bsdicobjs_find_ref (sDics, wdici) == BS_IDX_NULL )
           {
+            wdici->ssn = bsdiixssn_free (wdici->ssn);
             wdici->diIx = wdici->diix_destroy (wdici->diIx);
           }
 
@@ -188,6 +233,9 @@ static void
     {
       int disbl;
       fprintf (flConf, BSDS_ISIXRM"%d\n", sIsIxRm);
+      fprintf (flConf, BSDS_MEMBDGT"%d\n", sMemBdgtMb);
+      fprintf (flConf, BSDS_DPVLD"%d\n", sDpVld);
+      fprintf (flConf, BSDS_FZDST"%d\n", bsdiixfind_get_fzdst ());
       for ( int i = 0; i < sDics->size; i++ )
       {
         fprintf (flConf, BSDS_PATH"%s\n", sDics->vals[i]->pth->val);
@@ -241,6 +289,8 @@ static void
     if ( ext != NULL )
     {
       BS_DO_CEE_OUT (dic = bsdicobj_new (g_file_get_path (file), sIsIxRm))
+      dic->pref->memBdgtMb = sMemBdgtMb;
+      dic->pref->dpVld = sDpVld;
       
       BS_THREAD_LOCK
         if ( sDics == NULL )
@@ -476,6 +526,37 @@ static gboolean
 
 //Public lib:
 
+/**
+ * <p>Read optional global settings, they are before dictionaries ones,
+ * so settings file of previous version is read as well.</p>
+ * @param pFlConf - settings file at line after BSDS_ISIXRM one
+ * @set errno if error.
+ **/
+static void
+  s_load_glbs (FILE *pFlConf)
+{
+  char ln[64];
+  long pos = ftell (pFlConf);
+  BS_IF_EN_RET (pos < 0, BSE_READ_FILE)
+  while ( fgets (ln, sizeof (ln), pFlConf) != NULL )
+  {
+    if ( strncmp (ln, BSDS_MEMBDGT, strlen (BSDS_MEMBDGT)) == 0 )
+    {
+      BS_IF_EN_RET (sscanf (ln + strlen (BSDS_MEMBDGT), "%d", &sMemBdgtMb) != 1
+                      || sMemBdgtMb < BSDI_MEMBDGT_AUTO, BSE_READ_FILE)
+    } else if ( strncmp (ln, BSDS_DPVLD, strlen (BSDS_DPVLD)) == 0 ) {
+      sDpVld = ln[strlen (BSDS_DPVLD)] == '1';
+    } else if ( strncmp (ln, BSDS_FZDST, strlen (BSDS_FZDST)) == 0 ) {
+      BS_DO_E_RET (bsdiixfind_set_fzdst (atoi (ln + strlen (BSDS_FZDST))))
+    } else { //dictionary's setting:
+      break;
+    }
+    pos = ftell (pFlConf);
+    BS_IF_EN_RET (pos < 0, BSE_READ_FILE)
+  }
+  BS_IF_EN_RET (fseek (pFlConf, pos, SEEK_SET) != 0, BSE_READ_FILE)
+}
+
 /**
  * <p>Lazy get w.dictionaries.</p>
  * @set errno if error.
@@ -508,6 +589,8 @@ void
   
   fscanf (flConf, "%*[\n]");
 
+  BS_DO_CEE_OUT (s_load_glbs (flConf))
+
   while ( !feof (flConf) && !ferror (flConf) )
   {
     bsstrbuf_clear (sStrBuf);
@@ -548,6 +631,8 @@ void
     }
 
     BS_DO_CEE_OUT (BsDicObj *dic = bsdicobj_new (sStrBuf->vals, isIxRm))
+    dic->pref->memBdgtMb = sMemBdgtMb;
+    dic->pref->dpVld = sDpVld;
     if ( dsbl )
             { dic->opSt->stt = EBSDS_DISABLED; }
 
@@ -608,30 +693,33 @@ BsDicObjs*
 
   if ( sDics != NULL && sDics->size > 0 )
   {
-            //2 usual new thread[s] loading:
-    int thrdCnt;
+            //2 openers pool loading, dics are split into equal ranges:
+    int thrdCnt = g_get_num_processors ();
 
-    if ( sDics->size > BS_IDX_1 )
-    {
-      thrdCnt = 2;
-      BS_IDX_T idxMiddle = sDics->size / BS_IDX_2;
-      sOargs[0].ixSt = BS_IDX_0;
-      sOargs[0].ixEn = idxMiddle - BS_IDX_1;
-      sOargs[0].thrd = NULL;
-      sOargs[1].thrd = NULL;
-      sOargs[1].ixSt = idxMiddle;
-      sOargs[1].ixEn = sDics->size - BS_IDX_1;
-    } else {
-      thrdCnt = 1;
-      sOargs[0].thrd = NULL;
-      sOargs[0].ixSt = BS_IDX_0;
-      sOargs[0].ixEn = sDics->size - BS_IDX_1;
-    }
-              //launching thread[s]:
-    for ( int i = 0; i < thrdCnt; i++ )
-    { //direct pthreads do not receive properly arguments!
-      sOargs[i].thrd = g_thread_new (NULL, s_open_dic_thrd, &sOargs[i]);
-    }
+    if ( thrdCnt > BSDICSET_MAX_OPNRS )
+                { thrdCnt = BSDICSET_MAX_OPNRS; }
+    if ( thrdCnt > sDics->size )
+                { thrdCnt = sDics->size; }
+    if ( thrdCnt < 1 )
+                { thrdCnt = 1; }
+
+    BS_THREAD_LOCK
+      for ( int i = 0; i < thrdCnt; i++ )
+      {
+        sOargs[i].thrd = NULL;
+        sOargs[i].ixSt = sDics->size * i / thrdCnt;
+        sOargs[i].ixEn = sDics->size * ( i + 1 ) / thrdCnt - BS_IDX_1;
+      }
+      sOargsCnt = thrdCnt;
+              //launching threads:
+      for ( int i = 0; i < thrdCnt; i++ )
+      { //direct pthreads do not receive properly arguments!
+        sOargs[i].thrd = g_thread_new (NULL, s_open_dic_thrd, &sOargs[i]);
+      }
+    BS_THREAD_UNLOCK
+
+    if ( isDbg )
+        { BSLOG_LOG (BSLINFO, "Launched dics openers=%d\n", thrdCnt); }
   }
   return sDics;
 }
@@ -644,10 +732,12 @@ BsDicObjs*
 bool
   bsdicsettings_is_busy ()
 {
-  if ( sOargAdd.thrd != NULL || sOargs[0].thrd != NULL
-        || sOargs[1].thrd != NULL )
+  if ( sOargAdd.thrd != NULL )
+                { return true; }
+  for ( int i = 0; i < sOargsCnt; i++ )
   {
-    return true;
+    if ( sOargs[i].thrd != NULL )
+                { return true; }
   }
   return false;
 }
@@ -666,10 +756,11 @@ void
   }
   if (sOargAdd.thrd != NULL)
       { g_thread_join (sOargAdd.thrd); }
-  if (sOargs[0].thrd != NULL)
-      { g_thread_join (sOargs[0].thrd); }
-  if (sOargs[1].thrd != NULL)
-      { g_thread_join (sOargs[1].thrd); }
+  for ( int i = 0; i < sOargsCnt; i++ )
+  {
+    if (sOargs[i].thrd != NULL)
+        { g_thread_join (sOargs[i].thrd); }
+  }
 
   s_free_here ();
   
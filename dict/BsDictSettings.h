@@ -15,10 +15,23 @@ See the LICENSE in the root source folder */
 
 #define BSDICSET_PATH "/.bsdict.conf"
 
+//max dictionaries openers threads, actual count is processors count:
+#define BSDICSET_MAX_OPNRS 16
+
 #define BSDS_DISABLED "#Disabled="
 
 #define BSDS_ISIXRM "#IsIxRm="
 
+//optional, memory budget in MB to make IDX, -1 means auto:
+#define BSDS_MEMBDGT "#MemBdgtMb="
+
+//optional, 1 - deep validation of saved IDX on opening:
+#define BSDS_DPVLD "#DpVld="
+
+//optional, max distance of typos finding, 0 - disabled, then IDX is made
+//without headwords FST:
+#define BSDS_FZDST "#FzDst="
+
 #define BSDS_NAME "#Name="
 
 #define BSDS_PATH "#Path="
@@ -12,10 +12,13 @@ See the LICENSE in the root source folder */
 #include "string.h"
 #include "stdlib.h"
 #include "locale.h"
+#include "wchar.h"
 
 #include "BsFatalLog.h"
 #include "BsError.h"
 #include "BsStrings.h"
+#include "BsFioWrap.h"
+#include "BsDiIxMm.h"
 #include "BsDiIxFind.h"
 
 static BsDiIxTxRm * sDiIxRm = NULL;
@@ -44,23 +47,25 @@ static void sf_prn_idx(BsDiIxTxRm *pDiIxRm) {
   bslog_log(BSLONLYMSG, "  irt:\n", pDiIxRm);
   BS_WCHAR_T wstr[pDiIxRm->head->mxIrWdSz];
   for (l = BS_IDX_0; l < pDiIxRm->head->irtSz; l++) {
-    bsdicidxab_istr_to_wstr(pDiIxRm->irt[l]->idx_subwrd, wstr, pDiIxRm->head->ab);
-    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" %ls dwolt_start="BS_IDX_FMT" i2wpt_quantity=%d i2wpt_start="BS_IDX_FMT"\n", l, wstr, pDiIxRm->irt[l]->dwolt_start, pDiIxRm->irt[l]->i2wpt_quantity, pDiIxRm->irt[l]->i2wpt_start);
+    bsdicidxab_istr_to_wstr(BDI_RM_IRTWRD(pDiIxRm, l), wstr, pDiIxRm->head->ab);
+    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" %ls dwolt_start="BS_IDX_FMT" i2wpt_quantity=%d i2wpt_start="BS_IDX_FMT"\n", l, wstr, BDI_RM_DWST(pDiIxRm, l), pDiIxRm->irtI2Qns[l], BDI_RM_I2ST(pDiIxRm, l));
   }
   bslog_log(BSLONLYMSG, "  i2wpt:\n", pDiIxRm);
   for (l = BS_IDX_0; l < pDiIxRm->head->i2wptSz; l++) {
-    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" = "BS_IDX_FMT"\n", l, pDiIxRm->i2wpt[l]);
+    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" = "BS_IDX_FMT"\n", l, BDI_RM_I2WPT(pDiIxRm, l));
   }
   bslog_log(BSLONLYMSG, "  dwolt:\n", pDiIxRm);
   for (l = BS_IDX_0; l < pDiIxRm->head->dwoltSz; l++) {
-    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" ofst=%ld len=%d\n", l, pDiIxRm->dwolt[l]->offset_dword, pDiIxRm->dwolt[l]->length_dword);
+    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" ofst=%ld len=%d\n", l, BDI_RM_DWOFS(pDiIxRm, l), pDiIxRm->dwoltLens[l]);
   }
 }
 
 static void sf_test2() {
   char *dic_pth = "tst_dic4.dsl";
-  BsDiIxOst *opSt = NULL; BsDiFdWds *dicWrds = NULL;
+  BsDiIxOst *opSt = NULL; BsDiFdWds *dicWrds = NULL, *dicWrdsDic = NULL;
   BS_DO_E_OUT (opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
   BS_DO_E_OUT (sDiIxRm = bsdiixtxrm_create (dic_pth, opSt))
   sf_prn_idx (sDiIxRm);
   BS_DO_E_OUT (bsdiixtxrm_validate(sDiIxRm))
@@ -77,7 +82,23 @@ static void sf_test2() {
           { bslog_log(BSLONLYMSG, "dicWrds->vals[%d]->wrd->val = %s\n", i, dicWrds->vals[i]->wrd->val); }
   if ( dicWrds->size != 6 )
           { errno = BSE_ERR; BSLOG_LOG(BSLERROR, "Wrong matched size=%d != 6 (sen)\n", dicWrds->size); }
+  //the same without HWP, i.e. from DIC:
+  BS_IF_ENM_OUT (sDiIxRm->hwp == NULL, BSE_TEST_ERR, "HWP is not made!\n")
+  char *hwp = sDiIxRm->hwp;
+  sDiIxRm->hwp = NULL;
+  BS_DO_E_OUT (dicWrdsDic = bsdifdwds_new (BS_IDX_100))
+  bsdiixtxrmfind_mtch (sDiIxRm, dicWrdsDic, subwrd);
+  sDiIxRm->hwp = hwp;
+  if ( errno != 0 )
+                { goto out; }
+  BS_IF_ENM_OUT (dicWrdsDic->size != dicWrds->size, BSE_TEST_ERR, "HWP matched size differs from DIC one!\n")
+  for ( int i = 0; i < dicWrds->size; i++ )
+  {
+    BS_IF_ENM_OUT (strcmp (dicWrds->vals[i]->wrd->val, dicWrdsDic->vals[i]->wrd->val) != 0,
+                   BSE_TEST_ERR, "HWP matched word differs from DIC one!\n")
+  }
 out:
+  bsdifdwds_free (dicWrdsDic);
   bsdiixost_free (opSt);
   fclose (sDiIxRm->dicFl);
   sDiIxRm->dicFl = NULL;
@@ -116,6 +137,193 @@ out:
   bsdiixtx_destroy(diIx);
 }
 
+//HIRTLK must give the same IRT ranges as HIRT scanning:
+static void sf_hirtlk(BsDiIxHeadBs *pHead, int pChrsSz) {
+  BS_IF_ENM_RET (pHead->hirtLk == NULL || pHead->hirtLk->sIdxs == NULL,
+                 BSE_TEST_ERR, "HIRTLK isn't made!\n")
+  BS_SMALL_T *sIdxs = pHead->hirtLk->sIdxs;
+  BS_CHAR_T iwrd[3];
+  iwrd[2] = 0;
+  for ( int k = 0; k < 2; k++ )
+  { //with second chars rows and without them:
+    pHead->hirtLk->sIdxs = k == 0 ? sIdxs : NULL;
+    for ( int f = 0; f < pChrsSz; f++ )
+    {
+      for ( int c = 0; c < pChrsSz; c++ )
+      {
+        iwrd[0] = f; iwrd[1] = c;
+        BS_IDX_T lkSt = BS_IDX_0, lkEn = pHead->irtSz - BS_IDX_1;
+        BS_IDX_T scSt = BS_IDX_0, scEn = pHead->irtSz - BS_IDX_1;
+        bsdicidx_find_irtrange (pHead, iwrd, &lkSt, &lkEn);
+        bsdicidx_find_irtrange_scan (pHead->hirt, pHead->hirtSz, iwrd, &scSt, &scEn);
+        if ( lkSt != scSt || lkEn != scEn )
+        {
+          pHead->hirtLk->sIdxs = sIdxs;
+          errno = BSE_TEST_ERR;
+          BSLOG_LOG (BSLERROR, "HIRTLK %d/%d range "BS_IDX_FMT"-"BS_IDX_FMT" != scanned "BS_IDX_FMT"-"BS_IDX_FMT"\n", f, c, lkSt, lkEn, scSt, scEn)
+          return;
+        }
+      }
+    }
+  }
+  pHead->hirtLk->sIdxs = sIdxs;
+}
+
+/**
+ * <p>HIRTLK of HIRT with second chars.</p>
+ **/
+static void sf_test_hirtlk() {
+  //fchar, irtIdx, second chars and their IRT indexes:
+  BS_CHAR_T fchars[] = { 2, 5, 6, 9 };
+  BS_IDX_T irtIdxs[] = { 0, 3, 9, 10 };
+  BS_SMALL_T schrsSzs[] = { 0, 3, 1, 2 };
+  BS_CHAR_T schars[][3] = { { 0 }, { 1, 4, 7 }, { 2 }, { 3, 6 } };
+  BS_IDX_T sIrtIdxs[][3] = { { 0 }, { 3, 5, 8 }, { 9 }, { 10, 12 } };
+  BsDiIxHirtRd *hirtRd = NULL;
+  BS_DO_E_RET (BsDiIxHeadBs *head = bsdiixheadbs_new (sizeof (BsDiIxHeadBs)))
+  head->hirtSz = 4;
+  head->irtSz = 15L;
+  for ( int i = 0; i < head->hirtSz; i++ )
+  {
+    BS_IF_ENM_OUT (head->hirtLk != NULL, BSE_TEST_ERR, "HIRTLK is made before HIRT completed!\n")
+    BS_DO_E_OUT (hirtRd = bsdicidxhirtrd_new (schrsSzs[i]))
+    hirtRd->fchar = fchars[i];
+    hirtRd->irtIdx = irtIdxs[i];
+    for ( int j = 0; j < schrsSzs[i]; j++ )
+    {
+      hirtRd->schars[j] = schars[i][j];
+      hirtRd->irtIdxs[j] = sIrtIdxs[i][j];
+    }
+    BS_DO_E_OUT (bsdiixheadbs_add_hirtrd (head, hirtRd))
+    hirtRd = NULL;
+  }
+  BS_DO_E_OUT (sf_hirtlk (head, 12))
+  //"5,4" - exactly second char, "5,5" - next second char bounds range:
+  BS_CHAR_T iwrd[] = { 5, 4, 0 };
+  BS_IDX_T irtSt = BS_IDX_0, irtEn = head->irtSz - BS_IDX_1;
+  bsdicidx_find_irtrange (head, iwrd, &irtSt, &irtEn);
+  BS_IF_ENM_OUT (irtSt != 5L || irtEn != 8L, BSE_TEST_ERR, "Wrong HIRTLK range for 5,4!\n")
+  iwrd[1] = 5; irtSt = BS_IDX_0; irtEn = head->irtSz - BS_IDX_1;
+  bsdicidx_find_irtrange (head, iwrd, &irtSt, &irtEn);
+  BS_IF_ENM_OUT (irtSt != 8L || irtEn != 8L, BSE_TEST_ERR, "Wrong HIRTLK range for 5,5!\n")
+out:
+  bsdicidxhirtrd_free (hirtRd);
+  bsdiixheadbs_free (head);
+}
+
+//IRTEZ must give the same IRT index as binary search for any range:
+static void sf_irtez(BsDiIxTxRm *pDiIxRm) {
+  BS_IF_ENM_RET (pDiIxRm->irtEz == NULL, BSE_TEST_ERR, "IRTEZ isn't made!\n")
+  BsDiIxIrtEz *irtEz = pDiIxRm->irtEz;
+  BS_IDX_T irtSz = pDiIxRm->head->irtSz;
+  BS_CHAR_T iwrd[3];
+  iwrd[2] = 0;
+  for ( int c = 0; c < pDiIxRm->head->ab->chrsTot + 3; c++ )
+  {
+    iwrd[0] = c; iwrd[1] = 1;
+    for ( BS_IDX_T st = BS_IDX_0; st < irtSz; st++ )
+    {
+      for ( BS_IDX_T en = st; en < irtSz; en++ )
+      {
+        BS_IDX_T ezIdx = bsdiixrmfindtst_irtix (pDiIxRm, iwrd, st, en);
+        pDiIxRm->irtEz = NULL;
+        BS_IDX_T bsIdx = bsdiixrmfindtst_irtix (pDiIxRm, iwrd, st, en);
+        pDiIxRm->irtEz = irtEz;
+        if ( ezIdx != bsIdx )
+        {
+          errno = BSE_TEST_ERR;
+          BSLOG_LOG (BSLERROR, "IRTEZ %d "BS_IDX_FMT"-"BS_IDX_FMT" index "BS_IDX_FMT" != "BS_IDX_FMT"\n", c, st, en, ezIdx, bsIdx)
+          return;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * <p>IRTEZ of made and loaded IDX RAM.</p>
+ **/
+static void sf_test_irtez() {
+  char *dic_pth = "tst_dic5.dsl";
+  BsDiIxTxRm *diIxRm = NULL;
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIxRm = bsdiixtxrm_create (dic_pth, opSt))
+  BS_DO_E_OUT (sf_irtez (diIxRm))
+  BS_DO_E_OUT (bsdiixtxrm_save (diIxRm, dic_pth))
+  diIxRm = bsdiixtxrm_destroy (diIxRm);
+  BS_DO_E_OUT (diIxRm = bsdiixtxrm_load (dic_pth))
+  BS_IF_ENM_OUT (diIxRm == NULL, BSE_TEST_ERR, "Can't load IDX RAM!\n")
+  BS_DO_E_OUT (sf_irtez (diIxRm))
+out:
+  bsdiixtxrm_destroy (diIxRm);
+  bsdiixost_free (opSt);
+}
+
+//IRTSM finding must give the same IRT record as finding by reading every probe:
+static void sf_irtsm(BsDiIxTx *pDiIx, size_t pBkSz) {
+  BsDicFindIrtRd *smRd = NULL, *flRd = NULL;
+  int chrsSz = pDiIx->head->ab->chrsTot + 2, mx = pDiIx->head->mxIrWdSz;
+  BS_CHAR_T iwrd[4];
+  BS_DO_E_RET (bsdiixtx_mk_irtsm (pDiIx, pBkSz))
+  BS_IF_ENM_RET (pDiIx->irtSm == NULL, BSE_TEST_ERR, "IRTSM isn't made!\n")
+  BsDiIxIrtSm *irtSm = pDiIx->irtSm;
+  for ( int f = 1; f < chrsSz; f++ )
+  {
+    for ( int c = 0; c < chrsSz; c++ )
+    {
+      for ( int t = 0; t < ( c == 0 ? 1 : chrsSz ); t++ )
+      {
+        iwrd[0] = f; iwrd[1] = c; iwrd[2] = t; iwrd[3] = 0;
+        BS_IDX_T st = BS_IDX_0, en = pDiIx->head->irtSz - BS_IDX_1;
+        BS_DO_E_OUT (bsdicidx_find_irtrange ((BsDiIxHeadBs*) pDiIx->head, iwrd, &st, &en))
+        BS_DO_E_OUT (smRd = bsdiixfindtst_irtrd (pDiIx, iwrd, st, en))
+        pDiIx->irtSm = NULL;
+        flRd = bsdiixfindtst_irtrd (pDiIx, iwrd, st, en);
+        pDiIx->irtSm = irtSm;
+        BS_IF_ENM_OUT (errno != 0, BSE_TEST_ERR, "Can't find in file!\n")
+        if ( ( smRd == NULL ) != ( flRd == NULL ) || ( smRd != NULL
+             && ( smRd->idx != flRd->idx || smRd->dwolt_start != flRd->dwolt_start
+                  || smRd->i2wpt_quantity != flRd->i2wpt_quantity
+                  || smRd->i2wpt_start != flRd->i2wpt_start
+                  || memcmp (smRd->idx_subwrd, flRd->idx_subwrd, mx * BS_CHAR_LEN) != 0 ) ) )
+        {
+          errno = BSE_TEST_ERR;
+          BSLOG_LOG (BSLERROR, "IRTSM block=%zu %d/%d/%d record differs\n", pBkSz, f, c, t)
+          goto out;
+        }
+        smRd = bsdicfindirtrd_free (smRd);
+        flRd = bsdicfindirtrd_free (flRd);
+      }
+    }
+  }
+out:
+  pDiIx->irtSm = irtSm;
+  bsdicfindirtrd_free (smRd);
+  bsdicfindirtrd_free (flRd);
+}
+
+/**
+ * <p>IRTSM of IDX in file without mapped IDX v2 with different blocks.</p>
+ **/
+static void sf_test_irtsm() {
+  char *dic_pth = "tst_dic5.dsl";
+  BsDiIxTx *diIx = NULL;
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL, BSE_TEST_ERR, "Can't open IDX!\n")
+  diIx->mm = bsdiixmm_free (diIx->mm);
+  BS_DO_E_OUT (sf_irtsm (diIx, 1))
+  BS_DO_E_OUT (sf_irtsm (diIx, 100))
+  BS_DO_E_OUT (sf_irtsm (diIx, BDI_IRTSM_BKSZ))
+out:
+  bsdiixtx_destroy (diIx);
+  bsdiixost_free (opSt);
+}
+
 static void sf_test1() {
   char *dic_pth = "tst_dic1.dsl";
   BSDICIDXRAM_OPEN_E_RET (diIxRm, dic_pth)
@@ -129,7 +337,7 @@ static void sf_test1() {
   }
   BS_IDX_T irtStRn = BS_IDX_0;
   BS_IDX_T irtEnRn = diIxRm->head->irtSz - BS_IDX_1;
-  BS_DO_E_OUT(bsdicidx_find_irtrange(diIxRm->head->hirt, diIxRm->head->hirtSz, isubwrd, &irtStRn, &irtEnRn))
+  BS_DO_E_OUT(bsdicidx_find_irtrange ((BsDiIxHeadBs*) diIxRm->head, isubwrd, &irtStRn, &irtEnRn))
   //1-"валяние", 2-"ящур", 0-"бюллетенить"
   BS_IF_ENM_OUT(irtStRn != irtEnRn || irtStRn != 2L || irtEnRn != 2L,
     BSE_ERR, "Wrong irtStRn=irtEnRn!= 2 (ящур)\n")
@@ -150,6 +358,1139 @@ out:
   bsdiixtxrm_destroy(diIxRm);
 }
 
+//mapped IRT words are the same as read from IDX file:
+static void sf_irt_wrds(BsDiIxTx *pDiIx) {
+  int mx = pDiIx->head->mxIrWdSz;
+  BS_CHAR_T flWrd[mx];
+  for ( BS_IDX_T l = BS_IDX_0; l < pDiIx->head->irtSz; l++ )
+  {
+    const BS_CHAR_T *mmWrd = bsdiixmm_irt_wrd (pDiIx->mm, l);
+    BS_DO_E_RET (bsfseek_goto (pDiIx->idxFl, l * (BDI_IRTRD_FIXED_SIZE (mx, pDiIx->head->flgs)) + pDiIx->irtOfst))
+    BS_DO_E_RET (bsfread_bschars (flWrd, mx, pDiIx->idxFl))
+    //full size word is without 0:
+    int len = 0;
+    while ( len < mx && flWrd[len] != 0 )
+          { len++; }
+    if ( memcmp (mmWrd, flWrd, len * BS_CHAR_LEN) != 0 || ( len < mx && mmWrd[len] != 0 ) )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "IRT#"BS_IDX_FMT" mapped word differs from file's one\n", l)
+      return;
+    }
+  }
+}
+
+/**
+ * <p>Find with mapped IDX v2 must give the same as with IDX file.</p>
+ **/
+static void sf_test4() {
+  char *dic_pth = "tst_dic4.dsl";
+  char *subwrds[] = { "sen", "se", "s", "sent", "com", "c", "humor", "zzz" };
+  int cnt = sizeof (subwrds) / sizeof (subwrds[0]);
+  BsDiIxOst *opSt = NULL; BsDiIxTx *diIx = NULL; BsDiIxMm *mm = NULL;
+  BsDiFdWds *mmWrds = NULL, *flWrds = NULL;
+  BsDiIxMm *mmLd = NULL;
+  BS_DO_E_OUT (opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL, BSE_TEST_ERR, "IDX v2 isn't mapped!\n")
+  BS_IF_ENM_OUT (diIx->mm->hwp == NULL, BSE_TEST_ERR, "IDX v2 is without HWP!\n")
+  //small dictionary's IDX is 32-bit:
+  BS_IF_ENM_OUT (diIx->head->flgs != ( BDI_TXFLG_IDX32 | BDI_TXFLG_OFS32 | BDI_TXFLG_SUM
+                                   | BDI_TXFLG_UCF | BDI_TXFLG_ALGN ),
+                 BSE_TEST_ERR, "IDX isn't 32-bit!\n")
+  BS_IF_ENM_OUT (diIx->mm->flgs != diIx->head->flgs, BSE_TEST_ERR, "IDX v2 flags differ!\n")
+  //saved IDX v2 is up to date:
+  BS_DO_E_OUT (mmLd = bsdiixmm_load (diIx, dic_pth, true))
+  BS_IF_ENM_OUT (mmLd == NULL, BSE_TEST_ERR, "IDX v2 is stale!\n")
+  BS_DO_E_OUT (sf_irt_wrds (diIx))
+  BS_DO_E_OUT (sf_hirtlk ((BsDiIxHeadBs*) diIx->head, diIx->head->ab->chrsTot + 3))
+  for ( int j = 0; j < cnt; j++ )
+  {
+    BS_DO_E_OUT (mmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (flWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (bsdiixtxfind_mtch (diIx, mmWrds, subwrds[j]))
+    mm = diIx->mm; diIx->mm = NULL;
+    BS_DO_E_OUT (bsdiixtxfind_mtch (diIx, flWrds, subwrds[j]))
+    diIx->mm = mm; mm = NULL;
+    bslog_log (BSLONLYMSG, "IDX v2 %s matched=%d\n", subwrds[j], mmWrds->size);
+    if ( mmWrds->size != flWrds->size )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "%s mapped matched=%d != file's one=%d\n", subwrds[j], mmWrds->size, flWrds->size)
+      goto out;
+    }
+    for ( int i = 0; i < mmWrds->size; i++ )
+    {
+      if ( strcmp (mmWrds->vals[i]->wrd->val, flWrds->vals[i]->wrd->val) != 0 )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "#%d mapped %s != file's %s\n", i, mmWrds->vals[i]->wrd->val, flWrds->vals[i]->wrd->val)
+        goto out;
+      }
+      BS_DO_E_OUT (BsString *str = bsstring_new (mmWrds->vals[i]->wrd->val))
+      BS_DO_E_OUT (BsDicString *dstr = bsdicidxfind_exactly (diIx, str))
+      bsstring_free (str);
+      if ( dstr == NULL )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "Can't found exactly mapped %s\n", mmWrds->vals[i]->wrd->val)
+        goto out;
+      }
+      bsdicstring_free (dstr);
+    }
+    mmWrds = bsdifdwds_free (mmWrds);
+    flWrds = bsdifdwds_free (flWrds);
+  }
+out:
+  if ( mm != NULL )
+        { diIx->mm = mm; }
+  bsdiixmm_free (mmLd);
+  bsdifdwds_free (mmWrds);
+  bsdifdwds_free (flWrds);
+  bsdiixtx_destroy (diIx);
+  bsdiixost_free (opSt);
+}
+
+//overwrite IDX v2 file's bytes:
+static void sf_mm_put(char *pPth, long pOfst, const void *pBts, size_t pSz) {
+  FILE *fl = fopen(pPth, "r+b");
+  BS_IF_EN_RET (fl == NULL, BSE_OPEN_FILE)
+  if (fseek(fl, pOfst, SEEK_SET) != 0 || fwrite(pBts, 1, pSz, fl) != pSz) {
+    errno = BSE_WRITE_FILE;
+  }
+  fclose(fl);
+}
+
+/**
+ * <p>IDX v2 with corrupted IRT record is stale, with corrupted DWOLT
+ * it's stale only for deep validation.</p>
+ **/
+static void sf_test_mm_crpt() {
+  char *dic_pth = "tst_dic4.dsl";
+  char pth[strlen(dic_pth) + 10];
+  BsDiIxOst *opSt = NULL; BsDiIxTx *diIx = NULL; BsDiIxMm *mmLd = NULL;
+  int64_t dwSt = 1L << 40;
+  uint16_t len;
+  long irtOfst, lnsOfst;
+  strcpy(pth, dic_pth);
+  strcat(pth, BDI_IDXMM_FILE_EXT);
+  BS_DO_E_OUT (opSt = bsdiixost_new ())
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL, BSE_TEST_ERR, "IDX v2 isn't mapped!\n")
+  irtOfst = diIx->mm->irt - (const char*) diIx->mm->dt;
+  lnsOfst = (const char*) diIx->mm->dwoltLens - (const char*) diIx->mm->dt;
+  len = diIx->mm->dwoltLens[0] + 1;
+  diIx->mm = bsdiixmm_free (diIx->mm);
+  //the first IRT record's DWOLT start out of DWOLT:
+  BS_DO_E_OUT (sf_mm_put (pth, irtOfst + BDI_IDXMM_IRT_DWST, &dwSt, 8))
+  BS_DO_E_OUT (mmLd = bsdiixmm_load (diIx, dic_pth, false))
+  BS_IF_ENM_OUT (mmLd != NULL, BSE_TEST_ERR, "IDX v2 with corrupted IRT record is loaded!\n")
+  BS_DO_E_OUT (bsdiixmm_save (diIx, dic_pth))
+  BS_DO_E_OUT (sf_mm_put (pth, lnsOfst, &len, 2))
+  BS_DO_E_OUT (mmLd = bsdiixmm_load (diIx, dic_pth, false))
+  BS_IF_ENM_OUT (mmLd == NULL, BSE_TEST_ERR, "IDX v2 with intact head isn't loaded!\n")
+  mmLd = bsdiixmm_free (mmLd);
+  BS_DO_E_OUT (mmLd = bsdiixmm_load (diIx, dic_pth, true))
+  BS_IF_ENM_OUT (mmLd != NULL, BSE_TEST_ERR, "IDX v2 with corrupted DWOLT is loaded by deep validation!\n")
+  //opening with deep validation remakes it:
+  diIx = bsdiixtx_destroy (diIx);
+  opSt->dpVld = true;
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL || diIx->mm->dwoltLens[0] != len - 1,
+                 BSE_TEST_ERR, "IDX v2 isn't remade!\n")
+out:
+  bsdiixmm_free (mmLd);
+  bsdiixtx_destroy (diIx);
+  bsdiixost_free (opSt);
+}
+
+//remove generated IDX v2, errno is kept:
+static void sf_rm_idx2() {
+  int errnoOld = errno;
+  char *pths[] = { "tst_dic1.dsl", "tst_dic4.dsl", "tst_dic5.dsl", "tst_dic6.dsl",
+                   "tst_ftiskp.dsl", "tst_ssn.dsl" };
+  for (int j = 0; j < (int) (sizeof (pths) / sizeof (pths[0])); j++) {
+    char pth[strlen(pths[j]) + 10];
+    strcpy(pth, pths[j]);
+    strcat(pth, BDI_IDXMM_FILE_EXT);
+    remove(pth);
+  }
+  errno = errnoOld;
+}
+
+//words of FST maker test, in AB coding, ordered:
+static BS_CHAR_T sFstWrds[][5] = {
+  {1, 2, 0}, {1, 2, 3, 0}, {1, 3, 0}, {1, 3, 4, 0}, {2, 0}, {2, 2, 3, 0},
+  {2, 3, 0}, {2, 3, 4, 0}, {3, 1, 2, 3, 0}, {4, 3, 4, 0}, {5, 0}
+};
+
+//FST of sFstWrds or its first pCnt ones:
+static char *sf_fst_mk(int pCnt) {
+  char *fst = NULL;
+  BS_DO_E_RETN (BsDiIxFstMk *fstMk = bsdiixfstmk_new ())
+  for ( int i = 0; i < pCnt; i++ )
+        { BS_DO_E_OUT (bsdiixfstmk_add (fstMk, sFstWrds[i])) }
+  fst = bsdiixfstmk_end (fstMk);
+out:
+  bsdiixfstmk_free (fstMk);
+  return fst;
+}
+
+//if pIwrd starts with pPrfx:
+static bool sf_is_prfx(BS_CHAR_T *pIwrd, BS_CHAR_T *pPrfx) {
+  for ( int i = 0; pPrfx[i] != 0; i++ )
+  {
+    if ( pIwrd[i] != pPrfx[i] )
+          { return false; }
+  }
+  return true;
+}
+
+/**
+ * <p>FST maker and finding by FST against brute force over sFstWrds.</p>
+ **/
+static void sf_test_fst_mk() {
+  int cnt = sizeof (sFstWrds) / sizeof (sFstWrds[0]);
+  char *fst = NULL, *fst2 = NULL;
+  BsDiIxFstIt *it = NULL;
+  BsDiIxFstMk *fstMk = NULL;
+  BS_CHAR_T prfx[4];
+  BS_IDX_T idx, en;
+  const BS_CHAR_T *wrd;
+  BS_DO_E_OUT (fst = sf_fst_mk (cnt))
+  BS_IF_ENM_OUT (BDI_FST_CNT (fst) != cnt || BDI_FST_MXLEN (fst) != 4,
+                 BSE_TEST_ERR, "FST head is wrong!\n")
+  for ( int i = 0; i < cnt; i++ )
+  {
+    if ( bsdiixfst_find (fst, sFstWrds[i]) != i )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "FST word#%d found as "BS_IDX_FMT"\n", i, bsdiixfst_find (fst, sFstWrds[i]))
+      goto out;
+    }
+  }
+  //every prefix up to 3 chars over 1..6:
+  for ( int l = 0; l < 6 * 6 * 6; l++ )
+  {
+    prfx[0] = l / 36 + 1; prfx[1] = l / 6 % 6 + 1; prfx[2] = l % 6 + 1; prfx[3] = 0;
+    for ( int k = 1; k <= 3; k++ )
+    {
+      BS_CHAR_T c = prfx[k];
+      prfx[k] = 0;
+      int st = -1, ex = 0;
+      for ( int i = 0; i < cnt; i++ )
+      {
+        if ( sf_is_prfx (sFstWrds[i], prfx) )
+        {
+          if ( st < 0 ) { st = i; }
+          ex = i + 1;
+        }
+      }
+      idx = bsdiixfst_prefix (fst, prfx, &en);
+      if ( ( st < 0 && idx != BS_IDX_NULL ) || ( st >= 0 && ( idx != st || en != ex ) ) )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "FST prefix %d/%d/%d range "BS_IDX_FMT"-"BS_IDX_FMT" != %d-%d\n", prfx[0], prfx[1], prfx[2], idx, en, st, ex)
+        goto out;
+      }
+      if ( bsdiixfst_find (fst, prfx) != BS_IDX_NULL && !( st >= 0
+             && bsdicidx_istr_cmp (sFstWrds[st], prfx) == 0 ) )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "FST found not word %d/%d/%d\n", prfx[0], prfx[1], prfx[2])
+        goto out;
+      }
+      //iterator gives the same range in order:
+      BS_DO_E_OUT (it = bsdiixfstit_new (fst, prfx))
+      int i = st;
+      while ( ( wrd = bsdiixfstit_next (it, &idx) ) != NULL )
+      {
+        if ( st < 0 || i >= ex || idx != i || bsdicidx_istr_cmp ((BS_CHAR_T*) wrd, sFstWrds[i]) != 0 )
+        {
+          errno = BSE_TEST_ERR;
+          BSLOG_LOG (BSLERROR, "FST iterator %d/%d/%d gives wrong #"BS_IDX_FMT"\n", prfx[0], prfx[1], prfx[2], idx)
+          goto out;
+        }
+        i++;
+      }
+      BS_IF_ENM_OUT (st >= 0 && i != ex, BSE_TEST_ERR, "FST iterator gives less words!\n")
+      it = bsdiixfstit_free (it);
+      prfx[k] = c;
+    }
+  }
+  //equal suffixes share states, i.e. the more ones the smaller FST:
+  BS_DO_E_OUT (fst2 = sf_fst_mk (4))
+  BS_IF_ENM_OUT (BDI_FST_SZ (fst) <= BDI_FST_SZ (fst2), BSE_TEST_ERR, "FST isn't growing!\n")
+  free (fst2);
+  BS_CHAR_T shrd[][5] = { {1, 5, 6, 7, 0}, {2, 5, 6, 7, 0}, {3, 5, 6, 7, 0} };
+  BS_CHAR_T unsh[][5] = { {1, 5, 6, 7, 0}, {2, 6, 7, 8, 0}, {3, 7, 8, 9, 0} };
+  BS_FOFST_T shrdSz = 0;
+  for ( int k = 0; k < 2; k++ )
+  {
+    BS_DO_E_OUT (fstMk = bsdiixfstmk_new ())
+    for ( int i = 0; i < 3; i++ )
+          { BS_DO_E_OUT (bsdiixfstmk_add (fstMk, k == 0 ? shrd[i] : unsh[i])) }
+    BS_DO_E_OUT (fst2 = bsdiixfstmk_end (fstMk))
+    fstMk = bsdiixfstmk_free (fstMk);
+    for ( int i = 0; i < 3; i++ )
+    {
+      BS_IF_ENM_OUT (bsdiixfst_find (fst2, k == 0 ? shrd[i] : unsh[i]) != i,
+                     BSE_TEST_ERR, "Suffix word isn't found!\n")
+    }
+    if ( k == 0 )
+    {
+      shrdSz = BDI_FST_SZ (fst2);
+    } else {
+      bslog_log (BSLONLYMSG, "FST shared suffixes size=%ld, unshared=%ld\n", (long) shrdSz, (long) BDI_FST_SZ (fst2));
+      BS_IF_ENM_OUT (shrdSz >= BDI_FST_SZ (fst2), BSE_TEST_ERR, "FST suffixes aren't shared!\n")
+    }
+    free (fst2); fst2 = NULL;
+  }
+  //not ordered word is rejected:
+  BS_DO_E_OUT (fstMk = bsdiixfstmk_new ())
+  BS_DO_E_OUT (bsdiixfstmk_add (fstMk, sFstWrds[1]))
+  bsdiixfstmk_add (fstMk, sFstWrds[0]);
+  BS_IF_ENM_OUT (errno != BSE_WRONG_PARAMS, BSE_TEST_ERR, "Not ordered word is added!\n")
+  errno = 0;
+  bsdiixfstmk_add (fstMk, sFstWrds[1]);
+  BS_IF_ENM_OUT (errno != BSE_WRONG_PARAMS, BSE_TEST_ERR, "Duplicate word is added!\n")
+  errno = 0;
+  fstMk = bsdiixfstmk_free (fstMk);
+  //empty FST:
+  BS_DO_E_OUT (fst2 = sf_fst_mk (0))
+  BS_IF_ENM_OUT (bsdiixfst_find (fst2, sFstWrds[0]) != BS_IDX_NULL
+                 || bsdiixfst_prefix (fst2, sFstWrds[0] + 2, &en) != BS_IDX_NULL,
+                 BSE_TEST_ERR, "Empty FST finds word!\n")
+  BS_DO_E_OUT (it = bsdiixfstit_new (fst2, sFstWrds[0] + 2))
+  BS_IF_ENM_OUT (bsdiixfstit_next (it, &idx) != NULL, BSE_TEST_ERR, "Empty FST gives word!\n")
+out:
+  bsdiixfstit_free (it);
+  bsdiixfstmk_free (fstMk);
+  free (fst);
+  free (fst2);
+}
+
+/**
+ * <p>FST of dictionary must give all DWOLT words in order by their indexes,
+ * and they are HWP ones.</p>
+ * @param pFst - FST
+ * @param pHwp - HWP or NULL
+ * @param pCnt - DWOLT size
+ **/
+static void sf_fst(const char *pFst, const char *pHwp, BS_IDX_T pCnt) {
+  BS_CHAR_T prfx[4], emp[1] = {0};
+  BS_IDX_T idx, l = BS_IDX_0, st, en;
+  const BS_CHAR_T *wrd;
+  BsDiIxFstIt *it = NULL, *itp = NULL;
+  BS_IF_ENM_RET (pFst == NULL, BSE_TEST_ERR, "There is no FST!\n")
+  BS_IF_ENM_RET (BDI_FST_CNT (pFst) != pCnt, BSE_TEST_ERR, "FST size isn't DWOLT one!\n")
+  BS_DO_E_RET (it = bsdiixfstit_new (pFst, emp))
+  while ( ( wrd = bsdiixfstit_next (it, &idx) ) != NULL )
+  {
+    BS_IF_ENM_OUT (idx != l || bsdiixfst_find (pFst, (BS_CHAR_T*) wrd) != l,
+                   BSE_TEST_ERR, "FST gives wrong index!\n")
+    if ( pHwp != NULL && BDI_HWP_MBSLEN (BDI_HWP_RD (pHwp, l)) > 0
+         && bsdicidx_istr_cmp ((BS_CHAR_T*) wrd, BDI_HWP_ISTR (BDI_HWP_RD (pHwp, l))) != 0 )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "FST word#"BS_IDX_FMT" isn't HWP %s\n", l, BDI_HWP_MBS (BDI_HWP_RD (pHwp, l)))
+      goto out;
+    }
+    //word's prefixes ranges hold it:
+    for ( int k = 0; k < 3 && wrd[k] != 0; k++ )
+    {
+      prfx[k] = wrd[k]; prfx[k + 1] = 0;
+      st = bsdiixfst_prefix (pFst, prfx, &en);
+      BS_IF_ENM_OUT (st == BS_IDX_NULL || st > l || en <= l, BSE_TEST_ERR, "FST prefix range misses word!\n")
+      BS_DO_E_OUT (itp = bsdiixfstit_new (pFst, prfx))
+      BS_IF_ENM_OUT (bsdiixfstit_next (itp, &idx) == NULL || idx != st,
+                     BSE_TEST_ERR, "FST prefix iterator starts wrong!\n")
+      itp = bsdiixfstit_free (itp);
+    }
+    l++;
+  }
+  BS_IF_ENM_OUT (l != pCnt, BSE_TEST_ERR, "FST gives less words!\n")
+out:
+  bsdiixfstit_free (it);
+  bsdiixfstit_free (itp);
+}
+
+/**
+ * <p>FST of made, loaded, mapped and in file IDX, and finding by prefix.</p>
+ **/
+static void sf_test_fst() {
+  char *dic_pth = "tst_dic4.dsl";
+  char *prfxs[] = { "sen", "se", "s", "sent", "com", "c", "humor", "zzz" };
+  int cnt = sizeof (prfxs) / sizeof (prfxs[0]);
+  BsDiIxTxRm *diIxRm = NULL;
+  BsDiIxTx *diIx = NULL;
+  BsDiIxMm *mm = NULL;
+  BsDiFdWds *rmWrds = NULL, *mmWrds = NULL, *flWrds = NULL;
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIxRm = bsdiixtxrm_create (dic_pth, opSt))
+  BS_DO_E_OUT (sf_fst (diIxRm->fst, NULL, diIxRm->head->dwoltSz))
+  BS_DO_E_OUT (bsdiixtxrm_save (diIxRm, dic_pth))
+  BS_DO_E_OUT (sf_fst (diIxRm->fst, diIxRm->hwp, diIxRm->head->dwoltSz))
+  diIxRm = bsdiixtxrm_destroy (diIxRm);
+  BS_DO_E_OUT (diIxRm = bsdiixtxrm_load (dic_pth))
+  BS_IF_ENM_OUT (diIxRm == NULL, BSE_TEST_ERR, "Can't load IDX RAM!\n")
+  BS_DO_E_OUT (sf_fst (diIxRm->fst, diIxRm->hwp, diIxRm->head->dwoltSz))
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL, BSE_TEST_ERR, "IDX v2 isn't mapped!\n")
+  BS_IF_ENM_OUT (diIx->fstOfst == BS_FOFST_NULL, BSE_TEST_ERR, "IDX is without FST!\n")
+  BS_DO_E_OUT (sf_fst (diIx->mm->fst, diIx->mm->hwp, diIx->head->dwoltSz))
+  BS_DO_E_OUT (diIx->fst = bsdiixfst_load (diIx->idxFl, diIx->fstOfst, diIx->head->dwoltSz))
+  BS_DO_E_OUT (sf_fst (diIx->fst, NULL, diIx->head->dwoltSz))
+  for ( int j = 0; j < cnt; j++ )
+  {
+    BS_DO_E_OUT (rmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (mmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (flWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (bsdiixtxrmfind_prfx (diIxRm, rmWrds, prfxs[j]))
+    BS_DO_E_OUT (bsdiixtxfind_prfx (diIx, mmWrds, prfxs[j]))
+    mm = diIx->mm; diIx->mm = NULL;
+    BS_DO_E_OUT (bsdiixtxfind_prfx (diIx, flWrds, prfxs[j]))
+    diIx->mm = mm; mm = NULL;
+    bslog_log (BSLONLYMSG, "FST %s completed=%d\n", prfxs[j], rmWrds->size);
+    if ( mmWrds->size != rmWrds->size || flWrds->size != rmWrds->size )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "%s RAM completed=%d, mapped=%d, file=%d\n", prfxs[j], rmWrds->size, mmWrds->size, flWrds->size)
+      goto out;
+    }
+    for ( int i = 0; i < rmWrds->size; i++ )
+    {
+      if ( strcmp (rmWrds->vals[i]->wrd->val, mmWrds->vals[i]->wrd->val) != 0
+           || strcmp (rmWrds->vals[i]->wrd->val, flWrds->vals[i]->wrd->val) != 0
+           || strncmp (rmWrds->vals[i]->wrd->val, prfxs[j], strlen (prfxs[j])) != 0 )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "%s #%d completed wrong %s\n", prfxs[j], i, rmWrds->vals[i]->wrd->val)
+        goto out;
+      }
+    }
+    //0sent 1send 2"sense of humor" 4Sendy 5Sena, but not "Common sense":
+    BS_IF_ENM_OUT (j == 0 && rmWrds->size != 5, BSE_TEST_ERR, "Wrong completed size (sen)!\n")
+    rmWrds = bsdifdwds_free (rmWrds);
+    mmWrds = bsdifdwds_free (mmWrds);
+    flWrds = bsdifdwds_free (flWrds);
+  }
+out:
+  if ( mm != NULL )
+        { diIx->mm = mm; }
+  bsdifdwds_free (rmWrds);
+  bsdifdwds_free (mmWrds);
+  bsdifdwds_free (flWrds);
+  bsdiixtx_destroy (diIx);
+  bsdiixtxrm_destroy (diIxRm);
+  bsdiixost_free (opSt);
+}
+
+//OSA distance between pQry and the closest prefix of pIwrd, brute force:
+static int sf_osa_prfx(BS_CHAR_T *pIwrd, BS_CHAR_T *pQry) {
+  int n = bsdicidx_istr_len (pIwrd), m = bsdicidx_istr_len (pQry), i, j, d, rz;
+  int dd[n + 1][m + 1];
+  for ( i = 0; i <= n; i++ )
+  {
+    for ( j = 0; j <= m; j++ )
+    {
+      if ( i == 0 || j == 0 )
+            { dd[i][j] = i + j; continue; }
+      d = dd[i - 1][j - 1] + ( pIwrd[i - 1] == pQry[j - 1] ? 0 : 1 );
+      if ( d > dd[i - 1][j] + 1 ) { d = dd[i - 1][j] + 1; }
+      if ( d > dd[i][j - 1] + 1 ) { d = dd[i][j - 1] + 1; }
+      if ( i > 1 && j > 1 && pIwrd[i - 1] == pQry[j - 2] && pIwrd[i - 2] == pQry[j - 1]
+           && d > dd[i - 2][j - 2] + 1 )
+            { d = dd[i - 2][j - 2] + 1; }
+      dd[i][j] = d;
+    }
+  }
+  rz = dd[0][m];
+  for ( i = 1; i <= n; i++ )
+  {
+    if ( dd[i][m] < rz ) { rz = dd[i][m]; }
+  }
+  return rz;
+}
+
+/**
+ * <p>Fuzzy finding by FST against brute force over sFstWrds.</p>
+ **/
+static void sf_test_fz_mk() {
+  int cnt = sizeof (sFstWrds) / sizeof (sFstWrds[0]);
+  int sz, l, k, e, dst, wrdsMx, dsts[cnt];
+  BS_CHAR_T qry[5];
+  BsDiIxFstFz *fzs = NULL;
+  char *fst = NULL;
+  BS_DO_E_OUT (fst = sf_fst_mk (cnt))
+  //every word up to 4 chars over 1..5 with distance 1 and 2, unlimited and cut:
+  for ( l = 0; l < 5 * 5 * 5 * 5; l++ )
+  {
+    qry[0] = l / 125 + 1; qry[1] = l / 25 % 5 + 1; qry[2] = l / 5 % 5 + 1;
+    qry[3] = l % 5 + 1; qry[4] = 0;
+    for ( k = 1; k <= 4; k++ )
+    {
+      BS_CHAR_T c = qry[k];
+      qry[k] = 0;
+      for ( int i = 0; i < cnt; i++ )
+            { dsts[i] = sf_osa_prfx (sFstWrds[i], qry); }
+      for ( int t = 0; t < 4; t++ )
+      {
+        dst = t % 2 + 1;
+        wrdsMx = t < 2 ? 100 : 3;
+        BS_DO_E_OUT (fzs = bsdiixfst_fuzzy (fst, qry, dst, wrdsMx, BDI_FST_FZ_ARCS, &sz))
+        //expected order is by distance then by index:
+        e = 0;
+        for ( int d = 0; d <= dst; d++ )
+        {
+          for ( int i = 0; i < cnt && e < wrdsMx; i++ )
+          {
+            if ( dsts[i] != d )
+                  { continue; }
+            //e-th found word:
+            int f = e, r;
+            for ( r = 0; r < sz && f >= fzs[r].end - fzs[r].stt; r++ )
+                  { f -= fzs[r].end - fzs[r].stt; }
+            if ( r == sz || fzs[r].stt + f != i || fzs[r].dst != d )
+            {
+              errno = BSE_TEST_ERR;
+              BSLOG_LOG (BSLERROR, "Fuzzy %d/%d/%d/%d dst=%d mx=%d #%d isn't word#%d of distance %d\n", qry[0], qry[1], qry[2], qry[3], dst, wrdsMx, e, i, d)
+              goto out;
+            }
+            e++;
+          }
+        }
+        //nothing else but the last range's tail when it's cut:
+        BS_IDX_T fnd = BS_IDX_0;
+        for ( int r = 0; r < sz; r++ )
+              { fnd += fzs[r].end - fzs[r].stt; }
+        if ( fnd < e || ( fnd > e && ( e < wrdsMx || fnd - ( fzs[sz - 1].end - fzs[sz - 1].stt ) >= e ) ) )
+        {
+          errno = BSE_TEST_ERR;
+          BSLOG_LOG (BSLERROR, "Fuzzy %d/%d/%d/%d dst=%d mx=%d found "BS_IDX_FMT" instead of %d\n", qry[0], qry[1], qry[2], qry[3], dst, wrdsMx, fnd, e)
+          goto out;
+        }
+        free (fzs); fzs = NULL;
+      }
+      qry[k] = c;
+    }
+  }
+  //exhausted budget finds nothing:
+  qry[0] = 2; qry[1] = 3; qry[2] = 0;
+  BS_DO_E_OUT (fzs = bsdiixfst_fuzzy (fst, qry, 1, 100, 0L, &sz))
+  BS_IF_ENM_OUT (sz != 0, BSE_TEST_ERR, "Fuzzy is out of budget!\n")
+  free (fzs);
+  fzs = bsdiixfst_fuzzy (fst, qry, BDI_FST_FZ_DSTMX + 1, 100, BDI_FST_FZ_ARCS, &sz);
+  BS_IF_ENM_OUT (fzs != NULL || errno != BSE_WRONG_PARAMS, BSE_TEST_ERR, "Fuzzy distance isn't checked!\n")
+  errno = 0;
+out:
+  free (fzs);
+  free (fst);
+}
+
+/**
+ * <p>Typo tolerant finding in RAM, mapped and in file IDX.</p>
+ **/
+static void sf_test_fz() {
+  char *dic_pth = "tst_dic4.dsl";
+  //typo, found total, the first found:
+  char *wrds[] = { "sne", "snt", "comon", "sendx", "sen", "zzz" };
+  int cnts[] = { 5, 1, 1, 2, 6, 0 };
+  char *fsts[] = { "sena", "sent", "common sense", "send", "sena", NULL };
+  int cnt = sizeof (wrds) / sizeof (wrds[0]);
+  BsDiIxTxRm *diIxRm = NULL;
+  BsDiIxTx *diIx = NULL;
+  BsDiIxMm *mm = NULL;
+  BsDiFdWds *rmWrds = NULL, *mmWrds = NULL, *flWrds = NULL;
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIxRm = bsdiixtxrm_load (dic_pth))
+  BS_IF_ENM_OUT (diIxRm == NULL, BSE_TEST_ERR, "Can't load IDX RAM!\n")
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL, BSE_TEST_ERR, "IDX v2 isn't mapped!\n")
+  BS_DO_E_OUT (diIx->fst = bsdiixfst_load (diIx->idxFl, diIx->fstOfst, diIx->head->dwoltSz))
+  for ( int j = 0; j < cnt; j++ )
+  {
+    BS_DO_E_OUT (rmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (mmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (flWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (bsdiixtxrmfind_mtfz (diIxRm, rmWrds, wrds[j]))
+    BS_DO_E_OUT (bsdiixtxfind_mtfz (diIx, mmWrds, wrds[j]))
+    mm = diIx->mm; diIx->mm = NULL;
+    BS_DO_E_OUT (bsdiixtxfind_mtfz (diIx, flWrds, wrds[j]))
+    diIx->mm = mm; mm = NULL;
+    bslog_log (BSLONLYMSG, "Fuzzy %s found=%d\n", wrds[j], rmWrds->size);
+    for ( int i = 0; i < rmWrds->size; i++ )
+          { bslog_log (BSLONLYMSG, "  %s\n", rmWrds->vals[i]->wrd->val); }
+    if ( rmWrds->size != cnts[j] || mmWrds->size != cnts[j] || flWrds->size != cnts[j] )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "%s RAM found=%d, mapped=%d, file=%d, must be %d\n", wrds[j], rmWrds->size, mmWrds->size, flWrds->size, cnts[j])
+      goto out;
+    }
+    for ( int i = 0; i < rmWrds->size; i++ )
+    {
+      if ( strcmp (rmWrds->vals[i]->wrd->val, mmWrds->vals[i]->wrd->val) != 0
+           || strcmp (rmWrds->vals[i]->wrd->val, flWrds->vals[i]->wrd->val) != 0
+           || ( i == 0 && strcmp (rmWrds->vals[i]->wrd->val, fsts[j]) != 0 ) )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "%s #%d found wrong %s\n", wrds[j], i, rmWrds->vals[i]->wrd->val)
+        goto out;
+      }
+    }
+    rmWrds = bsdifdwds_free (rmWrds);
+    mmWrds = bsdifdwds_free (mmWrds);
+    flWrds = bsdifdwds_free (flWrds);
+  }
+  //disabled:
+  BS_DO_E_OUT (bsdiixfind_set_fzdst (0))
+  BS_DO_E_OUT (rmWrds = bsdifdwds_new (BS_IDX_100))
+  BS_DO_E_OUT (bsdiixtxrmfind_mtfz (diIxRm, rmWrds, wrds[0]))
+  BS_IF_ENM_OUT (rmWrds->size != 0, BSE_TEST_ERR, "Disabled fuzzy finds!\n")
+  bsdiixfind_set_fzdst (BDI_FST_FZ_DSTMX + 1);
+  BS_IF_ENM_OUT (errno != BSE_WRONG_PARAMS || bsdiixfind_get_fzdst () != 0,
+                 BSE_TEST_ERR, "Wrong fuzzy distance is set!\n")
+  errno = 0;
+out:
+  bsdiixfind_set_fzdst (BDI_FST_FZ_DSTMX);
+  if ( mm != NULL )
+        { diIx->mm = mm; }
+  bsdifdwds_free (rmWrds);
+  bsdifdwds_free (mmWrds);
+  bsdifdwds_free (flWrds);
+  bsdiixtx_destroy (diIx);
+  bsdiixtxrm_destroy (diIxRm);
+  bsdiixost_free (opSt);
+}
+
+//if pIwrd contains pInfx:
+static bool sf_is_infx(const BS_CHAR_T *pIwrd, BS_CHAR_T *pInfx) {
+  for ( int i = 0; pIwrd[i] != 0; i++ )
+  {
+    if ( sf_is_prfx ((BS_CHAR_T*) pIwrd + i, pInfx) )
+          { return true; }
+  }
+  return false;
+}
+
+/**
+ * <p>SA made of sFstWrds and I2WORD without DWOLT record,
+ * finding by infix against brute force.</p>
+ **/
+static void sf_test_sa_mk() {
+  int cnt = sizeof (sFstWrds) / sizeof (sFstWrds[0]);
+  int sz, e, l, k, n;
+  BS_CHAR_T infx[4], i2w[] = {1, 3, 1, 0};
+  BS_IDX_T idxs[BS_IDX_100], stt, end, exps[cnt];
+  char *sa = NULL;
+  BS_DO_E_RET (BsDicIwrds *iwrds = bsdiciwrds_new (BS_IDX_100, NULL))
+  for ( int i = 0; i < cnt; i++ )
+  {
+    BS_DO_E_OUT (bsdiciwrds_add_inc (iwrds, bsdiciwrdrd_new (sFstWrds[i], i * 10, 3)))
+    if ( i == 2 )
+          { BS_DO_E_OUT (bsdiciwrds_add_inc (iwrds, bsdiciwrdrd_new (i2w, 0, 0))) }
+  }
+  BS_DO_E_OUT (sa = bsdiixsa_new (iwrds))
+  BS_IF_ENM_OUT (BDI_SA_CNT (sa) != cnt, BSE_TEST_ERR, "SA size isn't DWOLT one!\n")
+  //every infix up to 3 chars over 1..5, unlimited and cut:
+  for ( l = 0; l < 5 * 5 * 5; l++ )
+  {
+    for ( k = 1; k <= 3; k++ )
+    {
+      infx[0] = l / 25 + 1; infx[1] = l / 5 % 5 + 1; infx[2] = l % 5 + 1;
+      infx[k] = 0;
+      e = 0; n = 0;
+      for ( int i = 0; i < cnt; i++ )
+      {
+        if ( sf_is_infx (sFstWrds[i], infx) )
+              { exps[e++] = i; }
+        for ( int j = 0; sFstWrds[i][j] != 0; j++ )
+        {
+          if ( sf_is_prfx (sFstWrds[i] + j, infx) )
+                { n++; }
+        }
+      }
+      stt = bsdiixsa_range (sa, infx, &end);
+      if ( ( n == 0 && stt != BS_IDX_NULL ) || ( n > 0 && end - stt != n ) )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "SA %d/%d/%d range has wrong size, must be %d\n", infx[0], infx[1], infx[2], n)
+        goto out;
+      }
+      for ( BS_IDX_T s = stt; n > 0 && s < end; s++ )
+      {
+        BS_IF_ENM_OUT (!sf_is_infx (sFstWrds[bsdiixsa_wrd (sa, s)], infx),
+                       BSE_TEST_ERR, "SA suffix's word hasn't infix!\n")
+      }
+      for ( int mx = 100; mx > 0; mx -= 98 )
+      {
+        BS_DO_E_OUT (sz = bsdiixsa_find (sa, infx, idxs, mx))
+        if ( sz != ( e < mx ? e : mx ) )
+        {
+          errno = BSE_TEST_ERR;
+          BSLOG_LOG (BSLERROR, "SA %d/%d/%d mx=%d found %d instead of %d\n", infx[0], infx[1], infx[2], mx, sz, e)
+          goto out;
+        }
+        for ( int i = 0; i < sz; i++ )
+        {
+          BS_IF_ENM_OUT (idxs[i] != exps[i], BSE_TEST_ERR, "SA found wrong word!\n")
+        }
+      }
+    }
+  }
+  infx[0] = 0;
+  BS_IF_ENM_OUT (bsdiixsa_find (sa, infx, idxs, 100) != -1 || errno != BSE_WRONG_PARAMS,
+                 BSE_TEST_ERR, "SA empty infix isn't checked!\n")
+  errno = 0;
+out:
+  free (sa);
+  bsdiciwrds_free (iwrds);
+}
+
+/**
+ * <p>Finding by infix by SA in made, loaded, mapped and in file IDX.
+ * Scanning IDX without SA (in RAM and in file without IDX v2)
+ * finds the same words.</p>
+ **/
+static void sf_test_sa() {
+  char *dic_pth = "tst_dic4.dsl";
+  //infix, found total:
+  char *infxs[] = { "ens", "en", "mon", "se", "y", "of h", "zzz" };
+  int cnts[] = { 2, 6, 1, 6, 1, 1, 0 };
+  int cnt = sizeof (infxs) / sizeof (infxs[0]);
+  BsDiIxTxRm *diIxRm = NULL, *diIxRmLd = NULL;
+  BsDiIxTx *diIx = NULL;
+  BsDiIxMm *mm = NULL;
+  BsDiFdWds *rmWrds = NULL, *ldWrds = NULL, *mmWrds = NULL, *flWrds = NULL;
+  BsDiFdWds *rmScWrds = NULL, *flScWrds = NULL;
+  char *rmSa = NULL, *flSa = NULL;
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIxRm = bsdiixtxrm_create (dic_pth, opSt))
+  BS_IF_ENM_OUT (diIxRm->sa == NULL, BSE_TEST_ERR, "Made IDX is without SA!\n")
+  BS_DO_E_OUT (bsdiixtxrm_save (diIxRm, dic_pth))
+  BS_DO_E_OUT (diIxRmLd = bsdiixtxrm_load (dic_pth))
+  BS_IF_ENM_OUT (diIxRmLd == NULL || diIxRmLd->sa == NULL, BSE_TEST_ERR, "Loaded IDX is without SA!\n")
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL || diIx->mm->sa == NULL,
+                 BSE_TEST_ERR, "IDX v2 is without SA!\n")
+  BS_IF_ENM_OUT (diIx->saOfst == BS_FOFST_NULL, BSE_TEST_ERR, "IDX is without SA!\n")
+  BS_DO_E_OUT (diIx->sa = bsdiixsa_load (diIx->idxFl, diIx->saOfst, diIx->head->dwoltSz))
+  BS_IF_ENM_OUT (diIx->sa == NULL || BDI_SA_SZ (diIx->sa) != BDI_SA_SZ (diIx->mm->sa)
+                 || memcmp (diIx->sa, diIx->mm->sa, BDI_SA_SZ (diIx->sa)) != 0
+                 || memcmp (diIx->sa, diIxRm->sa, BDI_SA_SZ (diIx->sa)) != 0,
+                 BSE_TEST_ERR, "SA in file isn't made one!\n")
+  for ( int j = 0; j < cnt; j++ )
+  {
+    BS_DO_E_OUT (rmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (ldWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (mmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (flWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (rmScWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (flScWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (bsdiixtxrmfind_infx (diIxRm, rmWrds, infxs[j]))
+    BS_DO_E_OUT (bsdiixtxrmfind_infx (diIxRmLd, ldWrds, infxs[j]))
+    BS_DO_E_OUT (bsdiixtxfind_infx (diIx, mmWrds, infxs[j]))
+    mm = diIx->mm; diIx->mm = NULL;
+    BS_DO_E_OUT (bsdiixtxfind_infx (diIx, flWrds, infxs[j]))
+    rmSa = diIxRm->sa; diIxRm->sa = NULL;
+    BS_DO_E_OUT (bsdiixtxrmfind_infx (diIxRm, rmScWrds, infxs[j]))
+    diIxRm->sa = rmSa; rmSa = NULL;
+    flSa = diIx->sa; diIx->sa = NULL;
+    BS_DO_E_OUT (bsdiixtxfind_infx (diIx, flScWrds, infxs[j]))
+    diIx->sa = flSa; flSa = NULL;
+    diIx->mm = mm; mm = NULL;
+    bslog_log (BSLONLYMSG, "SA %s found=%d\n", infxs[j], rmWrds->size);
+    if ( rmWrds->size != cnts[j] || ldWrds->size != cnts[j]
+         || mmWrds->size != cnts[j] || flWrds->size != cnts[j]
+         || rmScWrds->size != cnts[j] || flScWrds->size != cnts[j] )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "%s made found=%d, loaded=%d, mapped=%d, file=%d, scanned made=%d, scanned file=%d, must be %d\n", infxs[j], rmWrds->size, ldWrds->size, mmWrds->size, flWrds->size, rmScWrds->size, flScWrds->size, cnts[j])
+      goto out;
+    }
+    for ( int i = 0; i < rmWrds->size; i++ )
+    {
+      if ( strcmp (rmWrds->vals[i]->wrd->val, ldWrds->vals[i]->wrd->val) != 0
+           || strcmp (rmWrds->vals[i]->wrd->val, mmWrds->vals[i]->wrd->val) != 0
+           || strcmp (rmWrds->vals[i]->wrd->val, flWrds->vals[i]->wrd->val) != 0
+           || strcmp (rmWrds->vals[i]->wrd->val, rmScWrds->vals[i]->wrd->val) != 0
+           || strcmp (rmWrds->vals[i]->wrd->val, flScWrds->vals[i]->wrd->val) != 0
+           || strstr (rmWrds->vals[i]->wrd->val, infxs[j]) == NULL )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "%s #%d found wrong %s\n", infxs[j], i, rmWrds->vals[i]->wrd->val)
+        goto out;
+      }
+    }
+    rmWrds = bsdifdwds_free (rmWrds);
+    ldWrds = bsdifdwds_free (ldWrds);
+    mmWrds = bsdifdwds_free (mmWrds);
+    flWrds = bsdifdwds_free (flWrds);
+    rmScWrds = bsdifdwds_free (rmScWrds);
+    flScWrds = bsdifdwds_free (flScWrds);
+  }
+out:
+  if ( mm != NULL )
+        { diIx->mm = mm; }
+  if ( rmSa != NULL )
+        { diIxRm->sa = rmSa; }
+  if ( flSa != NULL )
+        { diIx->sa = flSa; }
+  bsdifdwds_free (rmWrds);
+  bsdifdwds_free (ldWrds);
+  bsdifdwds_free (mmWrds);
+  bsdifdwds_free (flWrds);
+  bsdifdwds_free (rmScWrds);
+  bsdifdwds_free (flScWrds);
+  bsdiixtx_destroy (diIx);
+  bsdiixtxrm_destroy (diIxRm);
+  bsdiixtxrm_destroy (diIxRmLd);
+  bsdiixost_free (opSt);
+}
+
+/**
+ * <p>Read whole file.</p>
+ * @param pPth - path
+ * @param pSzRt - pointer to return size
+ * @return content or NULL
+ **/
+static char *sf_read_fl(char *pPth, long *pSzRt) {
+  char *rz = NULL;
+  FILE *fl = fopen (pPth, "rb");
+  BS_IF_EN_RETN (fl == NULL, BSE_OPEN_FILE)
+  fseek (fl, 0L, SEEK_END);
+  *pSzRt = ftell (fl);
+  fseek (fl, 0L, SEEK_SET);
+  rz = malloc (*pSzRt + 1);
+  if ( rz == NULL || (long) fread (rz, 1, *pSzRt, fl) != *pSzRt ) {
+    free (rz);
+    rz = NULL;
+    errno = BSE_READ_FILE;
+  }
+  fclose (fl);
+  return rz;
+}
+
+/**
+ * <p>FTI made in one thread must be the same as one made by several threads
+ * or by reading DWOLT from IDX file instead of IDX v2.</p>
+ * @param pDiIx - IDX with IDX v2
+ * @param pPth - dictionary path
+ **/
+static void sf_fti_same(BsDiIxTx *pDiIx, char *pPth) {
+  char pth[strlen (pPth) + 10], *fti1 = NULL, *fti = NULL;
+  long sz1, sz;
+  BsDiIxMm *mm = pDiIx->mm;
+  strcpy (pth, pPth);
+  strcat (pth, BDI_FTI_FILE_EXT);
+  BS_DO_E_OUT (bsdiixfti_save (pDiIx, pPth, 1))
+  BS_DO_E_OUT (fti1 = sf_read_fl (pth, &sz1))
+  for ( int i = 0; i < 3; i++ ) {
+    if ( i == 2 ) {
+      pDiIx->mm = NULL;
+    }
+    BS_DO_E_OUT (bsdiixfti_save (pDiIx, pPth, i == 2 ? 1 : i + 2))
+    pDiIx->mm = mm;
+    BS_DO_E_OUT (fti = sf_read_fl (pth, &sz))
+    if ( sz != sz1 || memcmp (fti1, fti, sz) != 0 ) {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "%s #%d FTI size=%ld differs from 1 thread one size=%ld\n", pPth, i, sz, sz1)
+      goto out;
+    }
+    free (fti);
+    fti = NULL;
+  }
+out:
+  pDiIx->mm = mm;
+  free (fti1);
+  free (fti);
+}
+
+/**
+ * <p>Finding articles by content in mapped and in file IDX.</p>
+ * @param pPth - dictionary path
+ * @param pQrys - queries
+ * @param pIsPhrs - whether query is phrase
+ * @param pCnts - found words totals
+ * @param pWrds - the first found words
+ * @param pCnt - queries count
+ **/
+static void sf_fti(char *pPth, char **pQrys, bool *pIsPhrs, int *pCnts,
+                   char **pWrds, int pCnt) {
+  BsDiIxTx *diIx = NULL;
+  BsDiIxMm *mm = NULL;
+  BsDiIxFti *fti = NULL;
+  BsDiFdWds *mmWrds = NULL, *flWrds = NULL;
+  BS_IDX_T idxs[2];
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (pPth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL, BSE_TEST_ERR, "IDX v2 is absent!\n")
+  BS_DO_E_OUT (sf_fti_same (diIx, pPth))
+  BS_DO_E_OUT (fti = bsdiixfti_open (diIx, pPth, 1))
+  BS_IF_ENM_OUT (fti == NULL, BSE_TEST_ERR, "FTI is absent!\n")
+  if ( bsdiixfti_find (fti, diIx->head->ab, "", false, idxs, 2) != -1
+       || errno != BSE_WRONG_PARAMS ) {
+    errno = BSE_TEST_ERR;
+    BSLOG_LOG (BSLERROR, "Empty query isn't wrong!\n")
+    goto out;
+  }
+  errno = 0;
+  for ( int j = 0; j < pCnt; j++ )
+  {
+    BS_DO_E_OUT (mmWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (flWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT (bsdiixtxfind_fti (diIx, fti, mmWrds, pQrys[j], pIsPhrs[j]))
+    mm = diIx->mm; diIx->mm = NULL;
+    BS_DO_E_OUT (bsdiixtxfind_fti (diIx, fti, flWrds, pQrys[j], pIsPhrs[j]))
+    diIx->mm = mm; mm = NULL;
+    bslog_log (BSLONLYMSG, "FTI %s \"%s\" found=%d\n", pPth, pQrys[j], mmWrds->size);
+    if ( mmWrds->size != pCnts[j] || flWrds->size != pCnts[j]
+         || ( pCnts[j] > 0 && strcmp (mmWrds->vals[0]->wrd->val, pWrds[j]) != 0 ) )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "\"%s\" mapped found=%d, file=%d, must be %d (%s)\n", pQrys[j], mmWrds->size, flWrds->size, pCnts[j], pWrds[j])
+      goto out;
+    }
+    for ( int i = 0; i < mmWrds->size; i++ )
+    {
+      if ( strcmp (mmWrds->vals[i]->wrd->val, flWrds->vals[i]->wrd->val) != 0 )
+      {
+        errno = BSE_TEST_ERR;
+        BSLOG_LOG (BSLERROR, "\"%s\" #%d mapped found %s, file %s\n", pQrys[j], i, mmWrds->vals[i]->wrd->val, flWrds->vals[i]->wrd->val)
+        goto out;
+      }
+    }
+    mmWrds = bsdifdwds_free (mmWrds);
+    flWrds = bsdifdwds_free (flWrds);
+  }
+out:
+  if ( mm != NULL )
+        { diIx->mm = mm; }
+  bsdifdwds_free (mmWrds);
+  bsdifdwds_free (flWrds);
+  bsdiixfti_free (fti);
+  bsdiixtx_destroy (diIx);
+  bsdiixost_free (opSt);
+}
+
+/**
+ * <p>Finding articles by content words and phrases.</p>
+ **/
+static void sf_test_fti() {
+  char *qrys4[] = { "disease", "foot and mouth", "foot mouth", "foot mouth",
+    "Disease, MOUTH!", "milling", "СУКНА", "sick leave", "разг", "com",
+    "trn", "m1", "leave disease" };
+  bool isPhrs4[] = { false, true, true, false, false, false, false, true,
+    false, false, false, false, false };
+  int cnts4[] = { 3, 3, 0, 3, 3, 2, 2, 1, 1, 0, 0, 0, 0 };
+  char *wrds4[] = { "send", "send", "", "send", "send", "sent", "sent",
+    "sense of humor", "sense of humor", "", "", "", "" };
+  BS_DO_E_RET (sf_fti ("tst_dic4.dsl", qrys4, isPhrs4, cnts4, wrds4,
+                       sizeof (qrys4) / sizeof (qrys4[0])))
+  char *qrys6[] = { "zebra", "striped horse", "about", "tag", "well-known", "known", "o'clock",
+    "dc", "contraction possessive", "contraction possessive",
+    "possessive of it", "its", "well known", "wav" };
+  bool isPhrs6[] = { false, true, false, false, false, false, false, false,
+    false, true, true, false, true, false };
+  int cnts6[] = { 0, 1, 2, 1, 1, 1, 1, 1, 2, 0, 2, 0, 0, 0 };
+  char *wrds6[] = { "", "zebra", "it's", "well-known", "well-known", "well-known",
+    "zebra", "zebra", "it's", "", "it's", "", "", "" };
+  BS_DO_E_RET (sf_fti ("tst_dic6.dsl", qrys6, isPhrs6, cnts6, wrds6,
+                       sizeof (qrys6) / sizeof (qrys6[0])))
+}
+
+/**
+ * <p>Finding in long postings with skips by generated dictionary,
+ * article #i has "two" if i%2==0, "three" if i%3==0, "seven" if i%7==0,
+ * headwords are in DWOLT order, so found DWOLT index is article's one.</p>
+ **/
+static void sf_test_fti_skp() {
+  char *dic_pth = "tst_ftiskp.dsl";
+  int artsSz = 1000, mods[][3] = { { 1, 1, 1 }, { 2, 7, 1 }, { 7, 1, 1 },
+    { 3, 7, 2 }, { 6, 1, 1 }, { 6, 1, 1 }, { 0, 0, 0 } };
+  char *qrys[] = { "every", "two seven", "seven every", "three seven two",
+    "two three", "every two three", "three two" };
+  bool isPhrs[] = { false, false, false, false, true, true, true };
+  BsDiIxTx *diIx = NULL;
+  BsDiIxFti *fti = NULL;
+  BS_IDX_T idxs[artsSz];
+  int i, j, k, sz;
+  FILE *fl = fopen (dic_pth, "w");
+  BS_IF_EN_RET (fl == NULL, BSE_OPEN_FILE)
+  fprintf (fl, "#NAME \"Skips\"\n#INDEX_LANGUAGE \"English\"\n#CONTENTS_LANGUAGE \"English\"\n\n");
+  for ( i = 0; i < artsSz; i++ ) {
+    fprintf (fl, "w%c%c%c\n\t[m1]every%s%s%s[/m]\n", 'a' + i / 676, 'a' + i / 26 % 26,
+      'a' + i % 26, i % 2 == 0 ? " two" : "", i % 3 == 0 ? " three" : "",
+      i % 7 == 0 ? " seven" : "");
+  }
+  fclose (fl);
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (dic_pth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL, BSE_TEST_ERR, "IDX is absent!\n")
+  BS_DO_E_OUT (sf_fti_same (diIx, dic_pth))
+  BS_DO_E_OUT (fti = bsdiixfti_open (diIx, dic_pth, 2))
+  BS_IF_ENM_OUT (fti == NULL, BSE_TEST_ERR, "FTI is absent!\n")
+  for ( j = 0; j < (int) ( sizeof (qrys) / sizeof (qrys[0]) ); j++ ) {
+    BS_DO_E_OUT (sz = bsdiixfti_find (fti, diIx->head->ab, qrys[j], isPhrs[j], idxs, artsSz))
+    for ( i = 0, k = 0; i < artsSz && mods[j][0] > 0; i++ ) {
+      if ( i % mods[j][0] == 0 && i % mods[j][1] == 0 && i % mods[j][2] == 0 ) {
+        if ( k >= sz || idxs[k] != i ) {
+          errno = BSE_TEST_ERR;
+          BSLOG_LOG (BSLERROR, "\"%s\" #%d found=%ld, must be %d\n", qrys[j], k, k < sz ? idxs[k] : -1L, i)
+          goto out;
+        }
+        k++;
+      }
+    }
+    bslog_log (BSLONLYMSG, "FTI %s \"%s\" found=%d\n", dic_pth, qrys[j], sz);
+    BS_IF_ENM_OUT (k != sz, BSE_TEST_ERR, "Found more than must be!\n")
+  }
+out:
+  bsdiixfti_free (fti);
+  bsdiixtx_destroy (diIx);
+  bsdiixost_free (opSt);
+}
+
+//found words and their dictionaries' offsets are the same:
+static void sf_fdwds_same(BsDiFdWds *pFdWrds1, BsDiFdWds *pFdWrds2, char *pQry) {
+  if ( pFdWrds1->size != pFdWrds2->size )
+  {
+    errno = BSE_TEST_ERR;
+    BSLOG_LOG (BSLERROR, "\"%s\" found=%d != %d\n", pQry, pFdWrds1->size, pFdWrds2->size)
+    return;
+  }
+  for ( int i = 0; i < pFdWrds1->size; i++ )
+  {
+    BsDiSrDt1s *dos1 = pFdWrds1->vals[i]->dicOfsts, *dos2 = pFdWrds2->vals[i]->dicOfsts;
+    bool isSm = strcmp (pFdWrds1->vals[i]->wrd->val, pFdWrds2->vals[i]->wrd->val) == 0
+                  && dos1->size == dos2->size;
+    for ( int d = 0; isSm && d < dos1->size; d++ )
+          { isSm = dos1->vals[d]->diIx == dos2->vals[d]->diIx && dos1->vals[d]->ofst == dos2->vals[d]->ofst; }
+    if ( !isSm )
+    {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG (BSLERROR, "\"%s\" #%d found %s != %s\n", pQry, i, pFdWrds1->vals[i]->wrd->val, pFdWrds2->vals[i]->wrd->val)
+      return;
+    }
+  }
+}
+
+/**
+ * <p>Session finds the same as finding from scratch while typing
+ * and deleting every given query's char, then jumping between queries.</p>
+ **/
+static void sf_ssn(BsDiIxBs *pDiIx, bool pIsIxRm, char **pQrys, int pCnt) {
+  BsDiFdWds *ssWrds = NULL, *wrds = NULL;
+  BS_DO_E_RET (BsDiIxSsn *ssn = bsdiixssn_new (pDiIx, pIsIxRm))
+  int stpsSz = 0, fdsSz = 0;
+  for ( int j = 0; j < pCnt * 2 + 1; j++ )
+  {
+    wchar_t wqry[100];
+    int wlen = mbstowcs (wqry, pQrys[j % pCnt], 100);
+    BS_IF_ENM_OUT (wlen <= 0, BSE_TEST_ERR, "Wrong query!\n")
+    //typing and deleting, then only whole query:
+    int stps = j < pCnt ? wlen * 2 - 1 : 1;
+    for ( int s = 0; s < stps; s++ )
+    {
+      wchar_t wpfx[100];
+      int plen = j >= pCnt ? wlen : s < wlen ? s + 1 : wlen * 2 - 1 - s;
+      wmemcpy (wpfx, wqry, plen);
+      wpfx[plen] = 0;
+      char pfx[400];
+      wcstombs (pfx, wpfx, 400);
+      BS_DO_E_OUT (ssWrds = bsdifdwds_new (BS_IDX_100))
+      BS_DO_E_OUT (wrds = bsdifdwds_new (BS_IDX_100))
+      BS_DO_E_OUT (bsdiixssn_find (ssn, ssWrds, pfx))
+      if ( pIsIxRm )
+      {
+        BS_DO_E_OUT (bsdiixtxrmfind_mtfz ((BsDiIxTxRm*) pDiIx, wrds, pfx))
+      } else {
+        BS_DO_E_OUT (bsdiixtxfind_mtfz ((BsDiIxTx*) pDiIx, wrds, pfx))
+      }
+      BS_DO_E_OUT (sf_fdwds_same (ssWrds, wrds, pfx))
+      stpsSz++;
+      fdsSz += wrds->size;
+      ssWrds = bsdifdwds_free (ssWrds);
+      wrds = bsdifdwds_free (wrds);
+    }
+  }
+  bslog_log (BSLONLYMSG, "Session %s RAM=%d steps=%d found=%d\n", pDiIx->head->nme->val, pIsIxRm, stpsSz, fdsSz);
+out:
+  bsdifdwds_free (ssWrds);
+  bsdifdwds_free (wrds);
+  bsdiixssn_free (ssn);
+}
+
+/**
+ * <p>As-you-type finding session with IDX mapped, in file and in RAM.
+ * Generated dictionary has all words of 1..4 letters "a".."d", and every
+ * 5-th one is also with the next one, so IRT words are prefixes of others.</p>
+ **/
+static void sf_test_ssn() {
+  char *pths[] = { "tst_dic4.dsl", "tst_dic1.dsl", "tst_ftiskp.dsl", "tst_ssn.dsl" };
+  char *qrys4[] = { "common sense", "sendx", "humor", "sne", "se", "zzz" };
+  char *qrys1[] = { "ящур", "валяние", "бюл" };
+  char *qrysSkp[] = { "wabz", "wbmz", "wzz", "every" };
+  char *qrysSsn[] = { "abcd", "abca", "dcbax", "aaaa", "bb da", "cab", "dddd" };
+  char **qrys[] = { qrys4, qrys1, qrysSkp, qrysSsn };
+  int cnts[] = { 6, 3, 4, 7 };
+  BsDiIxTx *diIx = NULL;
+  BsDiIxTxRm *diIxRm = NULL;
+  BsDiIxMm *mm = NULL;
+  FILE *fl = fopen (pths[3], "w");
+  BS_IF_EN_RET (fl == NULL, BSE_OPEN_FILE)
+  fprintf (fl, "#NAME \"Session\"\n#INDEX_LANGUAGE \"English\"\n#CONTENTS_LANGUAGE \"English\"\n\n");
+  char wrd[5], prv[5] = "";
+  for ( int i = 0; i < 4 + 16 + 64 + 256; i++ ) {
+    int len = i < 4 ? 1 : i < 20 ? 2 : i < 84 ? 3 : 4;
+    int n = i - ( len == 1 ? 0 : len == 2 ? 4 : len == 3 ? 20 : 84 );
+    for ( int k = len - 1; k >= 0; k--, n /= 4 )
+          { wrd[k] = 'a' + n % 4; }
+    wrd[len] = 0;
+    if ( i % 5 == 0 && prv[0] != 0 ) {
+      fprintf (fl, "%s %s\n", prv, wrd);
+    }
+    fprintf (fl, "%s\n\t[m1]word %d[/m]\n", wrd, i);
+    strcpy (prv, wrd);
+  }
+  fclose (fl);
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  for ( int j = 0; j < (int) ( sizeof (pths) / sizeof (pths[0]) ); j++ )
+  {
+    BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (pths[j], opSt, false))
+    BS_IF_ENM_OUT (diIx == NULL || diIx->mm == NULL, BSE_TEST_ERR, "IDX v2 isn't mapped!\n")
+    BS_DO_E_OUT (sf_ssn ((BsDiIxBs*) diIx, false, qrys[j], cnts[j]))
+    mm = diIx->mm; diIx->mm = NULL;
+    BS_DO_E_OUT (sf_ssn ((BsDiIxBs*) diIx, false, qrys[j], cnts[j]))
+    diIx->mm = mm; mm = NULL;
+    diIx = bsdiixtx_destroy (diIx);
+    BS_DO_E_OUT (diIxRm = bsdiixtxrm_load (pths[j]))
+    BS_IF_ENM_OUT (diIxRm == NULL, BSE_TEST_ERR, "Can't load IDX RAM!\n")
+    BS_DO_E_OUT (sf_ssn ((BsDiIxBs*) diIxRm, true, qrys[j], cnts[j]))
+    diIxRm = bsdiixtxrm_destroy (diIxRm);
+  }
+out:
+  if ( mm != NULL )
+        { diIx->mm = mm; }
+  bsdiixtx_destroy (diIx);
+  bsdiixtxrm_destroy (diIxRm);
+  bsdiixost_free (opSt);
+}
+
 int main(int argc, char *argv[]) {
   setlocale(LC_ALL, ""); //it set to default system locale, e.g. en_US.UTF-8
   BS_DO_E_GOTO(BsLogFiles *bslf=bslogfiles_new(1), outlog)
@@ -166,11 +1507,26 @@ outlog:
   bslog_set_debug_ceiling(BS_DEBUGL_DICIDXFIND);
   BS_DO_E_OUT(sf_test1())
   BS_DO_E_OUT(sf_test2())
-  sf_test3();
+  BS_DO_E_OUT(sf_test3())
+  BS_DO_E_OUT(sf_test_hirtlk())
+  BS_DO_E_OUT(sf_test_irtez())
+  BS_DO_E_OUT(sf_test_irtsm())
+  BS_DO_E_OUT(sf_test_fst_mk())
+  BS_DO_E_OUT(sf_test_fst())
+  BS_DO_E_OUT(sf_test_fz_mk())
+  BS_DO_E_OUT(sf_test_fz())
+  BS_DO_E_OUT(sf_test_sa_mk())
+  BS_DO_E_OUT(sf_test_sa())
+  BS_DO_E_OUT(sf_test_fti())
+  BS_DO_E_OUT(sf_test_fti_skp())
+  BS_DO_E_OUT(sf_test_ssn())
+  BS_DO_E_OUT(sf_test4())
+  sf_test_mm_crpt();
 out:
   if (errno != 0) {
     BSLOG_ERR
   }
+  sf_rm_idx2();
   bsdiixtxrm_destroy(sDiIxRm);
   bslog_destroy();
   return errno;
@@ -12,9 +12,15 @@ See the LICENSE in the root source folder */
 #include "string.h"
 #include "stdlib.h"
 #include "locale.h"
+#include "wchar.h"
+#include "time.h"
 
 #include "BsFatalLog.h"
 #include "BsError.h"
+#include "BsFioWrap.h"
+#include "BsDicIwrdsMt.h"
+#include "BsDiIxMm.h"
+#include "BsDiIxHwp.h"
 #include "BsDiIxFind.h"
 
 static void sf_prn_idx(BsDiIxTxRm *pDiIxRm, BS_IDX_T p_irt_st, BS_IDX_T p_irt_end) {
@@ -42,21 +48,440 @@ static void sf_prn_idx(BsDiIxTxRm *pDiIxRm, BS_IDX_T p_irt_st, BS_IDX_T p_irt_en
     }
   }
   for (l = p_irt_st; l < p_irt_end; l++) {
-    bsdicidxab_istr_to_wstr(pDiIxRm->irt[l]->idx_subwrd, wstr, pDiIxRm->head->ab);
-    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" %ls dwolt_start="BS_IDX_FMT" i2wpt_quantity=%d i2wpt_start="BS_IDX_FMT"\n", l, wstr, pDiIxRm->irt[l]->dwolt_start, pDiIxRm->irt[l]->i2wpt_quantity, pDiIxRm->irt[l]->i2wpt_start);
+    bsdicidxab_istr_to_wstr(BDI_RM_IRTWRD(pDiIxRm, l), wstr, pDiIxRm->head->ab);
+    bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" %ls dwolt_start="BS_IDX_FMT" i2wpt_quantity=%d i2wpt_start="BS_IDX_FMT"\n", l, wstr, BDI_RM_DWST(pDiIxRm, l), pDiIxRm->irtI2Qns[l], BDI_RM_I2ST(pDiIxRm, l));
   }
   if (pDiIxRm->head->irtSz < 500L) {
     bslog_log(BSLONLYMSG, "  i2wpt:\n", pDiIxRm);
     for (l = BS_IDX_0; l < pDiIxRm->head->i2wptSz; l++) {
-      bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" = "BS_IDX_FMT"\n", l, pDiIxRm->i2wpt[l]);
+      bslog_log(BSLONLYMSG, "    #"BS_IDX_FMT" = "BS_IDX_FMT"\n", l, BDI_RM_I2WPT(pDiIxRm, l));
     }
     bslog_log(BSLONLYMSG, "  dwolt:\n", pDiIxRm);
     for (l = BS_IDX_0; l < pDiIxRm->head->dwoltSz; l++) {
-      bslog_log(BSLONLYMSG, "    #%ld ofst=%ld len=%d\n", l, pDiIxRm->dwolt[l]->offset_dword, pDiIxRm->dwolt[l]->length_dword);
+      bslog_log(BSLONLYMSG, "    #%ld ofst=%ld len=%d\n", l, BDI_RM_DWOFS(pDiIxRm, l), pDiIxRm->dwoltLens[l]);
     }
   }
 }
 
+static double sf_secs(struct timespec *pStt) {
+  struct timespec en;
+  clock_gettime(CLOCK_MONOTONIC, &en);
+  return (en.tv_sec - pStt->tv_sec) + (en.tv_nsec - pStt->tv_nsec) / 1e9;
+}
+
+/**
+ * <p>Reference loader that reads IDX tables field by field
+ * as bsdiixtxrm_load did before bulk reading.</p>
+ **/
+static BsDiIxTxRm *sf_load_flds(char *pPth) {
+  FILE *dicFl = NULL;
+  FILE *idxFl = NULL;
+  BsDiIxHeadTx *head = NULL;
+  BsDiIxTxRm *idx_ram = NULL;
+  BS_DO_E_RETN(bsdiixheadtx_load(pPth, &head, &dicFl, &idxFl))
+  BS_IF_ENM_RETN(head == NULL, BSE_TEST_ERR, "there is no IDX\n")
+  BS_DO_E_OUT(idx_ram = bsdiixtxrm_new(dicFl, head))
+  BS_IDX_T l, idx, wrdsSz = BS_IDX_0;
+  BS_FOFST_T ofst;
+  unsigned char iwsz;
+  int i;
+  for (l = BS_IDX_0; l < head->irtSz; l++) {
+    if (head->mxIrWdSz > 0) {
+      iwsz = head->mxIrWdSz;
+    } else {
+      BS_DO_E_OUT(bsfread_uchar(&iwsz, idxFl))
+    }
+    BDI_RM_SET_IRTWOFS(idx_ram, l, wrdsSz);
+    BS_DO_E_OUT(bsfread_bschars(idx_ram->irtWrds + wrdsSz, iwsz, idxFl))
+    for (i = 0; i < iwsz && idx_ram->irtWrds[wrdsSz + i] != 0; i++) ;
+    idx_ram->irtWrds[wrdsSz + i] = 0;
+    wrdsSz += i + 1;
+    BS_DO_E_OUT(bsdiixtx_read_idx(&idx, head->flgs, idxFl))
+    BDI_RM_SET_IDX(idx_ram, idx_ram->irtDwSts, l, idx);
+    BS_DO_E_OUT(bsfread_bssmall(&idx_ram->irtI2Qns[l], idxFl))
+    BS_DO_E_OUT(bsdiixtx_read_idx(&idx, head->flgs, idxFl))
+    BDI_RM_SET_IDX(idx_ram, idx_ram->irtI2Sts, l, idx);
+  }
+  for (l = BS_IDX_0; l < head->i2wptSz; l++) {
+    BS_DO_E_OUT(bsdiixtx_read_idx(&idx, head->flgs, idxFl))
+    BDI_RM_SET_IDX(idx_ram, idx_ram->i2wpt, l, idx);
+  }
+  for (l = BS_IDX_0; l < head->dwoltSz; l++) {
+    BS_DO_E_OUT(bsdiixtx_read_ofst(&ofst, head->flgs, idxFl))
+    BDI_RM_SET_DWOFS(idx_ram, l, ofst);
+    BS_DO_E_OUT(bsfread_bssmall(&idx_ram->dwoltLens[l], idxFl))
+  }
+  BS_DO_E_OUT(idx_ram->hwp = bsdiixhwp_load(idxFl, ftell(idxFl), head->dwoltSz))
+out:
+  fclose(idxFl);
+  if (errno != 0) {
+    if (idx_ram != NULL) {
+      bsdiixtxrm_destroy(idx_ram);
+    } else {
+      bsdiixheadtx_free(head);
+      fclose(dicFl);
+    }
+    return NULL;
+  }
+  return idx_ram;
+}
+
+/**
+ * <p>Benchmark IDX loading by big reads against field by field one,
+ * loaded tables must be same.</p>
+ **/
+static void sf_bench_load(char *pPth) {
+  struct timespec stt;
+  BsDiIxTxRm *idx_flds = NULL;
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  BS_DO_E_RET(BsDiIxTxRm *idx_ram = bsdiixtxrm_load(pPth))
+  double secs = sf_secs(&stt);
+  BS_IF_ENM_OUT(idx_ram == NULL, BSE_TEST_ERR, "there is no IDX\n")
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  BS_DO_E_OUT(idx_flds = sf_load_flds(pPth))
+  bslog_log(BSLTEST, "IDX irtSz="BS_IDX_FMT" i2wptSz="BS_IDX_FMT" dwoltSz="BS_IDX_FMT", load by chunks=%.4f sec, field by field=%.4f sec\n",
+    idx_ram->head->irtSz, idx_ram->head->i2wptSz, idx_ram->head->dwoltSz, secs, sf_secs(&stt));
+  for (BS_IDX_T l = BS_IDX_0; l < idx_ram->head->irtSz; l++) {
+    BS_IF_ENM_OUT(bsdicidx_istr_cmp(BDI_RM_IRTWRD(idx_ram, l), BDI_RM_IRTWRD(idx_flds, l)) != 0
+      || BDI_RM_DWST(idx_ram, l) != BDI_RM_DWST(idx_flds, l) || idx_ram->irtI2Qns[l] != idx_flds->irtI2Qns[l]
+      || BDI_RM_I2ST(idx_ram, l) != BDI_RM_I2ST(idx_flds, l), BSE_TEST_ERR, "IRT differs\n")
+  }
+  for (BS_IDX_T l = BS_IDX_0; l < idx_ram->head->i2wptSz; l++) {
+    BS_IF_ENM_OUT(BDI_RM_I2WPT(idx_ram, l) != BDI_RM_I2WPT(idx_flds, l), BSE_TEST_ERR, "I2WPT differs\n")
+  }
+  for (BS_IDX_T l = BS_IDX_0; l < idx_ram->head->dwoltSz; l++) {
+    BS_IF_ENM_OUT(BDI_RM_DWOFS(idx_ram, l) != BDI_RM_DWOFS(idx_flds, l)
+      || idx_ram->dwoltLens[l] != idx_flds->dwoltLens[l], BSE_TEST_ERR, "DWOLT differs\n")
+  }
+out:
+  bsdiixtxrm_destroy(idx_flds);
+  bsdiixtxrm_destroy(idx_ram);
+}
+
+/**
+ * <p>Benchmark finding IRT index with IRTEZ against binary search
+ * on generated IRT without HIRT range, found indexes must be same.</p>
+ * @param pSz - IRT size
+ **/
+static void sf_bench_irtez(BS_IDX_T pSz) {
+  struct timespec stt;
+  BsDiIxTxRm rm;
+  memset(&rm, 0, sizeof(rm));
+  int qtyBs = (int) (1000000000L / pSz), qtyEz = 1000000;
+  BS_IDX_T *idxs = NULL, l, sum = BS_IDX_0;
+  BS_CHAR_T iwrd[3] = { 0, 1, 0 };
+  rm.irtWrds = malloc(pSz * 3 * BS_CHAR_LEN);
+  rm.irtWrdOfsts = malloc(pSz * BS_IDX_LEN);
+  idxs = malloc(qtyBs * BS_IDX_LEN);
+  BS_IF_EN_OUT(rm.irtWrds == NULL || rm.irtWrdOfsts == NULL || idxs == NULL, ENOMEM)
+  //sorted words of 30 first and 30 second chars:
+  for (l = BS_IDX_0; l < pSz; l++) {
+    long pair = l * 900L / pSz;
+    BDI_RM_SET_IRTWOFS(&rm, l, l * 3);
+    rm.irtWrds[l * 3] = 1 + pair / 30;
+    rm.irtWrds[l * 3 + 1] = 1 + pair % 30;
+    rm.irtWrds[l * 3 + 2] = 0;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  BS_DO_E_OUT(rm.irtEz = bsdiixirtez_new(&rm, pSz))
+  double secsMk = sf_secs(&stt);
+  BS_IF_ENM_OUT(rm.irtEz == NULL, BSE_TEST_ERR, "IRTEZ isn't made!\n")
+  srand(1);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < qtyEz; i++) {
+    iwrd[0] = 1 + rand() % 31;
+    sum += bsdiixrmfindtst_irtix(&rm, iwrd, BS_IDX_0, pSz - BS_IDX_1);
+  }
+  double secsEz = sf_secs(&stt);
+  BsDiIxIrtEz *irtEz = rm.irtEz;
+  rm.irtEz = NULL;
+  srand(2);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < qtyBs; i++) {
+    iwrd[0] = 1 + rand() % 31;
+    idxs[i] = bsdiixrmfindtst_irtix(&rm, iwrd, BS_IDX_0, pSz - BS_IDX_1);
+  }
+  double secsBs = sf_secs(&stt);
+  rm.irtEz = irtEz;
+  srand(2);
+  for (int i = 0; i < qtyBs; i++) {
+    iwrd[0] = 1 + rand() % 31;
+    BS_IF_ENM_OUT(idxs[i] != bsdiixrmfindtst_irtix(&rm, iwrd, BS_IDX_0, pSz - BS_IDX_1),
+      BSE_TEST_ERR, "IRTEZ index differs\n")
+  }
+  bslog_log(BSLTEST, "IRT size="BS_IDX_FMT" IRTEZ made=%.4f sec, find IRTEZ=%.1f ns, binary search=%.1f ns (%ld)\n",
+    pSz, secsMk, secsEz * 1e9 / qtyEz, secsBs * 1e9 / qtyBs, (long) sum);
+out:
+  bsdiixirtez_free(rm.irtEz);
+  free(rm.irtWrds);
+  free(rm.irtWrdOfsts);
+  free(idxs);
+}
+
+/**
+ * <p>Benchmark FST's size against IRT's one and completing prefix
+ * by FST against matching by IRT.</p>
+ * @param pPth - dictionary path
+ * @param pPrfx - prefix
+ **/
+static void sf_bench_fst(char *pPth, char *pPrfx) {
+  struct timespec stt;
+  int rpts = 1000, prSz = 0, mtSz = 0;
+  BsDiFdWds *dicWrds = NULL;
+  BS_DO_E_RET(BsDiIxTxRm *idx_ram = bsdiixtxrm_load(pPth))
+  BS_IF_ENM_OUT(idx_ram == NULL || idx_ram->fst == NULL, BSE_TEST_ERR, "there is no IDX with FST\n")
+  long irtSz = idx_ram->head->irtSz * BDI_IRTRD_FIXED_SIZE(idx_ram->head->mxIrWdSz, idx_ram->head->flgs)
+    + idx_ram->head->i2wptSz * BDI_I2WPTRD_SIZE(idx_ram->head->flgs);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < rpts; i++) {
+    BS_DO_E_OUT(dicWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT(bsdiixtxrmfind_prfx (idx_ram, dicWrds, pPrfx))
+    prSz = dicWrds->size;
+    dicWrds = bsdifdwds_free (dicWrds);
+  }
+  double prSecs = sf_secs(&stt);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < rpts; i++) {
+    BS_DO_E_OUT(dicWrds = bsdifdwds_new (BS_IDX_100))
+    BS_DO_E_OUT(bsdiixtxrmfind_mtch (idx_ram, dicWrds, pPrfx))
+    mtSz = dicWrds->size;
+    dicWrds = bsdifdwds_free (dicWrds);
+  }
+  bslog_log(BSLTEST, "FST size=%ld (DWOLT words="BS_IDX_FMT"), IRT with I2WPT size=%ld; %dx '%s' completed=%d %.4f sec, matched=%d %.4f sec\n",
+    (long) BDI_FST_SZ(idx_ram->fst), idx_ram->head->dwoltSz, irtSz, rpts, pPrfx, prSz, prSecs, mtSz, sf_secs(&stt));
+out:
+  bsdifdwds_free (dicWrds);
+  bsdiixtxrm_destroy(idx_ram);
+}
+
+//per keystroke latency of typo tolerant finding, i.e. every prefix of the
+//given word with swapped 2-nd and 3-d chars (if they are ASCII):
+static void sf_bench_fz(char *pPth, char *pWrd) {
+  struct timespec stt;
+  int len = strlen(pWrd), fzSz = 0;
+  double secs, mxSecs = 0.0, allSecs = 0.0;
+  char typo[len + 1];
+  BsDiFdWds *dicWrds = NULL;
+  strcpy(typo, pWrd);
+  if (len > 2 && (unsigned char) typo[1] < 0x80 && (unsigned char) typo[2] < 0x80) {
+    typo[1] = pWrd[2]; typo[2] = pWrd[1];
+  }
+  BS_DO_E_RET(BsDiIxTxRm *idx_ram = bsdiixtxrm_load(pPth))
+  BS_IF_ENM_OUT(idx_ram == NULL || idx_ram->fst == NULL, BSE_TEST_ERR, "there is no IDX with FST\n")
+  for (int l = 1; l <= len; l++) {
+    char c = typo[l];
+    typo[l] = 0;
+    BS_DO_E_OUT(dicWrds = bsdifdwds_new (BS_IDX_100))
+    clock_gettime(CLOCK_MONOTONIC, &stt);
+    BS_DO_E_OUT(bsdiixtxrmfind_mtfz (idx_ram, dicWrds, typo))
+    secs = sf_secs(&stt);
+    allSecs += secs;
+    if (secs > mxSecs) { mxSecs = secs; }
+    fzSz = dicWrds->size;
+    bslog_log(BSLTEST, "typo '%s' found=%d %.5f sec%s%s\n", typo, fzSz, secs,
+      fzSz > 0 ? ", the first " : "", fzSz > 0 ? dicWrds->vals[0]->wrd->val : "");
+    dicWrds = bsdifdwds_free (dicWrds);
+    typo[l] = c;
+  }
+  bslog_log(BSLTEST, "%d keystrokes of '%s' total %.4f sec, max %.5f sec\n", len, typo, allSecs, mxSecs);
+out:
+  bsdifdwds_free (dicWrds);
+  bsdiixtxrm_destroy(idx_ram);
+}
+
+/**
+ * <p>Benchmark SA making from loaded SA words (it must be same) and finding
+ * by infixes of given word by SA against brute force scanning of words.</p>
+ * @param pPth - dictionary path
+ * @param pWrd - word which suffixes are infixes
+ **/
+static void sf_bench_sa(char *pPth, char *pWrd) {
+  struct timespec stt;
+  int rpts = 100, len = strlen(pWrd), saSz = 0, bfSz;
+  char *sa = NULL;
+  BsDicIwrds *iwrds = NULL;
+  BsDiFdWds *dicWrds = NULL;
+  BS_DO_E_RET(BsDiIxTxRm *idx_ram = bsdiixtxrm_load(pPth))
+  BS_IF_ENM_OUT(idx_ram == NULL || idx_ram->sa == NULL, BSE_TEST_ERR, "there is no IDX with SA\n")
+  BS_IDX_T cnt = BDI_SA_CNT(idx_ram->sa);
+  const BS_CHAR_T *txt = BDI_SA_TXT(idx_ram->sa);
+  const uint32_t *stts = BDI_SA_STTS(idx_ram->sa);
+  BS_DO_E_OUT(iwrds = bsdiciwrds_new(cnt, idx_ram->head->ab))
+  for (BS_IDX_T l = BS_IDX_0; l < cnt; l++) {
+    BS_DO_E_OUT(bsdiciwrds_add_inc(iwrds, bsdiciwrdrd_new((BS_CHAR_T*) txt + stts[l], BS_FOFST_0, 1)))
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  BS_DO_E_OUT(sa = bsdiixsa_new(iwrds))
+  bslog_log(BSLTEST, "SA size=%ld (DWOLT words="BS_IDX_FMT", suffixes=%ld) made %.4f sec\n",
+    (long) BDI_SA_SZ(sa), cnt, (long) BDI_SA_SFXSZ(sa), sf_secs(&stt));
+  BS_IF_ENM_OUT(BDI_SA_SZ(sa) != BDI_SA_SZ(idx_ram->sa) || memcmp(sa, idx_ram->sa, BDI_SA_SZ(sa)) != 0,
+    BSE_TEST_ERR, "SA made again differs\n")
+  for (int k = 1; k < len - 1; k++) {
+    char *infx = pWrd + k;
+    if ((unsigned char) infx[0] >= 0x80) { continue; }
+    clock_gettime(CLOCK_MONOTONIC, &stt);
+    for (int i = 0; i < rpts; i++) {
+      BS_DO_E_OUT(dicWrds = bsdifdwds_new (BS_IDX_100))
+      BS_DO_E_OUT(bsdiixtxrmfind_infx (idx_ram, dicWrds, infx))
+      saSz = dicWrds->size;
+      dicWrds = bsdifdwds_free (dicWrds);
+    }
+    double saSecs = sf_secs(&stt);
+    BS_CHAR_T iinfx[len + 1];
+    BS_DO_E_OUT(bsdicidxab_str_to_istr(infx, iinfx, idx_ram->head->ab))
+    int ilen = bsdicidx_istr_len(iinfx);
+    clock_gettime(CLOCK_MONOTONIC, &stt);
+    for (int i = 0; i < rpts; i++) {
+      bfSz = 0;
+      for (BS_IDX_T l = BS_IDX_0; l < cnt; l++) {
+        for (const BS_CHAR_T *c = txt + stts[l]; *c != 0; c++) {
+          if (memcmp(c, iinfx, ilen * BS_CHAR_LEN) == 0) { bfSz++; break; }
+        }
+      }
+    }
+    bslog_log(BSLTEST, "%dx infix '%s' SA found=%d %.5f sec, brute force found=%d %.5f sec\n",
+      rpts, infx, saSz, saSecs, bfSz, sf_secs(&stt));
+  }
+out:
+  free(sa);
+  bsdiciwrds_free(iwrds);
+  bsdifdwds_free (dicWrds);
+  bsdiixtxrm_destroy(idx_ram);
+}
+
+//FTI making by 1 and all processors, then AND and phrase finding
+//against brute force scanning of whole dictionary for the query:
+static void sf_bench_fti(char *pPth, char *pQry) {
+  struct timespec stt;
+  int rpts = 100, andSz = 0, phrSz = 0, thrdsCnt, bfSz = 0;
+  BsDiIxTx *diIx = NULL;
+  BsDiIxFti *fti = NULL;
+  BsDicDslMm *dslMm = NULL;
+  BS_IDX_T idxs[1000];
+  BS_DO_E_RET(BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT(diIx = (BsDiIxTx*) bsdiixtx_open (pPth, opSt, false))
+  BS_IF_ENM_OUT(diIx == NULL, BSE_TEST_ERR, "there is no IDX\n")
+  BS_DO_E_OUT(dslMm = bsdicdslmm_new (diIx->dicFl))
+  thrdsCnt = bsdiciwrdsmt_thrds_cnt (dslMm);
+  for (int t = 1; t <= thrdsCnt; t += thrdsCnt > 1 ? thrdsCnt - 1 : 1) {
+    clock_gettime(CLOCK_MONOTONIC, &stt);
+    BS_DO_E_OUT(bsdiixfti_save (diIx, pPth, t))
+    bslog_log(BSLTEST, "FTI of dictionary size=%ld made by %d threads %.4f sec\n",
+      (long) dslMm->sz, t, sf_secs(&stt));
+  }
+  BS_DO_E_OUT(fti = bsdiixfti_load (diIx, pPth))
+  BS_IF_ENM_OUT(fti == NULL, BSE_TEST_ERR, "there is no FTI\n")
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < rpts; i++) {
+    BS_DO_E_OUT(andSz = bsdiixfti_find (fti, diIx->head->ab, pQry, false, idxs, 1000))
+  }
+  double andSecs = sf_secs(&stt);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < rpts; i++) {
+    BS_DO_E_OUT(phrSz = bsdiixfti_find (fti, diIx->head->ab, pQry, true, idxs, 1000))
+  }
+  double phrSecs = sf_secs(&stt);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  int len = strlen (pQry);
+  for (char *c = dslMm->dt; c + len <= dslMm->dt + dslMm->sz; c++) {
+    if (*c == *pQry && memcmp (c, pQry, len) == 0) { bfSz++; }
+  }
+  bslog_log(BSLTEST, "FTI size=%zu documents="BS_IDX_FMT" terms="BS_IDX_FMT"; %dx '%s' AND found=%d %.5f sec, phrase found=%d %.5f sec; brute force found=%d %.5f sec\n",
+    fti->sz, fti->docsSz, fti->trmsSz, rpts, pQry, andSz, andSecs, phrSz, phrSecs, bfSz, sf_secs(&stt));
+out:
+  bsdicdslmm_free (dslMm);
+  bsdiixfti_free (fti);
+  bsdiixtx_destroy (diIx);
+  bsdiixost_free (opSt);
+}
+
+//per keystroke latency of finding from scratch against session's one while
+//typing then deleting every char of given queries, found words must be same:
+static void sf_ssn_keys(BsDiIxBs *pDiIx, bool pIsIxRm, char **pQrys, int pCnt, char *pMd) {
+  struct timespec stt;
+  double secs, mxSecs = 0.0, allSecs = 0.0, ssMxSecs = 0.0, ssAllSecs = 0.0;
+  int keys = 0;
+  BsDiFdWds *dicWrds = NULL, *ssWrds = NULL;
+  BS_DO_E_RET(BsDiIxSsn *ssn = bsdiixssn_new (pDiIx, pIsIxRm))
+  for (int j = 0; j < pCnt; j++) {
+    wchar_t wqry[200], wpfx[200];
+    char pfx[800];
+    int wlen = mbstowcs(wqry, pQrys[j], 200);
+    for (int s = 0; s < wlen * 2 - 1; s++, keys++) {
+      int plen = s < wlen ? s + 1 : wlen * 2 - 1 - s;
+      wmemcpy(wpfx, wqry, plen);
+      wpfx[plen] = 0;
+      wcstombs(pfx, wpfx, 800);
+      BS_DO_E_OUT(dicWrds = bsdifdwds_new (BS_IDX_100))
+      BS_DO_E_OUT(ssWrds = bsdifdwds_new (BS_IDX_100))
+      clock_gettime(CLOCK_MONOTONIC, &stt);
+      if (pIsIxRm) {
+        BS_DO_E_OUT(bsdiixtxrmfind_mtfz ((BsDiIxTxRm*) pDiIx, dicWrds, pfx))
+      } else {
+        BS_DO_E_OUT(bsdiixtxfind_mtfz ((BsDiIxTx*) pDiIx, dicWrds, pfx))
+      }
+      secs = sf_secs(&stt);
+      allSecs += secs;
+      if (secs > mxSecs) { mxSecs = secs; }
+      clock_gettime(CLOCK_MONOTONIC, &stt);
+      BS_DO_E_OUT(bsdiixssn_find (ssn, ssWrds, pfx))
+      secs = sf_secs(&stt);
+      ssAllSecs += secs;
+      if (secs > ssMxSecs) { ssMxSecs = secs; }
+      bool isSm = dicWrds->size == ssWrds->size;
+      for (int i = 0; isSm && i < dicWrds->size; i++) {
+        isSm = strcmp(dicWrds->vals[i]->wrd->val, ssWrds->vals[i]->wrd->val) == 0
+          && dicWrds->vals[i]->dicOfsts->size == ssWrds->vals[i]->dicOfsts->size;
+      }
+      BS_IF_ENM_OUT(!isSm, BSE_TEST_ERR, "Session found differs!\n")
+      dicWrds = bsdifdwds_free (dicWrds);
+      ssWrds = bsdifdwds_free (ssWrds);
+    }
+  }
+  bslog_log(BSLTEST, "%s %d keystrokes from scratch total %.4f sec, max %.5f sec; session total %.4f sec, max %.5f sec\n",
+    pMd, keys, allSecs, mxSecs, ssAllSecs, ssMxSecs);
+out:
+  bsdifdwds_free (dicWrds);
+  bsdifdwds_free (ssWrds);
+  bsdiixssn_free (ssn);
+}
+
+//as-you-type session against finding from scratch in IDX file without
+//mapped IDX v2 (as on slow storage), mapped one and in RAM, queries are
+//given word and every 50-th part of HWP words:
+static void sf_bench_ssn(char *pPth, char *pWrd) {
+  int cnt = 51;
+  char *qrys[cnt];
+  BsDiIxTx *diIx = NULL;
+  BsDiIxMm *mm = NULL;
+  BsDiIxOst *opSt = NULL;
+  BS_DO_E_RET(BsDiIxTxRm *diIxRm = bsdiixtxrm_load (pPth))
+  BS_IF_ENM_OUT(diIxRm == NULL || diIxRm->hwp == NULL, BSE_TEST_ERR, "there is no IDX with HWP\n")
+  qrys[0] = pWrd;
+  for (int j = 1; j < cnt; j++) {
+    qrys[j] = BDI_HWP_MBS (BDI_HWP_RD (diIxRm->hwp, diIxRm->head->dwoltSz / cnt * j));
+  }
+  BS_DO_E_OUT(opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT(diIx = (BsDiIxTx*) bsdiixtx_open (pPth, opSt, false))
+  BS_IF_ENM_OUT(diIx == NULL, BSE_TEST_ERR, "there is no IDX\n")
+  mm = diIx->mm; diIx->mm = NULL;
+  BS_DO_E_OUT(sf_ssn_keys ((BsDiIxBs*) diIx, false, qrys, cnt, "IDX file"))
+  diIx->mm = mm; mm = NULL;
+  if (diIx->mm != NULL) {
+    BS_DO_E_OUT(sf_ssn_keys ((BsDiIxBs*) diIx, false, qrys, cnt, "IDX v2"))
+  }
+  BS_DO_E_OUT(sf_ssn_keys ((BsDiIxBs*) diIxRm, true, qrys, cnt, "IDX RAM"))
+out:
+  if (mm != NULL) { diIx->mm = mm; }
+  bsdiixtx_destroy (diIx);
+  bsdiixost_free (opSt);
+  bsdiixtxrm_destroy (diIxRm);
+}
+
 static void sf_test1(int argc, char *argv[]) {
   BSDICIDXRAM_OPEN_E_RET (idx_ram, argv[1])
   BsDiIxOst *opSt = NULL;
@@ -64,6 +489,8 @@ static void sf_test1(int argc, char *argv[]) {
   if (idx_ram == NULL) {
     bslog_log(BSLTEST, "Try to create IDX for%s\n", argv[1]);
     BS_DO_E_OUT(opSt = bsdiixost_new ())
+    opSt->isFst = true;
+    opSt->isSa = true;
     BS_DO_E_OUT(idx_ram = bsdiixtxrm_create(argv[1], opSt))
     BS_DO_E_OUT(bsdiixtxrm_validate(idx_ram))
     BS_DO_E_OUT(bsdiixtxrm_save(idx_ram, argv[1]))
@@ -108,9 +535,36 @@ outlog:
   bslog_set_debug_floor(BS_DEBUGL_DICIDXFIND);
   bslog_set_debug_ceiling(BS_DEBUGL_DICIDXFIND);
   sf_test1(argc, argv);
+  if (errno == 0) {
+    sf_bench_load(argv[1]);
+  }
+  if (errno == 0) {
+    sf_bench_fst(argv[1], argv[2]);
+  }
+  if (errno == 0) {
+    sf_bench_fz(argv[1], argv[2]);
+  }
+  if (errno == 0) {
+    sf_bench_sa(argv[1], argv[2]);
+  }
+  if (errno == 0) {
+    sf_bench_ssn(argv[1], argv[2]);
+  }
+  if (errno == 0) {
+    sf_bench_fti(argv[1], argc > 3 ? argv[3] : argv[2]);
+  }
+  for (BS_IDX_T l = 100000L; errno == 0 && l <= 10000000L; l *= 10L) {
+    sf_bench_irtez(l);
+  }
   if (errno != 0) {
     BSLOG_ERR
   }
+  //generated IDX v2 is removed, IDX is kept for further runs:
+  int rz = errno;
+  char pth[strlen(argv[1]) + 10];
+  strcpy(pth, argv[1]);
+  strcat(pth, BDI_IDXMM_FILE_EXT);
+  remove(pth);
   bslog_destroy();
-  return errno;
+  return rz;
 }
@@ -12,9 +12,11 @@ See the LICENSE in the root source folder */
 #include "string.h"
 #include "stdlib.h"
 #include "locale.h"
+#include "time.h"
 
 #include "BsFatalLog.h"
 #include "BsError.h"
+#include "BsDiIxMm.h"
 #include "BsDiIxFind.h"
 
 static void sf_prn_idx(BsDiIxTx *pDiIx) {
@@ -33,6 +35,8 @@ static void sf_prn_idx(BsDiIxTx *pDiIx) {
 
 static void sf_test1(int argc, char *argv[]) {
   BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
   BS_DO_E_OUT (BsDiFdWds *dicWrds = bsdifdwds_new (BS_IDX_100))
   BS_DO_E_OUT (BsDiIxTx *diIx = (BsDiIxTx*) bsdiixtx_open (argv[1], opSt, false))
   BS_IF_ENM_OUT (diIx == NULL, BSE_TEST_ERR, "NULL opened without error!\n");
@@ -62,6 +66,74 @@ out:
   bsdiixtx_destroy(diIx);
 }
 
+static double sf_secs(struct timespec *pStt) {
+  struct timespec en;
+  clock_gettime(CLOCK_MONOTONIC, &en);
+  return (en.tv_sec - pStt->tv_sec) + (en.tv_nsec - pStt->tv_nsec) / 1e9;
+}
+
+/**
+ * <p>Benchmark finding IRT record in IDX file with IRTSM against reading
+ * every probe, within HIRT range and whole IRT, found records must be same.</p>
+ **/
+static void sf_bench_irtsm(char *pPth) {
+  struct timespec stt;
+  BsDicFindIrtRd *smRd = NULL, *flRd = NULL;
+  BsDiIxIrtSm *irtSm = NULL;
+  BsDiIxTx *diIx = NULL;
+  BS_CHAR_T iwrd[256]; //IRT word's size is unsigned char
+  double secsSm[2] = { 0.0, 0.0 }, secsFl[2] = { 0.0, 0.0 };
+  int qty = 3000;
+  BS_DO_E_RET (BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->isFst = true;
+  opSt->isSa = true;
+  BS_DO_E_OUT (diIx = (BsDiIxTx*) bsdiixtx_open (pPth, opSt, false))
+  BS_IF_ENM_OUT (diIx == NULL, BSE_TEST_ERR, "NULL opened without error!\n");
+  diIx->mm = bsdiixmm_free (diIx->mm);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  BS_DO_E_OUT (bsdiixtx_mk_irtsm (diIx, BDI_IRTSM_BKSZ))
+  double secsMk = sf_secs(&stt);
+  BS_IF_ENM_OUT (diIx->irtSm == NULL, BSE_TEST_ERR, "IRTSM isn't made!\n");
+  irtSm = diIx->irtSm;
+  int mx = diIx->head->mxIrWdSz;
+  for (int q = 0; q < qty; q++) {
+    //prefix of IRT word:
+    BS_IDX_T l = (q * 7919L) % diIx->head->irtSz;
+    BS_DO_E_OUT (const char *rd = bsdiixtx_irtsm_rd (diIx, l))
+    memcpy (iwrd, rd, mx * BS_CHAR_LEN);
+    iwrd[1 + q % 3 < mx ? 1 + q % 3 : mx] = 0;
+    for (int h = 0; h < 2; h++) {
+      BS_IDX_T st = BS_IDX_0, en = diIx->head->irtSz - BS_IDX_1;
+      if (h == 0) {
+        BS_DO_E_OUT (bsdicidx_find_irtrange ((BsDiIxHeadBs*) diIx->head, iwrd, &st, &en))
+      }
+      diIx->irtSm = irtSm;
+      irtSm->blkIdx = BS_IDX_NULL;
+      clock_gettime(CLOCK_MONOTONIC, &stt);
+      BS_DO_E_OUT (smRd = bsdiixfindtst_irtrd (diIx, iwrd, st, en))
+      secsSm[h] += sf_secs(&stt);
+      diIx->irtSm = NULL;
+      clock_gettime(CLOCK_MONOTONIC, &stt);
+      BS_DO_E_OUT (flRd = bsdiixfindtst_irtrd (diIx, iwrd, st, en))
+      secsFl[h] += sf_secs(&stt);
+      diIx->irtSm = irtSm;
+      BS_IF_ENM_OUT ((smRd == NULL) != (flRd == NULL)
+        || (smRd != NULL && smRd->idx != flRd->idx), BSE_TEST_ERR, "IRTSM record differs\n")
+      smRd = bsdicfindirtrd_free (smRd);
+      flRd = bsdicfindirtrd_free (flRd);
+    }
+  }
+  bslog_log(BSLTEST, "IRT size="BS_IDX_FMT" IRTSM k=%d blocks="BS_IDX_FMT" made=%.4f sec, find in HIRT range IRTSM=%.1f us, file=%.1f us, in whole IRT IRTSM=%.1f us, file=%.1f us\n",
+    diIx->head->irtSz, irtSm->k, irtSm->sz, secsMk, secsSm[0] * 1e6 / qty, secsFl[0] * 1e6 / qty, secsSm[1] * 1e6 / qty, secsFl[1] * 1e6 / qty);
+out:
+  if (diIx != NULL)
+        { diIx->irtSm = irtSm; }
+  bsdicfindirtrd_free (smRd);
+  bsdicfindirtrd_free (flRd);
+  bsdiixost_free (opSt);
+  bsdiixtx_destroy(diIx);
+}
+
 int main(int argc, char *argv[]) {
   if (argc < 3) {
     perror("WRONG params");
@@ -82,9 +154,20 @@ outlog:
   bslog_set_debug_ceiling(BS_DEBUGL_DICIDXFIND + 80);
   //bslog_add_dbgrange(BS_DEBUGL_DICIDXFIND + 70, BS_DEBUGL_DICIDXFIND + 70);
   sf_test1(argc, argv);
+  if (errno == 0) {
+    bslog_set_debug_floor(0);
+    bslog_set_debug_ceiling(0);
+    sf_bench_irtsm(argv[1]);
+  }
   if (errno != 0) {
     BSLOG_ERR
   }
+  //generated IDX v2 is removed, IDX is kept for further runs:
+  int rz = errno;
+  char pth[strlen(argv[1]) + 10];
+  strcpy(pth, argv[1]);
+  strcat(pth, BDI_IDXMM_FILE_EXT);
+  remove(pth);
   bslog_destroy();
-  return errno;
+  return rz;
 }
@@ -12,10 +12,13 @@ See the LICENSE in the root source folder */
 #include "string.h"
 #include "stdlib.h"
 #include "locale.h"
+#include "fcntl.h"
+#include "sys/stat.h"
 
 #include "BsFatalLog.h"
 #include "BsError.h"
-#include "BsDiIxTx.h"
+#include "BsDiIxTxEx.h"
+#include "BsDiIxMm.h"
 
 static void sf_test_idx_data_dic1dsl(BsDiIxTxRm *pDiIxRm) {
   if (pDiIxRm->head->dwoltSz != 3) {
@@ -149,6 +152,369 @@ out:
   bsdiixtxrm_destroy(idx_ram);
 }
 
+/**
+ * <p>Read whole IDX file of given dictionary.</p>
+ * @param pPth - dictionary path
+ * @param pSzRt - pointer to return size
+ * @return content or NULL when error
+ **/
+static char *sf_read_idx(char *pPth, long *pSzRt) {
+  char pth[strlen(pPth) + 10];
+  strcpy(pth, pPth);
+  strcat(pth, BDI_IDX_FILE_EXT);
+  FILE *fl = fopen(pth, "rb");
+  BS_IF_EN_RETN(fl == NULL, BSE_OPEN_FILE)
+  fseek(fl, 0L, SEEK_END);
+  *pSzRt = ftell(fl);
+  rewind(fl);
+  char *rz = malloc(*pSzRt + 1);
+  if (rz == NULL || fread(rz, 1, *pSzRt, fl) != *pSzRt) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Can't read %s\n", pth);
+    free(rz);
+    rz = NULL;
+  }
+  fclose(fl);
+  return rz;
+}
+
+/**
+ * <p>IDX made within memory budget must be same as made in memory.</p>
+ * @param pPth - dictionary path
+ * @param pMemBdgt - memory budget
+ **/
+static void sf_test_ext(char *pPth, size_t pMemBdgt) {
+  char *idxRm = NULL, *idxEx = NULL;
+  long szRm, szEx;
+  BsDiIxTx *diIx = NULL;
+  BS_DO_E_RET(BsDiIxOst *opSt = bsdiixost_new ())
+  BS_DO_E_OUT(BsDiIxTxRm *diIxRm = bsdiixtxrm_create(pPth, opSt))
+  BS_DO_E_OUT(bsdiixtxrm_validate(diIxRm))
+  BS_DO_E_OUT(bsdiixtxrm_save(diIxRm, pPth))
+  bsdiixtxrm_destroy(diIxRm);
+  BS_DO_E_OUT(idxRm = sf_read_idx(pPth, &szRm))
+  opSt->memBdgt = pMemBdgt;
+  BS_DO_E_OUT(diIx = bsdiixtxex_create(pPth, opSt))
+  BS_DO_E_OUT(idxEx = sf_read_idx(pPth, &szEx))
+  if (szRm != szEx || memcmp(idxRm, idxEx, szRm) != 0) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "IDX %s made within budget=%lu differs, size %ld!=%ld\n", pPth, (unsigned long) pMemBdgt, szEx, szRm);
+  }
+out:
+  free(idxRm);
+  free(idxEx);
+  bsdiixtx_destroy(diIx);
+  bsdiixost_free (opSt);
+}
+
+/**
+ * <p>Handed over just made IDX must be same as loaded one.</p>
+ * @param pPth - dictionary path
+ * @param pMemBdgt - memory budget
+ **/
+static void sf_test_open(char *pPth, size_t pMemBdgt) {
+  BsDiIxTx *diIx = NULL, *diIxLd = NULL;
+  char pth[strlen(pPth) + 10];
+  strcpy(pth, pPth);
+  strcat(pth, BDI_IDX_FILE_EXT);
+  remove(pth);
+  BS_DO_E_RET(BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->memBdgt = pMemBdgt;
+  BS_DO_E_OUT(diIx = (BsDiIxTx*) bsdiixtx_open(pPth, opSt, false))
+  BS_DO_E_OUT(diIxLd = bsdiixtx_load(pPth))
+  if (diIx == NULL || diIxLd == NULL || opSt->stt != EBSDS_OPENED) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Can't open %s within budget=%lu\n", pPth, (unsigned long) pMemBdgt);
+    goto out;
+  }
+  if (diIx->irtOfst != diIxLd->irtOfst || diIx->i2wptOfst != diIxLd->i2wptOfst
+        || diIx->dwoltOfst != diIxLd->dwoltOfst
+          || diIx->head->irtSz != diIxLd->head->irtSz
+            || diIx->head->hirtSz != diIxLd->head->hirtSz
+              || strcmp(diIx->head->nme->val, diIxLd->head->nme->val) != 0) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Handed over IDX %s differs from loaded one, irtOfst %ld!=%ld\n", pPth, diIx->irtOfst, diIxLd->irtOfst);
+  }
+  if (diIxLd->fstOfst != BS_FOFST_NULL) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "IDX %s is made with unwanted FST\n", pPth);
+  }
+  if (diIxLd->saOfst != BS_FOFST_NULL) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "IDX %s is made with unwanted SA\n", pPth);
+  }
+out:
+  bsdiixtx_destroy(diIx);
+  bsdiixtx_destroy(diIxLd);
+  bsdiixost_free (opSt);
+}
+
+/**
+ * <p>Small dictionary's IDX is made wholly in memory by auto budget.</p>
+ **/
+static void sf_test_bdgt() {
+  size_t bdgt = bsdiixtxex_bdgt("tst_dic5.dsl");
+  if (bdgt != 0) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Auto budget for tst_dic5.dsl=%lu\n", (unsigned long) bdgt);
+  }
+}
+
+/**
+ * <p>Just made IDX RAM is handed over without reloading.</p>
+ **/
+static void sf_test_open_rm() {
+  BsDiIxTxRm *diIxRm = NULL;
+  char pth[strlen(s_dic_pth) + 10];
+  strcpy(pth, s_dic_pth);
+  strcat(pth, BDI_IDX_FILE_EXT);
+  remove(pth);
+  BS_DO_E_RET(BsDiIxOst *opSt = bsdiixost_new ())
+  BS_DO_E_OUT(diIxRm = (BsDiIxTxRm*) bsdiixtx_open(s_dic_pth, opSt, true))
+  if (diIxRm == NULL) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Can't open %s\n", s_dic_pth);
+    goto out;
+  }
+  BS_DO_E_OUT(sf_test_idx_data_dic1dsl(diIxRm))
+out:
+  bsdiixtxrm_destroy(diIxRm);
+  bsdiixost_free (opSt);
+}
+
+/**
+ * <p>IDX RAM handed over from IDX made within memory budget
+ * must be same as loaded one.</p>
+ * @param pPth - dictionary path
+ * @param pMemBdgt - memory budget
+ **/
+static void sf_test_open_rm_ext(char *pPth, size_t pMemBdgt) {
+  BsDiIxTxRm *diIxRm = NULL, *diIxLd = NULL;
+  char pth[strlen(pPth) + 10];
+  strcpy(pth, pPth);
+  strcat(pth, BDI_IDX_FILE_EXT);
+  remove(pth);
+  BS_DO_E_RET(BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->memBdgt = pMemBdgt;
+  BS_DO_E_OUT(diIxRm = (BsDiIxTxRm*) bsdiixtx_open(pPth, opSt, true))
+  BS_DO_E_OUT(diIxLd = bsdiixtxrm_load(pPth))
+  if (diIxRm == NULL || diIxLd == NULL || opSt->stt != EBSDS_OPENED) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Can't open IDX RAM %s within budget=%lu\n", pPth, (unsigned long) pMemBdgt);
+    goto out;
+  }
+  BsDiIxHeadTx *hd = diIxRm->head;
+  if (hd->irtSz != diIxLd->head->irtSz || hd->i2wptSz != diIxLd->head->i2wptSz
+        || hd->dwoltSz != diIxLd->head->dwoltSz || diIxRm->flgs != diIxLd->flgs
+          || memcmp(diIxRm->irtDwSts, diIxLd->irtDwSts, hd->irtSz * BDI_RM_IDXLEN(diIxRm->flgs)) != 0
+            || memcmp(diIxRm->irtI2Sts, diIxLd->irtI2Sts, hd->irtSz * BDI_RM_IDXLEN(diIxRm->flgs)) != 0
+              || memcmp(diIxRm->i2wpt, diIxLd->i2wpt, hd->i2wptSz * BDI_RM_IDXLEN(diIxRm->flgs)) != 0
+                || memcmp(diIxRm->dwoltOfsts, diIxLd->dwoltOfsts, hd->dwoltSz * BDI_RM_OFSLEN(diIxRm->flgs)) != 0
+                  || (diIxRm->hwp == NULL) != (diIxLd->hwp == NULL)) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Handed over IDX RAM %s differs from loaded one\n", pPth);
+  }
+  else if (diIxRm->flgs != (BDI_TXFLG_IDX32 | BDI_TXFLG_OFS32 | BDI_RMFLG_WOFS32)) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "IDX RAM %s tables aren't 32 bit, flgs=%d\n", pPth, diIxRm->flgs);
+  }
+out:
+  bsdiixtxrm_destroy(diIxRm);
+  bsdiixtxrm_destroy(diIxLd);
+  bsdiixost_free (opSt);
+}
+
+static char *s_dicup_pth = "tst_dicup.dsl";
+
+/**
+ * <p>Write generated dictionary with thousands articles,
+ * so it's split into many chunks.</p>
+ * @param pVer - version, every next one is edited previous one
+ **/
+static void sf_write_dicup(int pVer) {
+  FILE *fl = fopen(s_dicup_pth, "w");
+  BS_IF_EN_RET(fl == NULL, BSE_OPEN_FILE)
+  fprintf(fl, "#NAME \"Dictionary update\"\n#INDEX_LANGUAGE \"English\"\n#CONTENTS_LANGUAGE \"English\"\n\n");
+  for (int i = 0; i < 4000; i++) {
+    if (pVer >= 1 && i == 1000) { //inserted with new AB chars:
+      fprintf(fl, "ёжик word\n\t[trn]inserted article[/trn]\n");
+    }
+    if (pVer >= 1 && i == 2000) { //deleted
+      continue;
+    }
+    if (pVer >= 1 && i == 500) { //earlier duplicate hides later headword:
+      fprintf(fl, "word03500\n\t[trn]earlier duplicate[/trn]\n");
+    }
+    if (pVer >= 3 && i == 1500) { //inserted within AB, so merged:
+      fprintf(fl, "changed number\n\t[trn]merged article[/trn]\n");
+    }
+    if (pVer >= 3 && i == 2500) { //deleted within AB
+      continue;
+    }
+    if (pVer >= 2 && i == 3000) {
+      fprintf(fl, "changed headword\n");
+    } else {
+      fprintf(fl, "word%05d\n", i);
+    }
+    if (i % 7 == 0) { //several headwords article:
+      fprintf(fl, "word%05d phrase number %d\n", i, i % 13);
+    }
+    fprintf(fl, "\t[trn]article %d %s[/trn]\n", i, pVer >= 2 && i == 100 ? "changed body" : "body");
+    fprintf(fl, "\t[ex]example of article number %d[/ex]\n\n", i);
+  }
+  if (pVer >= 2) { //appended:
+    fprintf(fl, "appended word\n\t[trn]appended article[/trn]\n");
+  }
+  fclose(fl);
+}
+
+/**
+ * <p>Updated IDX of edited dictionary must be same as fully remade one.</p>
+ * @param pVer - dictionary version
+ * @param pIsIxRm - prefer IDX RAM
+ **/
+static void sf_test_update_ver(int pVer, bool pIsIxRm) {
+  char *idxUp = NULL, *idxRm = NULL;
+  long szUp, szRm;
+  BsDiIxTxBs *diIx = NULL;
+  BS_DO_E_RET(BsDiIxOst *opSt = bsdiixost_new ())
+  BS_DO_E_OUT(sf_write_dicup(pVer))
+  BS_DO_E_OUT(diIx = bsdiixtx_open(s_dicup_pth, opSt, pIsIxRm))
+  if (diIx == NULL || opSt->stt != EBSDS_OPENED) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Can't update %s ver=%d\n", s_dicup_pth, pVer);
+    goto out;
+  }
+  if (pIsIxRm) {
+    diIx = (BsDiIxTxBs*) bsdiixtxrm_destroy((BsDiIxTxRm*) diIx);
+  } else {
+    diIx = (BsDiIxTxBs*) bsdiixtx_destroy((BsDiIxTx*) diIx);
+  }
+  BS_DO_E_OUT(idxUp = sf_read_idx(s_dicup_pth, &szUp))
+  BS_DO_E_OUT(BsDiIxTxRm *diIxRm = bsdiixtxrm_create(s_dicup_pth, opSt))
+  BS_DO_E_OUT(bsdiixtxrm_validate(diIxRm))
+  BS_DO_E_OUT(bsdiixtxrm_save(diIxRm, s_dicup_pth))
+  bsdiixtxrm_destroy(diIxRm);
+  BS_DO_E_OUT(idxRm = sf_read_idx(s_dicup_pth, &szRm))
+  if (szUp != szRm || memcmp(idxUp, idxRm, szRm) != 0) {
+    errno = BSE_ERR; bslog_log(BSLERROR, "Updated IDX %s ver=%d differs from remade one, size %ld!=%ld\n", s_dicup_pth, pVer, szUp, szRm);
+  }
+out:
+  free(idxUp);
+  free(idxRm);
+  bsdiixost_free (opSt);
+}
+
+/**
+ * <p>IDX of edited dictionary is updated by re-parsing only changed chunks,
+ * touched dictionary's IDX keeps its data.</p>
+ **/
+static void sf_test_update() {
+  char pth[strlen(s_dicup_pth) + 10];
+  strcpy(pth, s_dicup_pth);
+  strcat(pth, BDI_IDX_FILE_EXT);
+  remove(pth);
+  errno = 0; //it might not exist
+  BS_DO_E_OUT(sf_test_update_ver(0, false))
+  BS_DO_E_OUT(sf_test_update_ver(1, false))
+  BS_DO_E_OUT(sf_test_update_ver(2, true))
+  BS_DO_E_OUT(sf_test_update_ver(2, false)) //touched
+  BS_DO_E_OUT(sf_test_update_ver(3, true))
+  BS_DO_E_OUT(sf_test_update_ver(0, false))
+out:
+  remove(pth);
+  remove(s_dicup_pth);
+}
+
+/**
+ * <p>Flip IDX file's byte.</p>
+ **/
+static void sf_flip_idx(char *pPth, BS_FOFST_T pOfst) {
+  char pth[strlen(pPth) + 10];
+  unsigned char b;
+  strcpy(pth, pPth);
+  strcat(pth, BDI_IDX_FILE_EXT);
+  FILE *fl = fopen(pth, "r+b");
+  BS_IF_EN_RET(fl == NULL, BSE_OPEN_FILE)
+  fseek(fl, pOfst, SEEK_SET);
+  b = fgetc(fl) ^ 0x5A;
+  fseek(fl, pOfst, SEEK_SET);
+  fputc(b, fl);
+  fclose(fl);
+}
+
+/**
+ * <p>Open IDX and check its SUM.</p>
+ **/
+static EBsDiIxSumStt sf_open_sum(bool pDpVld, BsDiIxSum *pSumRt) {
+  EBsDiIxSumStt rz = EBDI_SUM_BAD;
+  BsDiIxTx *diIx = NULL;
+  BS_DO_E_RETE(BsDiIxOst *opSt = bsdiixost_new ())
+  opSt->dpVld = pDpVld;
+  BS_DO_E_OUT(diIx = (BsDiIxTx*) bsdiixtx_open(s_dicup_pth, opSt, false))
+  BS_IF_ENM_OUT(diIx == NULL || !(diIx->head->flgs & BDI_TXFLG_SUM), BSE_TEST_ERR, "IDX without SUM!\n")
+  BS_DO_E_OUT(rz = bsdiixsum_check(&diIx->head->sum, diIx->idxFl, s_dicup_pth))
+  *pSumRt = diIx->head->sum;
+out:
+  bsdiixtx_destroy(diIx);
+  bsdiixost_free (opSt);
+  return rz;
+}
+
+/**
+ * <p>IDX with intact check-summed head and matching dictionary's fingerprint
+ * is trusted, corrupted one is remade, touched dictionary's one gets new
+ * fingerprint.</p>
+ **/
+static void sf_test_sum() {
+  char *idx = NULL, *idx1 = NULL;
+  long sz, sz1;
+  BsDiIxSum sum;
+  char pth[strlen(s_dicup_pth) + 10];
+  strcpy(pth, s_dicup_pth);
+  strcat(pth, BDI_IDX_FILE_EXT);
+  remove(pth);
+  errno = 0; //it might not exist
+  BS_DO_E_OUT(sf_write_dicup(0))
+  BS_DO_E_OUT(sf_open_sum(false, &sum))
+  BS_DO_E_OUT(EBsDiIxSumStt stt = sf_open_sum(false, &sum))
+  BS_IF_ENM_OUT(stt != EBDI_SUM_OK, BSE_TEST_ERR, "made IDX isn't trusted!\n")
+  BS_DO_E_OUT(idx = sf_read_idx(s_dicup_pth, &sz))
+  //corrupted IRT is found only by deep validation:
+  BS_DO_E_OUT(sf_flip_idx(s_dicup_pth, sum.scts[0] + 1))
+  BS_DO_E_OUT(sf_open_sum(false, &sum))
+  BS_DO_E_OUT(idx1 = sf_read_idx(s_dicup_pth, &sz1))
+  BS_IF_ENM_OUT(sz != sz1 || memcmp(idx, idx1, sz) == 0, BSE_TEST_ERR, "corrupted IRT is remade without deep validation!\n")
+  free(idx1); idx1 = NULL;
+  BS_DO_E_OUT(sf_open_sum(true, &sum))
+  BS_DO_E_OUT(idx1 = sf_read_idx(s_dicup_pth, &sz1))
+  BS_IF_ENM_OUT(sz != sz1 || memcmp(idx, idx1, sz) != 0, BSE_TEST_ERR, "corrupted IRT isn't remade!\n")
+  free(idx1); idx1 = NULL;
+  //corrupted head:
+  BS_DO_E_OUT(sf_flip_idx(s_dicup_pth, sum.ofst + sizeof(int) + BS_FOFST_LEN + sizeof(long)))
+  BS_DO_E_OUT(sf_open_sum(false, &sum))
+  BS_DO_E_OUT(idx1 = sf_read_idx(s_dicup_pth, &sz1))
+  BS_IF_ENM_OUT(sz != sz1 || memcmp(idx, idx1, sz) != 0, BSE_TEST_ERR, "corrupted head isn't remade!\n")
+  //touched dictionary:
+  struct timespec tms[2] = { { 0, UTIME_OMIT }, { 1000000000L, 0 } };
+  BS_IF_EN_OUT(utimensat(AT_FDCWD, s_dicup_pth, tms, 0) != 0, BSE_WRITE_FILE)
+  BS_DO_E_OUT(stt = sf_open_sum(false, &sum))
+  BS_IF_ENM_OUT(stt != EBDI_SUM_OK || sum.mtime != 1000000000L * 1000000000L, BSE_TEST_ERR, "touched dictionary's IDX has old fingerprint!\n")
+  //reading error isn't reported as wrong checksum:
+  FILE *fl = fopen(pth, "ab");
+  BS_IF_EN_OUT(fl == NULL, BSE_OPEN_FILE)
+  stt = bsdiixsum_check(&sum, fl, s_dicup_pth);
+  fclose(fl);
+  BS_IF_ENM_OUT(errno == 0 || stt != EBDI_SUM_BAD, BSE_TEST_ERR, "reading error isn't reported!\n")
+  errno = 0;
+out:
+  free(idx);
+  free(idx1);
+  remove(pth);
+  remove(s_dicup_pth);
+}
+
+//remove generated IDX v2, errno is kept:
+static void sf_rm_idx2() {
+  int errnoOld = errno;
+  char *pths[] = { s_dic_pth, "tst_dic4.dsl", "tst_dic5.dsl", s_dicup_pth };
+  for (int j = 0; j < (int) (sizeof (pths) / sizeof (pths[0])); j++) {
+    char pth[strlen(pths[j]) + 10];
+    strcpy(pth, pths[j]);
+    strcat(pth, BDI_IDXMM_FILE_EXT);
+    remove(pth);
+  }
+  errno = errnoOld;
+}
+
 int main(int argc, char *argv[]) {
   setlocale(LC_ALL, ""); //it set to default system locale, e.g. en_US.UTF-8
   BS_DO_E_GOTO(BsLogFiles *bslf=bslogfiles_new(1), outlog)
@@ -164,11 +530,28 @@ outlog:
   //bslog_set_debug_floor(6000);
   //bslog_set_debug_ceiling(6000);
   BS_DO_E_OUT(sf_test_write())
-  sf_test_read();
+  BS_DO_E_OUT(sf_test_read())
+  BS_DO_E_OUT(sf_test_ext("tst_dic4.dsl", 1))
+  BS_DO_E_OUT(sf_test_ext("tst_dic4.dsl", 4096))
+  BS_DO_E_OUT(sf_test_ext("tst_dic4.dsl", 67108864))
+  BS_DO_E_OUT(sf_test_ext("tst_dic5.dsl", 1))
+  BS_DO_E_OUT(sf_test_ext("tst_dic5.dsl", 2048))
+  BS_DO_E_OUT(sf_test_ext("tst_dic5.dsl", 67108864))
+  BS_DO_E_OUT(sf_test_ext(s_dic_pth, 1))
+  BS_DO_E_OUT(sf_test_open("tst_dic5.dsl", 0))
+  BS_DO_E_OUT(sf_test_open("tst_dic5.dsl", 2048))
+  BS_DO_E_OUT(sf_test_open(s_dic_pth, 1))
+  BS_DO_E_OUT(sf_test_bdgt())
+  BS_DO_E_OUT(sf_test_open_rm())
+  BS_DO_E_OUT(sf_test_open_rm_ext("tst_dic5.dsl", 2048))
+  BS_DO_E_OUT(sf_test_open_rm_ext(s_dic_pth, 1))
+  BS_DO_E_OUT(sf_test_update())
+  BS_DO_E_OUT(sf_test_sum())
 out:
   if (errno != 0) {
     BSLOG_ERR
   }
+  sf_rm_idx2();
   bsdiixtxrm_destroy(sDiIxRm);
   bslog_destroy();
   return errno;
@@ -12,9 +12,12 @@ See the LICENSE in the root source folder */
 #include "string.h"
 #include "stdlib.h"
 #include "locale.h"
+#include "time.h"
+#include "wctype.h"
 
 #include "BsFatalLog.h"
 #include "BsError.h"
+#include "BsUcFold.h"
 #include "BsDicIdxAb.h"
 #include "BsDicWordDsl.h"
 
@@ -131,6 +134,128 @@ out:
   fclose(dic);
 }
 
+/**
+ * <p>Seconds since given time.</p>
+ **/
+static double sf_secs(struct timespec *pStt) {
+  struct timespec en;
+  clock_gettime(CLOCK_MONOTONIC, &en);
+  return (en.tv_sec - pStt->tv_sec) + (en.tv_nsec - pStt->tv_nsec) / 1e9;
+}
+
+/**
+ * <p>Former linear scan conversion as reference.</p>
+ **/
+static void sf_lin_to_istr(BS_WCHAR_T *pWstr, BS_CHAR_T *pIstr, BsDicIdxAb *pAb) {
+  int len = 0;
+  int was_space = FALSE;
+  for (int i = 0; pWstr[i] != 0; i++) {
+    BS_WCHAR_T nwch = bsucfold_fold(pWstr[i]);
+    for (int j = 0; j < pAb->chrsTot; j++) {
+      if (nwch == pAb->wchars[j]) {
+        if (nwch == pAb->ispace) {
+          if (was_space) {
+            break;
+          }
+          was_space = TRUE;
+        } else {
+          was_space = FALSE;
+        }
+        pIstr[len++] = j + 1;
+        break;
+      }
+    }
+  }
+  pIstr[len] = 0;
+}
+
+#define BENCH_WRDS 20000
+#define BENCH_WRDSZ 16
+
+/**
+ * <p>Benchmark AB filling and conversion on multi-script words,
+ * including non-BMP ones, lookup must give same result as linear scan,
+ * also for AB made as loaded one.</p>
+ **/
+static void sf_bench() {
+  //scripts ranges: Latin, Latin-1, Greek, Cyrillic, Armenian, Hebrew, Arabic,
+  //Devanagari, Thai, Georgian, CJK, Hangul, Gothic:
+  static const BS_WCHAR_T scrs[13][2] = { {0x41, 0x5A}, {0xC0, 0xFF},
+    {0x391, 0x3C9}, {0x410, 0x44F}, {0x531, 0x586}, {0x5D0, 0x5EA},
+    {0x627, 0x64A}, {0x905, 0x939}, {0xE01, 0xE2E}, {0x10D0, 0x10F0},
+    {0x4E00, 0x4EFF}, {0xAC00, 0xACFF}, {0x10330, 0x1034A} };
+  struct timespec stt;
+  BsDicIdxAb *idx_ab = NULL, *ld_ab = NULL;
+  BS_WCHAR_T (*wrds)[BENCH_WRDSZ] = malloc(BENCH_WRDS * sizeof(*wrds));
+  BS_CHAR_T (*istrs)[BENCH_WRDSZ] = malloc(BENCH_WRDS * sizeof(*istrs));
+  BS_CHAR_T istr[BENCH_WRDSZ];
+  BS_IF_ENM_OUT(wrds == NULL || istrs == NULL, ENOMEM, "no memory\n")
+  unsigned long rnd = 1;
+  for (int i = 0; i < BENCH_WRDS; i++) {
+    rnd = rnd * 6364136223846793005UL + 1442695040888963407UL;
+    const BS_WCHAR_T *scr = scrs[(rnd >> 33) % 13];
+    int len = 3 + (rnd >> 40) % (BENCH_WRDSZ - 4);
+    for (int j = 0; j < len; j++) {
+      rnd = rnd * 6364136223846793005UL + 1442695040888963407UL;
+      if (j > 0 && j < len - 1 && (rnd >> 60) == 0) {
+        wrds[i][j] = L' ';
+      } else {
+        wrds[i][j] = scr[0] + (rnd >> 33) % (scr[1] - scr[0] + 1);
+      }
+    }
+    wrds[i][len] = 0;
+  }
+  BS_DO_E_OUT(idx_ab = bsdicidxab_new(BDI_AB_BUF_INITSIZE))
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < BENCH_WRDS; i++) {
+    BS_DO_E_OUT(bsdicidxab_add_wstr(wrds[i], idx_ab))
+  }
+  double secsFl = sf_secs(&stt);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < BENCH_WRDS; i++) {
+    bsdicidxab_wstr_to_istr(wrds[i], istrs[i], idx_ab);
+  }
+  double secsLkp = sf_secs(&stt);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  for (int i = 0; i < BENCH_WRDS; i++) {
+    sf_lin_to_istr(wrds[i], istr, idx_ab);
+    if (bsdicidx_istr_cmp(istr, istrs[i]) != 0) {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG(BSLERROR, "lookup and linear scan differ on #%d %ls\n", i, wrds[i])
+      goto out;
+    }
+  }
+  double secsLin = sf_secs(&stt);
+  bslog_log(BSLTEST, "words=%d, AB chars=%d, fill=%.4f sec, lookup convert=%.4f sec, linear scan convert=%.4f sec\n",
+    BENCH_WRDS, idx_ab->chrsTot, secsFl, secsLkp, secsLin);
+  for (int k = 1; k < idx_ab->chrsTot; k++) {
+    if (idx_ab->wchars[k] <= idx_ab->wchars[k - 1]) {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG(BSLERROR, "AB wchars unordered at %d\n", k)
+      goto out;
+    }
+  }
+  //as loaded from IDX:
+  BS_DO_E_OUT(ld_ab = bsdicidxab_new(idx_ab->chrsTot))
+  ld_ab->chrsTot = idx_ab->chrsTot;
+  memcpy(ld_ab->wchars, idx_ab->wchars, idx_ab->chrsTot * BS_WCHAR_LEN);
+  ld_ab->ispace = idx_ab->ispace;
+  BS_DO_E_OUT(bsdicidxab_mk_lkp(ld_ab))
+  for (int i = 0; i < BENCH_WRDS; i++) {
+    bsdicidxab_wstr_to_istr(wrds[i], istr, ld_ab);
+    if (bsdicidx_istr_cmp(istr, istrs[i]) != 0) {
+      errno = BSE_TEST_ERR;
+      BSLOG_LOG(BSLERROR, "loaded AB differs on #%d %ls\n", i, wrds[i])
+      goto out;
+    }
+  }
+out:
+  bsdicidxab_free(idx_ab);
+  bsdicidxab_free(ld_ab);
+  free(wrds);
+  free(istrs);
+}
+
 int main(int argc, char *argv[]) {
   setlocale(LC_ALL, "");
   BS_DO_E_GOTO(BsLogFiles *bslf=bslogfiles_new(1), outlog)
@@ -144,7 +269,8 @@ outlog:
   bsfatallog_init_fatal_signals();
   errno = 0;
   BS_DO_E_OUT(sf_test_ab1())
-  sf_test_ab2();
+  BS_DO_E_OUT(sf_test_ab2())
+  sf_bench();
 out:
   if (errno != 0) {
     BSLOG_ERR
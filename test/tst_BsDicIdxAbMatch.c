@@ -73,6 +73,8 @@ static void sf_test_ab1() {
   BS_IF_ENM_OUT (bsdicidx_istr_cont (s_idxwords[0], s_idxwords[1]), BSE_TEST_ERR, "бюл cont бюллетенить");
   BS_IF_ENM_OUT (!bsdicidx_istr_cont (s_idxwords[1], s_idxwords[0]), BSE_TEST_ERR, "бюллетенить !cont бюл");
   BS_IF_ENM_OUT (!bsdicidx_istr_cont (s_idxwords[2], s_idxwords[0]), BSE_TEST_ERR, "валяние бюл !cont бюл");
+  BS_CHAR_T aaab[] = {1, 1, 1, 2, 0}, aab[] = {1, 1, 2, 0};
+  BS_IF_ENM_OUT (!bsdicidx_istr_cont (aaab, aab), BSE_TEST_ERR, "aaab !cont aab");
   if (bsdicidx_istr_match(s_idxwords[0], s_idxwords[1], idx_ab->ispace) != EWMATCHFROMSTART) {
     n = 1; bsdicidxab_istr_to_wstr(s_idxwords[n], dword, idx_ab);
     errno = BSE_ERR;
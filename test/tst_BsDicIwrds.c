@@ -17,6 +17,7 @@ See the LICENSE in the root source folder */
 #include "BsFatalLog.h"
 #include "BsError.h"
 #include "BsDicIwrds.h"
+#include "BsDicIwrdsMt.h"
 #include "BsDicWordDsl.h"
 
 #define MAX_WRD_LEN 14
@@ -205,6 +206,81 @@ out:
   fclose(dic);
 }
 
+/**
+ * <p>Make AB and i.words by given threads count.</p>
+ **/
+static void sf_make_mt(BsDicDslMm *pDslMm, int pThrdCnt, BsDicIdxAb **pIdxAbRt,
+  BsDicIdxAbTotals *pAbTots, BsDicIwrds **pIwrdsRt) {
+  BS_DO_E_RET(*pIdxAbRt = bsdicidxab_new(BDI_AB_BUF_INITSIZE))
+  BS_DO_E_RET(bsdiciwrdsmt_make(pDslMm, s_dic_entry_buffer_size, pThrdCnt, *pIdxAbRt, pAbTots, pIwrdsRt))
+}
+
+/**
+ * <p>Compare serial and multi-threaded (sharded) making AB and i.words.</p>
+ **/
+static void sf_test3() {
+  char *dic_pths[4] = { "tst_dic1.dsl", "tst_dic2.dsl", "tst_dic3.dsl", "tst_dic4.dsl" };
+  int thrd_cnts[3] = { 2, 3, 5 };
+  for (int d = 0; d < 4; d++) {
+    FILE *dic = fopen(dic_pths[d], "r");
+    if (dic == NULL) {
+      if (errno == 0) { errno = BSE_ERR; }
+      BSLOG_LOG(BSLERROR, "Can't open %s\n", dic_pths[d]);
+      return;
+    }
+    BsDicDslMm *dsl_mm = NULL;
+    BsDicIdxAb *idx_ab1 = NULL, *idx_ab2 = NULL;
+    BsDicIwrds *iwrds1 = NULL, *iwrds2 = NULL;
+    BS_DO_E_OUT(dsl_mm = bsdicdslmm_new(dic))
+    BSDICIDXABTOTALS_CREATE(ab_tots1)
+    BS_DO_E_OUT(sf_make_mt(dsl_mm, 1, &idx_ab1, &ab_tots1, &iwrds1))
+    for (int t = 0; t < 3; t++) {
+      BSDICIDXABTOTALS_CREATE(ab_tots2)
+      BS_DO_E_OUT(sf_make_mt(dsl_mm, thrd_cnts[t], &idx_ab2, &ab_tots2, &iwrds2))
+      if (idx_ab1->chrsTot != idx_ab2->chrsTot || idx_ab1->ispace != idx_ab2->ispace
+        || memcmp(idx_ab1->wchars, idx_ab2->wchars, idx_ab1->chrsTot * BS_WCHAR_LEN) != 0) {
+        errno = BSE_ALG_ERR;
+        BSLOG_LOG(BSLERROR, "AB differs %s threads=%d\n", dic_pths[d], thrd_cnts[t]);
+        goto out;
+      }
+      if (ab_tots1.max_iword_len != ab_tots2.max_iword_len || ab_tots1.dwoltSz != ab_tots2.dwoltSz
+        || ab_tots1.i2wptSz != ab_tots2.i2wptSz) {
+        errno = BSE_ALG_ERR;
+        BSLOG_LOG(BSLERROR, "AB totals differ %s threads=%d\n", dic_pths[d], thrd_cnts[t]);
+        goto out;
+      }
+      if (iwrds1->size != iwrds2->size || iwrds1->dwoltSz != iwrds2->dwoltSz
+        || iwrds1->max_iword_size != iwrds2->max_iword_size
+          || iwrds1->all_iwords_size != iwrds2->all_iwords_size) {
+        errno = BSE_ALG_ERR;
+        BSLOG_LOG(BSLERROR, "i.words totals differ %s threads=%d, size="BS_IDX_FMT"/"BS_IDX_FMT"\n", dic_pths[d], thrd_cnts[t], iwrds1->size, iwrds2->size);
+        goto out;
+      }
+      for (BS_IDX_T l = BS_IDX_0; l < iwrds1->size; l++) {
+        if (bsdicidx_istr_cmp(iwrds1->vals[l]->iword, iwrds2->vals[l]->iword) != 0
+          || iwrds1->vals[l]->offset_dword != iwrds2->vals[l]->offset_dword
+            || iwrds1->vals[l]->length_dword != iwrds2->vals[l]->length_dword) {
+          errno = BSE_ALG_ERR;
+          BSLOG_LOG(BSLERROR, "i.word#"BS_IDX_FMT" differs %s threads=%d\n", l, dic_pths[d], thrd_cnts[t]);
+          goto out;
+        }
+      }
+      idx_ab2 = bsdicidxab_free(idx_ab2);
+      iwrds2 = bsdiciwrds_free(iwrds2);
+    }
+out:
+    bsdicidxab_free(idx_ab1);
+    bsdicidxab_free(idx_ab2);
+    bsdiciwrds_free(iwrds1);
+    bsdiciwrds_free(iwrds2);
+    bsdicdslmm_free(dsl_mm);
+    fclose(dic);
+    if (errno != 0) {
+      return;
+    }
+  }
+}
+
 int main(int argc, char *argv[]) {
   setlocale(LC_ALL, ""); //it set to default system locale, e.g. en_US.UTF-8
   BS_DO_E_GOTO(BsLogFiles *bslf=bslogfiles_new(1), outlog)
@@ -219,7 +295,8 @@ outlog:
   errno = 0;
   //bslog_set_debug_ceiling(999999);
   BS_DO_E_OUT(sf_test1())
-  sf_test2(argc);
+  BS_DO_E_OUT(sf_test2(argc))
+  sf_test3();
 out:
   if (errno != 0) {
     BSLOG_ERR
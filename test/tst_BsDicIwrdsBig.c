@@ -12,6 +12,7 @@ See the LICENSE in the root source folder */
 #include "string.h"
 #include "stdlib.h"
 #include "locale.h"
+#include "time.h"
 
 #include "BsDicIwrds.h"
 #include "BsDicWordDsl.h"
@@ -31,6 +32,36 @@ static void sf_print_all_iwords(BsDicIwrds *p_iwrdssort) {
   }
 }
 
+/**
+ * <p>Seconds since given time.</p>
+ **/
+static double sf_secs(struct timespec *pStt) {
+  struct timespec en;
+  clock_gettime(CLOCK_MONOTONIC, &en);
+  return (en.tv_sec - pStt->tv_sec) + (en.tv_nsec - pStt->tv_nsec) / 1e9;
+}
+
+/**
+ * <p>Benchmark sorted insertion against append then sort, results must be same.</p>
+ **/
+static void sf_bench(FILE *pDic, BsDicIdxAbTotals *pTotals, BsDicIwrds *pIwrds, double pSecs) {
+  struct timespec stt;
+  BsDicIwrds *iwrds = NULL;
+  rewind(pDic);
+  clock_gettime(CLOCK_MONOTONIC, &stt);
+  BS_DO_E_OUT(bsdiciwrds_iter(pDic, s_dic_entry_buffer_size, pTotals, s_idx_ab, bsdicworddsl_iter_tus, bsdiciwrds_dwrd_csm_apnd, &iwrds))
+  double secs = sf_secs(&stt);
+  bslog_log(BSLTEST, "i.words="BS_IDX_FMT", sorted insertion=%.3f sec, append then sort=%.3f sec\n", pIwrds->size, pSecs, secs);
+  BS_IF_ENM_OUT(iwrds->size != pIwrds->size || iwrds->all_iwords_size != pIwrds->all_iwords_size,
+    BSE_TEST_ERR, "i.words totals differ\n")
+  for (BS_IDX_T l = BS_IDX_0; l < iwrds->size; l++) {
+    BS_IF_ENM_OUT(bsdicidx_istr_cmp(iwrds->vals[l]->iword, pIwrds->vals[l]->iword) != 0
+      || iwrds->vals[l]->offset_dword != pIwrds->vals[l]->offset_dword, BSE_TEST_ERR, "i.words differ\n")
+  }
+out:
+  bsdiciwrds_free(iwrds);
+}
+
 static void sf_test1(int argc, char *argv[]) {
   int ab_sz;
   char *pth = NULL;
@@ -54,7 +85,10 @@ static void sf_test1(int argc, char *argv[]) {
   BSDICIDXABTOTALS_CREATE(totals)
   BS_DO_E_OUT(bsdicidxab_iter_dsl_fill(dic, s_dic_entry_buffer_size, s_idx_ab, &totals))
   rewind(dic);
+  struct timespec stt;
+  clock_gettime(CLOCK_MONOTONIC, &stt);
   BS_DO_E_OUT(bsdiciwrds_iter(dic, s_dic_entry_buffer_size, &totals, s_idx_ab, bsdicworddsl_iter_tus, bsdiciwrds_dwrd_csm, &iwrds))
+  BS_DO_E_OUT(sf_bench(dic, &totals, iwrds, sf_secs(&stt)))
   if (totals.i2wptSz > BS_IDX_0) {
     BS_DO_E_OUT(i2wrds = bsdici2wrds_new_fill(totals.i2wptSz, iwrds))
   }
@@ -120,7 +120,7 @@ static void
       BS_IDX_T irtEnd = diIx->head->irtSz - BS_IDX_1;
       if ( diIx->head->hirt != NULL )
       {
-        BS_DO_E_OUT (bsdicidx_find_irtrange (diIx->head->hirt, diIx->head->hirtSz, iwrd, &irtStart, &irtEnd))
+        BS_DO_E_OUT (bsdicidx_find_irtrange ((BsDiIxHeadBs*) diIx->head, iwrd, &irtStart, &irtEnd))
       }
       BS_DO_E_OUT (rcd = bsdiixt2tst_find_irtrd(diIx, iwrd, irtStart, irtEnd))
       if ( rcd != NULL )
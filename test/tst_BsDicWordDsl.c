@@ -244,6 +244,99 @@ out:
   }
 }
 
+//Collected words to compare iterators:
+#define TST_MAX_WRDS 100
+
+typedef struct {
+  int size;
+  BsDicWord wrds[TST_MAX_WRDS];
+} TstWrds;
+
+static int sf_consume_collect(BsDicWord *p_dwrd, TstWrds *p_wrds) {
+  if (p_wrds->size == TST_MAX_WRDS) {
+    errno = BSE_ERR;
+    BSLOG_LOG(BSLERROR, "Too many words, dwrd=%ls\n", p_dwrd->word);
+    return errno;
+  }
+  BsDicWord *wrd = &p_wrds->wrds[p_wrds->size];
+  wrd->word = malloc((wcslen(p_dwrd->word) + 1) * BS_WCHAR_LEN);
+  if (wrd->word == NULL) {
+    errno = ENOMEM;
+    return errno;
+  }
+  wcscpy(wrd->word, p_dwrd->word);
+  wrd->offset = p_dwrd->offset;
+  wrd->lenChrs = p_dwrd->lenChrs;
+  p_wrds->size++;
+  return 0;
+}
+
+static void sf_clear_collected(TstWrds *p_wrds) {
+  for (int i = 0; i < p_wrds->size; i++) {
+    free(p_wrds->wrds[i].word);
+  }
+  p_wrds->size = 0;
+}
+
+static void sf_cmp_collected(TstWrds *p_wrds1, TstWrds *p_wrds2, char *p_dic_pth) {
+  if (p_wrds1->size != p_wrds2->size) {
+    errno = BSE_ERR;
+    BSLOG_LOG(BSLERROR, "%s words count different %d != %d\n", p_dic_pth, p_wrds1->size, p_wrds2->size);
+    return;
+  }
+  for (int i = 0; i < p_wrds1->size; i++) {
+    if (!sf_wstr_cmp(p_wrds1->wrds[i].word, p_wrds2->wrds[i].word)
+      || p_wrds1->wrds[i].offset != p_wrds2->wrds[i].offset
+        || p_wrds1->wrds[i].lenChrs != p_wrds2->wrds[i].lenChrs) {
+      errno = BSE_ERR;
+      BSLOG_LOG(BSLERROR, "%s words different %ls/%ld/%d != %ls/%ld/%d\n", p_dic_pth,
+        p_wrds1->wrds[i].word, p_wrds1->wrds[i].offset, p_wrds1->wrds[i].lenChrs,
+        p_wrds2->wrds[i].word, p_wrds2->wrds[i].offset, p_wrds2->wrds[i].lenChrs);
+      return;
+    }
+  }
+}
+
+/* memory mapped scanner must yield same words as wide stream one */
+static void sf_test3() {
+  char *dic_pths[4] = { "tst_dic1.dsl", "tst_dic2.dsl", "tst_dic3.dsl", "tst_dic4.dsl" };
+  TstWrds wrds_tus = { .size=0 };
+  TstWrds wrds_mm = { .size=0 };
+  TstWrds wrds_hw = { .size=0 };
+  BsDicDslMm *dsl_mm = NULL;
+  FILE *dic = NULL;
+  for (int d = 0; d < 4; d++) {
+    dic = fopen(dic_pths[d], "r");
+    if (dic == NULL) {
+      if (errno == 0) { errno = BSE_ERR; }
+      BSLOG_LOG(BSLERROR, "Can't open %s\n", dic_pths[d]);
+      goto out;
+    }
+    BS_DO_E_OUT(bsdicworddsl_iter_tus(dic, s_dic_entry_buffer_size, (BsDicWord_Consume_Tus*) sf_consume_collect, (void*) &wrds_tus))
+    rewind(dic);
+    BS_DO_E_OUT(dsl_mm = bsdicdslmm_new(dic))
+    BS_DO_E_OUT(bsdicdslmm_iter(dsl_mm, s_dic_entry_buffer_size, (BsDicWord_Consume_Tus*) sf_consume_collect, (void*) &wrds_mm))
+    BS_DO_E_OUT(sf_cmp_collected(&wrds_tus, &wrds_mm, dic_pths[d]))
+    BS_DO_E_OUT(bsdicdslmm_iter_hw(dsl_mm, s_dic_entry_buffer_size, (BsDicWord_Consume_Tus*) sf_consume_collect, (void*) &wrds_hw))
+    BS_DO_E_OUT(sf_cmp_collected(&wrds_tus, &wrds_hw, dic_pths[d]))
+    bslog_log(BSLTEST, "%s mapped scanner words=%d\n", dic_pths[d], wrds_mm.size);
+    dsl_mm = bsdicdslmm_free(dsl_mm);
+    fclose(dic);
+    dic = NULL;
+    sf_clear_collected(&wrds_tus);
+    sf_clear_collected(&wrds_mm);
+    sf_clear_collected(&wrds_hw);
+  }
+out:
+  bsdicdslmm_free(dsl_mm);
+  if (dic != NULL) {
+    fclose(dic);
+  }
+  sf_clear_collected(&wrds_tus);
+  sf_clear_collected(&wrds_mm);
+  sf_clear_collected(&wrds_hw);
+}
+
 int main(int argc, char *argv[]) {
   setlocale(LC_ALL, "");
   BS_DO_E_GOTO(BsLogFiles *bslf=bslogfiles_new(1), outlog)
@@ -258,7 +351,8 @@ outlog:
   errno = 0;
   bslog_set_debug_ceiling(999999);
   BS_DO_E_OUT(sf_test1())
-  sf_test2(argc);
+  BS_DO_E_OUT(sf_test2(argc))
+  sf_test3();
 out:
   if (errno != 0) {
     BSLOG_ERR